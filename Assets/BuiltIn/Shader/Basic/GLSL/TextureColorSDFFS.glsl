@@ -0,0 +1,17 @@
+precision mediump float;
+
+uniform sampler2D uTexDiffuse;
+
+in vec2 varTexCoord0;
+in vec4 varColor;
+out vec4 FragColor;
+
+void main(void)
+{
+	// the alpha is the signed distance, 0.5 is the edge of the glyph
+	float distance = texture(uTexDiffuse, varTexCoord0.xy).a;
+	float width = fwidth(distance) * 0.7;
+	float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+
+	FragColor = vec4(varColor.rgb, varColor.a * alpha);
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+Texture2D uTexDiffuse : register(t0);
+SamplerState uTexDiffuseSampler : register(s0);
+
+struct PS_INPUT
+{
+	float4 pos : SV_POSITION;
+	float4 color : COLOR0;
+	float2 tex0 : TEXCOORD0;
+};
+
+float4 main(PS_INPUT input) : SV_TARGET
+{
+	// the alpha is the signed distance, 0.5 is the edge of the glyph
+	float distance = uTexDiffuse.Sample(uTexDiffuseSampler, input.tex0).a;
+	float width = fwidth(distance) * 0.7;
+	float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+
+	return float4(input.color.rgb, input.color.a * alpha);
+}
\ No newline at end of file
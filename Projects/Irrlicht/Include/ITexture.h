@@ -161,6 +161,19 @@ public:
 	level. At least one pixel will be always kept.*/
 	virtual void regenerateMipMapLevels(void* mipmapData = 0) = 0;
 
+	//! Upload a sub rectangle of the main texture level.
+	/** It does not need lock() and unlock(), so only the changed pixels are sent to the GPU.
+	Call regenerateMipMapLevels() after it if the texture has mipmaps.
+	\param rect The rectangle in the texture to update.
+	\param data Pointer to the first pixel of the rectangle.
+	\param pitch Size in bytes of one row of the source data.
+	\param format The color format of the data, it must be the same as getColorFormat().
+	\return False if the driver does not support it, then lock() and unlock() the whole texture. */
+	virtual bool updateRegion(const core::rect<s32>& rect, const void* data, u32 pitch, ECOLOR_FORMAT format)
+	{
+		return false;
+	}
+
 	//! Get original size of the texture.
 	/** The texture is usually scaled, if it was created with an unoptimal
 	size. For example if the size was not a power of two. This method
@@ -154,6 +154,31 @@ ID3D11ShaderResourceView* CD3D11Texture::getShaderResourceView() const
 	return SRView;
 }
 
+//! Upload a sub rectangle of the main texture level
+bool CD3D11Texture::updateRegion(const core::rect<s32>& rect, const void* data, u32 pitch, ECOLOR_FORMAT format)
+{
+	if (!Texture || IsCompressed || IsRenderTarget || format != ColorFormat || Size != OriginalSize || NumberOfArraySlices > 1)
+		return false;
+
+	if (rect.UpperLeftCorner.X < 0 || rect.UpperLeftCorner.Y < 0 ||
+		rect.LowerRightCorner.X > (s32)Size.Width || rect.LowerRightCorner.Y > (s32)Size.Height)
+		return false;
+
+	if (rect.getWidth() <= 0 || rect.getHeight() <= 0)
+		return true;
+
+	D3D11_BOX box;
+	box.left = rect.UpperLeftCorner.X;
+	box.top = rect.UpperLeftCorner.Y;
+	box.right = rect.LowerRightCorner.X;
+	box.bottom = rect.LowerRightCorner.Y;
+	box.front = 0;
+	box.back = 1;
+
+	Context->UpdateSubresource(Texture, D3D11CalcSubresource(0, 0, NumberOfMipLevels), &box, data, pitch, 0);
+	return true;
+}
+
 //! lock function
 void* CD3D11Texture::lock(E_TEXTURE_LOCK_MODE mode, u32 mipmapLevel)
 {
@@ -48,6 +48,9 @@ public:
 	//! modifying the texture
 	virtual void regenerateMipMapLevels(void* mipmapData = 0);
 
+	//! Upload a sub rectangle of the main texture level
+	virtual bool updateRegion(const core::rect<s32>& rect, const void* data, u32 pitch, ECOLOR_FORMAT format);
+
 	virtual u32 getNumberOfArraySlices() const;
 
 public:
@@ -698,6 +698,47 @@ namespace irr
 			return TextureName;
 		}
 
+		//! Upload a sub rectangle of the main texture level
+		bool COGLES3Texture::updateRegion(const core::rect<s32>& rect, const void* data, u32 pitch, ECOLOR_FORMAT format)
+		{
+			if (IsCompressed || IsRenderTarget || format != ColorFormat || Size != OriginalSize)
+				return false;
+
+			if (rect.UpperLeftCorner.X < 0 || rect.UpperLeftCorner.Y < 0 ||
+				rect.LowerRightCorner.X > (s32)Size.Width || rect.LowerRightCorner.Y > (s32)Size.Height)
+				return false;
+
+			const u32 bytesPerPixel = IImage::getBitsPerPixelFromFormat(format) / 8;
+			const s32 w = rect.getWidth();
+			const s32 h = rect.getHeight();
+			if (w <= 0 || h <= 0 || bytesPerPixel == 0)
+				return true;
+
+			// keep the local image the same as the GPU texture
+			if (Image)
+			{
+				const u8* src = static_cast<const u8*>(data);
+				u8* dst = static_cast<u8*>(Image->lock()) + rect.UpperLeftCorner.Y * Image->getPitch() + rect.UpperLeftCorner.X * bytesPerPixel;
+				for (s32 i = 0; i < h; i++)
+				{
+					memcpy(dst, src, w * bytesPerPixel);
+					dst += Image->getPitch();
+					src += pitch;
+				}
+				Image->unlock();
+			}
+
+			Driver->setActiveTexture(0, this);
+			Driver->getBridgeCalls()->setTexture(0);
+
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / bytesPerPixel);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, rect.UpperLeftCorner.X, rect.UpperLeftCorner.Y, w, h, PixelFormat, PixelType, data);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+			Driver->ResetRenderStates = true;
+			return !Driver->testGLError();
+		}
+
 
 		//! Regenerates the mip map levels of the texture. Useful after locking and
 		//! modifying the texture
@@ -77,6 +77,9 @@ namespace irr
 			\param mipmapData Pointer to raw mipmap data, including all necessary mip levels, in the same format as the main texture image. If not set the mipmaps are derived from the main image. */
 			virtual void regenerateMipMapLevels(void* mipmapData = 0) _IRR_OVERRIDE_;
 
+			//! Upload a sub rectangle of the main texture level
+			virtual bool updateRegion(const core::rect<s32>& rect, const void* data, u32 pitch, ECOLOR_FORMAT format) _IRR_OVERRIDE_;
+
 			//! return open gl texture name
 			GLuint getOpenGLTextureName() const;
 
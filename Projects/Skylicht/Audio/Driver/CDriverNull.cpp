@@ -25,6 +25,14 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "stdafx.h"
 #include "CDriverNull.h"
 #include "Engine/CAudioEmitter.h"
+#include "Engine/CAudioEngine.h"
+#include "SkylichtAudioConfig.h"
+
+#if defined(USE_AUDIO_SSE)
+#include <emmintrin.h>
+#elif defined(USE_AUDIO_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace Skylicht
 {
@@ -34,6 +42,8 @@ namespace Skylicht
 		{
 			m_mixBuffer = NULL;
 			m_numMixSampler = 0;
+			m_numMixedVoices = 0;
+			m_numVirtualVoices = 0;
 			
 			m_bufferLength = 0.0625f;
 			m_preferedRate = 44100; // hz (num sampler per second)
@@ -48,7 +58,7 @@ namespace Skylicht
 			delete m_mutex;
 			
 			if (m_mixBuffer)
-				delete m_mixBuffer;
+				delete[] m_mixBuffer;
 			
 			shutdown();
 		}
@@ -101,52 +111,79 @@ namespace Skylicht
 			SScopeMutex lockScope(m_mutex);
 			
 			int totalSamples = numSample * 2;	// left & right
-			int safeBufferSize = totalSamples + totalSamples / 2;
 			
 			// alloc mix buffer
 			if (m_numMixSampler < numSample)
 			{
-				m_numMixSampler = numSample;
-				
 				// free current mix buffer
 				if (m_mixBuffer != NULL)
-					delete m_mixBuffer;
+					delete[] m_mixBuffer;
 				
-				m_mixBuffer = new int[safeBufferSize];
+				m_mixBuffer = new float[totalSamples];
 				m_numMixSampler = numSample;
 			}
 			
 			// silent audio
-			memset(m_mixBuffer, 0, sizeof(int)*safeBufferSize);
+			memset(m_mixBuffer, 0, sizeof(float) * totalSamples);
+			
+			m_numMixedVoices = 0;
+			m_numVirtualVoices = 0;
 			
 			// mix audio
 			std::vector<CSoundSource*>::iterator iSource = m_sources.begin(), sourceEnd = m_sources.end();
 			while (iSource != sourceEnd)
 			{
-				CSoundSource *source = (*iSource);
+				CSoundSource* source = (*iSource);
 				
 				// mix playing source
 				if (source->getState() == ISoundSource::StatePlaying)
 				{
-					source->fillBuffer(m_mixBuffer, numSample, m_masterGain);
+					if (source->fillBuffer(m_mixBuffer, numSample, m_masterGain))
+						m_numMixedVoices++;
+					else
+						m_numVirtualVoices++;
 				}
 				
 				++iSource;
 			}
 			
-			// clamp audio (convert fixed to short)
-			int *mixingBufferCursor = m_mixBuffer;
-			short *outBufferCursor = (short*)outBuffer;
+			// the sources consumed the buffers, wake up the engine to decode the next
+			if (m_numMixedVoices + m_numVirtualVoices > 0)
+				CAudioEngine::wakeUpEngine();
 			
-			for (int i = 0; i < totalSamples; i++)
+			// clamp audio (convert float to short)
+			const float* mix = m_mixBuffer;
+			short* out = (short*)outBuffer;
+			
+			int i = 0;
+			
+#if defined(USE_AUDIO_SSE)
+			for (; i + 8 <= totalSamples; i += 8)
 			{
-				if ((unsigned int)(*mixingBufferCursor + 32768) > 65535)
-					*outBufferCursor = (short)(*mixingBufferCursor < 0 ? -32768 : 32767);
-				else
-					*outBufferCursor = (short)(*mixingBufferCursor);
+				// truncate & saturate to 16 bit
+				__m128i a = _mm_cvttps_epi32(_mm_loadu_ps(mix + i));
+				__m128i b = _mm_cvttps_epi32(_mm_loadu_ps(mix + i + 4));
+				_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(a, b));
+			}
+#elif defined(USE_AUDIO_NEON)
+			for (; i + 8 <= totalSamples; i += 8)
+			{
+				int32x4_t a = vcvtq_s32_f32(vld1q_f32(mix + i));
+				int32x4_t b = vcvtq_s32_f32(vld1q_f32(mix + i + 4));
+				vst1q_s16(out + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+			}
+#endif
+			
+			for (; i < totalSamples; i++)
+			{
+				float value = mix[i];
 				
-				outBufferCursor++;
-				mixingBufferCursor++;
+				if (value > 32767.0f)
+					out[i] = 32767;
+				else if (value < -32768.0f)
+					out[i] = -32768;
+				else
+					out[i] = (short)value;
 			}
 		}
 		
@@ -41,9 +41,12 @@ namespace Skylicht
 		protected:
 			std::vector<CSoundSource*> m_sources;
 			
-			int* m_mixBuffer;
+			float* m_mixBuffer;
 			int m_numMixSampler;
 			
+			int m_numMixedVoices;
+			int m_numVirtualVoices;
+			
 			unsigned char* m_buffer;
 			float m_bufferLength;
 			int m_preferedRate;
@@ -67,6 +70,18 @@ namespace Skylicht
 				return m_masterGain;
 			}
 			
+			/// @brief The number of voices that were mixed on the last fillBuffer
+			int getNumMixedVoices()
+			{
+				return m_numMixedVoices;
+			}
+			
+			/// @brief The number of playing voices that were too quiet to mix on the last fillBuffer
+			int getNumVirtualVoices()
+			{
+				return m_numVirtualVoices;
+			}
+			
 			virtual void init();
 			
 			virtual void shutdown();
@@ -293,10 +293,18 @@ namespace Skylicht
 				
 				if (iBuffersProcessed == 0)
 				{
+					// sleep until the playing buffer is near the end (80%), do not poll each 1ms
+					ALint sampleOffset = 0;
+					alGetSourcei(m_alSourceID, AL_SAMPLE_OFFSET, &sampleOffset);
+					
+					int bufferSample = m_bufferSizeOAL / 4;
+					int remainSample = bufferSample - sampleOffset % bufferSample;
+					int waitTime = (int)(remainSample * 800.0f / m_preferedRate);
+					
 					if (m_mutex)
 						m_mutex->unlock();
 					
-					IThread::sleep(1);
+					IThread::sleep(waitTime > 1 ? waitTime : 1);
 					continue;
 				}
 				
@@ -26,16 +26,235 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CSoundSource.h"
 
 #include "SkylichtAudio.h"
+#include "SkylichtAudioConfig.h"
+
+#if defined(USE_AUDIO_SSE)
+#include <emmintrin.h>
+#elif defined(USE_AUDIO_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace Skylicht
 {
 	namespace Audio
 	{
+		// mix the 16 bit source to the float stereo buffer, at the same sampling rate
+		static void mixSameRate(const short* src, int numChannels, float* out, int nbSample, float leftGain, float rightGain)
+		{
+			int i = 0;
+
+			if (numChannels == 2)
+			{
+#if defined(USE_AUDIO_SSE)
+				__m128 gain = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+
+				for (; i + 4 <= nbSample; i += 4)
+				{
+					// 4 frames: L0 R0 L1 R1 L2 R2 L3 R3
+					__m128i s = _mm_loadu_si128((const __m128i*)(src + i * 2));
+					__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+					__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+
+					float* o = out + i * 2;
+					_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(lo, gain)));
+					_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(hi, gain)));
+				}
+#elif defined(USE_AUDIO_NEON)
+				float32x4_t gain = { leftGain, rightGain, leftGain, rightGain };
+
+				for (; i + 4 <= nbSample; i += 4)
+				{
+					int16x8_t s = vld1q_s16(src + i * 2);
+					float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+					float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+
+					float* o = out + i * 2;
+					vst1q_f32(o, vmlaq_f32(vld1q_f32(o), lo, gain));
+					vst1q_f32(o + 4, vmlaq_f32(vld1q_f32(o + 4), hi, gain));
+				}
+#endif
+				for (; i < nbSample; i++)
+				{
+					out[i * 2] += src[i * 2] * leftGain;
+					out[i * 2 + 1] += src[i * 2 + 1] * rightGain;
+				}
+			}
+			else
+			{
+#if defined(USE_AUDIO_SSE)
+				__m128 gain = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+
+				for (; i + 4 <= nbSample; i += 4)
+				{
+					// 4 frames: M0 M1 M2 M3 => M0 M0 M1 M1, M2 M2 M3 M3
+					__m128i s = _mm_loadl_epi64((const __m128i*)(src + i));
+					__m128 m = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+
+					float* o = out + i * 2;
+					_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(_mm_unpacklo_ps(m, m), gain)));
+					_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(_mm_unpackhi_ps(m, m), gain)));
+				}
+#elif defined(USE_AUDIO_NEON)
+				float32x4_t gain = { leftGain, rightGain, leftGain, rightGain };
+
+				for (; i + 4 <= nbSample; i += 4)
+				{
+					float32x4_t m = vcvtq_f32_s32(vmovl_s16(vld1_s16(src + i)));
+					float32x4x2_t lr = vzipq_f32(m, m);
+
+					float* o = out + i * 2;
+					vst1q_f32(o, vmlaq_f32(vld1q_f32(o), lr.val[0], gain));
+					vst1q_f32(o + 4, vmlaq_f32(vld1q_f32(o + 4), lr.val[1], gain));
+				}
+#endif
+				for (; i < nbSample; i++)
+				{
+					out[i * 2] += src[i] * leftGain;
+					out[i * 2 + 1] += src[i] * rightGain;
+				}
+			}
+		}
+
+		// mix the 16 bit source to the float stereo buffer with linear interpolation resampling
+		static void mixResample(const short* src, int numFrame, int numChannels, float* out, int nbSample, float rateRatio, float leftGain, float rightGain)
+		{
+			int lastFrame = numFrame - 1;
+			int i = 0;
+
+#if defined(USE_AUDIO_SSE)
+			__m128 gain = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+			__m128 ratio = _mm_set1_ps(rateRatio);
+
+			// 4 frames, the source frames are loaded by index, the interpolation is on the vectors
+			for (; i + 4 <= nbSample && (int)((i + 3) * rateRatio) < lastFrame; i += 4)
+			{
+				__m128 position = _mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(i, i + 1, i + 2, i + 3)), ratio);
+				__m128i frame = _mm_cvttps_epi32(position);
+				__m128 fract = _mm_sub_ps(position, _mm_cvtepi32_ps(frame));
+
+				int f[4];
+				_mm_storeu_si128((__m128i*)f, frame);
+
+				float* o = out + i * 2;
+
+				if (numChannels == 2)
+				{
+					const short* s0 = src + f[0] * 2;
+					const short* s1 = src + f[1] * 2;
+					const short* s2 = src + f[2] * 2;
+					const short* s3 = src + f[3] * 2;
+
+					__m128 a = _mm_setr_ps(s0[0], s0[1], s1[0], s1[1]);
+					__m128 b = _mm_setr_ps(s0[2], s0[3], s1[2], s1[3]);
+					__m128 t = _mm_unpacklo_ps(fract, fract);
+					__m128 v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+					_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(v, gain)));
+
+					a = _mm_setr_ps(s2[0], s2[1], s3[0], s3[1]);
+					b = _mm_setr_ps(s2[2], s2[3], s3[2], s3[3]);
+					t = _mm_unpackhi_ps(fract, fract);
+					v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+					_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(v, gain)));
+				}
+				else
+				{
+					__m128 a = _mm_setr_ps(src[f[0]], src[f[1]], src[f[2]], src[f[3]]);
+					__m128 b = _mm_setr_ps(src[f[0] + 1], src[f[1] + 1], src[f[2] + 1], src[f[3] + 1]);
+					__m128 v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fract));
+
+					_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(_mm_unpacklo_ps(v, v), gain)));
+					_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(_mm_unpackhi_ps(v, v), gain)));
+				}
+			}
+#elif defined(USE_AUDIO_NEON)
+			float32x4_t gain = { leftGain, rightGain, leftGain, rightGain };
+
+			for (; i + 4 <= nbSample && (int)((i + 3) * rateRatio) < lastFrame; i += 4)
+			{
+				int32x4_t index = { i, i + 1, i + 2, i + 3 };
+				float32x4_t position = vmulq_n_f32(vcvtq_f32_s32(index), rateRatio);
+				int32x4_t frame = vcvtq_s32_f32(position);
+				float32x4_t fract = vsubq_f32(position, vcvtq_f32_s32(frame));
+
+				int f[4];
+				vst1q_s32(f, frame);
+
+				float* o = out + i * 2;
+
+				if (numChannels == 2)
+				{
+					float a[8], b[8];
+					for (int k = 0; k < 4; k++)
+					{
+						const short* s = src + f[k] * 2;
+						a[k * 2] = s[0];
+						a[k * 2 + 1] = s[1];
+						b[k * 2] = s[2];
+						b[k * 2 + 1] = s[3];
+					}
+
+					float32x4x2_t t = vzipq_f32(fract, fract);
+
+					float32x4_t a0 = vld1q_f32(a);
+					float32x4_t v = vmlaq_f32(a0, vsubq_f32(vld1q_f32(b), a0), t.val[0]);
+					vst1q_f32(o, vmlaq_f32(vld1q_f32(o), v, gain));
+
+					float32x4_t a1 = vld1q_f32(a + 4);
+					v = vmlaq_f32(a1, vsubq_f32(vld1q_f32(b + 4), a1), t.val[1]);
+					vst1q_f32(o + 4, vmlaq_f32(vld1q_f32(o + 4), v, gain));
+				}
+				else
+				{
+					float a[4], b[4];
+					for (int k = 0; k < 4; k++)
+					{
+						a[k] = src[f[k]];
+						b[k] = src[f[k] + 1];
+					}
+
+					float32x4_t a0 = vld1q_f32(a);
+					float32x4_t v = vmlaq_f32(a0, vsubq_f32(vld1q_f32(b), a0), fract);
+					float32x4x2_t lr = vzipq_f32(v, v);
+
+					vst1q_f32(o, vmlaq_f32(vld1q_f32(o), lr.val[0], gain));
+					vst1q_f32(o + 4, vmlaq_f32(vld1q_f32(o + 4), lr.val[1], gain));
+				}
+			}
+#endif
+			for (; i < nbSample; i++)
+			{
+				float position = i * rateRatio;
+
+				int frame = (int)position;
+				if (frame >= lastFrame)
+					break;
+
+				float fract = position - (float)frame;
+
+				if (numChannels == 2)
+				{
+					const short* s = src + frame * 2;
+					out[i * 2] += (s[0] + (s[2] - s[0]) * fract) * leftGain;
+					out[i * 2 + 1] += (s[1] + (s[3] - s[1]) * fract) * rightGain;
+				}
+				else
+				{
+					const short* s = src + frame;
+					float value = s[0] + (s[1] - s[0]) * fract;
+					out[i * 2] += value * leftGain;
+					out[i * 2 + 1] += value * rightGain;
+				}
+			}
+		}
+
 		CSoundSource::CSoundSource(float length)
 		{
 			m_bitPerSample = 16;		// 16 bit
 			m_bufferDuration = length;	// s
 			m_driverBuffer = 0;
+			m_uploadBuffer = 0;
+			m_numDriverBuffer = 0;
+			m_buffers = NULL;
 			m_state = ISoundSource::StateInitial;
 			m_mutex = IMutex::createMutex();
 			
@@ -46,19 +265,26 @@ namespace Skylicht
 			m_pitch = 1.0f;
 			m_rollOff = 10.0f;		// 10m
 			m_is3DSound = false;
+			
+			m_mixParams.Gain = m_gain;
+			m_mixParams.Pitch = m_pitch;
+			m_mixParams.RollOff = m_rollOff;
+			m_mixParams.Is3DSound = m_is3DSound;
+			m_needPushParams = false;
 		}
 		
 		CSoundSource::~CSoundSource()
 		{
-			for (int i = 0, n = (int)m_buffers.size(); i < n; i++)
+			for (int i = 0; i < m_numDriverBuffer; i++)
 			{
 				if (m_buffers[i].Data != NULL)
 				{
-					delete m_buffers[i].Data;
+					delete[] m_buffers[i].Data;
 					m_buffers[i].Data = NULL;
 				}
 			}
 			
+			delete[] m_buffers;
 			delete m_mutex;
 		}
 		
@@ -78,10 +304,10 @@ namespace Skylicht
 			m_bufferSize = m_bufferSize * m_numChannels * m_bitPerSample / 8;
 			
 			// init driver buffer
+			m_buffers = new SDriverBuffer[m_numDriverBuffer];
 			for (int i = 0; i < m_numDriverBuffer; i++)
 			{
-				m_buffers.push_back(SDriverBuffer());
-				SDriverBuffer& buffer = m_buffers.back();
+				SDriverBuffer& buffer = m_buffers[i];
 				
 				buffer.Data = NULL;
 				buffer.Free = true;
@@ -108,13 +334,15 @@ namespace Skylicht
 		
 		bool CSoundSource::needData()
 		{
-			SScopeMutex scopeLock(m_mutex);
-			return m_buffers[m_driverBuffer].Free;
+			// retry the params, that the queue was full
+			if (m_needPushParams)
+				pushParams();
+			
+			return m_buffers[m_uploadBuffer].Free.load(std::memory_order_acquire);
 		}
 		
 		void CSoundSource::play()
 		{
-			SScopeMutex scopeLock(m_mutex);
 			if (m_state == ISoundSource::StateInitial)
 				return;
 			m_state = ISoundSource::StatePlaying;
@@ -122,7 +350,6 @@ namespace Skylicht
 		
 		void CSoundSource::stop()
 		{
-			SScopeMutex scopeLock(m_mutex);
 			if (m_state == ISoundSource::StateInitial)
 				return;
 			m_state = ISoundSource::StateStopped;
@@ -130,7 +357,6 @@ namespace Skylicht
 		
 		void CSoundSource::pause()
 		{
-			SScopeMutex scopeLock(m_mutex);
 			if (m_state == ISoundSource::StateInitial)
 				return;
 			m_state = ISoundSource::StatePause;
@@ -138,7 +364,6 @@ namespace Skylicht
 		
 		void CSoundSource::reset()
 		{
-			SScopeMutex scopeLock(m_mutex);
 			if (m_state == ISoundSource::StateInitial)
 				return;
 			m_state = ISoundSource::StateStopped;
@@ -146,7 +371,7 @@ namespace Skylicht
 		
 		ISoundSource::ESourceState CSoundSource::getState()
 		{
-			return m_state;
+			return (ISoundSource::ESourceState)m_state.load();
 		}
 		
 		void CSoundSource::setState(ESourceState state)
@@ -165,32 +390,41 @@ namespace Skylicht
 		
 		void CSoundSource::uploadData(void* soundData, unsigned int bufferSize)
 		{
-			SScopeMutex scopeLock(m_mutex);
+			SDriverBuffer& buffer = m_buffers[m_uploadBuffer];
 			
-			if (m_buffers[m_driverBuffer].Data == NULL)
+			// the mixer has not played this buffer (see needData)
+			if (!buffer.Free.load(std::memory_order_acquire))
+				return;
+			
+			if (buffer.Data == NULL)
 			{
 				// alloc new
-				m_buffers[m_driverBuffer].Data = new unsigned char[bufferSize];
-				memset(m_buffers[m_driverBuffer].Data, 0, bufferSize);
+				buffer.Data = new unsigned char[bufferSize];
+				memset(buffer.Data, 0, bufferSize);
 			}
 			else
 			{
-				if (m_buffers[m_driverBuffer].TotalSize < bufferSize)
+				if (buffer.TotalSize < bufferSize)
 				{
-					delete m_buffers[m_driverBuffer].Data;
+					delete[] buffer.Data;
 					
 					// re-alloc new size
-					m_buffers[m_driverBuffer].Data = new unsigned char[bufferSize];
-					memset(m_buffers[m_driverBuffer].Data, 0, bufferSize);
+					buffer.Data = new unsigned char[bufferSize];
+					memset(buffer.Data, 0, bufferSize);
 				}
 			}
 			
 			// copy data
-			memcpy(m_buffers[m_driverBuffer].Data, soundData, bufferSize);
+			memcpy(buffer.Data, soundData, bufferSize);
+			
+			buffer.UsedSize = bufferSize;
+			buffer.TotalSize = bufferSize;
+			
+			// hand off to the mixer
+			buffer.Free.store(false, std::memory_order_release);
 			
-			m_buffers[m_driverBuffer].UsedSize = bufferSize;
-			m_buffers[m_driverBuffer].TotalSize = bufferSize;
-			m_buffers[m_driverBuffer].Free = false;
+			m_uploadBuffer++;
+			m_uploadBuffer %= m_numDriverBuffer;
 		}
 		
 		void CSoundSource::lockThread()
@@ -203,116 +437,114 @@ namespace Skylicht
 			m_mutex->unlock();
 		}
 		
-		void CSoundSource::fillBuffer(int* buffer, int nbSample, float gain)
+		bool CSoundSource::fillBuffer(float* buffer, int nbSample, float gain)
 		{
-			SScopeMutex scopeLock(m_mutex);
+			// apply the params from game thread
+			SSourceParams params;
+			while (m_paramsQueue.pop(params))
+				m_mixParams = params;
 			
-			short* sourceBuffer = (short*)m_buffers[m_driverBuffer].Data;
+			SDriverBuffer& driverBuffer = m_buffers[m_driverBuffer];
 			
-			if (sourceBuffer == NULL || m_trackParams.BitsPerSample != 16)
-				return;
+			// the uploader has not fill this buffer
+			if (driverBuffer.Free.load(std::memory_order_acquire))
+				return false;
+			
+			short* sourceBuffer = (short*)driverBuffer.Data;
 			
 			m_distanceGain = 1.0f;
 			m_leftGain = 1.0f;
 			m_rightGain = 1.0f;
 			
-			if (m_is3DSound)
+			if (m_mixParams.Is3DSound)
 			{
 				// calc left, right, distance gain
 				update3D();
 			}
 			
-			float rateRatio = m_trackParams.SamplingRate / (float)m_driverSamplingRate;
-			
-			float pitch = rateRatio;
-			float currentSample = 0;
+			float leftGain = m_leftGain * m_mixParams.Gain * m_distanceGain * gain;
+			float rightGain = m_rightGain * m_mixParams.Gain * m_distanceGain * gain;
 			
-			int sample = 0;
+			bool audible = sourceBuffer != NULL &&
+				m_trackParams.BitsPerSample == 16 &&
+				(leftGain > SKYLICHTAUDIO_VIRTUAL_GAIN || rightGain > SKYLICHTAUDIO_VIRTUAL_GAIN) &&
+				m_mixParams.Pitch >= SKYLICHTAUDIO_MIN_PITCH && m_mixParams.Pitch <= SKYLICHTAUDIO_MAX_PITCH;
 			
-			float leftGain = m_leftGain * m_gain * m_distanceGain * gain;
-			float rightGain = m_rightGain * m_gain * m_distanceGain * gain;
-			
-			int sampleValue = 0;
-			float fract = 0.0f;
-			
-			// do not need mix
-			if (m_gain > 0.0f && m_distanceGain > 0.0f && m_pitch >= SKYLICHTAUDIO_MIN_PITCH && m_pitch <= SKYLICHTAUDIO_MAX_PITCH)
+			// the virtual voice just consumes the buffer
+			if (audible)
 			{
-				if (m_trackParams.NumChannels == 2)
+				int numFrame = driverBuffer.UsedSize / (2 * m_trackParams.NumChannels);
+				
+				if (m_trackParams.SamplingRate == m_driverSamplingRate)
 				{
-					// Mix STEREO
-					for (int i = 0; i < nbSample; ++i)
-					{
-						sample = (int)currentSample;
-						fract = currentSample - sample;
-						
-						// left
-						sampleValue = (int)(sourceBuffer[sample * 2] * (1.0f - fract) + sourceBuffer[sample * 2 + 2] * fract);
-						*buffer += (int)(sampleValue * leftGain);
-						++buffer;
-						
-						// right
-						sampleValue = (int)(sourceBuffer[sample * 2 + 1] * (1.0f - fract) + sourceBuffer[sample * 2 + 3] * fract);
-						*buffer += (int)(sampleValue * rightGain);
-						++buffer;
-						
-						currentSample = i * pitch;
-					}
+					mixSameRate(sourceBuffer, m_trackParams.NumChannels, buffer, nbSample < numFrame ? nbSample : numFrame, leftGain, rightGain);
 				}
 				else
 				{
-					// Mix MONO
-					for (int i = 0; i < nbSample; i++)
-					{
-						sample = (int)currentSample;
-						fract = currentSample - sample;
-						
-						sampleValue = (int)(sourceBuffer[sample] * (1.0f - fract) + sourceBuffer[sample + 1] * fract);
-						
-						// left
-						*buffer += (int)(sampleValue * leftGain);
-						++buffer;
-						
-						// right
-						*buffer += (int)(sampleValue * rightGain);
-						++buffer;
-						
-						currentSample = i * pitch;
-					}
+					float rateRatio = m_trackParams.SamplingRate / (float)m_driverSamplingRate;
+					mixResample(sourceBuffer, numFrame, m_trackParams.NumChannels, buffer, nbSample, rateRatio, leftGain, rightGain);
 				}
 			}
 			
 			// begin to upload data
-			m_buffers[m_driverBuffer].Free = true;
+			driverBuffer.Free.store(true, std::memory_order_release);
 			
 			// swap buffer
 			m_driverBuffer++;
 			m_driverBuffer %= m_numDriverBuffer;
+			
+			return audible;
+		}
+		
+		void CSoundSource::pushParams()
+		{
+			SSourceParams params;
+			params.Gain = m_gain;
+			params.Pitch = m_pitch;
+			params.Position = m_position;
+			params.RollOff = m_rollOff;
+			params.Is3DSound = m_is3DSound;
+			
+			// the queue is full (the mixer is suspended), push again on the next call
+			m_needPushParams = !m_paramsQueue.push(params);
 		}
 		
 		void CSoundSource::setGain(float gain)
 		{
+			if (m_gain == gain && !m_needPushParams)
+				return;
 			m_gain = gain;
+			pushParams();
 		}
 		
 		void CSoundSource::setPitch(float pitch)
 		{
+			if (m_pitch == pitch && !m_needPushParams)
+				return;
 			m_pitch = pitch;
+			pushParams();
 		}
 		
 		void CSoundSource::setPosition(const SVector3& pos)
 		{
 			m_position = pos;
+			pushParams();
 		}
 		
 		void CSoundSource::setRollOff(float rollOff)
 		{
+			if (m_rollOff == rollOff && !m_needPushParams)
+				return;
 			m_rollOff = rollOff;
+			pushParams();
 		}
 		
 		void CSoundSource::set3DSound(bool b)
 		{
+			if (m_is3DSound == b && !m_needPushParams)
+				return;
 			m_is3DSound = b;
+			pushParams();
 		}
 		
 		float CSoundSource::getGain()
@@ -350,19 +582,22 @@ namespace Skylicht
 		
 		float CSoundSource::calcDistanceGain(const SListener& listener)
 		{
+			const SVector3& position = m_mixParams.Position;
+			
 			SVector3 dis;
-			dis.X = m_position.X - listener.Position.X;
-			dis.Y = m_position.Y - listener.Position.Y;
-			dis.Z = m_position.Z - listener.Position.Z;
+			dis.X = position.X - listener.Position.X;
+			dis.Y = position.Y - listener.Position.Y;
+			dis.Z = position.Z - listener.Position.Z;
 			
 			float distance = sqrtf(dis.X * dis.X + dis.Y * dis.Y + dis.Z * dis.Z);
+			float rollOff = m_mixParams.RollOff;
 			
 			if (distance == 0.0f)
 				distance = 0.1f;
-			if (m_rollOff == 0.0f)
-				m_rollOff = 0.1f;
+			if (rollOff == 0.0f)
+				rollOff = 0.1f;
 			
-			float gain = 1.0f - distance / m_rollOff;
+			float gain = 1.0f - distance / rollOff;
 			
 			if (gain < 0.0f)
 				gain = 0.0f;
@@ -374,9 +609,11 @@ namespace Skylicht
 		
 		void CSoundSource::calcLeftRightGain(const SListener& listener, float& left, float& right)
 		{
-			float soundX = m_position.X - listener.Position.X;
-			float soundY = m_position.Y - listener.Position.Y;
-			float soundZ = m_position.Z - listener.Position.Z;
+			const SVector3& position = m_mixParams.Position;
+			
+			float soundX = position.X - listener.Position.X;
+			float soundY = position.Y - listener.Position.Y;
+			float soundZ = position.Z - listener.Position.Z;
 			
 			// Calculate the norm of the source (relative) position vector.
 			float  soundNorm = sqrtf(soundX * soundX + soundY * soundY + soundZ * soundZ);
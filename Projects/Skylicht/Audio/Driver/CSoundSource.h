@@ -26,16 +26,31 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "stdafx.h"
 #include "Thread/IMutex.h"
+#include "Thread/CSPSCQueue.h"
 #include "ISoundSource.h"
 
 using namespace Skylicht::System;
 
+// the voice that has the gain under this value is virtual (it keeps playing, but does not mix)
+#define SKYLICHTAUDIO_VIRTUAL_GAIN 0.0001f
+
 namespace Skylicht
 {
 	namespace Audio
 	{
 		class CSoundSource : public ISoundSource
 		{
+		public:
+			// the params that the game thread sends to the mixer
+			struct SSourceParams
+			{
+				float Gain;
+				float Pitch;
+				SVector3 Position;
+				float RollOff;
+				bool Is3DSound;
+			};
+
 		public:
 			CSoundSource(float length);
 			virtual ~CSoundSource();
@@ -63,7 +78,9 @@ namespace Skylicht
 			virtual void lockThread();
 			virtual void unlockThread();
 			
-			virtual void fillBuffer(int* buffer, int nbSample, float gain = 1.0f);
+			/// @brief Mix the current buffer to the float stereo buffer, call on the mixer thread.
+			/// @return false if the voice is virtual (too quiet) or has no data, nothing is mixed.
+			virtual bool fillBuffer(float* buffer, int nbSample, float gain = 1.0f);
 			
 			virtual void setGain(float gain);
 			virtual void setPitch(float pitch);
@@ -80,6 +97,7 @@ namespace Skylicht
 			virtual int getSampleRate();
 			
 		protected:
+			void pushParams();
 			void update3D();
 			float calcDistanceGain(const SListener& listener);
 			void calcLeftRightGain(const SListener& listener, float& left, float& right);
@@ -87,6 +105,7 @@ namespace Skylicht
 			STrackParams m_trackParams;
 			int m_numDriverBuffer;
 			int m_driverBuffer;
+			int m_uploadBuffer;
 			int m_driverBufferSize;
 			int m_driverSamplingRate;
 			
@@ -95,12 +114,11 @@ namespace Skylicht
 			int m_bitPerSample;
 			int m_numChannels;
 			
-			std::vector<SDriverBuffer> m_buffers;
+			// the ring of buffers, the uploader and the mixer hand off them by SDriverBuffer::Free
+			SDriverBuffer* m_buffers;
 			IMutex* m_mutex;
 			
-			float m_distanceGain;
-			float m_leftGain;
-			float m_rightGain;
+			// the params on the game thread
 			float m_gain;
 			float m_pitch;
 			
@@ -108,7 +126,16 @@ namespace Skylicht
 			SVector3 m_position;
 			float m_rollOff;
 			
-			ISoundSource::ESourceState m_state;
+			bool m_needPushParams;
+			CSPSCQueue<SSourceParams, 32> m_paramsQueue;
+			
+			// the params on the mixer thread
+			SSourceParams m_mixParams;
+			float m_distanceGain;
+			float m_leftGain;
+			float m_rightGain;
+			
+			std::atomic<int> m_state;
 		};
 	}
 }
@@ -25,6 +25,8 @@ https://github.com/skylicht-lab/skylicht-engine
 #ifndef _ISOUND_SOURCE_H_
 #define _ISOUND_SOURCE_H_
 
+#include <atomic>
+
 namespace Skylicht
 {
 	namespace Audio
@@ -65,7 +67,9 @@ namespace Skylicht
 			unsigned char* Data;
 			unsigned int UsedSize; // In bytes.
 			unsigned int TotalSize; // In bytes.
-			bool Free;
+
+			// the buffer is owned by the uploader when free, else by the mixer
+			std::atomic<bool> Free;
 		};
 		
 		struct SVector3
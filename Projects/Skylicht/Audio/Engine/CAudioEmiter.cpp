@@ -93,6 +93,7 @@ namespace Skylicht
 			m_rollOff = 10.0f;	// 10m
 			m_is3DSound = false;
 			m_currentTime = 0.0f;
+			m_lastUpdateTime = 0.0f;
 
 			m_loop = false;
 			m_cache = false;
@@ -290,8 +291,20 @@ namespace Skylicht
 		}
 
 		void CAudioEmitter::update()
+		{
+			if (updateState())
+				decode();
+		}
+
+		bool CAudioEmitter::updateState()
 		{
 			SScopeMutex scopelock(m_mutex);
+
+			// the time from last update for the fade
+			float now = IThread::getTime();
+			float dt = m_lastUpdateTime > 0.0f ? now - m_lastUpdateTime : 0.0f;
+			m_lastUpdateTime = now;
+
 			if (m_init == true)
 			{
 				EStatus status = initEmitter();
@@ -317,30 +330,35 @@ namespace Skylicht
 				else
 				{
 					// need wait download data stream
-					return;
+					return false;
 				}
 			}
 
 			if (m_decoder == NULL || m_source == NULL)
-				return;
+			{
+				// drop the commands, they need the decoder
+				SCommand command;
+				while (m_commands.pop(command));
+				return false;
+			}
+
+			// the commands from game thread
+			processCommands();
 
 			// sync state
-			if (m_source)
-			{
-				m_source->setState(m_state);
-				m_source->set3DSound(m_is3DSound);
+			m_source->setState(m_state);
+			m_source->set3DSound(m_is3DSound);
 
-				if (m_is3DSound)
-				{
-					m_source->setPosition(m_position);
-					m_source->setRollOff(m_rollOff);
-				}
+			if (m_is3DSound)
+			{
+				m_source->setPosition(m_position);
+				m_source->setRollOff(m_rollOff);
+			}
 
-				if (m_bufferSize != m_source->getBufferSize())
-				{
-					// update buffer when driver is changed duration
-					updateSourceBuffer();
-				}
+			if (m_bufferSize != m_source->getBufferSize())
+			{
+				// update buffer when driver is changed duration
+				updateSourceBuffer();
 			}
 
 			// force play (fix play when source is not init)
@@ -352,14 +370,13 @@ namespace Skylicht
 			}
 
 			// sync decoder
-			if (m_decoder)
-				m_decoder->setLoop(m_loop);
+			m_decoder->setLoop(m_loop);
 
-			// todo update fadeout
+			// update fadeout
 			if (m_fadeout > 0.0f)
 			{
-				m_fadeout = m_fadeout - 1000.0f / 30.0f;
-				if (m_fadeout < 0.0f)
+				m_fadeout = m_fadeout - dt;
+				if (m_fadeout <= 0.0f)
 				{
 					m_fadeout = -1.0f;
 
@@ -368,14 +385,9 @@ namespace Skylicht
 						m_stopWithFade = -1.0f;
 
 						// todo stop
-						if (m_buffer)
-						{
-							for (int i = 0; i < m_numBuffer; i++)
-								memset(m_buffer[i], 0, m_bufferSize);
-						}
+						clearBuffer();
 
-						if (m_decoder)
-							m_decoder->seek(0);
+						m_decoder->seek(0);
 
 						m_gain = 1.0f;
 						m_state = ISoundSource::StateStopped;
@@ -385,6 +397,7 @@ namespace Skylicht
 					}
 					else
 					{
+						m_gain = m_fadeGain;
 						m_playWithFade = -1.0f;
 					}
 				}
@@ -397,88 +410,33 @@ namespace Skylicht
 				}
 			}
 
-			EStatus decodeResult;
+			// update gain
+			m_source->setGain(m_gain);
+			m_source->setPitch(m_pitch);
 
-			// todo update emitter
 			if (m_state == ISoundSource::StatePlaying)
-			{
-				if (m_source->needData() == true && m_decoder != NULL)
-				{
-					if (m_pitch == 1.0f)
-					{
-						// printf("m_decoder::decode %d\n", m_bufferSize);
-						decodeResult = m_decoder->decode(m_buffer[m_currentBuffer], m_bufferSize);
-					}
-					else
-					{
-						int pitchSize = (int)(m_bufferSize * m_pitch);
-
-						memset(m_buffer[m_currentBuffer], 0, m_allocBufferSize);
-						memset(m_decodeBuffer, 0, (int)(m_allocBufferSize * SKYLICHTAUDIO_MAX_PITCH));
-						
-						decodeResult = m_decoder->decode(m_decodeBuffer, pitchSize);
-
-						STrackParams trackParam;
-						m_decoder->getTrackParam(&trackParam);
-
-						int nbSample = (m_bufferSize / (trackParam.BitsPerSample / 8)) / trackParam.NumChannels;
-
-						short* src = (short*)m_decodeBuffer;
-						short* dest = (short*)m_buffer[m_currentBuffer];
-
-						float currentSample = 0;
-
-						int sample = 0;
+				return m_source->needData();
 
-						// in mono
-						float pitch = pitchSize / (float)m_bufferSize;
-
-						float fract = 0.0f;
-
-						if (trackParam.NumChannels == 2)
-						{
-							// STEREO
-							for (int i = 0; i < nbSample; i++)
-							{
-								sample = (int)currentSample;
-								fract = currentSample - sample;
-
-								// left
-								*dest = (short)(src[sample * 2] * (1.0f - fract) + src[sample * 2 + 2] * fract);
-								++dest;
-
-								// right
-								*dest = (short)(src[sample * 2 + 1] * (1.0f - fract) + src[sample * 2 + 3] * fract);
-								++dest;
-
-								currentSample = i * pitch;
-							}
-						}
-						else
-						{
-							// MONO
-							for (int i = 0; i < nbSample; i++)
-							{
-								sample = (int)currentSample;
-								fract = currentSample - sample;
+			return m_state == ISoundSource::StatePauseWaitData;
+		}
 
-								// mix
-								*dest = (short)(src[sample] * (1.0f - fract) + src[sample + 1] * fract);
-								++dest;
+		void CAudioEmitter::decode()
+		{
+			SScopeMutex scopelock(m_mutex);
 
-								currentSample = i * pitch;
-							}
-						}
+			if (m_decoder == NULL || m_source == NULL)
+				return;
 
-					}
+			if (m_state == ISoundSource::StatePlaying)
+			{
+				// prefetch: fill all the free buffers, so the mixer does not wait the next update
+				while (m_state == ISoundSource::StatePlaying && m_source->needData())
+				{
+					EStatus decodeResult = decodeBuffer();
 
 					// update data to source
 					m_source->uploadData(m_buffer[m_currentBuffer], m_bufferSize);
 
-					// update gain
-					m_source->setGain(m_gain);
-					m_source->setPitch(m_pitch);
-
 					// swap buffer
 					m_currentBuffer++;
 					m_currentBuffer = m_currentBuffer % m_numBuffer;
@@ -508,7 +466,7 @@ namespace Skylicht
 			}
 			else if (m_state == ISoundSource::StatePauseWaitData)
 			{
-				decodeResult = m_decoder->decode(m_buffer[m_currentBuffer], m_bufferSize);
+				EStatus decodeResult = m_decoder->decode(m_buffer[m_currentBuffer], m_bufferSize);
 
 				if (decodeResult == Success)
 				{
@@ -523,99 +481,246 @@ namespace Skylicht
 					int seekBufferSize = (int)(trackParam.SamplingRate * (m_currentTime / 1000.0f)) * 4;
 					m_decoder->seek(seekBufferSize);
 
-					if (m_source)
-					{
-						m_source->lockThread();
+					clearBuffer();
+				}
+			}
+		}
 
-						if (m_buffer)
-						{
-							for (int i = 0; i < m_numBuffer; i++)
-								memset(m_buffer[i], 0, m_bufferSize);
-						}
+		EStatus CAudioEmitter::decodeBuffer()
+		{
+			if (m_pitch == 1.0f)
+				return m_decoder->decode(m_buffer[m_currentBuffer], m_bufferSize);
 
-						m_source->unlockThread();
-					}
+			int pitchSize = (int)(m_bufferSize * m_pitch);
+
+			memset(m_buffer[m_currentBuffer], 0, m_allocBufferSize);
+			memset(m_decodeBuffer, 0, (int)(m_allocBufferSize * SKYLICHTAUDIO_MAX_PITCH));
+
+			EStatus decodeResult = m_decoder->decode(m_decodeBuffer, pitchSize);
+
+			STrackParams trackParam;
+			m_decoder->getTrackParam(&trackParam);
+
+			int nbSample = (m_bufferSize / (trackParam.BitsPerSample / 8)) / trackParam.NumChannels;
+
+			short* src = (short*)m_decodeBuffer;
+			short* dest = (short*)m_buffer[m_currentBuffer];
+
+			float currentSample = 0;
+
+			int sample = 0;
+
+			// in mono
+			float pitch = pitchSize / (float)m_bufferSize;
+
+			float fract = 0.0f;
+
+			if (trackParam.NumChannels == 2)
+			{
+				// STEREO
+				for (int i = 0; i < nbSample; i++)
+				{
+					sample = (int)currentSample;
+					fract = currentSample - sample;
+
+					// left
+					*dest = (short)(src[sample * 2] * (1.0f - fract) + src[sample * 2 + 2] * fract);
+					++dest;
+
+					// right
+					*dest = (short)(src[sample * 2 + 1] * (1.0f - fract) + src[sample * 2 + 3] * fract);
+					++dest;
+
+					currentSample = i * pitch;
 				}
+			}
+			else
+			{
+				// MONO
+				for (int i = 0; i < nbSample; i++)
+				{
+					sample = (int)currentSample;
+					fract = currentSample - sample;
 
+					// mix
+					*dest = (short)(src[sample] * (1.0f - fract) + src[sample + 1] * fract);
+					++dest;
+
+					currentSample = i * pitch;
+				}
 			}
+
+			return decodeResult;
 		}
 
-		void CAudioEmitter::stopWithFade(float time)
+		void CAudioEmitter::clearBuffer()
 		{
-			m_fadeGain = m_gain;
-			m_fadeout = time;
-			m_stopWithFade = time;
-			m_playWithFade = -1.0f;
+			// silent buffer
+			// fix bug dirty sample
+			if (m_buffer)
+			{
+				for (int i = 0; i < m_numBuffer; i++)
+					memset(m_buffer[i], 0, m_bufferSize);
+			}
 		}
 
-		void CAudioEmitter::playWithFade(float gain, float time)
+		void CAudioEmitter::pushCommand(const SCommand& command)
 		{
-			m_fadeGain = gain;
-			m_gain = 0.0f;
-			play();
-			m_fadeout = time;
-			m_playWithFade = time;
-			m_stopWithFade = -1.0f;
+			if (!m_commands.push(command))
+			{
+				// the ring is full (the audio thread is busy), apply on this thread
+				SScopeMutex scopelock(m_mutex);
+				processCommands();
+				applyCommand(command);
+			}
+
+			// the audio thread process it now
+			CAudioEngine::wakeUpEngine();
 		}
 
-		void CAudioEmitter::seek(float time)
+		void CAudioEmitter::processCommands()
 		{
-			if (m_decoder == NULL && m_init == true)
-				return;
+			SCommand command;
+			while (m_commands.pop(command))
+				applyCommand(command);
+		}
 
-			SScopeMutex scopelock(m_mutex);
+		void CAudioEmitter::applyCommand(const SCommand& command)
+		{
+			switch (command.Type)
+			{
+			case SCommand::Play:
+				m_fadeout = -1.0f;
+				m_stopWithFade = -1.0f;
+				m_state = ISoundSource::StatePlaying;
 
-			STrackParams trackParam;
-			m_decoder->getTrackParam(&trackParam);
+				if (command.Flag && m_decoder)
+					m_decoder->seek(0);
 
-			int seekBufferSize = (int)(trackParam.SamplingRate * (time / 1000.0f)) * 2 * trackParam.NumChannels;
-			m_decoder->seek(seekBufferSize);
+				if (m_source)
+					m_source->play();
+				else
+					m_forcePlay = true;
 
-			if (m_state != ISoundSource::StatePause && m_source)
-			{
-				m_source->lockThread();
+				// CAudioEngine::getSoundEngine()->pushEvent(EVENT_PLAYING);
+				break;
+			case SCommand::Stop:
+				clearBuffer();
 
-				if (m_buffer)
+				if (m_decoder)
+					m_decoder->seek(0);
+
+				m_state = ISoundSource::StateStopped;
+				if (m_source)
+					m_source->stop();
+				break;
+			case SCommand::Pause:
+				clearBuffer();
+
+				// CAudioEngine::getSoundEngine()->pushEvent(EVENT_PAUSE);
+				m_state = ISoundSource::StatePause;
+
+				if (m_source)
+					m_source->pause();
+				break;
+			case SCommand::Reset:
+				m_state = ISoundSource::StateStopped;
+				if (m_source)
+					m_source->stop();
+				break;
+			case SCommand::StopStream:
+				m_state = ISoundSource::StateStopped;
+				if (m_source)
+					m_source->stop();
+				if (m_decoder)
+					m_decoder->stopStream();
+				break;
+			case SCommand::Seek:
+				if (m_decoder)
 				{
-					for (int i = 0; i < m_numBuffer; i++)
-						memset(m_buffer[i], 0, m_bufferSize);
-				}
+					STrackParams trackParam;
+					m_decoder->getTrackParam(&trackParam);
+
+					float time = command.Value[0];
+					int seekBufferSize = (int)(trackParam.SamplingRate * (time / 1000.0f)) * 2 * trackParam.NumChannels;
+					m_decoder->seek(seekBufferSize);
 
-				m_source->unlockThread();
+					if (m_state != ISoundSource::StatePause)
+						clearBuffer();
+
+					m_currentTime = time;
+				}
+				break;
+			case SCommand::StopWithFade:
+				m_fadeGain = m_gain;
+				m_fadeout = command.Value[0];
+				m_stopWithFade = command.Value[0];
+				m_playWithFade = -1.0f;
+				break;
+			case SCommand::PlayWithFade:
+				m_fadeGain = command.Value[0];
+				m_gain = 0.0f;
+				m_fadeout = command.Value[1];
+				m_playWithFade = command.Value[1];
+				m_stopWithFade = -1.0f;
+				break;
+			case SCommand::Position:
+				m_is3DSound = true;
+				m_position.X = command.Value[0];
+				m_position.Y = command.Value[1];
+				m_position.Z = command.Value[2];
+				break;
 			}
+		}
 
-			m_currentTime = time;
+		void CAudioEmitter::stopWithFade(float time)
+		{
+			SCommand command;
+			command.Type = SCommand::StopWithFade;
+			command.Value[0] = time;
+			pushCommand(command);
 		}
 
-		void CAudioEmitter::play(bool fromBegin)
+		void CAudioEmitter::playWithFade(float gain, float time)
 		{
-			m_fadeout = -1.0f;
-			m_stopWithFade = -1.0f;
+			play();
 
-			SScopeMutex scopelock(m_mutex);
-			m_state = ISoundSource::StatePlaying;
+			SCommand command;
+			command.Type = SCommand::PlayWithFade;
+			command.Value[0] = gain;
+			command.Value[1] = time;
+			pushCommand(command);
+		}
 
-			if (fromBegin && m_decoder)
-				m_decoder->seek(0);
+		void CAudioEmitter::seek(float time)
+		{
+			SCommand command;
+			command.Type = SCommand::Seek;
+			command.Value[0] = time;
+			pushCommand(command);
+		}
 
-			if (m_source)
-				m_source->play();
-			else
-				m_forcePlay = true;
+		void CAudioEmitter::play(bool fromBegin)
+		{
+			m_state = ISoundSource::StatePlaying;
 
-			// CAudioEngine::getSoundEngine()->pushEvent(EVENT_PLAYING);
+			SCommand command;
+			command.Type = SCommand::Play;
+			command.Flag = fromBegin;
+			pushCommand(command);
 		}
 
 		void CAudioEmitter::setGain(float g)
 		{
-			// SScopeMutex scopelock(m_mutex);
-			m_gain = g;
+			float gain = g;
 
 			// clamp the gain
-			if (m_gain < SKYLICHTAUDIO_MIN_GAIN)
-				m_gain = SKYLICHTAUDIO_MIN_GAIN;
-			if (m_gain > SKYLICHTAUDIO_MAX_GAIN)
-				m_gain = SKYLICHTAUDIO_MAX_GAIN;
+			if (gain < SKYLICHTAUDIO_MIN_GAIN)
+				gain = SKYLICHTAUDIO_MIN_GAIN;
+			if (gain > SKYLICHTAUDIO_MAX_GAIN)
+				gain = SKYLICHTAUDIO_MAX_GAIN;
+
+			m_gain = gain;
 		}
 
 		void CAudioEmitter::stop()
@@ -623,29 +728,11 @@ namespace Skylicht
 			if (m_state == ISoundSource::StateStopped)
 				return;
 
-			SScopeMutex scopelock(m_mutex);
-
-			// silent buffer
-			// fix bug dirty sample
-			if (m_state != ISoundSource::StateStopped && m_source)
-			{
-				m_source->lockThread();
-
-				if (m_buffer)
-				{
-					for (int i = 0; i < m_numBuffer; i++)
-						memset(m_buffer[i], 0, m_bufferSize);
-				}
-
-				if (m_decoder)
-					m_decoder->seek(0);
-
-				m_source->unlockThread();
-			}
-
 			m_state = ISoundSource::StateStopped;
-			if (m_source)
-				m_source->stop();
+
+			SCommand command;
+			command.Type = SCommand::Stop;
+			pushCommand(command);
 		}
 
 		void CAudioEmitter::pause()
@@ -653,62 +740,46 @@ namespace Skylicht
 			if (m_state == ISoundSource::StatePause)
 				return;
 
-			SScopeMutex scopelock(m_mutex);
-
-			// silent buffer
-			// fix bug dirty sample
-			if (m_state != ISoundSource::StatePause && m_source)
-			{
-				m_source->lockThread();
-
-				if (m_buffer)
-				{
-					for (int i = 0; i < m_numBuffer; i++)
-						memset(m_buffer[i], 0, m_bufferSize);
-				}
-
-				m_source->unlockThread();
-			}
-
-			// CAudioEngine::getSoundEngine()->pushEvent(EVENT_PAUSE);
 			m_state = ISoundSource::StatePause;
 
-			if (m_source)
-				m_source->pause();
+			SCommand command;
+			command.Type = SCommand::Pause;
+			pushCommand(command);
 		}
 
 		void CAudioEmitter::setPitch(float p)
 		{
-			// SScopeMutex scopelock(m_mutex);
-			m_pitch = p;
+			float pitch = p;
 
 			// clamp the pitch
-			if (m_pitch < SKYLICHTAUDIO_MIN_PITCH)
-				m_pitch = SKYLICHTAUDIO_MIN_PITCH;
-			if (m_pitch > SKYLICHTAUDIO_MAX_PITCH)
-				m_pitch = SKYLICHTAUDIO_MAX_PITCH;
+			if (pitch < SKYLICHTAUDIO_MIN_PITCH)
+				pitch = SKYLICHTAUDIO_MIN_PITCH;
+			if (pitch > SKYLICHTAUDIO_MAX_PITCH)
+				pitch = SKYLICHTAUDIO_MAX_PITCH;
+
+			m_pitch = pitch;
 		}
 
 		void CAudioEmitter::reset()
 		{
-			// SScopeMutex scopelock(m_mutex);
 			m_state = ISoundSource::StateStopped;
-			if (m_source)
-				m_source->stop();
+
+			SCommand command;
+			command.Type = SCommand::Reset;
+			pushCommand(command);
 		}
 
 		void CAudioEmitter::stopStream()
 		{
 			m_state = ISoundSource::StateStopped;
-			if (m_source)
-				m_source->stop();
-			if (m_decoder)
-				m_decoder->stopStream();
+
+			SCommand command;
+			command.Type = SCommand::StopStream;
+			pushCommand(command);
 		}
 
 		void CAudioEmitter::setLoop(bool loop)
 		{
-			// SScopeMutex scopelock(m_mutex);
 			m_loop = loop;
 		}
 
@@ -719,16 +790,16 @@ namespace Skylicht
 
 		void CAudioEmitter::setPosition(float x, float y, float z)
 		{
-			// SScopeMutex scopelock(m_mutex);
-			m_is3DSound = true;
-			m_position.X = x;
-			m_position.Y = y;
-			m_position.Z = z;
+			SCommand command;
+			command.Type = SCommand::Position;
+			command.Value[0] = x;
+			command.Value[1] = y;
+			command.Value[2] = z;
+			pushCommand(command);
 		}
 
 		void CAudioEmitter::setRollOff(float rollOff)
 		{
-			// SScopeMutex scopelock(m_mutex);
 			m_rollOff = rollOff;
 		}
 	}
@@ -30,6 +30,9 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "Decoder/IAudioDecoder.h"
 #include "Thread/IMutex.h"
+#include "Thread/CSPSCQueue.h"
+
+#include <atomic>
 
 #define SKYLICHTAUDIO_MIN_PITCH	0.25f
 #define SKYLICHTAUDIO_MAX_PITCH	4.0f
@@ -45,6 +48,35 @@ namespace Skylicht
 	{
 		class CAudioEmitter
 		{
+		public:
+			// the control command that the game thread sends to the audio thread
+			struct SCommand
+			{
+				enum EType
+				{
+					Play,
+					Stop,
+					Pause,
+					Reset,
+					StopStream,
+					Seek,
+					StopWithFade,
+					PlayWithFade,
+					Position
+				};
+
+				EType Type;
+				float Value[3];
+				bool Flag;
+
+				SCommand() :
+					Type(Play),
+					Flag(false)
+				{
+					Value[0] = Value[1] = Value[2] = 0.0f;
+				}
+			};
+
 		protected:
 			std::string m_name;
 			std::string m_fileName;
@@ -57,8 +89,10 @@ namespace Skylicht
 			ISoundSource* m_source;
 			ISoundDriver* m_driver;
 			
-			ISoundSource::ESourceState m_state;
+			std::atomic<ISoundSource::ESourceState> m_state;
 			IAudioDecoder::EDecoderType m_decodeType;
+
+			CSPSCQueue<SCommand, 64> m_commands;
 			
 			unsigned char** m_buffer;
 			unsigned char* m_decodeBuffer;
@@ -88,6 +122,7 @@ namespace Skylicht
 			float m_playWithFade;
 			
 			float m_currentTime;
+			float m_lastUpdateTime;
 		public:
 			
 			static IAudioDecoder::EDecoderType getDecode(const char* fileName);
@@ -97,6 +132,16 @@ namespace Skylicht
 			EStatus initEmitter();
 			
 			void updateSourceBuffer();
+
+			void pushCommand(const SCommand& command);
+
+			void processCommands();
+
+			void applyCommand(const SCommand& command);
+
+			void clearBuffer();
+
+			EStatus decodeBuffer();
 			
 		public:
 			CAudioEmitter(IStream* stream, IAudioDecoder::EDecoderType type, ISoundDriver* driver);
@@ -134,6 +179,14 @@ namespace Skylicht
 			
 			bool init();
 			
+			/// @brief Update the state, the fade and apply the commands, call on the audio thread.
+			/// @return true if the emitter need decode(), it can run on the other thread.
+			virtual bool updateState();
+
+			/// @brief Decode the stream to all the free source buffers.
+			virtual void decode();
+
+			/// @brief updateState() then decode()
 			virtual void update();
 			
 			virtual void play(bool fromBegin = true);
@@ -179,6 +232,12 @@ namespace Skylicht
 			{
 				return m_currentTime;
 			}
+
+			/// @brief The length (s) of a source buffer, 0 if the emitter is not init
+			float getBufferLength()
+			{
+				return m_bufferLengthTime;
+			}
 		};
 	}
 }
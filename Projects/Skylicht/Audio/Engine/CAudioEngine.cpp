@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "stdafx.h"
 #include "CAudioEngine.h"
 #include "CStreamFactory.h"
+#include "SkylichtSystemAPI.h"
 
 // mp3 library
 #include "mpg123.h"
@@ -67,19 +68,31 @@ namespace Skylicht
 			g_engine = NULL;
 		}
 
+		void CAudioEngine::wakeUpEngine()
+		{
+			if (g_engine != NULL)
+				g_engine->wakeUp();
+		}
+
 		CAudioEngine::CAudioEngine() :
-			m_pause(false),
-			m_defaultStreamFactory(NULL),
+			m_thread(NULL),
+			m_decodeJobs(NULL),
 			m_driver(NULL),
-			m_thread(NULL)
+			m_defaultStreamFactory(NULL),
+			m_pause(false),
+			m_wakeUp(false),
+			m_stopThread(false),
+			m_updateTime(SKYLICHTAUDIO_IDLE_UPDATE_TIME)
 		{
 			m_mutex = IMutex::createMutex();
+			m_decodeMutex = IMutex::createMutex();
 		}
 
 		CAudioEngine::~CAudioEngine()
 		{
 			shutdown();
 			delete m_mutex;
+			delete m_decodeMutex;
 		}
 
 		void CAudioEngine::init()
@@ -96,8 +109,12 @@ namespace Skylicht
 				// init mp3 library
 				mpg123_init();
 
+				// the decode workers
+				m_decodeJobs = new CJobSystem(SKYLICHTAUDIO_DECODE_THREADS);
+
 				// start thread
 #ifdef USE_MULTITHREAD_UPDATE
+				m_stopThread = false;
 				m_thread = IThread::createThread(this);
 #else
 				m_thread = NULL;
@@ -110,11 +127,20 @@ namespace Skylicht
 			// stop thread
 			if (m_thread != NULL)
 			{
+				m_stopThread = true;
+				wakeUp();
+
 				m_thread->stop();
 				delete m_thread;
 				m_thread = NULL;
 			}
 
+			if (m_decodeJobs != NULL)
+			{
+				delete m_decodeJobs;
+				m_decodeJobs = NULL;
+			}
+
 			// release emitter
 			destroyAllEmitter();
 
@@ -144,6 +170,9 @@ namespace Skylicht
 				// stop thread
 				if (m_thread != NULL)
 				{
+					m_stopThread = true;
+					wakeUp();
+
 					m_thread->stop();
 					delete m_thread;
 					m_thread = NULL;
@@ -163,7 +192,10 @@ namespace Skylicht
 				// start thread
 #ifdef USE_MULTITHREAD_UPDATE
 				if (m_thread == NULL)
+				{
+					m_stopThread = false;
 					m_thread = IThread::createThread(this);
+				}
 #else
 				m_thread = NULL;
 #endif
@@ -191,37 +223,87 @@ namespace Skylicht
 
 		void CAudioEngine::updateEmitter()
 		{
+			// lock the decode before the emitter list, same order as destroyEmitter
+			m_decodeMutex->lock();
 			m_mutex->lock();
 
-			// todo update sound engine
-			std::vector<CAudioEmitter*>::iterator i = m_emitters.begin(), end = m_emitters.end();
+			m_decodeEmitters.clear();
 
+			// the deadline of the next update: half of the shortest buffer that is playing
+			float updateTime = (float)SKYLICHTAUDIO_IDLE_UPDATE_TIME;
+
+			std::vector<CAudioEmitter*>::iterator i = m_emitters.begin(), end = m_emitters.end();
 			while (i != end)
 			{
 				CAudioEmitter* emitter = (*i);
-				emitter->update();
+
+				if (emitter->updateState())
+					m_decodeEmitters.push_back(emitter);
+
+				if (emitter->getState() == ISoundSource::StatePlaying && emitter->getBufferLength() > 0.0f)
+				{
+					float t = emitter->getBufferLength() * 1000.0f * 0.5f;
+					if (t < updateTime)
+						updateTime = t;
+				}
+
 				++i;
 			}
 
+			m_updateTime = (int)updateTime;
+			if (m_updateTime < 1)
+				m_updateTime = 1;
+
+			// the emitter list is copied to m_decodeEmitters, the main thread can create or play the emitters while decoding
 			m_mutex->unlock();
+
+			// decode the streams on the audio workers
+			int numDecode = (int)m_decodeEmitters.size();
+			if (numDecode > 0)
+			{
+				CAudioEmitter** emitters = m_decodeEmitters.data();
+
+				auto decode = [emitters](int begin, int end)
+					{
+						for (int i = begin; i < end; i++)
+							emitters[i]->decode();
+					};
+
+				if (m_decodeJobs != NULL)
+					m_decodeJobs->parallelFor(numDecode, 1, decode);
+				else
+					decode(0, numDecode);
+			}
+
+			m_decodeMutex->unlock();
 		}
 
 		void CAudioEngine::updateThread()
 		{
-			// todo update in-thread
-			unsigned int tpf = 1000 / 30;
-			float timeBegin = IThread::getTime();
+			if (m_stopThread)
+			{
+				IThread::sleep(1);
+				return;
+			}
 
 			updateEmitter();
 
-			// calc time to sleep
-			float timeEnd = IThread::getTime();
-			float dt = timeEnd - timeBegin;
-			int sleep = tpf - (int)dt;
-			if (sleep < 0)
-				sleep = 1;
+			// sleep until the deadline, the mixer & the emitter commands wake it up sooner
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wakeCondition.wait_for(lock, std::chrono::milliseconds(m_updateTime), [this]()
+				{
+					return m_wakeUp || m_stopThread;
+				});
+			m_wakeUp = false;
+		}
 
-			IThread::sleep(sleep);
+		void CAudioEngine::wakeUp()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_wakeMutex);
+				m_wakeUp = true;
+			}
+			m_wakeCondition.notify_one();
 		}
 
 		void CAudioEngine::registerStreamFactory(IStreamFactory* streamFactory)
@@ -381,6 +463,8 @@ namespace Skylicht
 
 		void CAudioEngine::destroyEmitter(CAudioEmitter* emitter)
 		{
+			// wait the emitter is decoded
+			SScopeMutex lockDecode(m_decodeMutex);
 			SScopeMutex lockScope(m_mutex);
 			std::vector<CAudioEmitter*>::iterator i = m_emitters.begin(), end = m_emitters.end();
 
@@ -426,6 +510,7 @@ namespace Skylicht
 
 		void CAudioEngine::destroyAllEmitter()
 		{
+			SScopeMutex lockDecode(m_decodeMutex);
 			SScopeMutex lockScope(m_mutex);
 			std::vector<CAudioEmitter*>::iterator i = m_emitters.begin(), end = m_emitters.end();
 
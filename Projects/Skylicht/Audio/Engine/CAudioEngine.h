@@ -34,10 +34,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Driver/ISoundDriver.h"
 #include "Thread/IMutex.h"
 #include "Thread/IThread.h"
+#include "Thread/CJobSystem.h"
 
 #include "CAudioEmitter.h"
 #include "CAudioReader.h"
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
 using namespace Skylicht::System;
 
 namespace Skylicht
@@ -57,6 +62,12 @@ namespace Skylicht
 
 			IMutex* m_mutex;
 
+			// it is locked while the streams are decoding, the emitters can't be destroyed
+			IMutex* m_decodeMutex;
+
+			// the decode workers of the audio
+			CJobSystem* m_decodeJobs;
+
 			ISoundDriver* m_driver;
 
 			IStreamFactory* m_defaultStreamFactory;
@@ -65,6 +76,8 @@ namespace Skylicht
 
 			std::vector<CAudioEmitter*> m_emitters;
 
+			std::vector<CAudioEmitter*> m_decodeEmitters;
+
 			std::vector<CAudioReader*> m_readers;
 
 			std::map<std::string, IStream*>	m_fileToStream;
@@ -73,11 +86,21 @@ namespace Skylicht
 
 			bool m_pause;
 
+			// the update thread sleeps until the deadline, or the wake up signal
+			std::mutex m_wakeMutex;
+			std::condition_variable m_wakeCondition;
+			bool m_wakeUp;
+			std::atomic<bool> m_stopThread;
+			int m_updateTime;
+
 		public:
 			static CAudioEngine* getSoundEngine();
 
 			static void shutdownEngine();
 
+			/// @brief Wake up the update thread, call when there are the emitter commands or the mixer consumes the buffers.
+			static void wakeUpEngine();
+
 			CAudioEngine();
 
 			virtual ~CAudioEngine();
@@ -98,6 +121,8 @@ namespace Skylicht
 
 			virtual void updateThread();
 
+			void wakeUp();
+
 			void lockThread()
 			{
 				m_mutex->lock();
@@ -50,3 +50,17 @@ https://github.com/skylicht-lab/skylicht-engine
 #endif
 #endif
 
+
+// SIMD instruction set for the mixer, the code must have the scalar version for the other platforms
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_AUDIO_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_AUDIO_NEON
+#endif
+
+// the update thread wakes up on the emitter commands and when the mixer consumes the buffers,
+// else it waits this time (ms) to poll the streams that wait data
+#define SKYLICHTAUDIO_IDLE_UPDATE_TIME 33
+
+// the worker threads that decode the streams, the audio does not wait the job system of the game
+#define SKYLICHTAUDIO_DECODE_THREADS 2
@@ -50,6 +50,8 @@ namespace Skylicht
 #endif
 
 		Version = "";
+
+		NumJobWorkers = -1;
 	}
 
 	CBuildConfig::~CBuildConfig()
@@ -52,6 +52,9 @@ namespace Skylicht
 
 		std::vector<std::string> APKPath;
 		std::string Version;
+
+		// number of job system workers, -1 is (cpu cores - 1)
+		int NumJobWorkers;
 	};
 
 }
\ No newline at end of file
@@ -163,7 +163,7 @@ namespace Skylicht
 		m_device->getCursorControl()->setReferenceRect(&winRect);
 
 		// init skylicht component
-		Skylicht::initSkylicht(m_device);
+		Skylicht::initSkylicht(m_device, false, CBuildConfig::getInstance()->NumJobWorkers);
 
 #ifdef ANDROID
 		char androidLog[1024];
@@ -0,0 +1,477 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBVHBuilder.h"
+
+#include "Debug/CSceneDebug.h"
+#include "Thread/CJobSystem.h"
+
+#if defined(SKYLICHT_SSE)
+#include <emmintrin.h>
+#elif defined(SKYLICHT_NEON)
+#include <arm_neon.h>
+#endif
+
+
+namespace Skylicht
+{
+#if defined(SKYLICHT_SSE)
+	typedef __m128 float4;
+	typedef __m128 mask4;
+
+	static inline float4 set4(float f) { return _mm_set1_ps(f); }
+	static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+	static inline void store4(float* p, float4 a) { _mm_storeu_ps(p, a); }
+	static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+	static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+	static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+	static inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+	static inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+	static inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+	static inline float4 abs4(float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static inline mask4 le4(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+	static inline mask4 lt4(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+	static inline mask4 and4(mask4 a, mask4 b) { return _mm_and_ps(a, b); }
+	static inline float4 select4(mask4 m, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+	static inline int movemask4(mask4 a) { return _mm_movemask_ps(a); }
+#elif defined(SKYLICHT_NEON)
+	typedef float32x4_t float4;
+	typedef uint32x4_t mask4;
+
+	static inline float4 set4(float f) { return vdupq_n_f32(f); }
+	static inline float4 load4(const float* p) { return vld1q_f32(p); }
+	static inline void store4(float* p, float4 a) { vst1q_f32(p, a); }
+	static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+	static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+	static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+	static inline float4 div4(float4 a, float4 b)
+	{
+		// reciprocal estimate with 2 newton steps
+		float4 r = vrecpeq_f32(b);
+		r = vmulq_f32(vrecpsq_f32(b, r), r);
+		r = vmulq_f32(vrecpsq_f32(b, r), r);
+		return vmulq_f32(a, r);
+	}
+	static inline float4 min4(float4 a, float4 b) { return vminq_f32(a, b); }
+	static inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+	static inline float4 abs4(float4 a) { return vabsq_f32(a); }
+	static inline mask4 le4(float4 a, float4 b) { return vcleq_f32(a, b); }
+	static inline mask4 lt4(float4 a, float4 b) { return vcltq_f32(a, b); }
+	static inline mask4 and4(mask4 a, mask4 b) { return vandq_u32(a, b); }
+	static inline float4 select4(mask4 m, float4 a, float4 b) { return vbslq_f32(m, a, b); }
+	static inline int movemask4(mask4 a)
+	{
+		return (vgetq_lane_u32(a, 0) & 1) |
+			(vgetq_lane_u32(a, 1) & 2) |
+			(vgetq_lane_u32(a, 2) & 4) |
+			(vgetq_lane_u32(a, 3) & 8);
+	}
+#endif
+
+	CBVHBuilder::CBVHBuilder()
+	{
+
+	}
+
+	CBVHBuilder::~CBVHBuilder()
+	{
+		clear();
+	}
+
+	void CBVHBuilder::clear()
+	{
+		m_tree.clear();
+		m_bvhTriangles.clear();
+		m_triangles.clear();
+		m_collisions.clear();
+
+		CCollisionBuilder::clear();
+	}
+
+	void CBVHBuilder::build()
+	{
+		const u32 start = os::Timer::getRealTime();
+
+		m_bvhTriangles.set_used(0);
+		m_triangles.set_used(0);
+		m_collisions.set_used(0);
+
+		u32 numPoly = 0;
+
+		// step 1: update transform and triangles
+		for (u32 i = 0, n = m_nodes.size(); i < n; i++)
+		{
+			m_nodes[i]->updateTransform();
+			numPoly += m_nodes[i]->Triangles.size();
+		}
+
+		// step 2: the bbox of triangles
+		core::array<core::aabbox3df> boxes;
+		boxes.set_used(numPoly);
+
+		m_triangles.set_used(numPoly);
+		m_collisions.set_used(numPoly);
+
+		u32 idx = 0;
+		for (u32 i = 0, n = m_nodes.size(); i < n; i++)
+		{
+			CCollisionNode* node = m_nodes[i];
+
+			u32 numTris = node->Triangles.size();
+			core::triangle3df* tris = node->Triangles.pointer();
+
+			for (u32 j = 0; j < numTris; j++)
+			{
+				core::aabbox3df& box = boxes[idx];
+				box.reset(tris[j].pointA);
+				box.addInternalPoint(tris[j].pointB);
+				box.addInternalPoint(tris[j].pointC);
+
+				m_triangles[idx] = &tris[j];
+				m_collisions[idx] = node;
+				idx++;
+			}
+		}
+
+		// step 3: build the nodes
+		m_tree.build(boxes.const_pointer(), numPoly);
+
+		// step 4: pack the triangles in leaf order
+		core::array<core::triangle3df*> triangles(m_triangles);
+		core::array<CCollisionNode*> collisions(m_collisions);
+
+		const u32* primitives = m_tree.getPrimitives();
+
+		m_bvhTriangles.set_used(numPoly);
+
+		for (u32 i = 0; i < numPoly; i++)
+		{
+			u32 id = primitives[i];
+
+			m_bvhTriangles[i].set(*triangles[id]);
+			m_triangles[i] = triangles[id];
+			m_collisions[i] = collisions[id];
+		}
+
+		c8 tmp[256];
+		sprintf(tmp, "Needed %ums to CBVHBuilder::build (%u polys, %u nodes)", os::Timer::getRealTime() - start, numPoly, m_tree.getNodeCount());
+		os::Printer::log(tmp, ELL_INFORMATION);
+	}
+
+	void CBVHBuilder::drawDebug()
+	{
+		CSceneDebug* debug = CSceneDebug::getInstance();
+
+		const CBVHTree::SNode* nodes = m_tree.getNodes();
+
+		for (u32 i = 0, n = m_tree.getNodeCount(); i < n; i++)
+		{
+			const CBVHTree::SNode& node = nodes[i];
+
+			core::aabbox3df box(
+				node.Min[0], node.Min[1], node.Min[2],
+				node.Max[0], node.Max[1], node.Max[2]);
+
+			debug->addBoudingBox(box, node.Count > 0 ? SColor(255, 255, 0, 0) : SColor(255, 255, 255, 0));
+		}
+	}
+
+	int CBVHBuilder::intersectRay(const core::vector3df& origin, const core::vector3df& dir, f32& tBest)
+	{
+		const SBVHTriangle* triangles = m_bvhTriangles.const_pointer();
+		int hit = -1;
+
+		m_tree.traverseRay(origin, dir, tBest, [triangles, &origin, &dir, &hit](u32 first, u32 count, f32& tBest)
+			{
+				for (u32 i = first, end = first + count; i < end; i++)
+				{
+					f32 t;
+					if (CBVHTree::intersectTriangle(triangles[i], origin, dir, t) && t >= 0.0f && t < tBest)
+					{
+						tBest = t;
+						hit = (int)i;
+					}
+				}
+			});
+
+		return hit;
+	}
+
+	void CBVHBuilder::setResult(SCollisionResult& result, const core::line3df& ray, const core::vector3df& dir, int triangle, f32 t)
+	{
+		if (triangle < 0)
+		{
+			result.Hit = false;
+			result.Node = NULL;
+			return;
+		}
+
+		result.Hit = true;
+		result.DistanceSquared = t * t;
+		result.Intersection = ray.start + dir * t;
+		result.Triangle = *m_triangles[triangle];
+		result.Node = m_collisions[triangle];
+	}
+
+	bool CBVHBuilder::getCollisionPoint(
+		const core::line3d<f32>& ray,
+		f32& outBestDistanceSquared,
+		core::vector3df& outIntersection,
+		core::triangle3df& outTriangle,
+		CCollisionNode*& outNode)
+	{
+		outNode = NULL;
+
+		core::vector3df dir = ray.getVector();
+		f32 length = dir.getLength();
+		if (length <= 0.0f)
+			return false;
+
+		dir /= length;
+
+		// the hit must be on the segment & nearer than the best distance
+		f32 tBest = core::min_(length, sqrtf(outBestDistanceSquared));
+
+		int triangle = intersectRay(ray.start, dir, tBest);
+		if (triangle < 0)
+			return false;
+
+		outBestDistanceSquared = tBest * tBest;
+		outIntersection = ray.start + dir * tBest;
+		outTriangle = *m_triangles[triangle];
+		outNode = m_collisions[triangle];
+		return true;
+	}
+
+	void CBVHBuilder::getCollisionPoints(const core::line3df* rays, SCollisionResult* results, int count)
+	{
+		if (count <= 0)
+			return;
+
+		CBVHBuilder* builder = this;
+
+		int numPacket = (count + 3) / 4;
+
+		System::CJobSystem::runParallelFor(numPacket, 16, [builder, rays, results, count](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					int first = i * 4;
+					builder->intersectPacket(rays + first, results + first, core::min_(4, count - first));
+				}
+			});
+	}
+
+	void CBVHBuilder::intersectPacket(const core::line3df* rays, SCollisionResult* results, int count)
+	{
+		core::vector3df dirs[4];
+		f32 ox[4], oy[4], oz[4], dx[4], dy[4], dz[4], ix[4], iy[4], iz[4], tBest[4];
+		int hit[4] = { -1, -1, -1, -1 };
+
+		for (int i = 0; i < 4; i++)
+		{
+			// the unused lane is a copy of the first ray, but it never hits (tBest < 0)
+			const core::line3df& ray = rays[i < count ? i : 0];
+
+			dirs[i] = ray.getVector();
+			f32 length = dirs[i].getLength();
+
+			if (length > 0.0f)
+				dirs[i] /= length;
+
+			f32 inv[3];
+			CBVHTree::getInvDir(dirs[i], inv);
+
+			ox[i] = ray.start.X;
+			oy[i] = ray.start.Y;
+			oz[i] = ray.start.Z;
+			dx[i] = dirs[i].X;
+			dy[i] = dirs[i].Y;
+			dz[i] = dirs[i].Z;
+			ix[i] = inv[0];
+			iy[i] = inv[1];
+			iz[i] = inv[2];
+			tBest[i] = (i < count && length > 0.0f) ? length : -1.0f;
+		}
+
+		if (m_tree.getNodeCount() > 0)
+		{
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			const CBVHTree::SNode* nodes = m_tree.getNodes();
+			const SBVHTriangle* triangles = m_bvhTriangles.const_pointer();
+
+			float4 Ox = load4(ox), Oy = load4(oy), Oz = load4(oz);
+			float4 Dx = load4(dx), Dy = load4(dy), Dz = load4(dz);
+			float4 Ix = load4(ix), Iy = load4(iy), Iz = load4(iz);
+			float4 T = load4(tBest);
+
+			const float4 zero = set4(0.0f);
+			const float4 one = set4(1.0f);
+			const float4 eps = set4(1e-12f);
+
+			u32 stack[BVH_STACK_SIZE];
+			int sp = 0;
+			stack[sp++] = 0;
+
+			while (sp > 0)
+			{
+				u32 nodeId = stack[--sp];
+				const CBVHTree::SNode& node = nodes[nodeId];
+
+				// slab test of 4 rays
+				float4 t1 = mul4(sub4(set4(node.Min[0]), Ox), Ix);
+				float4 t2 = mul4(sub4(set4(node.Max[0]), Ox), Ix);
+				float4 tmin = min4(t1, t2);
+				float4 tmax = max4(t1, t2);
+
+				t1 = mul4(sub4(set4(node.Min[1]), Oy), Iy);
+				t2 = mul4(sub4(set4(node.Max[1]), Oy), Iy);
+				tmin = max4(tmin, min4(t1, t2));
+				tmax = min4(tmax, max4(t1, t2));
+
+				t1 = mul4(sub4(set4(node.Min[2]), Oz), Iz);
+				t2 = mul4(sub4(set4(node.Max[2]), Oz), Iz);
+				tmin = max4(max4(tmin, min4(t1, t2)), zero);
+				tmax = min4(min4(tmax, max4(t1, t2)), T);
+
+				mask4 active = le4(tmin, tmax);
+				if (movemask4(active) == 0)
+					continue;
+
+				if (node.Count > 0)
+				{
+					for (u32 i = node.Offset, end = node.Offset + node.Count; i < end; i++)
+					{
+						const SBVHTriangle& tri = triangles[i];
+
+						float4 e1x = set4(tri.Edge1.X), e1y = set4(tri.Edge1.Y), e1z = set4(tri.Edge1.Z);
+						float4 e2x = set4(tri.Edge2.X), e2y = set4(tri.Edge2.Y), e2z = set4(tri.Edge2.Z);
+
+						// p = dir x edge2
+						float4 px = sub4(mul4(Dy, e2z), mul4(Dz, e2y));
+						float4 py = sub4(mul4(Dz, e2x), mul4(Dx, e2z));
+						float4 pz = sub4(mul4(Dx, e2y), mul4(Dy, e2x));
+
+						float4 det = add4(add4(mul4(e1x, px), mul4(e1y, py)), mul4(e1z, pz));
+						float4 invDet = div4(one, det);
+
+						// s = origin - a
+						float4 sx = sub4(Ox, set4(tri.A.X));
+						float4 sy = sub4(Oy, set4(tri.A.Y));
+						float4 sz = sub4(Oz, set4(tri.A.Z));
+
+						float4 u = mul4(add4(add4(mul4(sx, px), mul4(sy, py)), mul4(sz, pz)), invDet);
+
+						// q = s x edge1
+						float4 qx = sub4(mul4(sy, e1z), mul4(sz, e1y));
+						float4 qy = sub4(mul4(sz, e1x), mul4(sx, e1z));
+						float4 qz = sub4(mul4(sx, e1y), mul4(sy, e1x));
+
+						float4 v = mul4(add4(add4(mul4(Dx, qx), mul4(Dy, qy)), mul4(Dz, qz)), invDet);
+						float4 t = mul4(add4(add4(mul4(e2x, qx), mul4(e2y, qy)), mul4(e2z, qz)), invDet);
+
+						mask4 m = lt4(eps, abs4(det));
+						m = and4(m, le4(zero, u));
+						m = and4(m, le4(zero, v));
+						m = and4(m, le4(add4(u, v), one));
+						m = and4(m, le4(zero, t));
+						m = and4(m, lt4(t, T));
+
+						int bits = movemask4(m);
+						if (bits)
+						{
+							T = select4(m, t, T);
+
+							for (int k = 0; k < 4; k++)
+							{
+								if (bits & (1 << k))
+									hit[k] = (int)i;
+							}
+						}
+					}
+				}
+				else
+				{
+					u32 left = nodeId + 1;
+					u32 right = node.Offset;
+
+					// visit the near child first (by the direction of the first ray on the split)
+					const CBVHTree::SNode& l = nodes[left];
+					const CBVHTree::SNode& r = nodes[right];
+
+					f32 d = (r.Min[0] + r.Max[0] - l.Min[0] - l.Max[0]) * dx[0] +
+						(r.Min[1] + r.Max[1] - l.Min[1] - l.Max[1]) * dy[0] +
+						(r.Min[2] + r.Max[2] - l.Min[2] - l.Max[2]) * dz[0];
+
+					if (sp + 2 > BVH_STACK_SIZE)
+						continue;
+
+					if (d >= 0.0f)
+					{
+						stack[sp++] = right;
+						stack[sp++] = left;
+					}
+					else
+					{
+						stack[sp++] = left;
+						stack[sp++] = right;
+					}
+				}
+			}
+
+			store4(tBest, T);
+#else
+			for (int i = 0; i < count; i++)
+				hit[i] = intersectRay(rays[i].start, dirs[i], tBest[i]);
+#endif
+		}
+
+		for (int i = 0; i < count; i++)
+			setResult(results[i], rays[i], dirs[i], hit[i], tBest[i]);
+	}
+
+	void CBVHBuilder::getTriangles(const core::aabbox3df& box,
+		core::array<core::triangle3df*>& result,
+		core::array<CCollisionNode*>& nodes)
+	{
+		core::triangle3df** triangles = m_triangles.pointer();
+		CCollisionNode** collisions = m_collisions.pointer();
+
+		m_tree.traverseBox(box, [triangles, collisions, &box, &result, &nodes](u32 first, u32 count)
+			{
+				for (u32 i = first, end = first + count; i < end; i++)
+				{
+					core::triangle3df* triangle = triangles[i];
+
+					// if triangle collide the bbox
+					if (!triangle->isTotalOutsideBox(box))
+					{
+						result.push_back(triangle);
+						nodes.push_back(collisions[i]);
+					}
+				}
+			});
+	}
+}
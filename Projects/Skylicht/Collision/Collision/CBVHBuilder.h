@@ -0,0 +1,99 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CCollisionBuilder.h"
+#include "CBVHTree.h"
+
+namespace Skylicht
+{
+	/// @brief The collision builder that use the bounding volume hierarchy (the surface area heuristic).
+	///
+	/// The triangles are packed in the leaf order of CBVHTree.
+	/// The queries do not change the builder, so they can run on many threads.
+	class CBVHBuilder : public CCollisionBuilder
+	{
+	protected:
+		CBVHTree m_tree;
+
+		core::array<SBVHTriangle> m_bvhTriangles;
+
+		// the source of the packed triangles
+		core::array<core::triangle3df*> m_triangles;
+		core::array<CCollisionNode*> m_collisions;
+
+	public:
+		CBVHBuilder();
+
+		virtual ~CBVHBuilder();
+
+		virtual void build();
+
+		virtual void clear();
+
+		virtual void drawDebug();
+
+		inline u32 getNodeCount()
+		{
+			return m_tree.getNodeCount();
+		}
+
+		inline u32 getTriangleCount()
+		{
+			return m_bvhTriangles.size();
+		}
+
+		/// @brief The max number of triangles in a leaf, the SAH can stop the split before this size.
+		inline void setMaxLeafSize(u32 size)
+		{
+			m_tree.setMaxLeafSize(size);
+		}
+
+	public:
+
+		virtual bool getCollisionPoint(
+			const core::line3d<f32>& ray,
+			f32& outBestDistanceSquared,
+			core::vector3df& outIntersection,
+			core::triangle3df& outTriangle,
+			CCollisionNode*& outNode);
+
+		/// @brief Test the rays in the packets of 4 with SIMD, the packets run on the job system.
+		/// The nearby rays in the array should have the nearby direction for the best performance.
+		virtual void getCollisionPoints(const core::line3df* rays, SCollisionResult* results, int count);
+
+		virtual void getTriangles(const core::aabbox3df& box,
+			core::array<core::triangle3df*>& result,
+			core::array<CCollisionNode*>& nodes);
+
+	protected:
+
+		int intersectRay(const core::vector3df& origin, const core::vector3df& dir, f32& tBest);
+
+		void intersectPacket(const core::line3df* rays, SCollisionResult* results, int count);
+
+		void setResult(SCollisionResult& result, const core::line3df& ray, const core::vector3df& dir, int triangle, f32 t);
+	};
+}
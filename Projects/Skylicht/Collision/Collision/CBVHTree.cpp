@@ -0,0 +1,330 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBVHTree.h"
+
+#define BVH_BIN_COUNT 12
+#define BVH_MAX_DEPTH 60
+#define BVH_TRAVERSAL_COST 1.0f
+
+namespace Skylicht
+{
+	CBVHTree::CBVHTree() :
+		m_maxLeafSize(4)
+	{
+
+	}
+
+	CBVHTree::~CBVHTree()
+	{
+
+	}
+
+	void CBVHTree::clear()
+	{
+		m_nodes.clear();
+		m_primitives.clear();
+		m_parents.clear();
+		m_primitiveLeaf.clear();
+		m_refs.clear();
+	}
+
+	void CBVHTree::build(const core::aabbox3df* boxes, u32 count)
+	{
+		m_nodes.set_used(0);
+		m_primitives.set_used(0);
+		m_parents.set_used(0);
+		m_primitiveLeaf.set_used(0);
+
+		if (count == 0)
+			return;
+
+		m_refs.set_used(count);
+
+		for (u32 i = 0; i < count; i++)
+		{
+			SBuildRef& ref = m_refs[i];
+			ref.Box = boxes[i];
+			ref.Center = boxes[i].getCenter();
+			ref.Id = i;
+		}
+
+		// it sorts the refs in leaf order
+		m_nodes.reallocate(count);
+		buildNode(0, count, 0);
+
+		m_primitives.set_used(count);
+		for (u32 i = 0; i < count; i++)
+			m_primitives[i] = m_refs[i].Id;
+
+		m_refs.clear();
+	}
+
+	void CBVHTree::setNodeBox(SNode& node, const core::aabbox3df& box)
+	{
+		node.Min[0] = box.MinEdge.X;
+		node.Min[1] = box.MinEdge.Y;
+		node.Min[2] = box.MinEdge.Z;
+		node.Max[0] = box.MaxEdge.X;
+		node.Max[1] = box.MaxEdge.Y;
+		node.Max[2] = box.MaxEdge.Z;
+	}
+
+	u32 CBVHTree::buildNode(u32 begin, u32 end, int depth)
+	{
+		u32 nodeId = m_nodes.size();
+		m_nodes.push_back(SNode());
+
+		SBuildRef* refs = m_refs.pointer();
+
+		core::aabbox3df box = refs[begin].Box;
+		core::aabbox3df centerBox(refs[begin].Center);
+
+		for (u32 i = begin + 1; i < end; i++)
+		{
+			box.addInternalBox(refs[i].Box);
+			centerBox.addInternalPoint(refs[i].Center);
+		}
+
+		SNode& node = m_nodes[nodeId];
+		setNodeBox(node, box);
+		node.Offset = begin;
+		node.Count = end - begin;
+
+		u32 count = end - begin;
+		if (count <= 1 || depth >= BVH_MAX_DEPTH)
+			return nodeId;
+
+		// the binned SAH, the cost is relative to the intersection cost of a primitive
+		f32 parentArea = core::max_(box.getArea(), 1e-12f);
+		f32 bestCost = (f32)count;
+		int bestAxis = -1;
+		int bestBin = 0;
+
+		const f32* centerMin = &centerBox.MinEdge.X;
+		const f32* centerMax = &centerBox.MaxEdge.X;
+
+		core::aabbox3df binBox[BVH_BIN_COUNT];
+		u32 binCount[BVH_BIN_COUNT];
+		f32 rightArea[BVH_BIN_COUNT];
+		u32 rightCount[BVH_BIN_COUNT];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			f32 extent = centerMax[axis] - centerMin[axis];
+			if (extent <= 1e-6f)
+				continue;
+
+			f32 scale = BVH_BIN_COUNT * 0.9999f / extent;
+
+			for (int b = 0; b < BVH_BIN_COUNT; b++)
+				binCount[b] = 0;
+
+			for (u32 i = begin; i < end; i++)
+			{
+				const f32* c = &refs[i].Center.X;
+				int b = (int)((c[axis] - centerMin[axis]) * scale);
+
+				if (binCount[b] == 0)
+					binBox[b] = refs[i].Box;
+				else
+					binBox[b].addInternalBox(refs[i].Box);
+
+				binCount[b]++;
+			}
+
+			// sweep from right
+			core::aabbox3df accBox;
+			u32 accCount = 0;
+			for (int b = BVH_BIN_COUNT - 1; b > 0; b--)
+			{
+				if (binCount[b] > 0)
+				{
+					if (accCount == 0)
+						accBox = binBox[b];
+					else
+						accBox.addInternalBox(binBox[b]);
+					accCount += binCount[b];
+				}
+				rightArea[b] = accCount > 0 ? accBox.getArea() : 0.0f;
+				rightCount[b] = accCount;
+			}
+
+			// sweep from left, split after the bin b
+			accCount = 0;
+			for (int b = 0; b < BVH_BIN_COUNT - 1; b++)
+			{
+				if (binCount[b] > 0)
+				{
+					if (accCount == 0)
+						accBox = binBox[b];
+					else
+						accBox.addInternalBox(binBox[b]);
+					accCount += binCount[b];
+				}
+
+				if (accCount == 0 || rightCount[b + 1] == 0)
+					continue;
+
+				f32 cost = BVH_TRAVERSAL_COST + (accBox.getArea() * accCount + rightArea[b + 1] * rightCount[b + 1]) / parentArea;
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = b;
+				}
+			}
+		}
+
+		u32 mid = begin;
+
+		if (bestAxis >= 0)
+		{
+			// split at the best bin
+			f32 cmin = centerMin[bestAxis];
+			f32 scale = BVH_BIN_COUNT * 0.9999f / (centerMax[bestAxis] - cmin);
+
+			SBuildRef* p = std::partition(refs + begin, refs + end, [bestAxis, bestBin, cmin, scale](const SBuildRef& ref)
+				{
+					const f32* c = &ref.Center.X;
+					return (int)((c[bestAxis] - cmin) * scale) <= bestBin;
+				});
+
+			mid = (u32)(p - refs);
+		}
+		else if (count > m_maxLeafSize)
+		{
+			// the SAH does not find the split (the same centers), but the leaf is too big
+			mid = begin + count / 2;
+		}
+		else
+		{
+			// leaf
+			return nodeId;
+		}
+
+		if (mid == begin || mid == end)
+			mid = begin + count / 2;
+
+		buildNode(begin, mid, depth + 1);
+		u32 right = buildNode(mid, end, depth + 1);
+
+		// the reference node is invalid after the push_back
+		m_nodes[nodeId].Offset = right;
+		m_nodes[nodeId].Count = 0;
+
+		return nodeId;
+	}
+
+	void CBVHTree::initRefit()
+	{
+		u32 numNode = m_nodes.size();
+
+		m_parents.set_used(numNode);
+		m_primitiveLeaf.set_used(m_primitives.size());
+
+		if (numNode == 0)
+			return;
+
+		m_parents[0] = 0;
+
+		for (u32 i = 0; i < numNode; i++)
+		{
+			const SNode& node = m_nodes[i];
+
+			if (node.Count > 0)
+			{
+				for (u32 j = node.Offset, end = node.Offset + node.Count; j < end; j++)
+					m_primitiveLeaf[m_primitives[j]] = i;
+			}
+			else
+			{
+				m_parents[i + 1] = i;
+				m_parents[node.Offset] = i;
+			}
+		}
+	}
+
+	void CBVHTree::updateLeafBox(u32 nodeId, const core::aabbox3df* boxes)
+	{
+		SNode& node = m_nodes[nodeId];
+
+		core::aabbox3df box = boxes[m_primitives[node.Offset]];
+		for (u32 i = node.Offset + 1, end = node.Offset + node.Count; i < end; i++)
+			box.addInternalBox(boxes[m_primitives[i]]);
+
+		setNodeBox(node, box);
+	}
+
+	void CBVHTree::updateInnerBox(u32 nodeId)
+	{
+		SNode& node = m_nodes[nodeId];
+		const SNode& left = m_nodes[nodeId + 1];
+		const SNode& right = m_nodes[node.Offset];
+
+		for (int i = 0; i < 3; i++)
+		{
+			node.Min[i] = core::min_(left.Min[i], right.Min[i]);
+			node.Max[i] = core::max_(left.Max[i], right.Max[i]);
+		}
+	}
+
+	void CBVHTree::refit(u32 primitive, const core::aabbox3df* boxes)
+	{
+		if (m_nodes.size() == 0)
+			return;
+
+		if (m_parents.size() != m_nodes.size())
+			initRefit();
+
+		u32 nodeId = m_primitiveLeaf[primitive];
+		updateLeafBox(nodeId, boxes);
+
+		// walk up to the root, the box can grow or shrink
+		while (nodeId != 0)
+		{
+			nodeId = m_parents[nodeId];
+
+			SNode old = m_nodes[nodeId];
+			updateInnerBox(nodeId);
+
+			// the parents are not changed if this box is not changed
+			if (memcmp(&old, &m_nodes[nodeId], sizeof(SNode)) == 0)
+				break;
+		}
+	}
+
+	void CBVHTree::refitAll(const core::aabbox3df* boxes)
+	{
+		// the children are after the parent, so the reverse order updates the children first
+		for (int i = (int)m_nodes.size() - 1; i >= 0; i--)
+		{
+			if (m_nodes[i].Count > 0)
+				updateLeafBox((u32)i, boxes);
+			else
+				updateInnerBox((u32)i);
+		}
+	}
+}
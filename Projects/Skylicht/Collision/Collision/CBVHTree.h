@@ -0,0 +1,322 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#define BVH_STACK_SIZE 64
+
+namespace Skylicht
+{
+	/// @brief The triangle that precomputed for the ray test
+	struct SBVHTriangle
+	{
+		core::vector3df A;
+		core::vector3df Edge1;
+		core::vector3df Edge2;
+
+		inline void set(const core::triangle3df& tri)
+		{
+			A = tri.pointA;
+			Edge1 = tri.pointB - tri.pointA;
+			Edge2 = tri.pointC - tri.pointA;
+		}
+	};
+
+	/// @brief The bounding volume hierarchy over the boxes of the primitives, built with the surface area heuristic.
+	///
+	/// The nodes are flattened in depth-first order: the left child is the next node, and a node is 32 bytes.
+	/// The primitives are sorted in leaf order, getPrimitives() maps them to the source index.
+	class CBVHTree
+	{
+	public:
+		struct SNode
+		{
+			f32 Min[3];
+			// leaf: the first primitive, inner node: the right child
+			u32 Offset;
+			f32 Max[3];
+			// the number of primitives, 0 is the inner node
+			u32 Count;
+		};
+
+	protected:
+		struct SBuildRef
+		{
+			core::aabbox3df Box;
+			core::vector3df Center;
+			u32 Id;
+		};
+
+		core::array<SNode> m_nodes;
+		core::array<u32> m_primitives;
+
+		// for refit, they are created on the first refit
+		core::array<u32> m_parents;
+		core::array<u32> m_primitiveLeaf;
+
+		core::array<SBuildRef> m_refs;
+
+		u32 m_maxLeafSize;
+
+	public:
+		CBVHTree();
+
+		virtual ~CBVHTree();
+
+		void build(const core::aabbox3df* boxes, u32 count);
+
+		void clear();
+
+		/// @brief Update the boxes of the nodes from a primitive to the root, when the primitive box is changed.
+		void refit(u32 primitive, const core::aabbox3df* boxes);
+
+		/// @brief Update the boxes of all nodes.
+		void refitAll(const core::aabbox3df* boxes);
+
+		inline const SNode* getNodes()
+		{
+			return m_nodes.const_pointer();
+		}
+
+		inline u32 getNodeCount()
+		{
+			return m_nodes.size();
+		}
+
+		inline const u32* getPrimitives()
+		{
+			return m_primitives.const_pointer();
+		}
+
+		/// @brief The max number of primitives in a leaf, the SAH can stop the split before this size.
+		inline void setMaxLeafSize(u32 size)
+		{
+			m_maxLeafSize = size;
+		}
+
+		static inline void getInvDir(const core::vector3df& dir, f32* invDir)
+		{
+			// a big number instead of infinity, that avoids the NaN (0 * inf) in the slab test
+			const f32 big = 1e30f;
+
+			invDir[0] = fabsf(dir.X) > 1e-20f ? 1.0f / dir.X : (dir.X >= 0.0f ? big : -big);
+			invDir[1] = fabsf(dir.Y) > 1e-20f ? 1.0f / dir.Y : (dir.Y >= 0.0f ? big : -big);
+			invDir[2] = fabsf(dir.Z) > 1e-20f ? 1.0f / dir.Z : (dir.Z >= 0.0f ? big : -big);
+		}
+
+		static inline bool intersectBox(const SNode& node, const f32* origin, const f32* invDir, f32 tMax, f32& tNear)
+		{
+			f32 t1 = (node.Min[0] - origin[0]) * invDir[0];
+			f32 t2 = (node.Max[0] - origin[0]) * invDir[0];
+			f32 tmin = core::min_(t1, t2);
+			f32 tmax = core::max_(t1, t2);
+
+			t1 = (node.Min[1] - origin[1]) * invDir[1];
+			t2 = (node.Max[1] - origin[1]) * invDir[1];
+			tmin = core::max_(tmin, core::min_(t1, t2));
+			tmax = core::min_(tmax, core::max_(t1, t2));
+
+			t1 = (node.Min[2] - origin[2]) * invDir[2];
+			t2 = (node.Max[2] - origin[2]) * invDir[2];
+			tmin = core::max_(tmin, core::min_(t1, t2));
+			tmax = core::min_(tmax, core::max_(t1, t2));
+
+			tmin = core::max_(tmin, 0.0f);
+			tmax = core::min_(tmax, tMax);
+
+			tNear = tmin;
+			return tmin <= tmax;
+		}
+
+		static inline bool intersectTriangle(const SBVHTriangle& tri, const core::vector3df& origin, const core::vector3df& dir, f32& t)
+		{
+			// Moller-Trumbore, both faces
+			core::vector3df p = dir.crossProduct(tri.Edge2);
+			f32 det = tri.Edge1.dotProduct(p);
+			if (fabsf(det) < 1e-12f)
+				return false;
+
+			f32 invDet = 1.0f / det;
+			core::vector3df s = origin - tri.A;
+
+			f32 u = s.dotProduct(p) * invDet;
+			if (u < 0.0f || u > 1.0f)
+				return false;
+
+			core::vector3df q = s.crossProduct(tri.Edge1);
+
+			f32 v = dir.dotProduct(q) * invDet;
+			if (v < 0.0f || u + v > 1.0f)
+				return false;
+
+			t = tri.Edge2.dotProduct(q) * invDet;
+			return true;
+		}
+
+		static inline bool overlapBox(const SNode& node, const core::aabbox3df& box)
+		{
+			return !(node.Min[0] > box.MaxEdge.X || node.Max[0] < box.MinEdge.X ||
+				node.Min[1] > box.MaxEdge.Y || node.Max[1] < box.MinEdge.Y ||
+				node.Min[2] > box.MaxEdge.Z || node.Max[2] < box.MinEdge.Z);
+		}
+
+		/// @brief Visit the leaves that the ray (origin + dir * t, 0 <= t <= tBest) hits, the near leaf first.
+		/// leafFunc(first, count, tBest) tests the primitives [first, first + count) in leaf order and can reduce tBest.
+		template<class LeafFunc>
+		void traverseRay(const core::vector3df& origin, const core::vector3df& dir, f32& tBest, LeafFunc leafFunc)
+		{
+			if (m_nodes.size() == 0)
+				return;
+
+			const SNode* nodes = m_nodes.const_pointer();
+
+			f32 invDir[3];
+			getInvDir(dir, invDir);
+
+			const f32* o = &origin.X;
+
+			struct SStackItem
+			{
+				u32 Node;
+				f32 TNear;
+			};
+
+			SStackItem stack[BVH_STACK_SIZE];
+			int sp = 0;
+
+			f32 tNear = 0.0f;
+			if (!intersectBox(nodes[0], o, invDir, tBest, tNear))
+				return;
+
+			u32 nodeId = 0;
+
+			while (true)
+			{
+				const SNode& node = nodes[nodeId];
+
+				if (node.Count > 0)
+				{
+					leafFunc(node.Offset, node.Count, tBest);
+				}
+				else
+				{
+					u32 left = nodeId + 1;
+					u32 right = node.Offset;
+
+					f32 tLeft, tRight;
+					bool hitLeft = intersectBox(nodes[left], o, invDir, tBest, tLeft);
+					bool hitRight = intersectBox(nodes[right], o, invDir, tBest, tRight);
+
+					if (hitLeft && hitRight && sp < BVH_STACK_SIZE)
+					{
+						// visit the near child first
+						if (tRight < tLeft)
+						{
+							core::swap(left, right);
+							core::swap(tLeft, tRight);
+						}
+
+						stack[sp].Node = right;
+						stack[sp].TNear = tRight;
+						sp++;
+
+						nodeId = left;
+						continue;
+					}
+					else if (hitLeft)
+					{
+						nodeId = left;
+						continue;
+					}
+					else if (hitRight)
+					{
+						nodeId = right;
+						continue;
+					}
+				}
+
+				// pop the node that is nearer than the current hit
+				bool found = false;
+				while (sp > 0)
+				{
+					sp--;
+					if (stack[sp].TNear <= tBest)
+					{
+						nodeId = stack[sp].Node;
+						found = true;
+						break;
+					}
+				}
+
+				if (!found)
+					break;
+			}
+		}
+
+		/// @brief Visit the leaves that overlap the box, leafFunc(first, count).
+		template<class LeafFunc>
+		void traverseBox(const core::aabbox3df& box, LeafFunc leafFunc)
+		{
+			if (m_nodes.size() == 0)
+				return;
+
+			const SNode* nodes = m_nodes.const_pointer();
+
+			u32 stack[BVH_STACK_SIZE];
+			int sp = 0;
+			stack[sp++] = 0;
+
+			while (sp > 0)
+			{
+				u32 nodeId = stack[--sp];
+				const SNode& node = nodes[nodeId];
+
+				if (!overlapBox(node, box))
+					continue;
+
+				if (node.Count > 0)
+				{
+					leafFunc(node.Offset, node.Count);
+				}
+				else if (sp + 2 <= BVH_STACK_SIZE)
+				{
+					stack[sp++] = nodeId + 1;
+					stack[sp++] = node.Offset;
+				}
+			}
+		}
+
+	protected:
+
+		u32 buildNode(u32 begin, u32 end, int depth);
+
+		void setNodeBox(SNode& node, const core::aabbox3df& box);
+
+		void updateLeafBox(u32 nodeId, const core::aabbox3df* boxes);
+
+		void updateInnerBox(u32 nodeId);
+
+		void initRefit();
+	};
+}
@@ -25,7 +25,12 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CCollisionBuilder.h"
 
+#include "CMeshTriangleSelector.h"
+#include "CBBTriangleSelector.h"
+
 #include "GameObject/CGameObject.h"
+#include "RenderMesh/CRenderMesh.h"
+#include "Entity/CEntityManager.h"
 
 namespace Skylicht
 {
@@ -39,6 +44,47 @@ namespace Skylicht
 
 	}
 
+	bool CCollisionBuilder::addMeshCollision(CGameObject* gameObject)
+	{
+		CRenderMesh* renderMesh = gameObject->getComponent<CRenderMesh>();
+		if (renderMesh == NULL)
+			return false;
+
+		std::vector<CRenderMeshData*>& renderers = renderMesh->getRenderers();
+		for (CRenderMeshData* renderMesh : renderers)
+		{
+			CEntity* entity = renderMesh->Entity;
+			m_nodes.push_back(
+				new CCollisionNode(gameObject, entity, new CMeshTriangleSelector(entity))
+			);
+		}
+
+		return renderers.size() > 0;
+	}
+
+	bool CCollisionBuilder::addBBoxCollision(CGameObject* gameObject)
+	{
+		CRenderMesh* renderMesh = gameObject->getComponent<CRenderMesh>();
+		if (renderMesh == NULL)
+			return false;
+
+		std::vector<CRenderMeshData*>& renderers = renderMesh->getRenderers();
+		for (CRenderMeshData* renderMesh : renderers)
+		{
+			CEntity* entity = renderMesh->Entity;
+			m_nodes.push_back(
+				new CCollisionNode(gameObject, entity, new CBBTriangleSelector(entity))
+			);
+		}
+
+		return renderers.size() > 0;
+	}
+
+	void CCollisionBuilder::addCollision(CCollisionNode* node)
+	{
+		m_nodes.push_back(node);
+	}
+
 	void CCollisionBuilder::removeCollision(CGameObject* object)
 	{
 		for (u32 i = 0, n = m_nodes.size(); i < n; i++)
@@ -142,4 +188,14 @@ namespace Skylicht
 		float outBestDistanceSquared = ray.getLengthSQ();
 		return getCollisionPoint(ray, outBestDistanceSquared, outIntersection, outTriangle, outNode);
 	}
-}
\ No newline at end of file
+
+	void CCollisionBuilder::getCollisionPoints(const core::line3df* rays, SCollisionResult* results, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			SCollisionResult& r = results[i];
+			r.DistanceSquared = rays[i].getLengthSQ();
+			r.Hit = getCollisionPoint(rays[i], r.DistanceSquared, r.Intersection, r.Triangle, r.Node);
+		}
+	}
+}
@@ -28,6 +28,23 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	/// @brief The result of a ray in CCollisionBuilder::getCollisionPoints
+	struct SCollisionResult
+	{
+		bool Hit;
+		f32 DistanceSquared;
+		core::vector3df Intersection;
+		core::triangle3df Triangle;
+		CCollisionNode* Node;
+
+		SCollisionResult() :
+			Hit(false),
+			DistanceSquared(0.0f),
+			Node(NULL)
+		{
+		}
+	};
+
 	class CCollisionBuilder
 	{
 	protected:
@@ -38,6 +55,15 @@ namespace Skylicht
 
 		virtual ~CCollisionBuilder();
 
+		// add the mesh collision of the render mesh, remember build() after the add
+		bool addMeshCollision(CGameObject* gameObject);
+
+		// add the bbox collision of the render mesh, remember build() after the add
+		bool addBBoxCollision(CGameObject* gameObject);
+
+		// add the node with the custom triangles, remember build() after the add
+		void addCollision(CCollisionNode* node);
+
 		// remember build() after the remove
 		void removeCollision(CGameObject* object);
 
@@ -73,6 +99,10 @@ namespace Skylicht
 			core::triangle3df& outTriangle,
 			CCollisionNode*& outNode) = 0;
 
+		/// @brief Find the nearest collision of many rays (the segment start - end).
+		/// The default implementation calls getCollisionPoint on each ray.
+		virtual void getCollisionPoints(const core::line3df* rays, SCollisionResult* results, int count);
+
 		virtual void getTriangles(const core::aabbox3df& box,
 			core::array<core::triangle3df*>& result,
 			core::array<CCollisionNode*>& nodes) = 0;
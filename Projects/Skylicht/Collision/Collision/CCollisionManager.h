@@ -27,18 +27,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CCollisionNode.h"
 #include "COctreeNode.h"
 #include "COctreeBuilder.h"
+#include "CBVHBuilder.h"
 
 namespace Skylicht
 {
-	class CCollisionManager : public COctreeBuilder
+	class CCollisionManager : public CBVHBuilder
 	{
 	public:
 		CCollisionManager();
 
 		virtual ~CCollisionManager();
-
-		bool addMeshCollision(CGameObject* gameObject);
-
-		bool addBBoxCollision(CGameObject* gameObject);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,372 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CDynamicBVHBuilder.h"
+
+#include "Debug/CSceneDebug.h"
+#include "Thread/CJobSystem.h"
+#include "Transform/CWorldTransformData.h"
+
+namespace Skylicht
+{
+	static inline void getNodeWorld(CCollisionNode* node, core::matrix4& world)
+	{
+		if (node->Selector != NULL && node->Entity != NULL)
+		{
+			CWorldTransformData* transform = GET_ENTITY_DATA(node->Entity, CWorldTransformData);
+			world = transform->World;
+		}
+		else
+		{
+			// the custom triangles are in world space
+			world.makeIdentity();
+		}
+	}
+
+	CDynamicBVHBuilder::CDynamicBVHBuilder() :
+		m_refitCount(0)
+	{
+		m_topLevel.setMaxLeafSize(1);
+	}
+
+	CDynamicBVHBuilder::~CDynamicBVHBuilder()
+	{
+		clear();
+	}
+
+	void CDynamicBVHBuilder::clear()
+	{
+		for (u32 i = 0, n = m_instances.size(); i < n; i++)
+			delete m_instances[i];
+
+		m_instances.clear();
+		m_worldBoxes.clear();
+		m_topLevel.clear();
+		m_nodeInstance.clear();
+		m_refitCount = 0;
+
+		CCollisionBuilder::clear();
+	}
+
+	void CDynamicBVHBuilder::build()
+	{
+		const u32 start = os::Timer::getRealTime();
+
+		for (u32 i = 0, n = m_instances.size(); i < n; i++)
+			delete m_instances[i];
+
+		m_instances.set_used(0);
+		m_nodeInstance.clear();
+
+		u32 numPoly = 0;
+		u32 numNode = m_nodes.size();
+
+		// build the local tree of each node
+		for (u32 i = 0; i < numNode; i++)
+		{
+			SInstance* instance = new SInstance();
+			instance->Node = m_nodes[i];
+
+			initInstance(instance);
+
+			m_instances.push_back(instance);
+			m_nodeInstance[instance->Node] = i;
+
+			numPoly += instance->Triangles.size();
+		}
+
+		// the world bbox of the nodes
+		m_worldBoxes.set_used(numNode);
+		for (u32 i = 0; i < numNode; i++)
+			updateInstance(i);
+
+		rebuildTopLevel();
+
+		c8 tmp[256];
+		sprintf(tmp, "Needed %ums to CDynamicBVHBuilder::build (%u nodes, %u polys)", os::Timer::getRealTime() - start, numNode, numPoly);
+		os::Printer::log(tmp, ELL_INFORMATION);
+	}
+
+	void CDynamicBVHBuilder::initInstance(SInstance* instance)
+	{
+		CCollisionNode* node = instance->Node;
+		node->updateTransform();
+
+		const core::triangle3df* triangles = NULL;
+		u32 numTris = 0;
+
+		if (node->Selector != NULL && node->Entity != NULL)
+		{
+			triangles = node->Selector->getLocalTriangles();
+			numTris = node->Selector->getTriangleCount();
+		}
+		else
+		{
+			triangles = node->Triangles.const_pointer();
+			numTris = node->Triangles.size();
+		}
+
+		core::array<core::aabbox3df> boxes;
+		boxes.set_used(numTris);
+
+		instance->LocalBox.reset(0.0f, 0.0f, 0.0f);
+
+		for (u32 i = 0; i < numTris; i++)
+		{
+			core::aabbox3df& box = boxes[i];
+			box.reset(triangles[i].pointA);
+			box.addInternalPoint(triangles[i].pointB);
+			box.addInternalPoint(triangles[i].pointC);
+
+			if (i == 0)
+				instance->LocalBox = box;
+			else
+				instance->LocalBox.addInternalBox(box);
+		}
+
+		instance->Tree.build(boxes.const_pointer(), numTris);
+
+		// pack the triangles in leaf order
+		const u32* primitives = instance->Tree.getPrimitives();
+
+		instance->Triangles.set_used(numTris);
+		instance->TriangleIds.set_used(numTris);
+
+		for (u32 i = 0; i < numTris; i++)
+		{
+			u32 id = primitives[i];
+			instance->Triangles[i].set(triangles[id]);
+			instance->TriangleIds[i] = id;
+		}
+	}
+
+	void CDynamicBVHBuilder::updateInstance(u32 id)
+	{
+		SInstance* instance = m_instances[id];
+
+		getNodeWorld(instance->Node, instance->World);
+		instance->Valid = instance->World.getInverse(instance->InvWorld);
+
+		core::aabbox3df& box = m_worldBoxes[id];
+		box = instance->LocalBox;
+		instance->World.transformBoxEx(box);
+	}
+
+	void CDynamicBVHBuilder::rebuildTopLevel()
+	{
+		m_topLevel.build(m_worldBoxes.const_pointer(), m_worldBoxes.size());
+		m_refitCount = 0;
+	}
+
+	bool CDynamicBVHBuilder::updateNode(CCollisionNode* node)
+	{
+		std::map<CCollisionNode*, u32>::iterator it = m_nodeInstance.find(node);
+		if (it == m_nodeInstance.end())
+			return false;
+
+		u32 id = it->second;
+
+		// the world triangles for the result & getTriangles
+		node->updateTransform();
+
+		updateInstance(id);
+
+		m_topLevel.refit(id, m_worldBoxes.const_pointer());
+		m_refitCount++;
+		return true;
+	}
+
+	u32 CDynamicBVHBuilder::updateTransforms()
+	{
+		u32 numMoved = 0;
+		core::matrix4 world;
+
+		for (u32 i = 0, n = m_instances.size(); i < n; i++)
+		{
+			SInstance* instance = m_instances[i];
+
+			getNodeWorld(instance->Node, world);
+			if (world != instance->World)
+			{
+				updateNode(instance->Node);
+				numMoved++;
+			}
+		}
+
+		return numMoved;
+	}
+
+	void CDynamicBVHBuilder::drawDebug()
+	{
+		CSceneDebug* debug = CSceneDebug::getInstance();
+
+		const CBVHTree::SNode* nodes = m_topLevel.getNodes();
+
+		for (u32 i = 0, n = m_topLevel.getNodeCount(); i < n; i++)
+		{
+			const CBVHTree::SNode& node = nodes[i];
+
+			core::aabbox3df box(
+				node.Min[0], node.Min[1], node.Min[2],
+				node.Max[0], node.Max[1], node.Max[2]);
+
+			debug->addBoudingBox(box, node.Count > 0 ? SColor(255, 255, 0, 0) : SColor(255, 255, 255, 0));
+		}
+	}
+
+	int CDynamicBVHBuilder::intersectRay(const core::vector3df& origin, const core::vector3df& dir, f32& tBest, SInstance*& outInstance)
+	{
+		SInstance** instances = m_instances.pointer();
+		const u32* primitives = m_topLevel.getPrimitives();
+
+		int hit = -1;
+		outInstance = NULL;
+
+		m_topLevel.traverseRay(origin, dir, tBest, [instances, primitives, &origin, &dir, &hit, &outInstance](u32 first, u32 count, f32& tBest)
+			{
+				for (u32 i = first, end = first + count; i < end; i++)
+				{
+					SInstance* instance = instances[primitives[i]];
+					if (!instance->Valid)
+						continue;
+
+					// the ray in local space, the direction is not normalized so t is still the world distance
+					core::vector3df o;
+					core::vector3df d(dir);
+					instance->InvWorld.transformVect(o, origin);
+					instance->InvWorld.rotateVect(d);
+
+					const SBVHTriangle* triangles = instance->Triangles.const_pointer();
+
+					instance->Tree.traverseRay(o, d, tBest, [instance, triangles, &o, &d, &hit, &outInstance](u32 leafFirst, u32 leafCount, f32& tLeaf)
+						{
+							for (u32 j = leafFirst, leafEnd = leafFirst + leafCount; j < leafEnd; j++)
+							{
+								f32 t;
+								if (CBVHTree::intersectTriangle(triangles[j], o, d, t) && t >= 0.0f && t < tLeaf)
+								{
+									tLeaf = t;
+									hit = (int)j;
+									outInstance = instance;
+								}
+							}
+						});
+				}
+			});
+
+		return hit;
+	}
+
+	bool CDynamicBVHBuilder::getCollisionPoint(
+		const core::line3d<f32>& ray,
+		f32& outBestDistanceSquared,
+		core::vector3df& outIntersection,
+		core::triangle3df& outTriangle,
+		CCollisionNode*& outNode)
+	{
+		outNode = NULL;
+
+		core::vector3df dir = ray.getVector();
+		f32 length = dir.getLength();
+		if (length <= 0.0f)
+			return false;
+
+		dir /= length;
+
+		// the hit must be on the segment & nearer than the best distance
+		f32 tBest = core::min_(length, sqrtf(outBestDistanceSquared));
+
+		SInstance* instance = NULL;
+
+		int triangle = intersectRay(ray.start, dir, tBest, instance);
+		if (triangle < 0)
+			return false;
+
+		outBestDistanceSquared = tBest * tBest;
+		outIntersection = ray.start + dir * tBest;
+		outTriangle = instance->Node->Triangles[instance->TriangleIds[triangle]];
+		outNode = instance->Node;
+		return true;
+	}
+
+	void CDynamicBVHBuilder::getCollisionPoints(const core::line3df* rays, SCollisionResult* results, int count)
+	{
+		if (count <= 0)
+			return;
+
+		CDynamicBVHBuilder* builder = this;
+
+		System::CJobSystem::runParallelFor(count, 16, [builder, rays, results](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					SCollisionResult& result = results[i];
+					result.DistanceSquared = FLT_MAX;
+					result.Hit = builder->getCollisionPoint(rays[i], result.DistanceSquared, result.Intersection, result.Triangle, result.Node);
+				}
+			});
+	}
+
+	void CDynamicBVHBuilder::getTriangles(const core::aabbox3df& box,
+		core::array<core::triangle3df*>& result,
+		core::array<CCollisionNode*>& nodes)
+	{
+		SInstance** instances = m_instances.pointer();
+		const u32* primitives = m_topLevel.getPrimitives();
+
+		m_topLevel.traverseBox(box, [instances, primitives, &box, &result, &nodes](u32 first, u32 count)
+			{
+				for (u32 i = first, end = first + count; i < end; i++)
+				{
+					SInstance* instance = instances[primitives[i]];
+					if (!instance->Valid)
+						continue;
+
+					// the conservative box in local space
+					core::aabbox3df localBox(box);
+					instance->InvWorld.transformBoxEx(localBox);
+
+					CCollisionNode* node = instance->Node;
+					core::triangle3df* triangles = node->Triangles.pointer();
+					const u32* ids = instance->TriangleIds.const_pointer();
+
+					instance->Tree.traverseBox(localBox, [node, triangles, ids, &box, &result, &nodes](u32 leafFirst, u32 leafCount)
+						{
+							for (u32 j = leafFirst, leafEnd = leafFirst + leafCount; j < leafEnd; j++)
+							{
+								core::triangle3df* triangle = &triangles[ids[j]];
+
+								// if triangle collide the bbox
+								if (!triangle->isTotalOutsideBox(box))
+								{
+									result.push_back(triangle);
+									nodes.push_back(node);
+								}
+							}
+						});
+				}
+			});
+	}
+}
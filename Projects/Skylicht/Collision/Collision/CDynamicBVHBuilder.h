@@ -0,0 +1,131 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CCollisionBuilder.h"
+#include "CBVHTree.h"
+
+namespace Skylicht
+{
+	/// @brief The two-level collision builder for the moving collision nodes.
+	///
+	/// Each node has a static tree of its triangles in local space, and the top level tree is built over the world bbox of the nodes.
+	/// When a node moves, updateNode() refits the top level from the node to the root, the triangle trees are not rebuilt,
+	/// so the cost is proportional to the number of moving nodes.
+	class CDynamicBVHBuilder : public CCollisionBuilder
+	{
+	protected:
+		struct SInstance
+		{
+			CCollisionNode* Node;
+
+			// the tree & the triangles in local space
+			CBVHTree Tree;
+			core::array<SBVHTriangle> Triangles;
+
+			// the index of Node->Triangles in leaf order
+			core::array<u32> TriangleIds;
+
+			core::aabbox3df LocalBox;
+			core::matrix4 World;
+			core::matrix4 InvWorld;
+
+			// false if the world matrix is not invertible (zero scale)
+			bool Valid;
+		};
+
+		core::array<SInstance*> m_instances;
+		core::array<core::aabbox3df> m_worldBoxes;
+
+		CBVHTree m_topLevel;
+
+		std::map<CCollisionNode*, u32> m_nodeInstance;
+
+		u32 m_refitCount;
+
+	public:
+		CDynamicBVHBuilder();
+
+		virtual ~CDynamicBVHBuilder();
+
+		virtual void build();
+
+		virtual void clear();
+
+		virtual void drawDebug();
+
+		/// @brief Call when the transform of the node changed, it updates the world triangles & refits the top level.
+		/// @return false if the node is not in the builder (remember build() after the add)
+		bool updateNode(CCollisionNode* node);
+
+		/// @brief Check the transform of all nodes and update the moved nodes.
+		/// The check is cheap, but updateNode() is better when the moving nodes are known.
+		/// @return the number of moved nodes
+		u32 updateTransforms();
+
+		/// @brief Rebuild the top level, when the nodes moved far from the build position, the refit tree is not optimal.
+		void rebuildTopLevel();
+
+		inline u32 getInstanceCount()
+		{
+			return m_instances.size();
+		}
+
+		inline u32 getTopLevelNodeCount()
+		{
+			return m_topLevel.getNodeCount();
+		}
+
+		/// @brief The number of refits since the last build of the top level
+		inline u32 getRefitCount()
+		{
+			return m_refitCount;
+		}
+
+	public:
+
+		virtual bool getCollisionPoint(
+			const core::line3d<f32>& ray,
+			f32& outBestDistanceSquared,
+			core::vector3df& outIntersection,
+			core::triangle3df& outTriangle,
+			CCollisionNode*& outNode);
+
+		/// @brief The rays run on the job system.
+		virtual void getCollisionPoints(const core::line3df* rays, SCollisionResult* results, int count);
+
+		virtual void getTriangles(const core::aabbox3df& box,
+			core::array<core::triangle3df*>& result,
+			core::array<CCollisionNode*>& nodes);
+
+	protected:
+
+		void initInstance(SInstance* instance);
+
+		void updateInstance(u32 id);
+
+		int intersectRay(const core::vector3df& origin, const core::vector3df& dir, f32& tBest, SInstance*& outInstance);
+	};
+}
@@ -53,6 +53,12 @@ namespace Skylicht
 			return m_triangles.size();
 		}
 
+		/// @brief The triangles in the local space of the entity
+		inline const core::triangle3df* getLocalTriangles()
+		{
+			return m_triangles.const_pointer();
+		}
+
 		inline CEntity* getEntity()
 		{
 			return m_entity;
@@ -30,7 +30,7 @@ namespace Skylicht
 {
 	CDecalsRenderer::CDecalsRenderer()
 	{
-
+		m_cullingDependent = true;
 	}
 
 	CDecalsRenderer::~CDecalsRenderer()
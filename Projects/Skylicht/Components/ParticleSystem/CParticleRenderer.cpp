@@ -39,6 +39,7 @@ namespace Skylicht
 			m_group(NULL)
 		{
 			m_renderPass = Transparent;
+			m_cullingDependent = true;
 		}
 
 		CParticleRenderer::~CParticleRenderer()
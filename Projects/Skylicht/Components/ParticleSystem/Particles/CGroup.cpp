@@ -171,7 +171,7 @@ namespace Skylicht
 
 			updateLaunchEmitter();
 
-			CParticle* particles = m_particles.pointer();
+			CParticleData* particles = &m_particles;
 			u32 numParticles = m_particles.size();
 
 			if (visible == true)
@@ -194,29 +194,29 @@ namespace Skylicht
 			for (IParticleCallback* cb : m_callback)
 				cb->OnParticleUpdate(particles, numParticles, this, dt);
 
-			if (numParticles > 0)
-				m_bbox.reset(particles[0].Position);
-
-			// remove die particle & update box
-			for (u32 i = 0; i < numParticles; i++)
+			if (m_callback.size() == 0)
 			{
-				CParticle& p = particles[i];
-
-				if (p.Life < 0)
-				{
-					// remove dead particle
-					remove(i);
-					--i;
-					--numParticles;
-				}
-				else
+				// no one track the particle index, just move the alive particles to the front (stream compaction)
+				m_particles.removeDeadParticles();
+			}
+			else
+			{
+				// remove die particle, the callbacks follow the swap
+				for (u32 i = 0; i < numParticles; i++)
 				{
-					// add bbox
-					m_bbox.addInternalPoint(p.Position);
+					if (particles->Life[i] < 0)
+					{
+						// remove dead particle
+						remove(i);
+						--i;
+						--numParticles;
+					}
 				}
 			}
 
-			particles = m_particles.pointer();
+			// update bbox
+			m_particles.getBBox(m_bbox);
+
 			numParticles = m_particles.size();
 
 			// update instancing buffer
@@ -269,10 +269,10 @@ namespace Skylicht
 				SLaunchParticle& launch = m_launch[i];
 				if (launch.Number > 0)
 				{
-					CParticle* newParticles = create(launch.Number);
+					u32 first = create(launch.Number);
 					for (u32 j = 0, n = launch.Number; j < n; j++)
 					{
-						CParticle& p = newParticles[j];
+						CParticle p(&m_particles, first + j);
 						launchParticle(p, launch);
 					}
 				}
@@ -283,7 +283,7 @@ namespace Skylicht
 		{
 			initParticleLifeTime(p);
 
-			if (p.LifeTime > 0)
+			if (p.getLifeTime() > 0)
 			{
 				launch.Emitter->emitParticle(p, launch.Emitter->getZone(), this);
 				launch.Number--;
@@ -296,48 +296,54 @@ namespace Skylicht
 
 		void CGroup::initParticleModel(CParticle& p)
 		{
+			CParticleData* data = p.Data;
+			u32 i = p.Index;
+
 			for (CModel* m : m_models)
 			{
 				EParticleParams t = m->getType();
 
+				float* startValue = data->StartValue[t];
+				float* endValue = data->EndValue[t];
+
 				if (m->isRandomStart() == true)
-					p.StartValue[t] = m->getRandomStart();
+					startValue[i] = m->getRandomStart();
 				else
-					p.StartValue[t] = m->getStartValue1();
+					startValue[i] = m->getStartValue1();
 
 				if (m->isEnableEndValue())
 				{
 					if (m->isRandomEnd() == true)
-						p.EndValue[t] = m->getRandomEnd();
+						endValue[i] = m->getRandomEnd();
 					else
-						p.EndValue[t] = m->getEndValue1();
+						endValue[i] = m->getEndValue1();
 				}
 				else
 				{
-					p.EndValue[t] = p.StartValue[t];
+					endValue[i] = startValue[i];
 				}
 
 				if (t == Particle::RotateSpeedX ||
 					t == Particle::RotateSpeedY ||
 					t == Particle::RotateSpeedZ)
 				{
-					p.HaveRotate = true;
+					data->HaveRotate[i] = 1;
 				}
 				else if (t == Particle::RotateX)
-					p.Rotation.X = p.StartValue[t];
+					data->Rotation[0][i] = startValue[i];
 				else if (t == Particle::RotateY)
-					p.Rotation.Y = p.StartValue[t];
+					data->Rotation[1][i] = startValue[i];
 				else if (t == Particle::RotateZ)
-					p.Rotation.Z = p.StartValue[t];
+					data->Rotation[2][i] = startValue[i];
 				else if (t == Particle::FrameIndex)
 				{
 					if (!m->isRandomEnd())
 					{
-						p.EndValue[t] = p.StartValue[t];
+						endValue[i] = startValue[i];
 					}
 				}
 
-				p.Params[t] = p.StartValue[t];
+				data->Params[t][i] = startValue[i];
 			}
 
 			for (IParticleCallback* cb : m_callback)
@@ -346,52 +352,47 @@ namespace Skylicht
 
 		int CGroup::addParticleByEmitter(CEmitter* emitter, const core::vector3df& position, const core::vector3df& subEmitterDirection)
 		{
-			CParticle* p = create(1);
+			CParticle p(&m_particles, create(1));
 
-			initParticleLifeTime(*p);
+			initParticleLifeTime(p);
 
-			if (p->LifeTime > 0)
+			if (p.getLifeTime() > 0)
 			{
-				emitter->generateVelocity(*p, emitter->getZone(), this);
+				emitter->generateVelocity(p, emitter->getZone(), this);
 
-				initParticleModel(*p);
+				initParticleModel(p);
 
-				p->LastPosition = position;
-				p->Position = position;
-				p->SubEmitterDirection = subEmitterDirection;
+				p.setLastPosition(position);
+				p.setPosition(position);
+				p.setSubEmitterDirection(subEmitterDirection);
 			}
 
-			return (int)p->Index;
+			return (int)p.Index;
 		}
 
 		int CGroup::addParticleVelocityByEmitter(CEmitter* emitter, const core::vector3df& position, const core::vector3df& velocity)
 		{
-			CParticle* p = create(1);
+			CParticle p(&m_particles, create(1));
 
-			initParticleLifeTime(*p);
+			initParticleLifeTime(p);
 
-			if (p->LifeTime > 0)
+			if (p.getLifeTime() > 0)
 			{
-				emitter->generateVelocity(*p, emitter->getZone(), this);
+				emitter->generateVelocity(p, emitter->getZone(), this);
 
-				initParticleModel(*p);
+				initParticleModel(p);
 
-				p->LastPosition = position;
-				p->Position = position;
-				p->Velocity = velocity;
+				p.setLastPosition(position);
+				p.setPosition(position);
+				p.setVelocity(velocity);
 			}
 
-			return (int)p->Index;
+			return (int)p.Index;
 		}
 
-		CParticle* CGroup::create(u32 num)
+		u32 CGroup::create(u32 num)
 		{
-			u32 total = m_particles.size();
-			for (u32 i = 0; i < num; i++)
-			{
-				m_particles.push_back(CParticle(total + i));
-			}
-			return m_particles.pointer() + total;
+			return m_particles.create(num);
 		}
 
 		void CGroup::remove(u32 index)
@@ -400,18 +401,25 @@ namespace Skylicht
 			if (index >= total)
 				return;
 
-			if (total >= 2 && index != total - 1)
+			u32 last = total - 1;
+
+			if (total >= 2 && index != last)
 			{
+				CParticle p1(&m_particles, index);
+				CParticle p2(&m_particles, last);
+
 				for (IParticleCallback* cb : m_callback)
-					cb->OnSwapParticleData(m_particles[index], m_particles.getLast());
+					cb->OnSwapParticleData(p1, p2);
 
-				m_particles[index].swap(m_particles.getLast());
+				m_particles.swap(index, last);
 			}
 
+			CParticle p(&m_particles, last);
+
 			for (IParticleCallback* cb : m_callback)
-				cb->OnParticleDead(m_particles.getLast());
+				cb->OnParticleDead(p);
 
-			m_particles.set_used(total - 1);
+			m_particles.setSize(last);
 		}
 
 		CModel* CGroup::createModel(const std::wstring& attributeName)
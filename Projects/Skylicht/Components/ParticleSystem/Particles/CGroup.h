@@ -74,7 +74,7 @@ namespace Skylicht
 
 			}
 
-			virtual void OnParticleUpdate(CParticle* particles, int num, CGroup* group, float dt)
+			virtual void OnParticleUpdate(CParticleData* particles, int num, CGroup* group, float dt)
 			{
 
 			}
@@ -103,7 +103,7 @@ namespace Skylicht
 		class COMPONENT_API CGroup : public CParticleSerializable
 		{
 		protected:
-			core::array<CParticle> m_particles;
+			CParticleData m_particles;
 			core::array<SLaunchParticle> m_launch;
 
 			std::vector<CEmitter*> m_emitters;
@@ -184,9 +184,14 @@ namespace Skylicht
 				return m_particles.size();
 			}
 
-			inline CParticle* getParticlePointer()
+			inline CParticleData* getParticleData()
 			{
-				return m_particles.pointer();
+				return &m_particles;
+			}
+
+			inline CParticle getParticle(u32 i)
+			{
+				return CParticle(&m_particles, i);
 			}
 
 			inline CEmitter* addEmitter(CEmitter* e)
@@ -311,11 +316,6 @@ namespace Skylicht
 				return m_interpolators;
 			}
 
-			core::array<CParticle>& getParticles()
-			{
-				return m_particles;
-			}
-
 			DECLARE_GETTYPENAME(CGroup)
 
 			virtual CObjectSerializable* createSerializable();
@@ -334,13 +334,14 @@ namespace Skylicht
 
 			inline void initParticleLifeTime(CParticle& p)
 			{
-				p.Age = 0.0f;
-				p.Life = random(LifeMin, LifeMax);
-				p.LifeTime = p.Life;
-				p.HaveRotate = false;
+				float life = random(LifeMin, LifeMax);
+				p.setAge(0.0f);
+				p.setLife(life);
+				p.setLifeTime(life);
+				p.setHaveRotate(false);
 			}
 
-			CParticle* create(u32 num);
+			u32 create(u32 num);
 
 			void remove(u32 i);
 		};
@@ -24,66 +24,178 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #pragma once
 
-#include "Entity/IEntityData.h"
+#include "CParticleData.h"
 
 namespace Skylicht
 {
 	namespace Particle
 	{
-		enum EParticleParams
-		{
-			Scale = 0,
-			ScaleX,
-			ScaleY,
-			ScaleZ,
-			RotateX,
-			RotateY,
-			RotateZ,
-			ColorR,
-			ColorG,
-			ColorB,
-			ColorA,
-			Mass,
-			FrameIndex,
-			RotateSpeedX,
-			RotateSpeedY,
-			RotateSpeedZ,
-			NumParams
-		};
-
+		/// @brief The handle of a particle on the streams of CParticleData.
+		///
+		/// It is used by the emitters, zones and callbacks, the systems read and write the streams directly.
 		class COMPONENT_API CParticle
 		{
 		public:
+			CParticleData* Data;
 			u32 Index;
-			s32 ParentIndex;
-
-			bool Immortal;
-
-			float Params[NumParams];
-			float StartValue[NumParams];
-			float EndValue[NumParams];
-
-			float Age;
-			float Life;
-			float LifeTime;
-
-			bool HaveRotate;
-
-			core::vector3df Position;
-			core::vector3df Rotation;
-			core::vector3df Velocity;
-
-			core::vector3df LastPosition;
-
-			core::vector3df SubEmitterDirection;
-			void* UserData;
 
 		public:
-			CParticle(u32 index);
-
-			virtual ~CParticle();
-
-			void swap(CParticle& p);
+			CParticle(CParticleData* data, u32 index) :
+				Data(data),
+				Index(index)
+			{
+
+			}
+
+			inline core::vector3df getPosition()
+			{
+				return Data->getVector(Data->Position, Index);
+			}
+
+			inline void setPosition(const core::vector3df& v)
+			{
+				Data->setVector(Data->Position, Index, v);
+			}
+
+			inline core::vector3df getLastPosition()
+			{
+				return Data->getVector(Data->LastPosition, Index);
+			}
+
+			inline void setLastPosition(const core::vector3df& v)
+			{
+				Data->setVector(Data->LastPosition, Index, v);
+			}
+
+			inline core::vector3df getVelocity()
+			{
+				return Data->getVector(Data->Velocity, Index);
+			}
+
+			inline void setVelocity(const core::vector3df& v)
+			{
+				Data->setVector(Data->Velocity, Index, v);
+			}
+
+			inline core::vector3df getRotation()
+			{
+				return Data->getVector(Data->Rotation, Index);
+			}
+
+			inline void setRotation(const core::vector3df& v)
+			{
+				Data->setVector(Data->Rotation, Index, v);
+			}
+
+			inline core::vector3df getSubEmitterDirection()
+			{
+				return Data->getVector(Data->SubEmitterDirection, Index);
+			}
+
+			inline void setSubEmitterDirection(const core::vector3df& v)
+			{
+				Data->setVector(Data->SubEmitterDirection, Index, v);
+			}
+
+			inline float getParam(EParticleParams p)
+			{
+				return Data->Params[p][Index];
+			}
+
+			inline void setParam(EParticleParams p, float value)
+			{
+				Data->Params[p][Index] = value;
+			}
+
+			inline float getStartValue(EParticleParams p)
+			{
+				return Data->StartValue[p][Index];
+			}
+
+			inline void setStartValue(EParticleParams p, float value)
+			{
+				Data->StartValue[p][Index] = value;
+			}
+
+			inline float getEndValue(EParticleParams p)
+			{
+				return Data->EndValue[p][Index];
+			}
+
+			inline void setEndValue(EParticleParams p, float value)
+			{
+				Data->EndValue[p][Index] = value;
+			}
+
+			inline float getAge()
+			{
+				return Data->Age[Index];
+			}
+
+			inline void setAge(float f)
+			{
+				Data->Age[Index] = f;
+			}
+
+			inline float getLife()
+			{
+				return Data->Life[Index];
+			}
+
+			inline void setLife(float f)
+			{
+				Data->Life[Index] = f;
+			}
+
+			inline float getLifeTime()
+			{
+				return Data->LifeTime[Index];
+			}
+
+			inline void setLifeTime(float f)
+			{
+				Data->LifeTime[Index] = f;
+			}
+
+			inline bool isImmortal()
+			{
+				return Data->Immortal[Index] != 0;
+			}
+
+			inline void setImmortal(bool b)
+			{
+				Data->Immortal[Index] = b ? 1 : 0;
+			}
+
+			inline bool haveRotate()
+			{
+				return Data->HaveRotate[Index] != 0;
+			}
+
+			inline void setHaveRotate(bool b)
+			{
+				Data->HaveRotate[Index] = b ? 1 : 0;
+			}
+
+			inline s32 getParentIndex()
+			{
+				return Data->ParentIndex[Index];
+			}
+
+			inline void setParentIndex(s32 i)
+			{
+				Data->ParentIndex[Index] = i;
+			}
+
+			inline void* getUserData()
+			{
+				return Data->UserData[Index];
+			}
+
+			inline void setUserData(void* data)
+			{
+				Data->UserData[Index] = data;
+			}
 		};
 	}
-}
\ No newline at end of file
+}
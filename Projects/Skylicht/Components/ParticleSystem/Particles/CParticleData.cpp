@@ -0,0 +1,267 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CParticleData.h"
+#include "ParticleSIMD.h"
+
+#include "Thread/CJobSystem.h"
+
+namespace Skylicht
+{
+	namespace Particle
+	{
+		template<typename T>
+		static void compactStream(T* stream, const u32* alive, u32 begin, u32 end)
+		{
+			for (u32 i = begin; i < end; i++)
+				stream[i] = stream[alive[i]];
+		}
+
+		CParticleData::CParticleData() :
+			m_count(0),
+			m_capacity(0)
+		{
+			grow(64);
+		}
+
+		CParticleData::~CParticleData()
+		{
+
+		}
+
+		void CParticleData::grow(u32 capacity)
+		{
+			m_capacity = capacity;
+
+			for (int i = 0; i < NumFloatStreams; i++)
+				m_floatStreams[i].set_used(m_capacity);
+
+			m_immortal.set_used(m_capacity);
+			m_haveRotate.set_used(m_capacity);
+			m_parentIndex.set_used(m_capacity);
+			m_userData.set_used(m_capacity);
+			m_alive.set_used(m_capacity);
+
+			// bind the streams
+			int s = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				Position[i] = m_floatStreams[s++].pointer();
+				LastPosition[i] = m_floatStreams[s++].pointer();
+				Velocity[i] = m_floatStreams[s++].pointer();
+				Rotation[i] = m_floatStreams[s++].pointer();
+				SubEmitterDirection[i] = m_floatStreams[s++].pointer();
+			}
+
+			Age = m_floatStreams[s++].pointer();
+			Life = m_floatStreams[s++].pointer();
+			LifeTime = m_floatStreams[s++].pointer();
+
+			for (int i = 0; i < NumParams; i++)
+			{
+				Params[i] = m_floatStreams[s++].pointer();
+				StartValue[i] = m_floatStreams[s++].pointer();
+				EndValue[i] = m_floatStreams[s++].pointer();
+			}
+
+			Immortal = m_immortal.pointer();
+			HaveRotate = m_haveRotate.pointer();
+			ParentIndex = m_parentIndex.pointer();
+			UserData = m_userData.pointer();
+		}
+
+		u32 CParticleData::create(u32 num)
+		{
+			u32 first = m_count;
+			u32 total = m_count + num;
+
+			if (total > m_capacity)
+				grow(core::max_(total, m_capacity * 2));
+
+			for (int i = 0; i < NumFloatStreams; i++)
+			{
+				float* s = m_floatStreams[i].pointer();
+				for (u32 j = first; j < total; j++)
+					s[j] = 0.0f;
+			}
+
+			for (u32 j = first; j < total; j++)
+			{
+				SubEmitterDirection[1][j] = 1.0f;
+
+				Params[ColorR][j] = 1.0f;
+				Params[ColorG][j] = 1.0f;
+				Params[ColorB][j] = 1.0f;
+				Params[ColorA][j] = 1.0f;
+
+				Params[ScaleX][j] = 1.0f;
+				Params[ScaleY][j] = 1.0f;
+				Params[ScaleZ][j] = 1.0f;
+
+				Params[Mass][j] = 1.0f;
+
+				Immortal[j] = 0;
+				HaveRotate[j] = 0;
+				ParentIndex[j] = -1;
+				UserData[j] = NULL;
+			}
+
+			m_count = total;
+			return first;
+		}
+
+		void CParticleData::setSize(u32 num)
+		{
+			if (num < m_count)
+				m_count = num;
+		}
+
+		void CParticleData::clear()
+		{
+			m_count = 0;
+		}
+
+		void CParticleData::copy(u32 dst, u32 src)
+		{
+			for (int i = 0; i < NumFloatStreams; i++)
+			{
+				float* s = m_floatStreams[i].pointer();
+				s[dst] = s[src];
+			}
+
+			Immortal[dst] = Immortal[src];
+			HaveRotate[dst] = HaveRotate[src];
+			ParentIndex[dst] = ParentIndex[src];
+			UserData[dst] = UserData[src];
+		}
+
+		void CParticleData::swap(u32 a, u32 b)
+		{
+			for (int i = 0; i < NumFloatStreams; i++)
+			{
+				float* s = m_floatStreams[i].pointer();
+				core::swap(s[a], s[b]);
+			}
+
+			core::swap(Immortal[a], Immortal[b]);
+			core::swap(HaveRotate[a], HaveRotate[b]);
+			core::swap(ParentIndex[a], ParentIndex[b]);
+			core::swap(UserData[a], UserData[b]);
+		}
+
+		u32 CParticleData::removeDeadParticles()
+		{
+			const float* life = Life;
+			u32* alive = m_alive.pointer();
+			u32 numAlive = 0;
+
+			// list the alive particles, branchless
+			for (u32 i = 0; i < m_count; i++)
+			{
+				alive[numAlive] = i;
+				numAlive += life[i] >= 0.0f ? 1 : 0;
+			}
+
+			if (numAlive == m_count)
+				return m_count;
+
+			// the particles before the first dead particle are not moved
+			u32 begin = 0;
+			while (begin < numAlive && alive[begin] == begin)
+				begin++;
+
+			core::array<float>* floatStreams = m_floatStreams;
+			int grainSize = numAlive - begin < 4096 ? NumFloatStreams : 4;
+
+			System::CJobSystem::runParallelFor(NumFloatStreams, grainSize, [floatStreams, alive, begin, numAlive](int s, int end)
+				{
+					for (; s < end; s++)
+						compactStream(floatStreams[s].pointer(), alive, begin, numAlive);
+				});
+
+			compactStream(Immortal, alive, begin, numAlive);
+			compactStream(HaveRotate, alive, begin, numAlive);
+			compactStream(ParentIndex, alive, begin, numAlive);
+			compactStream(UserData, alive, begin, numAlive);
+
+			m_count = numAlive;
+			return m_count;
+		}
+
+		void CParticleData::getBBox(core::aabbox3df& box)
+		{
+			if (m_count == 0)
+				return;
+
+			float minValue[3], maxValue[3];
+			for (int a = 0; a < 3; a++)
+			{
+				minValue[a] = Position[a][0];
+				maxValue[a] = Position[a][0];
+			}
+
+			u32 i = 1;
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			if (m_count >= 4)
+			{
+				float lane[4];
+
+				for (int a = 0; a < 3; a++)
+				{
+					const float* p = Position[a];
+					float4 mn = load4(p);
+					float4 mx = mn;
+
+					for (i = 4; i + 4 <= m_count; i += 4)
+					{
+						float4 v = load4(p + i);
+						mn = min4(mn, v);
+						mx = max4(mx, v);
+					}
+
+					store4(lane, mn);
+					minValue[a] = core::min_(core::min_(lane[0], lane[1]), core::min_(lane[2], lane[3]));
+
+					store4(lane, mx);
+					maxValue[a] = core::max_(core::max_(lane[0], lane[1]), core::max_(lane[2], lane[3]));
+				}
+			}
+#endif
+
+			for (; i < m_count; i++)
+			{
+				for (int a = 0; a < 3; a++)
+				{
+					minValue[a] = core::min_(minValue[a], Position[a][i]);
+					maxValue[a] = core::max_(maxValue[a], Position[a][i]);
+				}
+			}
+
+			box.MinEdge.set(minValue[0], minValue[1], minValue[2]);
+			box.MaxEdge.set(maxValue[0], maxValue[1], maxValue[2]);
+		}
+	}
+}
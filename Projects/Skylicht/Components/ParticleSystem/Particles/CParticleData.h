@@ -0,0 +1,155 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	namespace Particle
+	{
+		enum EParticleParams
+		{
+			Scale = 0,
+			ScaleX,
+			ScaleY,
+			ScaleZ,
+			RotateX,
+			RotateY,
+			RotateZ,
+			ColorR,
+			ColorG,
+			ColorB,
+			ColorA,
+			Mass,
+			FrameIndex,
+			RotateSpeedX,
+			RotateSpeedY,
+			RotateSpeedZ,
+			NumParams
+		};
+
+		/// @brief The particles of a group, stored as SoA (structure of arrays).
+		///
+		/// Each attribute is a stream, the vectors are split to the X, Y, Z streams. The systems update the streams 4 particles at once with SSE or NEON (see ParticleSIMD.h).
+		/// The index of a particle is its position on the streams, it is changed when the dead particles are removed.
+		///
+		/// @code
+		/// CParticleData* data = group->getParticleData();
+		/// for (u32 i = 0, n = data->size(); i < n; i++)
+		///		data->Position[1][i] += 1.0f;
+		/// @endcode
+		class COMPONENT_API CParticleData
+		{
+		public:
+			float* Position[3];
+			float* LastPosition[3];
+			float* Velocity[3];
+			float* Rotation[3];
+			float* SubEmitterDirection[3];
+
+			float* Age;
+			float* Life;
+			float* LifeTime;
+
+			float* Params[NumParams];
+			float* StartValue[NumParams];
+			float* EndValue[NumParams];
+
+			u8* Immortal;
+			u8* HaveRotate;
+
+			s32* ParentIndex;
+			void** UserData;
+
+		protected:
+			enum
+			{
+				NumVectorStreams = 5,
+				NumFloatStreams = NumVectorStreams * 3 + 3 + NumParams * 3
+			};
+
+			core::array<float> m_floatStreams[NumFloatStreams];
+
+			core::array<u8> m_immortal;
+
+			core::array<u8> m_haveRotate;
+
+			core::array<s32> m_parentIndex;
+
+			core::array<void*> m_userData;
+
+			core::array<u32> m_alive;
+
+			u32 m_count;
+
+			u32 m_capacity;
+
+		public:
+			CParticleData();
+
+			virtual ~CParticleData();
+
+			inline u32 size()
+			{
+				return m_count;
+			}
+
+			/// @brief Add the particles with the default values
+			/// @return index of the first new particle
+			u32 create(u32 num);
+
+			/// @brief Remove the particles at the end of the streams
+			void setSize(u32 num);
+
+			void clear();
+
+			void copy(u32 dst, u32 src);
+
+			void swap(u32 a, u32 b);
+
+			/// @brief Move the alive particles (Life >= 0) to the front of the streams, stream by stream.
+			/// @return number of alive particles
+			u32 removeDeadParticles();
+
+			/// @brief Compute the bounding box of the positions
+			void getBBox(core::aabbox3df& box);
+
+			inline core::vector3df getVector(float** stream, u32 i)
+			{
+				return core::vector3df(stream[0][i], stream[1][i], stream[2][i]);
+			}
+
+			inline void setVector(float** stream, u32 i, const core::vector3df& v)
+			{
+				stream[0][i] = v.X;
+				stream[1][i] = v.Y;
+				stream[2][i] = v.Z;
+			}
+
+		protected:
+
+			void grow(u32 capacity);
+		};
+	}
+}
@@ -51,9 +51,11 @@ namespace Skylicht
 
 			group->addCallback(this);
 
-			core::array<CParticle>& particles = group->getParticles();
-			for (u32 i = 0, n = particles.size(); i < n; i++)
-				OnParticleBorn(particles[i]);
+			for (u32 i = 0, n = group->getNumParticles(); i < n; i++)
+			{
+				CParticle p = group->getParticle(i);
+				OnParticleBorn(p);
+			}
 
 			m_name = group->Name;
 
@@ -409,28 +411,28 @@ namespace Skylicht
 			m_meshBuffer->setDirty(EBT_VERTEX_AND_INDEX);
 		}
 
-		void CParticleTrail::OnParticleUpdate(CParticle* particles, int num, CGroup* group, float dt)
+		void CParticleTrail::OnParticleUpdate(CParticleData* particles, int num, CGroup* group, float dt)
 		{
 			float seg2 = m_segmentLength * m_segmentLength;
 
 			core::vector3df position;
 
+			float** params = particles->Params;
+
 			for (u32 i = 0; i < (u32)num; i++)
 			{
-				CParticle& p = particles[i];
-
-				STrailInfo& trail = m_trails[p.Index];
+				STrailInfo& trail = m_trails[i];
 
-				position = p.Position;
+				position = particles->getVector(particles->Position, i);
 				m_world.transformVect(position);
 
 				trail.CurrentPosition = position;
 
 				trail.CurrentColor.set(
-					(u32)(p.Params[ColorA] * 255.0f),
-					(u32)(p.Params[ColorR] * 255.0f),
-					(u32)(p.Params[ColorG] * 255.0f),
-					(u32)(p.Params[ColorB] * 255.0f)
+					(u32)(params[ColorA][i] * 255.0f),
+					(u32)(params[ColorR][i] * 255.0f),
+					(u32)(params[ColorG][i] * 255.0f),
+					(u32)(params[ColorB][i] * 255.0f)
 				);
 
 				if (trail.Position->size() == 0)
@@ -133,7 +133,7 @@ namespace Skylicht
 
 			virtual void update(CCamera* camera);
 
-			virtual void OnParticleUpdate(CParticle* particles, int num, CGroup* group, float dt);
+			virtual void OnParticleUpdate(CParticleData* particles, int num, CGroup* group, float dt);
 
 			virtual void OnParticleBorn(CParticle& p);
 
@@ -59,9 +59,11 @@ namespace Skylicht
 			for (CEmitter* e : m_emitters)
 				e->clearBornData();
 
-			core::array<CParticle>& particles = m_parentGroup->getParticles();
-			for (u32 i = 0, n = particles.size(); i < n; i++)
-				OnParticleBorn(particles[i]);
+			for (u32 i = 0, n = m_parentGroup->getNumParticles(); i < n; i++)
+			{
+				CParticle p = m_parentGroup->getParticle(i);
+				OnParticleBorn(p);
+			}
 		}
 
 		void CSubGroup::OnParticleBorn(CParticle& p)
@@ -79,13 +81,13 @@ namespace Skylicht
 				e->deleteBornData();
 			}
 
-			CParticle* particles = getParticlePointer();
-			u32 n = getNumParticles();
+			s32* parentIndex = m_particles.ParentIndex;
+			s32 index = (s32)p.Index;
 
-			for (u32 i = 0; i < n; i++)
+			for (u32 i = 0, n = m_particles.size(); i < n; i++)
 			{
-				if (particles[i].ParentIndex == p.Index)
-					particles[i].ParentIndex = -1;
+				if (parentIndex[i] == index)
+					parentIndex[i] = -1;
 			}
 		}
 
@@ -96,15 +98,16 @@ namespace Skylicht
 				e->swapBornData(p1.Index, p2.Index);
 			}
 
-			CParticle* particles = getParticlePointer();
-			u32 n = getNumParticles();
+			s32* parentIndex = m_particles.ParentIndex;
+			s32 index1 = (s32)p1.Index;
+			s32 index2 = (s32)p2.Index;
 
-			for (u32 i = 0; i < n; i++)
+			for (u32 i = 0, n = m_particles.size(); i < n; i++)
 			{
-				if (particles[i].ParentIndex == p1.Index)
-					particles[i].ParentIndex = p2.Index;
-				else if (particles[i].ParentIndex == p2.Index)
-					particles[i].ParentIndex = p1.Index;
+				if (parentIndex[i] == index1)
+					parentIndex[i] = index2;
+				else if (parentIndex[i] == index2)
+					parentIndex[i] = index1;
 			}
 		}
 
@@ -144,7 +147,7 @@ namespace Skylicht
 			u32 emiterId = 0;
 			u32 emiterLaunch = m_launch.size();
 
-			CParticle* baseParticles = m_parentGroup->getParticlePointer();
+			CParticleData* baseParticles = m_parentGroup->getParticleData();
 
 			for (u32 i = emiterId; i < emiterLaunch; i++)
 			{
@@ -153,25 +156,23 @@ namespace Skylicht
 				{
 					s32 parentIndex = launch.Parent;
 
-					CParticle& base = baseParticles[parentIndex];
-
 					// base orientation
-					m_position = base.Position;
+					m_position = baseParticles->getVector(baseParticles->Position, parentIndex);
 
-					m_direction = base.Velocity;
+					m_direction = baseParticles->getVector(baseParticles->Velocity, parentIndex);
 					if (m_direction.getLengthSQ() == 0.0f)
-						m_direction = base.SubEmitterDirection;
+						m_direction = baseParticles->getVector(baseParticles->SubEmitterDirection, parentIndex);
 					m_direction.normalize();
 
 					m_rotate.rotationFromTo(Transform::Oy, m_direction);
 
 					// init new particle
-					CParticle* newParticles = create(launch.Number);
+					u32 first = create(launch.Number);
 
 					for (u32 j = 0, n = launch.Number; j < n; j++)
 					{
-						CParticle& p = newParticles[j];
-						p.ParentIndex = parentIndex;
+						CParticle p(&m_particles, first + j);
+						p.setParentIndex(parentIndex);
 						launchParticle(p, launch);
 					}
 				}
@@ -251,14 +251,14 @@ namespace Skylicht
 		void CEmitter::generateVelocity(CParticle& particle, CZone* zone, CGroup* group)
 		{
 			float force = random(m_forceMin, m_forceMax);
-			generateVelocity(particle, force / particle.Params[Mass], zone, group);
+			generateVelocity(particle, force / particle.getParam(Mass), zone, group);
 		}
 
 		void CEmitter::emitParticle(CParticle& particle, CZone* zone, CGroup* group)
 		{
 			zone->generatePosition(particle, m_emitFullZone, group);
 			generateVelocity(particle, zone, group);
-			particle.LastPosition = particle.Position;
+			particle.setLastPosition(particle.getPosition());
 		}
 
 		u32 CEmitter::addBornData()
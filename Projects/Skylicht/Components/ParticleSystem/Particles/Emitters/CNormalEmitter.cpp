@@ -65,11 +65,13 @@ namespace Skylicht
 			if (m_inverted)
 				speed = -speed;
 
-			particle.Velocity = zone->computeNormal(particle.Position, group);
+			core::vector3df velocity = zone->computeNormal(particle.getPosition(), group);
 
-			particle.Velocity = group->getTransformVector(particle.Velocity);
-			particle.Velocity.normalize();
-			particle.Velocity *= speed;
+			velocity = group->getTransformVector(velocity);
+			velocity.normalize();
+			velocity *= speed;
+
+			particle.setVelocity(velocity);
 		}
 	}
 }
\ No newline at end of file
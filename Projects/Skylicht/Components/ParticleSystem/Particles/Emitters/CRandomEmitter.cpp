@@ -57,7 +57,7 @@ namespace Skylicht
 				norm = velocity.getLength();
 			} while (norm == 0.0f);
 
-			particle.Velocity = velocity * speed / norm;
+			particle.setVelocity(velocity * speed / norm);
 		}
 
 	}
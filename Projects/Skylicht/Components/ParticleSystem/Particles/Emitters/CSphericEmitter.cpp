@@ -143,13 +143,16 @@ namespace Skylicht
 			float y = sinTheta * sinf(phi);
 			float z = cosf(theta);
 
-			particle.Velocity.X = (m_matrix[0] * x + m_matrix[1] * y + m_matrix[2] * z);
-			particle.Velocity.Y = (m_matrix[3] * x + m_matrix[4] * y + m_matrix[5] * z);
-			particle.Velocity.Z = (m_matrix[6] * x + m_matrix[7] * y + m_matrix[8] * z);
+			core::vector3df velocity;
+			velocity.X = (m_matrix[0] * x + m_matrix[1] * y + m_matrix[2] * z);
+			velocity.Y = (m_matrix[3] * x + m_matrix[4] * y + m_matrix[5] * z);
+			velocity.Z = (m_matrix[6] * x + m_matrix[7] * y + m_matrix[8] * z);
 
-			particle.Velocity = group->getTransformVector(particle.Velocity);
-			particle.Velocity.normalize();
-			particle.Velocity *= speed;
+			velocity = group->getTransformVector(velocity);
+			velocity.normalize();
+			velocity *= speed;
+
+			particle.setVelocity(velocity);
 		}
 	}
 }
@@ -65,7 +65,7 @@ namespace Skylicht
 			core::vector3df direction = group->getTransformVector(m_direction);
 			direction.normalize();
 
-			particle.Velocity = direction * speed;
+			particle.setVelocity(direction * speed);
 		}
 	}
 }
\ No newline at end of file
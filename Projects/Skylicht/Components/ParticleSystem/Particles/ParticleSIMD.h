@@ -0,0 +1,127 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#if defined(SKYLICHT_SSE)
+#include <emmintrin.h>
+#elif defined(SKYLICHT_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Skylicht
+{
+	namespace Particle
+	{
+		// the 4 lanes helpers of the particle kernels (see CParticleData), the kernels load the streams unaligned
+		// and must have the scalar loop for the remain particles and the other platforms
+#if defined(SKYLICHT_SSE)
+		typedef __m128 float4;
+		typedef __m128 mask4;
+
+		static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+		static inline float4 set4(float f) { return _mm_set1_ps(f); }
+		static inline float4 set4(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+		static inline void store4(float* p, float4 a) { _mm_storeu_ps(p, a); }
+		static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+		static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+		static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+		static inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+		static inline float4 madd4(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+		static inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+		static inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+		static inline float4 abs4(float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		static inline mask4 le4(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+		static inline mask4 lt4(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+		static inline mask4 or4(mask4 a, mask4 b) { return _mm_or_ps(a, b); }
+		static inline mask4 and4(mask4 a, mask4 b) { return _mm_and_ps(a, b); }
+		static inline float4 select4(mask4 m, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+		static inline int movemask4(mask4 a) { return _mm_movemask_ps(a); }
+
+		// the lanes have the flag (u8) is not 0
+		static inline mask4 flag4(const u8* p)
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i v = _mm_setr_epi32(p[0], p[1], p[2], p[3]);
+			return _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpeq_epi32(v, zero), _mm_set1_epi32(-1)));
+		}
+#elif defined(SKYLICHT_NEON)
+		typedef float32x4_t float4;
+		typedef uint32x4_t mask4;
+
+		static inline float4 load4(const float* p) { return vld1q_f32(p); }
+		static inline float4 set4(float f) { return vdupq_n_f32(f); }
+		static inline float4 set4(float a, float b, float c, float d)
+		{
+			float v[4] = { a, b, c, d };
+			return vld1q_f32(v);
+		}
+		static inline void store4(float* p, float4 a) { vst1q_f32(p, a); }
+		static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+		static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+		static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+		static inline float4 div4(float4 a, float4 b)
+		{
+			// reciprocal estimate with 2 newton steps
+			float4 r = vrecpeq_f32(b);
+			r = vmulq_f32(vrecpsq_f32(b, r), r);
+			r = vmulq_f32(vrecpsq_f32(b, r), r);
+			return vmulq_f32(a, r);
+		}
+		static inline float4 madd4(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+		static inline float4 min4(float4 a, float4 b) { return vminq_f32(a, b); }
+		static inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+		static inline float4 sqrt4(float4 a)
+		{
+			// a * rsqrt(a), the zero lanes return 0
+			float4 r = vrsqrteq_f32(a);
+			r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+			r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+			uint32x4_t zero = vceqq_f32(a, vdupq_n_f32(0.0f));
+			return vbslq_f32(zero, vdupq_n_f32(0.0f), vmulq_f32(a, r));
+		}
+		static inline float4 abs4(float4 a) { return vabsq_f32(a); }
+		static inline mask4 le4(float4 a, float4 b) { return vcleq_f32(a, b); }
+		static inline mask4 lt4(float4 a, float4 b) { return vcltq_f32(a, b); }
+		static inline mask4 or4(mask4 a, mask4 b) { return vorrq_u32(a, b); }
+		static inline mask4 and4(mask4 a, mask4 b) { return vandq_u32(a, b); }
+		static inline float4 select4(mask4 m, float4 a, float4 b) { return vbslq_f32(m, a, b); }
+		static inline int movemask4(mask4 a)
+		{
+			return (vgetq_lane_u32(a, 0) & 1) |
+				(vgetq_lane_u32(a, 1) & 2) |
+				(vgetq_lane_u32(a, 2) & 4) |
+				(vgetq_lane_u32(a, 3) & 8);
+		}
+
+		// the lanes have the flag (u8) is not 0
+		static inline mask4 flag4(const u8* p)
+		{
+			u32 v[4] = { p[0], p[1], p[2], p[3] };
+			return vmvnq_u32(vceqq_u32(vld1q_u32(v), vdupq_n_u32(0)));
+		}
+#endif
+	}
+}
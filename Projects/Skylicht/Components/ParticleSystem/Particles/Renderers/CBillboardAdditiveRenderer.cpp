@@ -55,7 +55,7 @@ namespace Skylicht
 			m_material->applyMaterial();
 		}
 
-		void CBillboardAdditiveRenderer::updateParticleBuffer(IMeshBuffer* buffer, CParticle* particles, int num)
+		void CBillboardAdditiveRenderer::updateParticleBuffer(IMeshBuffer* buffer, CParticleData* particles, int num)
 		{
 			IVertexBuffer* vtx = buffer->getVertexBuffer();
 			IIndexBuffer* idx = buffer->getIndexBuffer();
@@ -65,8 +65,9 @@ namespace Skylicht
 
 			video::S3DVertex* vertices = (video::S3DVertex*)vtx->getVertices();
 
-			CParticle* p;
-			float* params;
+			float** position = particles->Position;
+			float* rotationZ = particles->Rotation[2];
+			float** params = particles->Params;
 			u32 frame, row, col;
 
 			u32 totalFrames = m_atlasNx * m_atlasNy;
@@ -84,15 +85,12 @@ namespace Skylicht
 
 			for (int i = 0; i < num; i++)
 			{
-				p = particles + i;
-				params = p->Params;
-
-				float sx = SizeX * params[ScaleX] * 0.5f;
-				float sy = SizeY * params[ScaleY] * 0.5f;
+				float sx = SizeX * params[ScaleX][i] * 0.5f;
+				float sy = SizeY * params[ScaleY][i] * 0.5f;
 
 				if (m_billboardType == Billboard)
 				{
-					float rotation = p->Rotation.Z;
+					float rotation = rotationZ[i];
 					float cosA = cosf(rotation);
 					float sinA = sinf(rotation);
 
@@ -117,18 +115,18 @@ namespace Skylicht
 				sideQuad *= sx;
 				upQuad *= sy;
 
-				x = p->Position.X;
-				y = p->Position.Y;
-				z = p->Position.Z;
+				x = position[0][i];
+				y = position[1][i];
+				z = position[2][i];
 
 				color.set(
-					(u32)(params[ColorA] * 255.0f),
-					(u32)(params[ColorR] * 255.0f),
-					(u32)(params[ColorG] * 255.0f),
-					(u32)(params[ColorB] * 255.0f)
+					(u32)(params[ColorA][i] * 255.0f),
+					(u32)(params[ColorR][i] * 255.0f),
+					(u32)(params[ColorG][i] * 255.0f),
+					(u32)(params[ColorB][i] * 255.0f)
 				);
 
-				frame = (u32)params[FrameIndex];
+				frame = (u32)params[FrameIndex][i];
 				frame = frame < 0 ? 0 : frame;
 				frame = frame >= totalFrames ? totalFrames - 1 : frame;
 
@@ -53,7 +53,7 @@ namespace Skylicht
 
 			virtual void getParticleBuffer(IMeshBuffer* buffer);
 
-			virtual void updateParticleBuffer(IMeshBuffer* buffer, CParticle* particles, int num);
+			virtual void updateParticleBuffer(IMeshBuffer* buffer, CParticleData* particles, int num);
 
 			virtual CObjectSerializable* createSerializable();
 
@@ -27,11 +27,57 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "ParticleSystem/Particles/CParticle.h"
 #include "ParticleSystem/Particles/CSubGroup.h"
+#include "ParticleSystem/Particles/ParticleSIMD.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
 	namespace Particle
 	{
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+		static inline float4 gather4(const float* stream, const s32* id)
+		{
+			return set4(stream[id[0]], stream[id[1]], stream[id[2]], stream[id[3]]);
+		}
+#endif
+
+		static void updateParticles(CParticleData* particles, CParticleData* baseParticles, bool syncLife, bool syncColor, int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				s32 parent = particles->ParentIndex[i];
+
+				if (parent >= 0)
+				{
+					for (int a = 0; a < 3; a++)
+						particles->Position[a][i] += (baseParticles->Position[a][parent] - baseParticles->LastPosition[a][parent]);
+
+					if (syncLife)
+					{
+						particles->Age[i] = baseParticles->Age[parent];
+						particles->Life[i] = baseParticles->Life[parent];
+						particles->LifeTime[i] = baseParticles->LifeTime[parent];
+					}
+
+					if (syncColor)
+					{
+						particles->Params[ColorR][i] = baseParticles->Params[ColorR][parent];
+						particles->Params[ColorG][i] = baseParticles->Params[ColorG][parent];
+						particles->Params[ColorB][i] = baseParticles->Params[ColorB][parent];
+						particles->Params[ColorA][i] = baseParticles->Params[ColorA][parent];
+					}
+				}
+				else
+				{
+					// sync dead
+					if (syncLife == true)
+					{
+						particles->Life[i] = -1.0f;
+					}
+				}
+			}
+		}
+
 		CParentRelativeSystem::CParentRelativeSystem() :
 			m_syncLife(false),
 			m_syncColor(false)
@@ -44,7 +90,7 @@ namespace Skylicht
 
 		}
 
-		void CParentRelativeSystem::update(CParticle* particles, int num, CGroup* group, float dt)
+		void CParentRelativeSystem::update(CParticleData* particles, int num, CGroup* group, float dt)
 		{
 			CSubGroup* subGroup = dynamic_cast<CSubGroup*>(group);
 			if (subGroup == NULL)
@@ -52,44 +98,53 @@ namespace Skylicht
 
 			CGroup* parentGroup = subGroup->getParentGroup();
 
-			CParticle* baseParticles = parentGroup->getParticlePointer();
-			CParticle* p;
+			CParticleData* baseParticles = parentGroup->getParticleData();
+			bool syncLife = m_syncLife;
+			bool syncColor = m_syncColor;
 
-// #pragma omp parallel for private(p)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
-
-				if (p->ParentIndex >= 0)
+			System::CJobSystem::runParallelFor(num, 2048, [particles, baseParticles, syncLife, syncColor](int begin, int end)
 				{
-					CParticle& parent = baseParticles[p->ParentIndex];
+					const s32* parentIndex = particles->ParentIndex;
+					int i = begin;
 
-					p->Position += (parent.Position - parent.LastPosition);
-
-					if (m_syncLife)
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+					// the 4 particles have the parent: gather the parent streams
+					for (; i + 4 <= end; i += 4)
 					{
-						p->Age = parent.Age;
-						p->Life = parent.Life;
-						p->LifeTime = parent.LifeTime;
+						const s32* id = parentIndex + i;
+						if ((id[0] | id[1] | id[2] | id[3]) < 0)
+						{
+							updateParticles(particles, baseParticles, syncLife, syncColor, i, i + 4);
+							continue;
+						}
+
+						for (int a = 0; a < 3; a++)
+						{
+							float* position = particles->Position[a];
+							const float* parentPosition = baseParticles->Position[a];
+							const float* parentLastPosition = baseParticles->LastPosition[a];
+
+							float4 delta = sub4(gather4(parentPosition, id), gather4(parentLastPosition, id));
+							store4(position + i, add4(load4(position + i), delta));
+						}
+
+						if (syncLife)
+						{
+							store4(particles->Age + i, gather4(baseParticles->Age, id));
+							store4(particles->Life + i, gather4(baseParticles->Life, id));
+							store4(particles->LifeTime + i, gather4(baseParticles->LifeTime, id));
+						}
+
+						if (syncColor)
+						{
+							for (int c = ColorR; c <= ColorA; c++)
+								store4(particles->Params[c] + i, gather4(baseParticles->Params[c], id));
+						}
 					}
+#endif
 
-					if (m_syncColor)
-					{
-						p->Params[ColorR] = parent.Params[ColorR];
-						p->Params[ColorG] = parent.Params[ColorG];
-						p->Params[ColorB] = parent.Params[ColorB];
-						p->Params[ColorA] = parent.Params[ColorA];
-					}
-				}
-				else
-				{
-					// sync dead
-					if (m_syncLife == true)
-					{
-						p->Life = -1.0f;
-					}
-				}
-			}
+					updateParticles(particles, baseParticles, syncLife, syncColor, i, end);
+				});
 		}
 	}
 }
\ No newline at end of file
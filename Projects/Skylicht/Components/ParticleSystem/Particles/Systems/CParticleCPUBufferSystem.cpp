@@ -44,7 +44,7 @@ namespace Skylicht
 
 		}
 
-		void CParticleCPUBufferSystem::update(CParticle *particles, int num, CGroup *group, float dt)
+		void CParticleCPUBufferSystem::update(CParticleData* particles, int num, CGroup* group, float dt)
 		{
 			CBillboardAdditiveRenderer *billboard = dynamic_cast<CBillboardAdditiveRenderer*>(group->getRenderer());
 			IMeshBuffer *mb = group->getParticleBuffer()->getMeshBuffer();
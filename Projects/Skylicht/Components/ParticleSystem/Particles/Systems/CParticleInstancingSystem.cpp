@@ -27,6 +27,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "ParticleSystem/Particles/CParticle.h"
 #include "ParticleSystem/Particles/CGroup.h"
+#include "Thread/CJobSystem.h"
 
 #include "ParticleSystem/Particles/Renderers/CQuadRenderer.h"
 
@@ -44,7 +45,7 @@ namespace Skylicht
 
 		}
 
-		void CParticleInstancingSystem::update(CParticle* particles, int num, CGroup* group, float dt)
+		void CParticleInstancingSystem::update(CParticleData* particles, int num, CGroup* group, float dt)
 		{
 			CVertexBuffer<SParticleInstance>* buffer = group->getIntancing()->getInstanceBuffer();
 			buffer->set_used(num);
@@ -59,10 +60,6 @@ namespace Skylicht
 
 			SParticleInstance* vtx = (SParticleInstance*)buffer->getVertices();
 
-			CParticle* p;
-			float* params;
-			SParticleInstance* data;
-
 			u32 frameX = 1;
 			u32 frameY = 1;
 
@@ -88,53 +85,59 @@ namespace Skylicht
 			u32 totalFrames = frameX * frameY;
 			float frameW = 1.0f / frameX;
 			float frameH = 1.0f / frameY;
-			u32 frame, row, col;
 
-// #pragma omp parallel for private(p, params, data, frame, row, col)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
-				params = p->Params;
-				data = vtx + i;
-
-				data->Pos.X = p->Position.X;
-				data->Pos.Y = p->Position.Y;
-				data->Pos.Z = p->Position.Z;
-
-				data->Color.set(
-					(u32)(params[ColorA] * 255.0f),
-					(u32)(params[ColorR] * 255.0f),
-					(u32)(params[ColorG] * 255.0f),
-					(u32)(params[ColorB] * 255.0f)
-				);
-
-				data->Size.X = sx * params[ScaleX];
-				data->Size.Y = sy * params[ScaleY];
-				data->Size.Z = sz * params[ScaleZ];
-
-				data->Rotation.X = p->Rotation.X;
-				data->Rotation.Y = p->Rotation.Y;
-				data->Rotation.Z = p->Rotation.Z;
-
-				data->Velocity.X = p->Velocity.X;
-				data->Velocity.Y = p->Velocity.Y;
-				data->Velocity.Z = p->Velocity.Z;
-
-				frame = (u32)params[FrameIndex];
-				frame = frame < 0 ? 0 : frame;
-				frame = frame >= totalFrames ? totalFrames - 1 : frame;
-
-				row = frame / frameX;
-				col = frame - (row * frameX);
-
-				data->UVScale.set(frameW, frameH);
-				data->UVOffset.set(col * frameW, row * frameH);
-			}
+			System::CJobSystem::runParallelFor(num, 1024, [=](int begin, int end)
+				{
+					float** position = particles->Position;
+					float** rotation = particles->Rotation;
+					float** velocity = particles->Velocity;
+					float** params = particles->Params;
+					SParticleInstance* data;
+					u32 frame, row, col;
+
+					for (int i = begin; i < end; i++)
+					{
+						data = vtx + i;
+
+						data->Pos.X = position[0][i];
+						data->Pos.Y = position[1][i];
+						data->Pos.Z = position[2][i];
+
+						data->Color.set(
+							(u32)(params[ColorA][i] * 255.0f),
+							(u32)(params[ColorR][i] * 255.0f),
+							(u32)(params[ColorG][i] * 255.0f),
+							(u32)(params[ColorB][i] * 255.0f)
+						);
+
+						data->Size.X = sx * params[ScaleX][i];
+						data->Size.Y = sy * params[ScaleY][i];
+						data->Size.Z = sz * params[ScaleZ][i];
+
+						data->Rotation.X = rotation[0][i];
+						data->Rotation.Y = rotation[1][i];
+						data->Rotation.Z = rotation[2][i];
+
+						data->Velocity.X = velocity[0][i];
+						data->Velocity.Y = velocity[1][i];
+						data->Velocity.Z = velocity[2][i];
+
+						frame = (u32)params[FrameIndex][i];
+						frame = frame < 0 ? 0 : frame;
+						frame = frame >= totalFrames ? totalFrames - 1 : frame;
+
+						row = frame / frameX;
+						col = frame - (row * frameX);
+
+						data->UVScale.set(frameW, frameH);
+						data->UVOffset.set(col * frameW, row * frameH);
+					}
+				});
 
 			if (num == 1)
 			{
 				// null particle, fix for AngleGLES drawInstancing
-				data = vtx + 1;
+				SParticleInstance* data = vtx + 1;
 				data->Pos.X = 0.0f;
 				data->Pos.Y = 0.0f;
 				data->Pos.Z = 0.0f;
@@ -37,7 +37,7 @@ namespace Skylicht
 
 			virtual ~CParticleInstancingSystem();
 
-			virtual void update(CParticle *particles, int num, CGroup *group, float dt);
+			virtual void update(CParticleData* particles, int num, CGroup* group, float dt);
 		};
 	}
 }
\ No newline at end of file
@@ -27,145 +27,277 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "ParticleSystem/Particles/CParticle.h"
 #include "ParticleSystem/Particles/CGroup.h"
+#include "ParticleSystem/Particles/ParticleSIMD.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
 	namespace Particle
 	{
-		CParticleSystem::CParticleSystem()
+		// age += dt, life -= dt (if the particle is not immortal)
+		static void updateLife(float* age, float* life, const u8* immortal, float dt, int i, int end)
 		{
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			float4 delta = set4(dt);
+			float4 zero = set4(0.0f);
+
+			for (; i + 4 <= end; i += 4)
+			{
+				store4(age + i, add4(load4(age + i), delta));
+				store4(life + i, sub4(load4(life + i), select4(flag4(immortal + i), zero, delta)));
+			}
+#endif
+
+			for (; i < end; i++)
+			{
+				age[i] = age[i] + dt;
 
+				if (!immortal[i])
+					life[i] -= dt;
+			}
 		}
 
-		CParticleSystem::~CParticleSystem()
+		// an axis of: last = position, position += velocity * dt, velocity += gravity
+		static void updatePosition(float* position, float* lastPosition, float* velocity, float dt, float gravity, int i, int end)
 		{
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			float4 delta = set4(dt);
+			float4 g = set4(gravity);
 
+			for (; i + 4 <= end; i += 4)
+			{
+				float4 p = load4(position + i);
+				float4 v = load4(velocity + i);
+
+				store4(lastPosition + i, p);
+				store4(position + i, madd4(v, delta, p));
+				store4(velocity + i, add4(v, g));
+			}
+#endif
+
+			for (; i < end; i++)
+			{
+				lastPosition[i] = position[i];
+				position[i] += velocity[i] * dt;
+				velocity[i] += gravity;
+			}
 		}
 
-		void CParticleSystem::updateLifeTime(CParticle* particles, int num, CGroup* group, float dt)
+		// an axis of: rotation += speed * dt (if the particle have rotate)
+		static void updateRotation(float* rotation, const float* speed, const u8* haveRotate, float dt, int i, int end)
 		{
-			dt = dt * 0.001f;
+			float pi2 = 2 * core::PI;
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			float4 delta = set4(dt);
+			float4 zero = set4(0.0f);
+			float4 round = set4(pi2);
+
+			for (; i + 4 <= end; i += 4)
+			{
+				mask4 rotate = flag4(haveRotate + i);
+
+				float4 r = add4(load4(rotation + i), select4(rotate, mul4(load4(speed + i), delta), zero));
+				store4(rotation + i, r);
+
+				// the same result as fmod, but it is only called on the lanes that are over a round
+				int over = movemask4(and4(rotate, le4(round, abs4(r))));
+				if (over != 0)
+				{
+					for (int k = 0; k < 4; k++)
+					{
+						if (over & (1 << k))
+							rotation[i + k] = fmodf(rotation[i + k], pi2);
+					}
+				}
+			}
+#endif
 
-			CParticle* p;
+			for (; i < end; i++)
+			{
+				if (haveRotate[i])
+				{
+					rotation[i] = rotation[i] + speed[i] * dt;
+
+					if (fabsf(rotation[i]) >= pi2)
+						rotation[i] = fmodf(rotation[i], pi2);
+				}
+			}
+		}
 
-// #pragma omp parallel for private(p)
-			for (int i = 0; i < num; i++)
+		// velocity *= 1 - min(1, friction / mass)
+		static void updateFriction(float** velocity, const float* mass, float friction, int i, int end)
+		{
+			float* vx = velocity[0];
+			float* vy = velocity[1];
+			float* vz = velocity[2];
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			float4 one = set4(1.0f);
+			float4 f4 = set4(friction);
+
+			for (; i + 4 <= end; i += 4)
 			{
-				p = particles + i;
+				float4 f = sub4(one, min4(one, div4(f4, load4(mass + i))));
 
-				// update life time
-				p->Age = p->Age + dt;
+				store4(vx + i, mul4(load4(vx + i), f));
+				store4(vy + i, mul4(load4(vy + i), f));
+				store4(vz + i, mul4(load4(vz + i), f));
+			}
+#endif
 
-				if (!p->Immortal)
-					p->Life -= dt;
+			for (; i < end; i++)
+			{
+				float f = 1.0f - core::min_(1.0f, friction / mass[i]);
+				vx[i] *= f;
+				vy[i] *= f;
+				vz[i] *= f;
 			}
 		}
 
-		void CParticleSystem::update(CParticle* particles, int num, CGroup* group, float dt)
+		// x = clamp(age / lifeTime, 0, 1)
+		static void updateInterpolation(float* x, const float* age, const float* lifeTime, int i, int end)
 		{
-			dt = dt * 0.001f;
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			float4 zero = set4(0.0f);
+			float4 one = set4(1.0f);
 
-			float pi2 = 2 * core::PI;
-			core::vector3df gravity = group->Gravity * dt;
+			for (; i + 4 <= end; i += 4)
+				store4(x + i, min4(max4(div4(load4(age + i), load4(lifeTime + i)), zero), one));
+#endif
 
-			float friction = group->Friction * dt;
+			for (; i < end; i++)
+				x[i] = core::clamp(age[i] / lifeTime[i], 0.0f, 1.0f);
+		}
 
-			CParticle* p;
-			float* params;
+		// param = start + (end - start) * x
+		static void updateParam(float* param, const float* startValue, const float* endValue, const float* x, int i, int end)
+		{
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			for (; i + 4 <= end; i += 4)
+			{
+				float4 s = load4(startValue + i);
+				store4(param + i, madd4(sub4(load4(endValue + i), s), load4(x + i), s));
+			}
+#endif
+
+			for (; i < end; i++)
+				param[i] = startValue[i] + (endValue[i] - startValue[i]) * x[i];
+		}
+
+		CParticleSystem::CParticleSystem()
+		{
+
+		}
+
+		CParticleSystem::~CParticleSystem()
+		{
+
+		}
+
+		void CParticleSystem::updateLifeTime(CParticleData* particles, int num, CGroup* group, float dt)
+		{
+			dt = dt * 0.001f;
+
+			System::CJobSystem::runParallelFor(num, 2048, [particles, dt](int begin, int end)
+				{
+					updateLife(particles->Age, particles->Life, particles->Immortal, dt, begin, end);
+				});
+		}
+
+		void CParticleSystem::update(CParticleData* particles, int num, CGroup* group, float dt)
+		{
+			dt = dt * 0.001f;
 
 			// model
 			std::vector<CModel*>& listModel = group->getModels();
 
-			std::vector<EParticleParams> listParams;
-			std::vector<CInterpolator*> listModelInterpolators;
+			m_paramTypes.set_used(0);
+			m_interpolators.set_used(0);
 
 			for (CModel* m : listModel)
 			{
-				listParams.push_back(m->getType());
+				m_paramTypes.push_back(m->getType());
 
 				CInterpolator* i = m->getInterpolator();
 				if (i && !i->empty())
-					listModelInterpolators.push_back(i);
+					m_interpolators.push_back(i);
 				else
-					listModelInterpolators.push_back(NULL);
+					m_interpolators.push_back(NULL);
 			}
 
 			// list model and param
-			u32 numModels = (u32)listModel.size();
-			CModel** models = listModel.data();
-			EParticleParams* paramTypes = listParams.data();
-			CInterpolator** modelInterpolators = listModelInterpolators.data();
-
-			float f, x, y;
-			EParticleParams t;
-
-// #pragma omp parallel for private(p, params, f, x, y, t)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
-				params = p->Params;
+			u32 numModels = m_paramTypes.size();
+			EParticleParams* paramTypes = m_paramTypes.pointer();
+			CInterpolator** modelInterpolators = m_interpolators.pointer();
 
-				// update life time
-				p->Age = p->Age + dt;
+			m_interpolation.set_used(num);
+			float* interpolation = m_interpolation.pointer();
 
-				if (!p->Immortal)
-					p->Life -= dt;
-
-				p->LastPosition = p->Position;
-
-				p->Position += p->Velocity * dt;
+			core::vector3df gravity = group->Gravity * dt;
 
-				// update gravity
-				p->Velocity += gravity;
+			float friction = group->Friction * dt;
+			bool haveFriction = group->Friction > 0.0f;
 
-				// update rotation
-				if (p->HaveRotate == true)
+			// the particles are independent, update the ranges on the job threads
+			// each range runs the kernels stream by stream
+			System::CJobSystem::runParallelFor(num, 1024, [=](int begin, int end)
 				{
-					p->Rotation.X = p->Rotation.X + params[RotateSpeedX] * dt;
-					p->Rotation.Y = p->Rotation.Y + params[RotateSpeedY] * dt;
-					p->Rotation.Z = p->Rotation.Z + params[RotateSpeedZ] * dt;
+					float* x = interpolation;
+					float** params = particles->Params;
+					EParticleParams t;
 
-					p->Rotation.X = fmod(p->Rotation.X, pi2);
-					p->Rotation.Y = fmod(p->Rotation.Y, pi2);
-					p->Rotation.Z = fmod(p->Rotation.Z, pi2);
-				}
+					// update life time
+					updateLife(particles->Age, particles->Life, particles->Immortal, dt, begin, end);
 
-				// update friction
-				if (group->Friction > 0.0f)
-				{
-					f = 1.0f - core::min_(1.0f, friction / params[Mass]);
-					p->Velocity *= f;
-				}
+					// update position & gravity
+					updatePosition(particles->Position[0], particles->LastPosition[0], particles->Velocity[0], dt, gravity.X, begin, end);
+					updatePosition(particles->Position[1], particles->LastPosition[1], particles->Velocity[1], dt, gravity.Y, begin, end);
+					updatePosition(particles->Position[2], particles->LastPosition[2], particles->Velocity[2], dt, gravity.Z, begin, end);
 
-				// update interpolate parameters
-				x = core::clamp(p->Age / p->LifeTime, 0.0f, 1.0f);
+					// update rotation
+					updateRotation(particles->Rotation[0], params[RotateSpeedX], particles->HaveRotate, dt, begin, end);
+					updateRotation(particles->Rotation[1], params[RotateSpeedY], particles->HaveRotate, dt, begin, end);
+					updateRotation(particles->Rotation[2], params[RotateSpeedZ], particles->HaveRotate, dt, begin, end);
 
-				for (u32 j = 0; j < numModels; j++)
-				{
-					// linear
-					y = x;
-					t = paramTypes[j];
+					// update friction
+					if (haveFriction)
+						updateFriction(particles->Velocity, params[Mass], friction, begin, end);
 
-					if (modelInterpolators[j])
-					{
-						// interpolate
-						y = modelInterpolators[j]->interpolate(x);
-						params[t] = y;
-					}
-					else
-					{
-						// update param value
-						params[t] = p->StartValue[t] + (p->EndValue[t] - p->StartValue[t]) * y;
-					}
+					if (numModels == 0)
+						return;
+
+					// update interpolate parameters
+					updateInterpolation(x, particles->Age, particles->LifeTime, begin, end);
 
-					if (t == Scale)
+					for (u32 j = 0; j < numModels; j++)
 					{
-						params[ScaleX] = params[Scale];
-						params[ScaleY] = params[Scale];
-						params[ScaleZ] = params[Scale];
+						t = paramTypes[j];
+
+						if (modelInterpolators[j])
+						{
+							// interpolate
+							CInterpolator* interpolator = modelInterpolators[j];
+							float* param = params[t];
+
+							for (int i = begin; i < end; i++)
+								param[i] = interpolator->interpolate(x[i]);
+						}
+						else
+						{
+							// linear
+							updateParam(params[t], particles->StartValue[t], particles->EndValue[t], x, begin, end);
+						}
+
+						if (t == Scale)
+						{
+							u32 size = (end - begin) * sizeof(float);
+							memcpy(params[ScaleX] + begin, params[Scale] + begin, size);
+							memcpy(params[ScaleY] + begin, params[Scale] + begin, size);
+							memcpy(params[ScaleZ] + begin, params[Scale] + begin, size);
+						}
 					}
-				}
-			}
+				});
 		}
 	}
 }
\ No newline at end of file
@@ -25,21 +25,33 @@ https://github.com/skylicht-lab/skylicht-engine
 #pragma once
 
 #include "ISystem.h"
+#include "ParticleSystem/Particles/CParticle.h"
 
 namespace Skylicht
 {
+	class CInterpolator;
+
 	namespace Particle
 	{
 		class COMPONENT_API CParticleSystem : public ISystem
 		{
+		protected:
+			// the models of group, collected at the begin of update
+			core::array<EParticleParams> m_paramTypes;
+
+			core::array<CInterpolator*> m_interpolators;
+
+			// the interpolation value (age / lifeTime) of the particles
+			core::array<float> m_interpolation;
+
 		public:
 			CParticleSystem();
 
 			virtual ~CParticleSystem();
 
-			void updateLifeTime(CParticle *particles, int num, CGroup *group, float dt);
+			void updateLifeTime(CParticleData* particles, int num, CGroup* group, float dt);
 
-			virtual void update(CParticle *particles, int num, CGroup *group, float dt);
+			virtual void update(CParticleData* particles, int num, CGroup* group, float dt);
 		};
 	}
 }
\ No newline at end of file
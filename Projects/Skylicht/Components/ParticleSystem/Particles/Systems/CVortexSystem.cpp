@@ -27,6 +27,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "ParticleSystem/Particles/CParticle.h"
 #include "ParticleSystem/Particles/CGroup.h"
+#include "ParticleSystem/Particles/ParticleSIMD.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
@@ -49,7 +51,7 @@ namespace Skylicht
 
 		}
 
-		void CVortexSystem::update(CParticle *particles, int num, CGroup *group, float dt)
+		void CVortexSystem::update(CParticleData* particles, int num, CGroup* group, float dt)
 		{
 			core::vector3df position = group->getTransformPosition(m_position);
 
@@ -58,58 +60,149 @@ namespace Skylicht
 
 			float deltaTime = dt * 0.001f;
 
-			CParticle *p;
-			float dist, angle, endRadius;
-			core::vector3df rotationCenter, normal, tangent, attraction;
+			float rotationSpeed = m_rotationSpeed;
+			float attractionSpeed = m_attractionSpeed;
+			float eyeAttractionSpeed = m_eyeAttractionSpeed;
+			float eyeRadius = m_eyeRadius;
+			bool killingParticle = m_killingParticleEnabled;
 
-// #pragma omp parallel for private(p, dist, angle, endRadius, rotationCenter, normal, tangent, attraction)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
+			float* life = particles->Life;
+			float* px = particles->Position[0];
+			float* py = particles->Position[1];
+			float* pz = particles->Position[2];
 
-				// Distance of the projection point from the position of the vortex
-				dist = direction.dotProduct(p->Position - position);
-
-				// Position of the rotation center (orthogonal projection of the particle)
-				rotationCenter = direction;
-				rotationCenter *= dist;
-
-				attraction = -rotationCenter;
-
-				rotationCenter += position;
-
-				// Distance of the particle from the eye of the vortex
-				dist = rotationCenter.getDistanceFrom(p->Position);
-
-				if (dist <= m_eyeRadius)
+			System::CJobSystem::runParallelFor(num, 1024, [=](int begin, int end)
 				{
-					if (m_killingParticleEnabled)
-						p->Life = -1.0f;
-					continue;
-				}
+					int i = begin;
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+					float4 dx = set4(direction.X), dy = set4(direction.Y), dz = set4(direction.Z);
+					float4 cx = set4(position.X), cy = set4(position.Y), cz = set4(position.Z);
+					float4 zero = set4(0.0f);
+					float4 eye = set4(eyeRadius);
+					float4 rotation = set4(rotationSpeed * deltaTime);
+					float4 attractionStep = set4(attractionSpeed * deltaTime);
+					float4 eyeAttraction = set4(eyeAttractionSpeed * deltaTime);
+					float4 dead = set4(-1.0f);
+					float lane[4], cosA[4], sinA[4];
+
+					for (; i + 4 <= end; i += 4)
+					{
+						float4 x = load4(px + i);
+						float4 y = load4(py + i);
+						float4 z = load4(pz + i);
+
+						// Distance of the projection point from the position of the vortex
+						float4 dist = madd4(dx, sub4(x, cx), madd4(dy, sub4(y, cy), mul4(dz, sub4(z, cz))));
+
+						// Position of the rotation center (orthogonal projection of the particle)
+						float4 rx = madd4(dx, dist, cx);
+						float4 ry = madd4(dy, dist, cy);
+						float4 rz = madd4(dz, dist, cz);
+
+						// Distance attraction: the normalized -direction * dist
+						float4 sign = sub4(select4(lt4(dist, zero), set4(1.0f), zero), select4(lt4(zero, dist), set4(1.0f), zero));
+
+						// Distance of the particle from the eye of the vortex
+						float4 nx = sub4(x, rx);
+						float4 ny = sub4(y, ry);
+						float4 nz = sub4(z, rz);
+						dist = sqrt4(madd4(nx, nx, madd4(ny, ny, mul4(nz, nz))));
+
+						// the particles in the eye are not moved
+						mask4 inEye = le4(dist, eye);
+
+						float4 angle = div4(rotation, dist);
+						float4 attraction = mul4(sign, div4(eyeAttraction, dist));
+
+						// Computes ortho base
+						nx = div4(nx, dist);
+						ny = div4(ny, dist);
+						nz = div4(nz, dist);
+
+						float4 tx = sub4(mul4(dy, nz), mul4(dz, ny));
+						float4 ty = sub4(mul4(dz, nx), mul4(dx, nz));
+						float4 tz = sub4(mul4(dx, ny), mul4(dy, nx));
+
+						float4 endRadius = sub4(dist, attractionStep);
+						mask4 toEye = le4(endRadius, eye);
+						endRadius = max4(endRadius, eye);
+
+						// sin & cos of the lanes
+						store4(lane, angle);
+						for (int k = 0; k < 4; k++)
+						{
+							cosA[k] = cosf(lane[k]);
+							sinA[k] = sinf(lane[k]);
+						}
+
+						float4 c = mul4(endRadius, load4(cosA));
+						float4 s = mul4(endRadius, load4(sinA));
+
+						store4(px + i, select4(inEye, x, madd4(nx, c, madd4(tx, s, madd4(dx, attraction, rx)))));
+						store4(py + i, select4(inEye, y, madd4(ny, c, madd4(ty, s, madd4(dy, attraction, ry)))));
+						store4(pz + i, select4(inEye, z, madd4(nz, c, madd4(tz, s, madd4(dz, attraction, rz)))));
+
+						if (killingParticle)
+							store4(life + i, select4(or4(inEye, toEye), dead, load4(life + i)));
+					}
+#endif
+
+					float dist, angle, endRadius;
+					core::vector3df p, rotationCenter, normal, tangent, attraction;
+
+					for (; i < end; i++)
+					{
+						p.set(px[i], py[i], pz[i]);
+
+						// Distance of the projection point from the position of the vortex
+						dist = direction.dotProduct(p - position);
+
+						// Position of the rotation center (orthogonal projection of the particle)
+						rotationCenter = direction;
+						rotationCenter *= dist;
+
+						attraction = -rotationCenter;
+
+						rotationCenter += position;
+
+						// Distance of the particle from the eye of the vortex
+						dist = rotationCenter.getDistanceFrom(p);
+
+						if (dist <= eyeRadius)
+						{
+							if (killingParticle)
+								life[i] = -1.0f;
+							continue;
+						}
+
+						angle = rotationSpeed * deltaTime / dist;
+
+						// Distance attraction
+						attraction.normalize();
+						attraction *= eyeAttractionSpeed * deltaTime / dist;
+
+						// Computes ortho base
+						normal = (p - rotationCenter) / dist;
+						tangent = direction.crossProduct(normal);
 
-				angle = m_rotationSpeed * deltaTime / dist;
-
-				// Distance attraction
-				attraction.normalize();
-				attraction *= m_eyeAttractionSpeed * deltaTime / dist;
-
-				// Computes ortho base
-				normal = (p->Position - rotationCenter) / dist;
-				tangent = direction.crossProduct(normal);
-
-				endRadius = dist - m_attractionSpeed * deltaTime;
-				if (endRadius <= m_eyeRadius)
-				{
-					endRadius = m_eyeRadius;
-					if (m_killingParticleEnabled)
-						p->Life = -1.0f;
-				}
+						endRadius = dist - attractionSpeed * deltaTime;
+						if (endRadius <= eyeRadius)
+						{
+							endRadius = eyeRadius;
+							if (killingParticle)
+								life[i] = -1.0f;
+						}
 
-				p->Position = rotationCenter + normal * endRadius * cosf(angle) + tangent * endRadius * sinf(angle);
+						p = rotationCenter + normal * endRadius * cosf(angle) + tangent * endRadius * sinf(angle);
+
+						p += attraction;
 
-				p->Position += attraction;
-			}
+						px[i] = p.X;
+						py[i] = p.Y;
+						pz[i] = p.Z;
+					}
+				});
 		}
 	}
 }
\ No newline at end of file
@@ -65,9 +65,10 @@ namespace Skylicht
 		{
 			core::vector3df pos = group->getTransformPosition(m_position);
 
-			particle.Position.X = pos.X + random(-m_dimension.X * 0.5f, m_dimension.X * 0.5f);
-			particle.Position.Y = pos.Y + random(-m_dimension.Y * 0.5f, m_dimension.Y * 0.5f);
-			particle.Position.Z = pos.Z + random(-m_dimension.Z * 0.5f, m_dimension.Z * 0.5f);
+			core::vector3df position;
+			position.X = pos.X + random(-m_dimension.X * 0.5f, m_dimension.X * 0.5f);
+			position.Y = pos.Y + random(-m_dimension.Y * 0.5f, m_dimension.Y * 0.5f);
+			position.Z = pos.Z + random(-m_dimension.Z * 0.5f, m_dimension.Z * 0.5f);
 
 			if (!full)
 			{
@@ -77,16 +78,18 @@ namespace Skylicht
 				switch (axis)
 				{
 				case 0:
-					particle.Position.X = pos.X + sens * m_dimension.X * 0.5f;
+					position.X = pos.X + sens * m_dimension.X * 0.5f;
 					break;
 				case 1:
-					particle.Position.Y = pos.Y + sens * m_dimension.Y * 0.5f;
+					position.Y = pos.Y + sens * m_dimension.Y * 0.5f;
 					break;
 				default:
-					particle.Position.Z = pos.Z + sens * m_dimension.Z * 0.5f;
+					position.Z = pos.Z + sens * m_dimension.Z * 0.5f;
 					break;
 				}
 			}
+
+			particle.setPosition(position);
 		}
 
 		core::vector3df CAABox::computeNormal(const core::vector3df& point, CGroup* group)
@@ -103,7 +103,7 @@ namespace Skylicht
 
 			core::vector3df b = a.crossProduct(-dir);
 
-			particle.Position = pos + cLength * dir + a * cRadius * cosf(cAngle) + b * cRadius * sinf(cAngle);
+			particle.setPosition(pos + cLength * dir + a * cRadius * cosf(cAngle) + b * cRadius * sinf(cAngle));
 		}
 
 		core::vector3df CCylinder::computeNormal(const core::vector3df& point, CGroup* group)
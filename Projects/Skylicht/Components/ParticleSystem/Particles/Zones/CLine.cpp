@@ -69,7 +69,7 @@ namespace Skylicht
 			core::vector3df direction = group->getTransformPosition(m_p2) - pos;
 
 			float ratio = random(0.0f, 1.0f);
-			particle.Position = pos + direction * ratio;
+			particle.setPosition(pos + direction * ratio);
 		}
 
 		core::vector3df CLine::computeNormal(const core::vector3df& point, CGroup* group)
@@ -58,7 +58,7 @@ namespace Skylicht
 		void CPoint::generatePosition(CParticle& particle, bool full, CGroup* group)
 		{
 			core::vector3df pos = group->getTransformPosition(m_position);
-			particle.Position = pos;
+			particle.setPosition(pos);
 		}
 
 		core::vector3df CPoint::computeNormal(const core::vector3df& point, CGroup* group)
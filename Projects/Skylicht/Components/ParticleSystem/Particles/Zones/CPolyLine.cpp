@@ -137,7 +137,7 @@ namespace Skylicht
 			core::vector3df direction = group->getTransformPosition(p2) - pos;
 			direction.normalize();
 
-			particle.Position = pos + direction * l;
+			particle.setPosition(pos + direction * l);
 		}
 
 		core::vector3df CPolyLine::computeNormal(const core::vector3df& point, CGroup* group)
@@ -98,7 +98,7 @@ namespace Skylicht
 			v.normalize();
 			v *= sqrtf(random(sqrMinRadius, sqrMaxRadius)); // to have a uniform distribution
 
-			particle.Position = pos + v;
+			particle.setPosition(pos + v);
 		}
 
 		core::vector3df CRing::computeNormal(const core::vector3df& point, CGroup* group)
@@ -81,7 +81,7 @@ namespace Skylicht
 				r *= m_radius;
 			}
 
-			particle.Position = group->getTransformPosition(m_position) + r;
+			particle.setPosition(group->getTransformPosition(m_position) + r);
 		}
 
 		core::vector3df CSphere::computeNormal(const core::vector3df& point, CGroup* group)
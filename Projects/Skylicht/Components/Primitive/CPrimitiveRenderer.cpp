@@ -37,7 +37,7 @@ namespace Skylicht
 	CPrimitiveRenderer::CPrimitiveRenderer() :
 		m_group(NULL)
 	{
-
+		m_cullingDependent = true;
 	}
 
 	CPrimitiveRenderer::~CPrimitiveRenderer()
@@ -10,7 +10,7 @@ namespace Skylicht
 	CLineRenderer::CLineRenderer() :
 		m_group(NULL)
 	{
-
+		m_cullingDependent = true;
 	}
 
 	CLineRenderer::~CLineRenderer()
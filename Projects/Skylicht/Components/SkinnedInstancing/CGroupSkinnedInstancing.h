@@ -39,5 +39,7 @@ namespace Skylicht
 		virtual ~CGroupSkinnedInstancing();
 
 		virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+		virtual bool onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity);
 	};
 }
\ No newline at end of file
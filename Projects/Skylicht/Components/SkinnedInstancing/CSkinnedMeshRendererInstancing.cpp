@@ -43,6 +43,7 @@ namespace Skylicht
 		m_group(NULL)
 	{
 		m_pipelineType = IRenderPipeline::Mix;
+		m_cullingDependent = true;
 	}
 
 	CSkinnedMeshRendererInstancing::~CSkinnedMeshRendererInstancing()
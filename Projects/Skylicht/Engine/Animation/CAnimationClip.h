@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CAnimationTrack.h"
+#include "CCompressedAnimation.h"
 
 namespace Skylicht
 {
@@ -45,11 +46,17 @@ namespace Skylicht
 		std::vector<SEntityAnim*> AnimInfo;
 		std::map<std::string, SEntityAnim*> AnimNameToInfo;
 
+	protected:
+		// the keys of all tracks, see CAnimationCompressor
+		CCompressedAnimationClip* m_compressed;
+
+	public:
 		CAnimationClip()
 		{
 			AnimName = "";
 			Duration = 0.0f;
 			Loop = true;
+			m_compressed = NULL;
 		}
 
 		virtual ~CAnimationClip()
@@ -65,6 +72,21 @@ namespace Skylicht
 			}
 			AnimInfo.clear();
 			AnimNameToInfo.clear();
+
+			delete m_compressed;
+			m_compressed = NULL;
+		}
+
+		void setCompressed(CCompressedAnimationClip* compressed)
+		{
+			if (m_compressed != compressed)
+				delete m_compressed;
+			m_compressed = compressed;
+		}
+
+		CCompressedAnimationClip* getCompressed()
+		{
+			return m_compressed;
 		}
 
 		void addAnim(SEntityAnim* anim)
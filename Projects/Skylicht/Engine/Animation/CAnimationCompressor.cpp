@@ -0,0 +1,288 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CAnimationCompressor.h"
+
+namespace Skylicht
+{
+	CAnimationCompressor::CAnimationCompressor() :
+		SampleRate(30.0f),
+		MaxSampleRate(120.0f),
+		PositionTolerance(0.001f),
+		RotationTolerance(0.001f),
+		ScaleTolerance(0.001f),
+		ReleaseKeyFrames(false),
+		m_positionError(0.0f),
+		m_rotationError(0.0f),
+		m_scaleError(0.0f)
+	{
+
+	}
+
+	CAnimationCompressor::~CAnimationCompressor()
+	{
+
+	}
+
+	bool CAnimationCompressor::compress(CAnimationClip* clip)
+	{
+		int numTrack = clip->getNodeAnimCount();
+		if (numTrack == 0)
+			return false;
+
+		float duration = 0.0f;
+		for (int i = 0; i < numTrack; i++)
+			duration = core::max_(duration, clip->getAnimOfEntity(i)->Data.getLastFrame());
+
+		std::vector<CCompressedAnimationData*> tracks;
+		CCompressedAnimationClip* result = NULL;
+
+		float sampleRate = SampleRate;
+
+		while (true)
+		{
+			result = compress(clip, sampleRate, duration, tracks);
+
+			m_positionError = 0.0f;
+			m_rotationError = 0.0f;
+			m_scaleError = 0.0f;
+
+			float frameStep = result->NumFrame > 1 ? duration / (float)(result->NumFrame - 1) : 0.0f;
+
+			for (int i = 0; i < numTrack; i++)
+				measureError(&clip->getAnimOfEntity(i)->Data, tracks[i], frameStep, duration);
+
+			if (m_positionError <= PositionTolerance &&
+				m_rotationError <= RotationTolerance &&
+				m_scaleError <= ScaleTolerance)
+			{
+				break;
+			}
+
+			for (CCompressedAnimationData* track : tracks)
+				delete track;
+			tracks.clear();
+
+			delete result;
+			result = NULL;
+
+			if (sampleRate >= MaxSampleRate)
+			{
+				char log[512];
+				sprintf(log, "[CAnimationCompressor] %s is over the tolerances at %.0f fps", clip->AnimName.c_str(), MaxSampleRate);
+				os::Printer::log(log);
+				return false;
+			}
+
+			sampleRate = core::min_(sampleRate * 2.0f, MaxSampleRate);
+		}
+
+		// apply to the clip
+		clip->setCompressed(result);
+
+		for (int i = 0; i < numTrack; i++)
+		{
+			CAnimationData& data = clip->getAnimOfEntity(i)->Data;
+
+			delete data.Compressed;
+			data.Compressed = tracks[i];
+
+			if (ReleaseKeyFrames)
+			{
+				data.Positions.Data.clear();
+				data.Rotations.Data.clear();
+				data.Scales.Data.clear();
+			}
+		}
+
+		return true;
+	}
+
+	CCompressedAnimationClip* CAnimationCompressor::compress(CAnimationClip* clip, float sampleRate, float duration, std::vector<CCompressedAnimationData*>& tracks)
+	{
+		int numTrack = clip->getNodeAnimCount();
+		int numFrame = core::max_(1, (int)ceilf(duration * sampleRate) + 1);
+
+		// the last frame is at duration
+		float frameStep = numFrame > 1 ? duration / (float)(numFrame - 1) : 0.0f;
+
+		CCompressedAnimationClip* result = new CCompressedAnimationClip();
+		result->NumFrame = numFrame;
+		result->NumTrack = numTrack;
+		result->SampleRate = sampleRate;
+		result->Duration = duration;
+		result->Keys.set_used(numFrame * numTrack);
+
+		SCompressedKey* keys = result->Keys.pointer();
+
+		core::array<core::vector3df> positions;
+		core::array<core::vector3df> scales;
+		core::array<core::quaternion> rotations;
+
+		positions.set_used(numFrame);
+		scales.set_used(numFrame);
+		rotations.set_used(numFrame);
+
+		for (int i = 0; i < numTrack; i++)
+		{
+			CAnimationData* data = &clip->getAnimOfEntity(i)->Data;
+
+			// sample the raw keys
+			CAnimationTrack track;
+			track.setAnimationData(data);
+
+			core::aabbox3df positionBox;
+			core::aabbox3df scaleBox;
+
+			for (int f = 0; f < numFrame; f++)
+			{
+				track.getKeyFrameData(f * frameStep, positions[f], scales[f], rotations[f]);
+				rotations[f].normalize();
+
+				if (f == 0)
+				{
+					positionBox.reset(positions[f]);
+					scaleBox.reset(scales[f]);
+				}
+				else
+				{
+					positionBox.addInternalPoint(positions[f]);
+					scaleBox.addInternalPoint(scales[f]);
+				}
+			}
+
+			CCompressedAnimationData* compressed = new CCompressedAnimationData();
+			compressed->Keys = keys + i;
+			compressed->Stride = numTrack;
+			compressed->NumFrame = numFrame;
+			compressed->Duration = duration;
+			compressed->InvFrameStep = frameStep > 0.0f ? 1.0f / frameStep : 0.0f;
+			compressed->PositionMin = positionBox.MinEdge;
+			compressed->PositionStep = (positionBox.MaxEdge - positionBox.MinEdge) / 65535.0f;
+			compressed->ScaleMin = scaleBox.MinEdge;
+			compressed->ScaleStep = (scaleBox.MaxEdge - scaleBox.MinEdge) / 65535.0f;
+
+			const core::vector3df positionRange = positionBox.MaxEdge - positionBox.MinEdge;
+			const core::vector3df scaleRange = scaleBox.MaxEdge - scaleBox.MinEdge;
+
+			const float* pMin = &positionBox.MinEdge.X;
+			const float* pRange = &positionRange.X;
+			const float* sMin = &scaleBox.MinEdge.X;
+			const float* sRange = &scaleRange.X;
+
+			for (int f = 0; f < numFrame; f++)
+			{
+				SCompressedKey& key = keys[f * numTrack + i];
+
+				const float* p = &positions[f].X;
+				const float* s = &scales[f].X;
+
+				for (int a = 0; a < 3; a++)
+				{
+					key.Position[a] = pRange[a] > 0.0f ? (u16)((p[a] - pMin[a]) / pRange[a] * 65535.0f + 0.5f) : 0;
+					key.Scale[a] = sRange[a] > 0.0f ? (u16)((s[a] - sMin[a]) / sRange[a] * 65535.0f + 0.5f) : 0;
+				}
+
+				CCompressedAnimationData::encodeRotation(rotations[f], key.Rotation);
+			}
+
+			tracks.push_back(compressed);
+		}
+
+		return result;
+	}
+
+	void CAnimationCompressor::measureError(CAnimationData* data, CCompressedAnimationData* compressed, float frameStep, float duration)
+	{
+		CAnimationTrack track;
+		track.setAnimationData(data);
+
+		core::vector3df position1, position2;
+		core::vector3df scale1, scale2;
+		core::quaternion rotation1, rotation2;
+
+		// test on the sample frames, the middle of them and the raw keys
+		core::array<float> frames;
+
+		if (frameStep > 0.0f)
+		{
+			for (float f = 0.0f; f < duration; f += frameStep)
+			{
+				frames.push_back(f);
+				frames.push_back(f + frameStep * 0.5f);
+			}
+		}
+		frames.push_back(duration);
+
+		for (u32 i = 0, n = data->Positions.size(); i < n; i++)
+			frames.push_back(data->Positions.Data[i].Frame);
+
+		for (u32 i = 0, n = data->Rotations.size(); i < n; i++)
+			frames.push_back(data->Rotations.Data[i].Frame);
+
+		for (u32 i = 0, n = data->Scales.size(); i < n; i++)
+			frames.push_back(data->Scales.Data[i].Frame);
+
+		for (u32 i = 0, n = frames.size(); i < n; i++)
+		{
+			track.getKeyFrameData(frames[i], position1, scale1, rotation1);
+			compressed->sample(frames[i], position2, scale2, rotation2);
+
+			rotation1.normalize();
+
+			float dot = fabsf(rotation1.dotProduct(rotation2));
+			float angle = 2.0f * acosf(core::min_(dot, 1.0f));
+
+			m_positionError = core::max_(m_positionError, position1.getDistanceFrom(position2));
+			m_scaleError = core::max_(m_scaleError, scale1.getDistanceFrom(scale2));
+			m_rotationError = core::max_(m_rotationError, angle);
+		}
+	}
+
+	u32 CAnimationCompressor::getKeyFrameMemory(CAnimationClip* clip)
+	{
+		u32 size = 0;
+
+		for (int i = 0, n = clip->getNodeAnimCount(); i < n; i++)
+		{
+			CAnimationData& data = clip->getAnimOfEntity(i)->Data;
+			size += data.Positions.size() * sizeof(CPositionKey);
+			size += data.Rotations.size() * sizeof(CRotationKey);
+			size += data.Scales.size() * sizeof(CScaleKey);
+		}
+
+		return size;
+	}
+
+	u32 CAnimationCompressor::getCompressedMemory(CAnimationClip* clip)
+	{
+		CCompressedAnimationClip* compressed = clip->getCompressed();
+		if (compressed == NULL)
+			return 0;
+
+		return compressed->Keys.size() * sizeof(SCompressedKey) +
+			clip->getNodeAnimCount() * sizeof(CCompressedAnimationData);
+	}
+}
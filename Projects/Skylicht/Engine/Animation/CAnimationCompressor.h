@@ -0,0 +1,102 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CAnimationClip.h"
+#include "CCompressedAnimation.h"
+
+namespace Skylicht
+{
+	/// @brief The offline compressor, it resamples all tracks of a clip to the uniform frames and quantizes the keys.
+	///
+	/// The sample rate starts at SampleRate and is doubled until the error of all tracks is under the tolerances (or MaxSampleRate).
+	/// @code
+	/// CAnimationCompressor compressor;
+	/// compressor.PositionTolerance = 0.001f;
+	/// if (compressor.compress(clip))
+	///		os::Printer::log("compressed");
+	/// @endcode
+	class SKYLICHT_API CAnimationCompressor
+	{
+	public:
+		// number of sample frames per second
+		float SampleRate;
+
+		float MaxSampleRate;
+
+		// unit
+		float PositionTolerance;
+
+		// radian
+		float RotationTolerance;
+
+		float ScaleTolerance;
+
+		// release the raw keys after compress to save memory, CSkylichtAnimExporter can not export the clip after that
+		bool ReleaseKeyFrames;
+
+	protected:
+		float m_positionError;
+		float m_rotationError;
+		float m_scaleError;
+
+	public:
+		CAnimationCompressor();
+
+		virtual ~CAnimationCompressor();
+
+		/// @brief Compress the clip, the tracks of clip will sample on the compressed keys.
+		/// @return false if the clip is empty or the error is over the tolerances at MaxSampleRate, the clip is not changed.
+		bool compress(CAnimationClip* clip);
+
+		/// @brief The max errors of the last compress
+		inline float getPositionError()
+		{
+			return m_positionError;
+		}
+
+		inline float getRotationError()
+		{
+			return m_rotationError;
+		}
+
+		inline float getScaleError()
+		{
+			return m_scaleError;
+		}
+
+		/// @brief The memory (bytes) of the raw keys
+		static u32 getKeyFrameMemory(CAnimationClip* clip);
+
+		/// @brief The memory (bytes) of the compressed keys
+		static u32 getCompressedMemory(CAnimationClip* clip);
+
+	protected:
+
+		CCompressedAnimationClip* compress(CAnimationClip* clip, float sampleRate, float duration, std::vector<CCompressedAnimationData*>& tracks);
+
+		void measureError(CAnimationData* data, CCompressedAnimationData* compressed, float frameStep, float duration);
+	};
+}
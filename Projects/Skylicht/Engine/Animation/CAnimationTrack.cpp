@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CAnimationTrack.h"
+#include "CCompressedAnimation.h"
 
 namespace Skylicht
 {
@@ -37,6 +38,44 @@ namespace Skylicht
 	{
 	}
 
+	CAnimationData::~CAnimationData()
+	{
+		delete Compressed;
+	}
+
+	CAnimationData::CAnimationData(const CAnimationData& data) :
+		Positions(data.Positions),
+		Rotations(data.Rotations),
+		Scales(data.Scales),
+		Compressed(NULL)
+	{
+	}
+
+	CAnimationData& CAnimationData::operator=(const CAnimationData& data)
+	{
+		if (this != &data)
+		{
+			Positions = data.Positions;
+			Rotations = data.Rotations;
+			Scales = data.Scales;
+
+			delete Compressed;
+			Compressed = NULL;
+		}
+		return *this;
+	}
+
+	f32 CAnimationData::getLastFrame()
+	{
+		if (Compressed)
+			return Compressed->Duration;
+
+		f32 lastFrame = Positions.getLastFrame();
+		lastFrame = core::max_(lastFrame, Rotations.getLastFrame());
+		lastFrame = core::max_(lastFrame, Scales.getLastFrame());
+		return lastFrame;
+	}
+
 	CAnimationData* CAnimationTrack::getAnimData()
 	{
 		return m_data;
@@ -54,6 +93,27 @@ namespace Skylicht
 			return;
 		}
 
+		if (data->Compressed)
+		{
+			data->Compressed->sample(frame, position, scale, rotation);
+			return;
+		}
+
+		getKeyFrameData(frame, position, scale, rotation);
+	}
+
+	void CAnimationTrack::getKeyFrameData(f32 frame,
+		core::vector3df& position,
+		core::vector3df& scale,
+		core::quaternion& rotation)
+	{
+		CAnimationData* data = getAnimData();
+
+		if (data == NULL)
+		{
+			return;
+		}
+
 		s32 foundPositionIndex = -1;
 		s32 foundScaleIndex = -1;
 		s32 foundRotationIndex = -1;
@@ -102,23 +102,34 @@ namespace Skylicht
 			}
 		}
 
-		// The Hint test failed, do a full scan...
+		// The Hint test failed (the playback jump or loop), binary search the first key >= frame
 		if (foundPositionIndex == -1)
 		{
-			for (s32 i = 0; i < numKey; ++i)
+			// Keys should to be sorted by frame
+			int low = 0;
+			int high = numKey;
+
+			while (low < high)
 			{
-				if (pData[i].Frame >= frame) // Keys should to be sorted by frame
-				{
-					foundPositionIndex = i;
-					Hint = i;
-					break;
-				}
+				int mid = (low + high) >> 1;
+				if (pData[mid].Frame < frame)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+
+			if (low < numKey)
+			{
+				foundPositionIndex = low;
+				Hint = low;
 			}
 		}
 
 		return foundPositionIndex;
 	}
 
+	class CCompressedAnimationData;
+
 	class SKYLICHT_API CAnimationData
 	{
 	public:
@@ -126,9 +137,22 @@ namespace Skylicht
 		CArrayKeyFrame<core::quaternion> Rotations;
 		CArrayKeyFrame<core::vector3df> Scales;
 
-		CAnimationData()
+		// the optional compressed keys (see CAnimationCompressor), the track samples on them if not NULL
+		CCompressedAnimationData* Compressed;
+
+		CAnimationData() :
+			Compressed(NULL)
 		{
 		}
+
+		~CAnimationData();
+
+		// the data owns Compressed, the copy only has the raw keys (Compressed is NULL)
+		CAnimationData(const CAnimationData& data);
+
+		CAnimationData& operator=(const CAnimationData& data);
+
+		f32 getLastFrame();
 	};
 
 	class SKYLICHT_API CAnimationTrack
@@ -154,6 +178,12 @@ namespace Skylicht
 			core::vector3df& scale,
 			core::quaternion& rotation);
 
+		/// @brief Sample on the raw keys, even if the data is compressed
+		void getKeyFrameData(f32 frame,
+			core::vector3df& position,
+			core::vector3df& scale,
+			core::quaternion& rotation);
+
 		CAnimationData* getAnimData();
 
 		void clearAllKeyFrame()
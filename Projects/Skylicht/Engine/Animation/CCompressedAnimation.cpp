@@ -0,0 +1,138 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CCompressedAnimation.h"
+
+namespace Skylicht
+{
+	// the smallest three components of an unit quaternion are in [-1/sqrt(2), 1/sqrt(2)]
+	static const float RotationRange = 0.70710678f;
+
+	// 15 bits per component, the highest bits of the first 2 components store the index of the largest component
+	static const float RotationQuantize = 32767.0f;
+
+	CCompressedAnimationData::CCompressedAnimationData() :
+		Keys(NULL),
+		Stride(0),
+		NumFrame(0),
+		Duration(0.0f),
+		InvFrameStep(0.0f)
+	{
+	}
+
+	void CCompressedAnimationData::encodeRotation(const core::quaternion& q, u16* result)
+	{
+		float c[4] = { q.X, q.Y, q.Z, q.W };
+
+		int largest = 0;
+		for (int i = 1; i < 4; i++)
+		{
+			if (fabsf(c[i]) > fabsf(c[largest]))
+				largest = i;
+		}
+
+		// q and -q are the same rotation, keep the largest component positive
+		float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+		for (int i = 0, j = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+
+			float v = core::clamp(c[i] * sign, -RotationRange, RotationRange);
+			v = (v / RotationRange + 1.0f) * 0.5f;
+
+			result[j++] = (u16)(v * RotationQuantize + 0.5f);
+		}
+
+		result[0] |= (u16)((largest & 1) << 15);
+		result[1] |= (u16)((largest >> 1) << 15);
+	}
+
+	void CCompressedAnimationData::decodeRotation(const u16* data, core::quaternion& q)
+	{
+		// the components that are stored, by the index of the largest component
+		static const int order[4][3] = { {1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2} };
+
+		const float scale = 2.0f * RotationRange / RotationQuantize;
+
+		int largest = (data[0] >> 15) | ((data[1] >> 15) << 1);
+
+		float a = (float)(data[0] & 0x7fff) * scale - RotationRange;
+		float b = (float)(data[1] & 0x7fff) * scale - RotationRange;
+		float c = (float)(data[2] & 0x7fff) * scale - RotationRange;
+
+		float* result = &q.X;
+		result[order[largest][0]] = a;
+		result[order[largest][1]] = b;
+		result[order[largest][2]] = c;
+		result[largest] = sqrtf(core::max_(0.0f, 1.0f - a * a - b * b - c * c));
+	}
+
+	void CCompressedAnimationData::sample(f32 frame,
+		core::vector3df& position,
+		core::vector3df& scale,
+		core::quaternion& rotation) const
+	{
+		int frame1 = 0;
+		float t = 0.0f;
+
+		if (NumFrame > 1)
+		{
+			float f = core::clamp(frame, 0.0f, Duration) * InvFrameStep;
+
+			frame1 = (int)f;
+			if (frame1 > NumFrame - 2)
+				frame1 = NumFrame - 2;
+
+			t = f - (float)frame1;
+		}
+
+		const SCompressedKey& a = Keys[frame1 * Stride];
+		const SCompressedKey& b = NumFrame > 1 ? Keys[(frame1 + 1) * Stride] : a;
+
+		position.X = PositionMin.X + PositionStep.X * ((float)a.Position[0] + ((float)b.Position[0] - (float)a.Position[0]) * t);
+		position.Y = PositionMin.Y + PositionStep.Y * ((float)a.Position[1] + ((float)b.Position[1] - (float)a.Position[1]) * t);
+		position.Z = PositionMin.Z + PositionStep.Z * ((float)a.Position[2] + ((float)b.Position[2] - (float)a.Position[2]) * t);
+
+		scale.X = ScaleMin.X + ScaleStep.X * ((float)a.Scale[0] + ((float)b.Scale[0] - (float)a.Scale[0]) * t);
+		scale.Y = ScaleMin.Y + ScaleStep.Y * ((float)a.Scale[1] + ((float)b.Scale[1] - (float)a.Scale[1]) * t);
+		scale.Z = ScaleMin.Z + ScaleStep.Z * ((float)a.Scale[2] + ((float)b.Scale[2] - (float)a.Scale[2]) * t);
+
+		core::quaternion q1, q2;
+		decodeRotation(a.Rotation, q1);
+		decodeRotation(b.Rotation, q2);
+
+		// the frames are close, so normalized lerp is enough (the compressor checks the error)
+		float s = (q1.X * q2.X + q1.Y * q2.Y + q1.Z * q2.Z + q1.W * q2.W) < 0.0f ? -t : t;
+		float r = 1.0f - t;
+
+		rotation.X = q1.X * r + q2.X * s;
+		rotation.Y = q1.Y * r + q2.Y * s;
+		rotation.Z = q1.Z * r + q2.Z * s;
+		rotation.W = q1.W * r + q2.W * s;
+		rotation.normalize();
+	}
+}
@@ -0,0 +1,102 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	/// @brief The quantized key of a track at a sample frame (18 bytes).
+	/// Position and scale are quantized in the range of the track, rotation is the smallest three components of the quaternion.
+	struct SCompressedKey
+	{
+		u16 Position[3];
+		u16 Rotation[3];
+		u16 Scale[3];
+	};
+
+	/// @brief The uniformly resampled keys of all tracks in a clip, see CAnimationCompressor.
+	///
+	/// The keys are interleaved by frame: Keys[frame * NumTrack + track], so the skeleton samples all bones at a time on the same memory block.
+	class SKYLICHT_API CCompressedAnimationClip
+	{
+	public:
+		core::array<SCompressedKey> Keys;
+
+		int NumFrame;
+
+		int NumTrack;
+
+		// number of sample frames per second
+		float SampleRate;
+
+		// second
+		float Duration;
+
+		CCompressedAnimationClip() :
+			NumFrame(0),
+			NumTrack(0),
+			SampleRate(0.0f),
+			Duration(0.0f)
+		{
+		}
+	};
+
+	/// @brief The compressed keys of a track, they link to the keys in CCompressedAnimationClip.
+	///
+	/// Sampling is a direct index and a lerp, that does not depend on the last frame (no hint).
+	class SKYLICHT_API CCompressedAnimationData
+	{
+	public:
+		// the key of this track at frame 0
+		const SCompressedKey* Keys;
+
+		// number of keys per frame (NumTrack of the clip)
+		int Stride;
+
+		int NumFrame;
+
+		// second
+		float Duration;
+
+		float InvFrameStep;
+
+		core::vector3df PositionMin;
+		core::vector3df PositionStep;
+
+		core::vector3df ScaleMin;
+		core::vector3df ScaleStep;
+
+	public:
+		CCompressedAnimationData();
+
+		void sample(f32 frame,
+			core::vector3df& position,
+			core::vector3df& scale,
+			core::quaternion& rotation) const;
+
+		static void encodeRotation(const core::quaternion& q, u16* result);
+
+		static void decodeRotation(const u16* data, core::quaternion& q);
+	};
+}
@@ -0,0 +1,483 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CCullingBVH.h"
+
+namespace Skylicht
+{
+	CCullingBVH::CCullingBVH() :
+		m_root(-1),
+		m_freeList(-1),
+		m_numLeaf(0),
+		m_margin(0.1f)
+	{
+
+	}
+
+	CCullingBVH::~CCullingBVH()
+	{
+
+	}
+
+	void CCullingBVH::clear()
+	{
+		m_nodes.set_used(0);
+		m_root = -1;
+		m_freeList = -1;
+		m_numLeaf = 0;
+	}
+
+	int CCullingBVH::allocNode()
+	{
+		if (m_freeList == -1)
+		{
+			SNode node;
+			node.Parent = -1;
+			m_nodes.push_back(node);
+			m_freeList = (int)m_nodes.size() - 1;
+		}
+
+		// the free list is linked by Parent
+		int id = m_freeList;
+		SNode& node = m_nodes[id];
+		m_freeList = node.Parent;
+
+		node.Parent = -1;
+		node.Child1 = -1;
+		node.Child2 = -1;
+		node.Height = 0;
+		node.UserData = NULL;
+		return id;
+	}
+
+	void CCullingBVH::freeNode(int id)
+	{
+		SNode& node = m_nodes[id];
+		node.Parent = m_freeList;
+		node.Height = -1;
+		m_freeList = id;
+	}
+
+	int CCullingBVH::insert(const core::aabbox3df& box, void* userData)
+	{
+		int proxy = allocNode();
+
+		SNode& node = m_nodes[proxy];
+		node.Box = box;
+		node.UserData = userData;
+
+		core::vector3df margin = box.getExtent() * m_margin;
+		node.Box.MinEdge -= margin;
+		node.Box.MaxEdge += margin;
+
+		insertLeaf(proxy);
+		m_numLeaf++;
+		return proxy;
+	}
+
+	void CCullingBVH::remove(int proxy)
+	{
+		removeLeaf(proxy);
+		freeNode(proxy);
+		m_numLeaf--;
+	}
+
+	bool CCullingBVH::update(int proxy, const core::aabbox3df& box)
+	{
+		SNode& node = m_nodes[proxy];
+		if (box.isFullInside(node.Box))
+			return false;
+
+		removeLeaf(proxy);
+
+		// note: removeLeaf does not change the leaf node
+		SNode& leaf = m_nodes[proxy];
+		leaf.Box = box;
+
+		core::vector3df margin = box.getExtent() * m_margin;
+		leaf.Box.MinEdge -= margin;
+		leaf.Box.MaxEdge += margin;
+
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void CCullingBVH::insertLeaf(int leaf)
+	{
+		if (m_root == -1)
+		{
+			m_root = leaf;
+			m_nodes[leaf].Parent = -1;
+			return;
+		}
+
+		// find the best sibling, that have the least surface area cost
+		core::aabbox3df leafBox = m_nodes[leaf].Box;
+		int index = m_root;
+
+		while (!m_nodes[index].isLeaf())
+		{
+			const SNode& node = m_nodes[index];
+			int child1 = node.Child1;
+			int child2 = node.Child2;
+
+			float area = node.Box.getArea();
+
+			core::aabbox3df combined = node.Box;
+			combined.addInternalBox(leafBox);
+			float combinedArea = combined.getArea();
+
+			// cost of creating a new parent for this node and the new leaf
+			float cost = 2.0f * combinedArea;
+
+			// minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float cost1, cost2;
+
+			core::aabbox3df box1 = m_nodes[child1].Box;
+			box1.addInternalBox(leafBox);
+			if (m_nodes[child1].isLeaf())
+				cost1 = box1.getArea() + inheritanceCost;
+			else
+				cost1 = (box1.getArea() - m_nodes[child1].Box.getArea()) + inheritanceCost;
+
+			core::aabbox3df box2 = m_nodes[child2].Box;
+			box2.addInternalBox(leafBox);
+			if (m_nodes[child2].isLeaf())
+				cost2 = box2.getArea() + inheritanceCost;
+			else
+				cost2 = (box2.getArea() - m_nodes[child2].Box.getArea()) + inheritanceCost;
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = cost1 < cost2 ? child1 : child2;
+		}
+
+		int sibling = index;
+
+		// create a new parent
+		int oldParent = m_nodes[sibling].Parent;
+		int newParent = allocNode();
+
+		SNode& parent = m_nodes[newParent];
+		parent.Parent = oldParent;
+		parent.UserData = NULL;
+		parent.Box = leafBox;
+		parent.Box.addInternalBox(m_nodes[sibling].Box);
+		parent.Height = m_nodes[sibling].Height + 1;
+		parent.Child1 = sibling;
+		parent.Child2 = leaf;
+
+		if (oldParent != -1)
+		{
+			if (m_nodes[oldParent].Child1 == sibling)
+				m_nodes[oldParent].Child1 = newParent;
+			else
+				m_nodes[oldParent].Child2 = newParent;
+		}
+		else
+		{
+			m_root = newParent;
+		}
+
+		m_nodes[sibling].Parent = newParent;
+		m_nodes[leaf].Parent = newParent;
+
+		// walk back up the tree fixing heights and boxes
+		fixUpward(m_nodes[leaf].Parent);
+	}
+
+	void CCullingBVH::removeLeaf(int leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = -1;
+			return;
+		}
+
+		int parent = m_nodes[leaf].Parent;
+		int grandParent = m_nodes[parent].Parent;
+		int sibling = m_nodes[parent].Child1 == leaf ? m_nodes[parent].Child2 : m_nodes[parent].Child1;
+
+		if (grandParent != -1)
+		{
+			// destroy parent and connect sibling to grandParent
+			if (m_nodes[grandParent].Child1 == parent)
+				m_nodes[grandParent].Child1 = sibling;
+			else
+				m_nodes[grandParent].Child2 = sibling;
+
+			m_nodes[sibling].Parent = grandParent;
+			freeNode(parent);
+
+			fixUpward(grandParent);
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].Parent = -1;
+			freeNode(parent);
+		}
+	}
+
+	void CCullingBVH::fixUpward(int index)
+	{
+		while (index != -1)
+		{
+			index = balance(index);
+
+			SNode& node = m_nodes[index];
+			const SNode& child1 = m_nodes[node.Child1];
+			const SNode& child2 = m_nodes[node.Child2];
+
+			node.Height = 1 + core::max_(child1.Height, child2.Height);
+			node.Box = child1.Box;
+			node.Box.addInternalBox(child2.Box);
+
+			index = node.Parent;
+		}
+	}
+
+	int CCullingBVH::balance(int iA)
+	{
+		// perform a left or right rotation if node A is imbalanced
+		SNode* A = &m_nodes[iA];
+		if (A->isLeaf() || A->Height < 2)
+			return iA;
+
+		int iB = A->Child1;
+		int iC = A->Child2;
+		SNode* B = &m_nodes[iB];
+		SNode* C = &m_nodes[iC];
+
+		int balance = C->Height - B->Height;
+
+		if (balance > 1)
+		{
+			// rotate C up
+			int iF = C->Child1;
+			int iG = C->Child2;
+			SNode* F = &m_nodes[iF];
+			SNode* G = &m_nodes[iG];
+
+			// swap A and C
+			C->Child1 = iA;
+			C->Parent = A->Parent;
+			A->Parent = iC;
+
+			// A's old parent should point to C
+			if (C->Parent != -1)
+			{
+				if (m_nodes[C->Parent].Child1 == iA)
+					m_nodes[C->Parent].Child1 = iC;
+				else
+					m_nodes[C->Parent].Child2 = iC;
+			}
+			else
+			{
+				m_root = iC;
+			}
+
+			// rotate
+			if (F->Height > G->Height)
+			{
+				C->Child2 = iF;
+				A->Child2 = iG;
+				G->Parent = iA;
+
+				A->Box = B->Box;
+				A->Box.addInternalBox(G->Box);
+				C->Box = A->Box;
+				C->Box.addInternalBox(F->Box);
+
+				A->Height = 1 + core::max_(B->Height, G->Height);
+				C->Height = 1 + core::max_(A->Height, F->Height);
+			}
+			else
+			{
+				C->Child2 = iG;
+				A->Child2 = iF;
+				F->Parent = iA;
+
+				A->Box = B->Box;
+				A->Box.addInternalBox(F->Box);
+				C->Box = A->Box;
+				C->Box.addInternalBox(G->Box);
+
+				A->Height = 1 + core::max_(B->Height, F->Height);
+				C->Height = 1 + core::max_(A->Height, G->Height);
+			}
+
+			return iC;
+		}
+
+		if (balance < -1)
+		{
+			// rotate B up
+			int iD = B->Child1;
+			int iE = B->Child2;
+			SNode* D = &m_nodes[iD];
+			SNode* E = &m_nodes[iE];
+
+			// swap A and B
+			B->Child1 = iA;
+			B->Parent = A->Parent;
+			A->Parent = iB;
+
+			// A's old parent should point to B
+			if (B->Parent != -1)
+			{
+				if (m_nodes[B->Parent].Child1 == iA)
+					m_nodes[B->Parent].Child1 = iB;
+				else
+					m_nodes[B->Parent].Child2 = iB;
+			}
+			else
+			{
+				m_root = iB;
+			}
+
+			// rotate
+			if (D->Height > E->Height)
+			{
+				B->Child2 = iD;
+				A->Child1 = iE;
+				E->Parent = iA;
+
+				A->Box = C->Box;
+				A->Box.addInternalBox(E->Box);
+				B->Box = A->Box;
+				B->Box.addInternalBox(D->Box);
+
+				A->Height = 1 + core::max_(C->Height, E->Height);
+				B->Height = 1 + core::max_(A->Height, D->Height);
+			}
+			else
+			{
+				B->Child2 = iE;
+				A->Child1 = iD;
+				D->Parent = iA;
+
+				A->Box = C->Box;
+				A->Box.addInternalBox(D->Box);
+				B->Box = A->Box;
+				B->Box.addInternalBox(E->Box);
+
+				A->Height = 1 + core::max_(C->Height, D->Height);
+				B->Height = 1 + core::max_(A->Height, E->Height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	int CCullingBVH::getHeight()
+	{
+		if (m_root == -1)
+			return 0;
+		return m_nodes[m_root].Height;
+	}
+
+	void CCullingBVH::query(const core::aabbox3df& box, CFastArray<int>& inside, CFastArray<int>& intersect)
+	{
+		inside.reset();
+		intersect.reset();
+
+		if (m_root == -1)
+			return;
+
+		m_stack.set_used(0);
+		m_stack.push_back(m_root);
+
+		SNode* nodes = m_nodes.pointer();
+
+		while (m_stack.size() > 0)
+		{
+			int index = m_stack.getLast();
+			m_stack.set_used(m_stack.size() - 1);
+
+			const SNode& node = nodes[index];
+
+			// reject the whole subtree
+			if (!node.Box.intersectsWithBox(box))
+				continue;
+
+			if (node.isLeaf())
+			{
+				intersect.push(index);
+			}
+			else if (node.Box.isFullInside(box))
+			{
+				// accept the whole subtree
+				collectLeaves(index, inside);
+			}
+			else
+			{
+				m_stack.push_back(node.Child1);
+				m_stack.push_back(node.Child2);
+			}
+		}
+	}
+
+	void CCullingBVH::getLeaves(CFastArray<int>& leaves)
+	{
+		leaves.reset();
+
+		if (m_root == -1)
+			return;
+
+		m_stack.set_used(0);
+		collectLeaves(m_root, leaves);
+	}
+
+	void CCullingBVH::collectLeaves(int index, CFastArray<int>& result)
+	{
+		SNode* nodes = m_nodes.pointer();
+
+		u32 begin = m_stack.size();
+		m_stack.push_back(index);
+
+		while (m_stack.size() > begin)
+		{
+			int i = m_stack.getLast();
+			m_stack.set_used(m_stack.size() - 1);
+
+			const SNode& node = nodes[i];
+			if (node.isLeaf())
+			{
+				result.push(i);
+			}
+			else
+			{
+				m_stack.push_back(node.Child1);
+				m_stack.push_back(node.Child2);
+			}
+		}
+	}
+}
@@ -0,0 +1,143 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Entity/CArrayUtils.h"
+
+namespace Skylicht
+{
+	/// @brief The dynamic bounding volume hierarchy, that is used to accept or reject the whole subtree of boxes in the culling.
+	///
+	/// Each leaf stores a fat box (the box is enlarged by a margin), so the small moving of object does not need update the tree.
+	/// The tree is balanced by the tree rotations on insert and remove.
+	///
+	/// @code
+	/// CCullingBVH* bvh = new CCullingBVH();
+	/// int proxy = bvh->insert(box, cullingData);
+	/// bvh->update(proxy, newBox);
+	/// bvh->query(cameraBox, inside, intersect);
+	/// @endcode
+	class SKYLICHT_API CCullingBVH
+	{
+	public:
+		struct SNode
+		{
+			core::aabbox3df Box;
+
+			int Parent;
+
+			int Child1;
+
+			int Child2;
+
+			// leaf = 0, free node = -1
+			int Height;
+
+			void* UserData;
+
+			inline bool isLeaf() const
+			{
+				return Child1 == -1;
+			}
+		};
+
+	protected:
+		core::array<SNode> m_nodes;
+
+		int m_root;
+
+		int m_freeList;
+
+		int m_numLeaf;
+
+		float m_margin;
+
+		core::array<int> m_stack;
+
+	public:
+		CCullingBVH();
+
+		virtual ~CCullingBVH();
+
+		/// @brief Insert a box to the tree
+		/// @return the proxy (leaf node id)
+		int insert(const core::aabbox3df& box, void* userData);
+
+		void remove(int proxy);
+
+		/// @brief Update the box of proxy, the tree only changes when the box is out of the fat box
+		/// @return true if the proxy is re-inserted
+		bool update(int proxy, const core::aabbox3df& box);
+
+		/// @brief Query the leaves that intersect with the box
+		/// @param inside the leaves, that their subtree is fully inside the box (don't need test again)
+		/// @param intersect the leaves, that the fat box intersects the box (need test the real box)
+		void query(const core::aabbox3df& box, CFastArray<int>& inside, CFastArray<int>& intersect);
+
+		/// @brief Get all leaves of the tree
+		void getLeaves(CFastArray<int>& leaves);
+
+		void clear();
+
+		inline void* getUserData(int proxy)
+		{
+			return m_nodes[proxy].UserData;
+		}
+
+		inline const core::aabbox3df& getFatBox(int proxy)
+		{
+			return m_nodes[proxy].Box;
+		}
+
+		inline int getNumLeaf()
+		{
+			return m_numLeaf;
+		}
+
+		int getHeight();
+
+		/// @brief The margin (ratio of the box size) to enlarge the fat box
+		inline void setMargin(float margin)
+		{
+			m_margin = margin;
+		}
+
+	protected:
+
+		int allocNode();
+
+		void freeNode(int node);
+
+		void insertLeaf(int leaf);
+
+		void removeLeaf(int leaf);
+
+		int balance(int node);
+
+		void fixUpward(int node);
+
+		void collectLeaves(int node, CFastArray<int>& result);
+	};
+}
@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CCullingData.h"
+#include "CCullingBVH.h"
 
 namespace Skylicht
 {
@@ -36,14 +37,19 @@ namespace Skylicht
 		Visible(true),
 		Occlusion(false),
 		ShadowCasting(true),
-		NeedValidate(true)
+		NeedValidate(true),
+		BVH(NULL),
+		BVHProxy(-1),
+		BVHEntry(-1),
+		ViewMask(0)
 	{
 
 	}
 
 	CCullingData::~CCullingData()
 	{
-
+		if (BVH)
+			BVH->remove(BVHProxy);
 	}
 
 	bool CCullingData::serializable(CMemoryStream* stream)
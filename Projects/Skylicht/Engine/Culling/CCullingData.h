@@ -28,6 +28,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	class CCullingBVH;
+
 	class SKYLICHT_API CCullingData : public IEntityData
 	{
 	public:
@@ -53,6 +55,17 @@ namespace Skylicht
 
 		bool NeedValidate;
 
+		// the leaf of BBox on the culling tree (see CCullingSystem)
+		CCullingBVH* BVH;
+
+		int BVHProxy;
+
+		// index on the culling list of this frame, -1 if it is not culled at this frame
+		int BVHEntry;
+
+		// bit i is set if the bbox is visible on the view i (see CCullingSystem::addView)
+		u32 ViewMask;
+
 	public:
 		CCullingData();
 
@@ -0,0 +1,356 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CCullingKernel.h"
+
+#if defined(SKYLICHT_SSE)
+#include <emmintrin.h>
+#elif defined(SKYLICHT_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Skylicht
+{
+#if defined(SKYLICHT_SSE)
+	typedef __m128 float4;
+	typedef __m128 mask4;
+
+	static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+	static inline float4 set4(float f) { return _mm_set1_ps(f); }
+	static inline void store4(float* p, float4 a) { _mm_storeu_ps(p, a); }
+	static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+	static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+	static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+	static inline float4 madd4(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static inline float4 abs4(float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static inline mask4 le4(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+	static inline mask4 and4(mask4 a, mask4 b) { return _mm_and_ps(a, b); }
+	static inline mask4 true4() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+	static inline int movemask4(mask4 a) { return _mm_movemask_ps(a); }
+#elif defined(SKYLICHT_NEON)
+	typedef float32x4_t float4;
+	typedef uint32x4_t mask4;
+
+	static inline float4 load4(const float* p) { return vld1q_f32(p); }
+	static inline float4 set4(float f) { return vdupq_n_f32(f); }
+	static inline void store4(float* p, float4 a) { vst1q_f32(p, a); }
+	static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+	static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+	static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+	static inline float4 madd4(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+	static inline float4 abs4(float4 a) { return vabsq_f32(a); }
+	static inline mask4 le4(float4 a, float4 b) { return vcleq_f32(a, b); }
+	static inline mask4 and4(mask4 a, mask4 b) { return vandq_u32(a, b); }
+	static inline mask4 true4() { return vdupq_n_u32(0xffffffff); }
+	static inline int movemask4(mask4 a)
+	{
+		return (vgetq_lane_u32(a, 0) & 1) |
+			(vgetq_lane_u32(a, 1) & 2) |
+			(vgetq_lane_u32(a, 2) & 4) |
+			(vgetq_lane_u32(a, 3) & 8);
+	}
+#endif
+
+	CCullingKernel::CCullingKernel() :
+		m_count(0),
+		m_capacity(0)
+	{
+		grow();
+	}
+
+	CCullingKernel::~CCullingKernel()
+	{
+
+	}
+
+	void CCullingKernel::reset()
+	{
+		m_count = 0;
+	}
+
+	void CCullingKernel::grow()
+	{
+		m_capacity = m_capacity < 32 ? 32 : m_capacity * 2;
+
+		for (int i = 0; i < 3; i++)
+		{
+			m_center[i].set_used(m_capacity);
+			m_extent[i].set_used(m_capacity);
+			m_c[i] = m_center[i].pointer();
+			m_e[i] = m_extent[i].pointer();
+		}
+
+		for (int i = 0; i < 12; i++)
+		{
+			m_matrix[i].set_used(m_capacity);
+			m_m[i] = m_matrix[i].pointer();
+		}
+
+		m_result.set_used(m_capacity);
+	}
+
+	int CCullingKernel::addBox(const core::aabbox3df& box)
+	{
+		if (m_count >= m_capacity)
+			grow();
+
+		int i = m_count++;
+
+		m_c[0][i] = (box.MinEdge.X + box.MaxEdge.X) * 0.5f;
+		m_c[1][i] = (box.MinEdge.Y + box.MaxEdge.Y) * 0.5f;
+		m_c[2][i] = (box.MinEdge.Z + box.MaxEdge.Z) * 0.5f;
+
+		m_e[0][i] = (box.MaxEdge.X - box.MinEdge.X) * 0.5f;
+		m_e[1][i] = (box.MaxEdge.Y - box.MinEdge.Y) * 0.5f;
+		m_e[2][i] = (box.MaxEdge.Z - box.MinEdge.Z) * 0.5f;
+
+		m_result[i] = 1;
+		return i;
+	}
+
+	int CCullingKernel::addBox(const core::aabbox3df& box, const core::matrix4& world)
+	{
+		int i = addBox(box);
+
+		// see core::matrix4::transformVect
+		const f32* m = world.pointer();
+		m_m[0][i] = m[0];
+		m_m[1][i] = m[1];
+		m_m[2][i] = m[2];
+		m_m[3][i] = m[4];
+		m_m[4][i] = m[5];
+		m_m[5][i] = m[6];
+		m_m[6][i] = m[8];
+		m_m[7][i] = m[9];
+		m_m[8][i] = m[10];
+		m_m[9][i] = m[12];
+		m_m[10][i] = m[13];
+		m_m[11][i] = m[14];
+
+		return i;
+	}
+
+	void CCullingKernel::transformBoxes()
+	{
+		float* cx = m_c[0];
+		float* cy = m_c[1];
+		float* cz = m_c[2];
+		float* ex = m_e[0];
+		float* ey = m_e[1];
+		float* ez = m_e[2];
+		float** m = m_m;
+
+		int i = 0;
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+		for (; i + 4 <= m_count; i += 4)
+		{
+			float4 x = load4(cx + i);
+			float4 y = load4(cy + i);
+			float4 z = load4(cz + i);
+			float4 sx = load4(ex + i);
+			float4 sy = load4(ey + i);
+			float4 sz = load4(ez + i);
+
+			float4 m0 = load4(m[0] + i), m1 = load4(m[1] + i), m2 = load4(m[2] + i);
+			float4 m4 = load4(m[3] + i), m5 = load4(m[4] + i), m6 = load4(m[5] + i);
+			float4 m8 = load4(m[6] + i), m9 = load4(m[7] + i), m10 = load4(m[8] + i);
+
+			// center = M * center
+			store4(cx + i, madd4(x, m0, madd4(y, m4, madd4(z, m8, load4(m[9] + i)))));
+			store4(cy + i, madd4(x, m1, madd4(y, m5, madd4(z, m9, load4(m[10] + i)))));
+			store4(cz + i, madd4(x, m2, madd4(y, m6, madd4(z, m10, load4(m[11] + i)))));
+
+			// extent = |M| * extent
+			store4(ex + i, madd4(sx, abs4(m0), madd4(sy, abs4(m4), mul4(sz, abs4(m8)))));
+			store4(ey + i, madd4(sx, abs4(m1), madd4(sy, abs4(m5), mul4(sz, abs4(m9)))));
+			store4(ez + i, madd4(sx, abs4(m2), madd4(sy, abs4(m6), mul4(sz, abs4(m10)))));
+		}
+#endif
+
+		for (; i < m_count; i++)
+		{
+			float x = cx[i], y = cy[i], z = cz[i];
+			float sx = ex[i], sy = ey[i], sz = ez[i];
+
+			cx[i] = x * m[0][i] + y * m[3][i] + z * m[6][i] + m[9][i];
+			cy[i] = x * m[1][i] + y * m[4][i] + z * m[7][i] + m[10][i];
+			cz[i] = x * m[2][i] + y * m[5][i] + z * m[8][i] + m[11][i];
+
+			ex[i] = sx * fabsf(m[0][i]) + sy * fabsf(m[3][i]) + sz * fabsf(m[6][i]);
+			ey[i] = sx * fabsf(m[1][i]) + sy * fabsf(m[4][i]) + sz * fabsf(m[7][i]);
+			ez[i] = sx * fabsf(m[2][i]) + sy * fabsf(m[5][i]) + sz * fabsf(m[8][i]);
+		}
+	}
+
+	void CCullingKernel::intersectBox(const core::aabbox3df& box)
+	{
+		float** c = m_c;
+		float** e = m_e;
+		const float boxMin[3] = { box.MinEdge.X, box.MinEdge.Y, box.MinEdge.Z };
+		const float boxMax[3] = { box.MaxEdge.X, box.MaxEdge.Y, box.MaxEdge.Z };
+
+		u8* result = m_result.pointer();
+
+		int i = 0;
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+		float4 bmin[3], bmax[3];
+		for (int a = 0; a < 3; a++)
+		{
+			bmin[a] = set4(boxMin[a]);
+			bmax[a] = set4(boxMax[a]);
+		}
+
+		for (; i + 4 <= m_count; i += 4)
+		{
+			mask4 inside = true4();
+
+			for (int a = 0; a < 3; a++)
+			{
+				float4 center = load4(c[a] + i);
+				float4 extent = load4(e[a] + i);
+
+				// min <= boxMax && boxMin <= max
+				inside = and4(inside, le4(sub4(center, extent), bmax[a]));
+				inside = and4(inside, le4(bmin[a], add4(center, extent)));
+			}
+
+			int mask = movemask4(inside);
+			result[i] = mask & 1;
+			result[i + 1] = (mask >> 1) & 1;
+			result[i + 2] = (mask >> 2) & 1;
+			result[i + 3] = (mask >> 3) & 1;
+		}
+#endif
+
+		for (; i < m_count; i++)
+		{
+			u8 inside = 1;
+			for (int a = 0; a < 3; a++)
+			{
+				if (c[a][i] - e[a][i] > boxMax[a] || c[a][i] + e[a][i] < boxMin[a])
+				{
+					inside = 0;
+					break;
+				}
+			}
+			result[i] = inside;
+		}
+	}
+
+	void CCullingKernel::intersectFrustum(const SViewFrustum& frustum)
+	{
+		const float* cx = m_c[0];
+		const float* cy = m_c[1];
+		const float* cz = m_c[2];
+		const float* ex = m_e[0];
+		const float* ey = m_e[1];
+		const float* ez = m_e[2];
+
+		u8* result = m_result.pointer();
+
+		int i = 0;
+
+		// the normal of frustum planes point to outside
+		// the box is outside if: dot(n, center) + d - dot(|n|, extent) > epsilon (see plane3df::classifyPointRelation)
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+		float4 nx[SViewFrustum::VF_PLANE_COUNT], ny[SViewFrustum::VF_PLANE_COUNT], nz[SViewFrustum::VF_PLANE_COUNT];
+		float4 ax[SViewFrustum::VF_PLANE_COUNT], ay[SViewFrustum::VF_PLANE_COUNT], az[SViewFrustum::VF_PLANE_COUNT];
+		float4 d[SViewFrustum::VF_PLANE_COUNT];
+
+		for (int p = 0; p < SViewFrustum::VF_PLANE_COUNT; p++)
+		{
+			const core::plane3df& plane = frustum.planes[p];
+			nx[p] = set4(plane.Normal.X);
+			ny[p] = set4(plane.Normal.Y);
+			nz[p] = set4(plane.Normal.Z);
+			ax[p] = set4(fabsf(plane.Normal.X));
+			ay[p] = set4(fabsf(plane.Normal.Y));
+			az[p] = set4(fabsf(plane.Normal.Z));
+			d[p] = set4(plane.D - core::ROUNDING_ERROR_f32);
+		}
+
+		for (; i + 4 <= m_count; i += 4)
+		{
+			// the 4 boxes are rejected by the last test
+			if ((result[i] | result[i + 1] | result[i + 2] | result[i + 3]) == 0)
+				continue;
+
+			float4 x = load4(cx + i);
+			float4 y = load4(cy + i);
+			float4 z = load4(cz + i);
+			float4 sx = load4(ex + i);
+			float4 sy = load4(ey + i);
+			float4 sz = load4(ez + i);
+
+			mask4 inside = true4();
+
+			for (int p = 0; p < SViewFrustum::VF_PLANE_COUNT; p++)
+			{
+				float4 dist = madd4(x, nx[p], madd4(y, ny[p], madd4(z, nz[p], d[p])));
+				float4 radius = madd4(sx, ax[p], madd4(sy, ay[p], mul4(sz, az[p])));
+				inside = and4(inside, le4(dist, radius));
+			}
+
+			int mask = movemask4(inside);
+			result[i] &= mask & 1;
+			result[i + 1] &= (mask >> 1) & 1;
+			result[i + 2] &= (mask >> 2) & 1;
+			result[i + 3] &= (mask >> 3) & 1;
+		}
+#endif
+
+		for (; i < m_count; i++)
+		{
+			if (result[i] == 0)
+				continue;
+
+			for (int p = 0; p < SViewFrustum::VF_PLANE_COUNT; p++)
+			{
+				const core::plane3df& plane = frustum.planes[p];
+
+				float dist = plane.Normal.X * cx[i] + plane.Normal.Y * cy[i] + plane.Normal.Z * cz[i] + plane.D;
+				float radius = fabsf(plane.Normal.X) * ex[i] + fabsf(plane.Normal.Y) * ey[i] + fabsf(plane.Normal.Z) * ez[i];
+
+				if (dist - radius > core::ROUNDING_ERROR_f32)
+				{
+					result[i] = 0;
+					break;
+				}
+			}
+		}
+	}
+
+	void CCullingKernel::getBox(int i, core::aabbox3df& box)
+	{
+		core::vector3df center(m_c[0][i], m_c[1][i], m_c[2][i]);
+		core::vector3df extent(m_e[0][i], m_e[1][i], m_e[2][i]);
+
+		box.MinEdge = center - extent;
+		box.MaxEdge = center + extent;
+	}
+}
@@ -0,0 +1,102 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	/// @brief The batched culling tests on SoA (structure of arrays) bounding boxes.
+	///
+	/// The boxes are stored in the center/extent form, the tests run 4 boxes at once with SSE or NEON (see SKYLICHT_SSE, SKYLICHT_NEON), and have the scalar version for other platforms.
+	///
+	/// @code
+	/// CCullingKernel kernel;
+	/// kernel.addBox(localBox, worldMatrix);
+	/// kernel.transformBoxes();
+	/// kernel.intersectBox(cameraBox);
+	/// kernel.intersectFrustum(camera->getViewFrustum());
+	/// u8* visible = kernel.getResult();
+	/// @endcode
+	class SKYLICHT_API CCullingKernel
+	{
+	protected:
+		core::array<float> m_center[3];
+
+		core::array<float> m_extent[3];
+
+		// the world matrix (without projection row) of the boxes, all boxes must be added by addBox(box, matrix) before transformBoxes
+		core::array<float> m_matrix[12];
+
+		core::array<u8> m_result;
+
+		float* m_c[3];
+
+		float* m_e[3];
+
+		float* m_m[12];
+
+		int m_count;
+
+		int m_capacity;
+
+	public:
+		CCullingKernel();
+
+		virtual ~CCullingKernel();
+
+		void reset();
+
+		/// @brief Add a world box
+		/// @return index of the box
+		int addBox(const core::aabbox3df& box);
+
+		/// @brief Add a local box and its world matrix, the world box is computed by transformBoxes
+		int addBox(const core::aabbox3df& box, const core::matrix4& world);
+
+		/// @brief Transform all local boxes to world boxes (the same result as core::matrix4::transformBoxEx)
+		void transformBoxes();
+
+		/// @brief Test the boxes intersect with a box, the result will be reset
+		void intersectBox(const core::aabbox3df& box);
+
+		/// @brief Test the boxes with the 6 planes of frustum, the result is combined with the last test
+		void intersectFrustum(const SViewFrustum& frustum);
+
+		void getBox(int i, core::aabbox3df& box);
+
+		inline u8* getResult()
+		{
+			return m_result.pointer();
+		}
+
+		inline int getCount()
+		{
+			return m_count;
+		}
+
+	protected:
+
+		void grow();
+	};
+}
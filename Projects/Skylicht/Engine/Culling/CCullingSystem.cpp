@@ -25,6 +25,8 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CCullingSystem.h"
 #include "CCullingBBoxData.h"
+#include "CCullingBVH.h"
+#include "CCullingKernel.h"
 #include "Entity/CEntityManager.h"
 #include "RenderPipeline/IRenderPipeline.h"
 #include "Camera/CCamera.h"
@@ -34,6 +36,7 @@ https://github.com/skylicht-lab/skylicht-engine
 namespace Skylicht
 {
 	bool g_useCacheCulling = false;
+	bool g_useCullingBVH = true;
 
 	void CCullingSystem::useCacheCulling(bool b)
 	{
@@ -45,15 +48,40 @@ namespace Skylicht
 		return g_useCacheCulling;
 	}
 
+	void CCullingSystem::useCullingBVH(bool b)
+	{
+		g_useCullingBVH = b;
+	}
+
+	bool CCullingSystem::useCullingBVH()
+	{
+		return g_useCullingBVH;
+	}
+
 	CCullingSystem::CCullingSystem() :
-		m_group(NULL)
+		m_group(NULL),
+		m_currentView(-1),
+		m_viewsCulled(false)
 	{
 		m_pipelineType = IRenderPipeline::Mix;
+		m_cullingDependent = true;
+		m_bvh = new CCullingBVH();
 	}
 
 	CCullingSystem::~CCullingSystem()
 	{
+		// unlink the culling data that still on the tree
+		m_bvh->getLeaves(m_inside);
 
+		int* leaves = m_inside.pointer();
+		for (int i = 0, n = m_inside.count(); i < n; i++)
+		{
+			CCullingData* culling = (CCullingData*)m_bvh->getUserData(leaves[i]);
+			culling->BVH = NULL;
+			culling->BVHProxy = -1;
+		}
+
+		delete m_bvh;
 	}
 
 	void CCullingSystem::beginQuery(CEntityManager* entityManager)
@@ -70,10 +98,15 @@ namespace Skylicht
 		if (g_useCacheCulling)
 			return;
 
+		// the views are culled on the first pass, keep the list for the next views
+		if (m_currentView >= 0 && m_viewsCulled)
+			return;
+
 		entities = m_group->getEntities();
 		numEntity = m_group->getEntityCount();
 
 		m_bboxAndMaterials.reset();
+		m_dirtyEntries.reset();
 
 		CEntity* entity;
 		CCullingData* culling;
@@ -96,6 +129,10 @@ namespace Skylicht
 			culling->CullingLayer = visible->CullingLayer;
 			culling->ShadowCasting = visible->ShadowCasting;
 
+			// the entity is on the list of the last query
+			bool inList = culling->BVHEntry >= 0;
+			culling->BVHEntry = -1;
+
 			if (visible->Culled || !visible->Visible)
 			{
 				culling->Visible = false;
@@ -116,6 +153,7 @@ namespace Skylicht
 					m->Materials = &mesh->getMaterials();
 
 					m->Culling->NeedValidate |= transform->NeedValidate;
+					m->Culling->BVHEntry = m_bboxAndMaterials.count() - 1;
 				}
 				else
 				{
@@ -130,10 +168,25 @@ namespace Skylicht
 						m->Materials = &bbox->Materials;
 
 						m->Culling->NeedValidate |= (bbox->NeedValidate || transform->NeedValidate);
+						m->Culling->BVHEntry = m_bboxAndMaterials.count() - 1;
 						bbox->NeedValidate = false;
 					}
 				}
 			}
+
+			if (culling->BVHEntry >= 0)
+			{
+				// the new entry is culled until it is tested
+				if (!inList)
+				{
+					culling->Visible = false;
+					culling->CameraCulled = true;
+				}
+
+				// only update the bbox that its transform changed
+				if (culling->NeedValidate || (culling->BVH != m_bvh && g_useCullingBVH))
+					m_dirtyEntries.push(culling->BVHEntry);
+			}
 		}
 	}
 
@@ -148,143 +201,452 @@ namespace Skylicht
 		if (rp == NULL)
 			return;
 
-		core::matrix4 invTrans;
+		if (g_useCacheCulling)
+		{
+			updateCache(rp);
+			return;
+		}
+
+		if (m_currentView >= 0)
+		{
+			if (!m_viewsCulled)
+				updateViews();
+
+			applyView(rp);
+			return;
+		}
 
 		// camera
 		CCamera* camera = entityManager->getCamera();
 		const core::aabbox3df& cameraBox = camera->getViewFrustum().getBoundingBox();
 
+		// the box to test, and the camera frustum planes are not tested on shadow pass
+		const core::aabbox3df* box = &cameraBox;
+
+		bool shadowPass = false;
+		if (rp->getType() == IRenderPipeline::ShadowMap)
+		{
+			CShadowMapRP* shadowMapRP = (CShadowMapRP*)rp;
+			if (shadowMapRP->getRenderShadowState() == CShadowMapRP::DirectionLight)
+				box = &shadowMapRP->getFrustumBox();
+
+			shadowPass = true;
+		}
+
+		if (!g_useCullingBVH)
+		{
+			updateLinear(rp, camera, *box, shadowPass);
+			return;
+		}
+
+		SBBoxAndMaterial* bbBoxMats = m_bboxAndMaterials.pointer();
+		SBBoxAndMaterial* bbBoxMat;
+		CCullingData* culling;
+
+		// 1. Update the bbox on the tree, the entities that are not reported by the tree are culled
+		// so only clear the entities that are not culled by the last update
+		clearVisible();
+		updateDirtyBBoxes();
+
+		// 2. Walk the tree, accept or reject the whole subtree
+		m_bvh->query(*box, m_inside, m_intersect);
+
+		// 3. Test the reported boxes in batch
+		m_testKernel.reset();
+		m_testEntries.reset();
+
+		CFastArray<int>* leaves[] = { &m_inside, &m_intersect };
+		for (int l = 0; l < 2; l++)
+		{
+			int* leaf = leaves[l]->pointer();
+			for (int i = 0, n = leaves[l]->count(); i < n; i++)
+			{
+				culling = (CCullingData*)m_bvh->getUserData(leaf[i]);
+				if (culling->BVHEntry < 0)
+					continue;
+
+				// the leaf is a fat box, need test again the real box
+				m_testKernel.addBox(culling->BBox);
+				m_testEntries.push(&bbBoxMats[culling->BVHEntry]);
+			}
+		}
+
+		m_testKernel.intersectBox(*box);
+		if (!shadowPass)
+			m_testKernel.intersectFrustum(camera->getViewFrustum());
+
+		u8* result = m_testKernel.getResult();
+		SBBoxAndMaterial** entries = m_testEntries.pointer();
+
+		for (int i = 0, n = m_testEntries.count(); i < n; i++)
+		{
+			if (result[i] == 0)
+				continue;
+
+			bbBoxMat = entries[i];
+			culling = bbBoxMat->Culling;
+
+			culling->CameraCulled = false;
+			culling->Visible = canRender(bbBoxMat, rp);
+
+			if (culling->Visible && !shadowPass && !testFrustum(bbBoxMat, camera->getViewFrustum()))
+			{
+				culling->CameraCulled = true;
+				culling->Visible = false;
+			}
+
+			if (!culling->CameraCulled)
+				m_visibleEntities.push(bbBoxMat->Entity);
+		}
+	}
+
+	void CCullingSystem::updateCache(IRenderPipeline* rp)
+	{
+		int count = m_bboxAndMaterials.count();
+		SBBoxAndMaterial* bbBoxMats = m_bboxAndMaterials.pointer();
+
+		for (int i = 0; i < count; i++)
+		{
+			CCullingData* culling = bbBoxMats[i].Culling;
+
+			// if we have the last test result
+			if (culling->CameraCulled == true)
+				continue;
+
+			culling->Visible = canRender(&bbBoxMats[i], rp);
+		}
+	}
+
+	void CCullingSystem::updateLinear(IRenderPipeline* rp, CCamera* camera, const core::aabbox3df& box, bool shadowPass)
+	{
 		int count = m_bboxAndMaterials.count();
 
 		SBBoxAndMaterial* bbBoxMats = m_bboxAndMaterials.pointer();
 		SBBoxAndMaterial* bbBoxMat;
-		CEntity* entity;
 		CCullingData* culling;
-		CMaterial** materials;
-		CMaterial* m;
-		int materialCount;
+
+		m_testEntries.reset();
+		m_visibleEntities.reset();
 
 		for (int i = 0; i < count; i++)
 		{
 			bbBoxMat = &bbBoxMats[i];
-
-			entity = bbBoxMat->Entity;
 			culling = bbBoxMat->Culling;
 
-			if (g_useCacheCulling)
+			culling->CameraCulled = false;
+
+			// check material first
+			culling->Visible = canRender(bbBoxMat, rp);
+			if (culling->Visible == false)
 			{
-				// if we have the last test result
-				if (culling->CameraCulled == true)
-					continue;
+				m_visibleEntities.push(bbBoxMat->Entity);
+				continue;
 			}
-			else
+
+			m_testEntries.push(bbBoxMat);
+		}
+
+		updateDirtyBBoxes();
+
+		// 1. Detect by bounding box (and the camera frustum planes)
+		m_testKernel.reset();
+
+		SBBoxAndMaterial** entries = m_testEntries.pointer();
+		count = m_testEntries.count();
+
+		for (int i = 0; i < count; i++)
+			m_testKernel.addBox(entries[i]->Culling->BBox);
+
+		m_testKernel.intersectBox(box);
+		if (!shadowPass)
+			m_testKernel.intersectFrustum(camera->getViewFrustum());
+
+		u8* result = m_testKernel.getResult();
+
+		for (int i = 0; i < count; i++)
+		{
+			bbBoxMat = entries[i];
+			culling = bbBoxMat->Culling;
+
+			culling->CameraCulled = result[i] == 0;
+			culling->Visible = !culling->CameraCulled;
+
+			// 2. Detect algorithm
+			if (culling->Visible && !shadowPass && !testFrustum(bbBoxMat, camera->getViewFrustum()))
 			{
-				culling->CameraCulled = false;
+				culling->CameraCulled = true;
+				culling->Visible = false;
 			}
 
-			culling->Visible = true;
+			if (!culling->CameraCulled)
+				m_visibleEntities.push(bbBoxMat->Entity);
+		}
+	}
+
+	void CCullingSystem::beginViews()
+	{
+		m_views.set_used(0);
+		m_currentView = -1;
+		m_viewsCulled = false;
+	}
 
-			// check material first
-			if (bbBoxMat->Materials != NULL)
-			{
-				materials = bbBoxMat->Materials->data();
-				materialCount = (int)bbBoxMat->Materials->size();
+	int CCullingSystem::addView(const core::aabbox3df& box)
+	{
+		if ((int)m_views.size() >= MaxViews)
+			return -1;
+
+		SCullingView view;
+		view.Box = box;
+		view.UseFrustum = false;
+		m_views.push_back(view);
 
-				for (int j = 0; j < materialCount; j++)
+		m_viewsCulled = false;
+		return (int)m_views.size() - 1;
+	}
+
+	int CCullingSystem::addView(const SViewFrustum& frustum)
+	{
+		if ((int)m_views.size() >= MaxViews)
+			return -1;
+
+		SCullingView view;
+		view.Box = frustum.getBoundingBox();
+		view.Frustum = frustum;
+		view.UseFrustum = true;
+		m_views.push_back(view);
+
+		m_viewsCulled = false;
+		return (int)m_views.size() - 1;
+	}
+
+	void CCullingSystem::setCurrentView(int view)
+	{
+		if (view >= (int)m_views.size())
+			view = -1;
+
+		m_currentView = view;
+	}
+
+	void CCullingSystem::endViews()
+	{
+		m_views.set_used(0);
+		m_currentView = -1;
+		m_viewsCulled = false;
+	}
+
+	void CCullingSystem::updateViews()
+	{
+		int count = m_bboxAndMaterials.count();
+		int numViews = (int)m_views.size();
+
+		SBBoxAndMaterial* bbBoxMats = m_bboxAndMaterials.pointer();
+		SBBoxAndMaterial* bbBoxMat;
+		CCullingData* culling;
+
+		for (int i = 0; i < count; i++)
+			bbBoxMats[i].Culling->ViewMask = 0;
+
+		updateDirtyBBoxes();
+
+		// 1. Collect the boxes that can be seen by any view
+		m_testKernel.reset();
+		m_testEntries.reset();
+
+		if (g_useCullingBVH)
+		{
+			core::aabbox3df box = m_views[0].Box;
+			for (int v = 1; v < numViews; v++)
+				box.addInternalBox(m_views[v].Box);
+
+			m_bvh->query(box, m_inside, m_intersect);
+
+			CFastArray<int>* leaves[] = { &m_inside, &m_intersect };
+			for (int l = 0; l < 2; l++)
+			{
+				int* leaf = leaves[l]->pointer();
+				for (int i = 0, n = leaves[l]->count(); i < n; i++)
 				{
-					m = materials[j];
-					if (m != NULL && rp->canRenderMaterial(m) == false)
-					{
-						culling->Visible = false;
-						break;
-					}
+					culling = (CCullingData*)m_bvh->getUserData(leaf[i]);
+					if (culling->BVHEntry < 0)
+						continue;
+
+					m_testKernel.addBox(culling->BBox);
+					m_testEntries.push(&bbBoxMats[culling->BVHEntry]);
 				}
 			}
+		}
+		else
+		{
+			for (int i = 0; i < count; i++)
+			{
+				m_testKernel.addBox(bbBoxMats[i].Culling->BBox);
+				m_testEntries.push(&bbBoxMats[i]);
+			}
+		}
 
-			if (culling->Visible == false)
-				continue;
+		// 2. Test the same boxes with each view, and write the view bit
+		SBBoxAndMaterial** entries = m_testEntries.pointer();
+		count = m_testEntries.count();
+
+		for (int v = 0; v < numViews; v++)
+		{
+			const SCullingView& view = m_views[v];
+			u32 bit = 1u << v;
+
+			m_testKernel.intersectBox(view.Box);
+			if (view.UseFrustum)
+				m_testKernel.intersectFrustum(view.Frustum);
+
+			u8* result = m_testKernel.getResult();
 
-			if (rp->getType() == IRenderPipeline::ShadowMap && !culling->ShadowCasting)
+			for (int i = 0; i < count; i++)
 			{
-				culling->Visible = false;
-				continue;
+				if (result[i] == 0)
+					continue;
+
+				bbBoxMat = entries[i];
+				if (view.UseFrustum && !testFrustum(bbBoxMat, view.Frustum))
+					continue;
+
+				bbBoxMat->Culling->ViewMask |= bit;
 			}
+		}
 
-			if (g_useCacheCulling)
-				continue;
+		m_viewsCulled = true;
+	}
+
+	void CCullingSystem::applyView(IRenderPipeline* rp)
+	{
+		int count = m_bboxAndMaterials.count();
+		SBBoxAndMaterial* bbBoxMats = m_bboxAndMaterials.pointer();
+		CCullingData* culling;
 
-			// update bbox
-			if (culling->NeedValidate)
+		u32 bit = 1u << m_currentView;
+
+		m_visibleEntities.reset();
+
+		for (int i = 0; i < count; i++)
+		{
+			culling = bbBoxMats[i].Culling;
+
+			culling->CameraCulled = (culling->ViewMask & bit) == 0;
+			culling->Visible = !culling->CameraCulled && canRender(&bbBoxMats[i], rp);
+
+			if (!culling->CameraCulled)
+				m_visibleEntities.push(bbBoxMats[i].Entity);
+		}
+	}
+
+	void CCullingSystem::clearVisible()
+	{
+		CEntity** entities = m_visibleEntities.pointer();
+		for (int i = 0, n = m_visibleEntities.count(); i < n; i++)
+		{
+			// the entity can be removed after the last update
+			CCullingData* culling = GET_ENTITY_DATA(entities[i], CCullingData);
+			if (culling != NULL)
 			{
-				culling->BBox = *bbBoxMat->BBox;
-				bbBoxMat->Transform->World.transformBoxEx(culling->BBox);
-				culling->NeedValidate = false;
+				culling->Visible = false;
+				culling->CameraCulled = true;
 			}
+		}
+		m_visibleEntities.reset();
+	}
 
-			// 1. Detect by bounding box
-			if (rp->getType() == IRenderPipeline::ShadowMap)
-			{
-				CShadowMapRP* shadowMapRP = (CShadowMapRP*)rp;
+	void CCullingSystem::updateDirtyBBoxes()
+	{
+		SBBoxAndMaterial* bbBoxMats = m_bboxAndMaterials.pointer();
+		int* dirty = m_dirtyEntries.pointer();
+		int numDirty = m_dirtyEntries.count();
 
-				if (shadowMapRP->getRenderShadowState() == CShadowMapRP::DirectionLight)
-				{
-					const core::aabbox3df& box = shadowMapRP->getFrustumBox();
-					culling->CameraCulled = !culling->BBox.intersectsWithBox(box);
-					culling->Visible = !culling->CameraCulled;
-				}
-				else
-				{
-					culling->CameraCulled = !culling->BBox.intersectsWithBox(cameraBox);
-					culling->Visible = !culling->CameraCulled;
-				}
-				continue;
+		m_transformKernel.reset();
+
+		for (int i = 0; i < numDirty; i++)
+		{
+			SBBoxAndMaterial* bbBoxMat = &bbBoxMats[dirty[i]];
+			m_transformKernel.addBox(*bbBoxMat->BBox, bbBoxMat->Transform->World);
+			bbBoxMat->Culling->NeedValidate = false;
+		}
+
+		// world bbox = transform of local bbox
+		m_transformKernel.transformBoxes();
+
+		for (int i = 0; i < numDirty; i++)
+		{
+			CCullingData* culling = bbBoxMats[dirty[i]].Culling;
+			m_transformKernel.getBox(i, culling->BBox);
+
+			if (culling->BVH == m_bvh)
+			{
+				m_bvh->update(culling->BVHProxy, culling->BBox);
 			}
-			else
+			else if (g_useCullingBVH)
 			{
-				culling->CameraCulled = !culling->BBox.intersectsWithBox(cameraBox);
-				culling->Visible = !culling->CameraCulled;
+				culling->BVH = m_bvh;
+				culling->BVHProxy = m_bvh->insert(culling->BBox, culling);
 			}
+		}
 
-			// 2. Detect algorithm
-			if (culling->Visible == true)
+		m_dirtyEntries.reset();
+	}
+
+	bool CCullingSystem::canRender(SBBoxAndMaterial* bbBoxMat, IRenderPipeline* rp)
+	{
+		// check material first
+		if (bbBoxMat->Materials != NULL)
+		{
+			CMaterial** materials = bbBoxMat->Materials->data();
+			int materialCount = (int)bbBoxMat->Materials->size();
+
+			for (int j = 0; j < materialCount; j++)
+			{
+				CMaterial* m = materials[j];
+				if (m != NULL && rp->canRenderMaterial(m) == false)
+					return false;
+			}
+		}
+
+		if (rp->getType() == IRenderPipeline::ShadowMap && !bbBoxMat->Culling->ShadowCasting)
+			return false;
+
+		return true;
+	}
+
+	bool CCullingSystem::testFrustum(SBBoxAndMaterial* bbBoxMat, const SViewFrustum& frustum)
+	{
+		CCullingData* culling = bbBoxMat->Culling;
+
+		if (culling->Type != CCullingData::FrustumBox)
+			return true;
+
+		CWorldInverseTransformData* invTransform = GET_ENTITY_DATA(bbBoxMat->Entity, CWorldInverseTransformData);
+		if (invTransform == NULL)
+			return true;
+
+		// transform the frustum to the node's current absolute transformation
+		SViewFrustum frust = frustum;
+		frust.transform(invTransform->WorldInverse);
+
+		core::vector3df edges[8];
+		bbBoxMat->BBox->getEdges(edges);
+
+		for (s32 i = 0; i < scene::SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			bool boxInFrustum = false;
+			for (u32 j = 0; j < 8; ++j)
 			{
-				if (culling->Type == CCullingData::FrustumBox)
+				if (frust.planes[i].classifyPointRelation(edges[j]) != core::ISREL3D_FRONT)
 				{
-					CWorldInverseTransformData* invTransform = GET_ENTITY_DATA(entity, CWorldInverseTransformData);
-					if (invTransform)
-					{
-						// transform the frustum to the node's current absolute transformation
-						invTrans = invTransform->WorldInverse;
-
-						SViewFrustum frust = camera->getViewFrustum();
-						frust.transform(invTrans);
-
-						core::vector3df edges[8];
-						bbBoxMat->BBox->getEdges(edges);
-
-						for (s32 i = 0; i < scene::SViewFrustum::VF_PLANE_COUNT; ++i)
-						{
-							bool boxInFrustum = false;
-							for (u32 j = 0; j < 8; ++j)
-							{
-								if (frust.planes[i].classifyPointRelation(edges[j]) != core::ISREL3D_FRONT)
-								{
-									boxInFrustum = true;
-									break;
-								}
-							}
-
-							if (!boxInFrustum)
-							{
-								culling->CameraCulled = true;
-								culling->Visible = false;
-								break;
-							}
-						}
-					} // if invTransform
+					boxInFrustum = true;
+					break;
 				}
 			}
+
+			if (!boxInFrustum)
+				return false;
 		}
+
+		return true;
 	}
 
 	void CCullingSystem::render(CEntityManager* entityManager)
@@ -31,6 +31,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Transform/CWorldTransformData.h"
 #include "Transform/CWorldInverseTransformData.h"
 #include "RenderMesh/CRenderMeshData.h"
+#include "CCullingKernel.h"
 
 namespace Skylicht
 {
@@ -57,6 +58,24 @@ namespace Skylicht
 		}
 	};
 
+	struct SCullingView
+	{
+		core::aabbox3df Box;
+
+		SViewFrustum Frustum;
+
+		// false: only test the box (shadow pass)
+		bool UseFrustum;
+
+		SCullingView()
+		{
+			UseFrustum = false;
+		}
+	};
+
+	class CCullingBVH;
+	class CCamera;
+
 	class SKYLICHT_API CCullingSystem : public IRenderSystem
 	{
 	protected:
@@ -64,7 +83,35 @@ namespace Skylicht
 
 		CEntityGroup* m_group;
 
+		CCullingBVH* m_bvh;
+
+		CFastArray<int> m_inside;
+
+		CFastArray<int> m_intersect;
+
+		// batch the bbox transform and the culling test (see CCullingKernel)
+		CCullingKernel m_transformKernel;
+
+		CCullingKernel m_testKernel;
+
+		// the entries of m_bboxAndMaterials that need update the world bbox, they are collected on onQuery
+		CFastArray<int> m_dirtyEntries;
+
+		CFastArray<SBBoxAndMaterial*> m_testEntries;
+
+		// the entities that are not camera culled by the last update, the next update only clears them
+		CFastArray<CEntity*> m_visibleEntities;
+
+		// multi view culling
+		core::array<SCullingView> m_views;
+
+		int m_currentView;
+
+		bool m_viewsCulled;
+
 	public:
+		static const int MaxViews = 32;
+
 		CCullingSystem();
 
 		virtual ~CCullingSystem();
@@ -84,5 +131,58 @@ namespace Skylicht
 		static void useCacheCulling(bool b);
 
 		static bool useCacheCulling();
+
+		/// @brief Use the bounding volume hierarchy (see CCullingBVH) to accept or reject the whole subtree of bbox, instead of test each bbox.
+		static void useCullingBVH(bool b);
+
+		static bool useCullingBVH();
+
+		inline CCullingBVH* getCullingBVH()
+		{
+			return m_bvh;
+		}
+
+		/// @brief Begin the list of views (shadow cascades, cubemap faces, split screen cameras...) that are culled together in one pass.
+		void beginViews();
+
+		/// @brief Add a view that only test the box, return the view index or -1 if the list is full.
+		int addView(const core::aabbox3df& box);
+
+		/// @brief Add a view that test the box and the frustum planes, return the view index or -1 if the list is full.
+		int addView(const SViewFrustum& frustum);
+
+		/// @brief Select the view for the next cullingAndRender. The views are culled on the first call, and the next calls only read the CCullingData::ViewMask.
+		void setCurrentView(int view);
+
+		/// @brief Clear the list of views, back to cull by the camera.
+		void endViews();
+
+		inline int getCurrentView()
+		{
+			return m_currentView;
+		}
+
+		inline int getNumViews()
+		{
+			return (int)m_views.size();
+		}
+
+	protected:
+
+		void updateCache(IRenderPipeline* rp);
+
+		void updateLinear(IRenderPipeline* rp, CCamera* camera, const core::aabbox3df& box, bool shadowPass);
+
+		void updateViews();
+
+		void applyView(IRenderPipeline* rp);
+
+		void clearVisible();
+
+		void updateDirtyBBoxes();
+
+		bool canRender(SBBoxAndMaterial* bbBoxMat, IRenderPipeline* rp);
+
+		bool testFrustum(SBBoxAndMaterial* bbBoxMat, const SViewFrustum& frustum);
 	};
 }
\ No newline at end of file
@@ -75,4 +75,68 @@ namespace Skylicht
 		m_needQuery = false;
 		m_needValidate = true;
 	}
+
+	bool CGroupVisible::onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+		u32 visibleType = DATA_TYPE_INDEX(CVisibleData);
+		u32 transformType = DATA_TYPE_INDEX(CWorldTransformData);
+
+		bool addEntity = false;
+		bool removeEntity = false;
+
+		for (int i = 0; i < numEntity; i++)
+		{
+			CEntity* entity = entities[i];
+
+			bool select = entity->isAlive() &&
+				entity->Data[visibleType] != NULL &&
+				entity->Data[transformType] != NULL &&
+				entity->isVisible();
+
+			bool contain = containEntity(entity);
+
+			if (select && !contain)
+				addEntity = true;
+			else if (!select && contain)
+				removeEntity = true;
+		}
+
+		if (addEntity)
+		{
+			// the entities must be sorted by depth (see CGroupTransform), so query again the alive entities
+			// the membership only changes on these entities, so the children groups still can query changed
+			onQuery(entityManager, entityManager->getAliveEntities(), entityManager->getNumAliveEntities());
+			updateEntityPosition();
+		}
+		else if (removeEntity)
+		{
+			// keep the order of entities
+			CEntity** groupEntities = m_entities.pointer();
+			int count = m_entities.count();
+			int numSelect = 0;
+
+			for (int i = 0; i < count; i++)
+			{
+				CEntity* entity = groupEntities[i];
+				if (entity->isAlive() &&
+					entity->Data[visibleType] != NULL &&
+					entity->Data[transformType] != NULL)
+				{
+					m_entityPosition[entity->getIndex()] = numSelect;
+					groupEntities[numSelect++] = entity;
+				}
+				else
+				{
+					m_entityPosition[entity->getIndex()] = -1;
+				}
+			}
+
+			for (int i = numSelect; i < count; i++)
+				m_entities.pop();
+
+			m_needValidate = true;
+		}
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -70,6 +70,12 @@ namespace Skylicht
 			return m_count;
 		}
 
+		inline void pop()
+		{
+			if (m_count > 0)
+				m_count--;
+		}
+
 		void push(T element)
 		{
 			if (m_count + 1 >= m_alloc)
@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CEntity.h"
 #include "CEntityManager.h"
 #include "CEntityPrefab.h"
+#include "CEntityDataStorage.h"
 
 #include "Utils/CActivator.h"
 
@@ -35,8 +36,11 @@ https://github.com/skylicht-lab/skylicht-engine
 namespace Skylicht
 {
 	CEntity::CEntity(CEntityManager* mgr) :
-		m_alive(true),
 		m_visible(true),
+		m_alive(true),
+		m_chunkData(0),
+		m_dataSignature(0),
+		m_queryChanged(false),
 		m_mgr(mgr)
 	{
 		m_index = mgr->getNumEntities();
@@ -46,8 +50,11 @@ namespace Skylicht
 	}
 
 	CEntity::CEntity(CEntityPrefab* mgr) :
-		m_alive(true),
 		m_visible(true),
+		m_alive(true),
+		m_chunkData(0),
+		m_dataSignature(0),
+		m_queryChanged(false),
 		m_mgr(NULL)
 	{
 		m_index = mgr->getNumEntities();
@@ -70,16 +77,57 @@ namespace Skylicht
 	{
 		if (Data[index])
 		{
-			notifyUpdateGroup(index);
+			releaseData(index);
 
-			delete Data[index];
-			Data[index] = NULL;
+			notifyDataChanged(index);
 			return true;
 		}
 
 		return false;
 	}
 
+	void* CEntity::allocateData(u32 index, u32 size, u32 align)
+	{
+		if (m_mgr == NULL)
+			return NULL;
+
+		CEntityDataStorage* storage = m_mgr->getDataStorage();
+		if (storage == NULL)
+			return NULL;
+
+		return storage->allocate(index, size, align);
+	}
+
+	void CEntity::freeData(u32 index, void* memory)
+	{
+		m_mgr->getDataStorage()->free(index, memory);
+	}
+
+	void CEntity::releaseData(u32 index)
+	{
+		IEntityData* data = Data[index];
+		if (data == NULL)
+			return;
+
+		u64 bit = (u64)1 << index;
+		if (m_chunkData & bit)
+		{
+			// the address of the most derived object, that is allocated on the storage
+			void* memory = dynamic_cast<void*>(data);
+			data->~IEntityData();
+			freeData(index, memory);
+
+			m_chunkData &= ~bit;
+		}
+		else
+		{
+			delete data;
+		}
+
+		Data[index] = NULL;
+		m_dataSignature &= ~((u64)1 << index);
+	}
+
 	IEntityData* CEntity::addDataByActivator(const char* dataType)
 	{
 		IActivatorObject* obj = CActivator::getInstance()->createInstance(dataType);
@@ -102,13 +150,13 @@ namespace Skylicht
 
 		int index = CEntityDataTypeManager::getDataIndex(typeid(*data));
 
-		if (Data[index])
-			delete Data[index];
+		releaseData(index);
 
 		// save at index
 		Data[index] = data;
+		m_dataSignature |= ((u64)1 << index);
 
-		notifyUpdateGroup(index);
+		notifyDataChanged(index);
 
 		return data;
 	}
@@ -120,10 +168,9 @@ namespace Skylicht
 		{
 			if (Data[i])
 			{
-				delete Data[i];
-				Data[i] = NULL;
+				releaseData(i);
 
-				notifyUpdateGroup(i);
+				notifyDataChanged(i);
 			}
 		}
 	}
@@ -148,4 +195,10 @@ namespace Skylicht
 		if (m_mgr)
 			m_mgr->notifyUpdateGroup(type);
 	}
+
+	void CEntity::notifyDataChanged(u32 index)
+	{
+		if (m_mgr)
+			m_mgr->notifyEntityDataChanged(this, index);
+	}
 }
\ No newline at end of file
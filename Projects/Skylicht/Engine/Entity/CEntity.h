@@ -64,6 +64,15 @@ namespace Skylicht
 		int m_index;
 		std::string m_id;
 
+		// bit mask of the data that is allocated on CEntityDataStorage
+		u64 m_chunkData;
+
+		// bit mask of the data that is added to this entity
+		u64 m_dataSignature;
+
+		// this entity is waiting for the groups update (see CEntityManager::notifyEntityDataChanged)
+		bool m_queryChanged;
+
 		CEntityManager* m_mgr;
 	public:
 
@@ -100,6 +109,12 @@ namespace Skylicht
 			return Data[dataIndex];
 		}
 
+		/// @brief Get the bit mask of the data types that added to this entity (bit = DATA_TYPE_INDEX)
+		inline u64 getDataSignature()
+		{
+			return m_dataSignature;
+		}
+
 		inline void setID(const char* id)
 		{
 			m_id = id;
@@ -146,45 +161,33 @@ namespace Skylicht
 			m_alive = b;
 		}
 
+		void* allocateData(u32 index, u32 size, u32 align);
+
+		void freeData(u32 index, void* memory);
+
+		void releaseData(u32 index);
+
+		void notifyDataChanged(u32 index);
+
 	};
 
 	template<class T>
 	T* CEntity::addData()
 	{
-		T* newData = new T();
-		IEntityData* data = dynamic_cast<IEntityData*>(newData);
-		if (data == NULL)
-		{
-			char exceptionInfo[512];
-			sprintf(exceptionInfo, "CEntity::addData %s must inherit IEntityData", typeid(T).name());
-			os::Printer::log(exceptionInfo);
-
-			delete newData;
-			return NULL;
-		}
-
 		// get index of type
 		u32 index = CEntityDataTypeManager::getDataIndex(typeid(T));
-
-		// also save this entity index
-		data->EntityIndex = m_index;
-		data->Entity = this;
-
-		if (Data[index])
-			delete Data[index];
-
-		// save at index
-		Data[index] = newData;
-
-		notifyUpdateGroup(index);
-
-		return newData;
+		return addData<T>(index);
 	}
 
 	template<class T>
 	T* CEntity::addData(int index)
 	{
-		T* newData = new T();
+		// remove the old data before reuse this slot
+		releaseData(index);
+
+		void* memory = allocateData(index, sizeof(T), alignof(T));
+		T* newData = memory ? new (memory) T() : new T();
+
 		IEntityData* data = dynamic_cast<IEntityData*>(newData);
 		if (data == NULL)
 		{
@@ -192,21 +195,31 @@ namespace Skylicht
 			sprintf(exceptionInfo, "CEntity::addData %s must inherit IEntityData", typeid(T).name());
 			os::Printer::log(exceptionInfo);
 
-			delete newData;
+			if (memory)
+			{
+				newData->~T();
+				freeData(index, memory);
+			}
+			else
+			{
+				delete newData;
+			}
 			return NULL;
 		}
 
+		if (memory)
+			m_chunkData |= ((u64)1 << index);
+
+		m_dataSignature |= ((u64)1 << index);
+
 		// also save this entity index
 		data->EntityIndex = m_index;
 		data->Entity = this;
 
-		if (Data[index])
-			delete Data[index];
-
 		// save at index
 		Data[index] = newData;
 
-		notifyUpdateGroup(index);
+		notifyDataChanged(index);
 
 		return newData;
 	}
@@ -237,10 +250,9 @@ namespace Skylicht
 
 		if (Data[index])
 		{
-			delete Data[index];
-			Data[index] = NULL;
+			releaseData(index);
 
-			notifyUpdateGroup(index);
+			notifyDataChanged(index);
 
 			return true;
 		}
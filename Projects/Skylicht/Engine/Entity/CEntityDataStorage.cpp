@@ -0,0 +1,123 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CEntityDataStorage.h"
+
+namespace Skylicht
+{
+	CEntityDataStorage::CEntityDataStorage(u32 chunkCapacity) :
+		m_chunkCapacity(chunkCapacity)
+	{
+		if (m_chunkCapacity == 0)
+			m_chunkCapacity = 1;
+	}
+
+	CEntityDataStorage::~CEntityDataStorage()
+	{
+		for (u32 i = 0; i < MAX_ENTITY_DATA; i++)
+		{
+			SDataPool& pool = m_pools[i];
+
+			if (pool.NumAlive > 0)
+				os::Printer::log("[CEntityDataStorage] Warning: release the storage, but the entity data is still alive");
+
+			for (u32 j = 0, n = pool.Chunks.size(); j < n; j++)
+				::free(pool.Chunks[j].Block);
+
+			pool.Chunks.clear();
+			pool.FreeSlots.clear();
+		}
+	}
+
+	void* CEntityDataStorage::allocate(u32 dataType, u32 size, u32 align)
+	{
+		SDataPool& pool = m_pools[dataType];
+
+		if (pool.Stride == 0)
+		{
+			// malloc memory is aligned 16 bytes
+			if (align < 16)
+				align = 16;
+			pool.Align = align;
+			pool.Stride = (size + align - 1) / align * align;
+		}
+
+		// a derived type that is bigger than the slot, the caller allocates it on the heap
+		if (size > pool.Stride || align > pool.Align)
+			return NULL;
+
+		pool.NumAlive++;
+
+		// reuse the slot of removed data
+		u32 numFree = pool.FreeSlots.size();
+		if (numFree > 0)
+		{
+			void* slot = pool.FreeSlots[numFree - 1];
+			pool.FreeSlots.erase(numFree - 1);
+			return slot;
+		}
+
+		u32 numChunks = pool.Chunks.size();
+		if (numChunks == 0 || pool.Chunks[numChunks - 1].Used >= m_chunkCapacity)
+		{
+			SDataChunk chunk;
+			if (pool.Align > 16)
+			{
+				// over-aligned type, align the memory in the block
+				chunk.Block = (u8*)malloc(pool.Stride * m_chunkCapacity + pool.Align);
+				chunk.Memory = (u8*)(((size_t)chunk.Block + pool.Align - 1) & ~((size_t)pool.Align - 1));
+			}
+			else
+			{
+				chunk.Block = (u8*)malloc(pool.Stride * m_chunkCapacity);
+				chunk.Memory = chunk.Block;
+			}
+			chunk.Used = 0;
+			pool.Chunks.push_back(chunk);
+			numChunks++;
+		}
+
+		SDataChunk& chunk = pool.Chunks[numChunks - 1];
+		void* slot = chunk.Memory + chunk.Used * pool.Stride;
+		chunk.Used++;
+
+		return slot;
+	}
+
+	void CEntityDataStorage::free(u32 dataType, void* data)
+	{
+		SDataPool& pool = m_pools[dataType];
+		pool.FreeSlots.push_back(data);
+		pool.NumAlive--;
+	}
+
+	u32 CEntityDataStorage::getMemoryUsage()
+	{
+		u32 size = 0;
+		for (u32 i = 0; i < MAX_ENTITY_DATA; i++)
+			size += m_pools[i].Chunks.size() * m_pools[i].Stride * m_chunkCapacity;
+		return size;
+	}
+}
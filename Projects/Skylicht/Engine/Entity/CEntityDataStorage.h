@@ -0,0 +1,117 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CEntity.h"
+
+namespace Skylicht
+{
+	/// @brief The object class stores IEntityData objects in contiguous memory chunks, one pool per data type.
+	/// @ingroup ECS
+	/// 
+	/// By default, CEntity::addData allocates each data object on the heap.
+	/// When the storage is enabled on CEntityManager (CEntityManager::enableDataChunkStorage), the data objects are constructed in the chunks,
+	/// so the entities created together will have their data side by side, and systems that loop over the entities have less cache misses.
+	/// 
+	/// The data objects are never moved after they are allocated, so the pointer that is returned by GET_ENTITY_DATA is stable.
+	/// The slot size & alignment of a pool are set by the first allocation. A bigger or more aligned type on the same index
+	/// (such as CSphereData on the index of CRenderMeshData) is not stored in the pool, CEntity::addData allocates it on the heap.
+	/// It is not an archetype storage: the pools are per data type, not per data signature,
+	/// and CEntityGroup still lists the entity pointers. A system can walk the chunks of a type with getChunk.
+	/// 
+	/// @code
+	/// CEntityManager* entityManager = scene->getEntityManager();
+	/// // call before create the entities
+	/// entityManager->enableDataChunkStorage(true);
+	/// @endcode
+	class SKYLICHT_API CEntityDataStorage
+	{
+	public:
+		struct SDataChunk
+		{
+			u8* Memory;
+			u8* Block;
+			u32 Used;
+		};
+
+	protected:
+		struct SDataPool
+		{
+			u32 Stride;
+			u32 Align;
+			u32 NumAlive;
+			core::array<SDataChunk> Chunks;
+			core::array<void*> FreeSlots;
+
+			SDataPool() :
+				Stride(0),
+				Align(0),
+				NumAlive(0)
+			{
+			}
+		};
+
+		SDataPool m_pools[MAX_ENTITY_DATA];
+
+		u32 m_chunkCapacity;
+
+	public:
+		CEntityDataStorage(u32 chunkCapacity = 256);
+
+		virtual ~CEntityDataStorage();
+
+		/// @brief Allocate a slot for the data type, return NULL when the size or the alignment does not fit the slot of the pool.
+		void* allocate(u32 dataType, u32 size, u32 align);
+
+		void free(u32 dataType, void* data);
+
+		inline u32 getChunkCapacity()
+		{
+			return m_chunkCapacity;
+		}
+
+		inline u32 getStride(u32 dataType)
+		{
+			return m_pools[dataType].Stride;
+		}
+
+		inline u32 getNumChunks(u32 dataType)
+		{
+			return m_pools[dataType].Chunks.size();
+		}
+
+		inline SDataChunk& getChunk(u32 dataType, u32 chunk)
+		{
+			return m_pools[dataType].Chunks[chunk];
+		}
+
+		inline u32 getNumAlive(u32 dataType)
+		{
+			return m_pools[dataType].NumAlive;
+		}
+
+		u32 getMemoryUsage();
+	};
+}
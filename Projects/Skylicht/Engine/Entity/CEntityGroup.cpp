@@ -28,17 +28,20 @@ https://github.com/skylicht-lab/skylicht-engine
 namespace Skylicht
 {
 	CEntityGroup::CEntityGroup(const u32* dataTypes, int count) :
+		m_parentGroup(NULL),
 		m_needQuery(true),
 		m_needValidate(true),
-		m_parentGroup(NULL)
+		m_queryAll(false)
 	{
 		for (int i = 0; i < count; i++)
 			m_dataTypes.push_back(dataTypes[i]);
 	}
 
 	CEntityGroup::CEntityGroup(const u32* dataTypes, int count, CEntityGroup* parentGroup) :
+		m_parentGroup(parentGroup),
 		m_needQuery(true),
-		m_parentGroup(parentGroup)
+		m_needValidate(true),
+		m_queryAll(false)
 	{
 		for (int i = 0; i < count; i++)
 			m_dataTypes.push_back(dataTypes[i]);
@@ -51,8 +54,7 @@ namespace Skylicht
 
 	void CEntityGroup::onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity)
 	{
-		u32* types = m_dataTypes.pointer();
-		int count = m_dataTypes.size();
+		u64 mask = getDataMask();
 
 		m_entities.reset();
 
@@ -65,25 +67,92 @@ namespace Skylicht
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
-			bool selectEntity = true;
 
-			for (int j = 0; j < count; j++)
+			if ((entity->getDataSignature() & mask) == mask)
+				m_entities.push(entity);
+		}
+
+		m_needQuery = false;
+		m_needValidate = true;
+	}
+
+	bool CEntityGroup::onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+		u64 mask = getDataMask();
+
+		for (int i = 0; i < numEntity; i++)
+		{
+			CEntity* entity = entities[i];
+
+			bool select = entity->isAlive() && (entity->getDataSignature() & mask) == mask;
+			if (select && m_parentGroup)
+				select = m_parentGroup->containEntity(entity);
+
+			bool contain = containEntity(entity);
+
+			if (select && !contain)
 			{
-				if (entity->Data[types[j]] == NULL)
-				{
-					selectEntity = false;
-					break;
-				}
+				addEntity(entity);
+				m_needValidate = true;
 			}
-
-			if (selectEntity)
+			else if (!select && contain)
 			{
-				m_entities.push(entity);
+				removeEntity(entity);
+				m_needValidate = true;
 			}
 		}
 
-		m_needQuery = false;
-		m_needValidate = true;
+		return true;
+	}
+
+	void CEntityGroup::updateEntityPosition()
+	{
+		int* position = m_entityPosition.pointer();
+		for (u32 i = 0, n = m_entityPosition.size(); i < n; i++)
+			position[i] = -1;
+
+		CEntity** entities = m_entities.pointer();
+		for (int i = 0, n = m_entities.count(); i < n; i++)
+		{
+			int index = entities[i]->getIndex();
+			while ((int)m_entityPosition.size() <= index)
+				m_entityPosition.push_back(-1);
+			m_entityPosition[index] = i;
+		}
+	}
+
+	void CEntityGroup::addEntity(CEntity* entity)
+	{
+		int index = entity->getIndex();
+		while ((int)m_entityPosition.size() <= index)
+			m_entityPosition.push_back(-1);
+
+		m_entityPosition[index] = m_entities.count();
+		m_entities.push(entity);
+	}
+
+	void CEntityGroup::removeEntity(CEntity* entity)
+	{
+		int index = entity->getIndex();
+		int pos = m_entityPosition[index];
+		int last = m_entities.count() - 1;
+
+		// swap with the last entity
+		CEntity** entities = m_entities.pointer();
+		CEntity* lastEntity = entities[last];
+		entities[pos] = lastEntity;
+		m_entityPosition[lastEntity->getIndex()] = pos;
+
+		m_entities.pop();
+		m_entityPosition[index] = -1;
+	}
+
+	u64 CEntityGroup::getDataMask()
+	{
+		u64 mask = 0;
+		for (u32 i = 0, n = m_dataTypes.size(); i < n; i++)
+			mask |= ((u64)1 << m_dataTypes[i]);
+		return mask;
 	}
 
 	bool CEntityGroup::haveDataType(u32 type)
@@ -36,6 +36,10 @@ namespace Skylicht
 	/// 
 	/// CGroupEntity will store query results; however, in some cases, it will re-query, such as when an entity is created or destroyed by CEntityManager, or when the notifyNeedQuery method is called.
 	/// 
+	/// When the data of some entities is added or removed, CEntityManager calls onQueryChanged with only these entities, 
+	/// the group compares the data signature of the entity (see CEntity::getDataSignature) and adds or swap-removes it, instead of re-query all entities.
+	/// A custom group that overrides onQuery should also override onQueryChanged (return false to re-query all).
+	/// 
 	/// Example of creating a group, that only queries entities containing CPrimiviteData.
 	/// @code
 	/// const u32 primitive[] = GET_LIST_ENTITY_DATA(CPrimiviteData);
@@ -61,8 +65,14 @@ namespace Skylicht
 		// needValidate tell children system update the query
 		bool m_needValidate;
 
+		// queryAll tell this group has re-queried all entities at this frame
+		bool m_queryAll;
+
 		CFastArray<CEntity*> m_entities;
 
+		// position of the entity in m_entities (by entity index), -1 if the entity is not in this group
+		core::array<int> m_entityPosition;
+
 	public:
 		CEntityGroup(const u32* dataTypes, int count);
 
@@ -72,6 +82,22 @@ namespace Skylicht
 
 		virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity);
 
+		/// @brief Update the group with the entities that have data added or removed
+		/// @return false if this group need re-query all entities
+		virtual bool onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+		/// @brief Rebuild the entity position map after m_entities is re-queried
+		void updateEntityPosition();
+
+		inline bool containEntity(CEntity* entity)
+		{
+			int index = entity->getIndex();
+			return index < (int)m_entityPosition.size() && m_entityPosition[index] >= 0;
+		}
+
+		/// @brief Get the bit mask of the data types in this group
+		u64 getDataMask();
+
 		inline CEntity** getEntities()
 		{
 			return m_entities.pointer();
@@ -100,6 +126,17 @@ namespace Skylicht
 		inline void finishValidate()
 		{
 			m_needValidate = false;
+			m_queryAll = false;
+		}
+
+		inline void setQueryAll(bool b)
+		{
+			m_queryAll = b;
+		}
+
+		inline bool isQueryAll()
+		{
+			return m_queryAll;
 		}
 
 		bool haveDataType(u32 type);
@@ -108,5 +145,11 @@ namespace Skylicht
 		{
 			return m_parentGroup;
 		}
+
+	protected:
+
+		void addEntity(CEntity* entity);
+
+		void removeEntity(CEntity* entity);
 	};
 }
\ No newline at end of file
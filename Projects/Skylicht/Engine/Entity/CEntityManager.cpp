@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CEntityManager.h"
+#include "CEntityDataStorage.h"
 
 #include "Transform/CTransformComponentSystem.h"
 #include "Transform/CWorldTransformSystem.h"
@@ -46,13 +47,19 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Debug/CDebugRenderer.h"
 #include "TextBillboard/CTextBillboardRenderer.h"
 
+#include "Thread/CJobSystem.h"
+#include "Thread/CTaskGraph.h"
+
 namespace Skylicht
 {
 	CEntityManager::CEntityManager() :
+		m_systemChanged(true),
+		m_needSortEntities(true),
+		m_multiThreadUpdate(true),
+		m_incrementalQuery(true),
 		m_camera(NULL),
 		m_renderPipeline(NULL),
-		m_systemChanged(true),
-		m_needSortEntities(true)
+		m_dataStorage(NULL)
 	{
 		addCustomGroup(new CGroupVisible());
 
@@ -88,6 +95,36 @@ namespace Skylicht
 		releaseAllEntities();
 		releaseAllSystems();
 		releaseAllGroups();
+
+		releaseUpdateStages(m_updateStages);
+		releaseUpdateStages(m_cullingStages);
+
+		if (m_dataStorage)
+			delete m_dataStorage;
+	}
+
+	bool CEntityManager::enableDataChunkStorage(bool enable)
+	{
+		if (enable == (m_dataStorage != NULL))
+			return true;
+
+		if (m_entities.size() > 0)
+		{
+			os::Printer::log("[CEntityManager] enableDataChunkStorage must be called before create entities");
+			return false;
+		}
+
+		if (enable)
+		{
+			m_dataStorage = new CEntityDataStorage();
+		}
+		else
+		{
+			delete m_dataStorage;
+			m_dataStorage = NULL;
+		}
+
+		return true;
 	}
 
 	void CEntityManager::registerCallback(IEntityManagerCallback* callback)
@@ -130,6 +167,7 @@ namespace Skylicht
 		m_entities.set_used(0);
 		m_unused.set_used(0);
 		m_delayRemove.set_used(0);
+		m_changedEntities.set_used(0);
 
 		notifyUpdateSortEntities();
 	}
@@ -167,7 +205,7 @@ namespace Skylicht
 			for (auto c : m_callbacks)
 				c->onEntityCreated(entity);
 
-			notifyUpdateSortEntities();
+			notifyAliveEntitiesChanged();
 			return entity;
 		}
 
@@ -178,7 +216,7 @@ namespace Skylicht
 		for (auto c : m_callbacks)
 			c->onEntityCreated(entity);
 
-		notifyUpdateSortEntities();
+		notifyAliveEntitiesChanged();
 		return entity;
 	}
 
@@ -201,7 +239,7 @@ namespace Skylicht
 		for (auto c : m_callbacks)
 			c->onEntityCreated(result, num);
 
-		notifyUpdateSortEntities();
+		notifyAliveEntitiesChanged();
 		return result;
 	}
 
@@ -312,7 +350,7 @@ namespace Skylicht
 		}
 
 		if (n > 0)
-			notifyUpdateSortEntities();
+			notifyAliveEntitiesChanged();
 
 		m_delayRemove.set_used(0);
 	}
@@ -427,6 +465,116 @@ namespace Skylicht
 		} customLess;
 
 		std::sort(m_sortUpdate.begin(), m_sortUpdate.end(), customLess);
+
+		std::vector<IEntitySystem*> updateSystems;
+		for (IEntitySystem* s : m_sortUpdate)
+		{
+			if (!s->isRenderSystem())
+				updateSystems.push_back(s);
+		}
+		buildUpdateStages(m_updateStages, updateSystems);
+	}
+
+	void CEntityManager::buildUpdateStages(std::vector<SUpdateStage>& stages, std::vector<IEntitySystem*>& systems)
+	{
+		releaseUpdateStages(stages);
+
+		bool haveDeclared = false;
+		for (IEntitySystem* s : systems)
+		{
+			if (s->isDeclaredDataAccess())
+			{
+				haveDeclared = true;
+				break;
+			}
+		}
+
+		// nothing can run parallel
+		if (!haveDeclared)
+			return;
+
+		std::vector<IEntitySystem*> parallel;
+		int numSystems = (int)systems.size();
+
+		for (int i = 0; i <= numSystems; i++)
+		{
+			IEntitySystem* s = i < numSystems ? systems[i] : NULL;
+			if (s && s->isDeclaredDataAccess())
+			{
+				parallel.push_back(s);
+				continue;
+			}
+
+			// flush the declared systems
+			if (parallel.size() == 1)
+			{
+				stages.push_back({ parallel[0], NULL });
+			}
+			else if (parallel.size() > 1)
+			{
+				System::CTaskGraph* graph = new System::CTaskGraph();
+
+				for (int j = 0, n = (int)parallel.size(); j < n; j++)
+				{
+					IEntitySystem* system = parallel[j];
+
+					graph->addTask([this, system]()
+						{
+							system->onQuery(this, m_alives.pointer(), (int)m_alives.size());
+							system->update(this);
+						});
+
+					// wait the previous systems that access the same data
+					for (int k = 0; k < j; k++)
+					{
+						if (system->isDataConflict(parallel[k]))
+							graph->addDependency(k, j);
+					}
+				}
+
+				stages.push_back({ NULL, graph });
+			}
+			parallel.clear();
+
+			// the system that is not declared run on main thread, in the order
+			if (s)
+				stages.push_back({ s, NULL });
+		}
+	}
+
+	void CEntityManager::releaseUpdateStages(std::vector<SUpdateStage>& stages)
+	{
+		for (SUpdateStage& stage : stages)
+		{
+			if (stage.Graph)
+				delete stage.Graph;
+		}
+		stages.clear();
+	}
+
+	bool CEntityManager::runUpdateStages(std::vector<SUpdateStage>& stages)
+	{
+		if (!m_multiThreadUpdate || stages.size() == 0)
+			return false;
+
+		System::CJobSystem* jobSystem = System::CJobSystem::getInstance();
+		if (jobSystem == NULL || jobSystem->getNumWorkers() == 0)
+			return false;
+
+		for (SUpdateStage& stage : stages)
+		{
+			if (stage.Graph)
+			{
+				stage.Graph->run(jobSystem);
+			}
+			else
+			{
+				stage.MainSystem->onQuery(this, m_alives.pointer(), (int)m_alives.size());
+				stage.MainSystem->update(this);
+			}
+		}
+
+		return true;
 	}
 
 	void CEntityManager::update()
@@ -447,15 +595,30 @@ namespace Skylicht
 		CEntity** entities = m_alives.pointer();
 		int numEntity = (int)m_alives.size();
 
+		CEntity** changed = m_changedEntities.pointer();
+		int numChanged = (int)m_changedEntities.size();
+
 		for (u32 i = 0, n = m_groups.size(); i < n; i++)
 		{
 			CEntityGroup* g = m_groups[i];
 			g->finishValidate();
 
+			// the parent group is re-queried, so this group must re-query
+			CEntityGroup* parent = g->getParent();
+			if (parent && parent->isQueryAll())
+				g->notifyNeedQuery();
+
 			if (g->needQuery())
-				g->onQuery(this, entities, numEntity);
+				queryGroup(g, entities, numEntity);
+			else if (numChanged > 0 && !g->onQueryChanged(this, changed, numChanged))
+				queryGroup(g, entities, numEntity);
 		}
 
+		clearChangedEntities();
+
+		if (runUpdateStages(m_updateStages))
+			return;
+
 		for (IEntitySystem*& s : m_sortUpdate)
 		{
 			// note: Render system will be updated in cullingAndRender function
@@ -485,6 +648,11 @@ namespace Skylicht
 		} customLess;
 
 		std::sort(m_sortRender.begin(), m_sortRender.end(), customLess);
+
+		std::vector<IEntitySystem*> cullingSystems;
+		for (IRenderSystem* s : m_renders)
+			cullingSystems.push_back(s);
+		buildUpdateStages(m_cullingStages, cullingSystems);
 	}
 
 	void CEntityManager::render()
@@ -541,10 +709,13 @@ namespace Skylicht
 		CEntity** entities = m_alives.pointer();
 		int numEntity = m_alives.size();
 
-		for (IRenderSystem*& s : m_renders)
+		if (!runUpdateStages(m_cullingStages))
 		{
-			s->onQuery(this, entities, numEntity);
-			s->update(this);
+			for (IRenderSystem*& s : m_renders)
+			{
+				s->onQuery(this, entities, numEntity);
+				s->update(this);
+			}
 		}
 
 		for (IRenderSystem*& s : m_sortRender)
@@ -575,6 +746,35 @@ namespace Skylicht
 		}
 	}
 
+	void CEntityManager::cullingAndRenderView()
+	{
+		if (m_systemChanged == true)
+		{
+			cullingAndRender();
+			return;
+		}
+
+		CEntity** entities = m_alives.pointer();
+		int numEntity = m_alives.size();
+
+		for (IRenderSystem*& s : m_renders)
+		{
+			if (s->isCullingDependent())
+				s->beginQuery(this);
+		}
+
+		for (IRenderSystem*& s : m_renders)
+		{
+			if (s->isCullingDependent())
+			{
+				s->onQuery(this, entities, numEntity);
+				s->update(this);
+			}
+		}
+
+		render();
+	}
+
 	void CEntityManager::renderEmission()
 	{
 		for (IRenderSystem*& s : m_sortRender)
@@ -614,6 +814,7 @@ namespace Skylicht
 		if (release == true)
 		{
 			delete system;
+			m_systemChanged = true;
 			return true;
 		}
 
@@ -708,6 +909,60 @@ namespace Skylicht
 		}
 	}
 
+	void CEntityManager::notifyAliveEntitiesChanged()
+	{
+		if (m_incrementalQuery)
+		{
+			// the groups will be updated by the changed entities (see notifyEntityDataChanged)
+			m_needSortEntities = true;
+		}
+		else
+		{
+			notifyUpdateSortEntities();
+		}
+	}
+
+	void CEntityManager::notifyEntityDataChanged(CEntity* entity, u32 dataType)
+	{
+		if (!m_incrementalQuery)
+		{
+			notifyUpdateGroup(dataType);
+			return;
+		}
+
+		if (!entity->m_queryChanged)
+		{
+			entity->m_queryChanged = true;
+			m_changedEntities.push_back(entity);
+		}
+	}
+
+	void CEntityManager::setIncrementalQuery(bool b)
+	{
+		if (m_incrementalQuery == b)
+			return;
+
+		m_incrementalQuery = b;
+
+		clearChangedEntities();
+		notifyUpdateSortEntities();
+	}
+
+	void CEntityManager::queryGroup(CEntityGroup* group, CEntity** entities, int numEntity)
+	{
+		group->onQuery(this, entities, numEntity);
+		group->updateEntityPosition();
+		group->setQueryAll(true);
+	}
+
+	void CEntityManager::clearChangedEntities()
+	{
+		CEntity** changed = m_changedEntities.pointer();
+		for (u32 i = 0, n = m_changedEntities.size(); i < n; i++)
+			changed[i]->m_queryChanged = false;
+		m_changedEntities.set_used(0);
+	}
+
 	void CEntityManager::notifyUpdateGroup(u32 dataType)
 	{
 		u32 count = m_groups.size();
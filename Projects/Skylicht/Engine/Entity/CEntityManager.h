@@ -37,6 +37,13 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	namespace System
+	{
+		class CTaskGraph;
+	}
+
+	class CEntityDataStorage;
+
 	class IEntityManagerCallback
 	{
 	public:
@@ -90,6 +97,7 @@ namespace Skylicht
 		core::array<CEntity*> m_entities;
 		core::array<CEntity*> m_unused;
 		core::array<CEntity*> m_delayRemove;
+		core::array<CEntity*> m_changedEntities;
 
 		core::array<CEntityGroup*> m_groups;
 
@@ -103,13 +111,29 @@ namespace Skylicht
 
 		std::vector<IEntityManagerCallback*> m_callbacks;
 
+		struct SUpdateStage
+		{
+			// run on main thread
+			IEntitySystem* MainSystem;
+
+			// or run the systems that have no data conflict on worker threads
+			System::CTaskGraph* Graph;
+		};
+
+		std::vector<SUpdateStage> m_updateStages;
+		std::vector<SUpdateStage> m_cullingStages;
+
 		bool m_systemChanged;
 		bool m_needSortEntities;
+		bool m_multiThreadUpdate;
+		bool m_incrementalQuery;
 
 		CCamera* m_camera;
 
 		IRenderPipeline* m_renderPipeline;
 
+		CEntityDataStorage* m_dataStorage;
+
 	public:
 		CEntityManager();
 
@@ -123,6 +147,12 @@ namespace Skylicht
 
 		void cullingAndRender();
 
+		/**
+		* @brief Render the next view of CCullingSystem, after a cullingAndRender on the first view.
+		* Only the render systems that read the culling result are queried again.
+		*/
+		void cullingAndRenderView();
+
 	protected:
 
 		int getDepth(CWorldTransformData* t);
@@ -161,6 +191,14 @@ namespace Skylicht
 
 		void releaseAllEntities();
 
+		/// @brief Allocate the entity data in contiguous chunks (see CEntityDataStorage). It must be called before create entities.
+		bool enableDataChunkStorage(bool enable);
+
+		inline CEntityDataStorage* getDataStorage()
+		{
+			return m_dataStorage;
+		}
+
 		void releaseAllSystems();
 
 		void releaseAllGroups();
@@ -180,6 +218,17 @@ namespace Skylicht
 			return m_entities.pointer();
 		}
 
+		/// @brief Get the alive entities, that sorted by depth
+		inline CEntity** getAliveEntities()
+		{
+			return m_alives.pointer();
+		}
+
+		inline int getNumAliveEntities()
+		{
+			return (int)m_alives.size();
+		}
+
 		CEntity* getEntityByID(const char* id);
 
 		void removeEntity(int index);
@@ -224,18 +273,52 @@ namespace Skylicht
 
 		void notifyUpdateGroup(u32 dataType);
 
+		/// @brief Called by CEntity when its data is added or removed, the groups will be updated with this entity at next update
+		void notifyEntityDataChanged(CEntity* entity, u32 dataType);
+
+		/// @brief Update the groups only with the entities that changed (see CEntityGroup::onQueryChanged), instead of re-query all entities.
+		void setIncrementalQuery(bool b);
+
+		inline bool isIncrementalQuery()
+		{
+			return m_incrementalQuery;
+		}
+
 		inline void notifySystemOrderChanged()
 		{
 			m_systemChanged = true;
 		}
 
+		/// @brief Run the systems that declared their data access on the worker threads (see IEntitySystem::declareReadData)
+		inline void setMultiThreadUpdate(bool b)
+		{
+			m_multiThreadUpdate = b;
+		}
+
+		inline bool isMultiThreadUpdate()
+		{
+			return m_multiThreadUpdate;
+		}
+
 	protected:
 
 		void initDefaultData(CEntity* entity);
 
+		void notifyAliveEntitiesChanged();
+
+		void queryGroup(CEntityGroup* group, CEntity** entities, int numEntity);
+
+		void clearChangedEntities();
+
 		void sortRenderer();
 
 		void sortSystem();
+
+		void buildUpdateStages(std::vector<SUpdateStage>& stages, std::vector<IEntitySystem*>& systems);
+
+		void releaseUpdateStages(std::vector<SUpdateStage>& stages);
+
+		bool runUpdateStages(std::vector<SUpdateStage>& stages);
 	};
 
 	template<class T>
@@ -41,15 +41,26 @@ namespace Skylicht
 	/// 
 	/// A IEntitySystem will operate by querying entities that have data requiring processing (onQuery), and then running an update function to process the entity's data.
 	/// 
+	/// A system can declare the IEntityData types that it reads/writes in update (declareReadData, declareWriteData),
+	/// the CEntityManager will run the systems that have no data conflict on the worker threads (see System::CJobSystem).
+	/// The system that does not declare is always run in the order.
+	/// 
 	/// @see CEntityGroup
 	class SKYLICHT_API IEntitySystem
 	{
 	protected:
 		int m_systemOrder;
 
+		bool m_declaredDataAccess;
+		u64 m_readData;
+		u64 m_writeData;
+
 	public:
 		IEntitySystem() :
-			m_systemOrder(0)
+			m_systemOrder(0),
+			m_declaredDataAccess(false),
+			m_readData(0),
+			m_writeData(0)
 		{
 		}
 
@@ -80,5 +91,43 @@ namespace Skylicht
 		{
 			return m_systemOrder;
 		}
+
+		inline void declareReadData(u32 dataType)
+		{
+			m_declaredDataAccess = true;
+			m_readData |= ((u64)1 << dataType);
+		}
+
+		inline void declareWriteData(u32 dataType)
+		{
+			m_declaredDataAccess = true;
+			m_writeData |= ((u64)1 << dataType);
+		}
+
+		inline bool isDeclaredDataAccess()
+		{
+			return m_declaredDataAccess;
+		}
+
+		inline u64 getReadData()
+		{
+			return m_readData;
+		}
+
+		inline u64 getWriteData()
+		{
+			return m_writeData;
+		}
+
+		bool isDataConflict(IEntitySystem* system)
+		{
+			if (!m_declaredDataAccess || !system->isDeclaredDataAccess())
+				return true;
+
+			u64 read = system->getReadData();
+			u64 write = system->getWriteData();
+
+			return (m_writeData & (read | write)) != 0 || (m_readData & write) != 0;
+		}
 	};
 }
\ No newline at end of file
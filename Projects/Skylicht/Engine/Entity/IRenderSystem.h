@@ -60,11 +60,15 @@ namespace Skylicht
 		ERenderPass m_renderPass;
 		int m_sortingPriority;
 
+		// the system reads the CCullingData result, so it is queried again on each view of CCullingSystem
+		bool m_cullingDependent;
+
 	public:
 		IRenderSystem() :
 			m_pipelineType(IRenderPipeline::Forwarder),
 			m_renderPass(Opaque),
-			m_sortingPriority(0)
+			m_sortingPriority(0),
+			m_cullingDependent(false)
 		{
 		}
 
@@ -113,5 +117,10 @@ namespace Skylicht
 		{
 			m_sortingPriority = s;
 		}
+
+		inline bool isCullingDependent()
+		{
+			return m_cullingDependent;
+		}
 	};
 }
\ No newline at end of file
@@ -31,7 +31,11 @@ namespace Skylicht
 		m_width(width),
 		m_height(height),
 		m_needUpdateTexture(true),
-		m_texture(NULL)
+		m_texture(NULL),
+		m_shelfTop(0),
+		m_dirtyRect(0, 0, 0, 0),
+		m_usedArea(0),
+		m_lastUsed(0)
 	{
 		m_image = getVideoDriver()->createImage(format, core::dimension2du(width, height));
 
@@ -40,9 +44,6 @@ namespace Skylicht
 		u8 *data = (u8*)m_image->lock();
 		memset(data, 0, size);
 		m_image->unlock();
-
-		core::recti r(0, 0, width, height);
-		m_rects.push_back(r);
 	}
 
 	CAtlas::~CAtlas()
@@ -76,13 +77,44 @@ namespace Skylicht
 	{
 		core::recti ret(0, 0, 0, 0);
 
-		for (int i = 0, n = (int)m_rects.size(); i < n; i++)
+		if (w <= 0 || h <= 0 || w > m_width || h > m_height)
+			return ret;
+
+		// a shelf is used for the rects that are a bit shorter
+		int maxHeight = h + h / 4;
+
+		std::multimap<int, int>::iterator i = m_openShelves.lower_bound(h);
+		std::multimap<int, int>::iterator end = m_openShelves.end();
+
+		for (; i != end && i->first <= maxHeight; ++i)
 		{
-			if (m_rects[i].getWidth() >= w &&
-				m_rects[i].getHeight() >= h)
+			int shelfID = i->second;
+			if (allocOnShelf(m_shelves[shelfID], w, h, ret))
 			{
-				// found region & devide this region
-				ret = devideRect(i, w, h);
+				closeShelf(shelfID);
+				return ret;
+			}
+		}
+
+		// new shelf on the top
+		if (m_shelfTop + h <= m_height)
+		{
+			m_shelves.push_back(SAtlasShelf(m_shelfTop, h));
+			m_shelfTop += h;
+
+			int shelfID = (int)m_shelves.size() - 1;
+			allocOnShelf(m_shelves[shelfID], w, h, ret);
+			openShelf(shelfID);
+			return ret;
+		}
+
+		// the atlas is almost full, use any taller shelf
+		for (; i != end; ++i)
+		{
+			int shelfID = i->second;
+			if (allocOnShelf(m_shelves[shelfID], w, h, ret))
+			{
+				closeShelf(shelfID);
 				return ret;
 			}
 		}
@@ -90,76 +122,183 @@ namespace Skylicht
 		return ret;
 	}
 
-	core::recti CAtlas::devideRect(int rectID, int w, int h)
+	bool CAtlas::allocOnShelf(SAtlasShelf& shelf, int w, int h, core::recti& ret)
 	{
-		core::recti r = m_rects[rectID];
-
-		// remove this region
-		m_rects.erase(m_rects.begin() + rectID);
-
-		// result
-		core::recti ret = r;
-		ret.LowerRightCorner.X = r.UpperLeftCorner.X + w;
-		ret.LowerRightCorner.Y = r.UpperLeftCorner.Y + h;
-
-		// duc.phamhong note
-		// divide region r
-		//
-		// *---+-----------*
-		// | r |           |
-		// | e |   right   |
-		// | t |           |
-		// +---+-----------*
-		// |               |
-		// |     bottom    |
-		// |               |
-		// *---------------*
-		//
-		core::recti right, bottom;
-		right.UpperLeftCorner.X = ret.LowerRightCorner.X;
-		right.LowerRightCorner.X = right.UpperLeftCorner.X + r.getWidth() - w;
-		right.UpperLeftCorner.Y = ret.UpperLeftCorner.Y;
-		right.LowerRightCorner.Y = ret.LowerRightCorner.Y;
-
-		bottom.UpperLeftCorner.X = r.UpperLeftCorner.X;
-		bottom.LowerRightCorner.X = r.LowerRightCorner.X;
-		bottom.UpperLeftCorner.Y = ret.LowerRightCorner.Y;
-		bottom.LowerRightCorner.Y = bottom.UpperLeftCorner.Y + r.getHeight() - h;
-
-		// add new region (sort by height)
-		if (right.getWidth() > 0 && right.getHeight() > 0)
-			insertSortRect(right);
-
-		if (bottom.getWidth() > 0 && bottom.getHeight() > 0)
-			insertSortRect(bottom);
+		int x = -1;
 
-		return ret;
+		// the released spans first
+		for (u32 i = 0, n = (u32)shelf.Free.size(); i < n; i++)
+		{
+			core::vector2di& span = shelf.Free[i];
+			if (span.Y >= w)
+			{
+				x = span.X;
+				span.X += w;
+				span.Y -= w;
+				if (span.Y == 0)
+					shelf.Free.erase(shelf.Free.begin() + i);
+				break;
+			}
+		}
+
+		if (x < 0)
+		{
+			if (shelf.Right + w > m_width)
+				return false;
+
+			x = shelf.Right;
+			shelf.Right += w;
+		}
+
+		ret = core::recti(x, shelf.Y, x + w, shelf.Y + h);
+		m_usedArea += w * h;
+		return true;
 	}
 
-	void CAtlas::insertSortRect(core::recti r)
+	void CAtlas::openShelf(int shelfID)
 	{
-		bool add = false;
+		SAtlasShelf& shelf = m_shelves[shelfID];
+		if (!shelf.Open && (shelf.Right < m_width || shelf.Free.size() > 0))
+		{
+			shelf.Open = true;
+			m_openShelves.insert(std::pair<int, int>(shelf.Height, shelfID));
+		}
+	}
+
+	void CAtlas::closeShelf(int shelfID)
+	{
+		SAtlasShelf& shelf = m_shelves[shelfID];
+		if (shelf.Open && shelf.Right >= m_width && shelf.Free.size() == 0)
+			removeOpenShelf(shelfID);
+	}
+
+	void CAtlas::removeOpenShelf(int shelfID)
+	{
+		SAtlasShelf& shelf = m_shelves[shelfID];
+
+		std::pair<std::multimap<int, int>::iterator, std::multimap<int, int>::iterator> range = m_openShelves.equal_range(shelf.Height);
+		for (std::multimap<int, int>::iterator i = range.first; i != range.second; ++i)
+		{
+			if (i->second == shelfID)
+			{
+				m_openShelves.erase(i);
+				break;
+			}
+		}
+
+		shelf.Open = false;
+	}
+
+	void CAtlas::releaseRect(const core::recti& r)
+	{
+		int w = r.getWidth();
 		int h = r.getHeight();
+		if (w <= 0 || h <= 0)
+			return;
 
-		for (int i = (int)m_rects.size() - 1; i >= 0; i--)
+		// find the shelf by Y
+		int lo = 0, hi = (int)m_shelves.size() - 1, shelfID = -1;
+		while (lo <= hi)
 		{
-			if (h > m_rects[i].getHeight())
+			int mid = (lo + hi) / 2;
+			int y = m_shelves[mid].Y;
+			if (y == r.UpperLeftCorner.Y)
 			{
-				add = true;
-				m_rects.insert(m_rects.begin() + (i + 1), r);
+				shelfID = mid;
 				break;
 			}
+			else if (y < r.UpperLeftCorner.Y)
+				lo = mid + 1;
+			else
+				hi = mid - 1;
 		}
 
-		if (add == false)
-			m_rects.insert(m_rects.begin(), r);
+		if (shelfID < 0)
+			return;
+
+		SAtlasShelf& shelf = m_shelves[shelfID];
+		int x = r.UpperLeftCorner.X;
+
+		// insert the span sorted and merge the neighbours
+		u32 i = 0;
+		while (i < shelf.Free.size() && shelf.Free[i].X < x)
+			i++;
+		shelf.Free.insert(shelf.Free.begin() + i, core::vector2di(x, w));
+
+		if (i + 1 < shelf.Free.size() && shelf.Free[i].X + shelf.Free[i].Y == shelf.Free[i + 1].X)
+		{
+			shelf.Free[i].Y += shelf.Free[i + 1].Y;
+			shelf.Free.erase(shelf.Free.begin() + i + 1);
+		}
+
+		if (i > 0 && shelf.Free[i - 1].X + shelf.Free[i - 1].Y == shelf.Free[i].X)
+		{
+			shelf.Free[i - 1].Y += shelf.Free[i].Y;
+			shelf.Free.erase(shelf.Free.begin() + i);
+		}
+
+		// the last span goes back to the right space
+		if (shelf.Free.size() > 0 && shelf.Free.back().X + shelf.Free.back().Y == shelf.Right)
+		{
+			shelf.Right = shelf.Free.back().X;
+			shelf.Free.pop_back();
+		}
+
+		m_usedArea -= w * h;
+
+		// clear the old pixels, the next rect may not cover them
+		u32 pitch = m_image->getPitch();
+		u32 bpp = m_image->getBytesPerPixel();
+		u8* data = (u8*)m_image->lock();
+		for (int y = r.UpperLeftCorner.Y; y < r.LowerRightCorner.Y; y++)
+			memset(data + y * pitch + x * bpp, 0, w * bpp);
+		m_image->unlock();
+
+		addDirtyRect(r);
+
+		openShelf(shelfID);
+
+		// remove the empty shelves on the top, so the space can be used for the other height
+		while (m_shelves.size() > 0)
+		{
+			SAtlasShelf& top = m_shelves.back();
+			if (top.Right > 0)
+				break;
+
+			if (top.Open)
+				removeOpenShelf((int)m_shelves.size() - 1);
+
+			m_shelfTop = top.Y;
+			m_shelves.pop_back();
+		}
+	}
+
+	void CAtlas::clear()
+	{
+		m_shelves.clear();
+		m_openShelves.clear();
+		m_shelfTop = 0;
+		m_usedArea = 0;
+
+		u32 size = m_image->getPitch() * m_height;
+		u8* data = (u8*)m_image->lock();
+		memset(data, 0, size);
+		m_image->unlock();
+
+		addDirtyRect(core::recti(0, 0, m_width, m_height));
 	}
 
 	ITexture* CAtlas::getTexture()
 	{
 		if (m_texture == NULL)
+		{
 			m_texture = getVideoDriver()->addTexture("atlas", m_image);
 
+			// the new texture has all pixels
+			m_needUpdateTexture = false;
+			m_dirtyRect = core::recti(0, 0, 0, 0);
+		}
+
 		return m_texture;
 	}
 
@@ -173,11 +312,29 @@ namespace Skylicht
 
 		if (m_needUpdateTexture)
 		{
-			void *data = m_texture->lock();
-			memcpy(data, m_image->lock(), m_width * m_height * 4);
-			m_texture->unlock();
+			m_dirtyRect.clipAgainst(core::recti(0, 0, m_width, m_height));
+
+			u32 pitch = m_image->getPitch();
+			u32 bpp = m_image->getBytesPerPixel();
+			u8* data = (u8*)m_image->lock();
+			u8* dirtyData = data + m_dirtyRect.UpperLeftCorner.Y * pitch + m_dirtyRect.UpperLeftCorner.X * bpp;
+
+			// upload the changed pixels only, or the whole image if the driver does not support
+			if (!m_texture->updateRegion(m_dirtyRect, dirtyData, pitch, m_image->getColorFormat()))
+			{
+				void* texData = m_texture->lock();
+				if (texData != NULL)
+				{
+					memcpy(texData, data, m_width * m_height * bpp);
+					m_texture->unlock();
+				}
+			}
+
+			m_image->unlock();
 			m_texture->regenerateMipMapLevels();
+
 			m_needUpdateTexture = false;
+			m_dirtyRect = core::recti(0, 0, 0, 0);
 
 			/*
 			static int test = 0;
@@ -191,6 +348,30 @@ namespace Skylicht
 	void CAtlas::bitBltImage(IImage *img, int x, int y)
 	{
 		img->copyTo(m_image, core::vector2di(x, y));
+
+		core::dimension2du size = img->getDimension();
+		addDirtyRect(core::recti(x, y, x + (int)size.Width, y + (int)size.Height));
+	}
+
+	void CAtlas::bitBltImage(IImage *img, int x, int y, const core::recti& sourceRect)
+	{
+		img->copyTo(m_image, core::vector2di(x, y), sourceRect);
+
+		addDirtyRect(core::recti(x, y, x + sourceRect.getWidth(), y + sourceRect.getHeight()));
+	}
+
+	void CAtlas::addDirtyRect(const core::recti& r)
+	{
+		if (m_needUpdateTexture && m_dirtyRect.getArea() > 0)
+		{
+			m_dirtyRect.addInternalPoint(r.UpperLeftCorner);
+			m_dirtyRect.addInternalPoint(r.LowerRightCorner);
+		}
+		else
+		{
+			m_dirtyRect = r;
+		}
+
 		m_needUpdateTexture = true;
 	}
-}
+}
\ No newline at end of file
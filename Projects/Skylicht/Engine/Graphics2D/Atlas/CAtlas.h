@@ -26,6 +26,33 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	/// @brief A row of the atlas, the rects on the shelf have the same height and are allocated from the left.
+	struct SAtlasShelf
+	{
+		int Y;
+		int Height;
+
+		// the allocated width from the left
+		int Right;
+
+		// the released spans (x, width) on the left of Right, sorted by x
+		std::vector<core::vector2di> Free;
+
+		bool Open;
+
+		SAtlasShelf(int y, int height) :
+			Y(y),
+			Height(height),
+			Right(0),
+			Open(false)
+		{
+		}
+	};
+
+	/// @brief The image that packs many small images (glyphs, sprites) and uploads it to one texture.
+	///
+	/// The rects are packed on the shelves. The open shelves are indexed by the height, so createRect
+	/// finds a shelf in O(log n), and releaseRect gives the space back to the shelf.
 	class SKYLICHT_API CAtlas
 	{
 	protected:
@@ -36,18 +63,40 @@ namespace Skylicht
 		int m_width;
 		int m_height;
 
-		std::vector<core::recti> m_rects;
+		// sorted by Y
+		std::vector<SAtlasShelf> m_shelves;
+
+		// height -> shelf id, the shelves that have space
+		std::multimap<int, int> m_openShelves;
+
+		int m_shelfTop;
+
+		core::recti m_dirtyRect;
+
+		int m_usedArea;
+
+		u32 m_lastUsed;
 
 	public:
 		CAtlas(ECOLOR_FORMAT format, int width, int height);
 
 		virtual ~CAtlas();
 
+		/**
+		* @brief Allocate a rect on the atlas.
+		* @return The rect, or an empty rect if the atlas is full.
+		*/
 		core::recti createRect(int w, int h);
 
-		core::recti devideRect(int rectID, int w, int h);
+		/**
+		* @brief Give back a rect of createRect, the pixels of the rect are cleared.
+		*/
+		void releaseRect(const core::recti& r);
 
-		void insertSortRect(core::recti r);
+		/**
+		* @brief Release all rects and clear the image.
+		*/
+		void clear();
 
 		static void calcCellSize(int *w, int *h);
 
@@ -56,6 +105,16 @@ namespace Skylicht
 			return m_image;
 		}
 
+		inline int getWidth()
+		{
+			return m_width;
+		}
+
+		inline int getHeight()
+		{
+			return m_height;
+		}
+
 		ITexture* getTexture();
 
 		inline bool needUpdateTexture()
@@ -63,8 +122,50 @@ namespace Skylicht
 			return m_needUpdateTexture;
 		}
 
+		/// @brief The region changed by bitBltImage since the last updateTexture, only this region is uploaded.
+		inline const core::recti& getDirtyRect()
+		{
+			return m_dirtyRect;
+		}
+
+		/// @brief The number of pixels allocated by createRect.
+		inline int getUsedArea()
+		{
+			return m_usedArea;
+		}
+
+		inline int getNumShelf()
+		{
+			return (int)m_shelves.size();
+		}
+
+		/// @brief The owner marks the time that the atlas is drawn, it is used to find the least recently used atlas.
+		inline void setLastUsed(u32 time)
+		{
+			m_lastUsed = time;
+		}
+
+		inline u32 getLastUsed()
+		{
+			return m_lastUsed;
+		}
+
 		void updateTexture();
 
 		void bitBltImage(IImage *img, int x, int y);
+
+		void bitBltImage(IImage *img, int x, int y, const core::recti& sourceRect);
+
+	protected:
+
+		bool allocOnShelf(SAtlasShelf& shelf, int w, int h, core::recti& ret);
+
+		void openShelf(int shelfID);
+
+		void closeShelf(int shelfID);
+
+		void removeOpenShelf(int shelfID);
+
+		void addDirtyRect(const core::recti& r);
 	};
 }
\ No newline at end of file
@@ -39,6 +39,17 @@ namespace Skylicht
 		m_scaleGUI(1.0f),
 		m_haveScaleGUI(false),
 		m_is3DBillboard(false),
+		m_enableRenderCache(false),
+		m_enableCulling(true),
+		m_haveCullRect(false),
+		m_numCulled(0),
+		m_subtree(NULL),
+		m_subtreeStack(0),
+		m_subtreeMatch(0),
+		m_subtreeRecord(false),
+		m_subtreeValid(false),
+		m_numSubtreeCached(0),
+		m_renderID(0),
 		m_renderCamera(NULL),
 		m_currentMask(NULL),
 		IsInEditor(false),
@@ -59,7 +70,8 @@ namespace Skylicht
 		m_root->setDock(EGUIDock::DockFill);
 		m_root->setName("Root");
 
-		m_systems.push_back(new CGUILayoutSystem());
+		m_layoutSystem = new CGUILayoutSystem();
+		m_systems.push_back(m_layoutSystem);
 		m_systems.push_back(new CGUIOpacitySystem());
 
 		for (IEntitySystem* system : m_systems)
@@ -167,12 +179,49 @@ namespace Skylicht
 			system->onQuery(NULL, m_alives.pointer(), m_alives.count());
 			system->update(NULL);
 		}
+
+		// update the hit test index, only the changed elements
+		m_spatialIndex.setArea(m_root->getRect());
+
+		CFastArray<CGUITransformData*>& changed = m_layoutSystem->getChangedBounds();
+		CGUITransformData** changedPtr = changed.pointer();
+		for (int i = 0, n = changed.count(); i < n; i++)
+		{
+			CGUITransformData* t = changedPtr[i];
+			m_spatialIndex.update(t->Entity->getIndex(), t->Element, t->Bounds);
+		}
 	}
 
 	void CCanvas::render(CCamera* camera)
 	{
 		m_renderCamera = camera;
 		m_currentMask = NULL;
+		m_numCulled = 0;
+		m_numSubtreeCached = 0;
+		m_subtree = NULL;
+		m_renderID++;
+
+		// the view rect in the canvas space, for the orthographic camera
+		m_haveCullRect = false;
+		if (m_enableCulling &&
+			(camera->getProjectionType() == CCamera::OrthoUI || camera->getProjectionType() == CCamera::Ortho))
+		{
+			const core::recti& vp = getVideoDriver()->getViewPort();
+			core::vector2df p[4];
+
+			m_haveCullRect =
+				getCanvasPosition(camera, (float)vp.UpperLeftCorner.X, (float)vp.UpperLeftCorner.Y, vp, p[0]) &&
+				getCanvasPosition(camera, (float)vp.LowerRightCorner.X, (float)vp.UpperLeftCorner.Y, vp, p[1]) &&
+				getCanvasPosition(camera, (float)vp.UpperLeftCorner.X, (float)vp.LowerRightCorner.Y, vp, p[2]) &&
+				getCanvasPosition(camera, (float)vp.LowerRightCorner.X, (float)vp.LowerRightCorner.Y, vp, p[3]);
+
+			if (m_haveCullRect)
+			{
+				m_cullRect = core::rectf(p[0], p[0]);
+				for (int i = 1; i < 4; i++)
+					m_cullRect.addInternalPoint(p[i]);
+			}
+		}
 
 		// render
 		std::stack<CGUIElement*> renderEntity;
@@ -186,6 +235,10 @@ namespace Skylicht
 
 		while (renderEntity.size() > 0)
 		{
+			// all childs of the cached subtree are drawn
+			if (m_subtree != NULL && renderEntity.size() == m_subtreeStack)
+				endSubtree(camera);
+
 			entity = renderEntity.top();
 			renderEntity.pop();
 
@@ -218,28 +271,161 @@ namespace Skylicht
 					m_currentMask = mask;
 				}
 				mask->applyParentClip(parentMask);
-				mask->beginMaskTest(camera);
 			}
 
-			entity->render(camera);
+			if (m_enableRenderCache && m_subtree == NULL && mask == NULL && entity->isCacheSubtree())
+				beginSubtree(entity, (u32)renderEntity.size(), camera);
+
+			if (m_enableCulling && isCulled(entity, mask))
+			{
+				m_numCulled++;
+			}
+			else if (m_subtree != NULL)
+			{
+				renderSubtree(entity, mask, camera);
+			}
+			else
+			{
+				if (mask != NULL)
+					mask->beginMaskTest(camera);
+
+				if (m_enableRenderCache)
+					entity->renderCache(camera);
+				else
+					entity->render(camera);
+
+				if (mask != NULL)
+					mask->endMaskTest();
+			}
 
 			// update render order for UI Hitest
 			entity->m_renderOrder = renderOrder++;
 
-			if (mask != NULL)
-				mask->endMaskTest();
-
 			// we use stack to render parent -> child
 			// so we must inverse render position because stack = Last-In First-Out (LIFO)
 			for (int i = (int)entity->m_childs.size() - 1; i >= 0; i--)
 				renderEntity.push(entity->m_childs[i]);
 		}
+
+		if (m_subtree != NULL)
+			endSubtree(camera);
 	}
 
-	CGUIElement* CCanvas::getHitTest(CCamera* camera, float x, float y, const core::recti& viewport)
+	void CCanvas::beginSubtree(CGUIElement* entity, u32 stackSize, CCamera* camera)
 	{
+		m_subtree = entity;
+		m_subtreeStack = stackSize;
+		m_subtreeMatch = 0;
+		m_subtreeRecord = false;
+		m_subtreeValid = true;
+
+		CGraphics2DCache* cache = entity->m_subtreeCache;
+		if (cache == NULL || !cache->Valid)
+			recordSubtree(camera);
+	}
+
+	void CCanvas::renderSubtree(CGUIElement* entity, CGUIMask* mask, CCamera* camera)
+	{
+		bool cacheable = mask == NULL && entity->canCacheRender();
+
+		if (!m_subtreeRecord)
+		{
+			core::array<CGUIElement*>& elements = m_subtree->m_subtreeElements;
+
+			if (cacheable &&
+				m_subtreeMatch < elements.size() &&
+				elements[m_subtreeMatch] == entity &&
+				entity->isRenderCacheValid())
+			{
+				// not changed, it is drawn by the subtree cache in endSubtree
+				m_subtreeMatch++;
+				return;
+			}
+
+			recordSubtree(camera);
+		}
+
+		if (!cacheable)
+			m_subtreeValid = false;
+
+		if (mask != NULL)
+			mask->beginMaskTest(camera);
+
+		entity->renderCache(camera);
+
+		if (mask != NULL)
+			mask->endMaskTest();
+
+		m_subtree->m_subtreeElements.push_back(entity);
+	}
+
+	void CCanvas::recordSubtree(CCamera* camera)
+	{
+		if (m_subtree->m_subtreeCache == NULL)
+			m_subtree->m_subtreeCache = new CGraphics2DCache();
+
+		CGraphics2D::getInstance()->beginRecord(m_subtree->m_subtreeCache);
+
+		// the elements that matched are not drawn yet, their own cache is still valid
+		core::array<CGUIElement*>& elements = m_subtree->m_subtreeElements;
+		for (u32 i = 0; i < m_subtreeMatch; i++)
+			elements[i]->renderCache(camera);
+
+		elements.set_used(m_subtreeMatch);
+		m_subtreeRecord = true;
+	}
+
+	void CCanvas::endSubtree(CCamera* camera)
+	{
+		CGraphics2D* g = CGraphics2D::getInstance();
+
+		if (!m_subtreeRecord)
+		{
+			if (m_subtreeMatch == m_subtree->m_subtreeElements.size())
+			{
+				g->addCache(m_subtree->m_subtreeCache);
+				m_numSubtreeCached++;
+				m_subtree = NULL;
+				return;
+			}
+
+			// the last elements are hidden, culled or removed
+			recordSubtree(camera);
+		}
+
+		bool valid = g->endRecord();
+		m_subtree->m_subtreeCache->Valid = valid && m_subtreeValid;
+		m_subtree = NULL;
+	}
+
+	bool CCanvas::isCulled(CGUIElement* entity, CGUIMask* mask)
+	{
+		// the callback can draw anything, and some elements draw out of their rect
+		if (entity == m_root || entity->OnRender != nullptr || !entity->isRenderInsideRect())
+			return false;
+
+		const core::rectf& bounds = entity->m_guiTransform->Bounds;
+
+		if (m_haveCullRect && !isRectOverlap(bounds, m_cullRect))
+			return true;
+
+		// the mask that renders after this element has the clip rect of the last frame
+		if (mask != NULL && mask->getClipRenderID() == m_renderID && !isRectOverlap(bounds, mask->getClipRect()))
+			return true;
+
+		return false;
+	}
+
+	void CCanvas::getWorldTransform(CCamera* camera, core::matrix4& world)
+	{
+		// the canvas was rendered by this camera, so the hit test is the same as the last frame
+		if (camera == m_renderCamera)
+		{
+			world = m_renderWorldTransform;
+			return;
+		}
+
 		core::matrix4 billboardMatrix;
-		core::matrix4 world;
 
 		if (camera->getProjectionType() != CCamera::OrthoUI)
 		{
@@ -305,62 +491,142 @@ namespace Skylicht
 			// world is relative of root
 			world = m_root->getRelativeTransform();
 		}
+	}
 
-		core::array<CGUIElement*> visits;
-		visits.push_back(m_root);
+	bool CCanvas::getCanvasPosition(CCamera* camera, float x, float y, const core::recti& viewport, core::vector2df& result)
+	{
+		core::matrix4 world;
+		getWorldTransform(camera, world);
+
+		core::matrix4 trans = camera->getProjectionMatrix();
+		trans *= camera->getViewMatrix();
+		trans *= world;
+
+		// the canvas plane (z = 0) to the clip space is a 3x3 homography
+		const f32* m = trans.pointer();
+		f32 h[9] = {
+			m[0], m[4], m[12],
+			m[1], m[5], m[13],
+			m[3], m[7], m[15]
+		};
+
+		// inverse of the homography
+		f32 inv[9];
+		inv[0] = h[4] * h[8] - h[5] * h[7];
+		inv[1] = h[2] * h[7] - h[1] * h[8];
+		inv[2] = h[1] * h[5] - h[2] * h[4];
+		inv[3] = h[5] * h[6] - h[3] * h[8];
+		inv[4] = h[0] * h[8] - h[2] * h[6];
+		inv[5] = h[2] * h[3] - h[0] * h[5];
+		inv[6] = h[3] * h[7] - h[4] * h[6];
+		inv[7] = h[1] * h[6] - h[0] * h[7];
+		inv[8] = h[0] * h[4] - h[1] * h[3];
+
+		f32 det = h[0] * inv[0] + h[1] * inv[3] + h[2] * inv[6];
+		if (core::iszero(det))
+			return false;
+
+		// see CProjective::getScreenCoordinatesFrom3DPosition
+		f32 halfW = (f32)viewport.getWidth() * 0.5f;
+		f32 halfH = (f32)viewport.getHeight() * 0.5f;
+		f32 ndcX = (x - halfW) / halfW;
+		f32 ndcY = (halfH - y) / halfH;
+
+		f32 u = inv[0] * ndcX + inv[1] * ndcY + inv[2];
+		f32 v = inv[3] * ndcX + inv[4] * ndcY + inv[5];
+		f32 w = inv[6] * ndcX + inv[7] * ndcY + inv[8];
+
+		if (core::iszero(w))
+			return false;
+
+		result.set(u / w, v / w);
+		return true;
+	}
+
+	void CCanvas::getHitTestElements(CCamera* camera, float x, float y, const core::recti& viewport, std::vector<CGUIElement*>& result)
+	{
+		core::vector2df pos;
+		if (!getCanvasPosition(camera, x, y, viewport, pos))
+			return;
 
-		CGUIElement* result = NULL;
+		size_t begin = result.size();
+		m_spatialIndex.query(pos, result);
 
-		while (visits.size() > 0)
-		{
-			CGUIElement* gui = visits.getLast();
-			visits.erase(visits.size() - 1);
+		// the index tests the bounds, so check the rotated rect
+		core::vector3df point(pos.X, pos.Y, 0.0f);
+		size_t count = begin;
 
-			core::matrix4 worldElementTransform;
-			if (gui == m_root)
-				worldElementTransform = world;
-			else
-				worldElementTransform = world * gui->getAbsoluteTransform();
+		for (size_t i = begin, n = result.size(); i < n; i++)
+		{
+			CGUIElement* gui = result[i];
 
+			const core::matrix4& transform = gui->getAbsoluteTransform();
 			const core::rectf& r = gui->getRect();
 
 			core::vector3df p[4];
-			core::vector3df p2d[4];
-
 			p[0].set(r.UpperLeftCorner.X, r.UpperLeftCorner.Y, 0.0f);
 			p[1].set(r.LowerRightCorner.X, r.UpperLeftCorner.Y, 0.0f);
 			p[2].set(r.UpperLeftCorner.X, r.LowerRightCorner.Y, 0.0f);
 			p[3].set(r.LowerRightCorner.X, r.LowerRightCorner.Y, 0.0f);
 
-			for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
 			{
-				// get real 3d position
-				worldElementTransform.transformVect(p[i]);
-
-				// project to 2d screen
-				CProjective::getScreenCoordinatesFrom3DPosition(camera, p[i], p2d[i].X, p2d[i].Y, viewport.getWidth(), viewport.getHeight());
-				p2d[i].Z = 0.0f;
+				transform.transformVect(p[j]);
+				p[j].Z = 0.0f;
 			}
 
-			// hit test
-			core::triangle3df t1(p2d[0], p2d[1], p2d[2]);
-			core::triangle3df t2(p2d[2], p2d[1], p2d[3]);
-			core::vector3df mousePos(x, y, 0.0f);
+			core::triangle3df t1(p[0], p[1], p[2]);
+			core::triangle3df t2(p[2], p[1], p[3]);
+
+			if (t1.isPointInside(point) == true || t2.isPointInside(point) == true)
+				result[count++] = gui;
+		}
 
-			bool hit = false;
-			if (t1.isPointInside(mousePos) == true || t2.isPointInside(mousePos) == true)
-				hit = true;
+		result.resize(count);
+	}
+
+	CGUIElement* CCanvas::getHitTest(CCamera* camera, float x, float y, const core::recti& viewport)
+	{
+		m_hitElements.clear();
+		getHitTestElements(camera, x, y, viewport, m_hitElements);
+
+		if (std::find(m_hitElements.begin(), m_hitElements.end(), m_root) == m_hitElements.end())
+			return NULL;
 
-			if (hit)
+		// walk down from the root, the last child is on top
+		CGUIElement* result = m_root;
+
+		while (true)
+		{
+			CGUIElement* next = NULL;
+			int numHit = 0;
+
+			for (CGUIElement* gui : m_hitElements)
 			{
-				result = gui;
+				if (gui->getParent() == result)
+				{
+					next = gui;
+					numHit++;
+				}
+			}
 
-				// add child to test child
-				visits.clear();
-				std::vector<CGUIElement*>& childs = gui->getChilds();
-				for (CGUIElement* e : childs)
-					visits.push_back(e);
+			if (numHit == 0)
+				break;
+
+			if (numHit > 1)
+			{
+				std::vector<CGUIElement*>& childs = result->getChilds();
+				for (int i = (int)childs.size() - 1; i >= 0; i--)
+				{
+					if (std::find(m_hitElements.begin(), m_hitElements.end(), childs[i]) != m_hitElements.end())
+					{
+						next = childs[i];
+						break;
+					}
+				}
 			}
+
+			result = next;
 		}
 
 		return result;
@@ -38,11 +38,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "GUI/CGUIFitSprite.h"
 #include "GUI/CGUIElipse.h"
 
+#include "CGUISpatialIndex.h"
+
 #include "Entity/CEntityPrefab.h"
 #include "Entity/CEntityManager.h"
 
 namespace Skylicht
 {
+	class CGUILayoutSystem;
+
 	/// @brief This class manages GUI components, including creating and deleting images and sprites.
 	/// @ingroup Graphics2D
 	/// 
@@ -97,6 +101,39 @@ namespace Skylicht
 		/// Enable 3D billboard rendering for the canvas.
 		bool m_is3DBillboard;
 
+		/// Reuse the batch geometry of the unchanged elements (see CGUIElement::isRenderCacheable).
+		bool m_enableRenderCache;
+
+		/// Skip rendering the elements outside the view or the mask clip.
+		bool m_enableCulling;
+
+		/// The visible rect in the canvas space, valid if m_haveCullRect.
+		core::rectf m_cullRect;
+		bool m_haveCullRect;
+
+		/// The number of elements culled on the last render.
+		int m_numCulled;
+
+		/// The subtree that is drawing with its cache (see CGUIElement::setCacheSubtree).
+		CGUIElement* m_subtree;
+
+		/// The size of the render stack when all elements of the subtree are drawn.
+		u32 m_subtreeStack;
+
+		/// The number of subtree elements that are the same as the cached elements.
+		u32 m_subtreeMatch;
+
+		/// The subtree is changed, its cache is recorded again.
+		bool m_subtreeRecord;
+
+		/// False if the recorded subtree has an element that can't be cached.
+		bool m_subtreeValid;
+
+		/// The number of subtrees drawn from their cache on the last render.
+		int m_numSubtreeCached;
+
+		u32 m_renderID;
+
 		/// The world transform used for rendering.
 		core::matrix4 m_renderWorldTransform;
 
@@ -112,6 +149,15 @@ namespace Skylicht
 		/// List of entity systems for GUI logic.
 		std::vector<IEntitySystem*> m_systems;
 
+		/// The layout system, it reports the elements that changed bounds.
+		CGUILayoutSystem* m_layoutSystem;
+
+		/// Grid of the element bounds for hit testing.
+		CGUISpatialIndex m_spatialIndex;
+
+		/// The elements found by the last hit test.
+		std::vector<CGUIElement*> m_hitElements;
+
 		/// Entities sorted by children depth.
 		CFastArray<CEntity*> m_depth[MAX_ENTITY_DEPTH];
 
@@ -172,6 +218,36 @@ namespace Skylicht
 		 */
 		CGUIElement* getHitTest(CCamera* camera, float x, float y, const core::recti& viewport);
 
+		/**
+		 * @brief Get all GUI elements under the given coordinates, it queries the spatial index.
+		 * @param camera The camera used for projection.
+		 * @param x Screen X coordinate.
+		 * @param y Screen Y coordinate.
+		 * @param viewport The viewport rectangle.
+		 * @param result The elements are added to this list, in no particular order.
+		 */
+		void getHitTestElements(CCamera* camera, float x, float y, const core::recti& viewport, std::vector<CGUIElement*>& result);
+
+		/**
+		 * @brief Convert the screen coordinates to the canvas space (the space of CGUIElement::getAbsoluteTransform).
+		 * @param camera The camera used for projection.
+		 * @param x Screen X coordinate.
+		 * @param y Screen Y coordinate.
+		 * @param viewport The viewport rectangle.
+		 * @param result The position on the canvas plane.
+		 * @return False if the screen point does not hit the canvas plane.
+		 */
+		bool getCanvasPosition(CCamera* camera, float x, float y, const core::recti& viewport, core::vector2df& result);
+
+		/**
+		 * @brief Get the spatial index of the element bounds.
+		 * @return Reference to CGUISpatialIndex.
+		 */
+		inline CGUISpatialIndex& getSpatialIndex()
+		{
+			return m_spatialIndex;
+		}
+
 		/**
 		 * @brief Get the entity manager.
 		 * @return Pointer to CEntityPrefab.
@@ -276,6 +352,69 @@ namespace Skylicht
 			return m_is3DBillboard;
 		}
 
+		/**
+		 * @brief Enable or disable the retained render cache.
+		 * The cacheable elements keep their generated vertices, and only regenerate them after notifyChanged or when the transform, rect or color changed.
+		 * @param b True to enable.
+		 */
+		inline void setEnableRenderCache(bool b)
+		{
+			m_enableRenderCache = b;
+		}
+
+		/**
+		 * @brief Check if the retained render cache is enabled.
+		 * @return True if enabled.
+		 */
+		inline bool isRenderCacheEnabled()
+		{
+			return m_enableRenderCache;
+		}
+
+		/**
+		 * @brief Enable or disable culling the elements outside the view or their mask.
+		 * @param b True to enable.
+		 */
+		inline void setEnableCulling(bool b)
+		{
+			m_enableCulling = b;
+		}
+
+		/**
+		 * @brief Check if the culling is enabled.
+		 * @return True if enabled.
+		 */
+		inline bool isCullingEnabled()
+		{
+			return m_enableCulling;
+		}
+
+		/**
+		 * @brief Get the number of elements that were culled on the last render.
+		 * @return The number of elements.
+		 */
+		inline int getNumCulled()
+		{
+			return m_numCulled;
+		}
+
+		/**
+		 * @brief Get the number of subtrees that were drawn from their cache on the last render.
+		 * @return The number of subtrees.
+		 */
+		inline int getNumSubtreeCached()
+		{
+			return m_numSubtreeCached;
+		}
+
+		/**
+		 * @brief The counter of the render calls, the mask clip rect is valid for culling if it was updated on the current render.
+		 */
+		inline u32 getRenderID()
+		{
+			return m_renderID;
+		}
+
 		/**
 		 * @brief Remove all GUI elements from the canvas.
 		 */
@@ -555,6 +694,14 @@ namespace Skylicht
 			m_renderWorldTransform = w;
 		}
 
+		/**
+		 * @brief Get the world transform of the canvas for the camera.
+		 * It reuses the render world transform if the camera rendered this canvas.
+		 * @param camera The camera.
+		 * @param world The result matrix.
+		 */
+		void getWorldTransform(CCamera* camera, core::matrix4& world);
+
 		/**
 		 * @brief Get the camera currently used for rendering.
 		 * @return Pointer to camera.
@@ -594,6 +741,41 @@ namespace Skylicht
 		 */
 		template<typename T>
 		std::vector<T*> getElementsInChild(bool addThis);
+
+	protected:
+
+		/**
+		 * @brief Check if the element is out of the view or out of its mask clip.
+		 */
+		bool isCulled(CGUIElement* entity, CGUIMask* mask);
+
+		/**
+		 * @brief Start drawing the subtree of the element, from its cache if the elements are not changed.
+		 */
+		void beginSubtree(CGUIElement* entity, u32 stackSize, CCamera* camera);
+
+		/**
+		 * @brief Check the element with the subtree cache, or draw it if the subtree is recording.
+		 */
+		void renderSubtree(CGUIElement* entity, CGUIMask* mask, CCamera* camera);
+
+		/**
+		 * @brief Record the subtree cache again, the elements that matched the cache are drawn first.
+		 */
+		void recordSubtree(CCamera* camera);
+
+		/**
+		 * @brief All elements of the subtree are checked, draw the subtree cache or stop recording it.
+		 */
+		void endSubtree(CCamera* camera);
+
+		static inline bool isRectOverlap(const core::rectf& a, const core::rectf& b)
+		{
+			return a.UpperLeftCorner.X <= b.LowerRightCorner.X &&
+				a.LowerRightCorner.X >= b.UpperLeftCorner.X &&
+				a.UpperLeftCorner.Y <= b.LowerRightCorner.Y &&
+				a.LowerRightCorner.Y >= b.UpperLeftCorner.Y;
+		}
 	};
 
 	template<typename T>
@@ -0,0 +1,176 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CGUISpatialIndex.h"
+
+namespace Skylicht
+{
+	CGUISpatialIndex::CGUISpatialIndex() :
+		m_cellSize(64.0f),
+		m_numX(0),
+		m_numY(0)
+	{
+
+	}
+
+	CGUISpatialIndex::~CGUISpatialIndex()
+	{
+
+	}
+
+	void CGUISpatialIndex::setArea(const core::rectf& area, float cellSize)
+	{
+		if (area == m_area && cellSize == m_cellSize && m_numX > 0)
+			return;
+
+		m_area = area;
+		m_cellSize = cellSize;
+
+		m_numX = core::max_((int)ceilf(area.getWidth() / cellSize), 1);
+		m_numY = core::max_((int)ceilf(area.getHeight() / cellSize), 1);
+
+		m_cells.clear();
+		m_cells.resize(m_numX * m_numY);
+
+		// the cell size changed, add all items again
+		for (int i = 0, n = (int)m_items.size(); i < n; i++)
+		{
+			if (m_items[i].Inserted)
+				insertCells(i);
+		}
+	}
+
+	void CGUISpatialIndex::getCell(float x, float y, int& cx, int& cy)
+	{
+		cx = core::clamp((int)floorf((x - m_area.UpperLeftCorner.X) / m_cellSize), 0, m_numX - 1);
+		cy = core::clamp((int)floorf((y - m_area.UpperLeftCorner.Y) / m_cellSize), 0, m_numY - 1);
+	}
+
+	void CGUISpatialIndex::update(int id, CGUIElement* element, const core::rectf& bounds)
+	{
+		if (id >= (int)m_items.size())
+			m_items.resize(id + 1);
+
+		SItem& item = m_items[id];
+		item.Element = element;
+		item.Bounds = bounds;
+
+		if (m_numX == 0)
+		{
+			item.Inserted = true;
+			return;
+		}
+
+		int x1, y1, x2, y2;
+		getCell(bounds.UpperLeftCorner.X, bounds.UpperLeftCorner.Y, x1, y1);
+		getCell(bounds.LowerRightCorner.X, bounds.LowerRightCorner.Y, x2, y2);
+
+		// still in the same cells
+		if (item.Inserted && item.X1 == x1 && item.Y1 == y1 && item.X2 == x2 && item.Y2 == y2)
+			return;
+
+		if (item.Inserted)
+			removeCells(id);
+
+		item.Inserted = true;
+		insertCells(id);
+	}
+
+	void CGUISpatialIndex::remove(int id)
+	{
+		if (id < 0 || id >= (int)m_items.size())
+			return;
+
+		SItem& item = m_items[id];
+		if (!item.Inserted)
+			return;
+
+		if (m_numX > 0)
+			removeCells(id);
+
+		item.Inserted = false;
+		item.Element = NULL;
+	}
+
+	void CGUISpatialIndex::clear()
+	{
+		m_items.clear();
+
+		for (std::vector<int>& cell : m_cells)
+			cell.clear();
+	}
+
+	void CGUISpatialIndex::insertCells(int id)
+	{
+		SItem& item = m_items[id];
+		getCell(item.Bounds.UpperLeftCorner.X, item.Bounds.UpperLeftCorner.Y, item.X1, item.Y1);
+		getCell(item.Bounds.LowerRightCorner.X, item.Bounds.LowerRightCorner.Y, item.X2, item.Y2);
+
+		for (int y = item.Y1; y <= item.Y2; y++)
+		{
+			for (int x = item.X1; x <= item.X2; x++)
+				m_cells[y * m_numX + x].push_back(id);
+		}
+	}
+
+	void CGUISpatialIndex::removeCells(int id)
+	{
+		SItem& item = m_items[id];
+
+		for (int y = item.Y1; y <= item.Y2; y++)
+		{
+			for (int x = item.X1; x <= item.X2; x++)
+			{
+				std::vector<int>& cell = m_cells[y * m_numX + x];
+				for (int i = 0, n = (int)cell.size(); i < n; i++)
+				{
+					if (cell[i] == id)
+					{
+						cell[i] = cell[n - 1];
+						cell.pop_back();
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	void CGUISpatialIndex::query(const core::vector2df& point, std::vector<CGUIElement*>& result)
+	{
+		if (m_numX == 0)
+			return;
+
+		int cx, cy;
+		getCell(point.X, point.Y, cx, cy);
+
+		std::vector<int>& cell = m_cells[cy * m_numX + cx];
+		for (int id : cell)
+		{
+			SItem& item = m_items[id];
+			if (item.Bounds.isPointInside(point))
+				result.push_back(item.Element);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	class CGUIElement;
+
+	/// @brief The uniform grid of the element bounds in the canvas space, it is used for hit testing.
+	/// @ingroup Graphics2D
+	/// 
+	/// The items are indexed by the entity index of the element, so CCanvas only updates the elements that CGUILayoutSystem changed.
+	/// The elements out of the area are kept in the border cells.
+	class SKYLICHT_API CGUISpatialIndex
+	{
+	protected:
+		struct SItem
+		{
+			CGUIElement* Element;
+			core::rectf Bounds;
+			int X1;
+			int Y1;
+			int X2;
+			int Y2;
+			bool Inserted;
+
+			SItem() :
+				Element(NULL),
+				X1(0),
+				Y1(0),
+				X2(-1),
+				Y2(-1),
+				Inserted(false)
+			{
+			}
+		};
+
+		core::rectf m_area;
+		float m_cellSize;
+
+		int m_numX;
+		int m_numY;
+
+		std::vector<SItem> m_items;
+		std::vector<std::vector<int>> m_cells;
+
+	public:
+		CGUISpatialIndex();
+
+		virtual ~CGUISpatialIndex();
+
+		/**
+		* @brief Set the indexed area, it rebuilds the cells if the area changed.
+		*/
+		void setArea(const core::rectf& area, float cellSize = 64.0f);
+
+		void update(int id, CGUIElement* element, const core::rectf& bounds);
+
+		void remove(int id);
+
+		void clear();
+
+		/**
+		* @brief Get the elements, that their bounds contain the point.
+		*/
+		void query(const core::vector2df& point, std::vector<CGUIElement*>& result);
+
+		inline const core::rectf& getArea()
+		{
+			return m_area;
+		}
+
+		inline int getNumCell()
+		{
+			return m_numX * m_numY;
+		}
+
+	protected:
+
+		void getCell(float x, float y, int& cx, int& cy);
+
+		void insertCells(int id);
+
+		void removeCells(int id);
+	};
+}
@@ -44,7 +44,8 @@ namespace Skylicht
 		m_currentW(-1),
 		m_currentH(-1),
 		m_vertexColorShader(0),
-		m_bufferID(0)
+		m_bufferID(0),
+		m_flushMaterial(NULL)
 	{
 		m_driver = getVideoDriver();
 
@@ -317,6 +318,14 @@ namespace Skylicht
 
 		if (indices->getIndexCount() > 0 && vertices->getVertexCount() > 0)
 		{
+			if (meshBuffer == m_buffer)
+			{
+				m_stats.NumVertex += vertices->getVertexCount();
+
+				for (u32 i = 0, n = m_records.size(); i < n; i++)
+					recordBuffer(m_records[i], m_flushMaterial);
+			}
+
 			// set shader if default
 			if (material.MaterialType > 0)
 			{
@@ -335,6 +344,12 @@ namespace Skylicht
 			vertices->set_used(0);
 
 			nextBuffer();
+
+			for (u32 i = 0, n = m_records.size(); i < n; i++)
+			{
+				m_records[i].Vertex = 0;
+				m_records[i].Index = 0;
+			}
 		}
 	}
 
@@ -357,7 +372,122 @@ namespace Skylicht
 		m_customMaterial.ZBuffer = m_2dMaterial.ZBuffer;
 		m_customMaterial.ZWriteEnable = m_2dMaterial.ZWriteEnable;
 
+		m_flushMaterial = material;
 		flushBuffer(m_buffer, m_customMaterial);
+		m_flushMaterial = NULL;
+	}
+
+	void CGraphics2D::beginRecord(CGraphics2DCache* cache)
+	{
+		cache->clear();
+		cache->Valid = true;
+
+		SRecord record;
+		record.Cache = cache;
+		record.Vertex = m_vertices->getVertexCount();
+		record.Index = m_indices->getIndexCount();
+		m_records.push_back(record);
+	}
+
+	bool CGraphics2D::endRecord()
+	{
+		u32 numRecord = m_records.size();
+		if (numRecord == 0)
+			return false;
+
+		// the geometry that is still waiting in the batch
+		SRecord& record = m_records[numRecord - 1];
+		recordBuffer(record, NULL);
+
+		bool valid = record.Cache->Valid;
+		m_records.erase(numRecord - 1);
+		return valid;
+	}
+
+	void CGraphics2D::recordBuffer(SRecord& record, CMaterial* material)
+	{
+		u32 numVertex = m_vertices->getVertexCount();
+		u32 numIndex = m_indices->getIndexCount();
+
+		if (numVertex <= record.Vertex || numIndex <= record.Index)
+			return;
+
+		CGraphics2DCache* cache = record.Cache;
+
+		CGraphics2DCache::SBatch batch;
+		batch.Texture = m_2dMaterial.getTexture(0);
+		batch.ShaderID = m_2dMaterial.MaterialType;
+		batch.Material = material;
+		batch.VertexStart = cache->Vertices.size();
+		batch.VertexCount = numVertex - record.Vertex;
+		batch.IndexStart = cache->Indices.size();
+		batch.IndexCount = numIndex - record.Index;
+
+		S3DVertex* vertices = (S3DVertex*)m_vertices->getVertices();
+		u16* indices = (u16*)m_indices->getIndices();
+
+		for (u32 i = record.Vertex; i < numVertex; i++)
+			cache->Vertices.push_back(vertices[i]);
+
+		// the index is local on the batch
+		for (u32 i = record.Index; i < numIndex; i++)
+			cache->Indices.push_back(indices[i] - record.Vertex);
+
+		cache->Batchs.push_back(batch);
+
+		record.Vertex = numVertex;
+		record.Index = numIndex;
+	}
+
+	void CGraphics2D::addCache(CGraphics2DCache* cache)
+	{
+		for (u32 b = 0, n = cache->Batchs.size(); b < n; b++)
+		{
+			CGraphics2DCache::SBatch& batch = cache->Batchs[b];
+
+			if (m_2dMaterial.getTexture(0) != batch.Texture || m_2dMaterial.MaterialType != batch.ShaderID || batch.Material != NULL)
+				flush();
+
+			u32 numVertices = m_vertices->getVertexCount();
+			u32 numIndex = m_indices->getIndexCount();
+
+			if (numVertices + batch.VertexCount > MAX_VERTICES || numIndex + batch.IndexCount > MAX_INDICES)
+			{
+				flush();
+				numVertices = 0;
+				numIndex = 0;
+			}
+
+			m_vertices->set_used(numVertices + batch.VertexCount);
+			S3DVertex* vertices = (S3DVertex*)m_vertices->getVertices();
+			const S3DVertex* cacheVertices = &cache->Vertices[batch.VertexStart];
+			std::copy(cacheVertices, cacheVertices + batch.VertexCount, &vertices[numVertices]);
+
+			m_indices->set_used(numIndex + batch.IndexCount);
+			u16* index = (u16*)m_indices->getIndices();
+			const u16* cacheIndex = &cache->Indices[batch.IndexStart];
+			for (u32 i = 0; i < batch.IndexCount; i++)
+				index[numIndex + i] = (u16)(numVertices + cacheIndex[i]);
+
+			m_2dMaterial.setTexture(0, batch.Texture);
+			m_2dMaterial.MaterialType = batch.ShaderID;
+
+			m_buffer->setDirty();
+
+			m_stats.NumCacheVertex += batch.VertexCount;
+
+			if (batch.Material != NULL)
+				flushWithMaterial(batch.Material);
+		}
+	}
+
+	void CGraphics2D::drawImmediateBuffer()
+	{
+		// the immediate draw is not batched, so it can't be recorded
+		for (u32 i = 0, n = m_records.size(); i < n; i++)
+			m_records[i].Cache->Valid = false;
+
+		m_driver->drawMeshBuffer(m_buffer);
 	}
 
 	void CGraphics2D::addExternalBuffer(IMeshBuffer* meshBuffer, const core::matrix4& absoluteMatrix, int shaderID, CMaterial* material)
@@ -1653,7 +1783,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_TRIANGLES);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -1695,7 +1825,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_LINES);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -1732,7 +1862,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_LINES);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -1766,7 +1896,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_TRIANGLES);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -1800,7 +1930,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_TRIANGLES);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -1833,7 +1963,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_LINE_STRIP);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -1866,7 +1996,7 @@ namespace Skylicht
 		m_buffer->setPrimitiveType(scene::EPT_LINE_STRIP);
 		m_buffer->setDirty();
 
-		m_driver->drawMeshBuffer(m_buffer);
+		drawImmediateBuffer();
 
 		m_indices->set_used(0);
 		m_vertices->set_used(0);
@@ -30,12 +30,34 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Graphics2D/SpriteFrame/CSpriteFrame.h"
 #include "Graphics2D/SpriteFrame/CGlyphFont.h"
 #include "Material/CMaterial.h"
+#include "CGraphics2DCache.h"
 
 namespace Skylicht
 {
 	class CCamera;
 	class CCanvas;
 
+	/// @brief The counters of the 2D vertices
+	struct SGraphics2DStats
+	{
+		/// The vertices submitted by the batch buffer
+		u32 NumVertex;
+
+		/// The vertices copied from CGraphics2DCache, they are not generated again
+		u32 NumCacheVertex;
+
+		SGraphics2DStats()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			NumVertex = 0;
+			NumCacheVertex = 0;
+		}
+	};
+
 	/// @brief The object class supports 2D drawing on the screen.
 	/// @ingroup Graphics2D
 	/// 
@@ -82,6 +104,19 @@ namespace Skylicht
 		scene::SVertexBuffer* m_vertices;
 		scene::CIndexBuffer* m_indices;
 
+		struct SRecord
+		{
+			CGraphics2DCache* Cache;
+			u32 Vertex;
+			u32 Index;
+		};
+
+		// the records can be nested, the geometry is recorded in all of them
+		core::array<SRecord> m_records;
+		CMaterial* m_flushMaterial;
+
+		SGraphics2DStats m_stats;
+
 	public:
 		CGraphics2D();
 		virtual ~CGraphics2D();
@@ -182,6 +217,41 @@ namespace Skylicht
 
 		void setNoDepthTest(video::SMaterial& mat);
 
+		/**
+		* @brief Record the geometry of the next batch calls into the cache, until endRecord.
+		* The batch calls still draw as usual. The records can be nested, endRecord stops the last one.
+		*/
+		void beginRecord(CGraphics2DCache* cache);
+
+		/**
+		* @brief Stop recording.
+		* @return true if the cache is valid, false if an immediate draw function was called while recording.
+		*/
+		bool endRecord();
+
+		/**
+		* @brief Append the recorded geometry to the batch, it draws the same as the recorded calls.
+		*/
+		void addCache(CGraphics2DCache* cache);
+
+		inline bool isRecording()
+		{
+			return m_records.size() > 0;
+		}
+
+		/**
+		* @brief Get the vertex counters, they count until resetStats.
+		*/
+		inline SGraphics2DStats& getStats()
+		{
+			return m_stats;
+		}
+
+		inline void resetStats()
+		{
+			m_stats.reset();
+		}
+
 		void draw2DTriangle(
 			const core::position2df& a,
 			const core::position2df& b,
@@ -218,6 +288,10 @@ namespace Skylicht
 
 	private:
 
+		void recordBuffer(SRecord& record, CMaterial* material);
+
+		void drawImmediateBuffer();
+
 		void updateRectBuffer(video::S3DVertex* vtx, const core::rectf& r, const core::matrix4& mat);
 
 		void updateRectTexcoordBuffer(
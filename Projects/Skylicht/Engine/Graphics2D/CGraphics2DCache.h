@@ -0,0 +1,70 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Material/CMaterial.h"
+
+namespace Skylicht
+{
+	/// @brief The geometry that CGraphics2D generated between beginRecord and endRecord.
+	/// @ingroup Graphics2D
+	/// 
+	/// The vertices are already transformed to canvas space, so CGraphics2D::addCache can append them to the batch without recomputing.
+	/// The cache is only valid if every draw call was batched (the immediate draw2D functions cannot be recorded).
+	class SKYLICHT_API CGraphics2DCache
+	{
+	public:
+		struct SBatch
+		{
+			ITexture* Texture;
+			s32 ShaderID;
+			CMaterial* Material;
+			u32 VertexStart;
+			u32 VertexCount;
+			u32 IndexStart;
+			u32 IndexCount;
+		};
+
+		core::array<video::S3DVertex> Vertices;
+		core::array<u16> Indices;
+		core::array<SBatch> Batchs;
+
+		bool Valid;
+
+	public:
+		CGraphics2DCache() :
+			Valid(false)
+		{
+		}
+
+		inline void clear()
+		{
+			Vertices.set_used(0);
+			Indices.set_used(0);
+			Batchs.set_used(0);
+			Valid = false;
+		}
+	};
+}
@@ -30,9 +30,10 @@ namespace Skylicht
 	IMPLEMENT_DATA_TYPE_INDEX(CGUITransformData);
 
 	CGUITransformData::CGUITransformData() :
+		m_scale(1.0f, 1.0f, 1.0f),
 		HasChanged(true),
 		Parent(NULL),
-		m_scale(1.0f, 1.0f, 1.0f)
+		Element(NULL)
 	{
 
 	}
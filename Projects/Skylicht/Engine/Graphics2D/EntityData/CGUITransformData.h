@@ -28,6 +28,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	class CGUIElement;
+
 	class SKYLICHT_API CGUITransformData : public IEntityData
 	{
 		friend class CGUILayoutSystem;
@@ -39,13 +41,21 @@ namespace Skylicht
 		core::vector3df	m_scale;
 		core::vector3df	m_rotation;
 
+		// the rect that Bounds was computed from
+		core::rectf m_boundsRect;
+
 	public:
 		bool HasChanged;
 
 		core::rectf Rect;
 
+		// the bounding rect of Rect in the canvas space, it's updated by CGUILayoutSystem
+		core::rectf Bounds;
+
 		CGUITransformData* Parent;
 
+		CGUIElement* Element;
+
 	public:
 		CGUITransformData();
 
@@ -42,7 +42,14 @@ namespace Skylicht
 		m_enableMaterial(false),
 		m_materialId(0),
 		m_renderOrder(0),
-		m_applyCurrentMask(NULL)
+		m_applyCurrentMask(NULL),
+		m_renderCache(NULL),
+		m_renderChanged(true),
+		m_cacheShaderID(0),
+		m_cacheMaterial(NULL),
+		m_cacheVersion(0),
+		m_cacheSubtree(false),
+		m_subtreeCache(NULL)
 	{
 		CEntityPrefab* entityPrefab = m_canvas->getEntityManager();
 		m_entity = entityPrefab->createEntity();
@@ -53,6 +60,7 @@ namespace Skylicht
 		m_guiAlign = m_entity->addData<CGUIAlignData>();
 		m_renderData = m_entity->addData<CGUIRenderData>();
 		m_transform = GET_ENTITY_DATA(m_entity, CWorldTransformData);
+		m_guiTransform->Element = this;
 
 		setParent(parent);
 		setRect(parent->getRect());
@@ -66,7 +74,14 @@ namespace Skylicht
 		m_enableMaterial(false),
 		m_materialId(0),
 		m_renderOrder(0),
-		m_applyCurrentMask(NULL)
+		m_applyCurrentMask(NULL),
+		m_renderCache(NULL),
+		m_renderChanged(true),
+		m_cacheShaderID(0),
+		m_cacheMaterial(NULL),
+		m_cacheVersion(0),
+		m_cacheSubtree(false),
+		m_subtreeCache(NULL)
 	{
 		CEntityPrefab* entityPrefab = m_canvas->getEntityManager();
 		m_entity = entityPrefab->createEntity();
@@ -77,6 +92,7 @@ namespace Skylicht
 		m_guiAlign = m_entity->addData<CGUIAlignData>();
 		m_renderData = m_entity->addData<CGUIRenderData>();
 		m_transform = GET_ENTITY_DATA(m_entity, CWorldTransformData);
+		m_guiTransform->Element = this;
 
 		setParent(parent);
 		setRect(rect);
@@ -87,8 +103,16 @@ namespace Skylicht
 	{
 		removeAllChilds();
 
+		m_canvas->getSpatialIndex().remove(m_entity->getIndex());
+
 		CEntityPrefab* entityPrefab = m_canvas->getEntityManager();
 		entityPrefab->removeEntity(m_entity);
+
+		if (m_renderCache)
+			delete m_renderCache;
+
+		if (m_subtreeCache)
+			delete m_subtreeCache;
 	}
 
 	void CGUIElement::setName(const wchar_t* name)
@@ -428,6 +452,61 @@ namespace Skylicht
 	{
 		m_guiTransform->HasChanged = true;
 		m_transform->HasChanged = true;
+		m_renderChanged = true;
+	}
+
+	bool CGUIElement::canCacheRender()
+	{
+		// the callback and the border lines are drawn immediately
+		return isRenderCacheable() &&
+			OnRender == nullptr &&
+			!m_drawBorder &&
+			!m_canvas->DrawOutline;
+	}
+
+	bool CGUIElement::isRenderCacheValid()
+	{
+		return m_renderCache &&
+			m_renderCache->Valid &&
+			!m_renderChanged &&
+			m_cacheShaderID == getShaderID() &&
+			m_cacheMaterial == getMaterial() &&
+			m_cacheVersion == getRenderCacheVersion() &&
+			m_cacheColor == getColor() &&
+			m_cacheRect == getRect() &&
+			m_cacheWorld == m_transform->World;
+	}
+
+	void CGUIElement::renderCache(CCamera* camera)
+	{
+		if (!canCacheRender())
+		{
+			render(camera);
+			return;
+		}
+
+		CGraphics2D* g = CGraphics2D::getInstance();
+
+		if (isRenderCacheValid())
+		{
+			g->addCache(m_renderCache);
+			return;
+		}
+
+		if (m_renderCache == NULL)
+			m_renderCache = new CGraphics2DCache();
+
+		m_cacheWorld = m_transform->World;
+		m_cacheRect = getRect();
+		m_cacheColor = getColor();
+		m_cacheShaderID = getShaderID();
+		m_cacheMaterial = getMaterial();
+		m_cacheVersion = getRenderCacheVersion();
+		m_renderChanged = false;
+
+		g->beginRecord(m_renderCache);
+		render(camera);
+		g->endRecord();
 	}
 
 	CGUIElement* CGUIElement::getChildBefore(CGUIElement* object)
@@ -31,6 +31,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Graphics2D/EntityData/CGUIAlignData.h"
 #include "Graphics2D/EntityData/CGUIRenderData.h"
 #include "Graphics2D/EntityData/CGUILayoutData.h"
+#include "Graphics2D/CGraphics2DCache.h"
 
 namespace Skylicht
 {
@@ -76,6 +77,20 @@ namespace Skylicht
 
 		std::string m_materialFile;
 
+		CGraphics2DCache* m_renderCache;
+		bool m_renderChanged;
+
+		core::matrix4 m_cacheWorld;
+		core::rectf m_cacheRect;
+		SColor m_cacheColor;
+		int m_cacheShaderID;
+		CMaterial* m_cacheMaterial;
+		u32 m_cacheVersion;
+
+		bool m_cacheSubtree;
+		CGraphics2DCache* m_subtreeCache;
+		core::array<CGUIElement*> m_subtreeElements;
+
 	public:
 
 		std::function<void(CGUIElement*)> OnRender;
@@ -94,6 +109,10 @@ namespace Skylicht
 			return m_applyCurrentMask;
 		}
 
+		void renderCache(CCamera* camera);
+
+		bool isRenderCacheValid();
+
 	public:
 		virtual ~CGUIElement();
 
@@ -239,6 +258,7 @@ namespace Skylicht
 		{
 			m_transform->HasChanged = true;
 			m_guiTransform->HasChanged = true;
+			m_renderChanged = true;
 		}
 
 		inline void setPosition(const core::vector3df& v)
@@ -341,6 +361,27 @@ namespace Skylicht
 			m_drawBorder = b;
 		}
 
+		/**
+		* @brief The canvas keeps the batch geometry of this element and all its childs in one cache (when the canvas enables the render cache).
+		* The cache is drawn as long as the childs are not changed, it is good for a panel that is not animated.
+		* The subtree is not cached if it has a mask, or an element that can't cache its render (see isRenderCacheable).
+		* A subtree inside a cached subtree is a part of the parent cache.
+		*/
+		inline void setCacheSubtree(bool b)
+		{
+			m_cacheSubtree = b;
+		}
+
+		inline bool isCacheSubtree()
+		{
+			return m_cacheSubtree;
+		}
+
+		inline CGraphics2DCache* getSubtreeCache()
+		{
+			return m_subtreeCache;
+		}
+
 		inline bool isEnableMaterial()
 		{
 			return m_enableMaterial;
@@ -376,6 +417,39 @@ namespace Skylicht
 
 		void notifyChanged();
 
+		/**
+		* @brief The element can keep its batch geometry in a CGraphics2DCache when the canvas enables the render cache.
+		* It must call notifyChanged when something that render() uses changes, except the world transform, rect, color, shader and material.
+		* The plain CGUIElement only draws the border (never cached), so it is cacheable. A derived class is not, until it overrides this.
+		*/
+		virtual bool isRenderCacheable()
+		{
+			return typeid(*this) == typeid(CGUIElement);
+		}
+
+		/**
+		* @brief The cache is rebuilt when this value changes, e.g. the sprite frame is moved by CSpriteAtlas::defragment.
+		*/
+		virtual u32 getRenderCacheVersion()
+		{
+			return 0;
+		}
+
+		bool canCacheRender();
+
+		/**
+		* @brief Return false if render() can draw outside of getRect(), then the canvas never culls this element.
+		*/
+		virtual bool isRenderInsideRect()
+		{
+			return true;
+		}
+
+		inline CGraphics2DCache* getRenderCache()
+		{
+			return m_renderCache;
+		}
+
 		CGUIElement* getChildBefore(CGUIElement* object);
 
 		void bringToNext(CGUIElement* object, CGUIElement* target, bool behind);
@@ -76,5 +76,7 @@ namespace Skylicht
 		CGUIElement::loadSerializable(object);
 		m_a = object->get<float>("angleA", 0.0f);
 		m_b = object->get<float>("angleB", 360.0f);
+
+		notifyChanged();
 	}
 }
\ No newline at end of file
@@ -53,10 +53,16 @@ namespace Skylicht
 
 		virtual void render(CCamera* camera);
 
+		virtual bool isRenderCacheable()
+		{
+			return true;
+		}
+
 		inline void setFillAngle(float a, float b)
 		{
 			m_a = a;
 			m_b = b;
+			notifyChanged();
 		}
 
 		virtual CObjectSerializable* createSerializable();
@@ -160,6 +160,8 @@ namespace Skylicht
 		{
 			m_frame = NULL;
 		}
+
+		notifyChanged();
 	}
 
 	void CGUIFitSprite::setFrameSource(const char* spritePath, const char* frameName, const char* editorFileRef)
@@ -182,6 +184,8 @@ namespace Skylicht
 				m_spriteId = sprite->getId();
 			}
 		}
+
+		notifyChanged();
 	}
 
 	void CGUIFitSprite::setAnchor(AnchorType type, float left, float right, float top, float bottom)
@@ -191,6 +195,8 @@ namespace Skylicht
 		m_anchorRight = core::max_(right, 0.0f);
 		m_anchorTop = core::max_(top, 0.0f);
 		m_anchorBottom = core::max_(bottom, 0.0f);
+
+		notifyChanged();
 	}
 
 	CObjectSerializable* CGUIFitSprite::createSerializable()
@@ -251,5 +257,7 @@ namespace Skylicht
 				}
 			}
 		}
+
+		notifyChanged();
 	}
 }
\ No newline at end of file
@@ -80,6 +80,16 @@ namespace Skylicht
 
 		virtual void render(CCamera* camera);
 
+		virtual bool isRenderCacheable()
+		{
+			return true;
+		}
+
+		virtual u32 getRenderCacheVersion()
+		{
+			return m_frame ? m_frame->Version : 0;
+		}
+
 		void reloadSpriteFrame();
 
 		void setFrameSource(const char* spritePath, const char* frameName, const char* editorFileRef = NULL);
@@ -87,6 +97,7 @@ namespace Skylicht
 		inline void setFrame(SFrame* frame)
 		{
 			m_frame = frame;
+			notifyChanged();
 		}
 
 		inline SFrame* getFrame()
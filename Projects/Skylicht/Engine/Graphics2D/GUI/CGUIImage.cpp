@@ -89,6 +89,8 @@ namespace Skylicht
 
 		if (m_image)
 			setSourceRect(0, 0, (float)m_image->getSize().Width, (float)m_image->getSize().Height);
+
+		notifyChanged();
 	}
 
 	void CGUIImage::setImageResource(const char* path, const char* editorRefId)
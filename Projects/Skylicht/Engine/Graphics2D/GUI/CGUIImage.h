@@ -59,6 +59,16 @@ namespace Skylicht
 
 		virtual void render(CCamera* camera);
 
+		virtual bool isRenderCacheable()
+		{
+			return true;
+		}
+
+		virtual bool isRenderInsideRect()
+		{
+			return m_pivot.X == 0.0f && m_pivot.Y == 0.0f;
+		}
+
 		virtual const core::rectf getNativeRect();
 
 		void setImage(ITexture* texture);
@@ -81,11 +91,13 @@ namespace Skylicht
 			m_sourceRect.UpperLeftCorner.Y = y;
 			m_sourceRect.LowerRightCorner.X = x + w;
 			m_sourceRect.LowerRightCorner.Y = y + h;
+			notifyChanged();
 		}
 
 		void setPivot(float x, float y)
 		{
 			m_pivot.set(x, y);
+			notifyChanged();
 		}
 
 		const core::position2df& getPivot()
@@ -60,6 +60,12 @@ namespace Skylicht
 
 		virtual void update(CCamera* camera);
 
+		virtual bool isRenderCacheable()
+		{
+			// the layout draws nothing
+			return true;
+		}
+
 		inline void setAlign(CGUILayoutData::EAlignType type)
 		{
 			m_layoutData->AlignType = type;
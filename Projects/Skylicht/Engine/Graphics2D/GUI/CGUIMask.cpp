@@ -26,12 +26,14 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CGUIMask.h"
 #include "Graphics2D/CGraphics2D.h"
+#include "Graphics2D/CCanvas.h"
 
 namespace Skylicht
 {
 	CGUIMask::CGUIMask(CCanvas* canvas, CGUIElement* parent, const core::rectf& rect) :
 		CGUIElement(canvas, parent, rect),
-		m_drawMask(false)
+		m_drawMask(false),
+		m_clipRenderID(0)
 	{
 
 	}
@@ -50,6 +52,7 @@ namespace Skylicht
 	{
 		const core::rectf& r = getRect();
 		m_drawMask = false;
+		m_clipRenderID = m_canvas->getRenderID();
 
 		float z = 0.0f;
 		if (camera && camera->getProjectionType() != CCamera::OrthoUI)
@@ -49,6 +49,7 @@ namespace Skylicht
 		CGUIMask(CCanvas* canvas, CGUIElement* parent, const core::rectf& rect);
 
 		bool m_drawMask;
+		u32 m_clipRenderID;
 		core::vector3df m_topLeft;
 		core::vector3df m_bottomRight;
 
@@ -67,6 +68,24 @@ namespace Skylicht
 
 		void endMaskTest();
 
+		/**
+		 * @brief Get the clip rect in the canvas space, it's updated on the render.
+		 */
+		inline core::rectf getClipRect()
+		{
+			core::rectf r(m_topLeft.X, m_topLeft.Y, m_bottomRight.X, m_bottomRight.Y);
+			r.repair();
+			return r;
+		}
+
+		/**
+		 * @brief The canvas render pass that updated the clip rect, see CCanvas::getRenderID.
+		 */
+		inline u32 getClipRenderID()
+		{
+			return m_clipRenderID;
+		}
+
 		inline void clearMask()
 		{
 			m_drawMask = false;
@@ -50,6 +50,11 @@ namespace Skylicht
 
 		virtual void render(CCamera* camera);
 
+		virtual bool isRenderCacheable()
+		{
+			return true;
+		}
+
 		DECLARE_GETTYPENAME(CGUIRect)
 	};
 }
\ No newline at end of file
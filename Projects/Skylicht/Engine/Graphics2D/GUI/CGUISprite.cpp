@@ -131,6 +131,8 @@ namespace Skylicht
 		{
 			m_frame = NULL;
 		}
+
+		notifyChanged();
 	}
 
 	void CGUISprite::setFrameSource(const char* spritePath, const char* frameName, const char* editorFileRef)
@@ -152,6 +154,8 @@ namespace Skylicht
 				m_spriteId = sprite->getId();
 			}
 		}
+
+		notifyChanged();
 	}
 
 	void CGUISprite::setAutoRotate(bool rotate, float rotateAngle, float framePerSec)
@@ -177,6 +181,8 @@ namespace Skylicht
 			m_frame->ModuleOffset[0].OffsetX = -((float)m_frame->getWidth() * 0.5f);
 			m_frame->ModuleOffset[0].OffsetY = -((float)m_frame->getHeight() * 0.5f);
 		}
+
+		notifyChanged();
 	}
 
 	void CGUISprite::setAlignModuleDefault()
@@ -187,6 +193,8 @@ namespace Skylicht
 			m_frame->ModuleOffset[0].OffsetY = m_defaultOffsetY;
 			m_isCenter = false;
 		}
+
+		notifyChanged();
 	}
 
 	void CGUISprite::setOffsetModule(float x, float y)
@@ -196,6 +204,8 @@ namespace Skylicht
 			m_frame->ModuleOffset[0].OffsetX = x;
 			m_frame->ModuleOffset[0].OffsetY = y;
 		}
+
+		notifyChanged();
 	}
 
 	CObjectSerializable* CGUISprite::createSerializable()
@@ -239,5 +249,7 @@ namespace Skylicht
 					m_frame = sprite->getFrameById(m_guid.c_str());
 			}
 		}
+
+		notifyChanged();
 	}
 }
\ No newline at end of file
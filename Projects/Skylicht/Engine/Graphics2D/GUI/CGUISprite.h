@@ -119,6 +119,27 @@ namespace Skylicht
 		 */
 		virtual void render(CCamera* camera);
 
+		/**
+		 * @brief The sprite geometry can be cached by the canvas, the setters call notifyChanged.
+		 */
+		virtual bool isRenderCacheable()
+		{
+			return true;
+		}
+
+		virtual u32 getRenderCacheVersion()
+		{
+			return m_frame ? m_frame->Version : 0;
+		}
+
+		/**
+		 * @brief The frame is drawn at its module offset, so only the stretched sprite is inside the rect.
+		 */
+		virtual bool isRenderInsideRect()
+		{
+			return m_stretch;
+		}
+
 		/**
 		 * @brief Get the native rectangle of the frame.
 		 * The native rectangle is a rectangle whose size matches the size of the frame.
@@ -135,6 +156,7 @@ namespace Skylicht
 		inline void setFrame(SFrame* frame)
 		{
 			m_frame = frame;
+			notifyChanged();
 		}
 
 		/**
@@ -189,6 +211,7 @@ namespace Skylicht
 		inline void setStretch(bool b)
 		{
 			m_stretch = b;
+			notifyChanged();
 		}
 
 		/**
@@ -33,25 +33,29 @@ namespace Skylicht
 {
 	CGUIText::CGUIText(CCanvas* canvas, CGUIElement* parent, IFont* font) :
 		CGUIElement(canvas, parent),
+		m_font(NULL),
+		m_customfont(font),
+		m_charPadding(0),
+		m_charSpacePadding(0),
+		m_linePadding(0),
+		m_enableTextFormat(true),
 		TextVertical(EGUIVerticalAlign::Top),
 		TextHorizontal(EGUIHorizontalAlign::Left),
 		m_multiLine(true),
 		m_centerRotate(false),
-		m_charPadding(0),
-		m_charSpacePadding(0),
-		m_linePadding(0),
 		m_updateTextRender(true),
-		m_font(NULL),
-		m_customfont(font),
 		m_fontData(NULL),
+		m_fontChanged(-1),
 		m_lastWidth(0.0f),
 		m_lastHeight(0.0f),
-		m_fontChanged(-1),
-		m_enableTextFormat(true)
+		m_atlasVersion(0),
+		m_layoutVersion(0),
+		m_alphaShader(-1),
+		m_sdfShader(-1)
 #ifdef HAVE_CARET
 		, m_showCaret(false),
-		m_setCaret(-1),
 		m_caretShader(0),
+		m_setCaret(-1),
 		m_caretBlink(0.0f),
 		m_caretBlinkSpeed(500.0f)
 #endif
@@ -63,21 +67,25 @@ namespace Skylicht
 
 	CGUIText::CGUIText(CCanvas* canvas, CGUIElement* parent, const core::rectf& rect, IFont* font) :
 		CGUIElement(canvas, parent, rect),
+		m_font(NULL),
+		m_customfont(font),
+		m_charPadding(0),
+		m_charSpacePadding(0),
+		m_linePadding(0),
+		m_enableTextFormat(true),
 		TextVertical(EGUIVerticalAlign::Top),
 		TextHorizontal(EGUIHorizontalAlign::Left),
 		m_multiLine(true),
 		m_centerRotate(false),
-		m_charPadding(0),
-		m_charSpacePadding(0),
-		m_linePadding(0),
 		m_updateTextRender(true),
-		m_font(NULL),
-		m_customfont(font),
 		m_fontData(NULL),
+		m_fontChanged(-1),
 		m_lastWidth(0.0f),
 		m_lastHeight(0.0f),
-		m_fontChanged(-1),
-		m_enableTextFormat(true)
+		m_atlasVersion(0),
+		m_layoutVersion(0),
+		m_alphaShader(-1),
+		m_sdfShader(-1)
 #ifdef HAVE_CARET
 		, m_showCaret(false),
 		m_caretShader(0),
@@ -117,6 +125,27 @@ namespace Skylicht
 		}
 	}
 
+	int CGUIText::getTextShaderID()
+	{
+		int shaderID = getShaderID();
+
+		if (m_font == NULL || !m_font->isSDF())
+			return shaderID;
+
+		if (m_sdfShader == -1)
+		{
+			CShaderManager* shaderMgr = CShaderManager::getInstance();
+			m_alphaShader = shaderMgr->getShaderIDByName("TextureColorAlpha");
+			m_sdfShader = shaderMgr->getShaderIDByName("TextureColorSDF");
+		}
+
+		// the default text shader can not draw the distance field
+		if (shaderID == m_alphaShader)
+			return m_sdfShader;
+
+		return shaderID;
+	}
+
 	IFont* CGUIText::getCurrentFont()
 	{
 		if (m_customfont)
@@ -724,6 +753,64 @@ namespace Skylicht
 		updateCaret();
 #endif
 
+		updateLayout();
+
+		const core::rectf& rect = getRect();
+
+		// calc multiline height
+		int textHeight = (int)m_arrayCharRender.size() * (m_textHeight + m_linePadding);
+		textHeight -= m_linePadding;
+
+		int x = (int)rect.UpperLeftCorner.X;
+		int y = (int)rect.UpperLeftCorner.Y;
+
+		// calc text algin vertial
+		if (TextVertical == EGUIVerticalAlign::Middle)
+			y = y + ((int)m_lastHeight - textHeight - m_textOffsetY) / 2;
+		else if (TextVertical == EGUIVerticalAlign::Bottom)
+			y = y + (int)m_lastHeight - textHeight;
+
+		if (m_centerRotate == true)
+			y = y - textHeight / 2;
+
+		// render
+		for (int i = 0, n = (int)m_arrayCharRender.size(); i < n; i++)
+		{
+			// render text
+			renderText(m_arrayCharRender[i], m_arrayCharFormat[i], x, y, i);
+
+			// new line
+			y += (m_textHeight + m_linePadding);
+		}
+
+		CGUIElement::render(camera);
+	}
+
+	void CGUIText::update(CCamera* camera)
+	{
+		CGUIElement::update(camera);
+
+		// upload the new glyphs & keep the atlas, also when the text is drawn from the render cache
+		IFont* font = getCurrentFont();
+		if (font)
+		{
+			updateLayout();
+			font->updateFontTexture();
+		}
+	}
+
+	u32 CGUIText::getRenderCacheVersion()
+	{
+		updateLayout();
+		return m_layoutVersion;
+	}
+
+	void CGUIText::updateLayout()
+	{
+		IFont* font = getCurrentFont();
+		if (!font)
+			return;
+
 		// fix: sometime font address pointer is not change (so font != m_font is not correct)
 		bool fontChanged = false;
 		if (m_fontData)
@@ -742,6 +829,14 @@ namespace Skylicht
 			m_updateTextRender = true;
 		}
 
+		// the glyphs are moved or evicted
+		u32 atlasVersion = font->getAtlasVersion();
+		if (m_atlasVersion != atlasVersion)
+		{
+			m_atlasVersion = atlasVersion;
+			m_updateTextRender = true;
+		}
+
 		const core::rectf& rect = getRect();
 
 		if (m_lastWidth != rect.getWidth() || m_lastHeight != rect.getHeight())
@@ -755,37 +850,8 @@ namespace Skylicht
 		{
 			updateSplitText();
 			m_updateTextRender = false;
+			m_layoutVersion++;
 		}
-
-		m_font->updateFontTexture();
-
-		// calc multiline height
-		int textHeight = (int)m_arrayCharRender.size() * (m_textHeight + m_linePadding);
-		textHeight -= m_linePadding;
-
-		int x = (int)rect.UpperLeftCorner.X;
-		int y = (int)rect.UpperLeftCorner.Y;
-
-		// calc text algin vertial
-		if (TextVertical == EGUIVerticalAlign::Middle)
-			y = y + ((int)m_lastHeight - textHeight - m_textOffsetY) / 2;
-		else if (TextVertical == EGUIVerticalAlign::Bottom)
-			y = y + (int)m_lastHeight - textHeight;
-
-		if (m_centerRotate == true)
-			y = y - textHeight / 2;
-
-		// render
-		for (int i = 0, n = (int)m_arrayCharRender.size(); i < n; i++)
-		{
-			// render text
-			renderText(m_arrayCharRender[i], m_arrayCharFormat[i], x, y, i);
-
-			// new line
-			y += (m_textHeight + m_linePadding);
-		}
-
-		CGUIElement::render(camera);
 	}
 
 	void CGUIText::renderText(ArrayModuleOffset& string, ArrayInt& stringFormat, int posX, int posY, int line)
@@ -868,6 +934,8 @@ namespace Skylicht
 		}
 #endif
 
+		int shaderID = getTextShaderID();
+
 		// render string
 		for (int i = 0; i < numCharacter; i++)
 		{
@@ -880,9 +948,9 @@ namespace Skylicht
 
 			// render text with base color if format = 0
 			if (format == 0)
-				g->addModuleBatch(moduleOffset, getColor(), m_transform->World, (float)x, (float)y, getShaderID(), getMaterial());
+				g->addModuleBatch(moduleOffset, getColor(), m_transform->World, (float)x, (float)y, shaderID, getMaterial());
 			else
-				g->addModuleBatch(moduleOffset, m_colorFormat[format], m_transform->World, (float)x, (float)y, getShaderID(), getMaterial());
+				g->addModuleBatch(moduleOffset, m_colorFormat[format], m_transform->World, (float)x, (float)y, shaderID, getMaterial());
 
 			if (moduleOffset->Character == ' ')
 				x += ((int)moduleOffset->XAdvance + m_charSpacePadding);
@@ -104,6 +104,12 @@ namespace Skylicht
 		float m_lastWidth;
 		float m_lastHeight;
 
+		u32 m_atlasVersion;
+		u32 m_layoutVersion;
+
+		int m_alphaShader;
+		int m_sdfShader;
+
 #ifdef HAVE_CARET
 		bool m_showCaret;
 		int m_caretShader;
@@ -124,12 +130,36 @@ namespace Skylicht
 	public:
 		virtual ~CGUIText();
 
+		virtual void update(CCamera* camera);
+
 		virtual void render(CCamera* camera);
 
+		virtual bool isRenderCacheable()
+		{
+#ifdef HAVE_CARET
+			// the caret is blinking
+			return !m_showCaret;
+#else
+			return true;
+#endif
+		}
+
+		/**
+		* @brief Lay out the text if it is changed, the version changes when the text, the font or the glyph atlas (CGlyphFreetype::getAtlasVersion) changes.
+		*/
+		virtual u32 getRenderCacheVersion();
+
+		virtual bool isRenderInsideRect()
+		{
+			// the text can overflow the rect
+			return false;
+		}
+
 		void setTextAlign(EGUIHorizontalAlign h, EGUIVerticalAlign v)
 		{
 			TextVertical = v;
 			TextHorizontal = h;
+			notifyChanged();
 		}
 
 		/*
@@ -148,6 +178,7 @@ namespace Skylicht
 		{
 			if (id < MAX_FORMATCOLOR)
 				m_colorFormat[id] = c;
+			notifyChanged();
 		}
 
 		void setText(const char* text);
@@ -201,21 +232,25 @@ namespace Skylicht
 		{
 			m_charPadding = charPadding;
 			m_charSpacePadding = charPadding;
+			m_updateTextRender = true;
 		}
 
 		inline void setLinePadding(int linePadding)
 		{
 			m_linePadding = linePadding;
+			notifyChanged();
 		}
 
 		inline void setMultiLine(bool b)
 		{
 			m_multiLine = b;
+			m_updateTextRender = true;
 		}
 
 		inline void setCenterRotate(bool b)
 		{
 			m_centerRotate = b;
+			notifyChanged();
 		}
 
 		void setFontSource(const char* fontSource);
@@ -237,12 +272,14 @@ namespace Skylicht
 		inline void showCaret(bool b)
 		{
 			m_showCaret = b;
+			notifyChanged();
 		}
 
 		inline void setCaret(int line, int character)
 		{
 			m_caret.set(character, line);
 			m_caretBlink = 0.0f;
+			notifyChanged();
 		}
 
 		void setCaret(int charPos);
@@ -279,6 +316,8 @@ namespace Skylicht
 		void updateSetCaret();
 #endif
 
+		void updateLayout();
+
 		void updateSplitText();
 
 		void splitText(std::vector<ArrayModuleOffset>& split, std::vector<ArrayInt>& format, std::vector<ArrayInt>& id, int width);
@@ -288,5 +327,7 @@ namespace Skylicht
 		void initFont(IFont* font);
 
 		IFont* getCurrentFont();
+
+		int getTextShaderID();
 	};
 }
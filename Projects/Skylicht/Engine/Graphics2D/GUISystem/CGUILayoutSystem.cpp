@@ -44,6 +44,7 @@ namespace Skylicht
 		m_guiAlign.reset();
 		m_guiLayout.reset();
 		m_parentLayout.reset();
+		m_changedBounds.reset();
 	}
 
 	void CGUILayoutSystem::onQuery(CEntityManager* entityManager, CEntity** entities, int count)
@@ -406,6 +407,12 @@ namespace Skylicht
 			CWorldTransformData* w = transforms[i];
 			CGUITransformData* t = guiTransforms[i];
 
+			// the dock layout can resize the rect without notify
+			if (w->HasChanged || t->Rect != t->m_boundsRect)
+			{
+				m_changedBounds.push(t);
+			}
+
 			if (w->HasChanged)
 			{
 				// update relative matrix
@@ -447,5 +454,36 @@ namespace Skylicht
 				w->HasChanged = false;
 			}
 		}
+
+		// compute the bounds with the new world matrix
+		CGUITransformData** changed = m_changedBounds.pointer();
+		for (int i = 0, n = m_changedBounds.count(); i < n; i++)
+		{
+			CGUITransformData* t = changed[i];
+			updateBounds(GET_ENTITY_DATA(t->Entity, CWorldTransformData), t);
+		}
+	}
+
+	void CGUILayoutSystem::updateBounds(CWorldTransformData* w, CGUITransformData* t)
+	{
+		const core::rectf& r = t->Rect;
+
+		core::vector3df p[4];
+		p[0].set(r.UpperLeftCorner.X, r.UpperLeftCorner.Y, 0.0f);
+		p[1].set(r.LowerRightCorner.X, r.UpperLeftCorner.Y, 0.0f);
+		p[2].set(r.UpperLeftCorner.X, r.LowerRightCorner.Y, 0.0f);
+		p[3].set(r.LowerRightCorner.X, r.LowerRightCorner.Y, 0.0f);
+
+		w->World.transformVect(p[0]);
+
+		core::rectf bounds(p[0].X, p[0].Y, p[0].X, p[0].Y);
+		for (int i = 1; i < 4; i++)
+		{
+			w->World.transformVect(p[i]);
+			bounds.addInternalPoint(p[i].X, p[i].Y);
+		}
+
+		t->Bounds = bounds;
+		t->m_boundsRect = r;
 	}
 }
\ No newline at end of file
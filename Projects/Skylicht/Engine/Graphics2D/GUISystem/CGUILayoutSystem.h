@@ -42,6 +42,8 @@ namespace Skylicht
 		CFastArray<CGUILayoutData*> m_parentLayout;
 		CFastArray<CGUIChildLayoutData*> m_guiLayout;
 
+		CFastArray<CGUITransformData*> m_changedBounds;
+
 	public:
 		CGUILayoutSystem();
 
@@ -55,6 +57,14 @@ namespace Skylicht
 
 		virtual void update(CEntityManager* entityManager);
 
+		/**
+		* @brief The elements that their Bounds changed on the last update.
+		*/
+		inline CFastArray<CGUITransformData*>& getChangedBounds()
+		{
+			return m_changedBounds;
+		}
+
 	protected:
 
 		void updateLayout();
@@ -67,5 +77,7 @@ namespace Skylicht
 
 		void updateTransform();
 
+		void updateBounds(CWorldTransformData* w, CGUITransformData* t);
+
 	};
 }
\ No newline at end of file
@@ -25,6 +25,9 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CGlyphFreetype.h"
 
+#include <thread>
+#include <chrono>
+
 // From SDL_ttf: Handy routines for converting from fixed point
 #define FT_CEIL(X)  (((X + 63) & -64) / 64)
 
@@ -65,7 +68,14 @@ namespace Skylicht
 
 	CGlyphFreetype::CGlyphFreetype() :
 		m_width(1024),
-		m_height(1024)
+		m_height(1024),
+		m_maxAtlas(0),
+		m_atlasVersion(0),
+		m_useTime(0),
+		m_sdfSize(32),
+		m_sdfSpread(4),
+		m_thread(NULL),
+		m_numRaster(0)
 	{
 #ifdef FT2_BUILD_LIBRARY
 		int error = FT_Init_FreeType(&m_lib);
@@ -78,6 +88,15 @@ namespace Skylicht
 
 	CGlyphFreetype::~CGlyphFreetype()
 	{
+		if (m_thread)
+		{
+			m_thread->stop();
+			delete m_thread;
+			m_thread = NULL;
+		}
+
+		clearRasterQueue();
+
 		for (CAtlas* a : m_atlas)
 			delete a;
 		m_atlas.clear();
@@ -117,7 +136,12 @@ namespace Skylicht
 			readFile->read(data, dataSize);
 
 			FT_Face face = NULL;
-			FT_Error error = FT_New_Memory_Face(m_lib, data, dataSize, 0, &face);
+			FT_Error error;
+			{
+				std::lock_guard<std::mutex> lock(m_freetypeLock);
+				error = FT_New_Memory_Face(m_lib, data, dataSize, 0, &face);
+			}
+
 			if (error != 0)
 			{
 				char log[512];
@@ -125,6 +149,7 @@ namespace Skylicht
 				os::Printer::log(log);
 
 				delete[]data;
+				readFile->drop();
 				return false;
 			}
 
@@ -145,6 +170,9 @@ namespace Skylicht
 
 	void CGlyphFreetype::clearAtlas()
 	{
+		// the glyphs in the queue are deleted with the glyph entity
+		clearRasterQueue();
+
 		for (CAtlas* a : m_atlas)
 			delete a;
 		m_atlas.clear();
@@ -153,6 +181,28 @@ namespace Skylicht
 			i->second->cleanGlyphEntity();
 
 		addEmptyAtlas(ECF_A8R8G8B8, m_width, m_height);
+
+		m_atlasVersion++;
+	}
+
+	void CGlyphFreetype::clearRasterQueue()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_queueLock);
+			m_queue.clear();
+		}
+
+		// wait the glyph that the raster thread is running, it uses the face
+		for (SGlyphEntity* ge : m_pendingGlyphs)
+		{
+			if (ge->m_raster)
+			{
+				while (ge->m_raster->State.load(std::memory_order_acquire) == SGlyphRaster::Running)
+					std::this_thread::yield();
+			}
+		}
+
+		m_pendingGlyphs.clear();
 	}
 
 	int CGlyphFreetype::sizePtToPx(float pt)
@@ -165,55 +215,33 @@ namespace Skylicht
 		return ((float)px * (6.0f / 8.0f));
 	}
 
+	SFaceEntity* CGlyphFreetype::getFace(const char* name)
+	{
+		std::map<std::string, SFaceEntity*>::iterator i = m_faceEntity.find(name);
+		if (i == m_faceEntity.end())
+			return NULL;
+		return i->second;
+	}
+
 	CAtlas* CGlyphFreetype::getCharImage(unsigned short code,
 		const char* name,
 		int fontSize,
 		float* advance,
 		float* uvX, float* uvY, float* uvW, float* uvH, float* offsetX, float* offsetY)
 	{
-#ifdef FT2_BUILD_LIBRARY
-		SFaceEntity* fe = m_faceEntity[name];
-		if (fe == NULL)
-			return NULL;
-
-		u32 key = (fontSize << 16) | code;
-		SGlyphEntity* ge = fe->m_ge[key];
+		SGlyphEntity* ge = NULL;
 
-		if (ge == NULL)
+		SFaceEntity* fe = getFace(name);
+		if (fe != NULL)
 		{
-			FT_Size_RequestRec req;
-			req.type = FT_SIZE_REQUEST_TYPE_REAL_DIM;
-			req.width = 0;
-			req.height = (uint32_t)fontSize * 64;
-			req.horiResolution = 0;
-			req.vertResolution = 0;
-			FT_Request_Size(fe->m_face, &req);
-
-			if (FT_Load_Char(fe->m_face, code, FT_LOAD_RENDER))
-				return NULL;
-
-			const FT_GlyphSlot& g = fe->m_face->glyph;
-			int atlasID = putGlyphToTexture(g, uvX, uvY, uvW, uvH);
-
-			ge = new SGlyphEntity();
-			ge->m_atlas = m_atlas[atlasID];
-			ge->m_advance = (float)FT_CEIL(g->advance.x);
-			ge->m_uvX = *uvX;
-			ge->m_uvY = *uvY;
-			ge->m_uvW = *uvW;
-			ge->m_uvH = *uvH;
-
-			// Glyph metrics
-			// https://docs.microsoft.com/en-us/typography/opentype/spec/gpos
-			float height = (float)FT_CEIL(g->metrics.vertAdvance);
-			ge->m_offsetX = (float)FT_CEIL(g->metrics.horiBearingX);
-			ge->m_offsetY = -(float)FT_CEIL(g->metrics.horiBearingY) + height;
-
-			fe->m_ge[key] = ge;
+			ge = requestGlyph(fe, code, fontSize, false, false);
+			finishGlyph(ge);
 		}
 
-		if (ge != NULL)
+		if (ge != NULL && ge->m_atlas != NULL)
 		{
+			touchAtlas(ge->m_atlas);
+
 			*uvX = ge->m_uvX;
 			*uvY = ge->m_uvY;
 			*uvW = ge->m_uvW;
@@ -223,19 +251,8 @@ namespace Skylicht
 			*offsetY = ge->m_offsetY;
 			return ge->m_atlas;
 		}
-		else
-		{
-			*uvX = 0;
-			*uvY = 0;
-			*uvW = 0;
-			*uvH = 0;
-			*advance = 0;
-			*offsetX = 0;
-			*offsetY = 0;
-			return NULL;
-		}
-#else
-		* uvX = 0;
+
+		*uvX = 0;
 		*uvY = 0;
 		*uvW = 0;
 		*uvH = 0;
@@ -243,7 +260,6 @@ namespace Skylicht
 		*offsetX = 0;
 		*offsetY = 0;
 		return NULL;
-#endif
 	}
 
 	CAtlas* CGlyphFreetype::getCharImage(
@@ -258,49 +274,19 @@ namespace Skylicht
 		float* uvH,
 		float* offsetX, float* offsetY)
 	{
-#ifdef FT2_BUILD_LIBRARY
-		SFaceEntity* fe = m_faceEntity[name];
-		if (fe == NULL)
-			return NULL;
-
-		u32 key = (fontSize << 16) | code;
-		SGlyphEntity* ge = fe->m_ge[key];
+		SGlyphEntity* ge = NULL;
 
-		if (ge == NULL)
+		SFaceEntity* fe = getFace(name);
+		if (fe != NULL)
 		{
-			FT_Size_RequestRec req;
-			req.type = FT_SIZE_REQUEST_TYPE_REAL_DIM;
-			req.width = 0;
-			req.height = (uint32_t)fontSize * 64;
-			req.horiResolution = 0;
-			req.vertResolution = 0;
-			FT_Request_Size(fe->m_face, &req);
-
-			if (FT_Load_Char(fe->m_face, code, FT_LOAD_RENDER))
-				return NULL;
-
-			const FT_GlyphSlot& g = fe->m_face->glyph;
-			CAtlas* atlas = putGlyphToTexture(external, g, uvX, uvY, uvW, uvH);
-
-			ge = new SGlyphEntity();
-			ge->m_atlas = atlas;
-			ge->m_advance = (float)FT_CEIL(g->advance.x);
-			ge->m_uvX = *uvX;
-			ge->m_uvY = *uvY;
-			ge->m_uvW = *uvW;
-			ge->m_uvH = *uvH;
-
-			// Glyph metrics
-			// https://docs.microsoft.com/en-us/typography/opentype/spec/gpos
-			float height = (float)FT_CEIL(g->metrics.vertAdvance);
-			ge->m_offsetX = (float)FT_CEIL(g->metrics.horiBearingX);
-			ge->m_offsetY = -(float)FT_CEIL(g->metrics.horiBearingY) + height;
-
-			fe->m_ge[key] = ge;
+			ge = requestGlyph(fe, code, fontSize, false, false);
+			finishGlyph(ge, external);
 		}
 
-		if (ge != NULL)
+		if (ge != NULL && ge->m_atlas != NULL)
 		{
+			touchAtlas(ge->m_atlas);
+
 			*uvX = ge->m_uvX;
 			*uvY = ge->m_uvY;
 			*uvW = ge->m_uvW;
@@ -310,35 +296,369 @@ namespace Skylicht
 			*offsetY = ge->m_offsetY;
 			return ge->m_atlas;
 		}
-		else
+
+		*uvX = 0;
+		*uvY = 0;
+		*uvW = 0;
+		*uvH = 0;
+		*advance = 0;
+		*offsetX = 0;
+		*offsetY = 0;
+		return NULL;
+	}
+
+	CAtlas* CGlyphFreetype::getCharImageSDF(unsigned short code,
+		const char* name,
+		int fontSize,
+		float* advance,
+		float* uvX, float* uvY, float* uvW, float* uvH, float* offsetX, float* offsetY,
+		float* scale)
+	{
+		SGlyphEntity* ge = NULL;
+
+		SFaceEntity* fe = getFace(name);
+		if (fe != NULL)
 		{
-			*uvX = 0;
-			*uvY = 0;
-			*uvW = 0;
-			*uvH = 0;
-			*advance = 0;
-			*offsetX = 0;
-			*offsetY = 0;
-			return NULL;
+			ge = requestGlyph(fe, code, m_sdfSize, true, false);
+			finishGlyph(ge);
+		}
+
+		if (ge != NULL && ge->m_atlas != NULL)
+		{
+			touchAtlas(ge->m_atlas);
+
+			// the metrics are at m_sdfSize
+			float s = (float)fontSize / (float)m_sdfSize;
+
+			*uvX = ge->m_uvX;
+			*uvY = ge->m_uvY;
+			*uvW = ge->m_uvW;
+			*uvH = ge->m_uvH;
+			*advance = core::round_(ge->m_advance * s);
+			*offsetX = ge->m_offsetX * s;
+			*offsetY = ge->m_offsetY * s;
+			*scale = s;
+			return ge->m_atlas;
 		}
-#else
-		* uvX = 0;
+
+		*uvX = 0;
 		*uvY = 0;
 		*uvW = 0;
 		*uvH = 0;
 		*advance = 0;
 		*offsetX = 0;
 		*offsetY = 0;
+		*scale = 1.0f;
 		return NULL;
-#endif
 	}
 
+	int CGlyphFreetype::prewarm(const char* name, const wchar_t* text, int fontSize, bool sdf)
+	{
+		SFaceEntity* fe = getFace(name);
+		if (fe == NULL || text == NULL)
+			return 0;
+
+		int count = 0;
+		int size = sdf ? m_sdfSize : fontSize;
+
+		CGlyphHashMap<SGlyphEntity>& glyphs = sdf ? fe->m_sdfGe : fe->m_ge;
+
+		for (const wchar_t* c = text; *c != 0; c++)
+		{
+			unsigned short code = (unsigned short)*c;
+			u32 key = sdf ? code : (((u32)size << 16) | code);
+
+			if (glyphs.get(key) == NULL)
+			{
+				requestGlyph(fe, code, size, sdf, true);
+				count++;
+			}
+		}
+
+		if (count > 0 && m_thread == NULL)
+			m_thread = System::IThread::createThread(this);
+
+		return count;
+	}
+
+	void CGlyphFreetype::updateRasterQueue()
+	{
+		int n = 0;
+
+		for (SGlyphEntity* ge : m_pendingGlyphs)
+		{
+			if (ge->m_raster && ge->m_raster->State.load(std::memory_order_acquire) < SGlyphRaster::Done)
+			{
+				// not done, check it next time
+				m_pendingGlyphs[n++] = ge;
+				continue;
+			}
+
+			finishGlyph(ge);
+		}
+
+		m_pendingGlyphs.resize(n);
+	}
+
+	void CGlyphFreetype::waitRasterQueue()
+	{
+		for (SGlyphEntity* ge : m_pendingGlyphs)
+			finishGlyph(ge);
+
+		m_pendingGlyphs.clear();
+	}
+
+	void CGlyphFreetype::updateThread()
+	{
+		std::shared_ptr<SGlyphRaster> r;
+
+		{
+			std::unique_lock<std::mutex> lock(m_queueLock);
+
+			// wake up sometime to let the thread stop
+			if (m_queue.empty())
+				m_queueSignal.wait_for(lock, std::chrono::milliseconds(10));
+
+			if (m_queue.empty())
+				return;
+
+			r = m_queue.front();
+			m_queue.pop_front();
+		}
+
+		// the main thread can take this glyph first
+		int state = SGlyphRaster::Queued;
+		if (r->State.compare_exchange_strong(state, SGlyphRaster::Running, std::memory_order_acq_rel))
+			rasterGlyph(r.get());
+	}
+
+	SGlyphEntity* CGlyphFreetype::requestGlyph(SFaceEntity* fe, unsigned short code, int fontSize, bool sdf, bool async)
+	{
+		CGlyphHashMap<SGlyphEntity>& glyphs = sdf ? fe->m_sdfGe : fe->m_ge;
+		u32 key = sdf ? code : (((u32)fontSize << 16) | code);
+
+		SGlyphEntity* ge = glyphs.get(key);
+		if (ge != NULL)
+			return ge;
+
+		ge = new SGlyphEntity();
+		ge->m_raster = std::make_shared<SGlyphRaster>();
+		ge->m_raster->Face = fe;
+		ge->m_raster->Code = code;
+		ge->m_raster->Size = fontSize;
+		ge->m_raster->SDF = sdf;
+
+		glyphs.set(key, ge);
+
+		if (async)
+		{
+			m_pendingGlyphs.push_back(ge);
+
+			std::lock_guard<std::mutex> lock(m_queueLock);
+			m_queue.push_back(ge->m_raster);
+			m_queueSignal.notify_one();
+		}
+
+		return ge;
+	}
+
+	void CGlyphFreetype::finishGlyph(SGlyphEntity* ge, CSpriteAtlas* external)
+	{
+		if (!ge->m_raster)
+			return;
+
+		SGlyphRaster* r = ge->m_raster.get();
+
+		// rasterize now if the raster thread has not taken it
+		int state = SGlyphRaster::Queued;
+		if (r->State.compare_exchange_strong(state, SGlyphRaster::Running, std::memory_order_acq_rel))
+			rasterGlyph(r);
+
+		while (r->State.load(std::memory_order_acquire) == SGlyphRaster::Running)
+			std::this_thread::yield();
+
+		if (r->State.load(std::memory_order_acquire) == SGlyphRaster::Done)
+		{
+			const u8* alpha = r->Alpha.size() > 0 ? r->Alpha.data() : NULL;
+
+			if (external != NULL)
+				ge->m_atlas = putGlyphToTexture(external, alpha, r->Width, r->Height, &ge->m_uvX, &ge->m_uvY, &ge->m_uvW, &ge->m_uvH, &ge->m_region);
+			else
+				ge->m_atlas = m_atlas[putGlyphToTexture(alpha, r->Width, r->Height, &ge->m_uvX, &ge->m_uvY, &ge->m_uvW, &ge->m_uvH, &ge->m_region)];
+
+			// Glyph metrics
+			// https://docs.microsoft.com/en-us/typography/opentype/spec/gpos
+			ge->m_advance = r->Advance;
+			ge->m_offsetX = r->BearingX;
+			ge->m_offsetY = -r->BearingY + r->VertAdvance;
+		}
+
+		ge->m_raster.reset();
+	}
+
+	void CGlyphFreetype::rasterGlyph(SGlyphRaster* r)
+	{
+		bool success = false;
+
 #ifdef FT2_BUILD_LIBRARY
-	int CGlyphFreetype::putGlyphToTexture(const FT_GlyphSlot& glyph, float* uvX, float* uvY, float* uvW, float* uvH)
+		{
+			std::lock_guard<std::mutex> lock(m_freetypeLock);
+
+			FT_Face face = r->Face->m_face;
+
+			FT_Size_RequestRec req;
+			req.type = FT_SIZE_REQUEST_TYPE_REAL_DIM;
+			req.width = 0;
+			req.height = (uint32_t)r->Size * 64;
+			req.horiResolution = 0;
+			req.vertResolution = 0;
+			FT_Request_Size(face, &req);
+
+			if (FT_Load_Char(face, r->Code, FT_LOAD_RENDER) == 0)
+			{
+				const FT_GlyphSlot& g = face->glyph;
+
+				r->Width = g->bitmap.width;
+				r->Height = g->bitmap.rows;
+				r->Alpha.resize(r->Width * r->Height);
+
+				for (int y = 0; y < r->Height; y++)
+					memcpy(r->Alpha.data() + y * r->Width, g->bitmap.buffer + y * g->bitmap.pitch, r->Width);
+
+				if (r->SDF)
+				{
+					// the SDF glyph is scaled, so keep the sub pixel metrics
+					r->Advance = g->advance.x / 64.0f;
+					r->BearingX = g->metrics.horiBearingX / 64.0f;
+					r->BearingY = g->metrics.horiBearingY / 64.0f;
+					r->VertAdvance = g->metrics.vertAdvance / 64.0f;
+				}
+				else
+				{
+					r->Advance = (float)FT_CEIL(g->advance.x);
+					r->BearingX = (float)FT_CEIL(g->metrics.horiBearingX);
+					r->BearingY = (float)FT_CEIL(g->metrics.horiBearingY);
+					r->VertAdvance = (float)FT_CEIL(g->metrics.vertAdvance);
+				}
+
+				success = true;
+			}
+		}
+
+		// the distance field is out of the FreeType lock
+		if (success && r->SDF)
+			generateSDF(r, m_sdfSpread);
+#endif
+
+		m_numRaster++;
+		r->State.store(success ? SGlyphRaster::Done : SGlyphRaster::Failed, std::memory_order_release);
+	}
+
+	// the squared distance transform of a row or a column
+	// Felzenszwalb & Huttenlocher, Distance Transforms of Sampled Functions
+	static void edt1d(float* f, int offset, int stride, int n, float* d, int* v, float* z)
 	{
-		int glyphW = glyph->bitmap.width;
-		int glyphH = glyph->bitmap.rows;
+		const float inf = 1e20f;
 
+		v[0] = 0;
+		z[0] = -inf;
+		z[1] = inf;
+
+		for (int i = 0; i < n; i++)
+			d[i] = f[offset + i * stride];
+
+		for (int q = 1, k = 0; q < n; q++)
+		{
+			float s = ((d[q] + q * q) - (d[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+			while (s <= z[k])
+			{
+				k--;
+				s = ((d[q] + q * q) - (d[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+			}
+
+			k++;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = inf;
+		}
+
+		for (int q = 0, k = 0; q < n; q++)
+		{
+			while (z[k + 1] < q)
+				k++;
+
+			float dq = (float)(q - v[k]);
+			f[offset + q * stride] = dq * dq + d[v[k]];
+		}
+	}
+
+	static void edt2d(float* grid, int w, int h)
+	{
+		int n = core::max_(w, h);
+
+		std::vector<float> d(n);
+		std::vector<int> v(n);
+		std::vector<float> z(n + 1);
+
+		for (int x = 0; x < w; x++)
+			edt1d(grid, x, w, h, d.data(), v.data(), z.data());
+
+		for (int y = 0; y < h; y++)
+			edt1d(grid, y * w, 1, w, d.data(), v.data(), z.data());
+	}
+
+	void CGlyphFreetype::generateSDF(SGlyphRaster* r, int spread)
+	{
+		int w = r->Width + spread * 2;
+		int h = r->Height + spread * 2;
+
+		const float inf = 1e20f;
+
+		std::vector<float> outside(w * h, inf);
+		std::vector<float> inside(w * h, 0.0f);
+
+		// the anti-aliased coverage gives the sub pixel edge
+		for (int y = 0; y < r->Height; y++)
+		{
+			for (int x = 0; x < r->Width; x++)
+			{
+				float a = r->Alpha[y * r->Width + x] / 255.0f;
+				int i = (y + spread) * w + x + spread;
+
+				if (a >= 1.0f)
+				{
+					outside[i] = 0.0f;
+					inside[i] = inf;
+				}
+				else if (a > 0.0f)
+				{
+					float d = 0.5f - a;
+					outside[i] = d > 0.0f ? d * d : 0.0f;
+					inside[i] = d < 0.0f ? d * d : 0.0f;
+				}
+			}
+		}
+
+		edt2d(outside.data(), w, h);
+		edt2d(inside.data(), w, h);
+
+		// 0.5 is the edge, > 0.5 is inside
+		r->Alpha.resize(w * h);
+		for (int i = 0, n = w * h; i < n; i++)
+		{
+			float d = sqrtf(outside[i]) - sqrtf(inside[i]);
+			float value = 0.5f - d / (2.0f * spread);
+			r->Alpha[i] = (u8)(core::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+		r->Width = w;
+		r->Height = h;
+		r->BearingX -= spread;
+		r->BearingY += spread;
+	}
+
+	int CGlyphFreetype::putGlyphToTexture(const u8* alpha, int glyphW, int glyphH, float* uvX, float* uvY, float* uvW, float* uvH, core::recti* outRegion)
+	{
 		int cellW = glyphW;
 		int cellH = glyphH;
 
@@ -360,12 +680,22 @@ namespace Skylicht
 
 		if (atlasID == -1)
 		{
-			addEmptyAtlas(ECF_A8R8G8B8, m_width, m_height);
+			if (m_maxAtlas > 0 && (int)m_atlas.size() >= m_maxAtlas)
+			{
+				atlasID = evictAtlas();
+			}
+			else
+			{
+				addEmptyAtlas(ECF_A8R8G8B8, m_width, m_height);
+				atlasID = (int)(m_atlas.size() - 1);
+			}
 
-			atlasID = (int)(m_atlas.size() - 1);
 			region = m_atlas[atlasID]->createRect(cellW, cellH);
 		}
 
+		touchAtlas(m_atlas[atlasID]);
+		*outRegion = region;
+
 		// draw character at region
 		int x = region.UpperLeftCorner.X;
 		int y = region.UpperLeftCorner.Y;
@@ -378,7 +708,8 @@ namespace Skylicht
 		*uvW = glyphW / (float)m_width;
 		*uvH = glyphH / (float)m_height;
 
-		unsigned char* alpha = glyph->bitmap.buffer;
+		if (alpha == NULL || glyphW == 0 || glyphH == 0)
+			return atlasID;
 
 		// need convert to A8R8G8B8
 		IImage* img = getVideoDriver()->createImage(ECF_A8R8G8B8, core::dimension2du(glyphW, glyphH));
@@ -402,11 +733,8 @@ namespace Skylicht
 		return atlasID;
 	}
 
-	CAtlas* CGlyphFreetype::putGlyphToTexture(CSpriteAtlas* external, const FT_GlyphSlot& glyph, float* uvX, float* uvY, float* uvW, float* uvH)
+	CAtlas* CGlyphFreetype::putGlyphToTexture(CSpriteAtlas* external, const u8* alpha, int glyphW, int glyphH, float* uvX, float* uvY, float* uvW, float* uvH, core::recti* outRegion)
 	{
-		int glyphW = glyph->bitmap.width;
-		int glyphH = glyph->bitmap.rows;
-
 		int cellW = glyphW;
 		int cellH = glyphH;
 
@@ -419,6 +747,7 @@ namespace Skylicht
 			return NULL;
 
 		CAtlas* atlas = imageAtlas->Atlas;
+		*outRegion = region;
 
 		// draw character at region
 		int x = region.UpperLeftCorner.X;
@@ -432,7 +761,8 @@ namespace Skylicht
 		*uvW = glyphW / (float)m_width;
 		*uvH = glyphH / (float)m_height;
 
-		unsigned char* alpha = glyph->bitmap.buffer;
+		if (alpha == NULL || glyphW == 0 || glyphH == 0)
+			return atlas;
 
 		// need convert to A8R8G8B8
 		IImage* img = getVideoDriver()->createImage(ECF_A8R8G8B8, core::dimension2du(glyphW, glyphH));
@@ -455,7 +785,190 @@ namespace Skylicht
 
 		return atlas;
 	}
-#endif
+
+	int CGlyphFreetype::evictAtlas()
+	{
+		// the least recently used atlas
+		int atlasID = 0;
+		for (int i = 1, n = (int)m_atlas.size(); i < n; i++)
+		{
+			if (m_atlas[i]->getLastUsed() < m_atlas[atlasID]->getLastUsed())
+				atlasID = i;
+		}
+
+		CAtlas* atlas = m_atlas[atlasID];
+
+		auto onAtlas = [atlas](SGlyphEntity* ge)
+		{
+			if (ge->m_atlas != atlas)
+				return false;
+
+			delete ge;
+			return true;
+		};
+
+		u32 count = 0;
+		for (std::map<std::string, SFaceEntity*>::iterator i = m_faceEntity.begin(), end = m_faceEntity.end(); i != end; i++)
+		{
+			count += i->second->m_ge.removeIf(onAtlas);
+			count += i->second->m_sdfGe.removeIf(onAtlas);
+		}
+
+		atlas->clear();
+		m_atlasVersion++;
+
+		char log[512];
+		sprintf(log, "[CGlyphFreetype] evict atlas %d: %d glyphs", atlasID, count);
+		os::Printer::log(log);
+
+		return atlasID;
+	}
+
+	void CGlyphFreetype::releaseGlyph(SGlyphEntity* ge)
+	{
+		if (ge->m_atlas != NULL)
+			ge->m_atlas->releaseRect(ge->m_region);
+
+		delete ge;
+	}
+
+	int CGlyphFreetype::removeGlyphs(const char* name, int fontSize, bool sdf)
+	{
+		SFaceEntity* fe = getFace(name);
+		if (fe == NULL)
+			return 0;
+
+		// the queued glyphs are in the atlas before they are removed
+		waitRasterQueue();
+
+		u32 count = 0;
+
+		if (sdf)
+		{
+			count = fe->m_sdfGe.size();
+			fe->m_sdfGe.forEach([this](SGlyphEntity* ge) { releaseGlyph(ge); });
+			fe->m_sdfGe.clear();
+		}
+		else
+		{
+			std::vector<u32> keys;
+			fe->m_ge.forEachItem([&keys, fontSize](u32 key, SGlyphEntity* ge)
+				{
+					if ((int)(key >> 16) == fontSize)
+						keys.push_back(key);
+				});
+
+			for (u32 key : keys)
+			{
+				releaseGlyph(fe->m_ge.get(key));
+				fe->m_ge.remove(key);
+			}
+
+			count = (u32)keys.size();
+		}
+
+		if (count > 0)
+			m_atlasVersion++;
+
+		return (int)count;
+	}
+
+	int CGlyphFreetype::defragment()
+	{
+		waitRasterQueue();
+
+		// the glyphs on the atlas of this object, the glyphs on the external atlas are not moved
+		std::map<CAtlas*, int> atlasID;
+		for (int i = 0, n = (int)m_atlas.size(); i < n; i++)
+			atlasID[m_atlas[i]] = i;
+
+		std::vector<SGlyphEntity*> glyphs;
+
+		auto onAtlas = [&glyphs, &atlasID](SGlyphEntity* ge)
+		{
+			if (ge->m_atlas != NULL && atlasID.find(ge->m_atlas) != atlasID.end())
+				glyphs.push_back(ge);
+		};
+
+		for (std::map<std::string, SFaceEntity*>::iterator i = m_faceEntity.begin(), end = m_faceEntity.end(); i != end; i++)
+		{
+			i->second->m_ge.forEach(onAtlas);
+			i->second->m_sdfGe.forEach(onAtlas);
+		}
+
+		if (glyphs.size() == 0)
+			return 0;
+
+		// keep the old pixels, then clear the atlas
+		IVideoDriver* driver = getVideoDriver();
+		std::vector<IImage*> oldImages;
+
+		for (CAtlas* atlas : m_atlas)
+		{
+			IImage* image = atlas->getImage();
+			IImage* copy = driver->createImage(image->getColorFormat(), image->getDimension());
+			image->copyTo(copy);
+			oldImages.push_back(copy);
+
+			atlas->clear();
+		}
+
+		// the taller glyphs first, the shelves are filled in order
+		std::sort(glyphs.begin(), glyphs.end(), [](SGlyphEntity* a, SGlyphEntity* b)
+			{
+				int ha = a->m_region.getHeight();
+				int hb = b->m_region.getHeight();
+				if (ha != hb)
+					return ha > hb;
+				return a->m_region.getWidth() > b->m_region.getWidth();
+			});
+
+		int moved = 0;
+
+		for (SGlyphEntity* ge : glyphs)
+		{
+			IImage* oldImage = oldImages[atlasID[ge->m_atlas]];
+			core::recti oldRegion = ge->m_region;
+
+			int w = oldRegion.getWidth();
+			int h = oldRegion.getHeight();
+
+			CAtlas* atlas = NULL;
+			core::recti region;
+
+			for (CAtlas* a : m_atlas)
+			{
+				region = a->createRect(w, h);
+				if (region.getWidth() != 0 && region.getHeight() != 0)
+				{
+					atlas = a;
+					break;
+				}
+			}
+
+			if (atlas == NULL)
+			{
+				atlas = addEmptyAtlas(ECF_A8R8G8B8, m_width, m_height);
+				region = atlas->createRect(w, h);
+			}
+
+			atlas->bitBltImage(oldImage, region.UpperLeftCorner.X, region.UpperLeftCorner.Y, oldRegion);
+
+			if (atlas != ge->m_atlas || region.UpperLeftCorner != oldRegion.UpperLeftCorner)
+				moved++;
+
+			ge->m_uvX += (region.UpperLeftCorner.X - oldRegion.UpperLeftCorner.X) / (float)m_width;
+			ge->m_uvY += (region.UpperLeftCorner.Y - oldRegion.UpperLeftCorner.Y) / (float)m_height;
+			ge->m_region = region;
+			ge->m_atlas = atlas;
+		}
+
+		for (IImage* image : oldImages)
+			image->drop();
+
+		m_atlasVersion++;
+		return moved;
+	}
 
 	CAtlas* CGlyphFreetype::addEmptyAtlas(ECOLOR_FORMAT color, int w, int h)
 	{
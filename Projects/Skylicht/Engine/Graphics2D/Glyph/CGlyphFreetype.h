@@ -30,11 +30,65 @@ https://github.com/skylicht-lab/skylicht-engine
 #endif
 
 #include "Utils/CSingleton.h"
+#include "Thread/IThread.h"
 #include "Graphics2D/Atlas/CAtlas.h"
 #include "Graphics2D/SpriteFrame/CSpriteAtlas.h"
+#include "CGlyphHashMap.h"
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <deque>
+#include <condition_variable>
 
 namespace Skylicht
 {
+	struct SFaceEntity;
+
+	/// @brief The bitmap of a glyph, it is rasterized on the raster thread (or the main thread) and put to the atlas on the main thread.
+	struct SGlyphRaster
+	{
+		enum EState
+		{
+			Queued = 0,
+			Running,
+			Done,
+			Failed
+		};
+
+		SFaceEntity* Face;
+		u32 Code;
+		int Size;
+		bool SDF;
+
+		std::atomic<int> State;
+
+		std::vector<u8> Alpha;
+		int Width;
+		int Height;
+
+		// metrics in pixel at Size
+		float Advance;
+		float BearingX;
+		float BearingY;
+		float VertAdvance;
+
+		SGlyphRaster() :
+			Face(NULL),
+			Code(0),
+			Size(0),
+			SDF(false),
+			State(Queued),
+			Width(0),
+			Height(0),
+			Advance(0.0f),
+			BearingX(0.0f),
+			BearingY(0.0f),
+			VertAdvance(0.0f)
+		{
+		}
+	};
+
 	struct SGlyphEntity
 	{
 		CAtlas* m_atlas;
@@ -45,6 +99,24 @@ namespace Skylicht
 		float m_uvH;
 		float m_offsetX;
 		float m_offsetY;
+
+		// the cell on the atlas
+		core::recti m_region;
+
+		// not NULL while the glyph is not in the atlas
+		std::shared_ptr<SGlyphRaster> m_raster;
+
+		SGlyphEntity() :
+			m_atlas(NULL),
+			m_advance(0.0f),
+			m_uvX(0.0f),
+			m_uvY(0.0f),
+			m_uvW(0.0f),
+			m_uvH(0.0f),
+			m_offsetX(0.0f),
+			m_offsetY(0.0f)
+		{
+		}
 	};
 
 	struct SFaceEntity
@@ -54,7 +126,11 @@ namespace Skylicht
 		FT_Byte* m_data;
 #endif
 
-		std::map<u32, SGlyphEntity*> m_ge;
+		// key: (fontSize << 16) | code
+		CGlyphHashMap<SGlyphEntity> m_ge;
+
+		// key: code, the signed distance field glyph is used for all font sizes
+		CGlyphHashMap<SGlyphEntity> m_sdfGe;
 
 #ifdef FT2_BUILD_LIBRARY
 		SFaceEntity(FT_Face face, FT_Byte* data) :
@@ -73,13 +149,34 @@ namespace Skylicht
 
 		void cleanGlyphEntity()
 		{
-			for (std::map<u32, SGlyphEntity*>::iterator it = m_ge.begin(), end = m_ge.end(); it != end; ++it)
-				delete it->second;
+			m_ge.forEach([](SGlyphEntity* ge) { delete ge; });
 			m_ge.clear();
+
+			m_sdfGe.forEach([](SGlyphEntity* ge) { delete ge; });
+			m_sdfGe.clear();
 		}
 	};
 
-	class SKYLICHT_API CGlyphFreetype
+	/// @brief The object class rasterizes the glyphs of .ttf, .otf fonts by FreeType into the atlas textures.
+	/// @ingroup Graphics2D
+	///
+	/// The glyph can be a bitmap at a font size (getCharImage), or a signed distance field (getCharImageSDF) that is rasterized once at getSDFSize
+	/// and drawn at any font size with the "TextureColorSDF" shader.
+	///
+	/// Use prewarm to rasterize the characters of a text on the raster thread before they are drawn.
+	///
+	/// The number of atlas can be limited by setMaxAtlas, then the least recently used atlas is evicted when it is full.
+	/// removeGlyphs and defragment change the glyph rects, getAtlasVersion is changed and CGlyphFont updates its modules.
+	///
+	/// @code
+	/// CGlyphFreetype* freetype = CGlyphFreetype::getInstance();
+	/// freetype->initFont("Segoe UI", "BuiltIn/Fonts/segoeui/segoeui.ttf");
+	/// freetype->prewarm("Segoe UI", L"Localized text", 24, true);
+	/// ...
+	/// // each frame
+	/// freetype->updateRasterQueue();
+	/// @endcode
+	class SKYLICHT_API CGlyphFreetype : public System::IThreadCallback
 	{
 	public:
 		DECLARE_SINGLETON(CGlyphFreetype)
@@ -96,6 +193,28 @@ namespace Skylicht
 
 		std::vector<CAtlas*> m_atlas;
 
+		int m_maxAtlas;
+
+		u32 m_atlasVersion;
+
+		u32 m_useTime;
+
+		int m_sdfSize;
+		int m_sdfSpread;
+
+		// FT_Library and FT_Face are used on the main thread and the raster thread
+		std::mutex m_freetypeLock;
+
+		System::IThread* m_thread;
+
+		std::deque<std::shared_ptr<SGlyphRaster>> m_queue;
+		std::mutex m_queueLock;
+		std::condition_variable m_queueSignal;
+
+		std::vector<SGlyphEntity*> m_pendingGlyphs;
+
+		std::atomic<int> m_numRaster;
+
 	public:
 		CGlyphFreetype();
 
@@ -109,6 +228,75 @@ namespace Skylicht
 
 		static float sizePxToPt(int px);
 
+		/**
+		* @brief Set the pixel size that the SDF glyphs are rasterized, and the distance range in pixel. Call it before the SDF glyphs are created, or call clearAtlas.
+		*/
+		inline void setSDFSize(int size, int spread)
+		{
+			m_sdfSize = size;
+			m_sdfSpread = spread;
+		}
+
+		inline int getSDFSize()
+		{
+			return m_sdfSize;
+		}
+
+		inline int getSDFSpread()
+		{
+			return m_sdfSpread;
+		}
+
+		inline std::vector<CAtlas*>& getAtlas()
+		{
+			return m_atlas;
+		}
+
+		/**
+		* @brief Limit the number of atlas, 0 is no limit. When the atlas are full, the glyphs of the least recently used atlas are removed.
+		*/
+		inline void setMaxAtlas(int n)
+		{
+			m_maxAtlas = n;
+		}
+
+		inline int getMaxAtlas()
+		{
+			return m_maxAtlas;
+		}
+
+		/**
+		* @brief The version is changed when the glyphs are moved or removed from the atlas.
+		*/
+		inline u32 getAtlasVersion()
+		{
+			return m_atlasVersion;
+		}
+
+		/**
+		* @brief Mark the atlas is drawn, see setMaxAtlas.
+		*/
+		inline void touchAtlas(CAtlas* atlas)
+		{
+			atlas->setLastUsed(++m_useTime);
+		}
+
+		/**
+		* @brief The number of glyphs rasterized by FreeType, since the instance is created.
+		*/
+		inline int getNumRasterGlyph()
+		{
+			return m_numRaster.load();
+		}
+
+		/**
+		* @brief The number of prewarm glyphs that are not in the atlas yet.
+		*/
+		inline int getNumPendingGlyph()
+		{
+			return (int)m_pendingGlyphs.size();
+		}
+
 		CAtlas* getCharImage(unsigned short code,
 			const char* name,
 			int fontSize,
@@ -131,13 +319,72 @@ namespace Skylicht
 			float* uvH,
 			float* offsetX, float* offsetY);
 
+		/**
+		* @brief Get the signed distance field glyph, the metrics are at fontSize.
+		* @param scale The output of fontSize / getSDFSize, the size of the atlas rect on the screen.
+		*/
+		CAtlas* getCharImageSDF(unsigned short code,
+			const char* name,
+			int fontSize,
+			float* advance,
+			float* uvX,
+			float* uvY,
+			float* uvW,
+			float* uvH,
+			float* offsetX, float* offsetY,
+			float* scale);
+
+		/**
+		* @brief Queue the characters of the text to the raster thread.
+		* @return The number of new glyphs.
+		*/
+		int prewarm(const char* name, const wchar_t* text, int fontSize, bool sdf);
+
+		/**
+		* @brief Put the glyphs that the raster thread has done to the atlas.
+		*/
+		void updateRasterQueue();
+
+		/**
+		* @brief Wait all prewarm glyphs and put them to the atlas.
+		*/
+		void waitRasterQueue();
+
+		/**
+		* @brief Remove the glyphs of a font size (or all SDF glyphs of the font) and give back their rects on the atlas.
+		* @return The number of removed glyphs.
+		*/
+		int removeGlyphs(const char* name, int fontSize, bool sdf);
+
+		/**
+		* @brief Repack the glyphs on the atlas, the free space is moved to the last atlas.
+		* @return The number of moved glyphs.
+		*/
+		int defragment();
+
+		virtual void updateThread();
+
 	protected:
+		int evictAtlas();
+
+		void releaseGlyph(SGlyphEntity* ge);
+
 		CAtlas* addEmptyAtlas(ECOLOR_FORMAT color, int w, int h);
 
-#ifdef FT2_BUILD_LIBRARY
-		int putGlyphToTexture(const FT_GlyphSlot& glyph, float* uvx, float* uvy, float* uvW, float* uvH);
+		SFaceEntity* getFace(const char* name);
 
-		CAtlas* putGlyphToTexture(CSpriteAtlas* external, const FT_GlyphSlot& glyph, float* uvx, float* uvy, float* uvW, float* uvH);
-#endif
+		SGlyphEntity* requestGlyph(SFaceEntity* fe, unsigned short code, int fontSize, bool sdf, bool async);
+
+		void finishGlyph(SGlyphEntity* ge, CSpriteAtlas* external = NULL);
+
+		void rasterGlyph(SGlyphRaster* r);
+
+		void clearRasterQueue();
+
+		static void generateSDF(SGlyphRaster* r, int spread);
+
+		int putGlyphToTexture(const u8* alpha, int glyphW, int glyphH, float* uvx, float* uvy, float* uvW, float* uvH, core::recti* region);
+
+		CAtlas* putGlyphToTexture(CSpriteAtlas* external, const u8* alpha, int glyphW, int glyphH, float* uvx, float* uvy, float* uvW, float* uvH, core::recti* region);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,231 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	/// @brief The flat hash map u32 -> T*, it uses the open addressing (linear probing) in one array.
+	///
+	/// The glyph lookup runs for each character of each text, this map has no node allocation and
+	/// the probe sequence is in the same cache line. The removed item is filled by the next items of the probe sequence,
+	/// so there is no tombstone.
+	template <class T>
+	class CGlyphHashMap
+	{
+	public:
+		static const u32 EmptyKey = 0xFFFFFFFF;
+
+	protected:
+		struct SSlot
+		{
+			u32 Key;
+			T* Value;
+		};
+
+		SSlot* m_slots;
+		u32 m_capacity;
+		u32 m_count;
+
+	public:
+		CGlyphHashMap() :
+			m_slots(NULL),
+			m_capacity(0),
+			m_count(0)
+		{
+		}
+
+		~CGlyphHashMap()
+		{
+			delete[] m_slots;
+		}
+
+		inline u32 size()
+		{
+			return m_count;
+		}
+
+		inline u32 capacity()
+		{
+			return m_capacity;
+		}
+
+		T* get(u32 key)
+		{
+			if (m_count == 0)
+				return NULL;
+
+			u32 mask = m_capacity - 1;
+			u32 i = hash(key) & mask;
+
+			while (true)
+			{
+				SSlot& slot = m_slots[i];
+				if (slot.Key == key)
+					return slot.Value;
+				if (slot.Key == EmptyKey)
+					return NULL;
+				i = (i + 1) & mask;
+			}
+		}
+
+		void set(u32 key, T* value)
+		{
+			// keep the load factor <= 0.75
+			if ((m_count + 1) * 4 > m_capacity * 3)
+				rehash(m_capacity == 0 ? 64 : m_capacity * 2);
+
+			u32 mask = m_capacity - 1;
+			u32 i = hash(key) & mask;
+
+			while (m_slots[i].Key != EmptyKey && m_slots[i].Key != key)
+				i = (i + 1) & mask;
+
+			if (m_slots[i].Key == EmptyKey)
+				m_count++;
+
+			m_slots[i].Key = key;
+			m_slots[i].Value = value;
+		}
+
+		bool remove(u32 key)
+		{
+			if (m_count == 0)
+				return false;
+
+			u32 mask = m_capacity - 1;
+			u32 i = hash(key) & mask;
+
+			while (m_slots[i].Key != key)
+			{
+				if (m_slots[i].Key == EmptyKey)
+					return false;
+				i = (i + 1) & mask;
+			}
+
+			// shift back the next items that can not be found if this slot is empty
+			u32 j = i;
+			while (true)
+			{
+				j = (j + 1) & mask;
+				if (m_slots[j].Key == EmptyKey)
+					break;
+
+				u32 home = hash(m_slots[j].Key) & mask;
+
+				// the item at j can move to i if its home slot is not in (i, j]
+				bool between = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+				if (!between)
+				{
+					m_slots[i] = m_slots[j];
+					i = j;
+				}
+			}
+
+			m_slots[i].Key = EmptyKey;
+			m_slots[i].Value = NULL;
+			m_count--;
+			return true;
+		}
+
+		/// @brief Call func(T*) for each value
+		template <class F>
+		void forEach(F func)
+		{
+			for (u32 i = 0; i < m_capacity; i++)
+			{
+				if (m_slots[i].Key != EmptyKey)
+					func(m_slots[i].Value);
+			}
+		}
+
+		/// @brief Call func(u32 key, T*) for each item
+		template <class F>
+		void forEachItem(F func)
+		{
+			for (u32 i = 0; i < m_capacity; i++)
+			{
+				if (m_slots[i].Key != EmptyKey)
+					func(m_slots[i].Key, m_slots[i].Value);
+			}
+		}
+
+		/// @brief Remove the items that pred(T*) returns true
+		/// @return The number of removed items
+		template <class F>
+		u32 removeIf(F pred)
+		{
+			std::vector<u32> keys;
+			for (u32 i = 0; i < m_capacity; i++)
+			{
+				if (m_slots[i].Key != EmptyKey && pred(m_slots[i].Value))
+					keys.push_back(m_slots[i].Key);
+			}
+
+			for (u32 key : keys)
+				remove(key);
+
+			return (u32)keys.size();
+		}
+
+		void clear()
+		{
+			for (u32 i = 0; i < m_capacity; i++)
+				m_slots[i].Key = EmptyKey;
+			m_count = 0;
+		}
+
+	protected:
+
+		static inline u32 hash(u32 key)
+		{
+			// fibonacci hashing, the glyph keys are sequential code points
+			return (key * 2654435769u) >> 7;
+		}
+
+		void rehash(u32 capacity)
+		{
+			SSlot* oldSlots = m_slots;
+			u32 oldCapacity = m_capacity;
+
+			m_slots = new SSlot[capacity];
+			m_capacity = capacity;
+			m_count = 0;
+
+			for (u32 i = 0; i < capacity; i++)
+			{
+				m_slots[i].Key = EmptyKey;
+				m_slots[i].Value = NULL;
+			}
+
+			for (u32 i = 0; i < oldCapacity; i++)
+			{
+				if (oldSlots[i].Key != EmptyKey)
+					set(oldSlots[i].Key, oldSlots[i].Value);
+			}
+
+			delete[] oldSlots;
+		}
+	};
+}
@@ -34,8 +34,10 @@ namespace Skylicht
 		FontType(this, "fontType", CFontSource::GlyphFreeType),
 		Source(this, "source"),
 		FontSizePt(this, "fontSizePt", 20.0f),
+		SDF(this, "sdf", false),
 		m_font(NULL),
 		m_sizePt(0.0f),
+		m_sdf(false),
 		m_revision(0)
 	{
 		// font source
@@ -85,7 +87,7 @@ namespace Skylicht
 		// re-init font
 		if (FontType.get() == CFontSource::GlyphFreeType)
 		{
-			if (m_source == fontPath && m_sizePt == FontSizePt.get())
+			if (m_source == fontPath && m_sizePt == FontSizePt.get() && m_sdf == SDF.get())
 			{
 				// no changed
 				return m_font;
@@ -98,10 +100,13 @@ namespace Skylicht
 					if (m_font)
 						m_font->dropFont();
 
-					m_font = new CGlyphFont(fontName.c_str(), FontSizePt.get());
+					CGlyphFont* glyphFont = new CGlyphFont(fontName.c_str(), FontSizePt.get());
+					glyphFont->setSDF(SDF.get());
+					m_font = glyphFont;
 
 					m_source = fontPath;
 					m_sizePt = FontSizePt.get();
+					m_sdf = SDF.get();
 				}
 			}
 		}
@@ -85,6 +85,7 @@ namespace Skylicht
 		CEnumProperty<EFontType> FontType;
 		CFilePathProperty Source;
 		CFloatProperty FontSizePt;
+		CBoolProperty SDF;
 
 	protected:
 		IFont* m_font;
@@ -92,6 +93,7 @@ namespace Skylicht
 		std::string m_path;
 		std::string m_source;
 		float m_sizePt;
+		bool m_sdf;
 
 		int m_revision;
 		
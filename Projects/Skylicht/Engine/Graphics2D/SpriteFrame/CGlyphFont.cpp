@@ -31,14 +31,18 @@ namespace Skylicht
 {
 	CGlyphFont::CGlyphFont() :
 		m_fontName("Segoe UI Light"), // default font
-		m_fontSizePt(24.0f)
+		m_fontSizePt(24.0f),
+		m_sdf(false),
+		m_atlasVersion(0)
 	{
 
 	}
 
 	CGlyphFont::CGlyphFont(const char* fontName, float sizePt) :
 		m_fontName(fontName), // default font
-		m_fontSizePt(sizePt)
+		m_fontSizePt(sizePt),
+		m_sdf(false),
+		m_atlasVersion(0)
 	{
 
 	}
@@ -69,82 +73,176 @@ namespace Skylicht
 		return img;
 	}
 
+	CAtlas* CGlyphFont::getGlyph(int character, int fontSize, float* advance, float* x, float* y, float* w, float* h, float* offsetX, float* offsetY, float* scale)
+	{
+		CGlyphFreetype* glyphFreetype = CGlyphFreetype::getInstance();
+
+		if (m_sdf)
+		{
+			return glyphFreetype->getCharImageSDF(
+				(u16)character,
+				m_fontName.c_str(),
+				fontSize,
+				advance,
+				x, y, w, h,
+				offsetX, offsetY,
+				scale);
+		}
+
+		*scale = 1.0f;
+
+		return glyphFreetype->getCharImage(
+			(u16)character,
+			m_fontName.c_str(),
+			fontSize,
+			advance,
+			x, y, w, h,
+			offsetX, offsetY);
+	}
+
+	void CGlyphFont::setModule(SModuleOffset* c, CAtlas* atlas, float advance, float x, float y, float w, float h, float offsetX, float offsetY, float scale)
+	{
+		SFrame* frame = c->Frame;
+		SModuleRect* module = c->Module;
+
+		frame->Image = getImage(atlas);
+
+		c->XAdvance = advance;
+		c->OffsetX = offsetX;
+		c->OffsetY = offsetY;
+
+		core::dimension2du size = atlas->getImage()->getDimension();
+
+		module->X = x * size.Width;
+		module->Y = y * size.Height;
+		module->W = w * size.Width * scale;
+		module->H = h * size.Height * scale;
+		module->UVScale = 1.0f / scale;
+
+		// bounding rect
+		frame->BoudingRect.UpperLeftCorner.set(c->OffsetX, c->OffsetY);
+		frame->BoudingRect.LowerRightCorner.set(c->OffsetX + module->W, c->OffsetY + module->H);
+	}
+
+	void CGlyphFont::updateGlyphAtlas()
+	{
+		CGlyphFreetype* glyphFreetype = CGlyphFreetype::getInstance();
+		m_atlasVersion = glyphFreetype->getAtlasVersion();
+
+		// remove the images of the deleted atlas (CGlyphFreetype::clearAtlas)
+		std::vector<CAtlas*>& atlas = glyphFreetype->getAtlas();
+		int n = 0;
+
+		for (SImage* img : m_images)
+		{
+			if (std::find(atlas.begin(), atlas.end(), img->Atlas) != atlas.end())
+			{
+				img->Texture = img->Atlas->getTexture();
+				m_images[n++] = img;
+			}
+			else
+			{
+				delete img;
+			}
+		}
+
+		m_images.resize(n);
+
+		// the glyphs can be moved or evicted, get them again
+		float advance = 0.0f, x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f, offsetX = 0, offsetY = 0;
+		float scale = 1.0f;
+
+		m_moduleOffset.forEachItem([&](u32 key, SModuleOffset* c)
+			{
+				CAtlas* a = getGlyph((int)c->Character, (int)(key >> 16), &advance, &x, &y, &w, &h, &offsetX, &offsetY, &scale);
+				if (a != NULL)
+				{
+					setModule(c, a, advance, x, y, w, h, offsetX, offsetY, scale);
+				}
+				else
+				{
+					// draw nothing, the old image can be deleted
+					c->Frame->Image = getImage(atlas[0]);
+					c->Module->W = 0.0f;
+					c->Module->H = 0.0f;
+				}
+			});
+	}
+
 	SModuleOffset* CGlyphFont::getCharacterModule(int character)
 	{
+		if (m_atlasVersion != CGlyphFreetype::getInstance()->getAtlasVersion())
+			updateGlyphAtlas();
+
 		int fontSize = CGlyphFreetype::sizePtToPx(m_fontSizePt);
 		u32 key = (fontSize << 16) | (u16)character;
 
-		SModuleOffset* c = m_moduleOffset[key];
+		SModuleOffset* c = m_moduleOffset.get(key);
 		if (c != NULL)
 			return c;
 
 		float advance = 0.0f, x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f, offsetX = 0, offsetY = 0;
+		float scale = 1.0f;
 
-		CGlyphFreetype* glyphFreetype = CGlyphFreetype::getInstance();
-		CAtlas* atlas = glyphFreetype->getCharImage(
-			(u16)character,
-			m_fontName.c_str(),
-			fontSize,
-			&advance,
-			&x, &y, &w, &h,
-			&offsetX, &offsetY);
+		CAtlas* atlas = getGlyph(character, fontSize, &advance, &x, &y, &w, &h, &offsetX, &offsetY, &scale);
 
 		if (atlas != NULL)
 		{
-			SImage* img = getImage(atlas);
-
 			m_frames.push_back(new SFrame());
 			SFrame* frame = m_frames.back();
 
-			frame->Image = img;
 			frame->ID = std::to_string(character);
 			frame->ModuleOffset.push_back(SModuleOffset());
 
 			c = &frame->ModuleOffset.back();
 			c->Character = character;
-			c->XAdvance = advance;
-			c->OffsetX = offsetX;
-			c->OffsetY = offsetY;
-
-			core::dimension2du size = atlas->getImage()->getDimension();
 
 			m_modules.push_back(new SModuleRect());
 			SModuleRect* module = m_modules.back();
-			module->X = x * size.Width;
-			module->Y = y * size.Height;
-			module->W = w * size.Width;
-			module->H = h * size.Height;
 
 			c->Module = module;
 			c->Frame = frame;
 
-			// bounding rect
-			frame->BoudingRect.UpperLeftCorner.set(c->OffsetX, c->OffsetY);
-			frame->BoudingRect.LowerRightCorner.set(c->OffsetX + module->W, c->OffsetY + module->H);
+			setModule(c, atlas, advance, x, y, w, h, offsetX, offsetY, scale);
 
-			m_moduleOffset[key] = c;
+			m_moduleOffset.set(key, c);
 		}
 
 		return c;
 	}
 
+	int CGlyphFont::prewarm(const wchar_t* text)
+	{
+		int fontSize = CGlyphFreetype::sizePtToPx(m_fontSizePt);
+		return CGlyphFreetype::getInstance()->prewarm(m_fontName.c_str(), text, fontSize, m_sdf);
+	}
+
 	void CGlyphFont::getListModule(const wchar_t* string, std::vector<int>& format, std::vector<SModuleOffset*>& output, std::vector<int>& outputFormat)
 	{
 		IFont::getListModule(string, format, output, outputFormat);
 
-		for (SImage* img : m_images)
-		{
-			if (img->Atlas != NULL)
-				img->Atlas->updateTexture();
-		}
+		updateFontTexture();
+	}
+
+	u32 CGlyphFont::getAtlasVersion()
+	{
+		return CGlyphFreetype::getInstance()->getAtlasVersion();
 	}
 
 	void CGlyphFont::updateFontTexture()
 	{
+		CGlyphFreetype* glyphFreetype = CGlyphFreetype::getInstance();
+		if (m_atlasVersion != glyphFreetype->getAtlasVersion())
+			updateGlyphAtlas();
+
 		for (SImage* img : m_images)
 		{
 			if (img->Atlas != NULL)
+			{
+				// the text is drawn, keep this atlas (see CGlyphFreetype::setMaxAtlas)
+				glyphFreetype->touchAtlas(img->Atlas);
 				img->Atlas->updateTexture();
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -27,6 +27,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "IFont.h"
 
 #include "Graphics2D/Atlas/CAtlas.h"
+#include "Graphics2D/Glyph/CGlyphHashMap.h"
 #include "CSpriteFrame.h"
 
 namespace Skylicht
@@ -43,6 +44,12 @@ namespace Skylicht
 	/// CGlyphFont* font = new CGlyphFont();
 	/// font->setFont("Segoe UI Light", 25);
 	/// @endcode
+	/// 
+	/// With setSDF(true), the glyphs are signed distance fields shared by all font sizes,
+	/// they need the "TextureColorSDF" shader (CGUIText uses it automatically).
+	/// 
+	/// When CGlyphFreetype moves or evicts the glyphs, the modules are updated in place,
+	/// so the SModuleOffset pointers that the texts keep are still valid.
 	class SKYLICHT_API CGlyphFont :
 		public CSpriteFrame,
 		public IFont
@@ -50,7 +57,11 @@ namespace Skylicht
 	protected:
 		float m_fontSizePt;
 
-		std::map<int, SModuleOffset*> m_moduleOffset;
+		bool m_sdf;
+
+		CGlyphHashMap<SModuleOffset> m_moduleOffset;
+
+		u32 m_atlasVersion;
 
 		std::string m_fontName;
 
@@ -58,6 +69,12 @@ namespace Skylicht
 
 		SImage* getImage(CAtlas* atlas);
 
+		CAtlas* getGlyph(int character, int fontSize, float* advance, float* x, float* y, float* w, float* h, float* offsetX, float* offsetY, float* scale);
+
+		void setModule(SModuleOffset* c, CAtlas* atlas, float advance, float x, float y, float w, float h, float offsetX, float offsetY, float scale);
+
+		void updateGlyphAtlas();
+
 	public:
 		CGlyphFont();
 
@@ -76,12 +93,32 @@ namespace Skylicht
 			return m_fontName.c_str();
 		}
 
+		/**
+		* @brief Use the signed distance field glyphs, call it before the characters are used.
+		*/
+		inline void setSDF(bool b)
+		{
+			m_sdf = b;
+		}
+
+		virtual bool isSDF()
+		{
+			return m_sdf;
+		}
+
+		/**
+		* @brief Rasterize the characters of the text on the raster thread, see CGlyphFreetype::prewarm.
+		*/
+		int prewarm(const wchar_t* text);
+
 		virtual SModuleOffset* getCharacterModule(int character);
 
 		virtual void getListModule(const wchar_t* string, std::vector<int>& format, std::vector<SModuleOffset*>& output, std::vector<int>& outputFormat);
 
 		virtual void updateFontTexture();
 
+		virtual u32 getAtlasVersion();
+
 		std::vector<SImage*>& getImages()
 		{
 			return m_images;
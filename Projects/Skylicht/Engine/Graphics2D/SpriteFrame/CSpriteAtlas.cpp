@@ -70,6 +70,9 @@ namespace Skylicht
 			}
 		}
 
+		if (std::find(m_externalImages.begin(), m_externalImages.end(), image) == m_externalImages.end())
+			m_externalImages.push_back(image);
+
 		outRegion = r;
 		return image;
 	}
@@ -90,82 +93,226 @@ namespace Skylicht
 				img->swapBG();
 			}
 
-			int w = img->getDimension().Width;
-			int h = img->getDimension().Height;
+			frame = addFrame(name, img, frameId);
+			img->drop();
+		}
+
+		return frame;
+	}
+
+	SFrame* CSpriteAtlas::addFrame(const char* name, IImage* img, const char* frameId)
+	{
+		int w = img->getDimension().Width;
+		int h = img->getDimension().Height;
+
+		int atlasW = w + 2;
+		int atlasH = h + 2;
+
+		int imageID = 0;
+		SImage* image = NULL;
+		core::recti r;
+
+		for (SImage*& a : m_images)
+		{
+			r = a->Atlas->createRect(atlasW, atlasH);
+			if (r.getWidth() != 0 && r.getHeight() != 0)
+			{
+				image = a;
+				break;
+			}
+
+			imageID++;
+		}
+
+		if (image == NULL)
+		{
+			image = addEmptyAtlas();
+			r = image->Atlas->createRect(atlasW, atlasH);
+			if (r.getWidth() == 0 || r.getHeight() == 0)
+				return NULL;
+		}
+
+		// atlas image
+		image->Atlas->bitBltImage(img, r.UpperLeftCorner.X, r.UpperLeftCorner.Y);
+
+		// create frame
+		SFrame* frame = new SFrame();
+		frame->Image = image;
+		frame->BoudingRect.UpperLeftCorner.set(0.0f, 0.0f);
+		frame->BoudingRect.LowerRightCorner.set((f32)r.getWidth(), (f32)r.getHeight());
+		frame->Name = name;
+
+		if (frameId != NULL)
+			frame->ID = frameId;
+		else
+			frame->ID = CRandomID::generate();
+
+		// create module
+		SModuleRect* module = new SModuleRect();
+		module->X = (f32)r.UpperLeftCorner.X;
+		module->Y = (f32)r.UpperLeftCorner.Y;
+		module->W = (f32)w;
+		module->H = (f32)h;
+		module->ID = (int)m_modules.size();
+		m_modules.push_back(module);
+
+		// frame & module with offset
+		frame->ModuleOffset.push_back(SModuleOffset());
+		SModuleOffset& offset = frame->ModuleOffset.back();
+		offset.Frame = frame;
+		offset.Module = module;
+		offset.OffsetX = 0;
+		offset.OffsetY = 0;
+
+		char log[512];
+		sprintf(log, "[AtlasFrame] add %s - %dx%d - [%d]", name, w, h, imageID);
+		os::Printer::log(log);
+
+		m_frames.push_back(frame);
+
+		m_names[name] = frame;
+
+		return frame;
+	}
+
+	bool CSpriteAtlas::removeFrame(SFrame* frame)
+	{
+		std::vector<SFrame*>::iterator i = std::find(m_frames.begin(), m_frames.end(), frame);
+		if (i == m_frames.end())
+			return false;
+
+		m_frames.erase(i);
+
+		std::map<std::string, SFrame*>::iterator name = m_names.find(frame->Name);
+		if (name != m_names.end() && name->second == frame)
+			m_names.erase(name);
+
+		for (SModuleOffset& offset : frame->ModuleOffset)
+		{
+			SModuleRect* module = offset.Module;
+
+			// the rect of addFrame has the 2 pixels padding
+			core::recti r((int)module->X, (int)module->Y, (int)module->X + (int)module->W + 2, (int)module->Y + (int)module->H + 2);
+			frame->Image->Atlas->releaseRect(r);
+
+			std::vector<SModuleRect*>::iterator m = std::find(m_modules.begin(), m_modules.end(), module);
+			if (m != m_modules.end())
+				m_modules.erase(m);
+
+			delete module;
+		}
+
+		delete frame;
+		return true;
+	}
+
+	int CSpriteAtlas::defragment()
+	{
+		struct SFrameRect
+		{
+			SFrame* Frame;
+			int ImageID;
+			core::recti Rect;
+		};
+
+		// the images that can be repacked
+		std::vector<SImage*> images;
+		for (SImage* image : m_images)
+		{
+			if (std::find(m_externalImages.begin(), m_externalImages.end(), image) == m_externalImages.end())
+				images.push_back(image);
+		}
+
+		std::vector<SFrameRect> frames;
+		for (SFrame* frame : m_frames)
+		{
+			std::vector<SImage*>::iterator i = std::find(images.begin(), images.end(), frame->Image);
+			if (i == images.end() || frame->ModuleOffset.size() == 0)
+				continue;
+
+			SModuleRect* module = frame->ModuleOffset[0].Module;
+
+			SFrameRect f;
+			f.Frame = frame;
+			f.ImageID = (int)(i - images.begin());
+			f.Rect = core::recti((int)module->X, (int)module->Y, (int)module->X + (int)module->W + 2, (int)module->Y + (int)module->H + 2);
+			frames.push_back(f);
+		}
+
+		if (frames.size() == 0)
+			return 0;
+
+		// keep the old pixels, then clear the atlas
+		IVideoDriver* driver = getVideoDriver();
+		std::vector<IImage*> oldImages;
 
-			int atlasW = w + 2;
-			int atlasH = h + 2;
+		for (SImage* image : images)
+		{
+			IImage* atlasImage = image->Atlas->getImage();
+			IImage* copy = driver->createImage(atlasImage->getColorFormat(), atlasImage->getDimension());
+			atlasImage->copyTo(copy);
+			oldImages.push_back(copy);
+
+			image->Atlas->clear();
+		}
+
+		// the taller frames first, the shelves are filled in order
+		std::sort(frames.begin(), frames.end(), [](const SFrameRect& a, const SFrameRect& b)
+			{
+				int ha = a.Rect.getHeight();
+				int hb = b.Rect.getHeight();
+				if (ha != hb)
+					return ha > hb;
+				return a.Rect.getWidth() > b.Rect.getWidth();
+			});
 
-			int imageID = 0;
+		int moved = 0;
+
+		for (SFrameRect& f : frames)
+		{
 			SImage* image = NULL;
 			core::recti r;
 
-			for (SImage*& a : m_images)
+			for (SImage* a : images)
 			{
-				r = a->Atlas->createRect(atlasW, atlasH);
+				r = a->Atlas->createRect(f.Rect.getWidth(), f.Rect.getHeight());
 				if (r.getWidth() != 0 && r.getHeight() != 0)
 				{
 					image = a;
 					break;
 				}
-
-				imageID++;
 			}
 
 			if (image == NULL)
 			{
 				image = addEmptyAtlas();
-				r = image->Atlas->createRect(atlasW, atlasH);
-				if (r.getWidth() == 0 || r.getHeight() == 0)
-				{
-					img->drop();
-					return NULL;
-				}
+				images.push_back(image);
+				r = image->Atlas->createRect(f.Rect.getWidth(), f.Rect.getHeight());
 			}
 
-			// atlas image
-			image->Atlas->bitBltImage(img, r.UpperLeftCorner.X, r.UpperLeftCorner.Y);
-
-			// create frame
-			frame = new SFrame();
-			frame->Image = image;
-			frame->BoudingRect.UpperLeftCorner.set(0.0f, 0.0f);
-			frame->BoudingRect.LowerRightCorner.set((f32)r.getWidth(), (f32)r.getHeight());
-			frame->Name = name;
-
-			if (frameId != NULL)
-				frame->ID = frameId;
-			else
-				frame->ID = CRandomID::generate();
-
-			// create module
-			SModuleRect* module = new SModuleRect();
-			module->X = (f32)r.UpperLeftCorner.X;
-			module->Y = (f32)r.UpperLeftCorner.Y;
-			module->W = (f32)w;
-			module->H = (f32)h;
-			module->ID = (int)m_modules.size();
-			m_modules.push_back(module);
-
-			// frame & module with offset
-			frame->ModuleOffset.push_back(SModuleOffset());
-			SModuleOffset& offset = frame->ModuleOffset.back();
-			offset.Frame = frame;
-			offset.Module = module;
-			offset.OffsetX = 0;
-			offset.OffsetY = 0;
-
-			char log[512];
-			sprintf(log, "[AtlasFrame] add %s - %dx%d - [%d]", name, w, h, imageID);
-			os::Printer::log(log);
-
-			m_frames.push_back(frame);
-			img->drop();
+			image->Atlas->bitBltImage(oldImages[f.ImageID], r.UpperLeftCorner.X, r.UpperLeftCorner.Y, f.Rect);
 
-			m_names[name] = frame;
+			if (image != f.Frame->Image || r.UpperLeftCorner != f.Rect.UpperLeftCorner)
+			{
+				// the render cache of the sprites is rebuilt
+				f.Frame->Version++;
+				moved++;
+			}
+
+			// the modules keep the offset on the frame rect
+			for (SModuleOffset& offset : f.Frame->ModuleOffset)
+			{
+				offset.Module->X += (f32)(r.UpperLeftCorner.X - f.Rect.UpperLeftCorner.X);
+				offset.Module->Y += (f32)(r.UpperLeftCorner.Y - f.Rect.UpperLeftCorner.Y);
+			}
+
+			f.Frame->Image = image;
 		}
 
-		return frame;
+		for (IImage* image : oldImages)
+			image->drop();
+
+		return moved;
 	}
 
 	void CSpriteAtlas::updateTexture()
@@ -36,6 +36,8 @@ namespace Skylicht
 	/// SFrame* btnYellowBackground = sprite->addFrame("btn_yellow.png", "LuckyDraw/btn_yellow.png");
 	/// @endcode
 	/// Then, use the CGraphics2D object or the CGUISprite, CGUIFitSprite to draw this sprite and image.
+	/// 
+	/// removeFrame gives back the space of a frame, call defragment to repack the frames.
 	class SKYLICHT_API CSpriteAtlas : public CSpriteFrame
 	{
 	protected:
@@ -43,6 +45,9 @@ namespace Skylicht
 		int m_height;
 		ECOLOR_FORMAT m_fmt;
 
+		// the images that have the rects of createAtlasRect, they are not repacked
+		std::vector<SImage*> m_externalImages;
+
 	protected:
 		SImage* addEmptyAtlas();
 
@@ -53,6 +58,19 @@ namespace Skylicht
 
 		SFrame* addFrame(const char* name, const char* path, const char* frameId = NULL);
 
+		SFrame* addFrame(const char* name, IImage* img, const char* frameId = NULL);
+
+		/**
+		* @brief Remove the frame and give back its rect on the atlas, the frame is deleted.
+		*/
+		bool removeFrame(SFrame* frame);
+
+		/**
+		* @brief Repack the frames, the modules and the frame images are updated.
+		* @return The number of moved frames.
+		*/
+		int defragment();
+
 		SImage* createAtlasRect(int w, int h, core::recti& outRegion);
 
 		void updateTexture();
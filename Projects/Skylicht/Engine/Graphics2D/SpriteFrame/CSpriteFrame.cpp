@@ -118,8 +118,8 @@ namespace Skylicht
 	{
 		float x1 = Module->X / texWidth;
 		float y1 = Module->Y / texHeight;
-		float x2 = (Module->X + Module->W * scaleW) / texWidth;
-		float y2 = (Module->Y + Module->H * scaleH) / texHeight;
+		float x2 = (Module->X + Module->W * Module->UVScale * scaleW) / texWidth;
+		float y2 = (Module->Y + Module->H * Module->UVScale * scaleH) / texHeight;
 
 		if (FlipX)
 			core::swap<float, float>(x1, x2);
@@ -53,6 +53,9 @@ namespace Skylicht
 		float W;
 		float H;
 
+		// the texture pixels per module pixel, the SDF glyph is drawn at any size from one bitmap
+		float UVScale;
+
 		SModuleRect()
 		{
 			ID = -1;
@@ -60,6 +63,7 @@ namespace Skylicht
 			Y = -1;
 			W = -1;
 			H = -1;
+			UVScale = 1.0f;
 		}
 	};
 
@@ -97,10 +101,14 @@ namespace Skylicht
 		SImage* Image;
 		core::rectf BoudingRect;
 
+		// it is increased when the modules or the image of the frame are moved (see CSpriteAtlas::defragment)
+		u32 Version;
+
 		SFrame()
 		{
 			ID = -1;
 			Image = NULL;
+			Version = 0;
 		}
 
 		inline float getWidth()
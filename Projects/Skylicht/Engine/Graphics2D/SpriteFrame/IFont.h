@@ -41,6 +41,18 @@ namespace Skylicht
 
 		virtual void updateFontTexture();
 
+		/// @brief The glyph rects are changed when this value changes, the text that uses the font is laid out again
+		virtual u32 getAtlasVersion()
+		{
+			return 0;
+		}
+
+		/// @brief The font is the signed distance field, it is drawn with the "TextureColorSDF" shader
+		virtual bool isSDF()
+		{
+			return false;
+		}
+
 		virtual bool dropFont();
 
 		virtual void grabFont();
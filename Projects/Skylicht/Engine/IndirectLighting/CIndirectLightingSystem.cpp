@@ -34,6 +34,10 @@ namespace Skylicht
 		m_groupProbes(NULL)
 	{
 		m_kdtree = kd_create(3);
+
+		declareReadData(DATA_TYPE_INDEX(CWorldTransformData));
+		declareWriteData(DATA_TYPE_INDEX(CLightProbeData));
+		declareWriteData(DATA_TYPE_INDEX(CIndirectLightingData));
 	}
 
 	CIndirectLightingSystem::~CIndirectLightingSystem()
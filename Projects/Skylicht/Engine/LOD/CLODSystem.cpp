@@ -29,6 +29,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Camera/CCamera.h"
 #include "RenderPipeline/CShadowMapRP.h"
 #include "Culling/CCullingSystem.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
@@ -36,6 +37,10 @@ namespace Skylicht
 		m_group(NULL)
 	{
 		m_pipelineType = IRenderPipeline::Mix;
+
+		declareReadData(DATA_TYPE_INDEX(CWorldTransformData));
+		declareReadData(DATA_TYPE_INDEX(CLODData));
+		declareWriteData(DATA_TYPE_INDEX(CVisibleData));
 	}
 
 	CLODSystem::~CLODSystem()
@@ -79,39 +84,43 @@ namespace Skylicht
 		core::vector3df distance;
 
 		CEntity** entities = m_group->getEntities();
-		u32 numEntity = m_group->getEntityCount();
-		CEntity* entity;
-		CWorldTransformData* transform;
-		CVisibleData* visible;
-		CLODData* lod;
-		const f32* m;
-		float x, z, d;
-
-		for (u32 i = 0; i < numEntity; i++)
-		{
-			entity = entities[i];
+		int numEntity = m_group->getEntityCount();
 
-			visible = GET_ENTITY_DATA(entity, CVisibleData);
-
-			if (!visible->Culled)
+		System::CJobSystem::runParallelFor(numEntity, 512, [entities, cameraPosition](int begin, int end)
 			{
-				transform = GET_ENTITY_DATA(entity, CWorldTransformData);
-				lod = GET_ENTITY_DATA(entity, CLODData);
-
-				m = transform->World.pointer();
-
-				// distance vector
-				x = cameraPosition.X - m[12];
-				z = cameraPosition.Z - m[14];
-
-				// length vector
-				d = x * x + z * z;
-
-				// culling out side
-				if (d < lod->From || d >= lod->To)
-					visible->Culled = true;
-			}
-		}
+				CEntity* entity;
+				CWorldTransformData* transform;
+				CVisibleData* visible;
+				CLODData* lod;
+				const f32* m;
+				float x, z, d;
+
+				for (int i = begin; i < end; i++)
+				{
+					entity = entities[i];
+
+					visible = GET_ENTITY_DATA(entity, CVisibleData);
+
+					if (!visible->Culled)
+					{
+						transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+						lod = GET_ENTITY_DATA(entity, CLODData);
+
+						m = transform->World.pointer();
+
+						// distance vector
+						x = cameraPosition.X - m[12];
+						z = cameraPosition.Z - m[14];
+
+						// length vector
+						d = x * x + z * z;
+
+						// culling out side
+						if (d < lod->From || d >= lod->To)
+							visible->Culled = true;
+					}
+				}
+			});
 	}
 
 	void CLODSystem::render(CEntityManager* entityManager)
@@ -0,0 +1,357 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CLightGrid.h"
+#include "Camera/CCamera.h"
+#include "Thread/CJobSystem.h"
+
+namespace Skylicht
+{
+	CLightGrid::CLightGrid() :
+		m_perspective(true),
+		m_scaleX(1.0f),
+		m_offsetX(0.0f),
+		m_scaleY(1.0f),
+		m_offsetY(0.0f),
+		m_near(0.1f),
+		m_far(1000.0f),
+		m_depthScale(1.0f),
+		m_built(false),
+		m_markId(0)
+	{
+		m_size[0] = 16;
+		m_size[1] = 9;
+		m_size[2] = 24;
+	}
+
+	CLightGrid::~CLightGrid()
+	{
+
+	}
+
+	void CLightGrid::setGridSize(u32 x, u32 y, u32 z)
+	{
+		m_size[0] = core::max_(x, 1u);
+		m_size[1] = core::max_(y, 1u);
+		m_size[2] = core::max_(z, 1u);
+		clear();
+	}
+
+	void CLightGrid::clear()
+	{
+		m_lights.set_used(0);
+		m_lightRanges.set_used(0);
+		m_clusterOffset.set_used(0);
+		m_clusterLights.set_used(0);
+		m_built = false;
+	}
+
+	void CLightGrid::build(CCamera* camera, CLightCullingData** lights, u32 count)
+	{
+		if (camera == NULL)
+		{
+			// no grid, getLights will test all the lights
+			clear();
+			for (u32 i = 0; i < count; i++)
+				m_lights.push_back(lights[i]);
+			return;
+		}
+
+		build(
+			camera->getViewMatrix(),
+			camera->getProjectionMatrix(),
+			camera->getNearValue(),
+			camera->getFarValue(),
+			lights, count);
+	}
+
+	void CLightGrid::build(const core::matrix4& view, const core::matrix4& projection, float nearValue, float farValue, CLightCullingData** lights, u32 count)
+	{
+		m_view = view;
+
+		// w = z on the perspective projection
+		m_perspective = projection[11] != 0.0f;
+		m_scaleX = projection[0];
+		m_scaleY = projection[5];
+
+		if (m_perspective)
+		{
+			m_offsetX = projection[8];
+			m_offsetY = projection[9];
+		}
+		else
+		{
+			m_offsetX = projection[12];
+			m_offsetY = projection[13];
+		}
+
+		m_near = core::max_(nearValue, 0.001f);
+		m_far = core::max_(farValue, m_near * 1.01f);
+		m_depthScale = (float)m_size[2] / logf(m_far / m_near);
+
+		m_lights.set_used(0);
+		for (u32 i = 0; i < count; i++)
+			m_lights.push_back(lights[i]);
+
+		if (m_mark.size() < count)
+		{
+			u32 n = m_mark.size();
+			m_mark.set_used(count);
+			for (u32 i = n; i < count; i++)
+				m_mark[i] = 0;
+		}
+
+		// the light bounds in view space
+		m_kernel.reset();
+		for (u32 i = 0; i < count; i++)
+			m_kernel.addBox(lights[i]->TransformBBox, m_view);
+		m_kernel.transformBoxes();
+
+		m_lightRanges.set_used(count);
+		core::aabbox3df viewBox;
+		core::vector3df padding(0.001f, 0.001f, 0.001f);
+
+		for (u32 i = 0; i < count; i++)
+		{
+			m_kernel.getBox((int)i, viewBox);
+			viewBox.MinEdge -= padding;
+			viewBox.MaxEdge += padding;
+			getClusterRange(viewBox, m_lightRanges[i]);
+		}
+
+		u32 numClusters = getNumClusters();
+		m_clusterOffset.set_used(numClusters + 1);
+
+		u32* offset = m_clusterOffset.pointer();
+		SClusterRange* ranges = m_lightRanges.pointer();
+		u32 sizeX = m_size[0];
+		u32 sizeY = m_size[1];
+		u32 sliceSize = sizeX * sizeY;
+
+		// each slice owns its clusters, so the slices are counted and filled in parallel
+		System::CJobSystem::runParallelFor((int)m_size[2], 1, [offset, ranges, count, sizeX, sliceSize](int begin, int end)
+			{
+				for (int z = begin; z < end; z++)
+				{
+					u32* slice = offset + z * sliceSize;
+					memset(slice, 0, sizeof(u32) * sliceSize);
+
+					for (u32 i = 0; i < count; i++)
+					{
+						const SClusterRange& r = ranges[i];
+						if ((u32)z < r.Min[2] || (u32)z > r.Max[2])
+							continue;
+
+						for (u32 y = r.Min[1]; y <= r.Max[1]; y++)
+						{
+							u32* row = slice + y * sizeX;
+							for (u32 x = r.Min[0]; x <= r.Max[0]; x++)
+								row[x]++;
+						}
+					}
+				}
+			});
+
+		// exclusive prefix sum
+		u32 total = 0;
+		for (u32 i = 0; i < numClusters; i++)
+		{
+			u32 c = offset[i];
+			offset[i] = total;
+			total += c;
+		}
+		offset[numClusters] = total;
+
+		m_clusterLights.set_used(total);
+		u32* clusterLights = m_clusterLights.pointer();
+
+		System::CJobSystem::runParallelFor((int)m_size[2], 1, [offset, clusterLights, ranges, count, sizeX, sliceSize](int begin, int end)
+			{
+				for (int z = begin; z < end; z++)
+				{
+					u32 first = z * sliceSize;
+
+					// the write cursor of the clusters in this slice
+					std::vector<u32> cursor(offset + first, offset + first + sliceSize);
+
+					for (u32 i = 0; i < count; i++)
+					{
+						const SClusterRange& r = ranges[i];
+						if ((u32)z < r.Min[2] || (u32)z > r.Max[2])
+							continue;
+
+						for (u32 y = r.Min[1]; y <= r.Max[1]; y++)
+						{
+							u32* row = cursor.data() + y * sizeX;
+							for (u32 x = r.Min[0]; x <= r.Max[0]; x++)
+								clusterLights[row[x]++] = i;
+						}
+					}
+				}
+			});
+
+		m_built = true;
+	}
+
+	u32 CLightGrid::getSlice(float z)
+	{
+		if (z <= m_near)
+			return 0;
+
+		float s = logf(z / m_near) * m_depthScale;
+		if (s >= (float)(m_size[2] - 1))
+			return m_size[2] - 1;
+
+		return (u32)s;
+	}
+
+	u32 CLightGrid::getTile(float ndc, u32 size)
+	{
+		float t = (ndc * 0.5f + 0.5f) * (float)size;
+		if (t <= 0.0f)
+			return 0;
+		if (t >= (float)(size - 1))
+			return size - 1;
+		return (u32)t;
+	}
+
+	void CLightGrid::getClusterRange(const core::aabbox3df& viewBox, SClusterRange& range)
+	{
+		const core::vector3df& minEdge = viewBox.MinEdge;
+		const core::vector3df& maxEdge = viewBox.MaxEdge;
+
+		range.Min[2] = getSlice(minEdge.Z);
+		range.Max[2] = getSlice(maxEdge.Z);
+
+		float minX, maxX, minY, maxY;
+
+		if (m_perspective)
+		{
+			if (minEdge.Z <= 0.0001f)
+			{
+				// the box crosses the camera plane, the projection is unbounded
+				range.Min[0] = 0;
+				range.Max[0] = m_size[0] - 1;
+				range.Min[1] = 0;
+				range.Max[1] = m_size[1] - 1;
+				return;
+			}
+
+			// x / z is monotonic on each axis, the extremes are at the corners
+			float invNear = 1.0f / minEdge.Z;
+			float invFar = 1.0f / maxEdge.Z;
+
+			minX = core::min_(minEdge.X * invNear, minEdge.X * invFar);
+			maxX = core::max_(maxEdge.X * invNear, maxEdge.X * invFar);
+			minY = core::min_(minEdge.Y * invNear, minEdge.Y * invFar);
+			maxY = core::max_(maxEdge.Y * invNear, maxEdge.Y * invFar);
+		}
+		else
+		{
+			minX = minEdge.X;
+			maxX = maxEdge.X;
+			minY = minEdge.Y;
+			maxY = maxEdge.Y;
+		}
+
+		float ndc0 = m_scaleX * minX + m_offsetX;
+		float ndc1 = m_scaleX * maxX + m_offsetX;
+		range.Min[0] = getTile(core::min_(ndc0, ndc1), m_size[0]);
+		range.Max[0] = getTile(core::max_(ndc0, ndc1), m_size[0]);
+
+		ndc0 = m_scaleY * minY + m_offsetY;
+		ndc1 = m_scaleY * maxY + m_offsetY;
+		range.Min[1] = getTile(core::min_(ndc0, ndc1), m_size[1]);
+		range.Max[1] = getTile(core::max_(ndc0, ndc1), m_size[1]);
+	}
+
+	u32 CLightGrid::getLights(const core::aabbox3df& box, core::array<CLightCullingData*>& result)
+	{
+		u32 added = 0;
+		u32 numLight = m_lights.size();
+		if (numLight == 0)
+			return 0;
+
+		CLightCullingData** lights = m_lights.pointer();
+
+		if (!m_built)
+		{
+			for (u32 i = 0; i < numLight; i++)
+			{
+				if (lights[i]->TransformBBox.intersectsWithBox(box))
+				{
+					result.push_back(lights[i]);
+					added++;
+				}
+			}
+			return added;
+		}
+
+		if (++m_markId == 0)
+		{
+			// the id wraps, reset the marks
+			for (u32 i = 0, n = m_mark.size(); i < n; i++)
+				m_mark[i] = 0;
+			m_markId = 1;
+		}
+
+		core::aabbox3df viewBox = box;
+		m_view.transformBoxEx(viewBox);
+
+		SClusterRange range;
+		getClusterRange(viewBox, range);
+
+		u32* mark = m_mark.pointer();
+		u32* offset = m_clusterOffset.pointer();
+		u32* clusterLights = m_clusterLights.pointer();
+
+		for (u32 z = range.Min[2]; z <= range.Max[2]; z++)
+		{
+			for (u32 y = range.Min[1]; y <= range.Max[1]; y++)
+			{
+				u32 cluster = getClusterIndex(range.Min[0], y, z);
+				for (u32 x = range.Min[0]; x <= range.Max[0]; x++, cluster++)
+				{
+					for (u32 i = offset[cluster], n = offset[cluster + 1]; i < n; i++)
+					{
+						u32 lightId = clusterLights[i];
+						if (mark[lightId] == m_markId)
+							continue;
+
+						mark[lightId] = m_markId;
+
+						if (lights[lightId]->TransformBBox.intersectsWithBox(box))
+						{
+							result.push_back(lights[lightId]);
+							added++;
+						}
+					}
+				}
+			}
+		}
+
+		return added;
+	}
+}
@@ -0,0 +1,179 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CLightCullingData.h"
+#include "Culling/CCullingKernel.h"
+
+namespace Skylicht
+{
+	class CCamera;
+
+	/// @brief The clustered (froxel) light grid of the camera.
+	///
+	/// The camera frustum is split to tiles on the screen and exponential slices on the depth. The grid is built once per frame
+	/// from the bounds of the visible lights (CLightCullingData::TransformBBox), each cluster keeps the list of the lights that may touch it.
+	/// A mesh takes its lights from the clusters that its bounds overlap, then the exact bounds test.
+	///
+	/// @code
+	/// CLightGrid grid;
+	/// grid.build(camera, lights, numLight);
+	/// grid.getLights(meshWorldBox, result);
+	/// @endcode
+	class SKYLICHT_API CLightGrid
+	{
+	public:
+		struct SClusterRange
+		{
+			u32 Min[3];
+			u32 Max[3];
+		};
+
+	protected:
+		u32 m_size[3];
+
+		core::matrix4 m_view;
+
+		bool m_perspective;
+
+		// ndc = scale * (x / z) + offset on the perspective camera, scale * x + offset on the ortho camera
+		float m_scaleX;
+		float m_offsetX;
+		float m_scaleY;
+		float m_offsetY;
+
+		float m_near;
+		float m_far;
+		float m_depthScale;
+
+		bool m_built;
+
+		// transform the light bounds to view space
+		CCullingKernel m_kernel;
+
+		core::array<CLightCullingData*> m_lights;
+
+		core::array<SClusterRange> m_lightRanges;
+
+		// the lights of cluster i are m_clusterLights[m_clusterOffset[i]] .. m_clusterLights[m_clusterOffset[i + 1] - 1]
+		core::array<u32> m_clusterOffset;
+
+		core::array<u32> m_clusterLights;
+
+		core::array<u32> m_mark;
+
+		u32 m_markId;
+
+	public:
+		CLightGrid();
+
+		virtual ~CLightGrid();
+
+		/// @brief Set the number of the tiles on the screen and the depth slices, the default is 16x9x24
+		void setGridSize(u32 x, u32 y, u32 z);
+
+		/// @brief Build the grid on the frustum of the camera, if the camera is NULL the lights are kept without the grid
+		void build(CCamera* camera, CLightCullingData** lights, u32 count);
+
+		/// @brief Build the grid on a view and a projection matrix
+		void build(const core::matrix4& view, const core::matrix4& projection, float nearValue, float farValue, CLightCullingData** lights, u32 count);
+
+		void clear();
+
+		/// @brief Get the clusters that a view space box may touch
+		void getClusterRange(const core::aabbox3df& viewBox, SClusterRange& range);
+
+		/**
+		 * @brief Get the lights that their bounds intersect a world box, each light is added once.
+		 * It is not thread safe, the query marks the lights on the grid.
+		 * @return The number of the lights added to the result.
+		 */
+		u32 getLights(const core::aabbox3df& box, core::array<CLightCullingData*>& result);
+
+		inline u32 getSizeX()
+		{
+			return m_size[0];
+		}
+
+		inline u32 getSizeY()
+		{
+			return m_size[1];
+		}
+
+		inline u32 getSizeZ()
+		{
+			return m_size[2];
+		}
+
+		inline u32 getNumClusters()
+		{
+			return m_size[0] * m_size[1] * m_size[2];
+		}
+
+		inline u32 getClusterIndex(u32 x, u32 y, u32 z)
+		{
+			return (z * m_size[1] + y) * m_size[0] + x;
+		}
+
+		/// @brief Get the light indices of a cluster, see getLight
+		inline const u32* getClusterLights(u32 cluster, u32& count)
+		{
+			if (!m_built)
+			{
+				count = 0;
+				return NULL;
+			}
+
+			count = m_clusterOffset[cluster + 1] - m_clusterOffset[cluster];
+			return m_clusterLights.pointer() + m_clusterOffset[cluster];
+		}
+
+		inline u32 getNumLights()
+		{
+			return m_lights.size();
+		}
+
+		inline CLightCullingData* getLight(u32 i)
+		{
+			return m_lights[i];
+		}
+
+		inline const SClusterRange& getLightRange(u32 i)
+		{
+			return m_lightRanges[i];
+		}
+
+		inline bool isBuilt()
+		{
+			return m_built;
+		}
+
+	protected:
+
+		u32 getSlice(float z);
+
+		u32 getTile(float ndc, u32 size);
+	};
+}
@@ -103,7 +103,18 @@ namespace Skylicht
 
 	void CLightSystem::update(CEntityManager* entityManager)
 	{
+		m_gridLights.set_used(0);
 
+		for (u32 i = 0, n = m_pointLights.size(); i < n; i++)
+			m_gridLights.push_back(m_pointLights[i]);
+
+		for (u32 i = 0, n = m_spotLights.size(); i < n; i++)
+			m_gridLights.push_back(m_spotLights[i]);
+
+		for (u32 i = 0, n = m_areaLights.size(); i < n; i++)
+			m_gridLights.push_back(m_areaLights[i]);
+
+		m_lightGrid.build(entityManager->getCamera(), m_gridLights.pointer(), m_gridLights.size());
 	}
 
 	void CLightSystem::render(CEntityManager* entityManager)
@@ -137,9 +148,9 @@ namespace Skylicht
 		// direction light
 		m_sorts.set_used(0);
 		CLightCullingData** lights = m_dirLights.pointer();
-		int lightCount = m_dirLights.size();
+		int numDirLight = m_dirLights.size();
 
-		for (int i = 0; i < lightCount; i++)
+		for (int i = 0; i < numDirLight; i++)
 		{
 			CLight* light = lights[i]->Light;
 
@@ -177,73 +188,65 @@ namespace Skylicht
 
 		core::vector3df position = transform->getWorldPosition();
 
-		// point light
-		lights = m_pointLights.pointer();
-		lightCount = m_pointLights.size();
+		// the lights from the clusters that the mesh bounds overlap
+		core::aabbox3df box = data->getMesh()->getBoundingBox();
+		transform->World.transformBoxEx(box);
 
-		sortLights(position, objLayer, lights, lightCount);
+		m_meshLights.set_used(0);
+		m_lightGrid.getLights(box, m_meshLights);
 
-		lightCount = m_sorts.size();
-		lightCount = core::min_(lightCount, 4);
+		CLight* nearest[4];
+
+		// point light
+		int lightCount = selectLights(position, objLayer, CLight::PointLight, nearest);
 		for (int i = 0; i < lightCount; i++)
-			CShaderLighting::setPointLight((CPointLight*)m_sorts[i].Light, i);
+			CShaderLighting::setPointLight((CPointLight*)nearest[i], i);
 
 		// spotlight
-		lights = m_spotLights.pointer();
-		lightCount = m_spotLights.size();
-
-		sortLights(position, objLayer, lights, lightCount);
-
-		lightCount = m_sorts.size();
-		lightCount = core::min_(lightCount, 4);
+		lightCount = selectLights(position, objLayer, CLight::SpotLight, nearest);
 		for (int i = 0; i < lightCount; i++)
-			CShaderLighting::setSpotLight((CSpotLight*)m_sorts[i].Light, i);
+			CShaderLighting::setSpotLight((CSpotLight*)nearest[i], i);
 
 		// area light
-		lights = m_areaLights.pointer();
-		lightCount = m_areaLights.size();
-
-		sortLights(position, objLayer, lights, lightCount);
-
-		lightCount = m_sorts.size();
-		lightCount = core::min_(lightCount, 4);
+		lightCount = selectLights(position, objLayer, CLight::AreaLight, nearest);
 		for (int i = 0; i < lightCount; i++)
-			CShaderLighting::setAreaLight((CAreaLight*)m_sorts[i].Light, i);
+			CShaderLighting::setAreaLight((CAreaLight*)nearest[i], i);
 	}
 
-	void CLightSystem::sortLights(const core::vector3df& position, u32 objLayer, CLightCullingData** lights, int lightCount)
+	int CLightSystem::selectLights(const core::vector3df& position, u32 objLayer, int lightType, CLight** result)
 	{
-		SDistanceLightEntry entry;
-		m_sorts.set_used(0);
+		float distance[4];
+		int n = 0;
 
-		for (int i = 0; i < lightCount; i++)
+		CLightCullingData** lights = m_meshLights.pointer();
+		for (u32 i = 0, numLight = m_meshLights.size(); i < numLight; i++)
 		{
-			CLight* light = lights[i]->Light;
-			u32 lightLayer = light->getLightLayers();
+			CLightCullingData* data = lights[i];
+			if (data->LightType != lightType)
+				continue;
 
-			if (objLayer & lightLayer)
-			{
-				entry.Data = lights[i];
-				entry.Light = light;
-				entry.Distance = lights[i]->LightPosition.getDistanceFromSQ(position);
+			CLight* light = data->Light;
+			if ((objLayer & light->getLightLayers()) == 0)
+				continue;
 
-				int n = m_sorts.size();
-				if (n == 0 || entry.Distance > m_sorts[n - 1].Distance)
-					m_sorts.push_back(entry);
-				else
-				{
-					// insert sort by distance
-					for (int i = 0; i < n; i++)
-					{
-						if (entry.Distance < m_sorts[i].Distance)
-						{
-							m_sorts.insert(entry, i);
-							break;
-						}
-					}
-				}
+			float d = data->LightPosition.getDistanceFromSQ(position);
+			if (n == 4 && d >= distance[3])
+				continue;
+
+			// insert sort on the 4 nearest
+			int j = n < 4 ? n++ : 3;
+			while (j > 0 && distance[j - 1] > d)
+			{
+				distance[j] = distance[j - 1];
+				result[j] = result[j - 1];
+				j--;
 			}
+
+			distance[j] = d;
+			result[j] = light;
 		}
+
+		return n;
 	}
 
 	void CLightSystem::onEndSetupLight()
@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #pragma once
 
 #include "CLightCullingData.h"
+#include "CLightGrid.h"
 #include "Entity/IRenderSystem.h"
 #include "Entity/CEntityGroup.h"
 #include "Transform/CWorldTransformData.h"
@@ -61,6 +62,14 @@ namespace Skylicht
 
 		core::array<SDistanceLightEntry> m_sorts;
 
+		// the point, spot and area lights on the grid
+		core::array<CLightCullingData*> m_gridLights;
+
+		// the lights that touch the current mesh
+		core::array<CLightCullingData*> m_meshLights;
+
+		CLightGrid m_lightGrid;
+
 	public:
 		CLightSystem();
 
@@ -82,9 +91,16 @@ namespace Skylicht
 
 		void onEndSetupLight();
 
+		/// @brief The clustered light grid of the current camera, it is built on update
+		inline CLightGrid* getLightGrid()
+		{
+			return &m_lightGrid;
+		}
+
 	protected:
 
-		void sortLights(const core::vector3df& position, u32 objLayer, CLightCullingData** lights, int lightCount);
+		/// @brief Select the 4 nearest lights of a type from the lights of the current mesh
+		int selectLights(const core::vector3df& position, u32 objLayer, int lightType, CLight** result);
 
 	};
 }
\ No newline at end of file
@@ -1077,26 +1077,39 @@ namespace Skylicht
 #endif
 			}
 
+			for (int i = 0; i < m_numVSUniform; i++)
+			{
+				m_listVSUniforms[i].Frequency = getUniformFrequency(m_listVSUniforms[i].Type);
+				m_listVSUniforms[i].Version = 0;
+			}
+
+			for (int i = 0; i < m_numFSUniform; i++)
+			{
+				m_listFSUniforms[i].Frequency = getUniformFrequency(m_listFSUniforms[i].Type);
+				m_listFSUniforms[i].Version = 0;
+			}
+
+			m_uniformCache.invalidate();
+
 			m_initCallback = false;
 		}
 
+		CShaderManager* shaderManager = CShaderManager::getInstance();
+		bool useCache = shaderManager->isUniformCacheEnabled();
+
+		// the built-in uniforms and the callbacks send the values through the cache
+		m_uniformCache.begin(matRender, useCache);
+		matRender = &m_uniformCache;
+
+		if (useCache)
+			shaderManager->updateUniformVersion(driver);
+
 		// todo set vertex shader
 		for (int i = 0; i < m_numVSUniform; i++)
 		{
 			SUniform& uniform = m_listVSUniforms[i];
 			if (uniform.UniformShaderID >= 0)
-			{
-				// builtin callback
-				if (setUniform(uniform, matRender, true, updateTransform) == false)
-				{
-					// plugin callback
-					for (IShaderCallback* cb : m_callbacks)
-					{
-						cb->OnSetConstants(this, &uniform, matRender, true);
-					}
-				}
-
-			}
+				setConstant(uniform, matRender, true, updateTransform, useCache);
 		}
 
 		// todo set pixel shader
@@ -1104,18 +1117,72 @@ namespace Skylicht
 		{
 			SUniform& uniform = m_listFSUniforms[i];
 			if (uniform.UniformShaderID >= 0)
+				setConstant(uniform, matRender, false, updateTransform, useCache);
+		}
+	}
+
+	void CShader::setConstant(SUniform& uniform, IMaterialRenderer* matRender, bool vertexShader, bool updateTransform, bool useVersion)
+	{
+		CShaderManager* shaderManager = CShaderManager::getInstance();
+		shaderManager->getUniformStats().NumUniform++;
+
+		// the transform uniforms are only sent on updateTransform, the version is only valid after they are sent
+		u32 version = 0;
+		if (useVersion && updateTransform)
+		{
+			if (uniform.Frequency == PerFrame)
+				version = shaderManager->getFrameVersion();
+			else if (uniform.Frequency == PerView)
+				version = shaderManager->getViewVersion();
+
+			if (version != 0 && uniform.Version == version)
 			{
-				// builtin callback
-				if (setUniform(uniform, matRender, false, updateTransform) == false)
-				{
-					// plugin callback
-					for (IShaderCallback* cb : m_callbacks)
-					{
-						cb->OnSetConstants(this, &uniform, matRender, false);
-					}
-				}
+				shaderManager->getUniformStats().NumSkipVersion++;
+				return;
+			}
+		}
+
+		// builtin callback
+		if (setUniform(uniform, matRender, vertexShader, updateTransform) == false)
+		{
+			// plugin callback
+			for (IShaderCallback* cb : m_callbacks)
+			{
+				cb->OnSetConstants(this, &uniform, matRender, vertexShader);
 			}
 		}
+
+		uniform.Version = version;
+	}
+
+	EUniformFrequency CShader::getUniformFrequency(EUniformType type)
+	{
+		switch (type)
+		{
+		case TIME:
+		case TIME_STEP:
+			return PerFrame;
+		case VIEW:
+		case VIEW_PROJECTION:
+		case WORLD_CAMERA_POSITION:
+		case DEFERRED_VIEW:
+		case DEFERRED_PROJECTION:
+		case DEFERRED_VIEW_PROJECTION:
+		case PARTICLE_VIEW_UP:
+		case PARTICLE_VIEW_LOOK:
+			return PerView;
+		case MATERIAL_PARAM:
+		case DEFAULT_VALUE:
+		case SHADER_VEC2:
+		case SHADER_VEC3:
+		case SHADER_VEC4:
+		case TEXTURE_MIPMAP_COUNT:
+		case TEXTURE_WIDTH_HEIGHT:
+		case COLOR_INTENSITY:
+			return PerMaterial;
+		default:
+			return PerObject;
+		}
 	}
 
 	bool CShader::setUniform(SUniform& uniform, IMaterialRenderer* matRender, bool vertexShader, bool updateTransform)
@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #pragma once
 
 #include "CBaseShaderCallback.h"
+#include "CShaderUniformCache.h"
 #include "Instancing/IShaderInstancing.h"
 
 namespace Skylicht
@@ -90,6 +91,19 @@ namespace Skylicht
 		NUM_SHADER_TYPE,
 	};
 
+	/**
+	 * @brief How often the value of a uniform can change, see CShader::getUniformFrequency.
+	 * The per-frame and per-view uniforms are skipped while CShaderManager::getFrameVersion or getViewVersion does not change,
+	 * the per-material and per-object uniforms are evaluated on each draw and only sent when the value changes.
+	 */
+	enum EUniformFrequency
+	{
+		PerFrame,
+		PerView,
+		PerMaterial,
+		PerObject,
+	};
+
 	/**
 	 * @brief Structure describing a shader uniform.
 	 * Holds name, type, values, binding info and platform specifics.
@@ -140,6 +154,12 @@ namespace Skylicht
 		/// Maximum allowed value(for UI)
 		float Max;
 
+		/// How often the value changes (see EUniformFrequency)
+		EUniformFrequency Frequency;
+
+		/// The frame or view version of the last set, 0 if it is not set
+		u32 Version;
+
 		/**
 		 * @brief Default constructor initializing values.
 		 */
@@ -160,6 +180,9 @@ namespace Skylicht
 			Type = NUM_SHADER_TYPE;
 			Min = -FLT_MAX;
 			Max = FLT_MAX;
+
+			Frequency = PerObject;
+			Version = 0;
 		}
 	};
 
@@ -440,6 +463,9 @@ namespace Skylicht
 
 		/// Source file path
 		std::string m_source;
+
+		/// The last uniform values sent to the material renderer
+		CShaderUniformCache m_uniformCache;
 	public:
 		/**
 		 * @brief Constructor. Initializes internal structures and built-in callbacks.
@@ -836,6 +862,11 @@ namespace Skylicht
 			return m_shadow;
 		}
 
+		/**
+		 * @brief Get the update frequency of a uniform type.
+		 */
+		static EUniformFrequency getUniformFrequency(EUniformType type);
+
 	protected:
 		/**
 		 * @brief Get the base shader type by its name string (SOLID, TRANSPARENT, etc.).
@@ -886,6 +917,11 @@ namespace Skylicht
 		 */
 		bool setUniform(SUniform& uniform, IMaterialRenderer* matRender, bool vertexShader, bool updateTransform);
 
+		/**
+		 * @brief Evaluate and send a uniform, skip it if its frame or view version did not change.
+		 */
+		void setConstant(SUniform& uniform, IMaterialRenderer* matRender, bool vertexShader, bool updateTransform, bool useVersion);
+
 		/**
 		 * @brief Delete all UI elements.
 		 */
@@ -39,6 +39,12 @@ namespace Skylicht
 	CShaderManager::CShaderManager() :
 		m_currentMeshBuffer(NULL),
 		m_currentMatRendering(NULL),
+		m_uniformCache(true),
+		m_uniformCacheVersion(1),
+		m_frameVersion(1),
+		m_viewVersion(1),
+		m_lastTotalTime(-1.0f),
+		m_lastTimeStep(-1.0f),
 		BoneMatrix(NULL),
 		BoneCount(0),
 		LightmapIndex(0)
@@ -50,6 +56,37 @@ namespace Skylicht
 		releaseAll();
 	}
 
+	void CShaderManager::setUniformCache(bool b)
+	{
+		if (b && !m_uniformCache)
+			m_uniformCacheVersion++;
+
+		m_uniformCache = b;
+	}
+
+	void CShaderManager::updateUniformVersion(IVideoDriver* driver)
+	{
+		const core::matrix4& view = driver->getTransform(video::ETS_VIEW);
+		const core::matrix4& projection = driver->getTransform(video::ETS_PROJECTION);
+
+		if (view != m_lastView || projection != m_lastProjection)
+		{
+			m_lastView = view;
+			m_lastProjection = projection;
+			m_viewVersion++;
+		}
+
+		float totalTime = getTotalTime();
+		float timeStep = getTimeStep();
+
+		if (totalTime != m_lastTotalTime || timeStep != m_lastTimeStep)
+		{
+			m_lastTotalTime = totalTime;
+			m_lastTimeStep = timeStep;
+			m_frameVersion++;
+		}
+	}
+
 	void CShaderManager::releaseAll()
 	{
 		for (u32 i = 0, n = (u32)m_listShader.size(); i < n; i++)
@@ -81,6 +118,7 @@ namespace Skylicht
 		loadShader("BuiltIn/Shader/Basic/TextureColorAlpha.xml");
 		loadShader("BuiltIn/Shader/Basic/TextureColorAlphaBGR.xml");
 		loadShader("BuiltIn/Shader/Basic/TextureColorAlphaBW.xml");
+		loadShader("BuiltIn/Shader/Basic/TextureColorSDF.xml");
 	}
 
 	void CShaderManager::initBasicShader()
@@ -93,6 +131,7 @@ namespace Skylicht
 		loadShader("BuiltIn/Shader/Basic/TextureColorAlpha.xml");
 		loadShader("BuiltIn/Shader/Basic/TextureColorAlphaBGR.xml");
 		loadShader("BuiltIn/Shader/Basic/TextureColorAlphaBW.xml");
+		loadShader("BuiltIn/Shader/Basic/TextureColorSDF.xml");
 
 		loadShader("BuiltIn/Shader/Basic/TextureColorAdditive.xml");
 		loadShader("BuiltIn/Shader/Basic/TextureColor2LayerAdditive.xml");
@@ -36,6 +36,35 @@ namespace Skylicht
 	class IShaderCallback;
 	class IShaderInstancing;
 
+	/// @brief The counters of the uniform updates in CShader::OnSetConstants
+	struct SUniformStats
+	{
+		/// The uniforms visited
+		u32 NumUniform;
+
+		/// The per-frame and per-view uniforms skipped, because their version did not change
+		u32 NumSkipVersion;
+
+		/// The values skipped, because they are the same as the last upload on the same shader
+		u32 NumSkipValue;
+
+		/// The values sent to the material renderer
+		u32 NumUpload;
+
+		SUniformStats()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			NumUniform = 0;
+			NumSkipVersion = 0;
+			NumSkipValue = 0;
+			NumUpload = 0;
+		}
+	};
+
 	/// @brief Centralized manager for loading, caching, rebuilding, and controlling shader objects in Skylicht-Engine.
 	/// @ingroup Materials
 	/// 
@@ -68,6 +97,28 @@ namespace Skylicht
 		/// Map from shader name to internal material ID
 		std::map<std::string, int> m_listShaderID;
 
+		/// Skip the uniforms that did not change (see CShaderUniformCache)
+		bool m_uniformCache;
+
+		/// Bumped when the uniform cache is enabled again
+		u32 m_uniformCacheVersion;
+
+		SUniformStats m_uniformStats;
+
+		/// Bumped when the time changes
+		u32 m_frameVersion;
+
+		/// Bumped when the view or projection changes
+		u32 m_viewVersion;
+
+		core::matrix4 m_lastView;
+
+		core::matrix4 m_lastProjection;
+
+		float m_lastTotalTime;
+
+		float m_lastTimeStep;
+
 	public:
 		// Uniform storage for current draw command (used by shaders)
 
@@ -262,6 +313,57 @@ namespace Skylicht
 			return m_listShader[i];
 		}
 
+		/**
+		 * @brief Enable or disable the uniform cache. When it is disabled, every uniform is evaluated and sent on each draw.
+		 */
+		void setUniformCache(bool b);
+
+		inline bool isUniformCacheEnabled()
+		{
+			return m_uniformCache;
+		}
+
+		inline u32 getUniformCacheVersion()
+		{
+			return m_uniformCacheVersion;
+		}
+
+		/**
+		 * @brief Get the counters of the uniform updates, they count until resetUniformStats.
+		 */
+		inline SUniformStats& getUniformStats()
+		{
+			return m_uniformStats;
+		}
+
+		inline void resetUniformStats()
+		{
+			m_uniformStats.reset();
+		}
+
+		/**
+		 * @brief Update the frame and view version by the time and the transforms of the driver, called by CShader::OnSetConstants.
+		 */
+		void updateUniformVersion(IVideoDriver* driver);
+
+		/**
+		 * @brief Notify that a view value that is not on the driver transform has changed (camera, deferred view, particle billboard).
+		 */
+		inline void notifyViewChanged()
+		{
+			m_viewVersion++;
+		}
+
+		inline u32 getFrameVersion()
+		{
+			return m_frameVersion;
+		}
+
+		inline u32 getViewVersion()
+		{
+			return m_viewVersion;
+		}
+
 	protected:
 
 		/**
@@ -0,0 +1,118 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CShaderUniformCache.h"
+#include "CShaderManager.h"
+
+namespace Skylicht
+{
+	CShaderUniformCache::CShaderUniformCache() :
+		m_renderer(NULL),
+		m_enable(true),
+		m_resetVersion(0)
+	{
+
+	}
+
+	CShaderUniformCache::~CShaderUniformCache()
+	{
+
+	}
+
+	void CShaderUniformCache::begin(video::IMaterialRenderer* renderer, bool enable)
+	{
+		// the cache is reset when it is enabled again, the values were sent without the cache
+		u32 resetVersion = CShaderManager::getInstance()->getUniformCacheVersion();
+		if (m_renderer != renderer || m_resetVersion != resetVersion)
+		{
+			invalidate();
+			m_resetVersion = resetVersion;
+		}
+
+		m_renderer = renderer;
+		m_enable = enable;
+	}
+
+	void CShaderUniformCache::invalidate()
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			for (SSlot& slot : m_slots[i])
+				slot.Valid = false;
+		}
+	}
+
+	s32 CShaderUniformCache::getShaderVariableID(const c8* name, video::E_SHADER_TYPE shaderType)
+	{
+		return m_renderer->getShaderVariableID(name, shaderType);
+	}
+
+	void CShaderUniformCache::setShaderVariable(s32 id, const f32* value, int count, video::E_SHADER_TYPE shaderType)
+	{
+		SUniformStats& stats = CShaderManager::getInstance()->getUniformStats();
+
+		if (!m_enable || id < 0 || count <= 0 ||
+			(shaderType != video::EST_VERTEX_SHADER && shaderType != video::EST_PIXEL_SHADER))
+		{
+			stats.NumUpload++;
+			m_renderer->setShaderVariable(id, value, count, shaderType);
+			return;
+		}
+
+		int type = shaderType == video::EST_VERTEX_SHADER ? 0 : 1;
+
+		std::vector<SSlot>& slots = m_slots[type];
+		std::vector<float>& values = m_values[type];
+
+		if ((int)slots.size() <= id)
+		{
+			SSlot empty = { 0, 0, false };
+			slots.resize(id + 1, empty);
+		}
+
+		SSlot& slot = slots[id];
+		if (slot.Count < count)
+		{
+			// the size of a uniform does not change, this allocates one time
+			slot.Offset = (int)values.size();
+			slot.Count = count;
+			slot.Valid = false;
+			values.resize(values.size() + count);
+		}
+
+		float* cache = values.data() + slot.Offset;
+		if (slot.Valid && memcmp(cache, value, sizeof(float) * count) == 0)
+		{
+			stats.NumSkipValue++;
+			return;
+		}
+
+		memcpy(cache, value, sizeof(float) * count);
+		slot.Valid = true;
+
+		stats.NumUpload++;
+		m_renderer->setShaderVariable(id, value, count, shaderType);
+	}
+}
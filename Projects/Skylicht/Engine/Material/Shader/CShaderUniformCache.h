@@ -0,0 +1,72 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	/// @brief Keeps the last values that a shader sent to its material renderer, and drops the set that does not change the value.
+	///
+	/// CShader::OnSetConstants passes this object to the built-in uniforms and the IShaderCallback as the material renderer,
+	/// so the callbacks do not need to know about the cache. The uniform values of the shader program stay on the GPU (OpenGL program, D3D11 constant buffer),
+	/// so a value that equals the last upload of the same shader can be skipped.
+	class SKYLICHT_API CShaderUniformCache : public video::IMaterialRenderer
+	{
+	protected:
+		struct SSlot
+		{
+			int Offset;
+			int Count;
+			bool Valid;
+		};
+
+		// vertex and pixel shader
+		std::vector<SSlot> m_slots[2];
+
+		std::vector<float> m_values[2];
+
+		video::IMaterialRenderer* m_renderer;
+
+		bool m_enable;
+
+		u32 m_resetVersion;
+
+	public:
+		CShaderUniformCache();
+
+		virtual ~CShaderUniformCache();
+
+		/// @brief Begin the constants of a draw
+		/// @param renderer The material renderer of the shader
+		/// @param enable False to send all values, the uploads are still counted
+		void begin(video::IMaterialRenderer* renderer, bool enable);
+
+		/// @brief Forget the cached values, the next set always uploads
+		void invalidate();
+
+		virtual s32 getShaderVariableID(const c8* name, video::E_SHADER_TYPE shaderType);
+
+		virtual void setShaderVariable(s32 id, const f32* value, int count, video::E_SHADER_TYPE shaderType);
+	};
+}
@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CShaderCamera.h"
 #include "Camera/CCamera.h"
 #include "GameObject/CGameObject.h"
+#include "Material/Shader/CShaderManager.h"
 
 namespace Skylicht
 {
@@ -34,6 +35,7 @@ namespace Skylicht
 	void CShaderCamera::setCamera(CCamera* camera)
 	{
 		g_camera = camera;
+		CShaderManager::getInstance()->notifyViewChanged();
 	}
 
 	CShaderCamera::CShaderCamera()
@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CShaderDeferred.h"
+#include "Material/Shader/CShaderManager.h"
 
 namespace Skylicht
 {
@@ -35,12 +36,14 @@ namespace Skylicht
 	{
 		g_projection = mat;
 		g_viewProjection = g_projection;
+		CShaderManager::getInstance()->notifyViewChanged();
 	}
 
 	void CShaderDeferred::setView(const core::matrix4& mat)
 	{
 		g_view = mat;
 		g_viewProjection = g_projection * g_view;
+		CShaderManager::getInstance()->notifyViewChanged();
 	}
 
 	CShaderDeferred::CShaderDeferred()
@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CShaderParticle.h"
+#include "Material/Shader/CShaderManager.h"
 
 namespace Skylicht
 {
@@ -49,6 +50,7 @@ namespace Skylicht
 		g_viewUp.Y = up.Y;
 		g_viewUp.Z = up.Z;
 		g_viewUp.W = 0.0f;
+		CShaderManager::getInstance()->notifyViewChanged();
 	}
 
 	void CShaderParticle::setViewLook(const core::vector3df& look)
@@ -57,6 +59,7 @@ namespace Skylicht
 		g_viewLook.Y = look.Y;
 		g_viewLook.Z = look.Z;
 		g_viewLook.W = 0.0f;
+		CShaderManager::getInstance()->notifyViewChanged();
 	}
 
 	void CShaderParticle::setOrientationUp(const core::vector3df& up)
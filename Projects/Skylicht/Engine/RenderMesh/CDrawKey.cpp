@@ -0,0 +1,177 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CDrawKey.h"
+
+namespace Skylicht
+{
+	u32 CDrawKey::getDepthBucket(float distance, float farValue, u32 bits)
+	{
+		u32 maxBucket = (1u << bits) - 1;
+		if (farValue <= 0.0f || distance <= 0.0f)
+			return 0;
+
+		float t = core::clamp(distance / farValue, 0.0f, 1.0f);
+
+		// more precision near the camera
+		t = sqrtf(t);
+
+		return (u32)(t * (float)maxBucket + 0.5f);
+	}
+
+	static void getStateID(CMaterial* material, u32& shaderId, u32& materialId, u32& textureId)
+	{
+		shaderId = 0;
+		materialId = 0;
+		textureId = 0;
+
+		if (material == NULL)
+			return;
+
+		CShader* shader = material->getShader();
+		if (shader != NULL)
+			shaderId = ((u32)shader->getMaterialRenderID() + 1) & 0x3ff;
+
+		materialId = CDrawKey::getPointerID(material, 14);
+
+		ITexture* texture = material->getTexture(0);
+		if (texture != NULL)
+			textureId = CDrawKey::getPointerID(texture, 14);
+	}
+
+	u64 CDrawKey::makeOpaqueKey(CMaterial* material, IMeshBuffer* mb, u32 depth)
+	{
+		u32 shaderId, materialId, textureId;
+		getStateID(material, shaderId, materialId, textureId);
+
+		u64 key = (u64)Opaque << 62;
+		key |= (u64)shaderId << 52;
+		key |= (u64)materialId << 38;
+		key |= (u64)textureId << 24;
+		key |= (u64)getPointerID(mb, 16) << 8;
+		key |= (u64)(depth & 0xff);
+		return key;
+	}
+
+	u64 CDrawKey::makeTransparentKey(CMaterial* material, IMeshBuffer* mb, u32 depth)
+	{
+		u32 shaderId, materialId, textureId;
+		getStateID(material, shaderId, materialId, textureId);
+
+		u64 key = (u64)Transparent << 62;
+		key |= (u64)(0xffff - (depth & 0xffff)) << 46;
+		key |= (u64)shaderId << 36;
+		key |= (u64)materialId << 22;
+		key |= (u64)textureId << 8;
+		key |= (u64)getPointerID(mb, 8);
+		return key;
+	}
+
+	u64 CDrawKey::makeMeshKey(CMesh* mesh, bool transparent, u32 depth)
+	{
+		CMaterial* material = NULL;
+		IMeshBuffer* mb = NULL;
+
+		if (mesh->getMeshBufferCount() > 0)
+		{
+			mb = mesh->getMeshBuffer(0);
+			if (mesh->Materials.size() > 0)
+				material = mesh->Materials[0];
+		}
+
+		if (transparent)
+			return makeTransparentKey(material, mb, depth);
+
+		return makeOpaqueKey(material, mb, depth);
+	}
+
+	SDrawKey* CDrawKey::sort(SDrawKey* keys, SDrawKey* temp, u32 count)
+	{
+		if (count <= 1)
+			return keys;
+
+		// small lists, insert sort is faster than 8 histogram passes
+		if (count <= 32)
+		{
+			for (u32 i = 1; i < count; i++)
+			{
+				SDrawKey k = keys[i];
+				u32 j = i;
+				while (j > 0 && keys[j - 1].Key > k.Key)
+				{
+					keys[j] = keys[j - 1];
+					j--;
+				}
+				keys[j] = k;
+			}
+			return keys;
+		}
+
+		// count all 8 digits in one read
+		u32 histogram[8][256];
+		memset(histogram, 0, sizeof(histogram));
+
+		for (u32 i = 0; i < count; i++)
+		{
+			u64 key = keys[i].Key;
+			for (u32 d = 0; d < 8; d++)
+				histogram[d][(key >> (d * 8)) & 0xff]++;
+		}
+
+		SDrawKey* src = keys;
+		SDrawKey* dst = temp;
+
+		for (u32 d = 0; d < 8; d++)
+		{
+			u32* h = histogram[d];
+
+			// skip the digit that all keys share, the high fields usually do
+			u32 first = (u32)((keys[0].Key >> (d * 8)) & 0xff);
+			if (h[first] == count)
+				continue;
+
+			u32 offset = 0;
+			for (u32 b = 0; b < 256; b++)
+			{
+				u32 c = h[b];
+				h[b] = offset;
+				offset += c;
+			}
+
+			u32 shift = d * 8;
+			for (u32 i = 0; i < count; i++)
+			{
+				u32 b = (u32)((src[i].Key >> shift) & 0xff);
+				dst[h[b]++] = src[i];
+			}
+
+			SDrawKey* t = src;
+			src = dst;
+			dst = t;
+		}
+
+		return src;
+	}
+}
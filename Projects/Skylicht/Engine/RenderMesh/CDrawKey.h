@@ -0,0 +1,115 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CMesh.h"
+#include "Material/CMaterial.h"
+
+namespace Skylicht
+{
+	/// @brief A draw sort key and the index of the item it sorts in the render list.
+	struct SDrawKey
+	{
+		u64 Key;
+		u32 Index;
+	};
+
+	/**
+	 * @brief Packs the render state of a draw into a 64-bit key, so the render lists sort by one integer compare.
+	 *
+	 * Opaque key, high to low bits: pass (2), shader (10), material (14), texture (14), mesh buffer (16), depth (8).
+	 * Transparent key: pass (2), inverted depth (16), shader (10), material (14), texture (14), mesh buffer (8).
+	 * The material, texture and mesh buffer IDs are folded from their pointers. Two objects that fold to the same ID
+	 * only break the batch, the draw is still correct.
+	 */
+	class SKYLICHT_API CDrawKey
+	{
+	public:
+		enum EPass
+		{
+			Opaque = 0,
+			Transparent = 1,
+		};
+
+		/// @brief Fold a pointer into a small ID of the given bits.
+		static inline u32 getPointerID(const void* p, u32 bits)
+		{
+			u64 v = (u64)(size_t)p;
+			// the low bits are allocator alignment
+			v = (v >> 4) ^ (v >> 21) ^ (v >> 37);
+			return (u32)(v & ((1ull << bits) - 1));
+		}
+
+		/// @brief Quantize a camera distance in [0, farValue] to a bucket, with more buckets near the camera.
+		static u32 getDepthBucket(float distance, float farValue, u32 bits);
+
+		/// @brief Build the key of an opaque draw.
+		static u64 makeOpaqueKey(CMaterial* material, IMeshBuffer* mb, u32 depth);
+
+		/// @brief Build the key of a transparent draw, the far draws sort first.
+		static u64 makeTransparentKey(CMaterial* material, IMeshBuffer* mb, u32 depth);
+
+		/// @brief Build the key of a mesh by its first material and mesh buffer, same as the order the renderers batch.
+		static u64 makeMeshKey(CMesh* mesh, bool transparent, u32 depth);
+
+		/**
+		 * @brief Stable LSD radix sort by key.
+		 * @param keys The keys to sort.
+		 * @param temp A buffer of the same count.
+		 * @param count The number of keys.
+		 * @return The buffer (keys or temp) that holds the sorted result.
+		 */
+		static SDrawKey* sort(SDrawKey* keys, SDrawKey* temp, u32 count);
+
+		/// @brief Compute the sort keys of a render list, sort them and write the list in key order.
+		template<class T, class TKeyFunc>
+		static void sortList(core::array<T>& list, core::array<SDrawKey>& keys, core::array<SDrawKey>& temp, core::array<T>& sorted, TKeyFunc keyFunc)
+		{
+			u32 count = list.size();
+			if (count <= 1)
+				return;
+
+			keys.set_used(count);
+			temp.set_used(count);
+
+			T* items = list.pointer();
+			SDrawKey* k = keys.pointer();
+			for (u32 i = 0; i < count; i++)
+			{
+				k[i].Key = keyFunc(items[i]);
+				k[i].Index = i;
+			}
+
+			SDrawKey* result = sort(k, temp.pointer(), count);
+
+			sorted.set_used(count);
+			T* s = sorted.pointer();
+			for (u32 i = 0; i < count; i++)
+				s[i] = items[result[i].Index];
+
+			list.swap(sorted);
+		}
+	};
+}
@@ -107,4 +107,10 @@ namespace Skylicht
 		m_needQuery = false;
 		m_needValidate = true;
 	}
+
+	bool CGroupMesh::onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+		// the query depends on the mesh state of entity, so re-query all
+		return false;
+	}
 }
\ No newline at end of file
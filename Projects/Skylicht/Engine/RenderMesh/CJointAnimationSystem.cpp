@@ -26,13 +26,16 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CJointAnimationSystem.h"
 #include "Entity/CEntityManager.h"
 #include "Culling/CVisibleData.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
 	CJointAnimationSystem::CJointAnimationSystem() :
 		m_group(NULL)
 	{
-
+		declareReadData(DATA_TYPE_INDEX(CWorldTransformData));
+		declareReadData(DATA_TYPE_INDEX(CWorldInverseTransformData));
+		declareWriteData(DATA_TYPE_INDEX(CJointData));
 	}
 
 	CJointAnimationSystem::~CJointAnimationSystem()
@@ -71,28 +74,31 @@ namespace Skylicht
 	{
 		CEntity** allEntities = entityManager->getEntities();
 
-		for (int i = 0; i < numEntity; i++)
-		{
-			CEntity* entity = entities[i];
-
-			CJointData* joint = GET_ENTITY_DATA(entity, CJointData);
-			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
-
-			if (transform->NeedValidate && joint->RootIndex != 0)
+		System::CJobSystem::runParallelFor(numEntity, 256, [entities, allEntities](int begin, int end)
 			{
-				CWorldInverseTransformData* rootInvTransform = GET_ENTITY_DATA(allEntities[joint->RootIndex], CWorldInverseTransformData);
-
-				if (rootInvTransform != NULL)
-				{
-					// move bone transform to Zero location
-					joint->AnimationMatrix.setbyproduct_nocheck(rootInvTransform->WorldInverse, transform->World);
-				}
-				else
+				for (int i = begin; i < end; i++)
 				{
-					// if will have bugs if the SkinnedMesh isnot stand at Zero location
-					joint->AnimationMatrix = transform->World;
+					CEntity* entity = entities[i];
+
+					CJointData* joint = GET_ENTITY_DATA(entity, CJointData);
+					CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+
+					if (transform->NeedValidate && joint->RootIndex != 0)
+					{
+						CWorldInverseTransformData* rootInvTransform = GET_ENTITY_DATA(allEntities[joint->RootIndex], CWorldInverseTransformData);
+
+						if (rootInvTransform != NULL)
+						{
+							// move bone transform to Zero location
+							joint->AnimationMatrix.setbyproduct_nocheck(rootInvTransform->WorldInverse, transform->World);
+						}
+						else
+						{
+							// if will have bugs if the SkinnedMesh isnot stand at Zero location
+							joint->AnimationMatrix = transform->World;
+						}
+					}
 				}
-			}
-		}
+			});
 	}
 }
\ No newline at end of file
@@ -32,12 +32,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Material/Shader/ShaderCallback/CShaderLighting.h"
 
 #include "Lighting/CLightSystem.h"
+#include "Camera/CCamera.h"
 
 namespace Skylicht
 {
-	CMeshRenderer::CMeshRenderer()
+	CMeshRenderer::CMeshRenderer() :
+		m_sortTransparent(false)
 	{
 		m_pipelineType = IRenderPipeline::Mix;
+		m_cullingDependent = true;
 	}
 
 	CMeshRenderer::~CMeshRenderer()
@@ -95,86 +98,26 @@ namespace Skylicht
 
 	}
 
-	int cmpRenderMeshFunc(const void* a, const void* b)
+	void CMeshRenderer::update(CEntityManager* entityManager)
 	{
-		CRenderMeshData* pa = *((CRenderMeshData**)a);
-		CRenderMeshData* pb = *((CRenderMeshData**)b);
-
-		CMesh* meshA = pa->getMesh();
-		CMesh* meshB = pb->getMesh();
-
-		std::vector<CMaterial*>& materialsA = meshA->Materials;
-		std::vector<CMaterial*>& materialsB = meshB->Materials;
-
-		// no material, compare by mesh
-		if (materialsA.size() == 0 || materialsA.size() == 0)
-		{
-			if (meshA == meshB)
-				return 0;
+		// need sort render by shader, material, texture, mesh and front to back
+		core::vector3df cameraPosition;
+		float farValue = 0.0f;
 
-			return meshA < meshB ? -1 : 1;
-		}
-
-		CMaterial* materialA = materialsA[0];
-		CMaterial* materialB = materialsB[0];
-
-		// compare by mesh
-		if (materialA == NULL || materialB == NULL)
+		CCamera* camera = entityManager->getCamera();
+		if (camera != NULL)
 		{
-			IMeshBuffer* mbA = meshA->getMeshBuffer(0);
-			IMeshBuffer* mbB = meshB->getMeshBuffer(0);
-
-			if (mbA == mbB)
-				return 0;
-
-			return mbA < mbB ? -1 : 1;
+			cameraPosition = camera->getPosition();
+			farValue = camera->getFarValue();
 		}
 
-		// comprate by texture
-		ITexture* textureA = materialA->getTexture(0);
-		ITexture* textureB = materialB->getTexture(0);
-
-		// if no texture
-		if (textureA == NULL || textureB == NULL)
-		{
-			if (materialA == materialB)
+		CDrawKey::sortList(m_meshs, m_keys, m_sortKeys, m_sortMeshs,
+			[&](CRenderMeshData* meshData)
 			{
-				// compare mesh
-				IMeshBuffer* mbA = meshA->getMeshBuffer(0);
-				IMeshBuffer* mbB = meshB->getMeshBuffer(0);
-
-				if (mbA == mbB)
-					return 0;
-			}
-
-			return materialA < materialB ? -1 : 1;
-		}
-
-		// sort by texture 0
-		if (textureA == textureB)
-		{
-			// compare mesh
-			IMeshBuffer* mbA = meshA->getMeshBuffer(0);
-			IMeshBuffer* mbB = meshB->getMeshBuffer(0);
-
-			if (mbA == mbB)
-				return 0;
-
-			return mbA < mbB ? -1 : 1;
-		}
-
-		return textureA < textureB ? -1 : 1;
-	}
-
-	void CMeshRenderer::update(CEntityManager* entityManager)
-	{
-		// need sort render by material, texture, mesh		
-		u32 count = m_meshs.size();
-		if (count > 0)
-		{
-			// need sort by material
-			qsort(m_meshs.pointer(), count, sizeof(CRenderMeshData*), cmpRenderMeshFunc);
-		}
+				CWorldTransformData* transform = GET_ENTITY_DATA(meshData->Entity, CWorldTransformData);
+				float distance = transform->World.getTranslation().getDistanceFrom(cameraPosition);
+				return CDrawKey::makeMeshKey(meshData->getMesh(), false, CDrawKey::getDepthBucket(distance, farValue, 8));
+			});
 	}
 
 	void CMeshRenderer::render(CEntityManager* entityManager)
@@ -185,6 +128,16 @@ namespace Skylicht
 
 		CLightSystem* lightSystem = entityManager->getRenderSystem<CLightSystem>();
 
+		core::vector3df cameraPosition;
+		float farValue = 0.0f;
+
+		CCamera* camera = entityManager->getCamera();
+		if (camera != NULL)
+		{
+			cameraPosition = camera->getPosition();
+			farValue = camera->getFarValue();
+		}
+
 		for (u32 i = 0, n = m_meshs.size(); i < n; i++)
 		{
 			CRenderMeshData* meshData = m_meshs[i];
@@ -203,7 +156,8 @@ namespace Skylicht
 			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
 			driver->setTransform(video::ETS_WORLD, transform->World);
 
-			bool haveTransparent = false;
+			CMaterial* transparentMaterial = NULL;
+			IMeshBuffer* transparentBuffer = NULL;
 
 			if (meshData->isSortingLights())
 				lightSystem->onBeginSetupLight(meshData, transform);
@@ -218,7 +172,11 @@ namespace Skylicht
 				}
 				else if (material->getShader() != NULL && material->getShader()->isOpaque() == false)
 				{
-					haveTransparent = true;
+					if (transparentMaterial == NULL)
+					{
+						transparentMaterial = material;
+						transparentBuffer = mesh->getMeshBuffer(j);
+					}
 				}
 				else
 				{
@@ -229,10 +187,17 @@ namespace Skylicht
 			if (meshData->isSortingLights())
 				lightSystem->onEndSetupLight();
 
-			if (haveTransparent == true)
+			if (transparentMaterial != NULL)
 			{
-				// this will render in transparent pass
-				m_transparents.push_back(i);
+				// this will render in transparent pass, far to near
+				float distance = transform->World.getTranslation().getDistanceFrom(cameraPosition);
+
+				SDrawKey key;
+				key.Key = CDrawKey::makeTransparentKey(transparentMaterial, transparentBuffer, CDrawKey::getDepthBucket(distance, farValue, 16));
+				key.Index = i;
+				m_transparents.push_back(key);
+
+				m_sortTransparent = true;
 			}
 		}
 	}
@@ -251,9 +216,17 @@ namespace Skylicht
 
 		CLightSystem* lightSystem = entityManager->getRenderSystem<CLightSystem>();
 
+		if (m_sortTransparent)
+		{
+			m_sortKeys.set_used(numTransparent);
+			if (CDrawKey::sort(m_transparents.pointer(), m_sortKeys.pointer(), numTransparent) != m_transparents.pointer())
+				m_transparents.swap(m_sortKeys);
+			m_sortTransparent = false;
+		}
+
 		for (u32 i = 0; i < numTransparent; i++)
 		{
-			u32 meshID = m_transparents[i];
+			u32 meshID = m_transparents[i].Index;
 
 			CRenderMeshData* meshData = m_meshs[meshID];
 			CEntity* entity = meshData->Entity;
@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "CRenderMeshData.h"
 #include "CMeshRenderSystem.h"
+#include "CDrawKey.h"
 #include "Transform/CWorldTransformData.h"
 #include "IndirectLighting/CIndirectLightingData.h"
 
@@ -35,7 +36,13 @@ namespace Skylicht
 	{
 	protected:
 		core::array<CRenderMeshData*> m_meshs;
-		core::array<u32> m_transparents;
+		core::array<CRenderMeshData*> m_sortMeshs;
+
+		core::array<SDrawKey> m_keys;
+		core::array<SDrawKey> m_sortKeys;
+
+		core::array<SDrawKey> m_transparents;
+		bool m_sortTransparent;
 	public:
 		CMeshRenderer();
 
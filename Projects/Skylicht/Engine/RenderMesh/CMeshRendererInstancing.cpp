@@ -37,6 +37,7 @@ namespace Skylicht
 	CMeshRendererInstancing::CMeshRendererInstancing()
 	{
 		m_pipelineType = IRenderPipeline::Mix;
+		m_cullingDependent = true;
 	}
 
 	CMeshRendererInstancing::~CMeshRendererInstancing()
@@ -308,71 +309,6 @@ namespace Skylicht
 		}
 	}
 
-	int cmpMaterialsFunc(SMeshInstancing* meshA, SMeshInstancing* meshB)
-	{
-		core::array<CMaterial*>& materialsA = meshA->Materials;
-		core::array<CMaterial*>& materialsB = meshB->Materials;
-
-		// no material, compare by mesh
-		if (materialsA.size() == 0 || materialsA.size() == 0)
-		{
-			if (meshA == meshB)
-				return 0;
-
-			return meshA < meshB ? -1 : 1;
-		}
-
-		CMaterial* materialA = materialsA[0];
-		CMaterial* materialB = materialsB[0];
-
-		// compare by mesh
-		if (materialA == NULL || materialB == NULL)
-		{
-			IMeshBuffer* mbA = meshA->MeshBuffers[0];
-			IMeshBuffer* mbB = meshB->MeshBuffers[0];
-
-			if (mbA == mbB)
-				return 0;
-
-			return mbA < mbB ? -1 : 1;
-		}
-
-		// comprate by texture
-		ITexture* textureA = materialA->getTexture(0);
-		ITexture* textureB = materialB->getTexture(0);
-
-		// if no texture
-		if (textureA == NULL || textureB == NULL)
-		{
-			if (materialA == materialB)
-			{
-				// compare mesh
-				IMeshBuffer* mbA = meshA->MeshBuffers[0];
-				IMeshBuffer* mbB = meshB->MeshBuffers[0];
-
-				if (mbA == mbB)
-					return 0;
-			}
-
-			return materialA < materialB ? -1 : 1;
-		}
-
-		// sort by texture 0
-		if (textureA == textureB)
-		{
-			// compare mesh
-			IMeshBuffer* mbA = meshA->MeshBuffers[0];
-			IMeshBuffer* mbB = meshB->MeshBuffers[0];
-
-			if (mbA == mbB)
-				return 0;
-
-			return mbA < mbB ? -1 : 1;
-		}
-
-		return textureA < textureB ? -1 : 1;
-	}
-
 	void CMeshRendererInstancing::sortBeforeRender(core::array<SInstancingGroup>& instancing)
 	{
 		instancing.set_used(0);
@@ -386,25 +322,18 @@ namespace Skylicht
 			if (count == 0)
 				continue;
 
-			// insert sort
-			bool insert = false;
-
-			for (u32 i = 0, n = instancing.size(); i < n; i++)
-			{
-				if (cmpMaterialsFunc(instancing[i].Instancing, data) > 0)
-				{
-					SInstancingGroup g{ data, group };
-					instancing.insert(g, i);
-					insert = true;
-					break;
-				}
-			}
+			SInstancingGroup g{ data, group };
+			instancing.push_back(g);
+		}
 
-			if (!insert)
+		// sort by shader, material, texture, mesh
+		CDrawKey::sortList(instancing, m_keys, m_sortKeys, m_sortGroups,
+			[](SInstancingGroup& g)
 			{
-				SInstancingGroup g{ data, group };
-				instancing.push_back(g);
-			}
-		}
+				SMeshInstancing* data = g.Instancing;
+				CMaterial* material = data->Materials.size() > 0 ? data->Materials[0] : NULL;
+				IMeshBuffer* mb = data->MeshBuffers.size() > 0 ? data->MeshBuffers[0] : NULL;
+				return CDrawKey::makeOpaqueKey(material, mb, 0);
+			});
 	}
-}
\ No newline at end of file
+}
@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "CRenderMeshData.h"
 #include "CMeshRenderSystem.h"
+#include "CDrawKey.h"
 #include "Transform/CWorldTransformData.h"
 #include "IndirectLighting/CIndirectLightingData.h"
 
@@ -50,6 +51,10 @@ namespace Skylicht
 
 		core::array<SInstancingGroup> m_transparents;
 
+		core::array<SInstancingGroup> m_sortGroups;
+		core::array<SDrawKey> m_keys;
+		core::array<SDrawKey> m_sortKeys;
+
 	public:
 		CMeshRendererInstancing();
 
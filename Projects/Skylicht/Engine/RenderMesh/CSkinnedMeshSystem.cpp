@@ -31,7 +31,8 @@ namespace Skylicht
 {
 	CSkinnedMeshSystem::CSkinnedMeshSystem()
 	{
-
+		declareReadData(DATA_TYPE_INDEX(CJointData));
+		declareWriteData(DATA_TYPE_INDEX(CRenderMeshData));
 	}
 
 	CSkinnedMeshSystem::~CSkinnedMeshSystem()
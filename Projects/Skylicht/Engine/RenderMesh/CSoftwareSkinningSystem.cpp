@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CSoftwareSkinningSystem.h"
 #include "Culling/CCullingData.h"
 #include "VertexAnimation/CSoftwareSkinningUtils.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
@@ -59,6 +60,8 @@ namespace Skylicht
 		int numEntity = m_groupMesh->getNumSoftwareSkinnedMesh();
 		CEntity** entities = m_groupMesh->getSoftwareSkinnedMeshes();
 
+		m_visibles.reset();
+
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
@@ -67,16 +70,28 @@ namespace Skylicht
 			if (culling != NULL && culling->Visible == false)
 				continue;
 
-			CRenderMeshData* renderer = GET_ENTITY_DATA(entity, CRenderMeshData);
-
-			CSkinnedMesh* renderMesh = dynamic_cast<CSkinnedMesh*>(renderer->getMesh());
-			CSkinnedMesh* blendShapeMesh = dynamic_cast<CSkinnedMesh*>(renderer->getSoftwareBlendShapeMesh());
-			CMesh* skinnedMesh = renderer->getSoftwareSkinnedMesh();
-
-			if (renderMesh->getMeshBuffer(0)->getVertexType() == video::EVT_SKIN_TANGENTS)
-				CSoftwareSkinningUtils::softwareSkinningTangent(skinnedMesh, renderMesh, blendShapeMesh);
-			else
-				CSoftwareSkinningUtils::softwareSkinning(skinnedMesh, renderMesh, blendShapeMesh);
+			m_visibles.push(entity);
 		}
+
+		// each entity writes its own skinned mesh, the big mesh buffers are also split by vertex range
+		CEntity** visibles = m_visibles.pointer();
+
+		System::CJobSystem::runParallelFor(m_visibles.count(), 1,
+			[visibles](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					CRenderMeshData* renderer = GET_ENTITY_DATA(visibles[i], CRenderMeshData);
+
+					CSkinnedMesh* renderMesh = dynamic_cast<CSkinnedMesh*>(renderer->getMesh());
+					CSkinnedMesh* blendShapeMesh = dynamic_cast<CSkinnedMesh*>(renderer->getSoftwareBlendShapeMesh());
+					CMesh* skinnedMesh = renderer->getSoftwareSkinnedMesh();
+
+					if (renderMesh->getMeshBuffer(0)->getVertexType() == video::EVT_SKIN_TANGENTS)
+						CSoftwareSkinningUtils::softwareSkinningTangent(skinnedMesh, renderMesh, blendShapeMesh);
+					else
+						CSoftwareSkinningUtils::softwareSkinning(skinnedMesh, renderMesh, blendShapeMesh);
+				}
+			});
 	}
 }
\ No newline at end of file
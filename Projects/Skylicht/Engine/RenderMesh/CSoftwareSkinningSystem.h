@@ -33,6 +33,9 @@ namespace Skylicht
 {
 	class SKYLICHT_API CSoftwareSkinningSystem : public CMeshSystem
 	{
+	protected:
+		CFastArray<CEntity*> m_visibles;
+
 	public:
 		CSoftwareSkinningSystem();
 
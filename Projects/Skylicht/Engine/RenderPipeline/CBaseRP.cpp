@@ -36,6 +36,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "IndirectLighting/CIndirectLightingData.h"
 #include "RenderPipeline/CShadowMapRP.h"
+#include "Culling/CCullingSystem.h"
 
 
 namespace Skylicht
@@ -548,6 +549,11 @@ namespace Skylicht
 
 		core::matrix4 view;
 
+		// cull all the faces in one pass
+		CCullingSystem* views = NULL;
+		if (!allPipeline)
+			views = beginCubeCullingViews(entityMgr, position, projection, target, up, face, numFace);
+
 		// OpenGL have flipY buffer
 		// So we fix inverse Y by render to a buffer
 		ITexture* tempFBO = NULL;
@@ -581,6 +587,9 @@ namespace Skylicht
 				camera->setProjectionMatrix(projection);
 				camera->setViewMatrix(view, position);
 
+				if (views)
+					views->setCurrentView(i);
+
 				if (!allPipeline)
 				{
 					// Just need quick render in this RP
@@ -618,6 +627,9 @@ namespace Skylicht
 				camera->setProjectionMatrix(projection);
 				camera->setViewMatrix(view, position);
 
+				if (views)
+					views->setCurrentView(i);
+
 				if (!allPipeline)
 				{
 					// Just need quick render in this RP
@@ -646,6 +658,9 @@ namespace Skylicht
 			driver->removeTexture(tempFBO);
 		}
 
+		if (views)
+			views->endViews();
+
 		// revert camera
 		camera->setProjectionType(cameraType);
 		camera->endUpdate();
@@ -704,6 +719,11 @@ namespace Skylicht
 
 		core::matrix4 view;
 
+		// cull all the faces in one pass
+		CCullingSystem* views = NULL;
+		if (!allPipeline)
+			views = beginCubeCullingViews(entityMgr, position, projection, target, up, face, numFace);
+
 		// OpenGL have flipY buffer
 		// So we fix inverse Y by render to a buffer
 		ITexture* tempFBO = NULL;
@@ -738,6 +758,9 @@ namespace Skylicht
 				camera->setProjectionMatrix(projection);
 				camera->setViewMatrix(view, position);
 
+				if (views)
+					views->setCurrentView(i);
+
 				if (!allPipeline)
 				{
 					// Just need quick render in this RP
@@ -773,6 +796,9 @@ namespace Skylicht
 				camera->setProjectionMatrix(projection);
 				camera->setViewMatrix(view, position);
 
+				if (views)
+					views->setCurrentView(i);
+
 				if (!allPipeline)
 				{
 					// Just quick render in this RP
@@ -802,11 +828,46 @@ namespace Skylicht
 			driver->removeTexture(tempFBO);
 		}
 
+		if (views)
+			views->endViews();
+
 		// revert camera
 		camera->setProjectionType(cameraType);
 		camera->endUpdate();
 	}
 
+	CCullingSystem* CBaseRP::beginCubeCullingViews(CEntityManager* entityMgr, const core::vector3df& position, const core::matrix4& projection, const core::vector3df* target, const core::vector3df* up, int* face, int numFace)
+	{
+		CCullingSystem* cullingSystem = entityMgr->getSystem<CCullingSystem>();
+		if (cullingSystem == NULL)
+			return NULL;
+
+		if (face == NULL)
+			numFace = 6;
+
+		core::matrix4 view;
+		core::matrix4 viewProjection;
+		SViewFrustum frustum;
+
+		cullingSystem->beginViews();
+
+		for (int i = 0; i < numFace; i++)
+		{
+			int faceID = face != NULL ? face[i] : i;
+
+			view.makeIdentity();
+			view.buildCameraLookAtMatrixLH(position, position + target[faceID] * 100.0f, up[faceID]);
+			viewProjection.setbyproduct_nocheck(projection, view);
+
+			frustum.cameraPosition = position;
+			frustum.setFrom(viewProjection);
+
+			cullingSystem->addView(frustum);
+		}
+
+		return cullingSystem;
+	}
+
 	void CBaseRP::saveFBOToFile(ITexture* texture, const char* output)
 	{
 		video::ECOLOR_FORMAT format = texture->getColorFormat();
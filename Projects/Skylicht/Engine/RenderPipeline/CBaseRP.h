@@ -29,6 +29,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	class CCullingSystem;
+
 	class SKYLICHT_API CBaseRP : public IRenderPipeline
 	{
 	protected:
@@ -115,5 +117,7 @@ namespace Skylicht
 		void drawSceneToTexture(ITexture* target, CCamera* camera, CEntityManager* entityMgr, bool allPipeline);
 
 		void drawSceneToCubeTexture(ITexture* target, CCamera* camera, video::E_CUBEMAP_FACE faceID, CEntityManager* entityMgr, bool allPipeline);
+
+		CCullingSystem* beginCubeCullingViews(CEntityManager* entityMgr, const core::vector3df& position, const core::matrix4& projection, const core::vector3df* target, const core::vector3df* up, int* face, int numFace);
 	};
 }
\ No newline at end of file
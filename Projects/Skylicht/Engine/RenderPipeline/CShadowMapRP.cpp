@@ -32,6 +32,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Material/Shader/ShaderCallback/CShaderTransformTexture.h"
 #include "Material/Shader/CShaderManager.h"
 #include "Lighting/CLightCullingSystem.h"
+#include "Culling/CCullingSystem.h"
 #include "Lighting/CPointLight.h"
 #include "Lighting/CSpotLight.h"
 #include "Lighting/CDirectionalLight.h"
@@ -497,6 +498,19 @@ namespace Skylicht
 
 		if (m_shadowMapType == CShadowMapRP::CascadedShadow)
 		{
+			// cull all the cascades in one pass
+			CCullingSystem* views = NULL;
+			if (castShadow && light)
+			{
+				views = entityManager->getSystem<CCullingSystem>();
+				if (views != NULL)
+				{
+					views->beginViews();
+					for (int i = 0; i < m_numCascade; i++)
+						views->addView(m_csm->getFrustumBox(i));
+				}
+			}
+
 			for (int i = m_numCascade - 1; i >= 0; i--)
 			{
 				// note: clear while 0xFFFFFFFF for max depth value
@@ -508,12 +522,25 @@ namespace Skylicht
 
 				if (castShadow && light)
 				{
-					if (i == m_numCascade - 1)
+					if (views != NULL)
+					{
+						views->setCurrentView(i);
+
+						// the other render systems keep the query of the first view
+						if (i == m_numCascade - 1)
+							entityManager->cullingAndRender();
+						else
+							entityManager->cullingAndRenderView();
+					}
+					else if (i == m_numCascade - 1)
 						entityManager->cullingAndRender();
 					else
 						entityManager->render();
 				}
 			}
+
+			if (views != NULL)
+				views->endViews();
 		}
 		else
 		{
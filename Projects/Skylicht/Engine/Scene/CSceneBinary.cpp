@@ -0,0 +1,655 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CSceneBinary.h"
+#include "Serializable/CArraySerializable.h"
+#include "Utils/CMemoryStream.h"
+
+namespace Skylicht
+{
+	struct SSceneBinaryWriter
+	{
+		std::map<std::string, u32> StringID;
+		std::vector<std::string> Strings;
+		std::vector<CSceneBinary::SNode> Nodes;
+		CMemoryStream Data;
+		io::IAttributes* Attributes;
+
+		u32 getStringID(const char* s)
+		{
+			std::map<std::string, u32>::iterator i = StringID.find(s);
+			if (i != StringID.end())
+				return i->second;
+
+			u32 id = (u32)Strings.size();
+			StringID[s] = id;
+			Strings.push_back(s);
+			return id;
+		}
+
+		void writeAttribute(u32 type, const char* name)
+		{
+			Data.writeUInt(type);
+			Data.writeUInt(getStringID(name));
+		}
+
+		void writeNode(CObjectSerializable* object)
+		{
+			u32 index = (u32)Nodes.size();
+
+			CSceneBinary::SNode node;
+			node.Type = getStringID(object->Name.c_str());
+			node.Array = (object->getObjectType() == ObjectArray ||
+				object->getObjectType() == FileArray ||
+				object->getObjectType() == TextureArray) ? 1 : 0;
+			node.End = 0;
+			node.DataOffset = Data.getSize();
+			node.NumAttribute = 0;
+
+			// the same attributes, that CObjectSerializable::save writes to xml
+			Attributes->clear();
+			object->serialize(Attributes);
+
+			for (u32 i = 0, n = Attributes->getAttributeCount(); i < n; i++)
+			{
+				const char* name = Attributes->getAttributeName(i);
+
+				switch (Attributes->getAttributeType(i))
+				{
+				case io::EAT_INT:
+					writeAttribute(CSceneBinary::Int, name);
+					Data.writeInt(Attributes->getAttributeAsInt(i));
+					break;
+				case io::EAT_UINT:
+					writeAttribute(CSceneBinary::UInt, name);
+					Data.writeUInt(Attributes->getAttributeAsUInt(i));
+					break;
+				case io::EAT_FLOAT:
+					writeAttribute(CSceneBinary::Float, name);
+					Data.writeFloat(Attributes->getAttributeAsFloat(i));
+					break;
+				case io::EAT_BOOL:
+					writeAttribute(CSceneBinary::Bool, name);
+					Data.writeUInt(Attributes->getAttributeAsBool(i) ? 1 : 0);
+					break;
+				case io::EAT_VECTOR3D:
+				{
+					core::vector3df v = Attributes->getAttributeAsVector3d(i);
+					writeAttribute(CSceneBinary::Vector3, name);
+					Data.writeData(&v.X, sizeof(float) * 3);
+				}
+				break;
+				case io::EAT_VECTOR2D:
+				{
+					core::vector2df v = Attributes->getAttributeAsVector2d(i);
+					writeAttribute(CSceneBinary::Vector2, name);
+					Data.writeData(&v.X, sizeof(float) * 2);
+				}
+				break;
+				case io::EAT_QUATERNION:
+				{
+					core::quaternion q = Attributes->getAttributeAsQuaternion(i);
+					writeAttribute(CSceneBinary::Quaternion, name);
+					Data.writeData(&q.X, sizeof(float) * 4);
+				}
+				break;
+				case io::EAT_COLOR:
+					writeAttribute(CSceneBinary::Color, name);
+					Data.writeUInt(Attributes->getAttributeAsColor(i).color);
+					break;
+				case io::EAT_MATRIX:
+				{
+					core::matrix4 m = Attributes->getAttributeAsMatrix(i);
+					writeAttribute(CSceneBinary::Matrix, name);
+					Data.writeData(m.pointer(), sizeof(float) * 16);
+				}
+				break;
+				default:
+				{
+					// the other types are converted to string
+					core::stringc value = Attributes->getAttributeAsString(i);
+					writeAttribute(CSceneBinary::String, name);
+					Data.writeUInt(getStringID(value.c_str()));
+				}
+				break;
+				}
+
+				node.NumAttribute++;
+			}
+
+			Nodes.push_back(node);
+
+			// child objects
+			for (u32 i = 0, n = object->getNumProperty(); i < n; i++)
+			{
+				CValueProperty* p = object->getPropertyID(i);
+				if (p->getType() == EPropertyDataType::Object)
+					writeNode((CObjectSerializable*)p);
+			}
+
+			Nodes[index].End = (u32)Nodes.size();
+		}
+	};
+
+	CSceneBinary::CSceneBinary() :
+		m_header(NULL),
+		m_stringOffset(NULL),
+		m_strings(NULL),
+		m_nodes(NULL),
+		m_data(NULL),
+		m_attributes(NULL)
+	{
+
+	}
+
+	CSceneBinary::~CSceneBinary()
+	{
+		release();
+
+		if (m_attributes)
+			m_attributes->drop();
+	}
+
+	io::IAttributes* CSceneBinary::getAttributes()
+	{
+		if (m_attributes == NULL)
+			m_attributes = getIrrlichtDevice()->getFileSystem()->createEmptyAttributes();
+		else
+			m_attributes->clear();
+		return m_attributes;
+	}
+
+	void CSceneBinary::release()
+	{
+		m_buffer.clear();
+		m_header = NULL;
+		m_stringOffset = NULL;
+		m_strings = NULL;
+		m_nodes = NULL;
+		m_data = NULL;
+	}
+
+	bool CSceneBinary::save(CObjectSerializable* data, const char* path)
+	{
+		io::IFileSystem* fs = getIrrlichtDevice()->getFileSystem();
+
+		SSceneBinaryWriter writer;
+		writer.Attributes = fs->createEmptyAttributes();
+		writer.writeNode(data);
+		writer.Attributes->drop();
+
+		// string table: the offsets and the chars, aligned by 4 bytes
+		CMemoryStream strings;
+		u32 offset = 0;
+		for (const std::string& s : writer.Strings)
+		{
+			strings.writeUInt(offset);
+			offset += (u32)s.size() + 1;
+		}
+
+		for (const std::string& s : writer.Strings)
+			strings.writeData(s.c_str(), (u32)s.size() + 1);
+
+		while (strings.getSize() % 4 != 0)
+			strings.writeChar(0);
+
+		SHeader header;
+		header.Magic = Magic;
+		header.Version = Version;
+		header.NumString = (u32)writer.Strings.size();
+		header.StringOffset = sizeof(SHeader);
+		header.NumNode = (u32)writer.Nodes.size();
+		header.NodeOffset = header.StringOffset + strings.getSize();
+		header.DataOffset = header.NodeOffset + header.NumNode * sizeof(SNode);
+		header.DataSize = writer.Data.getSize();
+
+		io::IWriteFile* file = fs->createAndWriteFile(path);
+		if (file == NULL)
+			return false;
+
+		file->write(&header, sizeof(SHeader));
+		file->write(strings.getData(), strings.getSize());
+		file->write(writer.Nodes.data(), header.NumNode * sizeof(SNode));
+		file->write(writer.Data.getData(), header.DataSize);
+		file->drop();
+
+		return true;
+	}
+
+	bool CSceneBinary::isBinaryScene(const char* path)
+	{
+		io::IReadFile* file = getIrrlichtDevice()->getFileSystem()->createAndOpenFile(path);
+		if (file == NULL)
+			return false;
+
+		u32 magic = 0;
+		bool ret = file->read(&magic, sizeof(u32)) == sizeof(u32) && magic == Magic;
+		file->drop();
+
+		return ret;
+	}
+
+	bool CSceneBinary::load(const char* path)
+	{
+		release();
+
+		io::IReadFile* file = getIrrlichtDevice()->getFileSystem()->createAndOpenFile(path);
+		if (file == NULL)
+			return false;
+
+		// one read, the sections are used in place
+		u32 size = (u32)file->getSize();
+		m_buffer.resize(size);
+		if (size > 0)
+			file->read(m_buffer.data(), size);
+		file->drop();
+
+		char log[512];
+
+		const SHeader* header = (const SHeader*)m_buffer.data();
+		if (size < sizeof(SHeader) || header->Magic != Magic || header->Version != Version)
+		{
+			sprintf(log, "[CSceneBinary] Wrong binary scene: %s", path);
+			os::Printer::log(log);
+			release();
+			return false;
+		}
+
+		u64 nodeEnd = (u64)header->NodeOffset + (u64)header->NumNode * sizeof(SNode);
+		u64 stringEnd = (u64)header->StringOffset + (u64)header->NumString * sizeof(u32);
+		if (header->StringOffset < sizeof(SHeader) ||
+			header->StringOffset % 4 != 0 ||
+			header->NodeOffset % 4 != 0 ||
+			header->DataOffset % 4 != 0 ||
+			stringEnd > header->NodeOffset ||
+			nodeEnd > header->DataOffset ||
+			(u64)header->DataOffset + header->DataSize > size)
+		{
+			sprintf(log, "[CSceneBinary] Broken binary scene: %s", path);
+			os::Printer::log(log);
+			release();
+			return false;
+		}
+
+		m_header = header;
+		m_stringOffset = (const u32*)(m_buffer.data() + header->StringOffset);
+		m_strings = (const char*)(m_stringOffset + header->NumString);
+		m_nodes = (const SNode*)(m_buffer.data() + header->NodeOffset);
+		m_data = m_buffer.data() + header->DataOffset;
+
+		// the nodes, the strings and the values are used in place, so check all indices and offsets one time
+		if (!validate((u32)(header->NodeOffset - stringEnd)))
+		{
+			sprintf(log, "[CSceneBinary] Broken binary scene: %s", path);
+			os::Printer::log(log);
+			release();
+			return false;
+		}
+
+		return true;
+	}
+
+	u32 getAttributeValueSize(u32 type)
+	{
+		switch (type)
+		{
+		case CSceneBinary::Vector3:
+			return sizeof(float) * 3;
+		case CSceneBinary::Vector2:
+			return sizeof(float) * 2;
+		case CSceneBinary::Quaternion:
+			return sizeof(float) * 4;
+		case CSceneBinary::Matrix:
+			return sizeof(float) * 16;
+		default:
+			return sizeof(u32);
+		}
+	}
+
+	bool CSceneBinary::validate(u32 stringSize)
+	{
+		u32 numString = m_header->NumString;
+		u32 numNode = m_header->NumNode;
+		u32 dataSize = m_header->DataSize;
+
+		// each string must end with '\0' in the string section
+		u32 lastZero = stringSize;
+		for (u32 i = stringSize; i > 0; i--)
+		{
+			if (m_strings[i - 1] == 0)
+			{
+				lastZero = i - 1;
+				break;
+			}
+		}
+
+		for (u32 i = 0; i < numString; i++)
+		{
+			if (lastZero == stringSize || m_stringOffset[i] > lastZero)
+				return false;
+		}
+
+		for (u32 i = 0; i < numNode; i++)
+		{
+			const SNode& n = m_nodes[i];
+
+			// the subtree must be after this node, so the node loops always move forward
+			if (n.Type >= numString || n.End <= i || n.End > numNode || n.DataOffset > dataSize)
+				return false;
+
+			// the values are read as u32 & f32, the value sizes are 4 bytes aligned
+			if (n.DataOffset % 4 != 0)
+				return false;
+
+			u64 offset = n.DataOffset;
+			for (u32 j = 0; j < n.NumAttribute; j++)
+			{
+				if (offset + sizeof(SAttribute) > dataSize)
+					return false;
+
+				const SAttribute* attribute = (const SAttribute*)(m_data + offset);
+				if (attribute->Type > Matrix || attribute->Name >= numString)
+					return false;
+
+				offset += sizeof(SAttribute);
+
+				u32 valueSize = getAttributeValueSize(attribute->Type);
+				if (offset + valueSize > dataSize)
+					return false;
+
+				if (attribute->Type == String && *(const u32*)(m_data + offset) >= numString)
+					return false;
+
+				offset += valueSize;
+			}
+		}
+
+		return true;
+	}
+
+	void CSceneBinary::readAttributes(u32 node, io::IAttributes* io)
+	{
+		const SNode& n = m_nodes[node];
+		const u8* data = m_data + n.DataOffset;
+
+		for (u32 i = 0; i < n.NumAttribute; i++)
+		{
+			const SAttribute* attribute = (const SAttribute*)data;
+			const u8* value = data + sizeof(SAttribute);
+			const char* name = getString(attribute->Name);
+
+			switch (attribute->Type)
+			{
+			case Int:
+				io->addInt(name, *(const s32*)value);
+				break;
+			case UInt:
+				io->addUInt(name, *(const u32*)value);
+				break;
+			case Float:
+				io->addFloat(name, *(const f32*)value);
+				break;
+			case Bool:
+				io->addBool(name, *(const u32*)value != 0);
+				break;
+			case String:
+				io->addString(name, getString(*(const u32*)value));
+				break;
+			case Vector3:
+			{
+				const f32* f = (const f32*)value;
+				io->addVector3d(name, core::vector3df(f[0], f[1], f[2]));
+			}
+			break;
+			case Vector2:
+			{
+				const f32* f = (const f32*)value;
+				io->addVector2d(name, core::vector2df(f[0], f[1]));
+			}
+			break;
+			case Quaternion:
+			{
+				const f32* f = (const f32*)value;
+				io->addQuaternion(name, core::quaternion(f[0], f[1], f[2], f[3]));
+			}
+			break;
+			case Color:
+				io->addColor(name, video::SColor(*(const u32*)value));
+				break;
+			case Matrix:
+			{
+				core::matrix4 m;
+				memcpy(m.pointer(), value, sizeof(float) * 16);
+				io->addMatrix(name, m);
+			}
+			break;
+			default:
+				break;
+			}
+
+			data = value + getAttributeValueSize(attribute->Type);
+		}
+	}
+
+	void CSceneBinary::initProperty(u32 node, CObjectSerializable* object)
+	{
+		// create the properties like CSerializableLoader::initProperty, without the attributes
+		const SNode& n = m_nodes[node];
+		const u8* data = m_data + n.DataOffset;
+
+		for (u32 i = 0; i < n.NumAttribute; i++)
+		{
+			const SAttribute* attribute = (const SAttribute*)data;
+			const u8* value = data + sizeof(SAttribute);
+			const char* name = getString(attribute->Name);
+
+			CValueProperty* valueProperty = NULL;
+
+			switch (attribute->Type)
+			{
+			case Int:
+				valueProperty = new CIntProperty(object, name, *(const s32*)value);
+				break;
+			case UInt:
+				valueProperty = new CUIntProperty(object, name, *(const u32*)value);
+				break;
+			case Float:
+				valueProperty = new CFloatProperty(object, name, *(const f32*)value);
+				break;
+			case Bool:
+				valueProperty = new CBoolProperty(object, name, *(const u32*)value != 0);
+				break;
+			case String:
+				valueProperty = new CStringProperty(object, name, getString(*(const u32*)value));
+				break;
+			case Vector3:
+			{
+				const f32* f = (const f32*)value;
+				valueProperty = new CVector3Property(object, name, core::vector3df(f[0], f[1], f[2]));
+			}
+			break;
+			case Quaternion:
+			{
+				const f32* f = (const f32*)value;
+				valueProperty = new CQuaternionProperty(object, name, core::quaternion(f[0], f[1], f[2], f[3]));
+			}
+			break;
+			case Color:
+				valueProperty = new CColorProperty(object, name, video::SColor(*(const u32*)value));
+				break;
+			case Matrix:
+			{
+				core::matrix4 m;
+				memcpy(m.pointer(), value, sizeof(float) * 16);
+				valueProperty = new CMatrixProperty(object, name, m);
+			}
+			break;
+			default:
+				break;
+			}
+
+			if (valueProperty)
+				object->autoRelease(valueProperty);
+
+			data = value + getAttributeValueSize(attribute->Type);
+		}
+	}
+
+	void CSceneBinary::load(u32 node, CObjectSerializable* object, const char* exitNode)
+	{
+		const SNode& n = m_nodes[node];
+		const char* type = getString(n.Type);
+
+		bool acceptName = object->Name == type;
+		if (!acceptName)
+		{
+			for (const std::string& name : object->OtherName)
+			{
+				if (name == type)
+				{
+					acceptName = true;
+					break;
+				}
+			}
+		}
+
+		if (!acceptName)
+		{
+			char log[1024];
+			sprintf(log, "[CSceneBinary::load] Skip wrong data: type: %s, %s ", object->Name.c_str(), type);
+			os::Printer::log(log);
+			return;
+		}
+
+		CArraySerializable* arrayObject = NULL;
+		if (object->getObjectType() == ObjectArray ||
+			object->getObjectType() == FileArray ||
+			object->getObjectType() == TextureArray)
+		{
+			arrayObject = dynamic_cast<CArraySerializable*>(object);
+		}
+
+		if (object->getNumProperty() > 0 || (arrayObject && arrayObject->haveCreateElementFunction()))
+		{
+			io::IAttributes* attr = getAttributes();
+			readAttributes(node, attr);
+
+			// for SerializableActivator or the array, that creates elements
+			if (object->getNumProperty() == 0)
+				arrayObject->resize((int)attr->getAttributeCount());
+
+			object->deserialize(attr);
+		}
+		else
+		{
+			initProperty(node, object);
+		}
+
+		// child objects
+		u32 child = node + 1;
+		while (child < n.End)
+		{
+			const SNode& c = m_nodes[child];
+			const char* name = getString(c.Type);
+
+			bool newObject = true;
+			CObjectSerializable* data;
+
+			// activator
+			data = CSerializableActivator::getInstance()->createInstance(name);
+			if (data == NULL)
+			{
+				// try find the current object with the name
+				data = dynamic_cast<CObjectSerializable*>(object->getProperty(name));
+				if (data != NULL)
+				{
+					// use exist property
+					newObject = false;
+				}
+				else
+				{
+					// we will add new object serializable
+					if (c.Array)
+						data = new CArraySerializable(name);
+					else
+						data = new CObjectSerializable(name);
+				}
+			}
+
+			load(child, data, exitNode);
+
+			if (newObject)
+			{
+				object->addProperty(data);
+				object->autoRelease(data);
+			}
+
+			if (strcmp(name, exitNode) == 0)
+				return;
+
+			child = c.End;
+		}
+	}
+
+	void CSceneBinary::parseSerializable(u32 node, CObjectSerializable* object)
+	{
+		const SNode& n = m_nodes[node];
+		if (object->Name != getString(n.Type))
+		{
+			char log[512];
+			sprintf(log, "[CSceneBinary::parseSerializable] Skip wrong data: type: %s", object->Name.c_str());
+			os::Printer::log(log);
+			return;
+		}
+
+		io::IAttributes* attr = getAttributes();
+		readAttributes(node, attr);
+
+		// the array, that creates elements
+		if (attr->getAttributeCount() > 0 && object->getNumProperty() == 0)
+		{
+			CArraySerializable* arrayData = dynamic_cast<CArraySerializable*>(object);
+			if (arrayData && arrayData->haveCreateElementFunction())
+			{
+				for (u32 i = 0, num = attr->getAttributeCount(); i < num; i++)
+					arrayData->createElement();
+			}
+		}
+
+		object->deserialize(attr);
+
+		// load the child objects, that have the same name
+		u32 child = node + 1;
+		for (u32 i = 0, num = object->getNumProperty(); i < num && child < n.End; i++)
+		{
+			CValueProperty* p = object->getPropertyID(i);
+			if (p->getType() == EPropertyDataType::Object)
+			{
+				parseSerializable(child, (CObjectSerializable*)p);
+				child = m_nodes[child].End;
+			}
+		}
+	}
+}
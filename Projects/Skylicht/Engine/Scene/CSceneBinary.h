@@ -0,0 +1,171 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Serializable/CObjectSerializable.h"
+
+namespace Skylicht
+{
+	/// @brief The compiled binary scene, that CSceneExporter::exportSceneBinary writes and CSceneImporter loads.
+	///
+	/// It holds the same node tree as the XML .scene file, in 3 flat sections:
+	/// - A string table (the node types, the attribute names and the string values), each string is stored one time.
+	/// - The nodes in depth-first order, each node has the index of the node after its subtree, so a subtree is skipped without parsing it.
+	/// - The attribute blob, each node has a range of typed values, that are read without string parsing.
+	///
+	/// The file is read into one buffer and the nodes, the strings and the values are used in place.
+	///
+	/// The values are not deserialized straight to the components: CValueProperty only reads io::IAttributes,
+	/// so the loader still fills one io::IAttributes (reused for all nodes, but it allocates each attribute),
+	/// and the object without properties gets a new CValueProperty for each attribute, the same as the XML loader.
+	class SKYLICHT_API CSceneBinary
+	{
+	public:
+		static const u32 Magic = 0x42534b53; // SKSB
+		static const u32 Version = 1;
+
+		enum EAttributeType
+		{
+			Int = 0,
+			UInt,
+			Float,
+			Bool,
+			String,
+			Vector3,
+			Vector2,
+			Quaternion,
+			Color,
+			Matrix,
+		};
+
+		struct SHeader
+		{
+			u32 Magic;
+			u32 Version;
+			u32 NumString;
+			u32 StringOffset;
+			u32 NumNode;
+			u32 NodeOffset;
+			u32 DataOffset;
+			u32 DataSize;
+		};
+
+		struct SNode
+		{
+			/// The type name in the string table
+			u32 Type;
+
+			/// 1 if the node is an array
+			u32 Array;
+
+			/// The node index after the subtree of this node
+			u32 End;
+
+			/// The attributes in the data blob
+			u32 DataOffset;
+			u32 NumAttribute;
+		};
+
+		struct SAttribute
+		{
+			u32 Type;
+			u32 Name;
+		};
+
+	protected:
+		std::vector<u8> m_buffer;
+
+		const SHeader* m_header;
+
+		const u32* m_stringOffset;
+
+		const char* m_strings;
+
+		const SNode* m_nodes;
+
+		const u8* m_data;
+
+		io::IAttributes* m_attributes;
+
+	public:
+		CSceneBinary();
+
+		virtual ~CSceneBinary();
+
+		/// @brief Write the serializable tree (see CSceneExporter::exportScene) to the binary file.
+		static bool save(CObjectSerializable* data, const char* path);
+
+		/// @brief Check the header of the file.
+		static bool isBinaryScene(const char* path);
+
+		bool load(const char* path);
+
+		inline u32 getNodeCount()
+		{
+			return m_header ? m_header->NumNode : 0;
+		}
+
+		inline const SNode& getNode(u32 i)
+		{
+			return m_nodes[i];
+		}
+
+		inline u32 getStringCount()
+		{
+			return m_header ? m_header->NumString : 0;
+		}
+
+		inline const char* getString(u32 i)
+		{
+			return m_strings + m_stringOffset[i];
+		}
+
+		inline const char* getNodeType(u32 i)
+		{
+			return getString(m_nodes[i].Type);
+		}
+
+		/// @brief Add the attributes of the node to the io, like IAttributes::read on the xml node.
+		void readAttributes(u32 node, io::IAttributes* io);
+
+		/// @brief Load the node to the object, like CSerializableLoader::load.
+		void load(u32 node, CObjectSerializable* object, const char* exitNode);
+
+		/// @brief Load the node to the object, like CObjectSerializable::parseSerializable, that deserializes the existing properties.
+		void parseSerializable(u32 node, CObjectSerializable* object);
+
+	protected:
+
+		/// @brief Check the string table, the node tree and the attributes, that are read without bound check.
+		bool validate(u32 stringSize);
+
+		void initProperty(u32 node, CObjectSerializable* object);
+
+		/// @brief The empty attributes, that is reused for the nodes.
+		io::IAttributes* getAttributes();
+
+		void release();
+	};
+}
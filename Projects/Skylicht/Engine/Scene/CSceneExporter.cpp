@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CSceneExporter.h"
+#include "CSceneBinary.h"
 #include "Utils/CPath.h"
 
 namespace Skylicht
@@ -75,15 +76,13 @@ namespace Skylicht
 		delete data;
 	}
 
-	void CSceneExporter::exportScene(CScene* scene, const char* path)
+	CObjectSerializable* CSceneExporter::exportScene(CScene* scene)
 	{
 		CObjectSerializable* data = scene->createSerializable();
 
 		ArrayZone* zone = scene->getAllZone();
 		ArrayZoneIter i = zone->begin(), end = zone->end();
 
-		std::stack<CObjectSerializable*> stack;
-
 		while (i != end)
 		{
 			CZone* zone = (*i);
@@ -100,8 +99,21 @@ namespace Skylicht
 			data->addProperty(zoneData);
 			data->autoRelease(zoneData);
 			++i;
+		}
+
+		return data;
+	}
+
+	void CSceneExporter::exportScene(CScene* scene, const char* path)
+	{
+		CObjectSerializable* data = exportScene(scene);
 
-			stack.push(zoneData);
+		std::stack<CObjectSerializable*> stack;
+		for (u32 i = 0, n = data->getNumProperty(); i < n; i++)
+		{
+			CValueProperty* p = data->getPropertyID(i);
+			if (p->getType() == EPropertyDataType::Object && p->Name == "CZone")
+				stack.push((CObjectSerializable*)p);
 		}
 
 		data->save(path);
@@ -157,4 +169,12 @@ namespace Skylicht
 
 		delete data;
 	}
-}
\ No newline at end of file
+
+	bool CSceneExporter::exportSceneBinary(CScene* scene, const char* path)
+	{
+		CObjectSerializable* data = exportScene(scene);
+		bool ret = CSceneBinary::save(data, path);
+		delete data;
+		return ret;
+	}
+}
@@ -40,6 +40,10 @@ namespace Skylicht
 
 		static void exportGameObject(CGameObject* object, const char* path);
 
+		static CObjectSerializable* exportScene(CScene* scene);
+
 		static void exportScene(CScene* scene, const char* path);
+
+		static bool exportSceneBinary(CScene* scene, const char* path);
 	};
 }
\ No newline at end of file
@@ -43,6 +43,42 @@ namespace Skylicht
 
 	CObjectSerializable* g_template = NULL;
 
+	// the binary scene, that is loading
+	CSceneBinary* g_sceneBinary = NULL;
+	u32 g_sceneBinaryNode = 0;
+
+	// the node types of the binary scene, that are resolved one time by the string table
+	enum ESceneNodeType
+	{
+		SceneNodeUnknown = 0,
+		SceneNodeScene,
+		SceneNodeZone,
+		SceneNodeContainer,
+		SceneNodeGameObject,
+		SceneNodeComponents,
+	};
+
+	std::vector<u8> g_sceneNodeType;
+
+	void CSceneImporter::addComponent(CGameObject* object, const char* componentName)
+	{
+		CComponentSystem* comSystem = object->getComponentByTypeName(componentName);
+		if (comSystem == NULL)
+		{
+			// try add component
+			if (object->addComponentByTypeName(componentName) == NULL)
+			{
+				char log[512];
+				sprintf(log, "[CSceneImporter] Found unsupport component '%s'", componentName);
+				os::Printer::log(log);
+
+				// unsupport component
+				CNullComponent* nullComponent = object->addComponent<CNullComponent>();
+				nullComponent->setName(componentName);
+			}
+		}
+	}
+
 	void CSceneImporter::buildComponent(CGameObject* object, io::IXMLReader* reader)
 	{
 		std::wstring nodeName = L"node";
@@ -65,22 +101,7 @@ namespace Skylicht
 					{
 						attributeName = reader->getAttributeValue(L"type");
 						std::string componentName = CStringImp::convertUnicodeToUTF8(attributeName.c_str());
-
-						CComponentSystem* comSystem = object->getComponentByTypeName(componentName.c_str());
-						if (comSystem == NULL)
-						{
-							// try add component
-							if (object->addComponentByTypeName(componentName.c_str()) == NULL)
-							{
-								char log[512];
-								sprintf(log, "[CSceneImporter] Found unsupport component '%s'", componentName.c_str());
-								os::Printer::log(log);
-
-								// unsupport component
-								CNullComponent* nullComponent = object->addComponent<CNullComponent>();
-								nullComponent->setName(componentName);
-							}
-						}
+						addComponent(object, componentName.c_str());
 					}
 				}
 				break;
@@ -183,8 +204,228 @@ namespace Skylicht
 		g_currentGameObject = g_listGameObject.begin();
 	}
 
+	bool CSceneImporter::buildScene(CScene* scene, CSceneBinary* binary)
+	{
+		g_sceneNodeType.resize(binary->getStringCount());
+		for (u32 i = 0, n = binary->getStringCount(); i < n; i++)
+		{
+			const char* s = binary->getString(i);
+			if (strcmp(s, "CScene") == 0)
+				g_sceneNodeType[i] = SceneNodeScene;
+			else if (strcmp(s, "CZone") == 0)
+				g_sceneNodeType[i] = SceneNodeZone;
+			else if (strcmp(s, "CContainerObject") == 0)
+				g_sceneNodeType[i] = SceneNodeContainer;
+			else if (strcmp(s, "CGameObject") == 0)
+				g_sceneNodeType[i] = SceneNodeGameObject;
+			else if (strcmp(s, "Components") == 0)
+				g_sceneNodeType[i] = SceneNodeComponents;
+			else
+				g_sceneNodeType[i] = SceneNodeUnknown;
+		}
+
+		std::stack<u32> containerEnd;
+
+		// the objects must be in a zone, check it before creating any object
+		u32 i = 0, n = binary->getNodeCount();
+		bool haveObject = false;
+		while (i < n)
+		{
+			while (!containerEnd.empty() && i >= containerEnd.top())
+				containerEnd.pop();
+
+			const CSceneBinary::SNode& node = binary->getNode(i);
+
+			switch (g_sceneNodeType[node.Type])
+			{
+			case SceneNodeZone:
+				containerEnd.push(node.End);
+				haveObject = true;
+				break;
+			case SceneNodeContainer:
+				if (containerEnd.empty())
+					return false;
+				containerEnd.push(node.End);
+				haveObject = true;
+				break;
+			case SceneNodeGameObject:
+				if (containerEnd.empty())
+					return false;
+				haveObject = true;
+				break;
+			case SceneNodeComponents:
+				if (haveObject)
+				{
+					i = node.End;
+					continue;
+				}
+				break;
+			default:
+				break;
+			}
+
+			i++;
+		}
+
+		std::stack<CContainerObject*> container;
+		containerEnd = std::stack<u32>();
+
+		g_listGameObject.clear();
+
+		CGameObject* currentObject = NULL;
+
+		i = 0;
+		while (i < n)
+		{
+			// the end of the container subtree
+			while (!containerEnd.empty() && i >= containerEnd.top())
+			{
+				container.pop();
+				containerEnd.pop();
+			}
+
+			const CSceneBinary::SNode& node = binary->getNode(i);
+
+			switch (g_sceneNodeType[node.Type])
+			{
+			case SceneNodeZone:
+			{
+				CZone* zone = scene->createZone();
+				container.push((CContainerObject*)zone);
+				containerEnd.push(node.End);
+				g_listGameObject.push_back(zone);
+				currentObject = zone;
+			}
+			break;
+			case SceneNodeContainer:
+			{
+				CContainerObject* object = container.top()->createContainerObject();
+				container.push(object);
+				containerEnd.push(node.End);
+				g_listGameObject.push_back(object);
+				currentObject = object;
+			}
+			break;
+			case SceneNodeGameObject:
+			{
+				CGameObject* object = container.top()->createEmptyObject();
+				g_listGameObject.push_back(object);
+				currentObject = object;
+			}
+			break;
+			case SceneNodeComponents:
+			{
+				if (currentObject != NULL)
+				{
+					// the child nodes are the components
+					for (u32 c = i + 1; c < node.End; c = binary->getNode(c).End)
+						addComponent(currentObject, binary->getNodeType(c));
+
+					i = node.End;
+					continue;
+				}
+			}
+			break;
+			default:
+				break;
+			}
+
+			i++;
+		}
+
+		g_currentGameObject = g_listGameObject.begin();
+		return true;
+	}
+
+	bool CSceneImporter::loadStep(CScene* scene, CSceneBinary* binary)
+	{
+		int step = 0;
+
+		u32 i = g_sceneBinaryNode, n = binary->getNodeCount();
+		while (step < g_loadSceneStep && i < n)
+		{
+			const CSceneBinary::SNode& node = binary->getNode(i);
+
+			switch (g_sceneNodeType[node.Type])
+			{
+			case SceneNodeScene:
+			{
+				CObjectSerializable* data = scene->createSerializable();
+				binary->parseSerializable(i, data);
+				scene->loadSerializable(data);
+				delete data;
+			}
+			break;
+			case SceneNodeZone:
+			case SceneNodeContainer:
+			case SceneNodeGameObject:
+			{
+				CGameObject* gameobject = *g_currentGameObject;
+
+				// get id generated
+				std::string id = gameobject->getID();
+
+				++g_currentGameObject;
+				++g_loadingScene;
+				++step;
+
+				CObjectSerializable* data = new CObjectSerializable(binary->getNodeType(i));
+
+				// load to end of node Components
+				binary->load(i, data, "Components");
+				gameobject->loadSerializable(data);
+				gameobject->startComponent();
+				delete data;
+
+				// use new id, that generated
+				if (g_generateId)
+					gameobject->setID(id.c_str());
+			}
+			break;
+			case SceneNodeComponents:
+				// loaded with the object
+				i = node.End;
+				continue;
+			default:
+				break;
+			}
+
+			i++;
+		}
+
+		g_sceneBinaryNode = i;
+
+		return g_currentGameObject == g_listGameObject.end();
+	}
+
 	bool CSceneImporter::beginImportScene(CScene* scene, const char* file)
 	{
+		if (CSceneBinary::isBinaryScene(file))
+		{
+			CSceneBinary* binary = new CSceneBinary();
+			if (!binary->load(file))
+			{
+				delete binary;
+				return false;
+			}
+
+			if (!buildScene(scene, binary))
+			{
+				os::Printer::log("[CSceneImporter] Wrong node tree of the binary scene");
+				delete binary;
+				return false;
+			}
+
+			g_sceneBinary = binary;
+			g_sceneBinaryNode = 0;
+			g_sceneReaderPath = file;
+			g_scene = scene;
+			g_loadingScene = 0;
+			g_generateId = false;
+
+			return true;
+		}
+
 		// step 1
 		// build scene object
 		g_sceneReader = getIrrlichtDevice()->getFileSystem()->createXMLReader(file);
@@ -283,7 +524,13 @@ namespace Skylicht
 	{
 		// step 2
 		// load object attribute
-		if (CSceneImporter::loadStep(g_scene, g_sceneReader))
+		bool finish = false;
+		if (g_sceneBinary)
+			finish = CSceneImporter::loadStep(g_scene, g_sceneBinary);
+		else
+			finish = CSceneImporter::loadStep(g_scene, g_sceneReader);
+
+		if (finish)
 		{
 			// drop
 			if (g_sceneReader)
@@ -292,6 +539,12 @@ namespace Skylicht
 				g_sceneReader = NULL;
 			}
 
+			if (g_sceneBinary)
+			{
+				delete g_sceneBinary;
+				g_sceneBinary = NULL;
+			}
+
 			// final index search object
 			g_scene->updateIndexSearchObject();
 			g_scene = NULL;
@@ -28,17 +28,24 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CScene.h"
 #include "Serializable/CObjectSerializable.h"
 #include "Serializable/CSerializableLoader.h"
+#include "CSceneBinary.h"
 
 namespace Skylicht
 {
 	class SKYLICHT_API CSceneImporter
 	{
+		static void addComponent(CGameObject* object, const char* componentName);
+
 		static void buildComponent(CGameObject* object, io::IXMLReader* xmlReader);
 
 		static void buildScene(CScene* scene, CContainerObject* target, io::IXMLReader* xmlReader);
 
 		static bool loadStep(CScene* scene, io::IXMLReader* reader);
 
+		static bool buildScene(CScene* scene, CSceneBinary* binary);
+
+		static bool loadStep(CScene* scene, CSceneBinary* binary);
+
 	public:
 
 		static bool beginImportScene(CScene* scene, const char* path);
@@ -63,6 +63,9 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "Graphics2D/Glyph/CGlyphFreetype.h"
 
+// Job system
+#include "Thread/CJobSystem.h"
+
 
 namespace Skylicht
 {
@@ -76,12 +79,14 @@ namespace Skylicht
 	float g_fixedTimeStep = 16.666f;
 	bool g_useFixedTimeStep = false;
 
-	void initSkylicht(IrrlichtDevice* device, bool server)
+	void initSkylicht(IrrlichtDevice* device, bool server, int numJobWorkers)
 	{
 		g_device = device;
 		g_video = device->getVideoDriver();
 
 		os::Printer::log("Init Skylicht Engine");
+		System::CJobSystem::createGetInstance(numJobWorkers);
+
 		CEventManager::createGetInstance();
 
 		CTouchManager::createGetInstance();
@@ -153,6 +158,8 @@ namespace Skylicht
 		CJoystick::releaseInstance();
 
 		CEventManager::releaseInstance();
+
+		System::CJobSystem::releaseInstance();
 	}
 
 	void updateSkylicht()
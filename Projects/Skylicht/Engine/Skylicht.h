@@ -161,8 +161,9 @@ namespace Skylicht
 	 *
 	 * @param device Pointer to the Irrlicht device to use.
 	 * @param server Set to true if running in server mode (default: false).
+	 * @param numJobWorkers Number of job system worker threads, 0 runs all jobs on the main thread, -1 uses (cpu cores - 1) (default: -1).
 	 */
-	SKYLICHT_API void initSkylicht(IrrlichtDevice* device, bool server = false);
+	SKYLICHT_API void initSkylicht(IrrlichtDevice* device, bool server = false, int numJobWorkers = -1);
 
 	/**
 	 * @brief Release and clean up all Skylicht Engine core resources and managers.
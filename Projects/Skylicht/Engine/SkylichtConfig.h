@@ -65,4 +65,11 @@ https://github.com/skylicht-lab/skylicht-engine
 	#define SKYLICHT_EXPORT
 #endif
 
+#endif
+
+// SIMD instruction set, the code must have the scalar version for the other platforms
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SKYLICHT_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define SKYLICHT_NEON
 #endif
\ No newline at end of file
@@ -29,7 +29,8 @@ https://github.com/skylicht-lab/skylicht-engine
 namespace Skylicht
 {
 	CGroupTransform::CGroupTransform(CEntityGroup* parent) :
-		CEntityGroup(NULL, 0)
+		CEntityGroup(NULL, 0),
+		m_stamp(0)
 	{
 		m_parentGroup = parent;
 		m_dataTypes.push_back(DATA_TYPE_INDEX(CWorldTransformData));
@@ -40,6 +41,18 @@ namespace Skylicht
 
 	}
 
+	int CGroupTransform::pushUpdate(CWorldTransformData* transform, int parent)
+	{
+		int slot = m_updates.count();
+		m_updates.push(transform);
+		m_updateParents.push(parent);
+
+		int entityIndex = transform->EntityIndex;
+		m_entitySlot[entityIndex] = slot;
+		m_entityStamp[entityIndex] = m_stamp;
+		return slot;
+	}
+
 	void CGroupTransform::onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity)
 	{
 		CEntity** allEntities = entityManager->getEntities();
@@ -54,10 +67,32 @@ namespace Skylicht
 		m_roots.reset();
 		m_childs.reset();
 		m_lateUpdate.reset();
+		m_updates.reset();
+		m_updateParents.reset();
+		m_updateLevels.reset();
+
+		// the stamp invalidates the entity slots of the last query
+		u32 numAllEntity = (u32)entityManager->getNumEntities();
+		if (m_entityStamp.size() < numAllEntity)
+		{
+			u32 oldSize = m_entityStamp.size();
+			m_entitySlot.set_used(numAllEntity);
+			m_entityStamp.set_used(numAllEntity);
+			for (u32 i = oldSize; i < numAllEntity; i++)
+				m_entityStamp[i] = 0;
+		}
+
+		if (++m_stamp == 0)
+		{
+			for (u32 i = 0, n = m_entityStamp.size(); i < n; i++)
+				m_entityStamp[i] = 0;
+			m_stamp = 1;
+		}
 
 		CEntity* entity;
 		CWorldTransformData* transform;
 		int parentID;
+		int lastDepth = -1;
 
 		for (int i = 0; i < numEntity; i++)
 		{
@@ -98,11 +133,32 @@ namespace Skylicht
 
 				m_entities.push(entity);
 
+				// the entities are sorted by depth, begin a new depth level
+				if (transform->Depth != lastDepth)
+				{
+					m_updateLevels.push(m_updates.count());
+					lastDepth = transform->Depth;
+				}
+
 				if (transform->Depth == 0 || transform->IsWorldTransform)
+				{
 					m_roots.push(transform);
+					pushUpdate(transform, UpdateRoot);
+				}
 				else
+				{
 					m_childs.push(transform);
 
+					// the parent is on an upper level of the list, or add the unchanged parent to read its world
+					int parentSlot;
+					if (m_entityStamp[parentID] == m_stamp)
+						parentSlot = m_entitySlot[parentID];
+					else
+						parentSlot = pushUpdate(transform->Parent, UpdateFixed);
+
+					pushUpdate(transform, parentSlot);
+				}
+
 				transform->HasChanged = false;
 			}
 
@@ -117,6 +173,9 @@ namespace Skylicht
 			}
 		}
 
+		if (m_updateLevels.count() > 0)
+			m_updateLevels.push(m_updates.count());
+
 		// notify alway update this group
 		m_needQuery = true;
 		m_needValidate = true;
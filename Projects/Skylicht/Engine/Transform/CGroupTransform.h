@@ -34,6 +34,30 @@ namespace Skylicht
 		CFastArray<CWorldTransformData*> m_roots;
 		CFastArray<CWorldTransformData*> m_childs;
 		CFastArray<CWorldTransformData*> m_lateUpdate;
+
+		// the update list of CWorldTransformSystem: the changed transforms sorted by depth, each depth level is a range of the list
+		CFastArray<CWorldTransformData*> m_updates;
+
+		// the parent on the update list (on an upper level), UpdateRoot or UpdateFixed
+		CFastArray<int> m_updateParents;
+
+		// the begin offset of each depth level on m_updates
+		CFastArray<int> m_updateLevels;
+
+		// the slot of an entity on the update list, it is valid when the stamp is the current query stamp
+		core::array<int> m_entitySlot;
+		core::array<u32> m_entityStamp;
+		u32 m_stamp;
+
+	public:
+		enum EUpdateParent
+		{
+			// world = relative
+			UpdateRoot = -1,
+			// the parent that is not changed, it is on the list to read its world
+			UpdateFixed = -2
+		};
+
 	public:
 		CGroupTransform(CEntityGroup* parent);
 
@@ -59,6 +83,33 @@ namespace Skylicht
 			return m_childs.pointer();
 		}
 
+		inline int getNumUpdate()
+		{
+			return m_updates.count();
+		}
+
+		inline CWorldTransformData** getUpdates()
+		{
+			return m_updates.pointer();
+		}
+
+		/// @brief The index of the parent on the update list, or EUpdateParent
+		inline int* getUpdateParents()
+		{
+			return m_updateParents.pointer();
+		}
+
+		/// @brief Number of depth levels on the update list, the level i is the range [getUpdateLevels()[i], getUpdateLevels()[i + 1])
+		inline int getNumUpdateLevel()
+		{
+			return m_updateLevels.count() > 0 ? m_updateLevels.count() - 1 : 0;
+		}
+
+		inline int* getUpdateLevels()
+		{
+			return m_updateLevels.pointer();
+		}
+
 		inline CWorldTransformData** getLateUpdate()
 		{
 			return m_lateUpdate.pointer();
@@ -70,5 +121,9 @@ namespace Skylicht
 		}
 
 		virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+	protected:
+
+		int pushUpdate(CWorldTransformData* transform, int parent);
 	};
 }
\ No newline at end of file
@@ -27,12 +27,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Entity/CEntityManager.h"
 #include "Culling/CVisibleData.h"
 #include "Transform/CTransform.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
 	CWorldInverseTransformSystem::CWorldInverseTransformSystem() :
 		m_group(NULL)
 	{
+		declareReadData(DATA_TYPE_INDEX(CWorldTransformData));
+		declareWriteData(DATA_TYPE_INDEX(CWorldInverseTransformData));
 	}
 
 	CWorldInverseTransformSystem::~CWorldInverseTransformSystem()
@@ -63,18 +66,21 @@ namespace Skylicht
 		CEntity** entities = m_group->getEntities();
 		int numEntity = m_group->getEntityCount();
 
-		for (int i = 0; i < numEntity; i++)
-		{
-			CEntity* entity = entities[i];
-
-			CWorldTransformData* world = GET_ENTITY_DATA(entity, CWorldTransformData);
-			CWorldInverseTransformData* worldInv = GET_ENTITY_DATA(entity, CWorldInverseTransformData);
-
-			if (world->NeedValidate)
+		System::CJobSystem::runParallelFor(numEntity, 256, [entities](int begin, int end)
 			{
-				// Get inverse matrix of world
-				world->World.getInverse(worldInv->WorldInverse);
-			}
-		}
+				for (int i = begin; i < end; i++)
+				{
+					CEntity* entity = entities[i];
+
+					CWorldTransformData* world = GET_ENTITY_DATA(entity, CWorldTransformData);
+					CWorldInverseTransformData* worldInv = GET_ENTITY_DATA(entity, CWorldInverseTransformData);
+
+					if (world->NeedValidate)
+					{
+						// Get inverse matrix of world
+						world->World.getInverse(worldInv->WorldInverse);
+					}
+				}
+			});
 	}
 }
\ No newline at end of file
@@ -28,6 +28,8 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Entity/CEntityManager.h"
 #include "Transform/CTransform.h"
 #include "Culling/CVisibleData.h"
+#include "Utils/CMatrix.h"
+#include "Thread/CJobSystem.h"
 
 namespace Skylicht
 {
@@ -79,30 +81,77 @@ namespace Skylicht
 
 	void CWorldTransformSystem::update(CEntityManager* entityManager)
 	{
-		CEntity** allEntities = entityManager->getEntities();
+		// only the changed transforms (and their childs) are on the list, sorted by depth
+		CWorldTransformData** transforms = m_groupTransform->getUpdates();
+		int* parents = m_groupTransform->getUpdateParents();
+		int numEntity = m_groupTransform->getNumUpdate();
 
-		CWorldTransformData** transforms = m_groupTransform->getRoots();
-		int numEntity = m_groupTransform->getNumRoot();
-
-		for (int i = 0; i < numEntity; i++)
+		if (numEntity == 0)
 		{
-			CWorldTransformData* t = transforms[i];
-			t->World = t->Relative;
+			lateUpdate(entityManager);
+			return;
 		}
 
-		transforms = m_groupTransform->getChilds();
-		numEntity = m_groupTransform->getNumChilds();
-
-		for (int i = 0; i < numEntity; i++)
+		if ((int)m_worlds.size() < numEntity)
 		{
-			CWorldTransformData* t = transforms[i];
+			m_relatives.set_used(numEntity);
+			m_worlds.set_used(numEntity);
+		}
 
-			// calc world = parent * relative
-			// - relative is copied from CTransformComponentSystem
-			// - relative is also defined in CEntityPrefab
-			t->World.setbyproduct_nocheck(t->Parent->World, t->Relative);
+		core::matrix4* relatives = m_relatives.pointer();
+		core::matrix4* worlds = m_worlds.pointer();
+
+		// gather the matrices to the contiguous arrays
+		// - relative is copied from CTransformComponentSystem
+		// - relative is also defined in CEntityPrefab
+		System::CJobSystem::runParallelFor(numEntity, 512, [transforms, parents, relatives, worlds](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					if (parents[i] == CGroupTransform::UpdateFixed)
+						worlds[i] = transforms[i]->World;
+					else
+						relatives[i] = transforms[i]->Relative;
+				}
+			});
+
+		// the parent of a level is on the upper level, so update level by level, and the transforms on a level in parallel
+		int* levels = m_groupTransform->getUpdateLevels();
+		int numLevel = m_groupTransform->getNumUpdateLevel();
+
+		for (int l = 0; l < numLevel; l++)
+		{
+			int levelBegin = levels[l];
+			int levelCount = levels[l + 1] - levelBegin;
+
+			System::CJobSystem::runParallelFor(levelCount, 256, [levelBegin, parents, relatives, worlds](int begin, int end)
+				{
+					for (int i = levelBegin + begin, n = levelBegin + end; i < n; i++)
+					{
+						int parent = parents[i];
+						if (parent >= 0)
+						{
+							// calc world = parent * relative
+							CMatrix::multiply(worlds[i], worlds[parent], relatives[i]);
+						}
+						else if (parent == CGroupTransform::UpdateRoot)
+						{
+							worlds[i] = relatives[i];
+						}
+					}
+				});
 		}
 
+		// scatter the result to the entity data, that the other systems read
+		System::CJobSystem::runParallelFor(numEntity, 512, [transforms, parents, worlds](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					if (parents[i] != CGroupTransform::UpdateFixed)
+						transforms[i]->World = worlds[i];
+				}
+			});
+
 		lateUpdate(entityManager);
 	}
 
@@ -118,7 +167,7 @@ namespace Skylicht
 		for (int i = 0; i < numEntity; i++)
 		{
 			CWorldTransformData* t = transforms[i];
-			t->World.setbyproduct_nocheck(t->Parent->World, t->Relative);
+			CMatrix::multiply(t->World, t->Parent->World, t->Relative);
 		}
 	}
 }
\ No newline at end of file
@@ -38,6 +38,10 @@ namespace Skylicht
 
 		std::vector<ILateUpdate*> m_lateUpdates;
 
+		// the matrices of the update list (see CGroupTransform::getUpdates), a depth level is a contiguous range
+		core::array<core::matrix4> m_relatives;
+		core::array<core::matrix4> m_worlds;
+
 	public:
 		CWorldTransformSystem();
 
@@ -0,0 +1,103 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#if defined(SKYLICHT_SSE)
+#include <emmintrin.h>
+#elif defined(SKYLICHT_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Skylicht
+{
+	class CMatrix
+	{
+	public:
+
+		/// @brief out = a * b, the same result as core::matrix4::setbyproduct_nocheck. The out matrix can be a or b.
+		static inline void multiply(core::matrix4& out, const core::matrix4& a, const core::matrix4& b)
+		{
+			const f32* m1 = a.pointer();
+			const f32* m2 = b.pointer();
+			f32* m = out.pointer();
+
+#if defined(SKYLICHT_SSE)
+			// the column j of out = the columns of a * the column j of b
+			__m128 c0 = _mm_loadu_ps(m1);
+			__m128 c1 = _mm_loadu_ps(m1 + 4);
+			__m128 c2 = _mm_loadu_ps(m1 + 8);
+			__m128 c3 = _mm_loadu_ps(m1 + 12);
+
+			__m128 r[4];
+			for (int j = 0; j < 4; j++)
+			{
+				const f32* col = m2 + j * 4;
+				__m128 v = _mm_mul_ps(c0, _mm_set1_ps(col[0]));
+				v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_set1_ps(col[1])));
+				v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_set1_ps(col[2])));
+				v = _mm_add_ps(v, _mm_mul_ps(c3, _mm_set1_ps(col[3])));
+				r[j] = v;
+			}
+
+			_mm_storeu_ps(m, r[0]);
+			_mm_storeu_ps(m + 4, r[1]);
+			_mm_storeu_ps(m + 8, r[2]);
+			_mm_storeu_ps(m + 12, r[3]);
+#elif defined(SKYLICHT_NEON)
+			float32x4_t c0 = vld1q_f32(m1);
+			float32x4_t c1 = vld1q_f32(m1 + 4);
+			float32x4_t c2 = vld1q_f32(m1 + 8);
+			float32x4_t c3 = vld1q_f32(m1 + 12);
+
+			float32x4_t r[4];
+			for (int j = 0; j < 4; j++)
+			{
+				const f32* col = m2 + j * 4;
+				float32x4_t v = vmulq_n_f32(c0, col[0]);
+				v = vaddq_f32(v, vmulq_n_f32(c1, col[1]));
+				v = vaddq_f32(v, vmulq_n_f32(c2, col[2]));
+				v = vaddq_f32(v, vmulq_n_f32(c3, col[3]));
+				r[j] = v;
+			}
+
+			vst1q_f32(m, r[0]);
+			vst1q_f32(m + 4, r[1]);
+			vst1q_f32(m + 8, r[2]);
+			vst1q_f32(m + 12, r[3]);
+#else
+			if (&out == &a || &out == &b)
+			{
+				core::matrix4 tmp(core::matrix4::EM4CONST_NOTHING);
+				tmp.setbyproduct_nocheck(a, b);
+				out = tmp;
+			}
+			else
+			{
+				out.setbyproduct_nocheck(a, b);
+			}
+#endif
+		}
+	};
+}
@@ -24,11 +24,39 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CSoftwareSkinningUtils.h"
+#include "Thread/CJobSystem.h"
+
+#if defined(SKYLICHT_SSE)
+#include <emmintrin.h>
+#elif defined(SKYLICHT_NEON)
+#include <arm_neon.h>
+#endif
 
 // #define VERTEX_NORMALIZE
 
 namespace Skylicht
 {
+#if defined(SKYLICHT_SSE)
+	typedef __m128 float4;
+
+	static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+	static inline float4 set4(float f) { return _mm_set1_ps(f); }
+	static inline void store4(float* p, float4 a) { _mm_storeu_ps(p, a); }
+	static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+	static inline float4 madd4(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#elif defined(SKYLICHT_NEON)
+	typedef float32x4_t float4;
+
+	static inline float4 load4(const float* p) { return vld1q_f32(p); }
+	static inline float4 set4(float f) { return vdupq_n_f32(f); }
+	static inline void store4(float* p, float4 a) { vst1q_f32(p, a); }
+	static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+	static inline float4 madd4(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+#endif
+
+	// the vertices of a mesh buffer are split to the worker threads by this size
+	static const int SkinningGrainSize = 1024;
+
 	CMesh* CSoftwareSkinningUtils::initSoftwareSkinning(CMesh* originalMesh)
 	{
 		CMesh* mesh = new CMesh();
@@ -185,9 +213,88 @@ namespace Skylicht
 		}
 	}
 
+	template<class T>
+	static void skinVertexRange(const CSkinnedMesh::SJoint* joints, const T* src, video::S3DVertex* dst, int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			const T& vertex = src[i];
+			video::S3DVertex& resultVertex = dst[i];
+
+			const float* weight = &vertex.BoneWeight.X;
+			const float* boneIndex = &vertex.BoneIndex.X;
+
+#if defined(SKYLICHT_SSE) || defined(SKYLICHT_NEON)
+			// blend the columns of the 4 bone matrices, then transform the vertex once
+			// sum(w * M * v) = sum(w * M) * v
+			float4 c0 = set4(0.0f);
+			float4 c1 = c0;
+			float4 c2 = c0;
+			float4 c3 = c0;
+
+			// no branch on the weights (they are not predictable), the unused bone reads joint 0 with weight 0
+			for (int j = 0; j < 4; j++)
+			{
+				float weightJ = weight[j] > 0.0f ? weight[j] : 0.0f;
+				int bone = weight[j] > 0.0f ? (int)boneIndex[j] : 0;
+
+				const float* m = joints[bone].SkinningMatrix;
+				float4 w = set4(weightJ);
+
+				c0 = madd4(load4(m), w, c0);
+				c1 = madd4(load4(m + 4), w, c1);
+				c2 = madd4(load4(m + 8), w, c2);
+				c3 = madd4(load4(m + 12), w, c3);
+			}
+
+			float4 pos = madd4(set4(vertex.Pos.X), c0, madd4(set4(vertex.Pos.Y), c1, madd4(set4(vertex.Pos.Z), c2, c3)));
+			float4 normal = madd4(set4(vertex.Normal.X), c0, madd4(set4(vertex.Normal.Y), c1, mul4(set4(vertex.Normal.Z), c2)));
+
+			// the vertex is not 16 bytes aligned, and the 4th float is the next member
+			float result[8];
+			store4(result, pos);
+			store4(result + 4, normal);
+
+			resultVertex.Pos.set(result[0], result[1], result[2]);
+			resultVertex.Normal.set(result[4], result[5], result[6]);
+#else
+			resultVertex.Pos.set(0.0f, 0.0f, 0.0f);
+			resultVertex.Normal.set(0.0f, 0.0f, 0.0f);
+
+			for (int j = 0; j < 4; j++)
+			{
+				if (weight[j] > 0.0f)
+				{
+					CSoftwareSkinningUtils::skinVertex(joints[(int)boneIndex[j]].SkinningMatrix,
+						resultVertex.Pos,
+						resultVertex.Normal,
+						vertex.Pos,
+						vertex.Normal,
+						weight[j]);
+				}
+			}
+#endif
+
+			// apply skin normal
+#ifdef VERTEX_NORMALIZE
+			resultVertex.Normal.normalize();
+#endif
+		}
+	}
+
+	void CSoftwareSkinningUtils::skinVertices(const CSkinnedMesh::SJoint* joints, const video::S3DVertexSkin* src, video::S3DVertex* dst, int begin, int end)
+	{
+		skinVertexRange(joints, src, dst, begin, end);
+	}
+
+	void CSoftwareSkinningUtils::skinVertices(const CSkinnedMesh::SJoint* joints, const video::S3DVertexSkinTangents* src, video::S3DVertex* dst, int begin, int end)
+	{
+		skinVertexRange(joints, src, dst, begin, end);
+	}
+
 	void CSoftwareSkinningUtils::softwareSkinning(CMesh* skinnedMesh, CSkinnedMesh* originalMesh, CSkinnedMesh* blendShapeMesh)
 	{
-		CSkinnedMesh::SJoint* arrayJoint = originalMesh->Joints.pointer();
+		const CSkinnedMesh::SJoint* arrayJoint = originalMesh->Joints.pointer();
 
 		CSkinnedMesh* sourceMesh = blendShapeMesh ? blendShapeMesh : originalMesh;
 
@@ -195,7 +302,7 @@ namespace Skylicht
 		{
 			IMeshBuffer* originalMeshBuffer = sourceMesh->getMeshBuffer(i);
 			IVertexBuffer* originalVertexbuffer = originalMeshBuffer->getVertexBuffer(0);
-			video::S3DVertexSkin* vertex = (video::S3DVertexSkin*)originalVertexbuffer->getVertices();
+			const video::S3DVertexSkin* vertex = (video::S3DVertexSkin*)originalVertexbuffer->getVertices();
 
 			int numVertex = originalVertexbuffer->getVertexCount();
 
@@ -203,79 +310,12 @@ namespace Skylicht
 			IVertexBuffer* resultVertexBuffer = resultMeshBuffer->getVertexBuffer(0);
 			video::S3DVertex* resultVertex = (video::S3DVertex*)resultVertexBuffer->getVertices();
 
-#ifdef VERTEX_NORMALIZE
-			float length, invLength;
-#endif
 			// skinning
-			for (int i = 0; i < numVertex; i++)
-			{
-				resultVertex->Pos.X = 0.0f;
-				resultVertex->Pos.Y = 0.0f;
-				resultVertex->Pos.Z = 0.0f;
-
-				resultVertex->Normal.X = 0.0f;
-				resultVertex->Normal.Y = 0.0f;
-				resultVertex->Normal.Z = 0.0f;
-
-				// bone 0
-				if (vertex->BoneWeight.X > 0.0f)
+			System::CJobSystem::runParallelFor(numVertex, SkinningGrainSize,
+				[arrayJoint, vertex, resultVertex](int begin, int end)
 				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.X].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.X);
-				}
-
-				// bone 1
-				if (vertex->BoneWeight.Y > 0.0f)
-				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.Y].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.Y);
-				}
-
-				// bone 2
-				if (vertex->BoneWeight.Z > 0.0f)
-				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.Z].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.Z);
-				}
-
-				// bone 3
-				if (vertex->BoneWeight.W > 0.0f)
-				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.W].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.W);
-				}
-
-				// apply skin normal
-#ifdef VERTEX_NORMALIZE
-				length = resultVertex->Normal.X * resultVertex->Normal.X +
-					resultVertex->Normal.Y * resultVertex->Normal.Y +
-					resultVertex->Normal.Z * resultVertex->Normal.Z;
-
-				invLength = 1.0f / sqrtf(length);
-				resultVertex->Normal.X = resultVertex->Normal.X * invLength;
-				resultVertex->Normal.Y = resultVertex->Normal.Y * invLength;
-				resultVertex->Normal.Z = resultVertex->Normal.Z * invLength;
-#endif
-
-				++resultVertex;
-				++vertex;
-			}
+					skinVertexRange(arrayJoint, vertex, resultVertex, begin, end);
+				});
 
 			skinnedMesh->setDirty(EBT_VERTEX);
 		}
@@ -283,7 +323,7 @@ namespace Skylicht
 
 	void CSoftwareSkinningUtils::softwareSkinningTangent(CMesh* skinnedMesh, CSkinnedMesh* originalMesh, CSkinnedMesh* blendShapeMesh)
 	{
-		CSkinnedMesh::SJoint* arrayJoint = originalMesh->Joints.pointer();
+		const CSkinnedMesh::SJoint* arrayJoint = originalMesh->Joints.pointer();
 
 		CSkinnedMesh* sourceMesh = blendShapeMesh ? blendShapeMesh : originalMesh;
 
@@ -291,7 +331,7 @@ namespace Skylicht
 		{
 			IMeshBuffer* originalMeshBuffer = sourceMesh->getMeshBuffer(i);
 			IVertexBuffer* originalVertexbuffer = originalMeshBuffer->getVertexBuffer(0);
-			video::S3DVertexSkinTangents* vertex = (video::S3DVertexSkinTangents*)originalVertexbuffer->getVertices();
+			const video::S3DVertexSkinTangents* vertex = (video::S3DVertexSkinTangents*)originalVertexbuffer->getVertices();
 
 			int numVertex = originalVertexbuffer->getVertexCount();
 
@@ -299,87 +339,17 @@ namespace Skylicht
 			IVertexBuffer* resultVertexBuffer = resultMeshBuffer->getVertexBuffer(0);
 			video::S3DVertex* resultVertex = (video::S3DVertex*)resultVertexBuffer->getVertices();
 
-#ifdef VERTEX_NORMALIZE
-			float length, invLength;
-#endif
-
 			// skinning
-			for (int i = 0; i < numVertex; i++)
-			{
-				resultVertex->Pos.X = 0.0f;
-				resultVertex->Pos.Y = 0.0f;
-				resultVertex->Pos.Z = 0.0f;
-
-				resultVertex->Normal.X = 0.0f;
-				resultVertex->Normal.Y = 0.0f;
-				resultVertex->Normal.Z = 0.0f;
-
-				// bone 0
-				if (vertex->BoneWeight.X > 0.0f)
-				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.X].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.X);
-				}
-
-				// bone 1
-				if (vertex->BoneWeight.Y > 0.0f)
+			System::CJobSystem::runParallelFor(numVertex, SkinningGrainSize,
+				[arrayJoint, vertex, resultVertex](int begin, int end)
 				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.Y].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.Y);
-				}
-
-				// bone 2
-				if (vertex->BoneWeight.Z > 0.0f)
-				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.Z].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.Z);
-				}
-
-				// bone 3
-				if (vertex->BoneWeight.W > 0.0f)
-				{
-					skinVertex(arrayJoint[(int)vertex->BoneIndex.W].SkinningMatrix,
-						resultVertex->Pos,
-						resultVertex->Normal,
-						vertex->Pos,
-						vertex->Normal,
-						vertex->BoneWeight.W);
-				}
-
-				// apply skin normal
-#ifdef VERTEX_NORMALIZE
-				length = resultVertex->Normal.X * resultVertex->Normal.X +
-					resultVertex->Normal.Y * resultVertex->Normal.Y +
-					resultVertex->Normal.Z * resultVertex->Normal.Z;
-
-				invLength = 1.0f / sqrtf(length);
-				resultVertex->Normal.X = resultVertex->Normal.X * invLength;
-				resultVertex->Normal.Y = resultVertex->Normal.Y * invLength;
-				resultVertex->Normal.Z = resultVertex->Normal.Z * invLength;
-#endif
-
-				++resultVertex;
-				++vertex;
-			}
+					skinVertexRange(arrayJoint, vertex, resultVertex, begin, end);
+				});
 		}
 
 		skinnedMesh->setDirty(EBT_VERTEX);
 	}
 
-	float px, py, pz, nx, ny, nz;
-
 	void CSoftwareSkinningUtils::skinVertex(const float* m,
 		core::vector3df& vertex,
 		core::vector3df& normal,
@@ -387,13 +357,13 @@ namespace Skylicht
 		const core::vector3df& srcNormal,
 		const float& weight)
 	{
-		px = srcPos.X * m[0] + srcPos.Y * m[4] + srcPos.Z * m[8] + m[12];
-		py = srcPos.X * m[1] + srcPos.Y * m[5] + srcPos.Z * m[9] + m[13];
-		pz = srcPos.X * m[2] + srcPos.Y * m[6] + srcPos.Z * m[10] + m[14];
+		float px = srcPos.X * m[0] + srcPos.Y * m[4] + srcPos.Z * m[8] + m[12];
+		float py = srcPos.X * m[1] + srcPos.Y * m[5] + srcPos.Z * m[9] + m[13];
+		float pz = srcPos.X * m[2] + srcPos.Y * m[6] + srcPos.Z * m[10] + m[14];
 
-		nx = srcNormal.X * m[0] + srcNormal.Y * m[4] + srcNormal.Z * m[8];
-		ny = srcNormal.X * m[1] + srcNormal.Y * m[5] + srcNormal.Z * m[9];
-		nz = srcNormal.X * m[2] + srcNormal.Y * m[6] + srcNormal.Z * m[10];
+		float nx = srcNormal.X * m[0] + srcNormal.Y * m[4] + srcNormal.Z * m[8];
+		float ny = srcNormal.X * m[1] + srcNormal.Y * m[5] + srcNormal.Z * m[9];
+		float nz = srcNormal.X * m[2] + srcNormal.Y * m[6] + srcNormal.Z * m[10];
 
 		px *= weight;
 		py *= weight;
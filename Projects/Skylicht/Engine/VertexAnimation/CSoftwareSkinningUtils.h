@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #pragma once
 
 #include "RenderMesh/CRenderMesh.h"
+#include "RenderMesh/CSkinnedMesh.h"
 #include "Animation/Skeleton/CSkeleton.h"
 
 namespace Skylicht
@@ -42,6 +43,11 @@ namespace Skylicht
 
 		static void softwareSkinningTangent(CMesh* renderMesh, CSkinnedMesh* originalMesh, CSkinnedMesh* blendShapeMesh);
 
+		/// @brief Skin the vertices [begin, end) of src to dst by the joint skinning matrices, it uses SSE or NEON when available.
+		static void skinVertices(const CSkinnedMesh::SJoint* joints, const video::S3DVertexSkin* src, video::S3DVertex* dst, int begin, int end);
+
+		static void skinVertices(const CSkinnedMesh::SJoint* joints, const video::S3DVertexSkinTangents* src, video::S3DVertex* dst, int begin, int end);
+
 		static void skinVertex(const float* m,
 			core::vector3df& vertex,
 			core::vector3df& normal,
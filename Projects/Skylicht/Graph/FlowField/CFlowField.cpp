@@ -0,0 +1,219 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CFlowField.h"
+
+namespace Skylicht
+{
+	namespace Graph
+	{
+		CFlowField::CFlowField(CWalkingTileMap* map, STile* goal) :
+			m_map(map),
+			m_goal(goal),
+			m_markId(0)
+		{
+
+		}
+
+		CFlowField::~CFlowField()
+		{
+
+		}
+
+		void CFlowField::build()
+		{
+			u32 numTile = m_map->getNumTile();
+
+			m_distance.set_used(numTile);
+			m_next.set_used(numTile);
+			m_direction.set_used(numTile);
+
+			for (u32 i = 0; i < numTile; i++)
+			{
+				m_distance[i] = -1.0f;
+				m_next[i] = NULL;
+				m_direction[i].set(0.0f, 0.0f, 0.0f);
+			}
+
+			if (m_mark.size() != numTile)
+			{
+				m_mark.set_used(numTile);
+				for (u32 i = 0; i < numTile; i++)
+					m_mark[i] = 0;
+				m_markId = 0;
+			}
+
+			m_queue.clear();
+
+			if (!m_goal->Blocked)
+			{
+				m_distance[m_goal->Id] = 0.0f;
+				m_queue.push({ 0.0f, m_goal });
+			}
+
+			propagate();
+		}
+
+		void CFlowField::setNext(STile* tile, STile* next, float distance)
+		{
+			int id = tile->Id;
+
+			m_distance[id] = distance;
+			m_next[id] = next;
+
+			m_direction[id] = next->Position - tile->Position;
+			m_direction[id].normalize();
+		}
+
+		void CFlowField::propagate()
+		{
+			// dijkstra from the goal, the old item in the queue is skipped
+			while (!m_queue.empty())
+			{
+				SDistanceTile t = m_queue.top();
+				m_queue.pop();
+
+				STile* tile = t.Tile;
+				if (t.Distance > m_distance[tile->Id])
+					continue;
+
+				for (u32 i = 0, n = tile->Neighbours.size(); i < n; i++)
+				{
+					STile* nei = tile->Neighbours[i];
+					if (nei->Blocked)
+						continue;
+
+					float distance = t.Distance + (nei->Position - tile->Position).getLength();
+					float current = m_distance[nei->Id];
+
+					if (current < 0.0f || distance < current)
+					{
+						setNext(nei, tile, distance);
+						m_queue.push({ distance, nei });
+					}
+				}
+			}
+		}
+
+		void CFlowField::updateTiles(STile** tiles, int count)
+		{
+			if (m_distance.size() != m_map->getNumTile())
+			{
+				// the map is changed
+				build();
+				return;
+			}
+
+			m_markId++;
+			if (m_markId == 0)
+			{
+				for (u32 i = 0, n = m_mark.size(); i < n; i++)
+					m_mark[i] = 0;
+				m_markId = 1;
+			}
+
+			// step 1: the changed tiles, and the tiles that their path goes through the changed tiles
+			core::array<STile*> invalid;
+			for (int i = 0; i < count; i++)
+			{
+				if (m_mark[tiles[i]->Id] != m_markId)
+				{
+					m_mark[tiles[i]->Id] = m_markId;
+					invalid.push_back(tiles[i]);
+				}
+			}
+
+			for (u32 i = 0; i < invalid.size(); i++)
+			{
+				STile* tile = invalid[i];
+
+				for (u32 j = 0, n = tile->Neighbours.size(); j < n; j++)
+				{
+					STile* nei = tile->Neighbours[j];
+					if (m_mark[nei->Id] != m_markId && m_next[nei->Id] == tile)
+					{
+						m_mark[nei->Id] = m_markId;
+						invalid.push_back(nei);
+					}
+				}
+			}
+
+			// step 2: reset them
+			for (u32 i = 0, n = invalid.size(); i < n; i++)
+			{
+				int id = invalid[i]->Id;
+				m_distance[id] = -1.0f;
+				m_next[id] = NULL;
+				m_direction[id].set(0.0f, 0.0f, 0.0f);
+			}
+
+			// step 3: start from the valid neighbours
+			m_queue.clear();
+
+			for (u32 i = 0, n = invalid.size(); i < n; i++)
+			{
+				STile* tile = invalid[i];
+				if (tile->Blocked)
+					continue;
+
+				if (tile == m_goal)
+				{
+					m_distance[tile->Id] = 0.0f;
+					m_queue.push({ 0.0f, tile });
+					continue;
+				}
+
+				for (u32 j = 0, m = tile->Neighbours.size(); j < m; j++)
+				{
+					STile* nei = tile->Neighbours[j];
+					float neiDistance = m_distance[nei->Id];
+
+					if (nei->Blocked || neiDistance < 0.0f)
+						continue;
+
+					float distance = neiDistance + (nei->Position - tile->Position).getLength();
+					if (m_distance[tile->Id] < 0.0f || distance < m_distance[tile->Id])
+						setNext(tile, nei, distance);
+				}
+
+				if (m_distance[tile->Id] >= 0.0f)
+					m_queue.push({ m_distance[tile->Id], tile });
+			}
+
+			// step 4: the unblocked tiles can make the shorter path for the valid tiles too
+			propagate();
+		}
+
+		bool CFlowField::getDirection(const core::vector3df& position, core::vector3df& outDirection)
+		{
+			STile* tile = m_map->getTileByPosition(position);
+			if (tile == NULL || (u32)tile->Id >= m_distance.size() || m_distance[tile->Id] < 0.0f)
+				return false;
+
+			outDirection = m_direction[tile->Id];
+			return true;
+		}
+	}
+}
@@ -0,0 +1,106 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "WalkingMap/CWalkingTileMap.h"
+#include "Graph/CGraphQuery.h"
+
+namespace Skylicht
+{
+	namespace Graph
+	{
+		/// @brief The flow field of a goal on the walking tile map, for the crowd that go to the same goal.
+		///
+		/// The integration field is the walk distance to the goal (Dijkstra from the goal over STile::Neighbours),
+		/// and the direction field points to the next tile, so the agents get their direction in O(1).
+		/// When the tiles change (STile::Blocked, Neighbours), updateTiles() repairs only the tiles that the change affects.
+		class CFlowField
+		{
+		protected:
+			CWalkingTileMap* m_map;
+			STile* m_goal;
+
+			// -1 if the tile can not go to the goal
+			core::array<float> m_distance;
+			core::array<STile*> m_next;
+			core::array<core::vector3df> m_direction;
+
+			CDistancePriorityQueue m_queue;
+
+			// the mark of the tiles in updateTiles
+			core::array<u32> m_mark;
+			u32 m_markId;
+
+		public:
+			CFlowField(CWalkingTileMap* map, STile* goal);
+
+			virtual ~CFlowField();
+
+			/// @brief Compute all tiles
+			void build();
+
+			/// @brief Repair the field after the tiles changed (blocked/unblocked or the neighbours changed).
+			/// If the neighbours of a tile changed, the tiles at both sides of the link must be in the list.
+			void updateTiles(STile** tiles, int count);
+
+			inline STile* getGoal()
+			{
+				return m_goal;
+			}
+
+			inline bool canReach(STile* tile)
+			{
+				return m_distance[tile->Id] >= 0.0f;
+			}
+
+			/// @brief The walk distance to the goal, -1 if the tile can not go to the goal
+			inline float getDistance(STile* tile)
+			{
+				return m_distance[tile->Id];
+			}
+
+			/// @brief The next tile to the goal, NULL on the goal or if it can not go to the goal
+			inline STile* getNextTile(STile* tile)
+			{
+				return m_next[tile->Id];
+			}
+
+			/// @brief The normalized direction to the next tile, zero on the goal or if it can not go to the goal
+			inline const core::vector3df& getDirection(STile* tile)
+			{
+				return m_direction[tile->Id];
+			}
+
+			/// @brief The direction at the position, it returns false if the position is not on a tile that can go to the goal
+			bool getDirection(const core::vector3df& position, core::vector3df& outDirection);
+
+		protected:
+
+			void setNext(STile* tile, STile* next, float distance);
+
+			void propagate();
+		};
+	}
+}
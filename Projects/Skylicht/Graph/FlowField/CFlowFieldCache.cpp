@@ -0,0 +1,92 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CFlowFieldCache.h"
+
+namespace Skylicht
+{
+	namespace Graph
+	{
+		CFlowFieldCache::CFlowFieldCache(CWalkingTileMap* map, u32 maxFields) :
+			m_map(map),
+			m_maxFields(core::max_(maxFields, 1u)),
+			m_useCounter(0)
+		{
+
+		}
+
+		CFlowFieldCache::~CFlowFieldCache()
+		{
+			clear();
+		}
+
+		void CFlowFieldCache::clear()
+		{
+			for (auto& it : m_fields)
+				delete it.second.Field;
+
+			m_fields.clear();
+		}
+
+		CFlowField* CFlowFieldCache::getFlowField(STile* goal)
+		{
+			m_useCounter++;
+
+			auto it = m_fields.find(goal);
+			if (it != m_fields.end())
+			{
+				it->second.LastUse = m_useCounter;
+				return it->second.Field;
+			}
+
+			// remove the least recently used field
+			while (m_fields.size() >= m_maxFields)
+			{
+				auto oldest = m_fields.begin();
+				for (auto i = m_fields.begin(); i != m_fields.end(); ++i)
+				{
+					if (i->second.LastUse < oldest->second.LastUse)
+						oldest = i;
+				}
+
+				delete oldest->second.Field;
+				m_fields.erase(oldest);
+			}
+
+			SCacheField& cache = m_fields[goal];
+			cache.Field = new CFlowField(m_map, goal);
+			cache.LastUse = m_useCounter;
+			cache.Field->build();
+
+			return cache.Field;
+		}
+
+		void CFlowFieldCache::updateTiles(STile** tiles, int count)
+		{
+			for (auto& it : m_fields)
+				it.second.Field->updateTiles(tiles, count);
+		}
+	}
+}
@@ -0,0 +1,76 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CFlowField.h"
+
+namespace Skylicht
+{
+	namespace Graph
+	{
+		/// @brief The flow fields of the goals on a walking tile map.
+		/// The field is built on the first request of its goal, the least recently used field is removed when the cache is full.
+		class CFlowFieldCache
+		{
+		protected:
+			struct SCacheField
+			{
+				CFlowField* Field;
+				u32 LastUse;
+			};
+
+			CWalkingTileMap* m_map;
+
+			std::map<STile*, SCacheField> m_fields;
+
+			u32 m_maxFields;
+			u32 m_useCounter;
+
+		public:
+			CFlowFieldCache(CWalkingTileMap* map, u32 maxFields = 8);
+
+			virtual ~CFlowFieldCache();
+
+			/// @brief Get the field of the goal, the pointer is valid until the field is removed from the cache.
+			CFlowField* getFlowField(STile* goal);
+
+			/// @brief Repair all cached fields after the tiles changed, see CFlowField::updateTiles
+			void updateTiles(STile** tiles, int count);
+
+			/// @brief Remove all fields, call it when the map is generated again
+			void clear();
+
+			inline void setMaxFields(u32 maxFields)
+			{
+				m_maxFields = core::max_(maxFields, 1u);
+			}
+
+			inline u32 getNumFields()
+			{
+				return (u32)m_fields.size();
+			}
+		};
+	}
+}
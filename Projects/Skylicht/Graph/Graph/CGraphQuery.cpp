@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "CGraphQuery.h"
 
+#include "Thread/CJobSystem.h"
+
 namespace Skylicht
 {
 	namespace Graph
@@ -34,46 +36,108 @@ namespace Skylicht
 
 		void CDistancePriorityQueue::push(const SDistanceTile& d)
 		{
+			m_queue.push_back(d);
+
+			// sift up
 			SDistanceTile* a = m_queue.pointer();
+			u32 i = m_queue.size() - 1;
 
-			// find position
-			int pos = -1;
-			for (u32 i = 0, n = m_queue.size(); i < n; i++)
+			while (i > 0)
 			{
-				if (m_queue[i].Distance < d.Distance)
-				{
-					pos = i;
+				u32 parent = (i - 1) >> 1;
+				if (a[parent].Distance <= d.Distance)
 					break;
-				}
+
+				a[i] = a[parent];
+				i = parent;
 			}
 
-			if (pos == -1)
-				pos = m_queue.size();
+			a[i] = d;
+		}
+
+		void CDistancePriorityQueue::pop()
+		{
+			u32 n = m_queue.size() - 1;
+			if (n == 0)
+			{
+				m_queue.set_used(0);
+				return;
+			}
 
-			// insert empty at last
-			m_queue.push_back(SDistanceTile());
+			// move the last to the root and sift down
+			SDistanceTile* a = m_queue.pointer();
+			SDistanceTile d = a[n];
+			u32 i = 0;
 
-			// swap
-			for (int i = m_queue.size() - 1; i > pos; i--)
+			while (true)
 			{
-				SDistanceTile t = m_queue[i];
-				m_queue[i] = m_queue[i - 1];
-				m_queue[i - 1] = t;
+				u32 child = (i << 1) + 1;
+				if (child >= n)
+					break;
+
+				if (child + 1 < n && a[child + 1].Distance < a[child].Distance)
+					child++;
+
+				if (d.Distance <= a[child].Distance)
+					break;
+
+				a[i] = a[child];
+				i = child;
 			}
 
-			m_queue[pos] = d;
+			a[i] = d;
+			m_queue.set_used(n);
 		}
 
-		void CDistancePriorityQueue::pop()
+		const SDistanceTile& CDistancePriorityQueue::top()
 		{
-			m_queue.set_used(m_queue.size() - 1);
+			return m_queue[0];
 		}
 
-		const SDistanceTile& CDistancePriorityQueue::top()
+		CPathQueryContext::CPathQueryContext() :
+			Generation(0)
 		{
-			return m_queue.getLast();
+
+		}
+
+		CPathQueryContext::~CPathQueryContext()
+		{
+
 		}
 
+		void CPathQueryContext::begin(u32 numTile)
+		{
+			Queue.clear();
+
+			if (Open.size() < numTile)
+			{
+				u32 oldSize = Open.size();
+
+				Distance.set_used(numTile);
+				Prev.set_used(numTile);
+				Open.set_used(numTile);
+				Closed.set_used(numTile);
+
+				for (u32 i = oldSize; i < numTile; i++)
+				{
+					Open[i] = 0;
+					Closed[i] = 0;
+				}
+			}
+
+			Generation++;
+
+			if (Generation == 0)
+			{
+				// the counter wraps, clear the old marks
+				for (u32 i = 0, n = Open.size(); i < n; i++)
+				{
+					Open[i] = 0;
+					Closed[i] = 0;
+				}
+				Generation = 1;
+			}
+		}
 
 		CGraphQuery::CGraphQuery() :
 			m_root(NULL),
@@ -85,6 +149,10 @@ namespace Skylicht
 		CGraphQuery::~CGraphQuery()
 		{
 			release();
+
+			for (u32 i = 0, n = m_contexts.size(); i < n; i++)
+				delete m_contexts[i];
+			m_contexts.clear();
 		}
 
 		void CGraphQuery::release()
@@ -434,34 +502,79 @@ namespace Skylicht
 			}
 		}
 
+		CPathQueryContext* CGraphQuery::acquireContext()
+		{
+			std::lock_guard<std::mutex> lock(m_contextMutex);
+
+			if (m_contexts.size() == 0)
+				return new CPathQueryContext();
+
+			CPathQueryContext* context = m_contexts.getLast();
+			m_contexts.erase(m_contexts.size() - 1);
+			return context;
+		}
+
+		void CGraphQuery::releaseContext(CPathQueryContext* context)
+		{
+			std::lock_guard<std::mutex> lock(m_contextMutex);
+			m_contexts.push_back(context);
+		}
+
 		bool CGraphQuery::findPath(CWalkingTileMap* map, STile* from, STile* to, core::array<STile*>& result)
 		{
-			result.clear();
-			u32 numTile = map->getNumTile();
+			CPathQueryContext* context = acquireContext();
+			bool found = findPath(context, map, from, to, result);
+			releaseContext(context);
+			return found;
+		}
+
+		void CGraphQuery::findPaths(CWalkingTileMap* map, SPathRequest* requests, int count)
+		{
+			CGraphQuery* query = this;
 
-			CDistancePriorityQueue queue;
+			System::CJobSystem::runParallelFor(count, 8, [query, map, requests](int begin, int end)
+				{
+					CPathQueryContext* context = query->acquireContext();
 
-			std::vector<STile*> prev(numTile, NULL);
-			std::vector<float> dist(numTile, -1.0);
+					for (int i = begin; i < end; i++)
+					{
+						SPathRequest& r = requests[i];
+						r.Found = query->findPath(context, map, r.From, r.To, r.Result);
+					}
+
+					query->releaseContext(context);
+				});
+		}
 
-			float length = (to->Position - from->Position).getLengthSQ();
+		bool CGraphQuery::findPath(CPathQueryContext* context, CWalkingTileMap* map, STile* from, STile* to, core::array<STile*>& result)
+		{
+			result.set_used(0);
+
+			context->begin(map->getNumTile());
+
+			CDistancePriorityQueue& queue = context->Queue;
+			float* dist = context->Distance.pointer();
+			STile** prev = context->Prev.pointer();
+			u32* open = context->Open.pointer();
+			u32* closed = context->Closed.pointer();
+			u32 generation = context->Generation;
+
+			float length = (to->Position - from->Position).getLength();
 			queue.push({ length, from });
 
+			open[from->Id] = generation;
 			dist[from->Id] = 0.0f;
-
-			map->resetVisit();
+			prev[from->Id] = NULL;
 
 			while (!queue.empty())
 			{
-				const SDistanceTile& t = queue.top();
-
-				STile* tile = t.Tile;
+				STile* tile = queue.top().Tile;
 				queue.pop();
 
-				if (tile->Visit)
+				if (closed[tile->Id] == generation)
 					continue;
 
-				tile->Visit = true;
+				closed[tile->Id] = generation;
 				if (tile == to)
 					break;
 
@@ -470,27 +583,29 @@ namespace Skylicht
 				for (u32 i = 0, n = tile->Neighbours.size(); i < n; i++)
 				{
 					STile* nei = tile->Neighbours[i];
+					int neiId = nei->Id;
+
+					if (closed[neiId] == generation || nei->Blocked)
+						continue;
 
 					float neiDist = (nei->Position - tile->Position).getLength();
 					float currentDist = walkDistance + neiDist;
 
-					if (dist[nei->Id] < 0 || dist[nei->Id] > currentDist)
+					if (open[neiId] != generation || dist[neiId] > currentDist)
 					{
 						// if not yet calc dist of nei
 						// or have another link shorter
-						dist[nei->Id] = currentDist;
+						open[neiId] = generation;
+						dist[neiId] = currentDist;
+						prev[neiId] = tile;
 
 						float length = currentDist + (to->Position - nei->Position).getLength();
 						queue.push({ length, nei });
-
-						prev[nei->Id] = tile;
 					}
 				}
 			}
 
-			map->resetVisit();
-
-			if (prev[to->Id] == NULL)
+			if (open[to->Id] != generation || prev[to->Id] == NULL)
 				return false;
 
 			STile* u = to;
@@ -512,4 +627,4 @@ namespace Skylicht
 			return true;
 		}
 	}
-}
\ No newline at end of file
+}
@@ -28,6 +28,8 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "ObstacleAvoidance/CObstacleAvoidance.h"
 #include "WalkingMap/CWalkingTileMap.h"
 
+#include <mutex>
+
 namespace Skylicht
 {
 	namespace Graph
@@ -57,6 +59,7 @@ namespace Skylicht
 			STile* Tile;
 		};
 
+		/// @brief The binary min-heap of the open tiles, top() is the tile that has the smallest distance.
 		class CDistancePriorityQueue
 		{
 		protected:
@@ -76,9 +79,71 @@ namespace Skylicht
 				return m_queue.empty();
 			}
 
+			inline void clear()
+			{
+				m_queue.set_used(0);
+			}
+
+			inline u32 size()
+			{
+				return m_queue.size();
+			}
+
 			const SDistanceTile& top();
 		};
 
+		/// @brief The search state of a path query, it is reused by the next queries.
+		/// The tiles are marked with the generation of the query, so the arrays are not cleared on each query.
+		class CPathQueryContext
+		{
+		public:
+			CDistancePriorityQueue Queue;
+
+			core::array<float> Distance;
+			core::array<STile*> Prev;
+
+			// Distance & Prev of the tile is valid if Open[id] == Generation
+			core::array<u32> Open;
+
+			// the tile is visited if Closed[id] == Generation
+			core::array<u32> Closed;
+
+			u32 Generation;
+
+		public:
+			CPathQueryContext();
+
+			virtual ~CPathQueryContext();
+
+			void begin(u32 numTile);
+
+			inline bool isOpen(int id)
+			{
+				return Open[id] == Generation;
+			}
+
+			inline bool isClosed(int id)
+			{
+				return Closed[id] == Generation;
+			}
+		};
+
+		/// @brief The path query of CGraphQuery::findPaths
+		struct SPathRequest
+		{
+			STile* From;
+			STile* To;
+			core::array<STile*> Result;
+			bool Found;
+
+			SPathRequest() :
+				From(NULL),
+				To(NULL),
+				Found(false)
+			{
+			}
+		};
+
 		class CGraphQuery
 		{
 		protected:
@@ -86,6 +151,9 @@ namespace Skylicht
 
 			u32 m_minimalPolysPerNode;
 
+			core::array<CPathQueryContext*> m_contexts;
+			std::mutex m_contextMutex;
+
 		public:
 			CGraphQuery();
 
@@ -110,8 +178,20 @@ namespace Skylicht
 
 			void getObstacles(const core::aabbox3df& box, CObstacleAvoidance& obstacle);
 
+			/// @brief Find the shortest path (A*) on the tile map, it does not change the map so the queries can run on many threads.
 			bool findPath(CWalkingTileMap* map, STile* from, STile* to, core::array<STile*>& result);
 
+			/// @brief findPath with the search state of the caller.
+			bool findPath(CPathQueryContext* context, CWalkingTileMap* map, STile* from, STile* to, core::array<STile*>& result);
+
+			/// @brief Find the paths of many agents, the requests run on the job system.
+			void findPaths(CWalkingTileMap* map, SPathRequest* requests, int count);
+
+			/// @brief Get a search state from the pool, call releaseContext when the query is done.
+			CPathQueryContext* acquireContext();
+
+			void releaseContext(CPathQueryContext* context);
+
 		protected:
 
 			void constructOctree(COctreeNode* node);
@@ -45,6 +45,9 @@ namespace Skylicht
 			core::array<STile*> Neighbours;
 			bool Visit;
 
+			// the dynamic obstacle (closed door...), the path does not go through this tile
+			bool Blocked;
+
 			STile()
 			{
 				Id = 0;
@@ -53,6 +56,7 @@ namespace Skylicht
 				Z = 0;
 				AreaId = 0;
 				Visit = false;
+				Blocked = false;
 			}
 		};
 
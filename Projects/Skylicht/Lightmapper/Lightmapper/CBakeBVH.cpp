@@ -0,0 +1,420 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBakeBVH.h"
+
+#define BAKE_BVH_BIN_COUNT 12
+#define BAKE_BVH_MAX_DEPTH 60
+#define BAKE_BVH_TRAVERSAL_COST 1.0f
+
+namespace Skylicht
+{
+	namespace Lightmapper
+	{
+		CBakeBVH::CBakeBVH() :
+			m_maxLeafSize(4)
+		{
+
+		}
+
+		CBakeBVH::~CBakeBVH()
+		{
+
+		}
+
+		void CBakeBVH::clear()
+		{
+			m_nodes.clear();
+			m_triangles.clear();
+			m_refs.clear();
+			m_box.reset(0.0f, 0.0f, 0.0f);
+		}
+
+		bool CBakeBVH::addTriangle(const core::vector3df& a, const core::vector3df& b, const core::vector3df& c, const core::vector3df& albedo)
+		{
+			SBakeTriangle tri;
+			tri.A = a;
+			tri.Edge1 = b - a;
+			tri.Edge2 = c - a;
+			tri.Normal = tri.Edge1.crossProduct(tri.Edge2);
+
+			f32 length = tri.Normal.getLength();
+			if (length < 1e-12f)
+				return false;
+
+			tri.Normal /= length;
+			tri.Albedo = albedo;
+
+			m_triangles.push_back(tri);
+			return true;
+		}
+
+		void CBakeBVH::build()
+		{
+			m_nodes.set_used(0);
+
+			u32 count = m_triangles.size();
+			if (count == 0)
+				return;
+
+			m_refs.set_used(count);
+
+			for (u32 i = 0; i < count; i++)
+			{
+				const SBakeTriangle& tri = m_triangles[i];
+
+				SBuildRef& ref = m_refs[i];
+				ref.Box.reset(tri.A);
+				ref.Box.addInternalPoint(tri.A + tri.Edge1);
+				ref.Box.addInternalPoint(tri.A + tri.Edge2);
+				ref.Center = ref.Box.getCenter();
+				ref.Id = i;
+			}
+
+			// it sorts the refs in leaf order
+			m_nodes.reallocate(count);
+			buildNode(0, count, 0);
+
+			// pack the triangles in leaf order
+			core::array<SBakeTriangle> triangles;
+			triangles.set_used(count);
+			for (u32 i = 0; i < count; i++)
+				triangles[i] = m_triangles[m_refs[i].Id];
+			m_triangles.swap(triangles);
+
+			const SNode& root = m_nodes[0];
+			m_box.MinEdge.set(root.Min[0], root.Min[1], root.Min[2]);
+			m_box.MaxEdge.set(root.Max[0], root.Max[1], root.Max[2]);
+
+			m_refs.clear();
+		}
+
+		void CBakeBVH::setNodeBox(SNode& node, const core::aabbox3df& box)
+		{
+			node.Min[0] = box.MinEdge.X;
+			node.Min[1] = box.MinEdge.Y;
+			node.Min[2] = box.MinEdge.Z;
+			node.Max[0] = box.MaxEdge.X;
+			node.Max[1] = box.MaxEdge.Y;
+			node.Max[2] = box.MaxEdge.Z;
+		}
+
+		u32 CBakeBVH::buildNode(u32 begin, u32 end, int depth)
+		{
+			u32 nodeId = m_nodes.size();
+			m_nodes.push_back(SNode());
+
+			SBuildRef* refs = m_refs.pointer();
+
+			core::aabbox3df box = refs[begin].Box;
+			core::aabbox3df centerBox(refs[begin].Center);
+
+			for (u32 i = begin + 1; i < end; i++)
+			{
+				box.addInternalBox(refs[i].Box);
+				centerBox.addInternalPoint(refs[i].Center);
+			}
+
+			SNode& node = m_nodes[nodeId];
+			setNodeBox(node, box);
+			node.Offset = begin;
+			node.Count = end - begin;
+
+			u32 count = end - begin;
+			if (count <= 1 || depth >= BAKE_BVH_MAX_DEPTH)
+				return nodeId;
+
+			// the binned SAH, the cost is relative to the intersection cost of a triangle
+			f32 parentArea = core::max_(box.getArea(), 1e-12f);
+			f32 bestCost = (f32)count;
+			int bestAxis = -1;
+			int bestBin = 0;
+
+			const f32* centerMin = &centerBox.MinEdge.X;
+			const f32* centerMax = &centerBox.MaxEdge.X;
+
+			core::aabbox3df binBox[BAKE_BVH_BIN_COUNT];
+			u32 binCount[BAKE_BVH_BIN_COUNT];
+			f32 rightArea[BAKE_BVH_BIN_COUNT];
+			u32 rightCount[BAKE_BVH_BIN_COUNT];
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				f32 extent = centerMax[axis] - centerMin[axis];
+				if (extent <= 1e-6f)
+					continue;
+
+				f32 scale = BAKE_BVH_BIN_COUNT * 0.9999f / extent;
+
+				for (int b = 0; b < BAKE_BVH_BIN_COUNT; b++)
+					binCount[b] = 0;
+
+				for (u32 i = begin; i < end; i++)
+				{
+					const f32* c = &refs[i].Center.X;
+					int b = (int)((c[axis] - centerMin[axis]) * scale);
+
+					if (binCount[b] == 0)
+						binBox[b] = refs[i].Box;
+					else
+						binBox[b].addInternalBox(refs[i].Box);
+
+					binCount[b]++;
+				}
+
+				// sweep from right
+				core::aabbox3df accBox;
+				u32 accCount = 0;
+				for (int b = BAKE_BVH_BIN_COUNT - 1; b > 0; b--)
+				{
+					if (binCount[b] > 0)
+					{
+						if (accCount == 0)
+							accBox = binBox[b];
+						else
+							accBox.addInternalBox(binBox[b]);
+						accCount += binCount[b];
+					}
+					rightArea[b] = accCount > 0 ? accBox.getArea() : 0.0f;
+					rightCount[b] = accCount;
+				}
+
+				// sweep from left, split after the bin b
+				accCount = 0;
+				for (int b = 0; b < BAKE_BVH_BIN_COUNT - 1; b++)
+				{
+					if (binCount[b] > 0)
+					{
+						if (accCount == 0)
+							accBox = binBox[b];
+						else
+							accBox.addInternalBox(binBox[b]);
+						accCount += binCount[b];
+					}
+
+					if (accCount == 0 || rightCount[b + 1] == 0)
+						continue;
+
+					f32 cost = BAKE_BVH_TRAVERSAL_COST + (accBox.getArea() * accCount + rightArea[b + 1] * rightCount[b + 1]) / parentArea;
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestBin = b;
+					}
+				}
+			}
+
+			u32 mid = begin;
+
+			if (bestAxis >= 0)
+			{
+				// split at the best bin
+				f32 cmin = centerMin[bestAxis];
+				f32 scale = BAKE_BVH_BIN_COUNT * 0.9999f / (centerMax[bestAxis] - cmin);
+
+				SBuildRef* p = std::partition(refs + begin, refs + end, [bestAxis, bestBin, cmin, scale](const SBuildRef& ref)
+					{
+						const f32* c = &ref.Center.X;
+						return (int)((c[bestAxis] - cmin) * scale) <= bestBin;
+					});
+
+				mid = (u32)(p - refs);
+			}
+			else if (count > m_maxLeafSize)
+			{
+				// the SAH does not find the split (the same centers), but the leaf is too big
+				mid = begin + count / 2;
+			}
+			else
+			{
+				// leaf
+				return nodeId;
+			}
+
+			if (mid == begin || mid == end)
+				mid = begin + count / 2;
+
+			buildNode(begin, mid, depth + 1);
+			u32 right = buildNode(mid, end, depth + 1);
+
+			// the reference node is invalid after the push_back
+			m_nodes[nodeId].Offset = right;
+			m_nodes[nodeId].Count = 0;
+
+			return nodeId;
+		}
+
+		static inline bool intersectNode(const CBakeBVH::SNode& node, const f32* origin, const f32* invDir, f32 tMax, f32& tNear)
+		{
+			f32 t1 = (node.Min[0] - origin[0]) * invDir[0];
+			f32 t2 = (node.Max[0] - origin[0]) * invDir[0];
+			f32 tmin = core::min_(t1, t2);
+			f32 tmax = core::max_(t1, t2);
+
+			t1 = (node.Min[1] - origin[1]) * invDir[1];
+			t2 = (node.Max[1] - origin[1]) * invDir[1];
+			tmin = core::max_(tmin, core::min_(t1, t2));
+			tmax = core::min_(tmax, core::max_(t1, t2));
+
+			t1 = (node.Min[2] - origin[2]) * invDir[2];
+			t2 = (node.Max[2] - origin[2]) * invDir[2];
+			tmin = core::max_(tmin, core::min_(t1, t2));
+			tmax = core::min_(tmax, core::max_(t1, t2));
+
+			tmin = core::max_(tmin, 0.0f);
+			tmax = core::min_(tmax, tMax);
+
+			tNear = tmin;
+			return tmin <= tmax;
+		}
+
+		template<bool AnyHit>
+		bool CBakeBVH::traverseRay(const core::vector3df& origin, const core::vector3df& dir, f32 tMax, SBakeHit& hit) const
+		{
+			if (m_nodes.size() == 0)
+				return false;
+
+			const SNode* nodes = m_nodes.const_pointer();
+			const SBakeTriangle* triangles = m_triangles.const_pointer();
+
+			// a big number instead of infinity, that avoids the NaN (0 * inf) in the slab test
+			const f32 big = 1e30f;
+
+			f32 invDir[3];
+			invDir[0] = fabsf(dir.X) > 1e-20f ? 1.0f / dir.X : (dir.X >= 0.0f ? big : -big);
+			invDir[1] = fabsf(dir.Y) > 1e-20f ? 1.0f / dir.Y : (dir.Y >= 0.0f ? big : -big);
+			invDir[2] = fabsf(dir.Z) > 1e-20f ? 1.0f / dir.Z : (dir.Z >= 0.0f ? big : -big);
+
+			const f32* o = &origin.X;
+
+			struct SStackItem
+			{
+				u32 Node;
+				f32 TNear;
+			};
+
+			SStackItem stack[BAKE_BVH_STACK_SIZE];
+			int sp = 0;
+
+			f32 tBest = tMax;
+			bool found = false;
+
+			f32 tNear = 0.0f;
+			if (!intersectNode(nodes[0], o, invDir, tBest, tNear))
+				return false;
+
+			u32 nodeId = 0;
+
+			while (true)
+			{
+				const SNode& node = nodes[nodeId];
+
+				if (node.Count > 0)
+				{
+					for (u32 i = node.Offset, end = node.Offset + node.Count; i < end; i++)
+					{
+						f32 t;
+						if (intersectTriangle(triangles[i], origin, dir, t) && t > 0.0f && t < tBest)
+						{
+							if (AnyHit)
+								return true;
+
+							tBest = t;
+							hit.Triangle = i;
+							hit.T = t;
+							found = true;
+						}
+					}
+				}
+				else
+				{
+					u32 left = nodeId + 1;
+					u32 right = node.Offset;
+
+					f32 tLeft, tRight;
+					bool hitLeft = intersectNode(nodes[left], o, invDir, tBest, tLeft);
+					bool hitRight = intersectNode(nodes[right], o, invDir, tBest, tRight);
+
+					if (hitLeft && hitRight && sp < BAKE_BVH_STACK_SIZE)
+					{
+						// visit the near child first
+						if (tRight < tLeft)
+						{
+							core::swap(left, right);
+							core::swap(tLeft, tRight);
+						}
+
+						stack[sp].Node = right;
+						stack[sp].TNear = tRight;
+						sp++;
+
+						nodeId = left;
+						continue;
+					}
+					else if (hitLeft)
+					{
+						nodeId = left;
+						continue;
+					}
+					else if (hitRight)
+					{
+						nodeId = right;
+						continue;
+					}
+				}
+
+				// pop the node that is nearer than the current hit
+				bool next = false;
+				while (sp > 0)
+				{
+					sp--;
+					if (stack[sp].TNear <= tBest)
+					{
+						nodeId = stack[sp].Node;
+						next = true;
+						break;
+					}
+				}
+
+				if (!next)
+					break;
+			}
+
+			return found;
+		}
+
+		bool CBakeBVH::intersect(const core::vector3df& origin, const core::vector3df& dir, f32 tMax, SBakeHit& hit) const
+		{
+			return traverseRay<false>(origin, dir, tMax, hit);
+		}
+
+		bool CBakeBVH::occluded(const core::vector3df& origin, const core::vector3df& dir, f32 tMax) const
+		{
+			SBakeHit hit;
+			return traverseRay<true>(origin, dir, tMax, hit);
+		}
+	}
+}
@@ -0,0 +1,164 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#define BAKE_BVH_STACK_SIZE 64
+
+namespace Skylicht
+{
+	namespace Lightmapper
+	{
+		/// @brief The triangle that precomputed for the ray test
+		struct SBakeTriangle
+		{
+			core::vector3df A;
+			core::vector3df Edge1;
+			core::vector3df Edge2;
+
+			// the geometric normal
+			core::vector3df Normal;
+
+			// the diffuse color, it is the vertex color
+			core::vector3df Albedo;
+		};
+
+		struct SBakeHit
+		{
+			u32 Triangle;
+			f32 T;
+		};
+
+		/// @brief The bounding volume hierarchy over the scene triangles, that the CPU baker traces the rays on.
+		///
+		/// It is built with the binned surface area heuristic, the nodes are flattened in depth-first order (the left child is the next node).
+		/// The triangles are sorted in leaf order after build. The ray queries do not change the tree, so they can run on many threads.
+		class CBakeBVH
+		{
+		public:
+			struct SNode
+			{
+				f32 Min[3];
+				// leaf: the first triangle, inner node: the right child
+				u32 Offset;
+				f32 Max[3];
+				// the number of triangles, 0 is the inner node
+				u32 Count;
+			};
+
+		protected:
+			struct SBuildRef
+			{
+				core::aabbox3df Box;
+				core::vector3df Center;
+				u32 Id;
+			};
+
+			core::array<SNode> m_nodes;
+			core::array<SBakeTriangle> m_triangles;
+			core::array<SBuildRef> m_refs;
+
+			core::aabbox3df m_box;
+
+			u32 m_maxLeafSize;
+
+		public:
+			CBakeBVH();
+
+			virtual ~CBakeBVH();
+
+			/// @brief Add a triangle, the degenerate triangle is skipped. Call build after add the triangles.
+			bool addTriangle(const core::vector3df& a, const core::vector3df& b, const core::vector3df& c, const core::vector3df& albedo);
+
+			void build();
+
+			void clear();
+
+			inline u32 getTriangleCount()
+			{
+				return m_triangles.size();
+			}
+
+			inline u32 getNodeCount()
+			{
+				return m_nodes.size();
+			}
+
+			inline const SBakeTriangle& getTriangle(u32 i) const
+			{
+				return m_triangles[i];
+			}
+
+			inline const core::aabbox3df& getBoundingBox()
+			{
+				return m_box;
+			}
+
+			inline void setMaxLeafSize(u32 size)
+			{
+				m_maxLeafSize = size;
+			}
+
+			/// @brief Find the nearest triangle that the ray (origin + dir * t, 0 < t < tMax) hits.
+			bool intersect(const core::vector3df& origin, const core::vector3df& dir, f32 tMax, SBakeHit& hit) const;
+
+			/// @brief Test any triangle on the ray (origin + dir * t, 0 < t < tMax), it is used for the shadow ray.
+			bool occluded(const core::vector3df& origin, const core::vector3df& dir, f32 tMax) const;
+
+			static inline bool intersectTriangle(const SBakeTriangle& tri, const core::vector3df& origin, const core::vector3df& dir, f32& t)
+			{
+				// Moller-Trumbore, both faces
+				core::vector3df p = dir.crossProduct(tri.Edge2);
+				f32 det = tri.Edge1.dotProduct(p);
+				if (fabsf(det) < 1e-12f)
+					return false;
+
+				f32 invDet = 1.0f / det;
+				core::vector3df s = origin - tri.A;
+
+				f32 u = s.dotProduct(p) * invDet;
+				if (u < 0.0f || u > 1.0f)
+					return false;
+
+				core::vector3df q = s.crossProduct(tri.Edge1);
+
+				f32 v = dir.dotProduct(q) * invDet;
+				if (v < 0.0f || u + v > 1.0f)
+					return false;
+
+				t = tri.Edge2.dotProduct(q) * invDet;
+				return true;
+			}
+
+		protected:
+
+			u32 buildNode(u32 begin, u32 end, int depth);
+
+			void setNodeBox(SNode& node, const core::aabbox3df& box);
+
+			template<bool AnyHit>
+			bool traverseRay(const core::vector3df& origin, const core::vector3df& dir, f32 tMax, SBakeHit& hit) const;
+		};
+	}
+}
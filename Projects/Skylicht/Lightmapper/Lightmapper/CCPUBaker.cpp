@@ -0,0 +1,512 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CCPUBaker.h"
+#include "CBaker.h"
+#include "GameObject/CGameObject.h"
+#include "RenderMesh/CRenderMeshData.h"
+#include "Transform/CWorldTransformData.h"
+#include "Lighting/CLightCullingData.h"
+#include "Lighting/CPointLight.h"
+#include "Lighting/CAreaLight.h"
+#include "Thread/CJobSystem.h"
+
+#include <atomic>
+
+namespace Skylicht
+{
+	namespace Lightmapper
+	{
+		static inline f32 bakeSmoothStep(f32 edge0, f32 edge1, f32 x)
+		{
+			f32 t = core::clamp((x - edge0) / core::max_(edge1 - edge0, 1e-6f), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
+		}
+
+		// the tangent & binormal of the normal (Duff et al. 2017)
+		static inline void getBakeBasis(const core::vector3df& n, core::vector3df& t, core::vector3df& b)
+		{
+			f32 sign = n.Z >= 0.0f ? 1.0f : -1.0f;
+			f32 a = -1.0f / (sign + n.Z);
+			f32 c = n.X * n.Y * a;
+			t.set(1.0f + sign * n.X * n.X * a, sign * c, -sign * n.X);
+			b.set(c, sign + n.Y * n.Y * a, -n.Y);
+		}
+
+		CCPUBaker::CCPUBaker() :
+			m_entityMgr(NULL),
+			m_numSample(64),
+			m_numPass(4),
+			m_numBounce(1),
+			m_seed(1),
+			m_bias(0.005f),
+			m_sphere(true),
+			m_currentPass(0),
+			m_numRay(0)
+		{
+
+		}
+
+		CCPUBaker::~CCPUBaker()
+		{
+
+		}
+
+		void CCPUBaker::clearScene()
+		{
+			m_bvh.clear();
+			m_lights.clear();
+			m_entityMgr = NULL;
+		}
+
+		void CCPUBaker::initScene(CEntityManager* entityMgr)
+		{
+			clearScene();
+
+			m_entityMgr = entityMgr;
+
+			for (int i = 0, n = entityMgr->getNumEntities(); i < n; i++)
+			{
+				CEntity* entity = entityMgr->getEntity(i);
+				if (entity == NULL || !entity->isAlive() || !entity->isVisible())
+					continue;
+
+				CRenderMeshData* renderer = GET_ENTITY_DATA(entity, CRenderMeshData);
+				CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+
+				// the skinned mesh is not baked, the same as the hemicube bake
+				if (renderer != NULL &&
+					transform != NULL &&
+					renderer->isVisible() &&
+					!renderer->isSkinnedMesh() &&
+					renderer->getMesh() != NULL)
+				{
+					CMesh* mesh = renderer->getMesh();
+					for (u32 j = 0, m = mesh->getMeshBufferCount(); j < m; j++)
+						addMeshBuffer(mesh->getMeshBuffer(j), transform->World);
+				}
+
+				CLightCullingData* lightData = GET_ENTITY_DATA(entity, CLightCullingData);
+				if (lightData != NULL && lightData->Light != NULL)
+				{
+					CLight* light = lightData->Light;
+					if (light->isEnable() && light->getGameObject()->isVisible())
+						addLight(light);
+				}
+			}
+
+			buildScene();
+		}
+
+		void CCPUBaker::addMeshBuffer(IMeshBuffer* mb, const core::matrix4& transform)
+		{
+			if (mb == NULL ||
+				mb->getVertexBufferCount() == 0 ||
+				mb->getPrimitiveType() != scene::EPT_TRIANGLES)
+				return;
+
+			IVertexBuffer* vb = mb->getVertexBuffer(0);
+			IIndexBuffer* ib = mb->getIndexBuffer();
+
+			// all vertex types begin with S3DVertex
+			u32 stride = vb->getVertexSize();
+			if (ib == NULL || stride < sizeof(video::S3DVertex))
+				return;
+
+			u8* vertices = (u8*)vb->getVertices();
+			u32 numVertex = vb->getVertexCount();
+			f32 c = 1.0f / (255.0f * 3.0f);
+
+			for (u32 i = 0, n = ib->getIndexCount() / 3 * 3; i < n; i += 3)
+			{
+				core::vector3df p[3];
+				core::vector3df albedo;
+				bool valid = true;
+
+				for (int k = 0; k < 3; k++)
+				{
+					u32 id = ib->getIndex(i + k);
+					if (id >= numVertex)
+					{
+						valid = false;
+						break;
+					}
+
+					video::S3DVertex* v = (video::S3DVertex*)(vertices + id * stride);
+					p[k] = v->Pos;
+					transform.transformVect(p[k]);
+
+					albedo.X += v->Color.getRed() * c;
+					albedo.Y += v->Color.getGreen() * c;
+					albedo.Z += v->Color.getBlue() * c;
+				}
+
+				if (valid)
+					m_bvh.addTriangle(p[0], p[1], p[2], albedo);
+			}
+		}
+
+		void CCPUBaker::addTriangle(const core::vector3df& a, const core::vector3df& b, const core::vector3df& c, const core::vector3df& albedo)
+		{
+			m_bvh.addTriangle(a, b, c, albedo);
+		}
+
+		void CCPUBaker::addLight(CLight* light)
+		{
+			SBakeLight bakeLight;
+
+			const SColorf& color = light->getColor();
+			f32 intensity = light->getIntensity();
+
+			bakeLight.Type = light->getLightTypeId();
+			bakeLight.Color.set(color.r * intensity, color.g * intensity, color.b * intensity);
+			bakeLight.Direction = light->getDirection();
+			bakeLight.Attenuation = light->getAttenuation();
+			bakeLight.Bounce = light->getBounce();
+
+			if (bakeLight.Type == CLight::PointLight || bakeLight.Type == CLight::SpotLight)
+			{
+				CPointLight* pointLight = dynamic_cast<CPointLight*>(light);
+				if (pointLight == NULL)
+					return;
+
+				bakeLight.Position = pointLight->getPosition();
+
+				// the same as the uniform SPOT_LIGHT_ATTENUATION
+				bakeLight.SpotCutoff = cosf(light->getSplotCutoff() * core::DEGTORAD * 0.5f);
+				bakeLight.SpotInnerCutoff = cosf(light->getSpotInnerCutof() * core::DEGTORAD * 0.5f);
+				bakeLight.SpotExponent = light->getSpotExponent();
+			}
+			else if (bakeLight.Type == CLight::AreaLight)
+			{
+				CAreaLight* areaLight = dynamic_cast<CAreaLight*>(light);
+				if (areaLight == NULL)
+					return;
+
+				const core::matrix4& world = areaLight->getWorldTransform();
+				bakeLight.Position = areaLight->getPosition();
+
+				// the same as the uniform AREA_LIGHT_SIZE
+				core::vector3df sx(areaLight->getSizeX() * 0.5f, 0.0f, 0.0f);
+				core::vector3df sy(0.0f, areaLight->getSizeY() * 0.5f, 0.0f);
+				world.rotateVect(sx);
+				world.rotateVect(sy);
+
+				bakeLight.SizeX = sx.getLength();
+				bakeLight.SizeY = sy.getLength();
+
+				bakeLight.DirX = sx;
+				bakeLight.DirX.normalize();
+				bakeLight.DirY = sy;
+				bakeLight.DirY.normalize();
+			}
+
+			m_lights.push_back(bakeLight);
+		}
+
+		void CCPUBaker::addLight(const SBakeLight& light)
+		{
+			m_lights.push_back(light);
+		}
+
+		void CCPUBaker::buildScene()
+		{
+			m_bvh.build();
+
+			char log[512];
+			sprintf(log, "[CCPUBaker] Build scene: %d triangles, %d nodes, %d lights",
+				m_bvh.getTriangleCount(),
+				m_bvh.getNodeCount(),
+				m_lights.size());
+			os::Printer::log(log);
+		}
+
+		core::vector3df CCPUBaker::getDirectLight(const core::vector3df& position, const core::vector3df& normal, u32 depth, SBakeRandom& random, u32& numRay)
+		{
+			core::vector3df result;
+			core::vector3df origin = position + normal * m_bias;
+
+			for (u32 i = 0, n = m_lights.size(); i < n; i++)
+			{
+				const SBakeLight& light = m_lights[i];
+				if (depth >= light.Bounce)
+					continue;
+
+				if (light.Type == CLight::DirectionalLight)
+				{
+					core::vector3df lightDir = -light.Direction;
+
+					f32 NdotL = normal.dotProduct(lightDir);
+					if (NdotL <= 0.0f)
+						continue;
+
+					numRay++;
+					if (!m_bvh.occluded(origin, lightDir, FLT_MAX))
+						result += light.Color * NdotL;
+				}
+				else if (light.Type == CLight::PointLight || light.Type == CLight::SpotLight)
+				{
+					core::vector3df lightDir = light.Position - position;
+					f32 distance = lightDir.getLength();
+					if (distance < 1e-6f)
+						continue;
+
+					lightDir /= distance;
+
+					f32 NdotL = normal.dotProduct(lightDir);
+					f32 attenuation = core::max_(0.0f, 1.0f - distance * light.Attenuation);
+
+					if (light.Type == CLight::SpotLight)
+					{
+						f32 spotDot = lightDir.dotProduct(-light.Direction);
+						if (spotDot < light.SpotCutoff)
+							continue;
+
+						attenuation *= powf(bakeSmoothStep(light.SpotCutoff, light.SpotInnerCutoff, spotDot), light.SpotExponent);
+					}
+
+					if (NdotL <= 0.0f || attenuation <= 0.0f)
+						continue;
+
+					numRay++;
+					if (!m_bvh.occluded(origin, lightDir, distance - m_bias))
+						result += light.Color * (NdotL * attenuation);
+				}
+				else if (light.Type == CLight::AreaLight)
+				{
+					// a random point on the rectangle, it converges by the passes
+					f32 u = random.nextFloat() * 2.0f - 1.0f;
+					f32 v = random.nextFloat() * 2.0f - 1.0f;
+
+					core::vector3df point = light.Position + light.DirX * (light.SizeX * u) + light.DirY * (light.SizeY * v);
+					core::vector3df lightDir = point - position;
+
+					f32 distanceSQ = lightDir.getLengthSQ();
+					if (distanceSQ < 1e-12f)
+						continue;
+
+					f32 distance = sqrtf(distanceSQ);
+					lightDir /= distance;
+
+					// the light shines to DirX x DirY, the same as the shader
+					core::vector3df emit = light.DirX.crossProduct(light.DirY);
+
+					f32 NdotL = normal.dotProduct(lightDir);
+					f32 cosLight = -emit.dotProduct(lightDir);
+					if (NdotL <= 0.0f || cosLight <= 0.0f)
+						continue;
+
+					// the form factor of the rectangle
+					f32 area = 4.0f * light.SizeX * light.SizeY;
+					f32 formFactor = NdotL * cosLight * area / (core::PI * distanceSQ);
+
+					numRay++;
+					if (!m_bvh.occluded(origin, lightDir, distance - m_bias))
+						result += light.Color * core::min_(formFactor, 1.0f);
+				}
+			}
+
+			return result;
+		}
+
+		core::vector3df CCPUBaker::traceRadiance(const core::vector3df& origin, const core::vector3df& dir, SBakeRandom& random, u32& numRay)
+		{
+			core::vector3df result;
+			core::vector3df throughput(1.0f, 1.0f, 1.0f);
+
+			core::vector3df rayOrigin = origin;
+			core::vector3df rayDir = dir;
+
+			for (u32 depth = 0; ; depth++)
+			{
+				SBakeHit hit;
+
+				numRay++;
+				if (!m_bvh.intersect(rayOrigin, rayDir, FLT_MAX, hit))
+				{
+					result += throughput * m_skyColor;
+					break;
+				}
+
+				const SBakeTriangle& tri = m_bvh.getTriangle(hit.Triangle);
+
+				core::vector3df position = rayOrigin + rayDir * hit.T;
+
+				// both faces are lit, the hemicube renders with no backface culling
+				core::vector3df normal = tri.Normal;
+				if (normal.dotProduct(rayDir) > 0.0f)
+					normal = -normal;
+
+				// lambert: the radiance is albedo * (direct + the cosine weighted incoming radiance)
+				throughput *= tri.Albedo;
+				result += throughput * getDirectLight(position, normal, depth, random, numRay);
+
+				if (depth >= m_numBounce || throughput.getLengthSQ() < 1e-8f)
+					break;
+
+				// next bounce on the cosine weighted hemisphere
+				f32 u1 = random.nextFloat();
+				f32 u2 = random.nextFloat();
+				f32 r = sqrtf(u1);
+				f32 phi = 2.0f * core::PI * u2;
+
+				core::vector3df tangent, binormal;
+				getBakeBasis(normal, tangent, binormal);
+
+				rayDir = tangent * (r * cosf(phi)) + binormal * (r * sinf(phi)) + normal * sqrtf(core::max_(0.0f, 1.0f - u1));
+				rayDir.normalize();
+
+				rayOrigin = position + normal * m_bias;
+			}
+
+			return result;
+		}
+
+		void CCPUBaker::begin(const core::vector3df* position, const core::vector3df* normal, int count, int numFace)
+		{
+			m_positions.set_used(0);
+			m_normals.set_used(0);
+
+			for (int i = 0; i < count; i++)
+			{
+				m_positions.push_back(position[i]);
+
+				core::vector3df n = normal[i];
+				n.normalize();
+				m_normals.push_back(n);
+			}
+
+			m_sum.set_used(count);
+			m_sh.set_used(count);
+
+			for (int i = 0; i < count; i++)
+			{
+				m_sum[i].zero();
+				m_sh[i].zero();
+			}
+
+			m_sphere = numFace >= NUM_FACES;
+			m_currentPass = 0;
+			m_numRay = 0;
+		}
+
+		void CCPUBaker::bakeTarget(u32 id, u32 pass, u32& numRay)
+		{
+			const core::vector3df& position = m_positions[id];
+			const core::vector3df& normal = m_normals[id];
+
+			// the seed is from the position & the pass, so the result does not depend on the batch & the thread
+			u32 seed = SBakeRandom::hash(m_seed + pass * 0x9e3779b9u);
+			const f32* values[] = { &position.X, &position.Y, &position.Z, &normal.X, &normal.Y, &normal.Z };
+			for (int i = 0; i < 6; i++)
+			{
+				u32 bits;
+				memcpy(&bits, values[i], sizeof(u32));
+				seed = SBakeRandom::hash(seed ^ bits);
+			}
+
+			SBakeRandom random(seed);
+
+			core::vector3df tangent, binormal;
+			getBakeBasis(normal, tangent, binormal);
+
+			core::vector3df origin = position;
+			if (!m_sphere)
+				origin += normal * m_bias;
+
+			// the stratified samples on a grid k * k
+			u32 k = (u32)ceilf(sqrtf((f32)m_numSample));
+			f32 invK = 1.0f / (f32)k;
+
+			CSH9& sum = m_sum[id];
+
+			for (u32 s = 0; s < m_numSample; s++)
+			{
+				u32 cell = s % (k * k);
+				f32 u1 = ((f32)(cell % k) + random.nextFloat()) * invK;
+				f32 u2 = ((f32)(cell / k) + random.nextFloat()) * invK;
+
+				f32 phi = 2.0f * core::PI * u2;
+				f32 z, r;
+
+				if (m_sphere)
+				{
+					// uniform on the sphere
+					z = 1.0f - 2.0f * u1;
+					r = sqrtf(core::max_(0.0f, 1.0f - z * z));
+				}
+				else
+				{
+					// uniform on the hemisphere
+					z = u1;
+					r = sqrtf(core::max_(0.0f, 1.0f - z * z));
+				}
+
+				core::vector3df dir = tangent * (r * cosf(phi)) + binormal * (r * sinf(phi)) + normal * z;
+				dir.normalize();
+
+				core::vector3df radiance = traceRadiance(origin, dir, random, numRay);
+				sum.projectAddOntoSH(dir, radiance);
+			}
+		}
+
+		void CCPUBaker::refine()
+		{
+			u32 count = m_positions.size();
+			if (count == 0)
+				return;
+
+			u32 pass = m_currentPass;
+			std::atomic<u64> numRay(0);
+
+			System::CJobSystem::runParallelFor((int)count, 4, [this, pass, &numRay](int begin, int end)
+				{
+					u32 rays = 0;
+					for (int i = begin; i < end; i++)
+						bakeTarget((u32)i, pass, rays);
+					numRay.fetch_add(rays, std::memory_order_relaxed);
+				});
+
+			m_currentPass++;
+			m_numRay += numRay.load();
+
+			// the weight of a sample is the solid angle / the number of samples
+			// the light is compressed by 3.0, the same as the bake light shaders
+			f32 solidAngle = m_sphere ? 4.0f * core::PI : 2.0f * core::PI;
+			f32 weight = solidAngle / (f32)(m_currentPass * m_numSample) / 3.0f;
+
+			for (u32 i = 0; i < count; i++)
+				m_sh[i] = m_sum[i] * weight;
+		}
+
+		void CCPUBaker::bake(const core::vector3df* position, const core::vector3df* normal, int count, int numFace)
+		{
+			begin(position, normal, count, numFace);
+
+			for (u32 i = 0; i < m_numPass; i++)
+				refine();
+		}
+	}
+}
@@ -0,0 +1,309 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CSH9.h"
+#include "CBakeBVH.h"
+#include "Entity/CEntityManager.h"
+#include "Lighting/CLight.h"
+
+namespace Skylicht
+{
+	namespace Lightmapper
+	{
+		/// @brief The light parameters that the CPU baker uses, they are copied from CLight
+		struct SBakeLight
+		{
+			// CLight::ELightType
+			int Type;
+
+			core::vector3df Position;
+
+			// the direction that the light goes
+			core::vector3df Direction;
+
+			// color * intensity
+			core::vector3df Color;
+
+			// 1 / radius
+			f32 Attenuation;
+
+			// the cosine of the half angles
+			f32 SpotCutoff;
+			f32 SpotInnerCutoff;
+			f32 SpotExponent;
+
+			// the area light: the axis & the half sizes
+			core::vector3df DirX;
+			core::vector3df DirY;
+			f32 SizeX;
+			f32 SizeY;
+
+			// the light is added on the hits that have the depth < Bounce
+			u32 Bounce;
+
+			SBakeLight() :
+				Type(CLight::DirectionalLight),
+				Direction(0.0f, -1.0f, 0.0f),
+				Color(1.0f, 1.0f, 1.0f),
+				Attenuation(0.0f),
+				SpotCutoff(0.0f),
+				SpotInnerCutoff(1.0f),
+				SpotExponent(1.0f),
+				DirX(1.0f, 0.0f, 0.0f),
+				DirY(0.0f, 1.0f, 0.0f),
+				SizeX(0.5f),
+				SizeY(0.5f),
+				Bounce(1)
+			{
+			}
+		};
+
+		/// @brief The random number generator of the bake samples, it is seeded by the baked position so the result does not depend on the threads.
+		struct SBakeRandom
+		{
+			u32 State;
+
+			SBakeRandom(u32 seed)
+			{
+				State = hash(seed);
+				if (State == 0)
+					State = 0x9e3779b9;
+			}
+
+			static inline u32 hash(u32 x)
+			{
+				x ^= x >> 16;
+				x *= 0x7feb352d;
+				x ^= x >> 15;
+				x *= 0x846ca68b;
+				x ^= x >> 16;
+				return x;
+			}
+
+			inline u32 next()
+			{
+				// xorshift32
+				State ^= State << 13;
+				State ^= State >> 17;
+				State ^= State << 5;
+				return State;
+			}
+
+			// [0, 1)
+			inline f32 nextFloat()
+			{
+				return (next() >> 8) * (1.0f / 16777216.0f);
+			}
+		};
+
+		/// @brief The baker that path traces the scene triangles on the CPU, it does not need the GPU (CBaker, CMTBaker, CGPUBaker render the hemicube).
+		///
+		/// The triangles of CRenderMeshData and the lights are copied to a CBakeBVH by initScene.
+		/// The bake runs in the passes: each pass adds getNumSample() samples to all positions on the job system,
+		/// so the result is refined progressively and it is the same on any number of threads.
+		///
+		/// @code
+		/// CCPUBaker* baker = CLightmapper::getInstance()->getCPUBaker();
+		/// baker->initScene(entityMgr);
+		/// baker->begin(positions, normals, count, NUM_FACES);
+		/// while (baker->getNumPass() < 8)
+		/// {
+		///		baker->refine();
+		///		const CSH9& sh = baker->getSH(0);
+		///		...
+		/// }
+		/// @endcode
+		class CCPUBaker
+		{
+		protected:
+			CBakeBVH m_bvh;
+
+			core::array<SBakeLight> m_lights;
+
+			CEntityManager* m_entityMgr;
+
+			core::vector3df m_skyColor;
+
+			u32 m_numSample;
+			u32 m_numPass;
+			u32 m_numBounce;
+			u32 m_seed;
+
+			f32 m_bias;
+
+			// the positions that is baking
+			core::array<core::vector3df> m_positions;
+			core::array<core::vector3df> m_normals;
+			core::array<CSH9> m_sum;
+			core::array<CSH9> m_sh;
+
+			bool m_sphere;
+			u32 m_currentPass;
+
+			u64 m_numRay;
+
+		public:
+			CCPUBaker();
+
+			virtual ~CCPUBaker();
+
+			/// @brief Copy the triangles & the lights of the entities, and build the BVH.
+			/// The skinned meshes are skipped, call it again when the scene is changed.
+			void initScene(CEntityManager* entityMgr);
+
+			void clearScene();
+
+			/// @brief Add the triangles of a mesh buffer, the albedo is the vertex color. Call buildScene after add.
+			void addMeshBuffer(IMeshBuffer* mb, const core::matrix4& transform);
+
+			void addTriangle(const core::vector3df& a, const core::vector3df& b, const core::vector3df& c, const core::vector3df& albedo);
+
+			void addLight(CLight* light);
+
+			void addLight(const SBakeLight& light);
+
+			void buildScene();
+
+			inline CEntityManager* getSceneEntityManager()
+			{
+				return m_entityMgr;
+			}
+
+			inline CBakeBVH* getBVH()
+			{
+				return &m_bvh;
+			}
+
+			inline u32 getNumLight()
+			{
+				return m_lights.size();
+			}
+
+			/// @brief Start to bake the positions, numFace = NUM_FACES bakes the sphere (the light probe), else the hemisphere on the normal (the lightmap texel).
+			void begin(const core::vector3df* position, const core::vector3df* normal, int count, int numFace);
+
+			/// @brief Add getNumSample() samples to all positions.
+			void refine();
+
+			/// @brief begin & refine getNumPass() times.
+			void bake(const core::vector3df* position, const core::vector3df* normal, int count, int numFace);
+
+			inline const CSH9& getSH(int i)
+			{
+				return m_sh[i];
+			}
+
+			inline u32 getNumTarget()
+			{
+				return m_positions.size();
+			}
+
+			inline u32 getCurrentPass()
+			{
+				return m_currentPass;
+			}
+
+			/// @brief The number of rays (the path segments & the shadow rays) that traced.
+			inline u64 getNumRay()
+			{
+				return m_numRay;
+			}
+
+			inline void setNumSample(u32 n)
+			{
+				m_numSample = core::max_(n, 1u);
+			}
+
+			inline u32 getNumSample()
+			{
+				return m_numSample;
+			}
+
+			inline void setNumPass(u32 n)
+			{
+				m_numPass = core::max_(n, 1u);
+			}
+
+			inline u32 getNumPass()
+			{
+				return m_numPass;
+			}
+
+			/// @brief The number of the indirect bounces after the first hit.
+			inline void setNumBounce(u32 n)
+			{
+				m_numBounce = n;
+			}
+
+			inline u32 getNumBounce()
+			{
+				return m_numBounce;
+			}
+
+			inline void setSeed(u32 seed)
+			{
+				m_seed = seed;
+			}
+
+			inline u32 getSeed()
+			{
+				return m_seed;
+			}
+
+			/// @brief The radiance of the rays that do not hit the scene.
+			inline void setSkyColor(const core::vector3df& color)
+			{
+				m_skyColor = color;
+			}
+
+			inline const core::vector3df& getSkyColor()
+			{
+				return m_skyColor;
+			}
+
+			/// @brief The offset of the ray origin from the surface.
+			inline void setBias(f32 bias)
+			{
+				m_bias = bias;
+			}
+
+			inline f32 getBias()
+			{
+				return m_bias;
+			}
+
+			/// @brief The radiance that comes to the origin from the direction.
+			core::vector3df traceRadiance(const core::vector3df& origin, const core::vector3df& dir, SBakeRandom& random, u32& numRay);
+
+			/// @brief The direct light on a surface, the shadow rays test the BVH.
+			core::vector3df getDirectLight(const core::vector3df& position, const core::vector3df& normal, u32 depth, SBakeRandom& random, u32& numRay);
+
+		protected:
+
+			void bakeTarget(u32 id, u32 pass, u32& numRay);
+		};
+	}
+}
@@ -38,7 +38,9 @@ namespace Skylicht
 		CLightmapper::CLightmapper() :
 			m_singleBaker(NULL),
 			m_multiBaker(NULL),
-			m_gpuBaker(NULL)
+			m_gpuBaker(NULL),
+			m_cpuBaker(NULL),
+			m_bakerType(HemicubeBaker)
 		{
 
 		}
@@ -67,6 +69,19 @@ namespace Skylicht
 				delete m_gpuBaker;
 				m_gpuBaker = NULL;
 			}
+
+			if (m_cpuBaker != NULL)
+			{
+				delete m_cpuBaker;
+				m_cpuBaker = NULL;
+			}
+		}
+
+		CCPUBaker* CLightmapper::getCPUBaker()
+		{
+			if (m_cpuBaker == NULL)
+				m_cpuBaker = new CCPUBaker();
+			return m_cpuBaker;
 		}
 
 		void CLightmapper::initBaker(u32 hemisphereBakeSize)
@@ -102,6 +117,17 @@ namespace Skylicht
 			const core::vector3df& binormal,
 			int numFace)
 		{
+			if (m_bakerType == CPUBaker)
+			{
+				CCPUBaker* baker = getCPUBaker();
+				if (baker->getSceneEntityManager() != entityMgr)
+					baker->initScene(entityMgr);
+
+				baker->bake(&position, &normal, 1, numFace);
+				m_temp = baker->getSH(0);
+				return m_temp;
+			}
+
 			if (m_singleBaker == NULL)
 			{
 				os::Printer::log("[CLightmapper::bakeAtPosition] Need call initBaker first");
@@ -123,6 +149,20 @@ namespace Skylicht
 		{
 			out.clear();
 
+			if (m_bakerType == CPUBaker)
+			{
+				CCPUBaker* baker = getCPUBaker();
+				if (baker->getSceneEntityManager() != entityMgr)
+					baker->initScene(entityMgr);
+
+				// the baker splits the positions on the job system
+				baker->bake(position, normal, count, numFace);
+
+				for (int i = 0; i < count; i++)
+					out.push_back(baker->getSH(i));
+				return;
+			}
+
 			if (m_multiBaker == NULL)
 			{
 				os::Printer::log("[CLightmapper::bakeAtPosition] Need call initBaker first");
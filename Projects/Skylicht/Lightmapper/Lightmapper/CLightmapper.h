@@ -28,6 +28,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CBaker.h"
 #include "CMTBaker.h"
 #include "CGPUBaker.h"
+#include "CCPUBaker.h"
 #include "LightProbes/CLightProbe.h"
 
 namespace Skylicht
@@ -40,10 +41,21 @@ namespace Skylicht
 		public:
 			DECLARE_SINGLETON(CLightmapper)
 
+			enum EBakerType
+			{
+				// render the hemicube faces (CBaker, CMTBaker, CGPUBaker), it needs the GPU
+				HemicubeBaker = 0,
+				// path trace on the CPU (CCPUBaker)
+				CPUBaker
+			};
+
 		protected:
 			CBaker* m_singleBaker;
 			CMTBaker* m_multiBaker;
 			CGPUBaker* m_gpuBaker;
+			CCPUBaker* m_cpuBaker;
+
+			EBakerType m_bakerType;
 
 			CSH9 m_temp;
 
@@ -56,6 +68,21 @@ namespace Skylicht
 
 			void release();
 
+			/// @brief Select the baker of bakeAtPosition & bakeProbes.
+			/// The CPUBaker does not need initBaker, the camera & the render pipeline, it builds the scene of the entity manager on the first bake.
+			inline void setBakerType(EBakerType type)
+			{
+				m_bakerType = type;
+			}
+
+			inline EBakerType getBakerType()
+			{
+				return m_bakerType;
+			}
+
+			/// @brief The CPU baker, use it to set the samples & bounces, or to rebuild the scene (initScene) when it is changed.
+			CCPUBaker* getCPUBaker();
+
 			const CSH9& bakeAtPosition(
 				CCamera* camera, IRenderPipeline* rp, CEntityManager* entityMgr,
 				const core::vector3df& position,
@@ -0,0 +1,290 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "stdafx.h"
+#include "CJobSystem.h"
+
+#include <thread>
+#include <algorithm>
+
+namespace Skylicht
+{
+	namespace System
+	{
+		CJobSystem* g_jobSystem = NULL;
+
+		thread_local int g_jobThreadIndex = 0;
+
+		CJobSystem* CJobSystem::createGetInstance(int numWorkers)
+		{
+			if (g_jobSystem == NULL)
+				g_jobSystem = new CJobSystem(numWorkers);
+			return g_jobSystem;
+		}
+
+		CJobSystem* CJobSystem::getInstance()
+		{
+			return g_jobSystem;
+		}
+
+		void CJobSystem::releaseInstance()
+		{
+			if (g_jobSystem != NULL)
+			{
+				delete g_jobSystem;
+				g_jobSystem = NULL;
+			}
+		}
+
+		int CJobSystem::getThreadIndex()
+		{
+			return g_jobThreadIndex;
+		}
+
+		void CJobSystem::CWorker::runThread()
+		{
+			g_jobThreadIndex = ThreadIndex;
+			Started = true;
+		}
+
+		void CJobSystem::CWorker::updateThread()
+		{
+			if (JobSystem->m_shutdown)
+				return;
+
+			if (!JobSystem->executeJob(ThreadIndex))
+				JobSystem->sleepWorker();
+		}
+
+		CJobSystem::CJobSystem(int numWorkers) :
+			m_pendingJobs(0),
+			m_shutdown(false)
+		{
+			if (numWorkers < 0)
+			{
+				int numCores = (int)std::thread::hardware_concurrency();
+				numWorkers = numCores > 1 ? numCores - 1 : 0;
+			}
+
+			// main thread queue
+			m_queues.push_back(new SJobQueue());
+
+			// the queues must be created before the workers run, because the workers steal the jobs on all queues
+			for (int i = 0; i < numWorkers; i++)
+				m_queues.push_back(new SJobQueue());
+
+			for (int i = 0; i < numWorkers; i++)
+			{
+				CWorker* worker = new CWorker(this, i + 1);
+
+				IThread* thread = IThread::createThread(worker);
+				if (thread == NULL)
+				{
+					// no thread support, all jobs run on the calling thread
+					delete worker;
+					break;
+				}
+
+				m_workers.push_back(worker);
+				m_threads.push_back(thread);
+			}
+
+			// wait the workers start the thread loop, so IThread::stop can join them
+			for (CWorker* worker : m_workers)
+			{
+				while (!worker->Started)
+					std::this_thread::yield();
+			}
+		}
+
+		CJobSystem::~CJobSystem()
+		{
+			m_shutdown = true;
+
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+				m_sleepCondition.notify_all();
+			}
+
+			for (IThread* thread : m_threads)
+			{
+				thread->stop();
+				delete thread;
+			}
+
+			for (CWorker* worker : m_workers)
+				delete worker;
+
+			for (SJobQueue* queue : m_queues)
+				delete queue;
+
+			m_threads.clear();
+			m_workers.clear();
+			m_queues.clear();
+		}
+
+		void CJobSystem::addJob(const JobFunc& func, CJobCounter* counter)
+		{
+			if (counter)
+				counter->add(1);
+
+			int threadIndex = g_jobThreadIndex;
+			if (threadIndex >= (int)m_queues.size())
+				threadIndex = 0;
+
+			SJobQueue* queue = m_queues[threadIndex];
+			{
+				std::lock_guard<std::mutex> lock(queue->Mutex);
+				queue->Jobs.push_back(SJob{ func, counter });
+			}
+
+			m_pendingJobs.fetch_add(1, std::memory_order_release);
+
+			if (m_workers.size() > 0)
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+				m_sleepCondition.notify_one();
+			}
+		}
+
+		void CJobSystem::wait(CJobCounter* counter)
+		{
+			int threadIndex = g_jobThreadIndex;
+			if (threadIndex >= (int)m_queues.size())
+				threadIndex = 0;
+
+			// help execute the jobs while waiting
+			while (!counter->isDone())
+			{
+				if (!executeJob(threadIndex))
+					std::this_thread::yield();
+			}
+		}
+
+		void CJobSystem::parallelFor(int count, int grainSize, const RangeFunc& func)
+		{
+			if (count <= 0)
+				return;
+
+			if (grainSize < 1)
+				grainSize = 1;
+
+			int numThreads = getNumThreads();
+			if (numThreads <= 1 || count <= grainSize)
+			{
+				func(0, count);
+				return;
+			}
+
+			// split more ranges than threads, so a fast thread can steal the remain ranges
+			int numRanges = numThreads * 4;
+			int rangeSize = (count + numRanges - 1) / numRanges;
+			if (rangeSize < grainSize)
+				rangeSize = grainSize;
+
+			CJobCounter counter;
+
+			for (int begin = rangeSize; begin < count; begin += rangeSize)
+			{
+				int end = std::min(begin + rangeSize, count);
+				addJob([&func, begin, end]() { func(begin, end); }, &counter);
+			}
+
+			// the calling thread run the first range
+			func(0, std::min(rangeSize, count));
+
+			wait(&counter);
+		}
+
+		void CJobSystem::runParallelFor(int count, int grainSize, const RangeFunc& func)
+		{
+			if (g_jobSystem != NULL)
+				g_jobSystem->parallelFor(count, grainSize, func);
+			else if (count > 0)
+				func(0, count);
+		}
+
+		bool CJobSystem::executeJob(int threadIndex)
+		{
+			SJob job;
+
+			if (!popJob(threadIndex, job) && !stealJob(threadIndex, job))
+				return false;
+
+			m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+			job.Func();
+
+			if (job.Counter)
+				job.Counter->done();
+
+			return true;
+		}
+
+		bool CJobSystem::popJob(int threadIndex, SJob& job)
+		{
+			SJobQueue* queue = m_queues[threadIndex];
+
+			std::lock_guard<std::mutex> lock(queue->Mutex);
+			if (queue->Jobs.empty())
+				return false;
+
+			// newest job, the data still hot in the cache
+			job = std::move(queue->Jobs.back());
+			queue->Jobs.pop_back();
+			return true;
+		}
+
+		bool CJobSystem::stealJob(int threadIndex, SJob& job)
+		{
+			int numQueue = (int)m_queues.size();
+
+			for (int i = 1; i < numQueue; i++)
+			{
+				SJobQueue* queue = m_queues[(threadIndex + i) % numQueue];
+
+				std::lock_guard<std::mutex> lock(queue->Mutex);
+				if (queue->Jobs.empty())
+					continue;
+
+				// oldest job, that is usually the biggest job
+				job = std::move(queue->Jobs.front());
+				queue->Jobs.pop_front();
+				return true;
+			}
+
+			return false;
+		}
+
+		void CJobSystem::sleepWorker()
+		{
+			// addJob & the destructor notify under m_sleepMutex, so the wake-up is not lost
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [this]()
+				{
+					return m_pendingJobs.load(std::memory_order_acquire) > 0 || m_shutdown;
+				});
+		}
+	}
+}
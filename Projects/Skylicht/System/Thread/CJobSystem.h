@@ -0,0 +1,178 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "SkylichtSystemAPI.h"
+#include "IThread.h"
+
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace Skylicht
+{
+	namespace System
+	{
+		class CJobSystem;
+
+		/// @brief Count the number of unfinished jobs, use CJobSystem::wait to wait them done.
+		class SYSTEM_SHARED_API CJobCounter
+		{
+		protected:
+			std::atomic<int> m_count;
+
+		public:
+			CJobCounter() :
+				m_count(0)
+			{
+			}
+
+			inline void add(int n)
+			{
+				m_count.fetch_add(n, std::memory_order_relaxed);
+			}
+
+			inline void done()
+			{
+				m_count.fetch_sub(1, std::memory_order_acq_rel);
+			}
+
+			inline bool isDone()
+			{
+				return m_count.load(std::memory_order_acquire) <= 0;
+			}
+		};
+
+		/// @brief Work-stealing job scheduler.
+		///
+		/// Each thread owns a job queue. A thread pushes/pops the newest job at the back of its own queue,
+		/// an idle thread steals the oldest job at the front of the other queues.
+		/// The thread that waits a CJobCounter also executes jobs, so a job can call parallelFor or wait another job.
+		///
+		/// @code
+		/// CJobSystem::getInstance()->parallelFor(numEntity, 256, [&](int begin, int end)
+		/// {
+		///		for (int i = begin; i < end; i++)
+		///			updateEntity(entities[i]);
+		/// });
+		/// @endcode
+		class SYSTEM_SHARED_API CJobSystem
+		{
+		public:
+			typedef std::function<void()> JobFunc;
+			typedef std::function<void(int, int)> RangeFunc;
+
+		protected:
+			struct SJob
+			{
+				JobFunc Func;
+				CJobCounter* Counter;
+			};
+
+			struct SJobQueue
+			{
+				std::mutex Mutex;
+				std::deque<SJob> Jobs;
+			};
+
+			class CWorker : public IThreadCallback
+			{
+			public:
+				CJobSystem* JobSystem;
+				int ThreadIndex;
+				std::atomic<bool> Started;
+
+				CWorker(CJobSystem* jobSystem, int threadIndex) :
+					JobSystem(jobSystem),
+					ThreadIndex(threadIndex),
+					Started(false)
+				{
+				}
+
+				virtual void runThread();
+
+				virtual void updateThread();
+			};
+
+			// queue 0 is used by main thread (and the threads that is not a worker)
+			std::vector<SJobQueue*> m_queues;
+
+			std::vector<CWorker*> m_workers;
+			std::vector<IThread*> m_threads;
+
+			std::atomic<int> m_pendingJobs;
+			std::atomic<bool> m_shutdown;
+
+			std::mutex m_sleepMutex;
+			std::condition_variable m_sleepCondition;
+
+		public:
+			static CJobSystem* createGetInstance(int numWorkers = -1);
+
+			static CJobSystem* getInstance();
+
+			static void releaseInstance();
+
+			CJobSystem(int numWorkers = -1);
+
+			virtual ~CJobSystem();
+
+			/// @brief Number of threads that execute jobs (workers + the calling thread)
+			inline int getNumThreads()
+			{
+				return (int)m_workers.size() + 1;
+			}
+
+			inline int getNumWorkers()
+			{
+				return (int)m_workers.size();
+			}
+
+			static int getThreadIndex();
+
+			void addJob(const JobFunc& func, CJobCounter* counter);
+
+			void wait(CJobCounter* counter);
+
+			/// @brief Split [0, count) to ranges (size >= grainSize) and run func(begin, end) on all threads. It returns when all ranges are done.
+			void parallelFor(int count, int grainSize, const RangeFunc& func);
+
+			/// @brief parallelFor on the shared instance, or run func(0, count) on the calling thread if the instance is not created.
+			static void runParallelFor(int count, int grainSize, const RangeFunc& func);
+
+		protected:
+
+			bool executeJob(int threadIndex);
+
+			bool popJob(int threadIndex, SJob& job);
+
+			bool stealJob(int threadIndex, SJob& job);
+
+			void sleepWorker();
+		};
+	}
+}
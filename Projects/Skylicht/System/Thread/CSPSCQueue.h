@@ -0,0 +1,86 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include <atomic>
+
+namespace Skylicht
+{
+	namespace System
+	{
+		/// @brief The lock-free queue for 1 producer thread and 1 consumer thread.
+		///
+		/// push and pop never block, push returns false when the queue is full (it holds Capacity - 1 items).
+		template<class T, int Capacity>
+		class CSPSCQueue
+		{
+		protected:
+			T m_items[Capacity];
+
+			// the consumer reads at head, the producer writes at tail
+			std::atomic<int> m_head;
+			std::atomic<int> m_tail;
+
+		public:
+			CSPSCQueue() :
+				m_head(0),
+				m_tail(0)
+			{
+			}
+
+			/// @brief Call on the producer thread
+			bool push(const T& item)
+			{
+				int tail = m_tail.load(std::memory_order_relaxed);
+				int next = (tail + 1) % Capacity;
+
+				if (next == m_head.load(std::memory_order_acquire))
+					return false;
+
+				m_items[tail] = item;
+				m_tail.store(next, std::memory_order_release);
+				return true;
+			}
+
+			/// @brief Call on the consumer thread
+			bool pop(T& item)
+			{
+				int head = m_head.load(std::memory_order_relaxed);
+
+				if (head == m_tail.load(std::memory_order_acquire))
+					return false;
+
+				item = m_items[head];
+				m_head.store((head + 1) % Capacity, std::memory_order_release);
+				return true;
+			}
+
+			bool empty()
+			{
+				return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+			}
+		};
+	}
+}
@@ -0,0 +1,132 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "stdafx.h"
+#include "CTaskGraph.h"
+
+#include <algorithm>
+
+namespace Skylicht
+{
+	namespace System
+	{
+		CTaskGraph::CTaskGraph()
+		{
+
+		}
+
+		CTaskGraph::~CTaskGraph()
+		{
+			clear();
+		}
+
+		int CTaskGraph::addTask(const CJobSystem::JobFunc& func)
+		{
+			STask* task = new STask();
+			task->Func = func;
+			task->NumDependencies = 0;
+			task->Remain = 0;
+
+			m_tasks.push_back(task);
+			return (int)m_tasks.size() - 1;
+		}
+
+		void CTaskGraph::addDependency(int task, int dependentTask)
+		{
+			std::vector<int>& successors = m_tasks[task]->Successors;
+			if (std::find(successors.begin(), successors.end(), dependentTask) != successors.end())
+				return;
+
+			successors.push_back(dependentTask);
+			m_tasks[dependentTask]->NumDependencies++;
+		}
+
+		void CTaskGraph::clear()
+		{
+			for (STask* task : m_tasks)
+				delete task;
+			m_tasks.clear();
+		}
+
+		void CTaskGraph::run(CJobSystem* jobSystem)
+		{
+			int numTasks = (int)m_tasks.size();
+			if (numTasks == 0)
+				return;
+
+			if (jobSystem == NULL || jobSystem->getNumWorkers() == 0)
+			{
+				// no worker: run tasks in the order of dependencies
+				std::vector<int> queue;
+				for (int i = 0; i < numTasks; i++)
+				{
+					m_tasks[i]->Remain = m_tasks[i]->NumDependencies;
+					if (m_tasks[i]->NumDependencies == 0)
+						queue.push_back(i);
+				}
+
+				for (size_t i = 0; i < queue.size(); i++)
+				{
+					STask* task = m_tasks[queue[i]];
+					task->Func();
+
+					for (int s : task->Successors)
+					{
+						if (--m_tasks[s]->Remain == 0)
+							queue.push_back(s);
+					}
+				}
+				return;
+			}
+
+			for (STask* task : m_tasks)
+				task->Remain = task->NumDependencies;
+
+			CJobCounter counter;
+			counter.add(numTasks);
+
+			for (int i = 0; i < numTasks; i++)
+			{
+				if (m_tasks[i]->NumDependencies == 0)
+					jobSystem->addJob([this, jobSystem, i, &counter]() { runTask(jobSystem, i, &counter); }, NULL);
+			}
+
+			jobSystem->wait(&counter);
+		}
+
+		void CTaskGraph::runTask(CJobSystem* jobSystem, int taskId, CJobCounter* counter)
+		{
+			STask* task = m_tasks[taskId];
+			task->Func();
+
+			for (int s : task->Successors)
+			{
+				if (m_tasks[s]->Remain.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					jobSystem->addJob([this, jobSystem, s, counter]() { runTask(jobSystem, s, counter); }, NULL);
+			}
+
+			counter->done();
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2025 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "SkylichtSystemAPI.h"
+#include "CJobSystem.h"
+
+namespace Skylicht
+{
+	namespace System
+	{
+		/// @brief A list of tasks with dependencies, the tasks run on CJobSystem when all their dependencies are done.
+		///
+		/// @code
+		/// CTaskGraph graph;
+		/// int a = graph.addTask([]() { updateA(); });
+		/// int b = graph.addTask([]() { updateB(); });
+		/// int c = graph.addTask([]() { updateC(); });
+		/// // c wait a & b
+		/// graph.addDependency(a, c);
+		/// graph.addDependency(b, c);
+		/// graph.run(CJobSystem::getInstance());
+		/// @endcode
+		class SYSTEM_SHARED_API CTaskGraph
+		{
+		protected:
+			struct STask
+			{
+				CJobSystem::JobFunc Func;
+				std::vector<int> Successors;
+				int NumDependencies;
+				std::atomic<int> Remain;
+			};
+
+			std::vector<STask*> m_tasks;
+
+		public:
+			CTaskGraph();
+
+			virtual ~CTaskGraph();
+
+			int addTask(const CJobSystem::JobFunc& func);
+
+			void addDependency(int task, int dependentTask);
+
+			inline int getNumTasks()
+			{
+				return (int)m_tasks.size();
+			}
+
+			void clear();
+
+			/// @brief Run all tasks & wait them done. The graph can run again after this call.
+			void run(CJobSystem* jobSystem);
+
+		protected:
+
+			void runTask(CJobSystem* jobSystem, int task, CJobCounter* counter);
+		};
+	}
+}
@@ -16,7 +16,8 @@ namespace Skylicht
 			m_skip(NULL),
 			m_inMotion(false),
 			m_outMotion(false),
-			m_pointerDown(false)
+			m_pointerDown(false),
+			m_hitCanvasChanged(true)
 		{
 
 		}
@@ -111,6 +112,11 @@ namespace Skylicht
 		void CUIContainer::addChild(CUIBase* base)
 		{
 			m_arrayUIObjects.push_back(base);
+
+			if (base->getElement())
+				m_elementUIObjects.insert(std::make_pair(base->getElement(), base));
+
+			m_hitCanvasChanged = true;
 		}
 
 		bool CUIContainer::removeChild(CUIBase* base)
@@ -121,6 +127,18 @@ namespace Skylicht
 				if (*i == base)
 				{
 					m_arrayUIObjects.erase(i);
+
+					auto range = m_elementUIObjects.equal_range(base->getElement());
+					for (auto it = range.first; it != range.second; ++it)
+					{
+						if (it->second == base)
+						{
+							m_elementUIObjects.erase(it);
+							break;
+						}
+					}
+
+					m_hitCanvasChanged = true;
 					return true;
 				}
 				++i;
@@ -150,14 +168,27 @@ namespace Skylicht
 
 		CUIBase* CUIContainer::getChildByGUI(CGUIElement* element)
 		{
-			std::vector<CUIBase*>::iterator i = m_arrayUIObjects.begin(), end = m_arrayUIObjects.end();
-			while (i != end)
+			auto it = m_elementUIObjects.find(element);
+			if (it != m_elementUIObjects.end())
+				return it->second;
+			return NULL;
+		}
+
+		void CUIContainer::updateHitCanvas()
+		{
+			m_hitCanvas.clear();
+
+			for (CUIBase* base : m_arrayUIObjects)
 			{
-				if ((*i)->getElement() == element)
-					return *i;
-				++i;
+				if (base->getElement() == NULL)
+					continue;
+
+				CCanvas* canvas = base->getElement()->getCanvas();
+				if (std::find(m_hitCanvas.begin(), m_hitCanvas.end(), canvas) == m_hitCanvas.end())
+					m_hitCanvas.push_back(canvas);
 			}
-			return NULL;
+
+			m_hitCanvasChanged = false;
 		}
 
 		CUIBase* CUIContainer::OnProcessEvent(const SEvent& event)
@@ -169,13 +200,42 @@ namespace Skylicht
 			{
 				const core::recti& vp = getVideoDriver()->getViewPort();
 
-				core::vector3df p2d[4];
 				m_raycastUIObjects.clear();
 
 				f32 mouseX = (f32)event.MouseInput.X;
 				f32 mouseY = (f32)event.MouseInput.Y;
-				core::vector3df mousePos(mouseX, mouseY, 0.0f);
 
+				if (m_hitCanvasChanged)
+					updateHitCanvas();
+
+				// the elements under the pointer, from the canvas spatial index
+				for (CCanvas* canvas : m_hitCanvas)
+				{
+					CCamera* camera = canvas->getRenderCamera();
+					if (camera == NULL)
+						continue;
+
+					m_hitElements.clear();
+					canvas->getHitTestElements(camera, mouseX, mouseY, vp, m_hitElements);
+
+					for (CGUIElement* element : m_hitElements)
+					{
+						if (!element->isVisible())
+							continue;
+
+						auto range = m_elementUIObjects.equal_range(element);
+						for (auto it = range.first; it != range.second; ++it)
+						{
+							CUIBase* base = it->second;
+							if (!base->isEnable() || !base->isVisible() || base == m_skip)
+								continue;
+
+							m_raycastUIObjects.push_back(base);
+						}
+					}
+				}
+
+				// the pointer move is still sent to all ui objects (drag out of the rect)
 				for (CUIBase* base : m_arrayUIObjects)
 				{
 					if (base->getElement() == NULL)
@@ -190,34 +250,9 @@ namespace Skylicht
 					if (base == m_skip)
 						continue;
 
-					CCanvas* canvas = base->getElement()->getCanvas();
-					CCamera* camera = canvas->getRenderCamera();
-					if (camera == NULL)
+					if (base->getElement()->getCanvas()->getRenderCamera() == NULL)
 						continue;
 
-					core::vector3df* rectTransform = base->getRectTransform();
-
-					for (int i = 0; i < 4; i++)
-					{
-						// project to 2d screen
-						CProjective::getScreenCoordinatesFrom3DPosition(
-							camera, rectTransform[i],
-							p2d[i].X,
-							p2d[i].Y,
-							vp.getWidth(),
-							vp.getHeight());
-						p2d[i].Z = 0.0f;
-					}
-
-					// hit test in 3D - apply for 3D UI
-					core::triangle3df t1(p2d[0], p2d[1], p2d[2]);
-					core::triangle3df t2(p2d[2], p2d[1], p2d[3]);
-
-					if (t1.isPointInside(mousePos) == true || t2.isPointInside(mousePos) == true)
-					{
-						m_raycastUIObjects.push_back(base);
-					}
-
 					base->onPointerMove(mouseX, mouseY);
 				}
 
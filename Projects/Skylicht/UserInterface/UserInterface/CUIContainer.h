@@ -40,6 +40,13 @@ namespace Skylicht
 
 			std::vector<CUIBase*> m_arrayUIObjects;
 			std::vector<CUIBase*> m_raycastUIObjects;
+			std::vector<CGUIElement*> m_hitElements;
+
+			// the ui objects of an element, to map the hit elements of the canvas spatial index
+			std::multimap<CGUIElement*, CUIBase*> m_elementUIObjects;
+
+			// the canvases of the ui objects, it's rebuilt when the ui list changed
+			std::vector<CCanvas*> m_hitCanvas;
 
 			CUIBase* m_skip;
 			CUIBase* m_hover;
@@ -50,6 +57,8 @@ namespace Skylicht
 
 			bool m_pointerDown;
 
+			bool m_hitCanvasChanged;
+
 		public:
 
 			std::function<void()> OnMotionInFinish;
@@ -86,6 +95,12 @@ namespace Skylicht
 
 			void startOutMotion();
 
+		protected:
+
+			void updateHitCanvas();
+
+		public:
+
 			inline void setEnable(bool b)
 			{
 				m_enable = b;
@@ -30,6 +30,7 @@ CDemoNavMesh::CDemoNavMesh(CZone* zone) :
 	m_obstacle = new Graph::CObstacleAvoidance();
 	m_walkingTileMap = new Graph::CWalkingTileMap();
 	m_query = new Graph::CGraphQuery();
+	m_flowFields = new Graph::CFlowFieldCache(m_walkingTileMap);
 	m_navMesh = new CMesh();
 }
 
@@ -40,6 +41,7 @@ CDemoNavMesh::~CDemoNavMesh()
 	delete m_builder;
 	delete m_obstacle;
 	delete m_navMesh;
+	delete m_flowFields;
 	delete m_walkingTileMap;
 	delete m_query;
 }
@@ -75,6 +77,7 @@ void CDemoNavMesh::init()
 	m_toTile = NULL;
 	m_path.clear();
 
+	m_flowFields->clear();
 	m_walkingTileMap->release();
 	m_navMesh->removeAllMeshBuffer();
 	m_obstacle->clear();
@@ -264,6 +267,7 @@ void CDemoNavMesh::onGUI()
 	ImGui::Text("After build NavMesh");
 	ImGui::Text("- Left mouse to set Agent position");
 	ImGui::Text("- Right mouse to move Agent");
+	ImGui::Text("- Shift + Right mouse to move Agent by flow field");
 
 	if (ImGui::CollapsingHeader("Draw Debug"))
 	{
@@ -341,7 +345,13 @@ void CDemoNavMesh::onViewRayClick(const core::line3df& ray, int button, bool hol
 			moveAgent->setTargetPosition(m_clickPosition);
 		}
 
-		if (m_fromTile && m_toTile)
+		if (button != 0 && holdShift && m_toTile)
+		{
+			// the flow field is shared by all agents that go to this tile
+			m_path.clear();
+			moveAgent->setFlowField(m_flowFields->getFlowField(m_toTile), m_clickPosition);
+		}
+		else if (m_fromTile && m_toTile)
 		{
 			if (m_query->findPath(m_walkingTileMap, m_fromTile, m_toTile, m_path))
 			{
@@ -366,5 +376,6 @@ void CDemoNavMesh::buildWalkingMap()
 	CMoveAgent* moveAgent = m_agent->getComponent<CMoveAgent>();
 	moveAgent->clearPath();
 
+	m_flowFields->clear();
 	m_walkingTileMap->generate(m_tileWidth, m_tileHeight, m_navMesh, m_obstacle);
 }
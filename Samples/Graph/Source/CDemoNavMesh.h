@@ -6,6 +6,7 @@
 #include "RecastMesh/CRecastBuilder.h"
 #include "WalkingMap/CWalkingTileMap.h"
 #include "Graph/CGraphQuery.h"
+#include "FlowField/CFlowFieldCache.h"
 
 class CDemoNavMesh : public CDemo
 {
@@ -27,6 +28,7 @@ protected:
 	Graph::CWalkingTileMap* m_walkingTileMap;
 
 	Graph::CGraphQuery* m_query;
+	Graph::CFlowFieldCache* m_flowFields;
 
 	float m_tileWidth;
 	float m_tileHeight;
@@ -8,6 +8,7 @@
 CMoveAgent::CMoveAgent() :
 	m_obstacle(NULL),
 	m_graphQuery(NULL),
+	m_flowField(NULL),
 	m_agentRadius(0.5f)
 {
 	m_obstacle = new Graph::CObstacleAvoidance();
@@ -31,7 +32,12 @@ void CMoveAgent::updateComponent()
 	core::vector3df position = transform->getPosition() - heightOffset;
 	core::vector3df newPosition;
 
-	if (m_points.size() > 0)
+	if (m_flowField)
+	{
+		// go by flow field
+		newPosition = followFlowField(position);
+	}
+	else if (m_points.size() > 0)
 	{
 		// go by path
 		newPosition = folowPath();
@@ -106,6 +112,20 @@ void CMoveAgent::setPath(const core::array<Graph::STile*>& path, const core::vec
 	}
 }
 
+core::vector3df CMoveAgent::followFlowField(const core::vector3df& position)
+{
+	const float Speed = 4.0f;
+
+	core::vector3df direction;
+	if (!m_flowField->getDirection(position, direction) || direction.getLengthSQ() == 0.0f)
+	{
+		// on the goal tile (or out of the field), go straight
+		return CVector::lerp(position, m_targetPosition, 0.001f * getTimeStep());
+	}
+
+	return position + direction * (Speed * 0.001f * getTimeStep());
+}
+
 core::vector3df CMoveAgent::folowPath()
 {
 	// see Irrlicht source: CSceneNodeAnimatorFollowSpline::animateNode
@@ -3,12 +3,14 @@
 #include "Components/CComponentSystem.h"
 #include "ObstacleAvoidance/CObstacleAvoidance.h"
 #include "Graph/CGraphQuery.h"
+#include "FlowField/CFlowField.h"
 
 class CMoveAgent : public CComponentSystem
 {
 protected:
 	Graph::CObstacleAvoidance* m_obstacle;
 	Graph::CGraphQuery* m_graphQuery;
+	Graph::CFlowField* m_flowField;
 
 	core::array<core::vector3df> m_points;
 
@@ -58,15 +60,26 @@ public:
 
 	void setPath(const core::array<Graph::STile*>& path, const core::vector3df& target);
 
+	// the agent follows the flow field of the shared goal, instead of its path
+	inline void setFlowField(Graph::CFlowField* flowField, const core::vector3df& target)
+	{
+		clearPath();
+		m_flowField = flowField;
+		m_targetPosition = target;
+	}
+
 	inline void clearPath()
 	{
 		m_points.clear();
 		m_distance = 0.0f;
 		m_moveTime = 0.0f;
+		m_flowField = NULL;
 	}
 
 protected:
 
+	core::vector3df followFlowField(const core::vector3df& position);
+
 	core::vector3df folowPath();
 
 };
\ No newline at end of file
@@ -24,7 +24,7 @@ void CTargetProjectile::setTargetCollide(u32 index, const core::vector3df& pos,
 	}
 }
 
-void CTargetProjectile::OnParticleUpdate(Particle::CParticle *particles, int num, Particle::CGroup *group, float dt)
+void CTargetProjectile::OnParticleUpdate(Particle::CParticleData *particles, int num, Particle::CGroup *group, float dt)
 {
 	if (m_impactGroup == NULL)
 		return;
@@ -39,14 +39,14 @@ void CTargetProjectile::OnParticleUpdate(Particle::CParticle *particles, int num
 		if (c.HaveData == false)
 			continue;
 
-		Particle::CParticle &p = particles[i];
-		if (p.Position.getDistanceFromSQ(c.Position) < minLengthSQ)
+		core::vector3df position = particles->getVector(particles->Position, i);
+		if (position.getDistanceFromSQ(c.Position) < minLengthSQ)
 		{
 			// add impact particle
 			m_impactGroup->addParticle(0, c.Position, c.Normal);
 
 			// kill this particle
-			p.Life = -1.0f;
+			particles->Life[i] = -1.0f;
 		}
 	}
 }
@@ -31,7 +31,7 @@ public:
 		m_impactGroup = g;
 	}
 
-	virtual void OnParticleUpdate(Particle::CParticle *particles, int num, Particle::CGroup *group, float dt);
+	virtual void OnParticleUpdate(Particle::CParticleData *particles, int num, Particle::CGroup *group, float dt);
 
 	virtual void OnParticleBorn(Particle::CParticle &p);
 
@@ -9,6 +9,9 @@
 
 #define EPSILON    (1.0e-4)
 
+// the benchmark cases time and print the results, they only run with: TestApp --benchmark
+extern bool g_testBenchmark;
+
 #define TEST_CASE( name ) std::cout << (std::string(" - ") + std::string(name)) << std::endl;
 
 #define TEST_ASSERT_THROW( condition )                              \
@@ -1,6 +1,28 @@
 #include "CApp.h"
 #include "TestCoreUtils.h"
 #include "TestSystemThread.h"
+#include "TestJobSystem.h"
+#include "TestEntityDataStorage.h"
+#include "TestEntityGroup.h"
+#include "TestCullingBVH.h"
+#include "TestCullingKernel.h"
+#include "TestCullingViews.h"
+#include "TestWorldTransform.h"
+#include "TestParticleSystem.h"
+#include "TestSoftwareSkinning.h"
+#include "TestAnimationCompressor.h"
+#include "TestAudioMixer.h"
+#include "TestCollisionBVH.h"
+#include "TestGraphQuery.h"
+#include "TestDrawKey.h"
+#include "TestLightGrid.h"
+#include "TestShaderUniform.h"
+#include "TestSceneBinary.h"
+#include "TestGUIRenderCache.h"
+#include "TestGUICulling.h"
+#include "TestGlyphFont.h"
+#include "TestAtlasPacker.h"
+#include "TestCPUBaker.h"
 #include "TestScene.h"
 #include "TestMemoryStream.h"
 #include "TestSpreadsheet.h"
@@ -11,9 +33,16 @@
 #define TEST_UPDATE_LOOP_COUNT	100
 
 bool g_finalPass = false;
+bool g_testBenchmark = false;
 
 void installApplication(const std::vector<std::string>& argv)
 {
+	for (const std::string& arg : argv)
+	{
+		if (arg == "--benchmark")
+			g_testBenchmark = true;
+	}
+
 	CApp *mainTest = new CApp();
 	getApplication()->registerAppEvent("CApp", mainTest);
 }
@@ -54,6 +83,38 @@ void CApp::onInitApp()
 
 	testSystemThread();
 
+	testJobSystem();
+
+	testEntityDataStorage();
+
+	testEntityGroup();
+
+	testCullingBVH();
+
+	testCullingKernel();
+
+	testCullingViews();
+
+	testWorldTransform();
+
+	testParticleSystem();
+
+	testSoftwareSkinning();
+
+	testAnimationCompressor();
+	testAudioMixer();
+	testCollisionBVH();
+	testGraphQuery();
+	testDrawKey();
+	testLightGrid();
+	testShaderUniform();
+	testSceneBinary();
+	testGUIRenderCache();
+	testGUICulling();
+	testGlyphFont();
+	testAtlasPacker();
+	testCPUBaker();
+
 	testScene();
 
 	testSpreadsheet();
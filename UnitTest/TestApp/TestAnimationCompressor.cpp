@@ -0,0 +1,229 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestAnimationCompressor.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static CAnimationClip* createTestClip(int numTrack, float duration, float keyRate)
+{
+	CAnimationClip* clip = new CAnimationClip();
+	clip->AnimName = "test";
+	clip->Duration = duration;
+
+	int numKey = (int)(duration * keyRate) + 1;
+
+	for (int i = 0; i < numTrack; i++)
+	{
+		SEntityAnim* anim = new SEntityAnim();
+
+		char name[64];
+		sprintf(name, "bone%d", i);
+		anim->Name = name;
+
+		float phase = (float)i * 0.37f;
+		float speed = 1.0f + (float)(i % 5) * 0.5f;
+
+		for (int k = 0; k < numKey; k++)
+		{
+			float t = (float)k / keyRate;
+			float a = t * speed + phase;
+
+			CPositionKey position;
+			position.Frame = t;
+			position.Value.set(sinf(a) * 0.5f, (float)i * 0.1f + cosf(a) * 0.2f, 0.0f);
+			anim->Data.Positions.Data.push_back(position);
+
+			CRotationKey rotation;
+			rotation.Frame = t;
+			rotation.Value.fromAngleAxis(sinf(a) * core::PI * 0.5f, core::vector3df(0.3f, 1.0f, 0.2f).normalize());
+			anim->Data.Rotations.Data.push_back(rotation);
+
+			// the odd tracks have no scale key, they use the default
+			if (i % 2 == 0)
+			{
+				CScaleKey scale;
+				scale.Frame = t;
+				scale.Value.set(1.0f, 1.0f, 1.0f);
+				anim->Data.Scales.Data.push_back(scale);
+			}
+		}
+
+		anim->Data.Scales.Default.set(1.0f, 1.0f, 1.0f);
+
+		clip->addAnim(anim);
+	}
+
+	return clip;
+}
+
+void testAnimationCompressor()
+{
+	const int numTrack = 60;
+	const float duration = 2.0f;
+
+	CAnimationClip* clip = createTestClip(numTrack, duration, 30.0f);
+
+	TEST_CASE("Animation key index");
+	{
+		// the binary search must match the linear scan
+		CArrayKeyFrame<core::vector3df>& positions = clip->getAnimOfEntity(0)->Data.Positions;
+		CPositionKey* keys = positions.pointer();
+
+		for (int i = 0; i < 200; i++)
+		{
+			float frame = (float)(rand() % 2400) / 1000.0f - 0.1f;
+
+			int expected = -1;
+			for (u32 j = 0; j < positions.size(); j++)
+			{
+				if (keys[j].Frame >= frame)
+				{
+					expected = j;
+					break;
+				}
+			}
+
+			positions.clearHint();
+			positions.Hint = rand() % positions.size();
+			TEST_ASSERT_EQUAL(positions.getIndex(frame), expected);
+		}
+	}
+
+	// sample the raw clip before compress
+	core::array<core::vector3df> rawPositions;
+	core::array<core::quaternion> rawRotations;
+	core::array<float> frames;
+
+	CAnimationTrack track;
+	for (int i = 0; i < 100; i++)
+	{
+		float frame = (float)(rand() % 2000) / 1000.0f;
+		frames.push_back(frame);
+
+		for (int j = 0; j < numTrack; j++)
+		{
+			core::vector3df position, scale;
+			core::quaternion rotation;
+
+			track.setAnimationData(&clip->getAnimOfEntity(j)->Data);
+			track.getFrameData(frame, position, scale, rotation);
+
+			rawPositions.push_back(position);
+			rawRotations.push_back(rotation);
+		}
+	}
+
+	TEST_CASE("Animation compress");
+	CAnimationCompressor compressor;
+	compressor.PositionTolerance = 0.002f;
+	compressor.RotationTolerance = 0.005f;
+	compressor.ScaleTolerance = 0.001f;
+
+	TEST_ASSERT_THROW(compressor.compress(clip));
+	TEST_ASSERT_THROW(clip->getCompressed() != NULL);
+	TEST_ASSERT_THROW(compressor.getPositionError() <= compressor.PositionTolerance);
+	TEST_ASSERT_THROW(compressor.getRotationError() <= compressor.RotationTolerance);
+	TEST_ASSERT_FLOAT_EQUAL(clip->getAnimOfEntity(0)->Data.getLastFrame(), duration);
+
+	TEST_CASE("Animation compressed sample");
+	for (u32 i = 0; i < frames.size(); i++)
+	{
+		for (int j = 0; j < numTrack; j++)
+		{
+			core::vector3df position, scale;
+			core::quaternion rotation;
+
+			track.setAnimationData(&clip->getAnimOfEntity(j)->Data);
+			track.getFrameData(frames[i], position, scale, rotation);
+
+			core::quaternion raw = rawRotations[i * numTrack + j];
+			raw.normalize();
+
+			float angle = 2.0f * acosf(core::min_(fabsf(raw.dotProduct(rotation)), 1.0f));
+
+			TEST_ASSERT_THROW(position.getDistanceFrom(rawPositions[i * numTrack + j]) <= compressor.PositionTolerance);
+			TEST_ASSERT_THROW(angle <= compressor.RotationTolerance);
+			TEST_ASSERT_THROW(scale.equals(core::vector3df(1.0f, 1.0f, 1.0f)));
+		}
+	}
+
+	TEST_CASE("Animation compress memory");
+	{
+		CAnimationClip* rawClip = createTestClip(numTrack, duration, 30.0f);
+		TEST_ASSERT_THROW(CAnimationCompressor::getCompressedMemory(clip) < CAnimationCompressor::getKeyFrameMemory(rawClip));
+		delete rawClip;
+	}
+
+	if (g_testBenchmark)
+	{
+		TEST_CASE("Animation compress benchmark");
+
+		CAnimationClip* rawClip = createTestClip(numTrack, duration, 30.0f);
+		CAnimationTrack* rawTracks = new CAnimationTrack[numTrack];
+		CAnimationTrack* compressedTracks = new CAnimationTrack[numTrack];
+
+		for (int j = 0; j < numTrack; j++)
+		{
+			rawTracks[j].setAnimationData(&rawClip->getAnimOfEntity(j)->Data);
+			compressedTracks[j].setAnimationData(&clip->getAnimOfEntity(j)->Data);
+		}
+
+		// the characters play at the random times, so the hint misses
+		const int numLoop = 2000;
+		core::vector3df position, scale;
+		core::quaternion rotation;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numLoop; i++)
+		{
+			float frame = frames[i % frames.size()];
+			for (int j = 0; j < numTrack; j++)
+			{
+				rawTracks[j].getFrameData(frame, position, scale, rotation);
+			}
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numLoop; i++)
+		{
+			float frame = frames[i % frames.size()];
+			for (int j = 0; j < numTrack; j++)
+			{
+				compressedTracks[j].getFrameData(frame, position, scale, rotation);
+			}
+		}
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		printf("    %d tracks: raw %d bytes %.3fms, compressed %d bytes %.3fms (%.0f fps)\n",
+			numTrack,
+			CAnimationCompressor::getKeyFrameMemory(rawClip),
+			std::chrono::duration<double, std::milli>(t1 - t0).count(),
+			CAnimationCompressor::getCompressedMemory(clip),
+			std::chrono::duration<double, std::milli>(t2 - t1).count(),
+			clip->getCompressed()->SampleRate);
+
+		delete[] rawTracks;
+		delete[] compressedTracks;
+		delete rawClip;
+	}
+
+	TEST_CASE("Animation compressed data copy");
+	{
+		// the copy has the raw keys, the compressed keys stay with the clip
+		CAnimationData* data = &clip->getAnimOfEntity(0)->Data;
+		CAnimationData copy(*data);
+		TEST_ASSERT_THROW(copy.Compressed == NULL);
+		TEST_ASSERT_EQUAL(copy.Positions.size(), data->Positions.size());
+
+		copy = *data;
+		TEST_ASSERT_THROW(copy.Compressed == NULL);
+		TEST_ASSERT_THROW(data->Compressed != NULL);
+	}
+
+	delete clip;
+}
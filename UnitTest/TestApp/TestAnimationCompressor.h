@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Animation/CAnimationCompressor.h"
+
+void testAnimationCompressor();
@@ -16,10 +16,15 @@ irr::IrrlichtDevice *g_device = NULL;
 
 extern bool g_finalPass;
 
-int main(int, char**)
+int main(int argc, char* argv[])
 {
 	g_mainApp = new CApplication();
 
+	std::vector<std::string> params;
+	for (int i = 1; i < argc; i++)
+		params.push_back(std::string(argv[i]));
+	g_mainApp->setParams(params);
+
 	// create irrlicht device console and null driver
 	SIrrlichtCreationParameters p;
 	p.DeviceType = EIDT_CONSOLE;
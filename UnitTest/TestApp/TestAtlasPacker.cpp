@@ -0,0 +1,429 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestAtlasPacker.h"
+#include "Graphics2D/Glyph/CGlyphFreetype.h"
+#include "Graphics2D/SpriteFrame/CGlyphFont.h"
+
+#include <chrono>
+#include <set>
+
+using namespace Skylicht;
+
+static void getRandomGlyphCell(int* w, int* h)
+{
+	// the cells of the glyphs from 12px to 48px
+	*w = 4 + rand() % 36;
+	*h = 8 + rand() % 40;
+	CAtlas::calcCellSize(w, h);
+}
+
+static bool isAtlasRectOverlap(std::vector<u8>& used, int width, const core::recti& r)
+{
+	for (int y = r.UpperLeftCorner.Y; y < r.LowerRightCorner.Y; y++)
+	{
+		for (int x = r.UpperLeftCorner.X; x < r.LowerRightCorner.X; x++)
+		{
+			if (used[y * width + x] != 0)
+				return true;
+			used[y * width + x] = 1;
+		}
+	}
+	return false;
+}
+
+void testAtlasPacker()
+{
+	const int size = 1024;
+
+	TEST_CASE("Atlas shelf packer");
+	{
+		CAtlas* atlas = new CAtlas(ECF_A8R8G8B8, size, size);
+		std::vector<u8> used(size * size, 0);
+
+		int area = 0;
+		int numRect = 0;
+		double allocTime = 0.0;
+
+		while (true)
+		{
+			int w, h;
+			getRandomGlyphCell(&w, &h);
+
+			auto t0 = std::chrono::high_resolution_clock::now();
+			core::recti r = atlas->createRect(w, h);
+			auto t1 = std::chrono::high_resolution_clock::now();
+			allocTime += std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+			if (r.getWidth() == 0)
+				break;
+
+			TEST_ASSERT_EQUAL(r.getWidth(), w);
+			TEST_ASSERT_EQUAL(r.getHeight(), h);
+			TEST_ASSERT_THROW(r.UpperLeftCorner.X >= 0 && r.UpperLeftCorner.Y >= 0);
+			TEST_ASSERT_THROW(r.LowerRightCorner.X <= size && r.LowerRightCorner.Y <= size);
+			TEST_ASSERT_THROW(!isAtlasRectOverlap(used, size, r));
+
+			area += w * h;
+			numRect++;
+		}
+
+		TEST_ASSERT_EQUAL(atlas->getUsedArea(), area);
+
+		float efficiency = area / (float)(size * size);
+		TEST_ASSERT_THROW(efficiency > 0.8f);
+
+		if (g_testBenchmark)
+			printf("    %d glyph rects, %d shelves, packing %.1f%%, %.3fus/rect\n", numRect, atlas->getNumShelf(), efficiency * 100.0f, allocTime / numRect);
+
+		delete atlas;
+	}
+
+	TEST_CASE("Atlas release rect");
+	{
+		CAtlas* atlas = new CAtlas(ECF_A8R8G8B8, size, size);
+
+		std::vector<core::recti> rects;
+		for (int i = 0; i < 2000; i++)
+		{
+			int w, h;
+			getRandomGlyphCell(&w, &h);
+
+			core::recti r = atlas->createRect(w, h);
+			if (r.getWidth() == 0)
+				break;
+			rects.push_back(r);
+		}
+
+		// release a half, then the same sizes fit again
+		std::vector<core::recti> released;
+		for (size_t i = 0; i < rects.size(); i += 2)
+		{
+			atlas->releaseRect(rects[i]);
+			released.push_back(rects[i]);
+		}
+
+		std::vector<core::recti> reused;
+		for (core::recti& r : released)
+		{
+			core::recti newRect = atlas->createRect(r.getWidth(), r.getHeight());
+			if (newRect.getWidth() != 0)
+				reused.push_back(newRect);
+		}
+
+		TEST_ASSERT_THROW(reused.size() >= released.size() * 9 / 10);
+
+		// release all, the atlas is empty
+		for (size_t i = 1; i < rects.size(); i += 2)
+			atlas->releaseRect(rects[i]);
+		for (core::recti& r : reused)
+			atlas->releaseRect(r);
+
+		TEST_ASSERT_EQUAL(atlas->getUsedArea(), 0);
+		TEST_ASSERT_EQUAL(atlas->getNumShelf(), 0);
+		TEST_ASSERT_THROW(atlas->createRect(size, size).getWidth() == size);
+
+		// the empty shelves on the top are removed
+		atlas->clear();
+		core::recti a = atlas->createRect(100, 20);
+		core::recti b = atlas->createRect(100, 60);
+		atlas->releaseRect(b);
+		TEST_ASSERT_EQUAL(atlas->getNumShelf(), 1);
+		atlas->releaseRect(a);
+		TEST_ASSERT_EQUAL(atlas->getNumShelf(), 0);
+		TEST_ASSERT_EQUAL(atlas->getUsedArea(), 0);
+
+		delete atlas;
+	}
+
+	TEST_CASE("Atlas release pages");
+	{
+		const int numLoop = g_testBenchmark ? 200000 : 20000;
+		std::vector<core::vector2di> sizes;
+		for (int i = 0; i < 1000; i++)
+		{
+			int w, h;
+			getRandomGlyphCell(&w, &h);
+			sizes.push_back(core::vector2di(w, h));
+		}
+
+		std::vector<CAtlas*> pages;
+		pages.push_back(new CAtlas(ECF_A8R8G8B8, size, size));
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		// a long session, the glyphs are added and the old pages are released
+		std::vector<std::vector<core::recti>> rects(1);
+		for (int i = 0; i < numLoop; i++)
+		{
+			core::vector2di& s = sizes[i % sizes.size()];
+			core::recti r = pages.back()->createRect(s.X, s.Y);
+			if (r.getWidth() == 0)
+			{
+				if (pages.size() >= 4)
+				{
+					// release the oldest page by the rects
+					CAtlas* page = pages.front();
+					for (core::recti& old : rects.front())
+						page->releaseRect(old);
+
+					pages.erase(pages.begin());
+					rects.erase(rects.begin());
+					pages.push_back(page);
+				}
+				else
+				{
+					pages.push_back(new CAtlas(ECF_A8R8G8B8, size, size));
+				}
+
+				rects.push_back(std::vector<core::recti>());
+				r = pages.back()->createRect(s.X, s.Y);
+			}
+
+			TEST_ASSERT_THROW(r.getWidth() != 0);
+			rects.back().push_back(r);
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		if (g_testBenchmark)
+		{
+			double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+			int area = 0;
+			for (CAtlas* page : pages)
+				area += page->getUsedArea();
+
+			printf("    %d rects and release: %.3fms (%.0f rects/ms), %d pages %.1f%% used\n",
+				numLoop, ms, numLoop / ms, (int)pages.size(), area * 100.0f / (float)(pages.size() * size * size));
+		}
+
+		// the released pages are reused
+		TEST_ASSERT_THROW(pages.size() <= 4);
+		for (size_t i = 0; i < pages.size(); i++)
+		{
+			int area = 0;
+			for (core::recti& r : rects[i])
+				area += r.getArea();
+			TEST_ASSERT_EQUAL(pages[i]->getUsedArea(), area);
+		}
+
+		for (CAtlas* page : pages)
+			delete page;
+	}
+
+	TEST_CASE("Sprite atlas defragment");
+	{
+		const int spriteSize = 256;
+		const int numFrame = 150;
+		CSpriteAtlas* sprite = new CSpriteAtlas(ECF_A8R8G8B8, spriteSize, spriteSize);
+
+		std::vector<SFrame*> frames;
+		std::vector<SColor> colors;
+
+		for (int i = 0; i < numFrame; i++)
+		{
+			int w = 8 + rand() % 40;
+			int h = 8 + rand() % 40;
+			SColor color(255, rand() % 256, rand() % 256, i % 256);
+
+			IImage* img = getVideoDriver()->createImage(ECF_A8R8G8B8, core::dimension2du(w, h));
+			img->fill(color);
+
+			char name[64];
+			sprintf(name, "frame%d", i);
+			SFrame* frame = sprite->addFrame(name, img);
+			img->drop();
+
+			TEST_ASSERT_THROW(frame != NULL);
+			frames.push_back(frame);
+			colors.push_back(color);
+		}
+
+		int numImage = (int)sprite->getImages().size();
+
+		// remove the frames, the holes are on all atlas
+		std::vector<SFrame*> keepFrames;
+		std::vector<SColor> keepColors;
+		for (int i = 0; i < numFrame; i++)
+		{
+			if (i % 3 != 0)
+			{
+				TEST_ASSERT_THROW(sprite->removeFrame(frames[i]));
+			}
+			else
+			{
+				keepFrames.push_back(frames[i]);
+				keepColors.push_back(colors[i]);
+			}
+		}
+
+		TEST_ASSERT_EQUAL((int)sprite->getFrames().size(), (int)keepFrames.size());
+
+		std::vector<u32> keepVersions;
+		for (SFrame* frame : keepFrames)
+			keepVersions.push_back(frame->Version);
+
+		int moved = sprite->defragment();
+		TEST_ASSERT_THROW(moved > 0);
+
+		// the moved frames have a new version, so the sprites rebuild their render cache
+		int changedVersion = 0;
+		for (size_t i = 0; i < keepFrames.size(); i++)
+		{
+			if (keepFrames[i]->Version != keepVersions[i])
+				changedVersion++;
+		}
+		TEST_ASSERT_EQUAL(changedVersion, moved);
+
+		// the frames are on the first atlas, and the pixels are moved with them
+		int usedImage = 0;
+		for (SImage* image : sprite->getImages())
+		{
+			if (image->Atlas->getUsedArea() > 0)
+				usedImage++;
+		}
+		TEST_ASSERT_THROW(usedImage < numImage);
+
+		for (size_t i = 0; i < keepFrames.size(); i++)
+		{
+			SModuleRect* module = keepFrames[i]->ModuleOffset[0].Module;
+			IImage* image = keepFrames[i]->Image->Atlas->getImage();
+
+			TEST_ASSERT_THROW(image->getPixel((u32)module->X, (u32)module->Y) == keepColors[i]);
+			TEST_ASSERT_THROW(image->getPixel((u32)(module->X + module->W - 1), (u32)(module->Y + module->H - 1)) == keepColors[i]);
+		}
+
+		if (g_testBenchmark)
+			printf("    sprite defragment: %d frames moved, %d atlas -> %d atlas\n", moved, numImage, usedImage);
+
+		sprite->drop();
+	}
+
+	CGlyphFreetype* freetype = CGlyphFreetype::getInstance();
+	const char* fontName = "TestSegoeUI";
+
+	TEST_CASE("Glyph atlas defragment");
+	if (!freetype->initFont(fontName, "../Assets/BuiltIn/Fonts/segoeui/segoeui.ttf"))
+	{
+		// the font asset is not synced (git lfs)
+		return;
+	}
+
+	std::wstring text = L"The quick brown fox jumps over the lazy dog 0123456789";
+	for (int i = 0; i < 200; i++)
+		text += (wchar_t)(0x4E00 + i * 37);
+
+	float advance, x, y, w, h, offsetX, offsetY;
+
+	{
+		freetype->clearAtlas();
+
+		// the font size 20px
+		CGlyphFont* font = new CGlyphFont(fontName, CGlyphFreetype::sizePxToPt(20));
+
+		for (int fontSize : { 20, 48, 28 })
+		{
+			for (wchar_t c : text)
+				freetype->getCharImage((u16)c, fontName, fontSize, &advance, &x, &y, &w, &h, &offsetX, &offsetY);
+		}
+
+		SModuleOffset* moduleA = font->getCharacterModule((int)L'A');
+		TEST_ASSERT_THROW(moduleA != NULL);
+
+		int usedArea = 0;
+		for (CAtlas* atlas : freetype->getAtlas())
+			usedArea += atlas->getUsedArea();
+
+		int removed = freetype->removeGlyphs(fontName, 48, false);
+		TEST_ASSERT_EQUAL(removed, (int)std::set<wchar_t>(text.begin(), text.end()).size());
+
+		int releasedArea = 0;
+		for (CAtlas* atlas : freetype->getAtlas())
+			releasedArea += atlas->getUsedArea();
+		TEST_ASSERT_THROW(releasedArea < usedArea);
+
+		// the pixels of 'A' before
+		CAtlas* atlasA = freetype->getCharImage((u16)'A', fontName, 20, &advance, &x, &y, &w, &h, &offsetX, &offsetY);
+		int ax = core::round32(x * size), ay = core::round32(y * size);
+		int aw = core::round32(w * size), ah = core::round32(h * size);
+
+		std::vector<u32> pixels;
+		for (int py = 0; py < ah; py++)
+			for (int px = 0; px < aw; px++)
+				pixels.push_back(atlasA->getImage()->getPixel(ax + px, ay + py).color);
+
+		u32 version = freetype->getAtlasVersion();
+		int numRaster = freetype->getNumRasterGlyph();
+
+		int moved = freetype->defragment();
+		TEST_ASSERT_THROW(moved > 0);
+		TEST_ASSERT_THROW(freetype->getAtlasVersion() != version);
+		TEST_ASSERT_EQUAL(freetype->getNumRasterGlyph(), numRaster);
+
+		// the pixels are moved with the glyph
+		atlasA = freetype->getCharImage((u16)'A', fontName, 20, &advance, &x, &y, &w, &h, &offsetX, &offsetY);
+		ax = core::round32(x * size);
+		ay = core::round32(y * size);
+
+		bool same = true;
+		for (int py = 0, i = 0; py < ah; py++)
+			for (int px = 0; px < aw; px++, i++)
+				same = same && atlasA->getImage()->getPixel(ax + px, ay + py).color == pixels[i];
+		TEST_ASSERT_THROW(same);
+
+		// the font module is updated in place
+		TEST_ASSERT_THROW(font->getCharacterModule((int)L'A') == moduleA);
+		TEST_ASSERT_FLOAT_EQUAL(moduleA->Module->X, (float)ax);
+		TEST_ASSERT_FLOAT_EQUAL(moduleA->Module->Y, (float)ay);
+		TEST_ASSERT_THROW(moduleA->Frame->Image->Atlas == atlasA);
+
+		int defragArea = 0;
+		int usedAtlas = 0;
+		for (CAtlas* atlas : freetype->getAtlas())
+		{
+			defragArea += atlas->getUsedArea();
+			if (atlas->getUsedArea() > 0)
+				usedAtlas++;
+		}
+		TEST_ASSERT_EQUAL(defragArea, releasedArea);
+
+		if (g_testBenchmark)
+			printf("    glyph defragment: %d glyphs moved, %d/%d atlas used\n", moved, usedAtlas, (int)freetype->getAtlas().size());
+
+		font->drop();
+	}
+
+	TEST_CASE("Glyph atlas eviction");
+	{
+		freetype->clearAtlas();
+		freetype->setMaxAtlas(1);
+
+		CGlyphFont* font = new CGlyphFont(fontName, CGlyphFreetype::sizePxToPt(20));
+		SModuleOffset* moduleA = font->getCharacterModule((int)L'A');
+		font->updateFontTexture();
+
+		// more glyphs than one atlas
+		u32 version = freetype->getAtlasVersion();
+		for (int fontSize : { 64, 72, 80 })
+		{
+			for (wchar_t c : text)
+				TEST_ASSERT_THROW(freetype->getCharImage((u16)c, fontName, fontSize, &advance, &x, &y, &w, &h, &offsetX, &offsetY) != NULL);
+		}
+
+		TEST_ASSERT_EQUAL((int)freetype->getAtlas().size(), 1);
+		TEST_ASSERT_THROW(freetype->getAtlasVersion() != version);
+
+		// the evicted glyph is rasterized again when the font is drawn
+		font->updateFontTexture();
+
+		CAtlas* atlasA = freetype->getCharImage((u16)'A', fontName, 20, &advance, &x, &y, &w, &h, &offsetX, &offsetY);
+		TEST_ASSERT_THROW(atlasA != NULL);
+		TEST_ASSERT_FLOAT_EQUAL(moduleA->Module->X, x * size);
+		TEST_ASSERT_FLOAT_EQUAL(moduleA->Module->Y, y * size);
+
+		font->drop();
+
+		freetype->setMaxAtlas(0);
+		freetype->clearAtlas();
+	}
+}
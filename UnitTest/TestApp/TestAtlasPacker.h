@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Base.hh"
+#include "Graphics2D/Atlas/CAtlas.h"
+#include "Graphics2D/SpriteFrame/CSpriteAtlas.h"
+
+void testAtlasPacker();
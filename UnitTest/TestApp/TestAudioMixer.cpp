@@ -0,0 +1,163 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestAudioMixer.h"
+
+#ifdef BUILD_SKYLICHT_AUDIO
+
+#include "Driver/CDriverNull.h"
+
+#include <chrono>
+
+using namespace Skylicht::Audio;
+
+static void uploadTestData(ISoundSource* source, short* data, int numFrame, short value)
+{
+	for (int i = 0; i < numFrame * 2; i++)
+		data[i] = value;
+
+	if (source->needData())
+		source->uploadData(data, numFrame * 2 * sizeof(short));
+}
+
+void testAudioMixer()
+{
+	const int numSource = 64;
+
+	CDriverNull* driver = new CDriverNull();
+
+	SSourceParam driverParam;
+	driver->getSourceParam(&driverParam);
+
+	STrackParams trackParam;
+	trackParam.NumChannels = 2;
+	trackParam.SamplingRate = driverParam.SamplingRate;
+	trackParam.BitsPerSample = 16;
+
+	int numFrame = driverParam.BufferSize;
+	short* data = new short[numFrame * 2];
+	short* out = new short[numFrame * 2];
+
+	ISoundSource* sources[numSource];
+	for (int i = 0; i < numSource; i++)
+	{
+		sources[i] = driver->createSource();
+		sources[i]->init(trackParam, driverParam);
+		sources[i]->play();
+	}
+
+	TEST_CASE("Audio mixer gain");
+	{
+		// only the first voice is audible
+		for (int i = 0; i < numSource; i++)
+		{
+			sources[i]->setGain(i == 0 ? 0.5f : 0.0f);
+			uploadTestData(sources[i], data, numFrame, 1000);
+		}
+
+		driver->fillBuffer((unsigned short*)out, numFrame);
+
+		TEST_ASSERT_EQUAL(driver->getNumMixedVoices(), 1);
+		TEST_ASSERT_EQUAL(driver->getNumVirtualVoices(), numSource - 1);
+		TEST_ASSERT_EQUAL(out[0], 500);
+		TEST_ASSERT_EQUAL(out[1], 500);
+		TEST_ASSERT_EQUAL(out[numFrame * 2 - 1], 500);
+	}
+
+	TEST_CASE("Audio mixer clamp");
+	{
+		for (int i = 0; i < numSource; i++)
+		{
+			sources[i]->setGain(1.0f);
+			uploadTestData(sources[i], data, numFrame, 20000);
+		}
+
+		driver->fillBuffer((unsigned short*)out, numFrame);
+
+		TEST_ASSERT_EQUAL(driver->getNumMixedVoices(), numSource);
+		TEST_ASSERT_EQUAL(out[0], 32767);
+		TEST_ASSERT_EQUAL(out[numFrame * 2 - 1], 32767);
+
+		for (int i = 0; i < numSource; i++)
+			uploadTestData(sources[i], data, numFrame, -20000);
+
+		driver->fillBuffer((unsigned short*)out, numFrame);
+
+		TEST_ASSERT_EQUAL(out[0], -32768);
+		TEST_ASSERT_EQUAL(out[numFrame * 2 - 1], -32768);
+	}
+
+	TEST_CASE("Audio mixer resample");
+	{
+		// the half rate track is stretched to the driver rate
+		STrackParams halfRate = trackParam;
+		halfRate.SamplingRate = driverParam.SamplingRate / 2;
+
+		ISoundSource* source = driver->createSource();
+		source->init(halfRate, driverParam);
+		source->play();
+
+		for (int i = 0; i < numSource; i++)
+			sources[i]->stop();
+
+		for (int i = 0; i < numFrame; i++)
+		{
+			data[i * 2] = (short)(i * 2);
+			data[i * 2 + 1] = (short)(-i * 2);
+		}
+		source->uploadData(data, numFrame * 2 * sizeof(short));
+
+		driver->fillBuffer((unsigned short*)out, numFrame);
+
+		TEST_ASSERT_EQUAL(out[2], 1);
+		TEST_ASSERT_EQUAL(out[3], -1);
+		TEST_ASSERT_EQUAL(out[20], 10);
+		TEST_ASSERT_EQUAL(out[21], -10);
+
+		driver->destroyDriverSource(source);
+
+		for (int i = 0; i < numSource; i++)
+			sources[i]->play();
+	}
+
+	TEST_CASE("Audio mixer virtual voices");
+	{
+		const int numLoop = g_testBenchmark ? 200 : 4;
+
+		// a half of voices are virtual
+		for (int i = 0; i < numSource; i++)
+			sources[i]->setGain(i % 2 == 0 ? 0.1f : 0.0f);
+
+		double time = 0.0;
+
+		for (int loop = 0; loop < numLoop; loop++)
+		{
+			for (int i = 0; i < numSource; i++)
+				uploadTestData(sources[i], data, numFrame, (short)(loop * 10));
+
+			auto t0 = std::chrono::high_resolution_clock::now();
+			driver->fillBuffer((unsigned short*)out, numFrame);
+			auto t1 = std::chrono::high_resolution_clock::now();
+
+			time += std::chrono::duration<double, std::micro>(t1 - t0).count();
+		}
+
+		TEST_ASSERT_EQUAL(driver->getNumMixedVoices(), numSource / 2);
+
+		if (g_testBenchmark)
+			printf("    %d voices, %d frames: %.1fus per buffer\n", numSource, numFrame, time / numLoop);
+	}
+
+	driver->destroyAllSource();
+	delete driver;
+
+	delete[] data;
+	delete[] out;
+}
+
+#else
+
+void testAudioMixer()
+{
+}
+
+#endif
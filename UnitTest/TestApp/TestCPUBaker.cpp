@@ -0,0 +1,306 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCPUBaker.h"
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+#include "RenderMesh/CRenderMeshData.h"
+#include "RenderMesh/CMesh.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+using namespace Skylicht::Lightmapper;
+
+static void addBakeQuad(CCPUBaker* baker, const core::vector3df& center, const core::vector3df& x, const core::vector3df& z, const core::vector3df& albedo)
+{
+	core::vector3df a = center - x - z;
+	core::vector3df b = center + x - z;
+	core::vector3df c = center + x + z;
+	core::vector3df d = center - x + z;
+
+	baker->addTriangle(a, b, c, albedo);
+	baker->addTriangle(a, c, d, albedo);
+}
+
+// the floor, a roof on the floor & the boxes
+static void createBakeScene(CCPUBaker* baker, int numBox)
+{
+	srand(3);
+
+	core::vector3df white(0.8f, 0.8f, 0.8f);
+
+	addBakeQuad(baker, core::vector3df(0.0f, 0.0f, 0.0f), core::vector3df(20.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, 20.0f), white);
+	addBakeQuad(baker, core::vector3df(0.0f, 3.0f, 0.0f), core::vector3df(3.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, 3.0f), white);
+
+	for (int i = 0; i < numBox; i++)
+	{
+		core::vector3df center((float)(rand() % 300) / 10.0f - 15.0f, 1.0f, (float)(rand() % 300) / 10.0f - 15.0f);
+
+		// keep the roof area clear
+		if (fabsf(center.X) < 5.0f && fabsf(center.Z) < 5.0f)
+			continue;
+
+		core::vector3df edges[8];
+		core::aabbox3df(center - core::vector3df(0.5f, 1.0f, 0.5f), center + core::vector3df(0.5f, 1.0f, 0.5f)).getEdges(edges);
+
+		const int id[] = { 3,0,2, 3,1,0, 3,2,7, 7,2,6, 7,6,4, 5,7,4, 5,4,0, 5,0,1, 1,3,7, 1,7,5, 0,6,2, 0,4,6 };
+		for (int j = 0; j < 36; j += 3)
+			baker->addTriangle(edges[id[j]], edges[id[j + 1]], edges[id[j + 2]], white);
+	}
+
+	SBakeLight sun;
+	sun.Type = CLight::DirectionalLight;
+	sun.Direction.set(0.0f, -1.0f, 0.0f);
+	sun.Color.set(1.0f, 1.0f, 1.0f);
+	sun.Bounce = 2;
+	baker->addLight(sun);
+
+	baker->buildScene();
+}
+
+static float getSHError(const CSH9& a, const CSH9& b)
+{
+	float error = 0.0f;
+	for (int i = 0; i < 9; i++)
+		error += (a.getValueConst()[i] - b.getValueConst()[i]).getLengthSQ();
+	return sqrtf(error);
+}
+
+static bool isSHEqual(const CSH9& a, const CSH9& b)
+{
+	return memcmp(a.getValueConst(), b.getValueConst(), sizeof(core::vector3df) * 9) == 0;
+}
+
+void testCPUBaker()
+{
+	CCPUBaker* baker = new CCPUBaker();
+	createBakeScene(baker, 80);
+
+	CBakeBVH* bvh = baker->getBVH();
+
+	TEST_CASE("CPU baker BVH");
+	{
+		srand(4);
+
+		for (int i = 0; i < 500; i++)
+		{
+			core::vector3df origin((float)(rand() % 400) / 10.0f - 20.0f, (float)(rand() % 60) / 10.0f + 0.1f, (float)(rand() % 400) / 10.0f - 20.0f);
+			core::vector3df dir((float)(rand() % 200) - 100.0f, (float)(rand() % 200) - 100.0f, (float)(rand() % 200) - 100.0f);
+			dir.normalize();
+
+			// brute force
+			float tBest = FLT_MAX;
+			for (u32 j = 0, n = bvh->getTriangleCount(); j < n; j++)
+			{
+				float t;
+				if (CBakeBVH::intersectTriangle(bvh->getTriangle(j), origin, dir, t) && t > 0.0f && t < tBest)
+					tBest = t;
+			}
+
+			SBakeHit hit;
+			bool found = bvh->intersect(origin, dir, FLT_MAX, hit);
+
+			TEST_ASSERT_THROW(found == (tBest < FLT_MAX));
+			if (found)
+			{
+				TEST_ASSERT_THROW(fabsf(hit.T - tBest) < 1e-4f);
+				TEST_ASSERT_THROW(bvh->occluded(origin, dir, tBest + 0.01f));
+			}
+
+			TEST_ASSERT_THROW(!bvh->occluded(origin, dir, core::min_(tBest, 1e6f) * 0.99f));
+		}
+	}
+
+	// the probes in the open area & under the roof
+	core::array<core::vector3df> positions;
+	core::array<core::vector3df> normals;
+	for (int i = 0; i < 64; i++)
+	{
+		float x = (float)(i % 8) - 3.5f;
+		float z = (float)(i / 8) - 3.5f;
+
+		positions.push_back(core::vector3df(x * 2.0f, 1.0f, z * 2.0f));
+		normals.push_back(core::vector3df(0.0f, 1.0f, 0.0f));
+	}
+
+	baker->setNumSample(32);
+	baker->setNumBounce(1);
+
+	TEST_CASE("CPU baker deterministic");
+	{
+		core::array<CSH9> first;
+
+		baker->setNumPass(2);
+		baker->bake(positions.pointer(), normals.pointer(), positions.size(), NUM_FACES);
+		for (u32 i = 0; i < positions.size(); i++)
+			first.push_back(baker->getSH(i));
+
+		baker->bake(positions.pointer(), normals.pointer(), positions.size(), NUM_FACES);
+		for (u32 i = 0; i < positions.size(); i++)
+			TEST_ASSERT_THROW(isSHEqual(first[i], baker->getSH(i)));
+
+		// a position does not depend on the batch & the thread that bakes it
+		baker->bake(positions.pointer() + 10, normals.pointer() + 10, 1, NUM_FACES);
+		TEST_ASSERT_THROW(isSHEqual(first[10], baker->getSH(0)));
+	}
+
+	TEST_CASE("CPU baker shadow");
+	{
+		baker->setNumPass(4);
+		baker->bake(positions.pointer(), normals.pointer(), positions.size(), NUM_FACES);
+
+		core::vector3df down(0.0f, -1.0f, 0.0f);
+
+		for (u32 i = 0; i < positions.size(); i++)
+		{
+			core::vector3df color;
+			CSH9 sh = baker->getSH(i);
+			sh.getSHIrradiance(down, color);
+
+			const core::vector3df& p = positions[i];
+			if (fabsf(p.X) < 1.5f && fabsf(p.Z) < 1.5f)
+			{
+				// under the roof, the floor is in the shadow
+				core::vector3df open;
+				CSH9 openSH = baker->getSH(0);
+				openSH.getSHIrradiance(down, open);
+
+				TEST_ASSERT_THROW(color.X < open.X * 0.7f);
+			}
+
+			TEST_ASSERT_THROW(color.X >= 0.0f);
+		}
+	}
+
+	TEST_CASE("CPU baker progressive");
+	{
+		const int testId = 9;
+
+		baker->setNumPass(64);
+		baker->bake(positions.pointer() + testId, normals.pointer() + testId, 1, NUM_FACES);
+		CSH9 reference = baker->getSH(0);
+
+		baker->begin(positions.pointer() + testId, normals.pointer() + testId, 1, NUM_FACES);
+
+		baker->refine();
+		float error1 = getSHError(baker->getSH(0), reference);
+
+		while (baker->getCurrentPass() < 16)
+			baker->refine();
+		float error16 = getSHError(baker->getSH(0), reference);
+
+		TEST_ASSERT_THROW(error16 < error1);
+
+		if (g_testBenchmark)
+			printf("    error pass 1: %.4f, pass 16: %.4f\n", error1, error16);
+	}
+
+	TEST_CASE("CPU baker sky");
+	{
+		CCPUBaker* empty = new CCPUBaker();
+		empty->buildScene();
+		empty->setSkyColor(core::vector3df(1.0f, 1.0f, 1.0f));
+		empty->setNumSample(64);
+		empty->setNumPass(4);
+
+		core::vector3df position(0.0f, 0.0f, 0.0f);
+		core::vector3df normal(0.0f, 1.0f, 0.0f);
+		empty->bake(&position, &normal, 1, NUM_FACES);
+
+		// the irradiance of the constant radiance (compressed by 3.0) is PI / 3
+		core::vector3df color;
+		CSH9 sh = empty->getSH(0);
+		sh.getSHIrradiance(normal, color);
+		TEST_ASSERT_THROW(fabsf(color.X - core::PI / 3.0f) < 0.03f);
+
+		sh.getSHIrradiance(-normal, color);
+		TEST_ASSERT_THROW(fabsf(color.X - core::PI / 3.0f) < 0.03f);
+
+		delete empty;
+	}
+
+	if (g_testBenchmark)
+	{
+		TEST_CASE("CPU baker benchmark");
+
+		baker->setNumPass(1);
+		baker->setNumSample(256);
+		baker->setNumBounce(2);
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+		baker->bake(positions.pointer(), normals.pointer(), positions.size(), 5);
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+		printf("    %d triangles, %d texels x %d samples: %.1fms, %.2f Mrays/s\n",
+			bvh->getTriangleCount(),
+			positions.size(),
+			baker->getNumSample(),
+			ms,
+			(double)baker->getNumRay() / (ms * 1000.0));
+	}
+
+	delete baker;
+
+	TEST_CASE("CPU baker lightmapper");
+	{
+		// a floor entity
+		IMeshBuffer* mb = new CMeshBuffer<video::S3DVertex>(getVideoDriver()->getVertexDescriptor(EVT_STANDARD), video::EIT_16BIT);
+		IVertexBuffer* vb = mb->getVertexBuffer(0);
+		IIndexBuffer* ib = mb->getIndexBuffer();
+
+		video::S3DVertex v;
+		v.Normal.set(0.0f, 1.0f, 0.0f);
+		v.Color.set(255, 64, 64, 64);
+
+		v.Pos.set(-10.0f, 0.0f, -10.0f); vb->addVertex(&v);
+		v.Pos.set(10.0f, 0.0f, -10.0f); vb->addVertex(&v);
+		v.Pos.set(10.0f, 0.0f, 10.0f); vb->addVertex(&v);
+		v.Pos.set(-10.0f, 0.0f, 10.0f); vb->addVertex(&v);
+
+		ib->addIndex(0); ib->addIndex(1); ib->addIndex(2);
+		ib->addIndex(0); ib->addIndex(2); ib->addIndex(3);
+
+		CMesh* mesh = new CMesh();
+		mesh->addMeshBuffer(mb);
+		mb->drop();
+
+		CEntityManager* entityManager = new CEntityManager();
+		CEntity* entity = entityManager->createEntity();
+		CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+		transform->World.setTranslation(core::vector3df(0.0f, -1.0f, 0.0f));
+
+		CRenderMeshData* renderer = entity->addData<CRenderMeshData>();
+		renderer->setMesh(mesh);
+		mesh->drop();
+
+		// no initBaker, the hemicube bakers are not created
+		CLightmapper* lightmapper = CLightmapper::createGetInstance();
+		lightmapper->setBakerType(CLightmapper::CPUBaker);
+		lightmapper->getCPUBaker()->setSkyColor(core::vector3df(1.0f, 1.0f, 1.0f));
+		lightmapper->getCPUBaker()->setNumSample(64);
+		lightmapper->getCPUBaker()->setNumPass(2);
+
+		std::vector<core::vector3df> probePositions;
+		std::vector<CSH9> probes;
+		probePositions.push_back(core::vector3df(0.0f, 0.0f, 0.0f));
+
+		// no camera & render pipeline
+		lightmapper->bakeProbes(probePositions, probes, NULL, NULL, entityManager);
+
+		TEST_ASSERT_EQUAL((int)probes.size(), 1);
+		TEST_ASSERT_EQUAL((int)lightmapper->getCPUBaker()->getBVH()->getTriangleCount(), 2);
+		TEST_ASSERT_THROW(lightmapper->getCPUBaker()->getSceneEntityManager() == entityManager);
+
+		// the sky is on the top, the floor (albedo 0.25) reflects the sky on the bottom
+		core::vector3df up, down;
+		probes[0].getSHIrradiance(core::vector3df(0.0f, 1.0f, 0.0f), up);
+		probes[0].getSHIrradiance(core::vector3df(0.0f, -1.0f, 0.0f), down);
+		TEST_ASSERT_THROW(up.X > 0.5f);
+		TEST_ASSERT_THROW(down.X > up.X * 0.15f && down.X < up.X * 0.35f);
+
+		CLightmapper::releaseInstance();
+
+		delete entityManager;
+	}
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Base.hh"
+#include "Lightmapper/CLightmapper.h"
+#include "Lightmapper/CCPUBaker.h"
+
+void testCPUBaker();
@@ -0,0 +1,502 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCollisionBVH.h"
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static float collisionRandom(float min, float max)
+{
+	return min + (max - min) * (float)(rand() % 10000) / 10000.0f;
+}
+
+static float terrainHeight(float x, float z)
+{
+	return sinf(x * 0.1f) * cosf(z * 0.13f) * 3.0f;
+}
+
+// the level: a terrain grid & the boxes on it
+static void createCollisionLevel(CCollisionBuilder* builder, int gridSize, int numBox)
+{
+	srand(1);
+
+	const float cell = 2.0f;
+	const float half = gridSize * cell * 0.5f;
+
+	CCollisionNode* terrain = new CCollisionNode(NULL, NULL, NULL);
+	for (int z = 0; z < gridSize; z++)
+	{
+		for (int x = 0; x < gridSize; x++)
+		{
+			float x0 = x * cell - half, x1 = x0 + cell;
+			float z0 = z * cell - half, z1 = z0 + cell;
+
+			core::vector3df a(x0, terrainHeight(x0, z0), z0);
+			core::vector3df b(x1, terrainHeight(x1, z0), z0);
+			core::vector3df c(x1, terrainHeight(x1, z1), z1);
+			core::vector3df d(x0, terrainHeight(x0, z1), z1);
+
+			terrain->Triangles.push_back(core::triangle3df(a, b, c));
+			terrain->Triangles.push_back(core::triangle3df(a, c, d));
+		}
+	}
+	builder->addCollision(terrain);
+
+	for (int i = 0; i < numBox; i++)
+	{
+		core::vector3df center(collisionRandom(-half, half), 0.0f, collisionRandom(-half, half));
+		core::vector3df size(collisionRandom(0.5f, 3.0f), collisionRandom(1.0f, 6.0f), collisionRandom(0.5f, 3.0f));
+		center.Y = terrainHeight(center.X, center.Z) + size.Y;
+
+		core::vector3df edges[8];
+		core::aabbox3df(center - size, center + size).getEdges(edges);
+
+		CCollisionNode* box = new CCollisionNode(NULL, NULL, NULL);
+		const int id[] = { 3,0,2, 3,1,0, 3,2,7, 7,2,6, 7,6,4, 5,7,4, 5,4,0, 5,0,1, 1,3,7, 1,7,5, 0,6,2, 0,4,6 };
+		for (int j = 0; j < 36; j += 3)
+			box->Triangles.push_back(core::triangle3df(edges[id[j]], edges[id[j + 1]], edges[id[j + 2]]));
+
+		builder->addCollision(box);
+	}
+
+	builder->build();
+}
+
+// the rays in the coherent groups of 4 (as the shotgun pellets)
+static void createCollisionRays(core::array<core::line3df>& rays, int count, float worldSize)
+{
+	srand(2);
+
+	for (int i = 0; i < count; i += 4)
+	{
+		core::vector3df start(collisionRandom(-worldSize, worldSize), collisionRandom(1.0f, 30.0f), collisionRandom(-worldSize, worldSize));
+		core::vector3df target(collisionRandom(-worldSize, worldSize), collisionRandom(-10.0f, 5.0f), collisionRandom(-worldSize, worldSize));
+
+		for (int j = 0; j < 4; j++)
+		{
+			core::vector3df jitter(collisionRandom(-1.0f, 1.0f), collisionRandom(-1.0f, 1.0f), collisionRandom(-1.0f, 1.0f));
+			rays.push_back(core::line3df(start, target + jitter));
+		}
+	}
+}
+
+// the box triangles in local space, the entity moves it
+class CTestBoxSelector : public CTriangleSelector
+{
+protected:
+	core::aabbox3df m_box;
+
+public:
+	CTestBoxSelector(CEntity* entity, const core::aabbox3df& box) :
+		CTriangleSelector(entity),
+		m_box(box)
+	{
+		init();
+	}
+
+	virtual void init()
+	{
+		core::vector3df edges[8];
+		m_box.getEdges(edges);
+
+		const int id[] = { 3,0,2, 3,1,0, 3,2,7, 7,2,6, 7,6,4, 5,7,4, 5,4,0, 5,0,1, 1,3,7, 1,7,5, 0,6,2, 0,4,6 };
+		for (int j = 0; j < 36; j += 3)
+			m_triangles.push_back(core::triangle3df(edges[id[j]], edges[id[j + 1]], edges[id[j + 2]]));
+	}
+};
+
+static void moveCollisionEntity(CEntity* entity, float worldSize)
+{
+	CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+
+	core::vector3df position(collisionRandom(-worldSize, worldSize), 0.0f, collisionRandom(-worldSize, worldSize));
+	position.Y = terrainHeight(position.X, position.Z) + collisionRandom(0.0f, 5.0f);
+
+	transform->World.makeIdentity();
+	transform->World.setRotationDegrees(core::vector3df(0.0f, collisionRandom(0.0f, 360.0f), collisionRandom(-20.0f, 20.0f)));
+	transform->World.setTranslation(position);
+}
+
+// the static terrain & the moving boxes of the entities
+static void createDynamicLevel(CCollisionBuilder* builder, core::array<CEntity*>& entities, int gridSize, core::array<CCollisionNode*>& nodes)
+{
+	createCollisionLevel(builder, gridSize, 0);
+
+	for (u32 i = 0; i < entities.size(); i++)
+	{
+		srand(100 + i);
+
+		core::vector3df size(collisionRandom(0.5f, 3.0f), collisionRandom(1.0f, 6.0f), collisionRandom(0.5f, 3.0f));
+		CTestBoxSelector* selector = new CTestBoxSelector(entities[i], core::aabbox3df(-size, size));
+
+		CCollisionNode* node = new CCollisionNode(NULL, entities[i], selector);
+		builder->addCollision(node);
+		nodes.push_back(node);
+	}
+
+	builder->build();
+}
+
+static int compareCollisionRays(CCollisionBuilder* a, CCollisionBuilder* b, core::array<core::line3df>& rays)
+{
+	int numMismatch = 0;
+
+	for (u32 i = 0; i < rays.size(); i++)
+	{
+		const core::line3df& ray = rays[i];
+
+		core::vector3df pointA, pointB;
+		core::triangle3df triA, triB;
+		CCollisionNode* nodeA = NULL;
+		CCollisionNode* nodeB = NULL;
+
+		f32 distanceA = ray.getLengthSQ();
+		f32 distanceB = ray.getLengthSQ();
+
+		bool hitA = a->getCollisionPoint(ray, distanceA, pointA, triA, nodeA);
+		bool hitB = b->getCollisionPoint(ray, distanceB, pointB, triB, nodeB);
+
+		if (hitA != hitB || (hitA && (pointA.getDistanceFrom(pointB) > 0.01f || !(triA == triB))))
+			numMismatch++;
+	}
+
+	return numMismatch;
+}
+
+// all triangles of b (that have a point in the box) are in a
+static bool containCollisionTriangles(core::array<core::triangle3df*>& a, core::array<core::triangle3df*>& b, const core::aabbox3df* box)
+{
+	for (u32 i = 0; i < b.size(); i++)
+	{
+		const core::triangle3df& tri = *b[i];
+
+		if (box && !box->isPointInside(tri.pointA) && !box->isPointInside(tri.pointB) && !box->isPointInside(tri.pointC))
+			continue;
+
+		bool found = false;
+		for (u32 j = 0; j < a.size() && !found; j++)
+			found = *a[j] == tri;
+
+		if (!found)
+			return false;
+	}
+	return true;
+}
+
+void testCollisionDynamicBVH()
+{
+	const int gridSize = 60;
+	const int numEntity = 300;
+	const float worldSize = gridSize * 2.0f * 0.5f;
+
+	CEntityManager* entityManager = new CEntityManager();
+
+	core::array<CEntity*> entities;
+	for (int i = 0; i < numEntity; i++)
+	{
+		CEntity* entity = entityManager->createEntity();
+		entity->addData<CWorldTransformData>();
+		moveCollisionEntity(entity, worldSize);
+		entities.push_back(entity);
+	}
+
+	CDynamicBVHBuilder* dynamic = new CDynamicBVHBuilder();
+	CBVHBuilder* bvh = new CBVHBuilder();
+
+	core::array<CCollisionNode*> nodes, bvhNodes;
+	createDynamicLevel(dynamic, entities, gridSize, nodes);
+	createDynamicLevel(bvh, entities, gridSize, bvhNodes);
+
+	core::array<core::line3df> rays;
+	createCollisionRays(rays, 1000, worldSize);
+
+	TEST_CASE("Collision dynamic BVH ray");
+	TEST_ASSERT_EQUAL((int)dynamic->getInstanceCount(), numEntity + 1);
+	TEST_ASSERT_THROW(compareCollisionRays(dynamic, bvh, rays) <= (int)rays.size() / 200);
+
+	TEST_CASE("Collision dynamic BVH refit");
+	{
+		TEST_ASSERT_EQUAL(dynamic->updateTransforms(), (u32)0);
+
+		CCollisionNode* unknown = new CCollisionNode(NULL, NULL, NULL);
+		TEST_ASSERT_THROW(dynamic->updateNode(unknown) == false);
+		delete unknown;
+
+		// move some nodes, the reference is the full rebuild
+		srand(4);
+
+		u32 numAuto = 0;
+		for (int i = 0; i < numEntity; i += 7)
+		{
+			moveCollisionEntity(entities[i], worldSize);
+
+			// the half is updated by the node, and the other by the check
+			if (i % 14 == 0)
+			{
+				TEST_ASSERT_THROW(dynamic->updateNode(nodes[i]));
+			}
+			else
+			{
+				numAuto++;
+			}
+		}
+
+		TEST_ASSERT_EQUAL(dynamic->updateTransforms(), numAuto);
+		bvh->build();
+
+		TEST_ASSERT_THROW(compareCollisionRays(dynamic, bvh, rays) <= (int)rays.size() / 200);
+
+		// the batch must match the single ray
+		core::array<SCollisionResult> results;
+		results.set_used(rays.size());
+		dynamic->getCollisionPoints(rays.pointer(), results.pointer(), (int)rays.size());
+
+		int numBatchMismatch = 0;
+		for (u32 i = 0; i < rays.size(); i++)
+		{
+			core::vector3df point;
+			core::triangle3df tri;
+			CCollisionNode* node = NULL;
+			f32 distance = rays[i].getLengthSQ();
+
+			bool hit = dynamic->getCollisionPoint(rays[i], distance, point, tri, node);
+			if (results[i].Hit != hit || (hit && (results[i].Node != node || results[i].Intersection.getDistanceFrom(point) > 0.001f)))
+				numBatchMismatch++;
+		}
+		TEST_ASSERT_EQUAL(numBatchMismatch, 0);
+	}
+
+	TEST_CASE("Collision dynamic BVH box");
+	{
+		srand(5);
+
+		for (int i = 0; i < 50; i++)
+		{
+			core::vector3df center(collisionRandom(-worldSize, worldSize), 0.0f, collisionRandom(-worldSize, worldSize));
+			core::vector3df size(collisionRandom(1.0f, 10.0f), collisionRandom(1.0f, 10.0f), collisionRandom(1.0f, 10.0f));
+			core::aabbox3df box(center - size, center + size);
+
+			core::array<core::triangle3df*> dynamicTris, bvhTris;
+			core::array<CCollisionNode*> dynamicNodes, bvhNodes;
+
+			dynamic->getTriangles(box, dynamicTris, dynamicNodes);
+			bvh->getTriangles(box, bvhTris, bvhNodes);
+
+			// the dynamic query tests the triangles in local space, so it skips some triangles that only the world bbox touches
+			TEST_ASSERT_THROW(dynamicTris.size() <= bvhTris.size());
+			TEST_ASSERT_THROW(containCollisionTriangles(bvhTris, dynamicTris, NULL));
+			TEST_ASSERT_THROW(containCollisionTriangles(dynamicTris, bvhTris, &box));
+			TEST_ASSERT_EQUAL(dynamicTris.size(), dynamicNodes.size());
+		}
+	}
+
+	TEST_CASE("Collision dynamic BVH moving");
+	{
+		const int numMove = 20;
+		const int numFrame = 50;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		for (int f = 0; f < numFrame; f++)
+		{
+			for (int i = 0; i < numMove; i++)
+			{
+				int id = (f * numMove + i) % numEntity;
+				moveCollisionEntity(entities[id], worldSize);
+				dynamic->updateNode(nodes[id]);
+			}
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		// the refit tree must match the rebuilt tree, the benchmark rebuilds it every frame
+		int numBuild = g_testBenchmark ? numFrame : 1;
+		for (int f = 0; f < numBuild; f++)
+			bvh->build();
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		TEST_ASSERT_THROW(compareCollisionRays(dynamic, bvh, rays) <= (int)rays.size() / 200);
+
+		if (g_testBenchmark)
+		{
+			printf("    %d nodes, %d moving nodes per frame: refit %.3fms, rebuild %.3fms\n",
+				numEntity + 1, numMove,
+				std::chrono::duration<double, std::milli>(t1 - t0).count() / numFrame,
+				std::chrono::duration<double, std::milli>(t2 - t1).count() / numFrame);
+		}
+	}
+
+	delete dynamic;
+	delete bvh;
+	delete entityManager;
+}
+
+void testCollisionBVH()
+{
+	const int gridSize = 100;
+	const int numBox = 500;
+	const float worldSize = gridSize * 2.0f * 0.5f;
+
+	COctreeBuilder* octree = new COctreeBuilder();
+	CBVHBuilder* bvh = new CBVHBuilder();
+
+	createCollisionLevel(octree, gridSize, numBox);
+	createCollisionLevel(bvh, gridSize, numBox);
+
+	TEST_CASE("Collision BVH build");
+	TEST_ASSERT_EQUAL((int)bvh->getTriangleCount(), gridSize * gridSize * 2 + numBox * 12);
+	TEST_ASSERT_THROW(bvh->getNodeCount() > 1);
+
+	core::array<core::line3df> rays;
+	createCollisionRays(rays, 2000, worldSize);
+
+	int numRay = (int)rays.size();
+
+	core::array<SCollisionResult> results;
+	results.set_used(numRay);
+	bvh->getCollisionPoints(rays.pointer(), results.pointer(), numRay);
+
+	TEST_CASE("Collision BVH ray");
+	{
+		int numHit = 0;
+		int numMismatch = 0;
+		int numPacketMismatch = 0;
+
+		for (int i = 0; i < numRay; i++)
+		{
+			const core::line3df& ray = rays[i];
+
+			core::vector3df octreePoint, bvhPoint;
+			core::triangle3df octreeTri, bvhTri;
+			CCollisionNode* octreeNode = NULL;
+			CCollisionNode* bvhNode = NULL;
+
+			f32 octreeDistance = ray.getLengthSQ();
+			f32 bvhDistance = ray.getLengthSQ();
+
+			bool octreeHit = octree->getCollisionPoint(ray, octreeDistance, octreePoint, octreeTri, octreeNode);
+			bool bvhHit = bvh->getCollisionPoint(ray, bvhDistance, bvhPoint, bvhTri, bvhNode);
+
+			if (bvhHit)
+				numHit++;
+
+			// the octree test is the line (not Moller-Trumbore), skip the edge cases
+			if (octreeHit != bvhHit || (bvhHit && octreePoint.getDistanceFrom(bvhPoint) > 0.01f))
+				numMismatch++;
+
+			// the packet must match the single ray
+			const SCollisionResult& r = results[i];
+			if (r.Hit != bvhHit || (bvhHit && (r.Node != bvhNode || r.Intersection.getDistanceFrom(bvhPoint) > 0.001f)))
+				numPacketMismatch++;
+		}
+
+		TEST_ASSERT_THROW(numHit > numRay / 2);
+		TEST_ASSERT_THROW(numMismatch <= numRay / 200);
+		TEST_ASSERT_EQUAL(numPacketMismatch, 0);
+	}
+
+	TEST_CASE("Collision BVH box");
+	{
+		srand(3);
+
+		for (int i = 0; i < 50; i++)
+		{
+			core::vector3df center(collisionRandom(-worldSize, worldSize), 0.0f, collisionRandom(-worldSize, worldSize));
+			core::vector3df size(collisionRandom(1.0f, 10.0f), collisionRandom(1.0f, 10.0f), collisionRandom(1.0f, 10.0f));
+			core::aabbox3df box(center - size, center + size);
+
+			core::array<core::triangle3df*> octreeTris, bvhTris;
+			core::array<CCollisionNode*> octreeNodes, bvhNodes;
+
+			octree->getTriangles(box, octreeTris, octreeNodes);
+			bvh->getTriangles(box, bvhTris, bvhNodes);
+
+			TEST_ASSERT_EQUAL(octreeTris.size(), bvhTris.size());
+			TEST_ASSERT_EQUAL(bvhTris.size(), bvhNodes.size());
+		}
+	}
+
+	delete octree;
+	delete bvh;
+
+	if (g_testBenchmark)
+	{
+		TEST_CASE("Collision BVH benchmark");
+
+		const int benchGrid = 200;
+		const float benchSize = benchGrid * 2.0f * 0.5f;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		octree = new COctreeBuilder();
+		createCollisionLevel(octree, benchGrid, 2000);
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		bvh = new CBVHBuilder();
+		createCollisionLevel(bvh, benchGrid, 2000);
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		rays.clear();
+		createCollisionRays(rays, 2000, benchSize);
+		numRay = (int)rays.size();
+		results.set_used(numRay);
+
+		core::vector3df point;
+		core::triangle3df tri;
+		CCollisionNode* node;
+		int octreeHit = 0, bvhHit = 0, packetHit = 0;
+
+		auto t3 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numRay; i++)
+		{
+			f32 distance = rays[i].getLengthSQ();
+			if (octree->getCollisionPoint(rays[i], distance, point, tri, node))
+				octreeHit++;
+		}
+
+		auto t4 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numRay; i++)
+		{
+			f32 distance = rays[i].getLengthSQ();
+			if (bvh->getCollisionPoint(rays[i], distance, point, tri, node))
+				bvhHit++;
+		}
+
+		auto t5 = std::chrono::high_resolution_clock::now();
+
+		bvh->getCollisionPoints(rays.pointer(), results.pointer(), numRay);
+
+		auto t6 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numRay; i++)
+		{
+			if (results[i].Hit)
+				packetHit++;
+		}
+
+		TEST_ASSERT_EQUAL(bvhHit, packetHit);
+
+		auto ms = [](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b)
+			{
+				return std::chrono::duration<double, std::milli>(b - a).count();
+			};
+
+		printf("    %d triangles, build: octree %.1fms, bvh %.1fms (%d nodes)\n",
+			(int)bvh->getTriangleCount(), ms(t0, t1), ms(t1, t2), (int)bvh->getNodeCount());
+		printf("    %d rays: octree %.2fms (%d hits), bvh %.2fms, bvh packets %.2fms (%d hits)\n",
+			numRay, ms(t3, t4), octreeHit, ms(t4, t5), ms(t5, t6), bvhHit);
+
+		delete octree;
+		delete bvh;
+	}
+
+	testCollisionDynamicBVH();
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Base.hh"
+#include "Collision/COctreeBuilder.h"
+#include "Collision/CBVHBuilder.h"
+#include "Collision/CDynamicBVHBuilder.h"
+
+void testCollisionBVH();
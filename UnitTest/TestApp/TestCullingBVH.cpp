@@ -0,0 +1,206 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCullingBVH.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static float randomRange(float min, float max)
+{
+	return min + (max - min) * (float)(rand() % 10000) / 10000.0f;
+}
+
+static core::aabbox3df randomBox(float worldSize)
+{
+	core::vector3df center(
+		randomRange(-worldSize, worldSize),
+		randomRange(-worldSize * 0.1f, worldSize * 0.1f),
+		randomRange(-worldSize, worldSize));
+
+	core::vector3df size(
+		randomRange(0.5f, 5.0f),
+		randomRange(0.5f, 5.0f),
+		randomRange(0.5f, 5.0f));
+
+	return core::aabbox3df(center - size, center + size);
+}
+
+static int queryLinear(core::array<core::aabbox3df>& boxes, const core::aabbox3df& box)
+{
+	int count = 0;
+	for (u32 i = 0, n = boxes.size(); i < n; i++)
+	{
+		if (boxes[i].intersectsWithBox(box))
+			count++;
+	}
+	return count;
+}
+
+static int queryBVH(CCullingBVH* bvh, core::array<core::aabbox3df>& boxes, const core::aabbox3df& box, CFastArray<int>& inside, CFastArray<int>& intersect)
+{
+	bvh->query(box, inside, intersect);
+
+	int count = inside.count();
+
+	int* leaves = intersect.pointer();
+	for (int i = 0, n = intersect.count(); i < n; i++)
+	{
+		int id = (int)(size_t)bvh->getUserData(leaves[i]);
+		if (boxes[id].intersectsWithBox(box))
+			count++;
+	}
+	return count;
+}
+
+static void testCullingQuery(int numBoxes)
+{
+	srand(0);
+
+	float worldSize = 2000.0f;
+
+	core::array<core::aabbox3df> boxes;
+	boxes.reallocate(numBoxes);
+
+	CCullingBVH* bvh = new CCullingBVH();
+
+	for (int i = 0; i < numBoxes; i++)
+	{
+		boxes.push_back(randomBox(worldSize));
+		bvh->insert(boxes[i], (void*)(size_t)i);
+	}
+
+	// the camera box see about 5% of the world
+	core::aabbox3df cameraBox(
+		core::vector3df(-200.0f, -500.0f, 0.0f),
+		core::vector3df(200.0f, 500.0f, 1000.0f));
+
+	CFastArray<int> inside;
+	CFastArray<int> intersect;
+
+	int linearCount = queryLinear(boxes, cameraBox);
+	int bvhCount = queryBVH(bvh, boxes, cameraBox, inside, intersect);
+
+	TEST_ASSERT_EQUAL(linearCount, bvhCount);
+
+	delete bvh;
+}
+
+static void benchmarkCulling(int numBoxes)
+{
+	srand(0);
+
+	float worldSize = 2000.0f;
+
+	core::array<core::aabbox3df> boxes;
+	boxes.reallocate(numBoxes);
+
+	CCullingBVH* bvh = new CCullingBVH();
+
+	for (int i = 0; i < numBoxes; i++)
+	{
+		boxes.push_back(randomBox(worldSize));
+		bvh->insert(boxes[i], (void*)(size_t)i);
+	}
+
+	core::aabbox3df cameraBox(
+		core::vector3df(-200.0f, -500.0f, 0.0f),
+		core::vector3df(200.0f, 500.0f, 1000.0f));
+
+	CFastArray<int> inside;
+	CFastArray<int> intersect;
+
+	const int numQuery = 10;
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	int linearCount = 0;
+	for (int i = 0; i < numQuery; i++)
+		linearCount = queryLinear(boxes, cameraBox);
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	int bvhCount = 0;
+	for (int i = 0; i < numQuery; i++)
+		bvhCount = queryBVH(bvh, boxes, cameraBox, inside, intersect);
+
+	auto t2 = std::chrono::high_resolution_clock::now();
+
+	TEST_ASSERT_EQUAL(linearCount, bvhCount);
+
+	double linearTime = std::chrono::duration<double, std::milli>(t1 - t0).count() / numQuery;
+	double bvhTime = std::chrono::duration<double, std::milli>(t2 - t1).count() / numQuery;
+
+	printf("    %d boxes (%d visible, tree height %d): linear %.3fms, bvh %.3fms\n",
+		numBoxes, bvhCount, bvh->getHeight(), linearTime, bvhTime);
+
+	delete bvh;
+}
+
+void testCullingBVH()
+{
+	TEST_CASE("Culling BVH insert");
+	srand(0);
+
+	const int numBoxes = 2000;
+	core::array<core::aabbox3df> boxes;
+	core::array<int> proxies;
+
+	CCullingBVH* bvh = new CCullingBVH();
+	for (int i = 0; i < numBoxes; i++)
+	{
+		boxes.push_back(randomBox(200.0f));
+		proxies.push_back(bvh->insert(boxes[i], (void*)(size_t)i));
+	}
+
+	TEST_ASSERT_EQUAL(bvh->getNumLeaf(), numBoxes);
+
+	// balanced tree
+	TEST_ASSERT_THROW(bvh->getHeight() < 32);
+
+	CFastArray<int> inside;
+	CFastArray<int> intersect;
+
+	core::aabbox3df cameraBox(core::vector3df(-50.0f, -50.0f, -50.0f), core::vector3df(50.0f, 50.0f, 50.0f));
+	TEST_ASSERT_EQUAL(queryBVH(bvh, boxes, cameraBox, inside, intersect), queryLinear(boxes, cameraBox));
+
+	TEST_CASE("Culling BVH update");
+	for (int i = 0; i < numBoxes; i += 3)
+	{
+		core::vector3df offset(randomRange(-100.0f, 100.0f), 0.0f, randomRange(-100.0f, 100.0f));
+		boxes[i].MinEdge += offset;
+		boxes[i].MaxEdge += offset;
+		bvh->update(proxies[i], boxes[i]);
+	}
+
+	for (int i = 0; i < numBoxes; i++)
+		TEST_ASSERT_THROW(boxes[i].isFullInside(bvh->getFatBox(proxies[i])));
+
+	TEST_ASSERT_EQUAL(queryBVH(bvh, boxes, cameraBox, inside, intersect), queryLinear(boxes, cameraBox));
+
+	TEST_CASE("Culling BVH remove");
+	for (int i = 0; i < numBoxes; i += 2)
+	{
+		bvh->remove(proxies[i]);
+
+		// move out of the camera box
+		boxes[i] = core::aabbox3df(core::vector3df(10000.0f), core::vector3df(10001.0f));
+	}
+
+	TEST_ASSERT_EQUAL(bvh->getNumLeaf(), numBoxes / 2);
+	TEST_ASSERT_EQUAL(queryBVH(bvh, boxes, cameraBox, inside, intersect), queryLinear(boxes, cameraBox));
+
+	delete bvh;
+
+	TEST_CASE("Culling BVH query");
+	testCullingQuery(10000);
+	testCullingQuery(100000);
+
+	if (g_testBenchmark)
+	{
+		TEST_CASE("Culling BVH benchmark");
+		benchmarkCulling(10000);
+		benchmarkCulling(100000);
+		benchmarkCulling(1000000);
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Culling/CCullingBVH.h"
+
+void testCullingBVH();
@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCullingKernel.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static float randomValue(float min, float max)
+{
+	return min + (max - min) * (float)(rand() % 10000) / 10000.0f;
+}
+
+static bool isBoxOutsideFrustum(const core::aabbox3df& box, const SViewFrustum& frustum)
+{
+	core::vector3df edges[8];
+	box.getEdges(edges);
+
+	for (s32 i = 0; i < SViewFrustum::VF_PLANE_COUNT; ++i)
+	{
+		bool boxInFrustum = false;
+		for (u32 j = 0; j < 8; ++j)
+		{
+			if (frustum.planes[i].classifyPointRelation(edges[j]) != core::ISREL3D_FRONT)
+			{
+				boxInFrustum = true;
+				break;
+			}
+		}
+
+		if (!boxInFrustum)
+			return true;
+	}
+	return false;
+}
+
+void testCullingKernel()
+{
+	srand(0);
+
+	const int numBoxes = 1003;
+
+	core::array<core::aabbox3df> localBoxes;
+	core::array<core::matrix4> worlds;
+
+	for (int i = 0; i < numBoxes; i++)
+	{
+		core::vector3df center(randomValue(-10.0f, 10.0f), randomValue(-10.0f, 10.0f), randomValue(-10.0f, 10.0f));
+		core::vector3df size(randomValue(0.1f, 3.0f), randomValue(0.1f, 3.0f), randomValue(0.1f, 3.0f));
+		localBoxes.push_back(core::aabbox3df(center - size, center + size));
+
+		core::matrix4 world;
+		world.setRotationDegrees(core::vector3df(randomValue(0.0f, 360.0f), randomValue(0.0f, 360.0f), randomValue(0.0f, 360.0f)));
+		world.setTranslation(core::vector3df(randomValue(-200.0f, 200.0f), randomValue(-20.0f, 20.0f), randomValue(-200.0f, 200.0f)));
+		world.setScale(randomValue(0.5f, 2.0f));
+		worlds.push_back(world);
+	}
+
+	CCullingKernel kernel;
+
+	TEST_CASE("Culling kernel transform box");
+	for (int i = 0; i < numBoxes; i++)
+		kernel.addBox(localBoxes[i], worlds[i]);
+	kernel.transformBoxes();
+
+	core::array<core::aabbox3df> worldBoxes;
+	for (int i = 0; i < numBoxes; i++)
+	{
+		core::aabbox3df box = localBoxes[i];
+		worlds[i].transformBoxEx(box);
+		worldBoxes.push_back(box);
+
+		core::aabbox3df result;
+		kernel.getBox(i, result);
+
+		float epsilon = 0.001f;
+		TEST_ASSERT_THROW(result.MinEdge.equals(box.MinEdge, epsilon));
+		TEST_ASSERT_THROW(result.MaxEdge.equals(box.MaxEdge, epsilon));
+	}
+
+	// camera look at +z
+	core::matrix4 projection, view;
+	projection.buildProjectionMatrixPerspectiveFovLH(core::PI / 3.0f, 16.0f / 9.0f, 0.1f, 150.0f);
+	view.buildCameraLookAtMatrixLH(core::vector3df(0.0f, 5.0f, -50.0f), core::vector3df(30.0f, 0.0f, 0.0f), core::vector3df(0.0f, 1.0f, 0.0f));
+
+	SViewFrustum frustum(projection * view);
+	const core::aabbox3df& cameraBox = frustum.getBoundingBox();
+
+	TEST_CASE("Culling kernel intersect box");
+	kernel.reset();
+	for (int i = 0; i < numBoxes; i++)
+		kernel.addBox(worldBoxes[i]);
+
+	kernel.intersectBox(cameraBox);
+
+	u8* result = kernel.getResult();
+	for (int i = 0; i < numBoxes; i++)
+		TEST_ASSERT_EQUAL((bool)result[i], worldBoxes[i].intersectsWithBox(cameraBox));
+
+	TEST_CASE("Culling kernel intersect frustum");
+	kernel.intersectFrustum(frustum);
+
+	int numVisible = 0;
+	for (int i = 0; i < numBoxes; i++)
+	{
+		bool visible = worldBoxes[i].intersectsWithBox(cameraBox) && !isBoxOutsideFrustum(worldBoxes[i], frustum);
+		TEST_ASSERT_EQUAL((bool)result[i], visible);
+
+		if (visible)
+			numVisible++;
+	}
+	TEST_ASSERT_THROW(numVisible > 0 && numVisible < numBoxes);
+
+	TEST_CASE("Culling kernel match scalar");
+
+	// loop & print the time in the benchmark mode
+	const int numLoop = g_testBenchmark ? 100 : 1;
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	int scalarVisible = 0;
+	for (int loop = 0; loop < numLoop; loop++)
+	{
+		scalarVisible = 0;
+		for (int i = 0; i < numBoxes; i++)
+		{
+			core::aabbox3df box = localBoxes[i];
+			worlds[i].transformBoxEx(box);
+
+			if (box.intersectsWithBox(cameraBox) && !isBoxOutsideFrustum(box, frustum))
+				scalarVisible++;
+		}
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	int kernelVisible = 0;
+	for (int loop = 0; loop < numLoop; loop++)
+	{
+		kernel.reset();
+		for (int i = 0; i < numBoxes; i++)
+			kernel.addBox(localBoxes[i], worlds[i]);
+
+		kernel.transformBoxes();
+		kernel.intersectBox(cameraBox);
+		kernel.intersectFrustum(frustum);
+
+		kernelVisible = 0;
+		result = kernel.getResult();
+		for (int i = 0; i < numBoxes; i++)
+			kernelVisible += result[i];
+	}
+
+	auto t2 = std::chrono::high_resolution_clock::now();
+
+	TEST_ASSERT_EQUAL(scalarVisible, kernelVisible);
+
+	if (g_testBenchmark)
+	{
+		double scalarTime = std::chrono::duration<double, std::milli>(t1 - t0).count() / numLoop;
+		double kernelTime = std::chrono::duration<double, std::milli>(t2 - t1).count() / numLoop;
+		printf("    %d boxes: scalar %.3fms, kernel %.3fms\n", numBoxes, scalarTime, kernelTime);
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Culling/CCullingKernel.h"
+
+void testCullingKernel();
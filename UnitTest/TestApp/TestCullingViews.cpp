@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCullingViews.h"
+#include "Culling/CCullingBBoxData.h"
+#include "RenderPipeline/CForwardRP.h"
+
+using namespace Skylicht;
+
+static float randomViewPosition(float size)
+{
+	return -size + 2.0f * size * (float)(rand() % 10000) / 10000.0f;
+}
+
+static bool isOutsideViewFrustum(const core::aabbox3df& box, const SViewFrustum& frustum)
+{
+	core::vector3df edges[8];
+	box.getEdges(edges);
+
+	for (s32 i = 0; i < SViewFrustum::VF_PLANE_COUNT; ++i)
+	{
+		bool inside = false;
+		for (u32 j = 0; j < 8; ++j)
+		{
+			if (frustum.planes[i].classifyPointRelation(edges[j]) != core::ISREL3D_FRONT)
+			{
+				inside = true;
+				break;
+			}
+		}
+
+		if (!inside)
+			return true;
+	}
+	return false;
+}
+
+static bool testViews(CEntityManager* entityManager, CCullingSystem* culling, core::array<CEntity*>& entities, core::array<core::aabbox3df>& boxes, core::array<SCullingView>& views)
+{
+	culling->beginViews();
+	for (u32 v = 0; v < views.size(); v++)
+	{
+		if (views[v].UseFrustum)
+			culling->addView(views[v].Frustum);
+		else
+			culling->addView(views[v].Box);
+	}
+
+	bool pass = culling->getNumViews() == (int)views.size();
+
+	for (u32 v = 0; v < views.size(); v++)
+	{
+		culling->setCurrentView(v);
+		culling->onQuery(entityManager, NULL, 0);
+		culling->update(entityManager);
+
+		for (u32 i = 0; i < entities.size(); i++)
+		{
+			CCullingData* data = GET_ENTITY_DATA(entities[i], CCullingData);
+
+			bool visible = boxes[i].intersectsWithBox(views[v].Box);
+			if (visible && views[v].UseFrustum)
+				visible = !isOutsideViewFrustum(boxes[i], views[v].Frustum);
+
+			if (data->Visible != visible)
+				pass = false;
+
+			if (((data->ViewMask >> v) & 1) != (visible ? 1 : 0))
+				pass = false;
+		}
+	}
+
+	culling->endViews();
+	return pass && culling->getCurrentView() == -1;
+}
+
+void testCullingViews()
+{
+	srand(0);
+
+	CEntityManager* entityManager = new CEntityManager();
+	CForwardRP* rp = new CForwardRP();
+	entityManager->setRenderPipeline(rp);
+
+	CCullingSystem* culling = entityManager->getSystem<CCullingSystem>();
+
+	const int numEntity = 2000;
+	const float worldSize = 200.0f;
+
+	core::array<CEntity*> entities;
+	core::array<core::aabbox3df> boxes;
+
+	for (int i = 0; i < numEntity; i++)
+	{
+		CEntity* entity = entityManager->createEntity();
+		entity->addData<CVisibleData>();
+		entity->addData<CCullingData>();
+
+		CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+		CCullingBBoxData* bbox = entity->addData<CCullingBBoxData>();
+
+		core::vector3df position(
+			randomViewPosition(worldSize),
+			randomViewPosition(worldSize),
+			randomViewPosition(worldSize));
+
+		bbox->BBox = core::aabbox3df(core::vector3df(-1.0f), core::vector3df(1.0f));
+		transform->Relative.setTranslation(position);
+		transform->World.setTranslation(position);
+
+		entities.push_back(entity);
+		boxes.push_back(core::aabbox3df(position - core::vector3df(1.0f), position + core::vector3df(1.0f)));
+	}
+
+	culling->beginQuery(entityManager);
+	entityManager->update();
+
+	// the boxes of shadow cascades, and the frustums of 2 cube faces
+	core::array<SCullingView> views;
+
+	float cascade[] = { 25.0f, 50.0f, 100.0f, 180.0f };
+	for (int i = 0; i < 4; i++)
+	{
+		SCullingView view;
+		view.Box = core::aabbox3df(core::vector3df(-cascade[i]), core::vector3df(cascade[i]));
+		views.push_back(view);
+	}
+
+	core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(90.0f * core::DEGTORAD, 1.0f, 0.1f, 150.0f);
+
+	core::vector3df target[] = { core::vector3df(0.0f, 0.0f, 1.0f), core::vector3df(1.0f, 0.0f, 0.0f) };
+	for (int i = 0; i < 2; i++)
+	{
+		core::matrix4 view;
+		view.buildCameraLookAtMatrixLH(core::vector3df(0.0f), target[i] * 100.0f, core::vector3df(0.0f, 1.0f, 0.0f));
+
+		SCullingView cullingView;
+		cullingView.Frustum.setFrom(projection * view);
+		cullingView.Box = cullingView.Frustum.getBoundingBox();
+		cullingView.UseFrustum = true;
+		views.push_back(cullingView);
+	}
+
+	TEST_CASE("Culling views with BVH");
+	CCullingSystem::useCullingBVH(true);
+	TEST_ASSERT_THROW(testViews(entityManager, culling, entities, boxes, views));
+
+	TEST_CASE("Culling views linear");
+	CCullingSystem::useCullingBVH(false);
+	TEST_ASSERT_THROW(testViews(entityManager, culling, entities, boxes, views));
+	CCullingSystem::useCullingBVH(true);
+
+	TEST_CASE("Culling views after moving");
+	for (int i = 0; i < numEntity; i += 4)
+	{
+		core::vector3df position(
+			randomViewPosition(worldSize),
+			randomViewPosition(worldSize),
+			randomViewPosition(worldSize));
+
+		CWorldTransformData* transform = GET_ENTITY_DATA(entities[i], CWorldTransformData);
+		transform->Relative.setTranslation(position);
+		transform->HasChanged = true;
+
+		boxes[i] = core::aabbox3df(position - core::vector3df(1.0f), position + core::vector3df(1.0f));
+	}
+	entityManager->update();
+	TEST_ASSERT_THROW(testViews(entityManager, culling, entities, boxes, views));
+
+	TEST_CASE("Culling views limit");
+	culling->beginViews();
+	for (int i = 0; i < CCullingSystem::MaxViews; i++)
+		culling->addView(views[0].Box);
+	TEST_ASSERT_EQUAL(culling->addView(views[0].Box), -1);
+	culling->endViews();
+
+	delete entityManager;
+	delete rp;
+}
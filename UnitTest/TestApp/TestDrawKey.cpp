@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestDrawKey.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace Skylicht;
+
+static u64 randomKey()
+{
+	return ((u64)(rand() & 0xffff) << 48) |
+		((u64)(rand() & 0xffff) << 32) |
+		((u64)(rand() & 0xffff) << 16) |
+		(u64)(rand() & 0xffff);
+}
+
+static bool isSortedStable(SDrawKey* keys, u32 count)
+{
+	for (u32 i = 1; i < count; i++)
+	{
+		if (keys[i - 1].Key > keys[i].Key)
+			return false;
+
+		// same key must keep the list order
+		if (keys[i - 1].Key == keys[i].Key && keys[i - 1].Index > keys[i].Index)
+			return false;
+	}
+	return true;
+}
+
+struct STestTexture
+{
+	int Id;
+};
+
+struct STestMaterial
+{
+	STestTexture* Texture;
+};
+
+struct STestDraw
+{
+	STestMaterial* Material;
+	IMeshBuffer* MeshBuffer;
+};
+
+static int cmpTestDrawFunc(const void* a, const void* b)
+{
+	STestDraw* pa = *((STestDraw**)a);
+	STestDraw* pb = *((STestDraw**)b);
+
+	STestTexture* textureA = pa->Material->Texture;
+	STestTexture* textureB = pb->Material->Texture;
+
+	if (textureA == textureB)
+	{
+		if (pa->MeshBuffer == pb->MeshBuffer)
+			return 0;
+		return pa->MeshBuffer < pb->MeshBuffer ? -1 : 1;
+	}
+
+	return textureA < textureB ? -1 : 1;
+}
+
+void testDrawKey()
+{
+	TEST_CASE("Draw key radix sort");
+	{
+		u32 counts[] = { 0, 1, 7, 32, 33, 1000, 10000 };
+		for (u32 c : counts)
+		{
+			core::array<SDrawKey> keys;
+			core::array<SDrawKey> temp;
+			keys.set_used(c);
+			temp.set_used(c);
+
+			for (u32 i = 0; i < c; i++)
+			{
+				// few distinct keys, so the stable order is tested
+				keys[i].Key = randomKey() % 97;
+				keys[i].Index = i;
+			}
+
+			SDrawKey* result = CDrawKey::sort(keys.pointer(), temp.pointer(), c);
+			TEST_ASSERT_THROW(isSortedStable(result, c));
+		}
+
+		// all digits differ
+		core::array<SDrawKey> keys;
+		core::array<SDrawKey> temp;
+		std::vector<u64> reference;
+		for (u32 i = 0; i < 5000; i++)
+		{
+			SDrawKey k;
+			k.Key = randomKey();
+			k.Index = i;
+			keys.push_back(k);
+			reference.push_back(k.Key);
+		}
+		temp.set_used(keys.size());
+
+		std::sort(reference.begin(), reference.end());
+
+		SDrawKey* result = CDrawKey::sort(keys.pointer(), temp.pointer(), keys.size());
+		for (u32 i = 0; i < keys.size(); i++)
+			TEST_ASSERT_THROW(result[i].Key == reference[i]);
+	}
+
+	TEST_CASE("Draw key order");
+	{
+		IMeshBuffer* mbA = (IMeshBuffer*)(size_t)0x10000;
+		IMeshBuffer* mbB = (IMeshBuffer*)(size_t)0x20000;
+
+		u32 nearDepth = CDrawKey::getDepthBucket(5.0f, 1000.0f, 8);
+		u32 farDepth = CDrawKey::getDepthBucket(500.0f, 1000.0f, 8);
+
+		TEST_ASSERT_THROW(nearDepth < farDepth);
+		TEST_ASSERT_EQUAL(CDrawKey::getDepthBucket(5000.0f, 1000.0f, 8), 255);
+		TEST_ASSERT_EQUAL(CDrawKey::getDepthBucket(-1.0f, 1000.0f, 8), 0);
+
+		// opaque: the same mesh is front to back, the mesh is before the depth
+		TEST_ASSERT_THROW(CDrawKey::makeOpaqueKey(NULL, mbA, nearDepth) < CDrawKey::makeOpaqueKey(NULL, mbA, farDepth));
+		TEST_ASSERT_THROW(
+			(CDrawKey::makeOpaqueKey(NULL, mbA, 0) < CDrawKey::makeOpaqueKey(NULL, mbB, 0)) ==
+			(CDrawKey::makeOpaqueKey(NULL, mbA, 255) < CDrawKey::makeOpaqueKey(NULL, mbB, 0)));
+
+		// transparent: after all opaque, back to front
+		u32 nearTransparent = CDrawKey::getDepthBucket(5.0f, 1000.0f, 16);
+		u32 farTransparent = CDrawKey::getDepthBucket(500.0f, 1000.0f, 16);
+
+		TEST_ASSERT_THROW(CDrawKey::makeOpaqueKey(NULL, mbA, 255) < CDrawKey::makeTransparentKey(NULL, mbA, 0));
+		TEST_ASSERT_THROW(CDrawKey::makeTransparentKey(NULL, mbA, farTransparent) < CDrawKey::makeTransparentKey(NULL, mbB, nearTransparent));
+		TEST_ASSERT_THROW(CDrawKey::makeTransparentKey(NULL, mbB, farTransparent) < CDrawKey::makeTransparentKey(NULL, mbA, nearTransparent));
+	}
+
+	TEST_CASE("Draw key sort list");
+	{
+		core::array<IMeshBuffer*> list;
+		for (u32 i = 0; i < 200; i++)
+			list.push_back((IMeshBuffer*)(size_t)(((rand() % 10) + 1) * 0x10000));
+
+		core::array<SDrawKey> keys, temp;
+		core::array<IMeshBuffer*> sorted;
+
+		CDrawKey::sortList(list, keys, temp, sorted,
+			[](IMeshBuffer* mb)
+			{
+				return CDrawKey::makeOpaqueKey(NULL, mb, 0);
+			});
+
+		// the same mesh buffers are batched
+		TEST_ASSERT_EQUAL(list.size(), 200);
+		u32 numBatch = 1;
+		for (u32 i = 1; i < list.size(); i++)
+		{
+			if (list[i] != list[i - 1])
+				numBatch++;
+		}
+		TEST_ASSERT_THROW(numBatch <= 10);
+	}
+
+	TEST_CASE("Draw key texture batch");
+	{
+		const int numDraw = 10000;
+		const int numTexture = 64;
+		const int numMesh = 200;
+
+		core::array<STestTexture*> textures;
+		core::array<STestMaterial*> materials;
+		for (int i = 0; i < numTexture; i++)
+		{
+			textures.push_back(new STestTexture{ i });
+			materials.push_back(new STestMaterial{ textures[i] });
+		}
+
+		core::array<STestDraw*> draws;
+		for (int i = 0; i < numDraw; i++)
+		{
+			STestDraw* d = new STestDraw();
+			d->Material = materials[rand() % numTexture];
+			d->MeshBuffer = (IMeshBuffer*)(size_t)((rand() % numMesh + 1) * 0x100);
+			draws.push_back(d);
+		}
+
+		// the benchmark compares with qsort on the loops
+		const int numLoop = g_testBenchmark ? 20 : 1;
+		core::array<STestDraw*> list;
+		core::array<STestDraw*> sorted;
+		core::array<SDrawKey> keys, temp;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		if (g_testBenchmark)
+		{
+			for (int l = 0; l < numLoop; l++)
+			{
+				list = draws;
+				qsort(list.pointer(), list.size(), sizeof(STestDraw*), cmpTestDrawFunc);
+			}
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		for (int l = 0; l < numLoop; l++)
+		{
+			list = draws;
+			CDrawKey::sortList(list, keys, temp, sorted,
+				[](STestDraw* d)
+				{
+					u64 key = (u64)CDrawKey::getPointerID(d->Material->Texture, 14) << 24;
+					key |= (u64)CDrawKey::getPointerID(d->MeshBuffer, 16) << 8;
+					return key;
+				});
+		}
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		// the sorted list is batched by texture
+		u32 numTextureChange = 1;
+		for (u32 i = 1; i < list.size(); i++)
+		{
+			if (list[i]->Material->Texture != list[i - 1]->Material->Texture)
+				numTextureChange++;
+		}
+		TEST_ASSERT_THROW(numTextureChange <= (u32)numTexture);
+
+		if (g_testBenchmark)
+		{
+			printf("    %d draws: qsort %.3fms, draw key %.3fms\n",
+				numDraw,
+				std::chrono::duration<double, std::milli>(t1 - t0).count() / numLoop,
+				std::chrono::duration<double, std::milli>(t2 - t1).count() / numLoop);
+		}
+
+		for (u32 i = 0; i < draws.size(); i++)
+			delete draws[i];
+		for (int i = 0; i < numTexture; i++)
+		{
+			delete materials[i];
+			delete textures[i];
+		}
+	}
+}
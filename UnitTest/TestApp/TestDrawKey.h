@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "RenderMesh/CDrawKey.h"
+
+void testDrawKey();
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestEntityDataStorage.h"
+#include "Transform/CWorldTransformData.h"
+#include "Culling/CVisibleData.h"
+
+using namespace Skylicht;
+
+// a derived data that is added on the index of CVisibleData (as CSphereData on CRenderMeshData)
+class CTestBigVisibleData : public CVisibleData
+{
+public:
+	float Extra[64];
+};
+
+class alignas(64) CTestAlignedVisibleData : public CVisibleData
+{
+public:
+	float Value;
+};
+
+static void testEntityDataStorageDerived()
+{
+	CEntityManager* entityManager = new CEntityManager();
+	entityManager->enableDataChunkStorage(true);
+
+	CEntityDataStorage* storage = entityManager->getDataStorage();
+	u32 visibleType = DATA_TYPE_INDEX(CVisibleData);
+
+	core::array<CEntity*> entities;
+	entityManager->createEntity(4, entities);
+
+	TEST_CASE("Entity data storage bigger derived data");
+	// the entities have the default CVisibleData on the storage
+	u32 stride = storage->getStride(visibleType);
+	TEST_ASSERT_EQUAL(storage->getNumAlive(visibleType), (u32)4);
+
+	// the big data does not fit the slot, it is on the heap
+	CTestBigVisibleData* big = entities[1]->addData<CTestBigVisibleData>(visibleType);
+	TEST_ASSERT_THROW(big != NULL);
+	TEST_ASSERT_EQUAL(storage->getNumAlive(visibleType), (u32)3);
+	TEST_ASSERT_EQUAL(storage->getStride(visibleType), stride);
+
+	for (int i = 0; i < 64; i++)
+		big->Extra[i] = (float)i;
+
+	// the next slot is not overwritten
+	CVisibleData* next = entities[2]->addData<CVisibleData>();
+	TEST_ASSERT_EQUAL(storage->getNumAlive(visibleType), (u32)3);
+	next->Visible = false;
+	TEST_ASSERT_THROW(big->Extra[0] == 0.0f && big->Extra[63] == 63.0f);
+
+	TEST_CASE("Entity data storage aligned data");
+	CTestAlignedVisibleData* aligned = entities[3]->addData<CTestAlignedVisibleData>(visibleType);
+	TEST_ASSERT_THROW(((size_t)aligned & 63) == 0);
+	TEST_ASSERT_EQUAL(storage->getNumAlive(visibleType), (u32)2);
+
+	entityManager->releaseAllEntities();
+	TEST_ASSERT_EQUAL(storage->getNumAlive(visibleType), (u32)0);
+	delete entityManager;
+
+	// the pool of the aligned type
+	entityManager = new CEntityManager();
+	entityManager->enableDataChunkStorage(true);
+	storage = entityManager->getDataStorage();
+
+	u32 alignedType = CEntityDataTypeManager::getDataIndex(typeid(CTestAlignedVisibleData));
+
+	entities.set_used(0);
+	entityManager->createEntity(8, entities);
+	for (u32 i = 0; i < entities.size(); i++)
+	{
+		aligned = entities[i]->addData<CTestAlignedVisibleData>(alignedType);
+		TEST_ASSERT_THROW(((size_t)aligned & 63) == 0);
+	}
+	TEST_ASSERT_EQUAL(storage->getNumAlive(alignedType), entities.size());
+	TEST_ASSERT_EQUAL(storage->getStride(alignedType) % 64, (u32)0);
+
+	entityManager->releaseAllEntities();
+	delete entityManager;
+}
+
+void testEntityDataStorage()
+{
+	CEntityManager* entityManager = new CEntityManager();
+
+	TEST_CASE("Entity data storage enable");
+	TEST_ASSERT_THROW(entityManager->enableDataChunkStorage(true));
+
+	CEntityDataStorage* storage = entityManager->getDataStorage();
+	TEST_ASSERT_THROW(storage != NULL);
+
+	const int numEntity = 300;
+	core::array<CEntity*> entities;
+	entityManager->createEntity(numEntity, entities);
+
+	TEST_CASE("Entity data storage can not disable when have entities");
+	TEST_ASSERT_THROW(entityManager->enableDataChunkStorage(false) == false);
+
+	TEST_CASE("Entity data storage contiguous");
+	u32 transformType = DATA_TYPE_INDEX(CWorldTransformData);
+	for (int i = 0; i < numEntity; i++)
+		entities[i]->addData<CWorldTransformData>();
+
+	u32 stride = storage->getStride(transformType);
+	TEST_ASSERT_THROW(stride >= sizeof(CWorldTransformData));
+	TEST_ASSERT_EQUAL(storage->getNumAlive(transformType), (u32)numEntity);
+
+	u32 capacity = storage->getChunkCapacity();
+	TEST_ASSERT_EQUAL(storage->getNumChunks(transformType), (numEntity + capacity - 1) / capacity);
+
+	for (int i = 1; i < (int)capacity && i < numEntity; i++)
+	{
+		u8* a = (u8*)GET_ENTITY_DATA(entities[i - 1], CWorldTransformData);
+		u8* b = (u8*)GET_ENTITY_DATA(entities[i], CWorldTransformData);
+		TEST_ASSERT_THROW(b - a == (int)stride);
+	}
+
+	TEST_CASE("Entity data storage reuse slot");
+	CWorldTransformData* data = GET_ENTITY_DATA(entities[10], CWorldTransformData);
+	TEST_ASSERT_THROW(entities[10]->removeData<CWorldTransformData>());
+	TEST_ASSERT_EQUAL(storage->getNumAlive(transformType), (u32)numEntity - 1);
+
+	CWorldTransformData* newData = entities[10]->addData<CWorldTransformData>();
+	TEST_ASSERT_THROW(newData == data);
+	TEST_ASSERT_THROW(newData->Entity == entities[10]);
+	TEST_ASSERT_THROW(GET_ENTITY_DATA(entities[10], CWorldTransformData) == newData);
+
+	TEST_CASE("Entity data storage release");
+	entityManager->releaseAllEntities();
+	TEST_ASSERT_EQUAL(storage->getNumAlive(transformType), (u32)0);
+	TEST_ASSERT_EQUAL(storage->getNumAlive(DATA_TYPE_INDEX(CVisibleData)), (u32)0);
+
+	delete entityManager;
+
+	testEntityDataStorageDerived();
+}
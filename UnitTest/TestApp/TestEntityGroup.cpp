@@ -0,0 +1,160 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestEntityGroup.h"
+#include "Transform/CWorldTransformData.h"
+#include "Transform/CWorldInverseTransformData.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static bool checkGroup(CEntityGroup* group, u64 mask)
+{
+	CEntity** entities = group->getEntities();
+	for (int i = 0, n = group->getEntityCount(); i < n; i++)
+	{
+		if (!entities[i]->isAlive())
+			return false;
+
+		if ((entities[i]->getDataSignature() & mask) != mask)
+			return false;
+
+		if (!group->containEntity(entities[i]))
+			return false;
+	}
+	return true;
+}
+
+static CEntity* spawnEntity(CEntityManager* entityManager, bool inverse)
+{
+	CEntity* entity = entityManager->createEntity();
+	entity->addData<CWorldTransformData>();
+	if (inverse)
+		entity->addData<CWorldInverseTransformData>();
+	return entity;
+}
+
+static double spawnChurn(CEntityManager* entityManager, int numFrame, int numChurn)
+{
+	core::array<CEntity*> spawned;
+
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	for (int frame = 0; frame < numFrame; frame++)
+	{
+		// despawn the entities of last frame
+		for (u32 i = 0; i < spawned.size(); i++)
+			spawned[i]->remove();
+		spawned.set_used(0);
+
+		for (int i = 0; i < numChurn; i++)
+			spawned.push_back(spawnEntity(entityManager, (i % 2) == 0));
+
+		entityManager->update();
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	for (u32 i = 0; i < spawned.size(); i++)
+		spawned[i]->remove();
+	entityManager->update();
+
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+void testEntityGroup()
+{
+	CEntityManager* entityManager = new CEntityManager();
+
+	u32 transformType = DATA_TYPE_INDEX(CWorldTransformData);
+	u32 inverseType = DATA_TYPE_INDEX(CWorldInverseTransformData);
+
+	const u32 transform[] = GET_LIST_ENTITY_DATA(CWorldTransformData);
+	const u32 inverse[] = GET_LIST_ENTITY_DATA(CWorldInverseTransformData);
+	const u32 both[] = { transformType, inverseType };
+
+	CEntityGroup* groupTransform = entityManager->createGroupFromVisible(transform, 1);
+	CEntityGroup* groupInverse = entityManager->createGroupFromVisible(inverse, 1);
+	CEntityGroup* groupBoth = entityManager->createGroup(both, 2);
+
+	TEST_CASE("Entity group signature");
+	CEntity* entity = spawnEntity(entityManager, false);
+	u64 transformMask = (u64)1 << transformType;
+	u64 inverseMask = (u64)1 << inverseType;
+	TEST_ASSERT_THROW((entity->getDataSignature() & transformMask) != 0);
+	TEST_ASSERT_THROW((entity->getDataSignature() & inverseMask) == 0);
+	TEST_ASSERT_EQUAL(groupBoth->getDataMask(), transformMask | inverseMask);
+	entity->remove();
+
+	TEST_CASE("Entity group incremental add");
+	const int numEntity = 1000;
+	core::array<CEntity*> entities;
+	for (int i = 0; i < numEntity; i++)
+		entities.push_back(spawnEntity(entityManager, false));
+	entityManager->update();
+
+	TEST_ASSERT_EQUAL(groupTransform->getEntityCount(), numEntity);
+	TEST_ASSERT_EQUAL(groupInverse->getEntityCount(), 0);
+
+	for (int i = 0; i < numEntity; i += 2)
+		entities[i]->addData<CWorldInverseTransformData>();
+	entityManager->update();
+
+	TEST_ASSERT_EQUAL(groupInverse->getEntityCount(), numEntity / 2);
+	TEST_ASSERT_EQUAL(groupBoth->getEntityCount(), numEntity / 2);
+	TEST_ASSERT_THROW(groupTransform->isQueryAll() == false);
+	TEST_ASSERT_THROW(groupInverse->isQueryAll() == false);
+	TEST_ASSERT_THROW(checkGroup(groupInverse, inverseMask));
+	TEST_ASSERT_THROW(checkGroup(groupBoth, transformMask | inverseMask));
+
+	TEST_CASE("Entity group incremental swap-remove");
+	for (int i = 0; i < numEntity; i += 4)
+		entities[i]->removeData<CWorldInverseTransformData>();
+	for (int i = 1; i < numEntity; i += 10)
+		entities[i]->remove();
+	entityManager->update();
+
+	TEST_ASSERT_EQUAL(groupInverse->getEntityCount(), numEntity / 4);
+	TEST_ASSERT_EQUAL(groupBoth->getEntityCount(), numEntity / 4);
+	TEST_ASSERT_EQUAL(groupTransform->getEntityCount(), numEntity - numEntity / 10);
+	TEST_ASSERT_THROW(checkGroup(groupTransform, transformMask));
+	TEST_ASSERT_THROW(checkGroup(groupInverse, inverseMask));
+	TEST_ASSERT_THROW(checkGroup(groupBoth, transformMask | inverseMask));
+
+	TEST_CASE("Entity group incremental same as full query");
+	int numTransform = groupTransform->getEntityCount();
+	int numInverse = groupInverse->getEntityCount();
+	int numBoth = groupBoth->getEntityCount();
+
+	entityManager->setIncrementalQuery(false);
+	entityManager->update();
+	TEST_ASSERT_EQUAL(groupTransform->getEntityCount(), numTransform);
+	TEST_ASSERT_EQUAL(groupInverse->getEntityCount(), numInverse);
+	TEST_ASSERT_EQUAL(groupBoth->getEntityCount(), numBoth);
+
+	TEST_CASE("Entity group spawn/despawn churn");
+	// simulate the groups of many systems
+	for (int i = 0; i < 16; i++)
+		entityManager->createGroupFromVisible((i % 2) ? transform : inverse, 1);
+
+	const int numFrame = 100;
+	const int numChurn = 50;
+
+	double fullQueryTime = spawnChurn(entityManager, numFrame, numChurn);
+
+	entityManager->setIncrementalQuery(true);
+	double incrementalTime = spawnChurn(entityManager, numFrame, numChurn);
+
+	if (g_testBenchmark)
+	{
+		printf("    %d entities, %d spawn/despawn per frame, %d frames\n", numTransform, numChurn, numFrame);
+		printf("    full query: %.2fms, incremental query: %.2fms\n", fullQueryTime, incrementalTime);
+	}
+
+	TEST_ASSERT_EQUAL(groupTransform->getEntityCount(), numTransform);
+	TEST_ASSERT_EQUAL(groupInverse->getEntityCount(), numInverse);
+	TEST_ASSERT_EQUAL(groupBoth->getEntityCount(), numBoth);
+	TEST_ASSERT_THROW(checkGroup(groupBoth, transformMask | inverseMask));
+
+	delete entityManager;
+}
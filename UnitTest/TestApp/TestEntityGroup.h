@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Entity/CEntityManager.h"
+
+void testEntityGroup();
@@ -0,0 +1,214 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestGUICulling.h"
+
+#include "Scene/CScene.h"
+#include "Projective/CProjective.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+// the linear hit test, that projects every element to the screen
+static CGUIElement* getHitTestLinear(CCanvas* canvas, CCamera* camera, float x, float y, const core::recti& viewport)
+{
+	CGUIElement* root = canvas->getRootElement();
+	core::matrix4 world = root->getRelativeTransform();
+
+	core::array<CGUIElement*> visits;
+	visits.push_back(root);
+
+	CGUIElement* result = NULL;
+
+	while (visits.size() > 0)
+	{
+		CGUIElement* gui = visits.getLast();
+		visits.erase(visits.size() - 1);
+
+		core::matrix4 transform = gui == root ? world : world * gui->getAbsoluteTransform();
+		const core::rectf& r = gui->getRect();
+
+		core::vector3df p[4];
+		p[0].set(r.UpperLeftCorner.X, r.UpperLeftCorner.Y, 0.0f);
+		p[1].set(r.LowerRightCorner.X, r.UpperLeftCorner.Y, 0.0f);
+		p[2].set(r.UpperLeftCorner.X, r.LowerRightCorner.Y, 0.0f);
+		p[3].set(r.LowerRightCorner.X, r.LowerRightCorner.Y, 0.0f);
+
+		for (int i = 0; i < 4; i++)
+		{
+			transform.transformVect(p[i]);
+			CProjective::getScreenCoordinatesFrom3DPosition(camera, p[i], p[i].X, p[i].Y, viewport.getWidth(), viewport.getHeight());
+			p[i].Z = 0.0f;
+		}
+
+		core::triangle3df t1(p[0], p[1], p[2]);
+		core::triangle3df t2(p[2], p[1], p[3]);
+		core::vector3df mousePos(x, y, 0.0f);
+
+		if (t1.isPointInside(mousePos) || t2.isPointInside(mousePos))
+		{
+			result = gui;
+
+			visits.clear();
+			for (CGUIElement* e : gui->getChilds())
+				visits.push_back(e);
+		}
+	}
+
+	return result;
+}
+
+static void renderCullingFrame(CCanvas* canvas, CCamera* camera)
+{
+	CGraphics2D* g = CGraphics2D::getInstance();
+
+	g->beginRenderGUI(camera->getProjectionMatrix(), camera->getViewMatrix());
+	g->resetStats();
+
+	canvas->updateEntities();
+
+	core::matrix4 world = canvas->getRootElement()->getRelativeTransform();
+	canvas->setRenderWorldTransform(world);
+	canvas->render(camera);
+
+	g->endRenderGUI();
+}
+
+void testGUICulling()
+{
+	CGraphics2D* g = CGraphics2D::getInstance();
+	const core::recti& viewport = getVideoDriver()->getViewPort();
+
+	CScene* scene = new CScene();
+	CZone* zone = scene->createZone();
+
+	CGameObject* cameraObj = zone->createEmptyObject();
+	CCamera* camera = cameraObj->addComponent<CCamera>();
+	camera->setProjectionType(CCamera::OrthoUI);
+	camera->endUpdate();
+
+	TEST_CASE("GUI hit test index");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+
+		for (int i = 0; i < 40; i++)
+		{
+			for (int j = 0; j < 40; j++)
+			{
+				core::rectf r((float)j * 20.0f, (float)i * 20.0f, (float)j * 20.0f + 16.0f, (float)i * 20.0f + 16.0f);
+				CGUIRect* cell = canvas->createRect(canvas->getRootElement(), r, SColor(255, 255, 255, 255));
+
+				// the nested and the rotated elements
+				if ((i + j) % 5 == 0)
+					canvas->createRect(cell, core::rectf((float)j * 20.0f + 4.0f, (float)i * 20.0f + 4.0f, (float)j * 20.0f + 12.0f, (float)i * 20.0f + 12.0f), SColor(255, 255, 0, 0));
+				else if ((i + j) % 7 == 0)
+					cell->setRotation(core::vector3df(0.0f, 0.0f, 30.0f));
+			}
+		}
+
+		renderCullingFrame(canvas, camera);
+
+		const int numQuery = 2000;
+		std::vector<core::vector2df> points;
+		for (int i = 0; i < numQuery; i++)
+			points.push_back(core::vector2df((float)(rand() % 8400) * 0.1f + 0.05f, (float)(rand() % 8400) * 0.1f + 0.05f));
+
+		std::vector<CGUIElement*> linear, indexed;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < numQuery; i++)
+			linear.push_back(getHitTestLinear(canvas, camera, points[i].X, points[i].Y, viewport));
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < numQuery; i++)
+			indexed.push_back(canvas->getHitTest(camera, points[i].X, points[i].Y, viewport));
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		int numSame = 0;
+		for (int i = 0; i < numQuery; i++)
+		{
+			if (linear[i] == indexed[i])
+				numSame++;
+		}
+		TEST_ASSERT_EQUAL(numSame, numQuery);
+
+		if (g_testBenchmark)
+		{
+			printf("    %d hit tests: linear %.3fms, spatial index %.3fms\n",
+				numQuery,
+				std::chrono::duration<double, std::milli>(t1 - t0).count(),
+				std::chrono::duration<double, std::milli>(t2 - t1).count());
+		}
+
+		obj->remove();
+	}
+
+	TEST_CASE("GUI culling");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+
+		// the list view with a mask
+		CGUIElement* list = canvas->createElement(canvas->getRootElement(), core::rectf(0.0f, 0.0f, 400.0f, 300.0f));
+		list->setPosition(core::vector3df(10.0f, 10.0f, 0.0f));
+
+		CGUIMask* mask = canvas->createMask(list, core::rectf(0.0f, 0.0f, 400.0f, 300.0f));
+
+		const int numItem = 200;
+		CGUIElement* content = canvas->createElement(list, core::rectf(0.0f, 0.0f, 400.0f, numItem * 20.0f));
+		content->setMask(mask);
+
+		std::vector<CGUIElement*> items;
+		for (int i = 0; i < numItem; i++)
+		{
+			CGUIElement* item = canvas->createElement(content, core::rectf(0.0f, 0.0f, 400.0f, 18.0f));
+			item->setPosition(core::vector3df(0.0f, i * 20.0f, 0.0f));
+
+			for (int k = 0; k < 4; k++)
+				canvas->createRect(item, core::rectf(4.0f + k * 90.0f, 0.0f, 84.0f + k * 90.0f, 18.0f), SColor(255, 255, 255, 255));
+
+			items.push_back(item);
+		}
+
+		// out of the screen
+		canvas->createRect(canvas->getRootElement(), core::rectf(-500.0f, 0.0f, -400.0f, 100.0f), SColor(255, 255, 255, 255));
+
+		canvas->setEnableCulling(false);
+		renderCullingFrame(canvas, camera);
+		u32 numVertex = g->getStats().NumVertex;
+		TEST_ASSERT_EQUAL(canvas->getNumCulled(), 0);
+
+		// 16 items overlap the mask, the other items and their rects are culled
+		canvas->setEnableCulling(true);
+		renderCullingFrame(canvas, camera);
+		TEST_ASSERT_EQUAL(canvas->getNumCulled(), (numItem - 16) * 5 + 1);
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex, 16 * 4 * 4);
+		TEST_ASSERT_THROW(g->getStats().NumVertex < numVertex);
+
+		if (g_testBenchmark)
+			printf("    %d elements: %d vertices, %d with culling\n", numItem * 5 + 4, numVertex, g->getStats().NumVertex);
+
+		TEST_ASSERT_THROW(canvas->getHitTest(camera, 24.3f, 15.5f, viewport) == items[0]->getChilds()[0]);
+
+		// scroll the list, the index updates the moved elements
+		content->setPosition(core::vector3df(0.0f, -1000.0f, 0.0f));
+		renderCullingFrame(canvas, camera);
+		TEST_ASSERT_EQUAL(canvas->getNumCulled(), (numItem - 16) * 5 + 1);
+
+		CGUIElement* hit = canvas->getHitTest(camera, 24.3f, 15.5f, viewport);
+		TEST_ASSERT_THROW(hit == items[50]->getChilds()[0]);
+		TEST_ASSERT_THROW(hit == getHitTestLinear(canvas, camera, 24.3f, 15.5f, viewport));
+
+		// the removed element is not in the index
+		items[50]->remove();
+		renderCullingFrame(canvas, camera);
+		hit = canvas->getHitTest(camera, 24.3f, 15.5f, viewport);
+		TEST_ASSERT_THROW(hit == content);
+
+		obj->remove();
+	}
+
+	delete scene;
+}
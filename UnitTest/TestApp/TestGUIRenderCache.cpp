@@ -0,0 +1,423 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestGUIRenderCache.h"
+
+#include "Scene/CScene.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+// all characters are the same glyph, the test moves it on the atlas
+class CTestRenderCacheFont : public IFont
+{
+public:
+	SImage Image;
+	SFrame Frame;
+	SModuleRect Module;
+	SModuleOffset Glyph;
+	u32 AtlasVersion;
+
+	CTestRenderCacheFont() :
+		AtlasVersion(0)
+	{
+		Module.X = 0.0f;
+		Module.Y = 0.0f;
+		Module.W = 8.0f;
+		Module.H = 12.0f;
+
+		Frame.Image = &Image;
+		Frame.BoudingRect = core::rectf(0.0f, 0.0f, 8.0f, 12.0f);
+
+		Glyph.Module = &Module;
+		Glyph.Frame = &Frame;
+		Glyph.XAdvance = 9.0f;
+		Glyph.Character = 'A';
+	}
+
+	virtual SModuleOffset* getCharacterModule(int character)
+	{
+		return &Glyph;
+	}
+
+	virtual u32 getAtlasVersion()
+	{
+		return AtlasVersion;
+	}
+
+	void moveGlyph(float x)
+	{
+		Module.X = x;
+		AtlasVersion++;
+	}
+};
+
+static std::vector<CGUIElement*> createRenderCacheGUI(CCanvas* canvas, int numRow, int numColumn, bool mask)
+{
+	std::vector<CGUIElement*> elements;
+
+	CGUIElement* panel = canvas->createElement(core::rectf(0.0f, 0.0f, 800.0f, 600.0f));
+	CGUIElement* parent = panel;
+
+	if (mask)
+	{
+		// the children are clipped by the mask depth
+		canvas->createMask(panel, core::rectf(10.0f, 10.0f, 790.0f, 590.0f));
+	}
+
+	for (int i = 0; i < numRow; i++)
+	{
+		for (int j = 0; j < numColumn; j++)
+		{
+			core::rectf r((float)j * 20.0f, (float)i * 20.0f, (float)j * 20.0f + 18.0f, (float)i * 20.0f + 18.0f);
+			SColor c(255, (i * 13) % 255, (j * 7) % 255, 128);
+
+			if ((i + j) % 2 == 0)
+				elements.push_back(canvas->createRect(parent, r, c));
+			else
+				elements.push_back(canvas->createElipse(parent, r, c));
+		}
+	}
+
+	return elements;
+}
+
+static void renderCacheFrame(CCanvas* canvas, CCamera* camera)
+{
+	CGraphics2D* g = CGraphics2D::getInstance();
+
+	core::matrix4 projection, view;
+	projection.buildProjectionMatrixOrthoLH(800.0f, -600.0f, -1.0f, 1.0f);
+	view.setTranslation(core::vector3df(-400.0f, -300.0f, 0.0f));
+
+	g->beginRenderGUI(projection, view);
+	g->resetStats();
+
+	canvas->updateEntities();
+	canvas->render(camera);
+}
+
+static void copyCurrentBuffer(std::vector<video::S3DVertex>& vertices, std::vector<u16>& indices)
+{
+	IMeshBuffer* buffer = CGraphics2D::getInstance()->getCurrentBuffer();
+	video::S3DVertex* v = (video::S3DVertex*)buffer->getVertexBuffer()->getVertices();
+	u16* id = (u16*)buffer->getIndexBuffer()->getIndices();
+
+	vertices.assign(v, v + buffer->getVertexBuffer()->getVertexCount());
+	indices.assign(id, id + buffer->getIndexBuffer()->getIndexCount());
+}
+
+void testGUIRenderCache()
+{
+	CGraphics2D* g = CGraphics2D::getInstance();
+
+	CScene* scene = new CScene();
+	CZone* zone = scene->createZone();
+
+	CGameObject* cameraObj = zone->createEmptyObject();
+	CCamera* camera = cameraObj->addComponent<CCamera>();
+
+	TEST_CASE("GUI render cache geometry");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+
+		// small enough to stay in one batch buffer
+		createRenderCacheGUI(canvas, 8, 10, false);
+
+		std::vector<video::S3DVertex> vertices, cacheVertices;
+		std::vector<u16> indices, cacheIndices;
+
+		renderCacheFrame(canvas, camera);
+		copyCurrentBuffer(vertices, indices);
+		g->endRenderGUI();
+
+		canvas->setEnableRenderCache(true);
+
+		// record, then replay
+		for (int i = 0; i < 2; i++)
+		{
+			renderCacheFrame(canvas, camera);
+			copyCurrentBuffer(cacheVertices, cacheIndices);
+			g->endRenderGUI();
+
+			TEST_ASSERT_THROW(vertices.size() > 0);
+			TEST_ASSERT_EQUAL((int)cacheVertices.size(), (int)vertices.size());
+			TEST_ASSERT_THROW(cacheIndices == indices);
+
+			bool same = true;
+			for (size_t v = 0; v < vertices.size() && same; v++)
+			{
+				same = vertices[v].Pos == cacheVertices[v].Pos &&
+					vertices[v].Color == cacheVertices[v].Color &&
+					vertices[v].TCoords == cacheVertices[v].TCoords;
+			}
+			TEST_ASSERT_THROW(same);
+		}
+
+		obj->remove();
+	}
+
+	TEST_CASE("GUI render cache vertices per frame");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+
+		std::vector<CGUIElement*> elements = createRenderCacheGUI(canvas, 28, 38, true);
+
+		// immediate mode
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+
+		u32 numVertex = g->getStats().NumVertex;
+		TEST_ASSERT_THROW(numVertex > 0);
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+
+		canvas->setEnableRenderCache(true);
+
+		// the first frame generates the cache
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex, numVertex);
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+
+		// the unchanged canvas only copies the cache
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex, numVertex);
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, numVertex);
+
+		// move one element, it regenerates only its vertices
+		CGUIElement* moved = elements[1];
+		u32 movedVertex = moved->getRenderCache()->Vertices.size();
+		moved->setPosition(core::vector3df(5.0f, 5.0f, 0.0f));
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex - g->getStats().NumCacheVertex, movedVertex);
+
+		// change the color and notify
+		CGUIElipse* elipse = dynamic_cast<CGUIElipse*>(moved);
+		TEST_ASSERT_THROW(elipse != NULL);
+		elipse->setFillAngle(0.0f, 180.0f);
+		elements[0]->setColor(SColor(255, 255, 0, 0));
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		u32 generated = g->getStats().NumVertex - g->getStats().NumCacheVertex;
+		TEST_ASSERT_EQUAL(generated, moved->getRenderCache()->Vertices.size() + elements[0]->getRenderCache()->Vertices.size());
+		TEST_ASSERT_THROW(generated < numVertex);
+
+		if (g_testBenchmark)
+		{
+			printf("    %d elements: %d vertices generated per frame, %d with the render cache\n",
+				(int)elements.size(),
+				numVertex,
+				generated);
+		}
+
+		// the border is drawn immediately, so it is not cached
+		canvas->DrawOutline = true;
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+		canvas->DrawOutline = false;
+
+		obj->remove();
+	}
+
+	TEST_CASE("GUI render cache subtree");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+
+		std::vector<CGUIElement*> elements = createRenderCacheGUI(canvas, 8, 10, false);
+		CGUIElement* panel = elements[0]->getParent();
+
+		std::vector<video::S3DVertex> vertices, cacheVertices;
+		std::vector<u16> indices, cacheIndices;
+
+		renderCacheFrame(canvas, camera);
+		copyCurrentBuffer(vertices, indices);
+		g->endRenderGUI();
+		u32 numVertex = g->getStats().NumVertex;
+
+		canvas->setEnableRenderCache(true);
+		panel->setCacheSubtree(true);
+
+		// record, then draw the panel by one cache
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 0);
+		TEST_ASSERT_THROW(panel->getSubtreeCache() != NULL && panel->getSubtreeCache()->Valid);
+		TEST_ASSERT_EQUAL(panel->getSubtreeCache()->Vertices.size(), numVertex);
+
+		renderCacheFrame(canvas, camera);
+		copyCurrentBuffer(cacheVertices, cacheIndices);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 1);
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, numVertex);
+		TEST_ASSERT_THROW(cacheIndices == indices);
+		TEST_ASSERT_EQUAL((int)cacheVertices.size(), (int)vertices.size());
+
+		bool same = true;
+		for (size_t v = 0; v < vertices.size() && same; v++)
+		{
+			same = vertices[v].Pos == cacheVertices[v].Pos &&
+				vertices[v].Color == cacheVertices[v].Color &&
+				vertices[v].TCoords == cacheVertices[v].TCoords;
+		}
+		TEST_ASSERT_THROW(same);
+
+		// move one child, the subtree is recorded again and only this child regenerates its vertices
+		CGUIElement* moved = elements[3];
+		moved->setPosition(core::vector3df(5.0f, 5.0f, 0.0f));
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 0);
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex - g->getStats().NumCacheVertex, moved->getRenderCache()->Vertices.size());
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 1);
+
+		// hide the last child
+		elements.back()->setVisible(false);
+		u32 hiddenVertex = elements.back()->getRenderCache()->Vertices.size();
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 0);
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex, numVertex - hiddenVertex);
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 1);
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, numVertex - hiddenVertex);
+
+		// the outline is drawn immediately, the subtree can't be cached
+		canvas->DrawOutline = true;
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_THROW(panel->getSubtreeCache()->Valid == false);
+		canvas->DrawOutline = false;
+
+		obj->remove();
+	}
+
+	TEST_CASE("GUI render cache subtree mask");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+		canvas->setEnableRenderCache(true);
+
+		std::vector<CGUIElement*> elements = createRenderCacheGUI(canvas, 4, 4, true);
+		elements[0]->getParent()->setCacheSubtree(true);
+
+		for (int i = 0; i < 2; i++)
+		{
+			renderCacheFrame(canvas, camera);
+			g->endRenderGUI();
+		}
+
+		// the masked childs use their own cache
+		TEST_ASSERT_EQUAL(canvas->getNumSubtreeCached(), 0);
+		TEST_ASSERT_THROW(g->getStats().NumCacheVertex > 0);
+
+		obj->remove();
+	}
+
+	TEST_CASE("GUI render cache text");
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+		canvas->setEnableRenderCache(true);
+
+		CTestRenderCacheFont font;
+		CGUIText* text = canvas->createText(core::rectf(0.0f, 0.0f, 400.0f, 100.0f), &font);
+		text->setText("Render cache text");
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		u32 numVertex = g->getStats().NumVertex;
+		TEST_ASSERT_THROW(numVertex > 0);
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+		TEST_ASSERT_THROW(text->getRenderCache() != NULL);
+
+		// the layout & the glyph quads are reused
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, numVertex);
+
+		core::vector2df uv = text->getRenderCache()->Vertices[0].TCoords;
+
+		// the glyph is moved on the atlas, the text is laid out again
+		font.moveGlyph(64.0f);
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+		TEST_ASSERT_EQUAL(g->getStats().NumVertex, numVertex);
+		TEST_ASSERT_THROW(text->getRenderCache()->Vertices[0].TCoords != uv);
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, numVertex);
+
+		// the new text
+		text->setText("Text");
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+		TEST_ASSERT_THROW(g->getStats().NumVertex > 0 && g->getStats().NumVertex < numVertex);
+
+		// the blinking caret is not cached
+		text->showCaret(true);
+
+		renderCacheFrame(canvas, camera);
+		g->endRenderGUI();
+		TEST_ASSERT_EQUAL(g->getStats().NumCacheVertex, 0);
+
+		obj->remove();
+	}
+
+	if (g_testBenchmark)
+	{
+		CGameObject* obj = zone->createEmptyObject();
+		CCanvas* canvas = obj->addComponent<CCanvas>();
+		canvas->setEnableRenderCache(true);
+
+		std::vector<CGUIElement*> elements = createRenderCacheGUI(canvas, 28, 38, false);
+		CGUIElement* panel = elements[0]->getParent();
+
+		int numLoop = 200;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < numLoop; i++)
+		{
+			renderCacheFrame(canvas, camera);
+			g->endRenderGUI();
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+		panel->setCacheSubtree(true);
+		for (int i = 0; i < numLoop; i++)
+		{
+			renderCacheFrame(canvas, camera);
+			g->endRenderGUI();
+		}
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		printf("    %d elements: element cache %.3fms, subtree cache %.3fms per frame\n",
+			(int)elements.size(),
+			std::chrono::duration<double, std::milli>(t1 - t0).count() / numLoop,
+			std::chrono::duration<double, std::milli>(t2 - t1).count() / numLoop);
+
+		obj->remove();
+	}
+
+	delete scene;
+}
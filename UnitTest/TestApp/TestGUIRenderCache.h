@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Base.hh"
+#include "Graphics2D/CGraphics2D.h"
+#include "Graphics2D/CCanvas.h"
+
+void testGUIRenderCache();
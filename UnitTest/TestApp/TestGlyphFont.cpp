@@ -0,0 +1,236 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestGlyphFont.h"
+
+#include <chrono>
+#include <set>
+
+using namespace Skylicht;
+
+static std::wstring getGlyphSampleText()
+{
+	// the latin text and the CJK ideographs, a localized text uses thousands of them
+	std::wstring text = L"The quick brown fox jumps over the lazy dog 0123456789 .,;:!?";
+	for (int i = 0; i < 400; i++)
+		text += (wchar_t)(0x4E00 + i * 37);
+	return text;
+}
+
+static int getGlyphAtlasUsedArea(CGlyphFreetype* freetype)
+{
+	int area = 0;
+	for (CAtlas* atlas : freetype->getAtlas())
+		area += atlas->getUsedArea();
+	return area;
+}
+
+void testGlyphFont()
+{
+	TEST_CASE("Glyph hash map");
+	{
+		CGlyphHashMap<int> map;
+		std::map<u32, int*> reference;
+		std::vector<int> values(5000);
+
+		for (int i = 0; i < 5000; i++)
+		{
+			u32 key = ((u32)(rand() % 64) << 16) | (u32)(rand() % 65536);
+			map.set(key, &values[i]);
+			reference[key] = &values[i];
+		}
+
+		TEST_ASSERT_EQUAL(map.size(), (u32)reference.size());
+
+		for (auto& it : reference)
+			TEST_ASSERT_THROW(map.get(it.first) == it.second);
+
+		for (int i = 0; i < 1000; i++)
+		{
+			u32 key = (100u << 16) | (u32)i;
+			TEST_ASSERT_THROW(map.get(key) == NULL);
+		}
+	}
+
+	CGlyphFreetype* freetype = CGlyphFreetype::getInstance();
+	const char* fontName = "TestSegoeUI";
+
+	TEST_CASE("Glyph font init");
+	if (!freetype->initFont(fontName, "../Assets/BuiltIn/Fonts/segoeui/segoeui.ttf"))
+	{
+		// the font asset is not synced (git lfs)
+		return;
+	}
+
+	std::wstring text = getGlyphSampleText();
+	std::set<wchar_t> uniqueChars(text.begin(), text.end());
+	int numUnique = (int)uniqueChars.size();
+
+	const int numSize = 4;
+	const int sizes[numSize] = { 16, 24, 32, 48 };
+	float advance, x, y, w, h, offsetX, offsetY, scale;
+
+	TEST_CASE("Glyph bitmap");
+	freetype->clearAtlas();
+
+	int raster = freetype->getNumRasterGlyph();
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < numSize; i++)
+	{
+		for (wchar_t c : text)
+			TEST_ASSERT_THROW(freetype->getCharImage((u16)c, fontName, sizes[i], &advance, &x, &y, &w, &h, &offsetX, &offsetY) != NULL);
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	int bitmapRaster = freetype->getNumRasterGlyph() - raster;
+	int bitmapArea = getGlyphAtlasUsedArea(freetype);
+	int bitmapAtlas = (int)freetype->getAtlas().size();
+	double bitmapTime = std::chrono::duration<double>(t1 - t0).count();
+
+	TEST_ASSERT_EQUAL(bitmapRaster, numUnique * numSize);
+
+	TEST_CASE("Glyph SDF");
+	freetype->clearAtlas();
+
+	raster = freetype->getNumRasterGlyph();
+	t0 = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < numSize; i++)
+	{
+		for (wchar_t c : text)
+		{
+			TEST_ASSERT_THROW(freetype->getCharImageSDF((u16)c, fontName, sizes[i], &advance, &x, &y, &w, &h, &offsetX, &offsetY, &scale) != NULL);
+			TEST_ASSERT_FLOAT_EQUAL(scale, (float)sizes[i] / (float)freetype->getSDFSize());
+		}
+	}
+
+	t1 = std::chrono::high_resolution_clock::now();
+
+	int sdfRaster = freetype->getNumRasterGlyph() - raster;
+	int sdfArea = getGlyphAtlasUsedArea(freetype);
+	int sdfAtlas = (int)freetype->getAtlas().size();
+	double sdfTime = std::chrono::duration<double>(t1 - t0).count();
+
+	// one raster for all sizes
+	TEST_ASSERT_EQUAL(sdfRaster, numUnique);
+	TEST_ASSERT_THROW(sdfArea < bitmapArea);
+
+	if (g_testBenchmark)
+	{
+		printf("    %d characters, %d sizes\n", numUnique, numSize);
+		printf("    bitmap: %d glyphs %.0f glyphs/s, %d atlas, %d KB used\n", bitmapRaster, bitmapRaster / bitmapTime, bitmapAtlas, bitmapArea * 4 / 1024);
+		printf("    SDF: %d glyphs %.0f glyphs/s, %d atlas, %d KB used\n", sdfRaster, sdfRaster / sdfTime, sdfAtlas, sdfArea * 4 / 1024);
+	}
+
+	TEST_CASE("Glyph SDF shape");
+	{
+		// the SDF edge at 0.5 is the same as the bitmap at the SDF size
+		int size = freetype->getSDFSize();
+		int spread = freetype->getSDFSpread();
+
+		const wchar_t* shapeChars = L"BgQ@";
+		for (int i = 0; shapeChars[i] != 0; i++)
+		{
+			u16 c = (u16)shapeChars[i];
+
+			float bx, by, bw, bh;
+			CAtlas* bitmapAtlas = freetype->getCharImage(c, fontName, size, &advance, &bx, &by, &bw, &bh, &offsetX, &offsetY);
+
+			float sx, sy, sw, sh;
+			CAtlas* sdfAtlas = freetype->getCharImageSDF(c, fontName, size, &advance, &sx, &sy, &sw, &sh, &offsetX, &offsetY, &scale);
+
+			TEST_ASSERT_THROW(bitmapAtlas != NULL && sdfAtlas != NULL);
+
+			IImage* bitmapImage = bitmapAtlas->getImage();
+			IImage* sdfImage = sdfAtlas->getImage();
+
+			float texSize = (float)bitmapImage->getDimension().Width;
+			int x0 = core::round32(bx * texSize), y0 = core::round32(by * texSize);
+			int x1 = core::round32(sx * texSize), y1 = core::round32(sy * texSize);
+			int gw = core::round32(bw * texSize), gh = core::round32(bh * texSize);
+
+			TEST_ASSERT_EQUAL(core::round32(sw * texSize), gw + spread * 2);
+
+			int same = 0;
+			for (int py = 0; py < gh; py++)
+			{
+				for (int px = 0; px < gw; px++)
+				{
+					bool bitmapInside = bitmapImage->getPixel(x0 + px, y0 + py).getAlpha() >= 128;
+					bool sdfInside = sdfImage->getPixel(x1 + px + spread, y1 + py + spread).getAlpha() >= 128;
+					if (bitmapInside == sdfInside)
+						same++;
+				}
+			}
+
+			TEST_ASSERT_THROW(same >= gw * gh * 95 / 100);
+		}
+	}
+
+	TEST_CASE("Glyph prewarm");
+	{
+		freetype->clearAtlas();
+
+		t0 = std::chrono::high_resolution_clock::now();
+
+		int queued = freetype->prewarm(fontName, text.c_str(), 24, true);
+		TEST_ASSERT_EQUAL(queued, numUnique);
+
+		// the main thread does not wait, it can draw the other things
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		freetype->waitRasterQueue();
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		TEST_ASSERT_EQUAL(freetype->getNumPendingGlyph(), 0);
+
+		// the glyphs are ready for all sizes
+		raster = freetype->getNumRasterGlyph();
+		for (int i = 0; i < numSize; i++)
+		{
+			for (wchar_t c : text)
+				TEST_ASSERT_THROW(freetype->getCharImageSDF((u16)c, fontName, sizes[i], &advance, &x, &y, &w, &h, &offsetX, &offsetY, &scale) != NULL);
+		}
+		TEST_ASSERT_EQUAL(freetype->getNumRasterGlyph(), raster);
+
+		// the glyph that is requested before the raster thread is done
+		TEST_ASSERT_EQUAL(freetype->prewarm(fontName, text.c_str(), 20, false), numUnique);
+		TEST_ASSERT_THROW(freetype->getCharImage((u16)text.back(), fontName, 20, &advance, &x, &y, &w, &h, &offsetX, &offsetY) != NULL);
+
+		while (freetype->getNumPendingGlyph() > 0)
+			freetype->updateRasterQueue();
+
+		TEST_ASSERT_EQUAL(freetype->getNumRasterGlyph(), raster + numUnique);
+
+		if (g_testBenchmark)
+		{
+			printf("    prewarm %d SDF glyphs: queue %.3fms, raster thread %.3fms\n",
+				queued,
+				std::chrono::duration<double, std::milli>(t1 - t0).count(),
+				std::chrono::duration<double, std::milli>(t2 - t0).count());
+		}
+	}
+
+	TEST_CASE("Glyph atlas dirty rect");
+	{
+		freetype->clearAtlas();
+
+		CAtlas* atlas = freetype->getAtlas()[0];
+		atlas->getTexture();
+		TEST_ASSERT_EQUAL(atlas->getDirtyRect().getArea(), 0);
+
+		// only the new glyph is uploaded
+		TEST_ASSERT_THROW(freetype->getCharImage((u16)'Q', fontName, 32, &advance, &x, &y, &w, &h, &offsetX, &offsetY) == atlas);
+		TEST_ASSERT_THROW(atlas->needUpdateTexture());
+		TEST_ASSERT_THROW(atlas->getDirtyRect().getArea() > 0);
+		TEST_ASSERT_THROW(atlas->getDirtyRect().getArea() <= 64 * 64);
+
+		atlas->updateTexture();
+		TEST_ASSERT_THROW(!atlas->needUpdateTexture());
+		TEST_ASSERT_EQUAL(atlas->getDirtyRect().getArea(), 0);
+
+		freetype->clearAtlas();
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Graphics2D/Glyph/CGlyphFreetype.h"
+
+void testGlyphFont();
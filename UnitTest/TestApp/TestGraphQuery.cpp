@@ -0,0 +1,447 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestGraphQuery.h"
+
+#ifdef BUILD_SKYLICHT_GRAPH
+
+#include "Graph/CGraphQuery.h"
+#include "FlowField/CFlowFieldCache.h"
+
+#include <chrono>
+#include <queue>
+
+using namespace Skylicht;
+using namespace Skylicht::Graph;
+
+// the grid of tiles with 8 neighbours, the walls have some doors
+static void createWalkingGrid(CWalkingTileMap* map, int size)
+{
+	srand(7);
+
+	core::array<STile*>& tiles = map->getTiles();
+	std::vector<STile*> grid(size * size, NULL);
+
+	for (int z = 0; z < size; z++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			bool wall = (x % 10 == 5 && rand() % 8 != 0) || (z % 14 == 7 && rand() % 8 != 0);
+			if (wall)
+				continue;
+
+			STile* tile = new STile();
+			tile->Id = tiles.size();
+			tile->X = x;
+			tile->Z = z;
+			tile->Position.set(x * 0.5f, 0.0f, z * 0.5f);
+
+			tiles.push_back(tile);
+			grid[z * size + x] = tile;
+		}
+	}
+
+	for (int z = 0; z < size; z++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			STile* tile = grid[z * size + x];
+			if (tile == NULL)
+				continue;
+
+			for (int dz = -1; dz <= 1; dz++)
+			{
+				for (int dx = -1; dx <= 1; dx++)
+				{
+					int nx = x + dx, nz = z + dz;
+					if ((dx == 0 && dz == 0) || nx < 0 || nz < 0 || nx >= size || nz >= size)
+						continue;
+
+					STile* nei = grid[nz * size + nx];
+					if (nei == NULL)
+						continue;
+
+					// the diagonal does not cut the wall corner
+					if (dx != 0 && dz != 0 && (grid[z * size + nx] == NULL || grid[nz * size + x] == NULL))
+						continue;
+
+					tile->Neighbours.push_back(nei);
+				}
+			}
+		}
+	}
+}
+
+static float getPathLength(core::array<STile*>& path)
+{
+	float length = 0.0f;
+	for (u32 i = 1; i < path.size(); i++)
+		length += path[i]->Position.getDistanceFrom(path[i - 1]->Position);
+	return length;
+}
+
+static bool isPathLinked(core::array<STile*>& path, STile* from, STile* to)
+{
+	if (path.size() == 0 || path[0] != from || path.getLast() != to)
+		return false;
+
+	for (u32 i = 1; i < path.size(); i++)
+	{
+		if (path[i - 1]->Neighbours.linear_search(path[i]) < 0)
+			return false;
+	}
+	return true;
+}
+
+// the shortest distance by dijkstra
+static float getShortestDistance(CWalkingTileMap* map, STile* from, STile* to)
+{
+	typedef std::pair<float, STile*> SItem;
+	std::priority_queue<SItem, std::vector<SItem>, std::greater<SItem>> queue;
+	std::vector<float> dist(map->getNumTile(), -1.0f);
+
+	dist[from->Id] = 0.0f;
+	queue.push(SItem(0.0f, from));
+
+	while (!queue.empty())
+	{
+		SItem item = queue.top();
+		queue.pop();
+
+		STile* tile = item.second;
+		if (item.first > dist[tile->Id])
+			continue;
+
+		if (tile == to)
+			return item.first;
+
+		for (u32 i = 0; i < tile->Neighbours.size(); i++)
+		{
+			STile* nei = tile->Neighbours[i];
+			float d = item.first + nei->Position.getDistanceFrom(tile->Position);
+
+			if (dist[nei->Id] < 0.0f || d < dist[nei->Id])
+			{
+				dist[nei->Id] = d;
+				queue.push(SItem(d, nei));
+			}
+		}
+	}
+
+	return -1.0f;
+}
+
+// the field must match the new build
+static bool isFlowFieldEqual(CWalkingTileMap* map, CFlowField* field)
+{
+	CFlowField check(map, field->getGoal());
+	check.build();
+
+	core::array<STile*>& tiles = map->getTiles();
+	for (u32 i = 0; i < tiles.size(); i++)
+	{
+		if (fabsf(field->getDistance(tiles[i]) - check.getDistance(tiles[i])) > 0.001f)
+			return false;
+	}
+	return true;
+}
+
+static void testFlowField(CWalkingTileMap* map, CGraphQuery* query)
+{
+	core::array<STile*>& tiles = map->getTiles();
+	u32 numTile = tiles.size();
+
+	srand(10);
+
+	CFlowFieldCache* cache = new CFlowFieldCache(map, 4);
+
+	STile* goal = tiles[rand() % numTile];
+	CFlowField* field = cache->getFlowField(goal);
+
+	TEST_CASE("Graph flow field");
+	{
+		TEST_ASSERT_THROW(cache->getFlowField(goal) == field);
+		TEST_ASSERT_EQUAL(field->getDistance(goal), 0.0f);
+
+		for (int i = 0; i < 20; i++)
+		{
+			STile* tile = tiles[rand() % numTile];
+			float shortest = getShortestDistance(map, tile, goal);
+
+			TEST_ASSERT_THROW(fabsf(field->getDistance(tile) - shortest) < 0.001f);
+
+			// follow the direction field to the goal
+			if (shortest >= 0.0f)
+			{
+				float length = 0.0f;
+				int step = 0;
+				while (tile != goal && step < (int)numTile)
+				{
+					STile* next = field->getNextTile(tile);
+					length += tile->Position.getDistanceFrom(next->Position);
+					tile = next;
+					step++;
+				}
+
+				TEST_ASSERT_THROW(tile == goal);
+				TEST_ASSERT_THROW(fabsf(length - shortest) < 0.001f);
+			}
+		}
+	}
+
+	TEST_CASE("Graph flow field update");
+	{
+		// close the doors of the wall near the goal
+		core::array<STile*> changed;
+		for (u32 i = 0; i < numTile; i++)
+		{
+			STile* tile = tiles[i];
+			if (tile->X % 10 == 5 && abs(tile->X - goal->X) < 20)
+			{
+				tile->Blocked = true;
+				changed.push_back(tile);
+			}
+		}
+
+		cache->updateTiles(changed.pointer(), changed.size());
+		TEST_ASSERT_THROW(isFlowFieldEqual(map, field));
+
+		// the blocked tiles are not on the path
+		core::array<STile*> path;
+		STile* from = tiles[0];
+		if (query->findPath(map, from, goal, path))
+		{
+			for (u32 i = 0; i < path.size(); i++)
+				TEST_ASSERT_THROW(path[i]->Blocked == false);
+			TEST_ASSERT_THROW(fabsf(getPathLength(path) - field->getDistance(from)) < 0.001f);
+		}
+
+		// open the doors
+		for (u32 i = 0; i < changed.size(); i++)
+			changed[i]->Blocked = false;
+
+		cache->updateTiles(changed.pointer(), changed.size());
+		TEST_ASSERT_THROW(isFlowFieldEqual(map, field));
+
+		// block the goal
+		goal->Blocked = true;
+		cache->updateTiles(&goal, 1);
+		TEST_ASSERT_THROW(field->canReach(tiles[0]) == false);
+
+		goal->Blocked = false;
+		cache->updateTiles(&goal, 1);
+		TEST_ASSERT_THROW(isFlowFieldEqual(map, field));
+	}
+
+	TEST_CASE("Graph flow field cache");
+	{
+		for (int i = 0; i < 10; i++)
+			cache->getFlowField(tiles[rand() % numTile]);
+
+		TEST_ASSERT_EQUAL(cache->getNumFields(), (u32)4);
+	}
+
+	TEST_CASE("Graph flow field agents");
+	{
+		const int numAgent = 500;
+		const int numGoal = 4;
+
+		STile* goals[numGoal];
+		for (int i = 0; i < numGoal; i++)
+			goals[i] = tiles[rand() % numTile];
+
+		core::array<SPathRequest> requests;
+		for (int i = 0; i < numAgent; i++)
+		{
+			requests.push_back(SPathRequest());
+			requests[i].From = tiles[rand() % numTile];
+			requests[i].To = goals[i % numGoal];
+		}
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		query->findPaths(map, requests.pointer(), numAgent);
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		cache->clear();
+
+		core::vector3df direction;
+		int numReach = 0;
+
+		for (int i = 0; i < numAgent; i++)
+		{
+			CFlowField* f = cache->getFlowField(requests[i].To);
+			if (f->canReach(requests[i].From))
+			{
+				direction = f->getDirection(requests[i].From);
+				numReach++;
+			}
+		}
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		// a door is closed
+		STile* door = NULL;
+		for (u32 i = 0; i < numTile && door == NULL; i++)
+		{
+			if (tiles[i]->X % 10 == 5)
+				door = tiles[i];
+		}
+
+		door->Blocked = true;
+		cache->updateTiles(&door, 1);
+
+		auto t3 = std::chrono::high_resolution_clock::now();
+
+		door->Blocked = false;
+		cache->updateTiles(&door, 1);
+		TEST_ASSERT_THROW(isFlowFieldEqual(map, cache->getFlowField(goals[0])));
+
+		int numFound = 0;
+		for (int i = 0; i < numAgent; i++)
+		{
+			if (requests[i].Found)
+				numFound++;
+		}
+		TEST_ASSERT_EQUAL(numReach, numFound);
+
+		if (g_testBenchmark)
+		{
+			printf("    %d agents to %d goals: findPaths %.2fms, flow fields %.2fms (%d reach), close a door %.3fms\n",
+				numAgent, numGoal,
+				std::chrono::duration<double, std::milli>(t1 - t0).count(),
+				std::chrono::duration<double, std::milli>(t2 - t1).count(),
+				numReach,
+				std::chrono::duration<double, std::milli>(t3 - t2).count());
+		}
+	}
+
+	delete cache;
+}
+
+void testGraphQuery()
+{
+	TEST_CASE("Graph priority queue");
+	{
+		CDistancePriorityQueue queue;
+		for (int i = 0; i < 1000; i++)
+			queue.push({ (float)(rand() % 500), NULL });
+
+		float last = -1.0f;
+		bool sorted = true;
+		while (!queue.empty())
+		{
+			if (queue.top().Distance < last)
+				sorted = false;
+
+			last = queue.top().Distance;
+			queue.pop();
+		}
+		TEST_ASSERT_THROW(sorted);
+	}
+
+	const int gridSize = 150;
+
+	CWalkingTileMap* map = new CWalkingTileMap();
+	createWalkingGrid(map, gridSize);
+
+	core::array<STile*>& tiles = map->getTiles();
+	u32 numTile = tiles.size();
+
+	CGraphQuery* query = new CGraphQuery();
+
+	TEST_CASE("Graph find path");
+	{
+		srand(8);
+
+		core::array<STile*> path;
+		for (int i = 0; i < 20; i++)
+		{
+			STile* from = tiles[rand() % numTile];
+			STile* to = tiles[rand() % numTile];
+			if (from == to)
+				continue;
+
+			float shortest = getShortestDistance(map, from, to);
+
+			bool found = query->findPath(map, from, to, path);
+			TEST_ASSERT_EQUAL(found, shortest >= 0.0f);
+
+			if (found)
+			{
+				TEST_ASSERT_THROW(isPathLinked(path, from, to));
+				TEST_ASSERT_THROW(fabsf(getPathLength(path) - shortest) < 0.001f);
+			}
+		}
+
+		// the query does not use the visit flag of the tiles
+		for (u32 i = 0; i < numTile; i++)
+			TEST_ASSERT_THROW(tiles[i]->Visit == false);
+	}
+
+	const int numAgent = 500;
+
+	core::array<SPathRequest> requests;
+	srand(9);
+	for (int i = 0; i < numAgent; i++)
+	{
+		requests.push_back(SPathRequest());
+		requests[i].From = tiles[rand() % numTile];
+		requests[i].To = tiles[rand() % numTile];
+	}
+
+	TEST_CASE("Graph find paths");
+	{
+		query->findPaths(map, requests.pointer(), numAgent);
+
+		int numMismatch = 0;
+		core::array<STile*> path;
+
+		for (int i = 0; i < numAgent; i++)
+		{
+			SPathRequest& r = requests[i];
+			bool found = query->findPath(map, r.From, r.To, path);
+
+			if (found != r.Found || (found && fabsf(getPathLength(path) - getPathLength(r.Result)) > 0.001f))
+				numMismatch++;
+		}
+		TEST_ASSERT_EQUAL(numMismatch, 0);
+	}
+
+	if (g_testBenchmark)
+	{
+		TEST_CASE("Graph find paths benchmark");
+
+		core::array<STile*> path;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numAgent; i++)
+			query->findPath(map, requests[i].From, requests[i].To, path);
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		query->findPaths(map, requests.pointer(), numAgent);
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		printf("    %d tiles, %d paths: findPath %.2fms, findPaths %.2fms\n",
+			numTile, numAgent,
+			std::chrono::duration<double, std::milli>(t1 - t0).count(),
+			std::chrono::duration<double, std::milli>(t2 - t1).count());
+	}
+
+	testFlowField(map, query);
+
+	delete query;
+	delete map;
+}
+
+#else
+
+void testGraphQuery()
+{
+
+}
+
+#endif
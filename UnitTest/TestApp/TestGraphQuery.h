@@ -0,0 +1,5 @@
+#pragma once
+
+#include "Base.hh"
+
+void testGraphQuery();
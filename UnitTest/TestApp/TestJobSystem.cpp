@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestJobSystem.h"
+
+using namespace Skylicht;
+
+static void testParallelFor(System::CJobSystem* jobSystem)
+{
+	TEST_CASE("Job system parallelFor");
+
+	const int count = 100000;
+	std::vector<int> values(count, 0);
+
+	jobSystem->parallelFor(count, 64, [&values](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+				values[i] += i;
+		});
+
+	for (int i = 0; i < count; i++)
+		TEST_ASSERT_THROW(values[i] == i);
+
+	TEST_CASE("Job system nested parallelFor");
+	std::atomic<int> total(0);
+
+	jobSystem->parallelFor(16, 1, [jobSystem, &total](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				jobSystem->parallelFor(1000, 10, [&total](int b, int e)
+					{
+						total.fetch_add(e - b);
+					});
+			}
+		});
+
+	TEST_ASSERT_EQUAL(total.load(), 16000);
+}
+
+static void testTaskGraph(System::CJobSystem* jobSystem)
+{
+	TEST_CASE("Task graph dependency");
+
+	/*
+		a   b
+		 \ /
+		  c
+		  |
+		  d
+	*/
+	std::atomic<int> step(0);
+	int orderA = -1, orderB = -1, orderC = -1, orderD = -1;
+
+	System::CTaskGraph graph;
+	int a = graph.addTask([&]() { orderA = step.fetch_add(1); });
+	int b = graph.addTask([&]() { orderB = step.fetch_add(1); });
+	int c = graph.addTask([&]() { orderC = step.fetch_add(1); });
+	int d = graph.addTask([&]() { orderD = step.fetch_add(1); });
+
+	graph.addDependency(a, c);
+	graph.addDependency(b, c);
+	graph.addDependency(c, d);
+
+	// run twice, the graph can be reused
+	for (int i = 0; i < 2; i++)
+	{
+		step = 0;
+		graph.run(jobSystem);
+
+		TEST_ASSERT_EQUAL(step.load(), 4);
+		TEST_ASSERT_THROW(orderC > orderA && orderC > orderB);
+		TEST_ASSERT_THROW(orderD > orderC);
+	}
+}
+
+void testJobSystem()
+{
+	TEST_CASE("Job system create");
+
+	// force create some workers, the test machine may have 1 core
+	System::CJobSystem* jobSystem = new System::CJobSystem(3);
+	TEST_ASSERT_THROW(jobSystem->getNumThreads() >= 1);
+
+	testParallelFor(jobSystem);
+	testTaskGraph(jobSystem);
+
+	TEST_CASE("Job system release");
+	delete jobSystem;
+
+	TEST_CASE("Job system run on calling thread");
+	System::CJobSystem noWorker(0);
+	TEST_ASSERT_EQUAL(noWorker.getNumWorkers(), 0);
+	testParallelFor(&noWorker);
+	testTaskGraph(&noWorker);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Base.hh"
+#include "Thread/CJobSystem.h"
+#include "Thread/CTaskGraph.h"
+
+void testJobSystem();
@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestLightGrid.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace Skylicht;
+
+static float randomRange(float min, float max)
+{
+	return min + (max - min) * (float)(rand() % 10000) / 10000.0f;
+}
+
+static core::aabbox3df randomLightBox(float size)
+{
+	core::vector3df center(randomRange(-100.0f, 100.0f), randomRange(-20.0f, 20.0f), randomRange(-50.0f, 250.0f));
+	core::vector3df extent(randomRange(0.1f, size), randomRange(0.1f, size), randomRange(0.1f, size));
+	return core::aabbox3df(center - extent, center + extent);
+}
+
+static void getLightsBruteForce(const core::aabbox3df& box, core::array<CLightCullingData*>& lights, core::array<CLightCullingData*>& result)
+{
+	for (u32 i = 0; i < lights.size(); i++)
+	{
+		if (lights[i]->TransformBBox.intersectsWithBox(box))
+			result.push_back(lights[i]);
+	}
+}
+
+static bool isSameLights(core::array<CLightCullingData*>& a, core::array<CLightCullingData*>& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	std::vector<CLightCullingData*> sa(a.pointer(), a.pointer() + a.size());
+	std::vector<CLightCullingData*> sb(b.pointer(), b.pointer() + b.size());
+	std::sort(sa.begin(), sa.end());
+	std::sort(sb.begin(), sb.end());
+	return sa == sb;
+}
+
+void testLightGrid()
+{
+	const int numLight = 250;
+
+	core::array<CLightCullingData*> lights;
+	for (int i = 0; i < numLight; i++)
+	{
+		CLightCullingData* data = new CLightCullingData();
+		data->TransformBBox = randomLightBox(8.0f);
+		data->LightPosition = data->TransformBBox.getCenter();
+		lights.push_back(data);
+	}
+
+	core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(core::vector3df(0.0f, 5.0f, -10.0f), core::vector3df(0.0f, 0.0f, 50.0f), core::vector3df(0.0f, 1.0f, 0.0f));
+
+	core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(core::PI / 3.0f, 16.0f / 9.0f, 0.1f, 300.0f);
+
+	CLightGrid grid;
+
+	TEST_CASE("Light grid build");
+	grid.build(view, projection, 0.1f, 300.0f, lights.pointer(), lights.size());
+	TEST_ASSERT_THROW(grid.isBuilt());
+	TEST_ASSERT_EQUAL(grid.getNumLights(), (u32)numLight);
+	{
+		// each light is listed on all clusters of its range, and only there
+		core::array<u32> numCluster;
+		numCluster.set_used(numLight);
+		for (int i = 0; i < numLight; i++)
+			numCluster[i] = 0;
+
+		for (u32 c = 0; c < grid.getNumClusters(); c++)
+		{
+			u32 count;
+			const u32* ids = grid.getClusterLights(c, count);
+			for (u32 i = 0; i < count; i++)
+				numCluster[ids[i]]++;
+		}
+
+		for (int i = 0; i < numLight; i++)
+		{
+			const CLightGrid::SClusterRange& r = grid.getLightRange(i);
+			u32 expected = (r.Max[0] - r.Min[0] + 1) * (r.Max[1] - r.Min[1] + 1) * (r.Max[2] - r.Min[2] + 1);
+			TEST_ASSERT_EQUAL(numCluster[i], expected);
+		}
+	}
+
+	TEST_CASE("Light grid assignment");
+	{
+		core::array<CLightCullingData*> result;
+		core::array<CLightCullingData*> reference;
+
+		for (int i = 0; i < 2000; i++)
+		{
+			// the boxes also cross the camera plane and the far plane
+			core::aabbox3df box = randomLightBox(i % 10 == 0 ? 40.0f : 4.0f);
+
+			result.set_used(0);
+			reference.set_used(0);
+
+			grid.getLights(box, result);
+			getLightsBruteForce(box, lights, reference);
+
+			TEST_ASSERT_THROW(isSameLights(result, reference));
+		}
+	}
+
+	TEST_CASE("Light grid ortho camera");
+	{
+		core::matrix4 ortho;
+		ortho.buildProjectionMatrixOrthoLH(200.0f, 120.0f, 0.1f, 300.0f);
+
+		grid.setGridSize(8, 8, 16);
+		grid.build(view, ortho, 0.1f, 300.0f, lights.pointer(), lights.size());
+
+		core::array<CLightCullingData*> result;
+		core::array<CLightCullingData*> reference;
+
+		for (int i = 0; i < 500; i++)
+		{
+			core::aabbox3df box = randomLightBox(6.0f);
+
+			result.set_used(0);
+			reference.set_used(0);
+
+			grid.getLights(box, result);
+			getLightsBruteForce(box, lights, reference);
+
+			TEST_ASSERT_THROW(isSameLights(result, reference));
+		}
+
+		// no camera, all lights are tested
+		grid.build((CCamera*)NULL, lights.pointer(), lights.size());
+		TEST_ASSERT_THROW(!grid.isBuilt());
+
+		core::aabbox3df box = randomLightBox(6.0f);
+		result.set_used(0);
+		reference.set_used(0);
+		grid.getLights(box, result);
+		getLightsBruteForce(box, lights, reference);
+		TEST_ASSERT_THROW(isSameLights(result, reference));
+
+		grid.setGridSize(16, 9, 24);
+	}
+
+	TEST_CASE("Light grid query count");
+	{
+		const int numMesh = 10000;
+
+		// the rendered meshes are in front of the camera
+		core::array<core::aabbox3df> meshes;
+		for (int i = 0; i < numMesh; i++)
+		{
+			core::aabbox3df box = randomLightBox(2.0f);
+			if (box.MinEdge.Z < 0.0f)
+			{
+				box.MaxEdge.Z -= box.MinEdge.Z;
+				box.MinEdge.Z = 0.0f;
+			}
+			meshes.push_back(box);
+		}
+
+		core::array<CLightCullingData*> result;
+		u32 numBrute = 0;
+		u32 numGrid = 0;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numMesh; i++)
+		{
+			result.set_used(0);
+			getLightsBruteForce(meshes[i], lights, result);
+			numBrute += result.size();
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		grid.build(view, projection, 0.1f, 300.0f, lights.pointer(), lights.size());
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < numMesh; i++)
+		{
+			result.set_used(0);
+			numGrid += grid.getLights(meshes[i], result);
+		}
+
+		auto t3 = std::chrono::high_resolution_clock::now();
+
+		TEST_ASSERT_EQUAL(numGrid, numBrute);
+
+		if (g_testBenchmark)
+		{
+			printf("    %d lights, %d meshes: brute force %.3fms, grid build %.3fms, grid query %.3fms\n",
+				numLight,
+				numMesh,
+				std::chrono::duration<double, std::milli>(t1 - t0).count(),
+				std::chrono::duration<double, std::milli>(t2 - t1).count(),
+				std::chrono::duration<double, std::milli>(t3 - t2).count());
+		}
+	}
+
+	for (u32 i = 0; i < lights.size(); i++)
+		delete lights[i];
+}
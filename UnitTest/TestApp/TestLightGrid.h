@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Lighting/CLightGrid.h"
+
+void testLightGrid();
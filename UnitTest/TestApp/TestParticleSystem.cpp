@@ -0,0 +1,163 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestParticleSystem.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static Particle::CGroup* createBurstGroup(Particle::CFactory* factory, int numParticle)
+{
+	Particle::CGroup* group = new Particle::CGroup();
+	group->LifeMin = 0.5f;
+	group->LifeMax = 1.0f;
+	group->Friction = 0.5f;
+
+	group->createModel(Particle::ColorA)->setStart(1.0f)->setEnd(0.0f);
+	group->createModel(Particle::RotateSpeedZ)->setStart(10.0f);
+
+	Particle::CEmitter* emitter = group->addEmitter(factory->createRandomEmitter());
+	emitter->setZone(factory->createSphereZone(core::vector3df(), 1.0f));
+	emitter->setFlow(0.0f);
+	emitter->setTank(numParticle);
+
+	return group;
+}
+
+static bool checkParticles(Particle::CGroup* group)
+{
+	Particle::CParticleData* data = group->getParticleData();
+	for (u32 i = 0, n = group->getNumParticles(); i < n; i++)
+	{
+		if (data->Life[i] < 0.0f)
+			return false;
+
+		float alpha = 1.0f - core::clamp(data->Age[i] / data->LifeTime[i], 0.0f, 1.0f);
+		if (!core::equals(data->Params[Particle::ColorA][i], alpha, 0.0001f))
+			return false;
+
+		if (fabsf(data->Rotation[2][i]) >= 2.0f * core::PI)
+			return false;
+
+		if (!group->getBBox().isPointInside(data->getVector(data->Position, i)))
+			return false;
+	}
+	return true;
+}
+
+// the particles have the same data, the kernels must give the same result on the SIMD lanes and the scalar loop
+static bool checkSameParticles(Particle::CGroup* group)
+{
+	Particle::CParticleData* data = group->getParticleData();
+	u32 n = group->getNumParticles();
+	if (n == 0)
+		return false;
+
+	core::vector3df last = data->getVector(data->Position, n - 1);
+
+	for (u32 i = 0; i < n; i++)
+	{
+		if (!data->getVector(data->Position, i).equals(last, 0.0001f))
+			return false;
+
+		if (!core::equals(data->Params[Particle::ColorA][i], data->Params[Particle::ColorA][n - 1], 0.0001f))
+			return false;
+	}
+	return true;
+}
+
+void testParticleSystem()
+{
+	float timeStep = getTimeStep();
+	setTimeStep(1000.0f / 60.0f);
+
+	Particle::CFactory* factory = new Particle::CFactory();
+
+	TEST_CASE("Particle burst");
+	Particle::CGroup* group = createBurstGroup(factory, 10000);
+
+	// the particles are born at the end of update
+	group->update(true);
+	TEST_ASSERT_EQUAL(group->getNumParticles(), 10000);
+
+	TEST_CASE("Particle update");
+	u32 lastCount = group->getNumParticles();
+	bool removed = false;
+
+	for (int i = 0; i < 75; i++)
+	{
+		group->update(true);
+		TEST_ASSERT_THROW(checkParticles(group));
+
+		if (group->getNumParticles() < lastCount)
+			removed = true;
+		lastCount = group->getNumParticles();
+	}
+
+	TEST_CASE("Particle remove dead");
+	TEST_ASSERT_THROW(removed);
+	TEST_ASSERT_EQUAL(group->getNumParticles(), 0);
+
+	delete group;
+
+	TEST_CASE("Particle long life");
+	group = createBurstGroup(factory, 100000);
+	group->LifeMin = 10.0f;
+	group->LifeMax = 10.0f;
+	group->update(true);
+
+	const int numLoop = 20;
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < numLoop; i++)
+		group->update(true);
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	if (g_testBenchmark)
+	{
+		printf("    %d particles: %.3fms per update\n",
+			group->getNumParticles(),
+			std::chrono::duration<double, std::milli>(end - begin).count() / numLoop);
+	}
+
+	TEST_ASSERT_THROW(checkParticles(group));
+	TEST_ASSERT_EQUAL(group->getNumParticles(), 100000);
+
+	delete group;
+
+	TEST_CASE("Particle vortex");
+	group = new Particle::CGroup();
+	group->LifeMin = 10.0f;
+	group->LifeMax = 10.0f;
+	group->Friction = 0.5f;
+
+	group->createModel(Particle::ColorA)->setStart(1.0f)->setEnd(0.0f);
+	group->createModel(Particle::RotateSpeedZ)->setStart(10.0f);
+
+	// 7 particles: 4 on the SIMD lanes, 3 on the scalar loop
+	Particle::CEmitter* emitter = group->addEmitter(factory->createStraightEmitter(core::vector3df(0.0f, 1.0f, 0.0f)));
+	emitter->setZone(factory->createPointZone(core::vector3df(1.0f, 0.0f, 0.0f)));
+	emitter->setForce(1.0f, 1.0f);
+	emitter->setFlow(0.0f);
+	emitter->setTank(7);
+
+	Particle::CVortexSystem* vortex = new Particle::CVortexSystem(core::vector3df(), core::vector3df(0.0f, 1.0f, 0.0f), 2.0f, 0.1f);
+	vortex->setEyeAttractionSpeed(0.5f);
+	group->addSystem(vortex);
+
+	group->update(true);
+	TEST_ASSERT_EQUAL(group->getNumParticles(), 7);
+
+	for (int i = 0; i < 10; i++)
+		group->update(true);
+
+	TEST_ASSERT_THROW(checkSameParticles(group));
+	TEST_ASSERT_THROW(checkParticles(group));
+
+	delete group;
+	delete vortex;
+	delete factory;
+
+	setTimeStep(timeStep);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Base.hh"
+#include "ParticleSystem/Particles/CGroup.h"
+#include "ParticleSystem/Particles/CFactory.h"
+
+void testParticleSystem();
@@ -0,0 +1,241 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestSceneBinary.h"
+
+#include "Scene/CScene.h"
+#include "Scene/CSceneExporter.h"
+#include "Scene/CSceneImporter.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static CScene* createBinaryTestScene(int numContainer, int numObject)
+{
+	CScene* scene = new CScene();
+	CZone* zone = scene->createZone();
+
+	CGameObject* camera = zone->createEmptyObject();
+	camera->setName("Camera");
+	camera->addComponent<CCamera>();
+
+	char name[64];
+
+	for (int i = 0; i < numContainer; i++)
+	{
+		CContainerObject* container = zone->createContainerObject();
+		sprintf(name, "Group_%d", i);
+		container->setName(name);
+		container->getTransformEuler()->setPosition(core::vector3df((float)i * 10.0f, 0.0f, 0.0f));
+
+		for (int j = 0; j < numObject; j++)
+		{
+			CGameObject* object = container->createEmptyObject();
+			sprintf(name, "Object_%d_%d", i, j);
+			object->setName(name);
+			object->setVisible(j % 3 != 0);
+
+			CTransformEuler* transform = object->getTransformEuler();
+			transform->setPosition(core::vector3df((float)j * 0.25f, (float)(i % 7), (float)j * -0.5f));
+			transform->setRotation(core::vector3df(0.0f, (float)(j * 13 % 360), 0.0f));
+			transform->setScale(core::vector3df(1.0f + (float)(j % 4) * 0.1f));
+		}
+	}
+
+	scene->updateAddRemoveObject();
+	return scene;
+}
+
+static CScene* importBinaryTestScene(const char* path, std::vector<CGameObject*>& objects)
+{
+	CScene* scene = new CScene();
+	if (!CSceneImporter::beginImportScene(scene, path))
+		return scene;
+
+	while (!CSceneImporter::updateLoadScene());
+
+	std::list<CGameObject*>& list = CSceneImporter::getObjects();
+	objects.assign(list.begin(), list.end());
+	return scene;
+}
+
+static bool isSameObject(CGameObject* a, CGameObject* b)
+{
+	if (a->getID() != b->getID() ||
+		strcmp(a->getNameA(), b->getNameA()) != 0 ||
+		a->getTypeName() != b->getTypeName() ||
+		a->isVisible() != b->isVisible() ||
+		a->getComponentCount() != b->getComponentCount())
+		return false;
+
+	CTransformEuler* ta = a->getTransformEuler();
+	CTransformEuler* tb = b->getTransformEuler();
+	return ta->getPosition().equals(tb->getPosition()) &&
+		ta->getRotation().equals(tb->getRotation()) &&
+		ta->getScale().equals(tb->getScale());
+}
+
+static long getTestFileSize(const char* path)
+{
+	io::IReadFile* file = getIrrlichtDevice()->getFileSystem()->createAndOpenFile(path);
+	if (file == NULL)
+		return 0;
+
+	long size = file->getSize();
+	file->drop();
+	return size;
+}
+
+static bool readTestFile(const char* path, std::vector<u8>& buffer)
+{
+	FILE* f = fopen(path, "rb");
+	if (f == NULL)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	buffer.resize((size_t)ftell(f));
+	fseek(f, 0, SEEK_SET);
+
+	bool ret = fread(buffer.data(), 1, buffer.size(), f) == buffer.size();
+	fclose(f);
+	return ret;
+}
+
+static bool writeTestFile(const char* path, const std::vector<u8>& buffer)
+{
+	FILE* f = fopen(path, "wb");
+	if (f == NULL)
+		return false;
+
+	bool ret = fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+	fclose(f);
+	return ret;
+}
+
+void testSceneBinary()
+{
+	TEST_CASE("Scene binary export");
+
+	const char* xmlPath = "TestSceneBinary.scene";
+	const char* binaryPath = "TestSceneBinary.sbin";
+
+	CScene* scene = createBinaryTestScene(40, 50);
+	CSceneExporter::exportScene(scene, xmlPath);
+	TEST_ASSERT_THROW(CSceneExporter::exportSceneBinary(scene, binaryPath));
+	TEST_ASSERT_THROW(CSceneBinary::isBinaryScene(binaryPath));
+	TEST_ASSERT_THROW(!CSceneBinary::isBinaryScene(xmlPath));
+	delete scene;
+
+	TEST_CASE("Scene binary file");
+	{
+		CSceneBinary binary;
+		TEST_ASSERT_THROW(binary.load(binaryPath));
+
+		// scene, zone, camera, containers and objects with their Components nodes
+		TEST_ASSERT_STRING_EQUAL(binary.getNodeType(0), "CScene");
+		TEST_ASSERT_EQUAL(binary.getNode(0).End, binary.getNodeCount());
+		TEST_ASSERT_STRING_EQUAL(binary.getNodeType(1), "CZone");
+
+		u32 numObject = 0;
+		for (u32 i = 0, n = binary.getNodeCount(); i < n; i++)
+		{
+			const CSceneBinary::SNode& node = binary.getNode(i);
+			TEST_ASSERT_THROW(node.End > i && node.End <= n);
+
+			if (strcmp(binary.getNodeType(i), "CGameObject") == 0)
+				numObject++;
+		}
+		TEST_ASSERT_EQUAL(numObject, 40 * 50 + 1);
+	}
+
+	TEST_CASE("Scene binary broken file");
+	{
+		std::vector<u8> buffer;
+		TEST_ASSERT_THROW(readTestFile(binaryPath, buffer));
+
+		const CSceneBinary::SHeader* header = (const CSceneBinary::SHeader*)buffer.data();
+		const char* brokenPath = "TestSceneBinaryBroken.sbin";
+
+		// the subtree of the zone ends before the zone
+		std::vector<u8> broken = buffer;
+		CSceneBinary::SNode* nodes = (CSceneBinary::SNode*)(broken.data() + header->NodeOffset);
+		nodes[1].End = 0;
+		TEST_ASSERT_THROW(writeTestFile(brokenPath, broken));
+		{
+			CSceneBinary binary;
+			TEST_ASSERT_THROW(!binary.load(brokenPath));
+		}
+
+		// the string offset is out of the string table
+		broken = buffer;
+		u32* stringOffset = (u32*)(broken.data() + header->StringOffset);
+		stringOffset[0] = header->NodeOffset;
+		TEST_ASSERT_THROW(writeTestFile(brokenPath, broken));
+		{
+			CSceneBinary binary;
+			TEST_ASSERT_THROW(!binary.load(brokenPath));
+		}
+
+		// the attributes are out of the data blob
+		broken = buffer;
+		nodes = (CSceneBinary::SNode*)(broken.data() + header->NodeOffset);
+		nodes[0].NumAttribute = 0x7fffffff;
+		TEST_ASSERT_THROW(writeTestFile(brokenPath, broken));
+		{
+			CSceneBinary binary;
+			TEST_ASSERT_THROW(!binary.load(brokenPath));
+		}
+
+		// the attributes are not aligned
+		broken = buffer;
+		nodes = (CSceneBinary::SNode*)(broken.data() + header->NodeOffset);
+		nodes[0].DataOffset += 1;
+		TEST_ASSERT_THROW(writeTestFile(brokenPath, broken));
+		{
+			CSceneBinary binary;
+			TEST_ASSERT_THROW(!binary.load(brokenPath));
+		}
+
+		remove(brokenPath);
+	}
+
+	TEST_CASE("Scene binary import");
+	std::vector<CGameObject*> xmlObjects;
+	std::vector<CGameObject*> binaryObjects;
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+	CScene* xmlScene = importBinaryTestScene(xmlPath, xmlObjects);
+	auto t1 = std::chrono::high_resolution_clock::now();
+	CScene* binaryScene = importBinaryTestScene(binaryPath, binaryObjects);
+	auto t2 = std::chrono::high_resolution_clock::now();
+
+	TEST_ASSERT_EQUAL(xmlObjects.size(), (size_t)(1 + 1 + 40 + 40 * 50));
+	TEST_ASSERT_EQUAL(binaryObjects.size(), xmlObjects.size());
+
+	bool same = binaryObjects.size() == xmlObjects.size();
+	for (size_t i = 0; same && i < xmlObjects.size(); i++)
+		same = isSameObject(xmlObjects[i], binaryObjects[i]);
+	TEST_ASSERT_THROW(same);
+
+	CGameObject* camera = binaryScene->searchObjectInChild(L"Camera");
+	TEST_ASSERT_THROW(camera != NULL && camera->getComponent<CCamera>() != NULL);
+
+	TEST_ASSERT_THROW(getTestFileSize(binaryPath) < getTestFileSize(xmlPath));
+
+	if (g_testBenchmark)
+	{
+		printf("    %d objects: xml %ld bytes %.3fms, binary %ld bytes %.3fms\n",
+			(int)xmlObjects.size(),
+			getTestFileSize(xmlPath),
+			std::chrono::duration<double, std::milli>(t1 - t0).count(),
+			getTestFileSize(binaryPath),
+			std::chrono::duration<double, std::milli>(t2 - t1).count());
+	}
+
+	delete xmlScene;
+	delete binaryScene;
+
+	remove(xmlPath);
+	remove(binaryPath);
+	remove("TestSceneBinary.txt");
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Scene/CSceneBinary.h"
+
+void testSceneBinary();
@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestShaderUniform.h"
+#include "Material/CMaterial.h"
+#include "Material/Shader/ShaderCallback/CShaderMaterial.h"
+
+#include <map>
+
+using namespace Skylicht;
+
+// record the uniform values like the program on the GPU
+class CTestUniformRenderer : public video::IMaterialRenderer
+{
+public:
+	std::map<std::string, s32> IDs;
+
+	std::map<s32, std::vector<float>> Values[2];
+
+	int NumSet;
+
+	CTestUniformRenderer() :
+		NumSet(0)
+	{
+	}
+
+	virtual s32 getShaderVariableID(const c8* name, video::E_SHADER_TYPE shaderType)
+	{
+		std::string key = name;
+		key += shaderType == video::EST_VERTEX_SHADER ? "_vs" : "_fs";
+
+		std::map<std::string, s32>::iterator it = IDs.find(key);
+		if (it != IDs.end())
+			return it->second;
+
+		s32 id = (s32)IDs.size();
+		IDs[key] = id;
+		return id;
+	}
+
+	virtual void setShaderVariable(s32 id, const f32* value, int count, video::E_SHADER_TYPE shaderType)
+	{
+		int type = shaderType == video::EST_VERTEX_SHADER ? 0 : 1;
+		Values[type][id] = std::vector<float>(value, value + count);
+		NumSet++;
+	}
+
+	u32 getStateHash()
+	{
+		u32 hash = 2166136261u;
+		for (int i = 0; i < 2; i++)
+		{
+			for (auto& it : Values[i])
+			{
+				hash = (hash ^ (u32)it.first) * 16777619u;
+				for (float f : it.second)
+				{
+					u32 bits;
+					memcpy(&bits, &f, sizeof(u32));
+					hash = (hash ^ bits) * 16777619u;
+				}
+			}
+		}
+		return hash;
+	}
+};
+
+class CTestUniformServices : public video::IMaterialRendererServices
+{
+public:
+	virtual void setBasicRenderStates(const video::SMaterial& material, const video::SMaterial& lastMaterial, bool resetAllRenderstates)
+	{
+	}
+
+	virtual video::IVideoDriver* getVideoDriver()
+	{
+		return getIrrlichtDevice()->getVideoDriver();
+	}
+};
+
+static void drawUniformScene(CShader* shader, CTestUniformServices* services, core::array<CMaterial*>& materials, int numObject, int numFrame, CTestUniformRenderer* renderer, core::array<u32>& hash)
+{
+	IVideoDriver* driver = getVideoDriver();
+
+	for (int frame = 0; frame < numFrame; frame++)
+	{
+		core::matrix4 view, projection;
+		view.buildCameraLookAtMatrixLH(core::vector3df(0.0f, 5.0f, -10.0f - (float)frame), core::vector3df(), core::vector3df(0.0f, 1.0f, 0.0f));
+		projection.buildProjectionMatrixPerspectiveFovLH(core::PI / 4.0f, 16.0f / 9.0f, 0.1f, 500.0f);
+
+		// the driver updates the view projection matrix on set view
+		driver->setTransform(video::ETS_PROJECTION, projection);
+		driver->setTransform(video::ETS_VIEW, view);
+
+		// the render lists are sorted by material
+		for (u32 m = 0; m < materials.size(); m++)
+		{
+			CShaderMaterial::setMaterial(materials[m]);
+
+			for (int i = 0; i < numObject; i++)
+			{
+				core::matrix4 world;
+				world.setTranslation(core::vector3df((float)i, 0.0f, (float)m));
+				driver->setTransform(video::ETS_WORLD, world);
+
+				shader->OnSetConstants(services, 0, true);
+				hash.push_back(renderer->getStateHash());
+			}
+		}
+	}
+
+	CShaderMaterial::setMaterial(NULL);
+}
+
+void testShaderUniform()
+{
+	TEST_CASE("Shader uniform cache");
+
+	const char* shaderPath = "BuiltIn/Shader/SpecularGlossiness/Forward/SG.xml";
+
+	io::IXMLReader* xmlReader = getIrrlichtDevice()->getFileSystem()->createXMLReader(shaderPath);
+	TEST_ASSERT_THROW(xmlReader != NULL);
+	if (xmlReader == NULL)
+		return;
+
+	CShader* shader = new CShader();
+	shader->initShader(xmlReader, shaderPath, "BuiltIn/Shader/SpecularGlossiness/Forward/");
+	xmlReader->drop();
+
+	CTestUniformRenderer* renderer = new CTestUniformRenderer();
+	s32 renderID = getVideoDriver()->addMaterialRenderer(renderer, "TestUniform");
+	renderer->drop();
+
+	shader->setMaterialRenderID(renderID);
+
+	CTestUniformServices services;
+
+	// the materials with the different color
+	core::array<CMaterial*> materials;
+	for (int i = 0; i < 8; i++)
+	{
+		CMaterial* material = new CMaterial("TestUniform", "");
+		SVec4 uvScale(1.0f, 1.0f, 0.0f, 0.0f);
+		SVec4 color((float)i / 8.0f, 0.5f, 0.5f, 1.0f);
+		SVec4 lightMul(1.0f, i % 2 == 0 ? 1.0f : 0.5f, 0.0f, 0.0f);
+		material->getShaderParams().setValue(0, uvScale);
+		material->getShaderParams().setValue(1, color);
+		material->getShaderParams().setValue(2, lightMul);
+		materials.push_back(material);
+	}
+
+	const int numObject = 200;
+	const int numFrame = 3;
+
+	CShaderManager* shaderManager = CShaderManager::getInstance();
+	bool cacheEnabled = shaderManager->isUniformCacheEnabled();
+
+	// send all uniforms
+	core::array<u32> hash;
+	shaderManager->setUniformCache(false);
+	shaderManager->resetUniformStats();
+	drawUniformScene(shader, &services, materials, numObject, numFrame, renderer, hash);
+
+	int numSet = renderer->NumSet;
+	SUniformStats stats = shaderManager->getUniformStats();
+	TEST_ASSERT_EQUAL((int)stats.NumUpload, numSet);
+	TEST_ASSERT_EQUAL((int)stats.NumSkipVersion, 0);
+	TEST_ASSERT_EQUAL((int)stats.NumSkipValue, 0);
+
+	// skip the uniforms that did not change
+	core::array<u32> cacheHash;
+	renderer->Values[0].clear();
+	renderer->Values[1].clear();
+	renderer->NumSet = 0;
+
+	shaderManager->setUniformCache(true);
+	shaderManager->resetUniformStats();
+	drawUniformScene(shader, &services, materials, numObject, numFrame, renderer, cacheHash);
+
+	int numCacheSet = renderer->NumSet;
+	SUniformStats cacheStats = shaderManager->getUniformStats();
+	TEST_ASSERT_EQUAL((int)cacheStats.NumUpload, numCacheSet);
+	TEST_ASSERT_EQUAL(cacheStats.NumUniform, stats.NumUniform);
+	TEST_ASSERT_THROW(cacheStats.NumSkipVersion > 0);
+	TEST_ASSERT_THROW(cacheStats.NumSkipValue > 0);
+	TEST_ASSERT_THROW(numCacheSet < numSet);
+
+	// the program sees the same values at each draw
+	TEST_ASSERT_EQUAL(cacheHash.size(), hash.size());
+	bool sameState = cacheHash.size() == hash.size();
+	for (u32 i = 0; sameState && i < hash.size(); i++)
+		sameState = cacheHash[i] == hash[i];
+	TEST_ASSERT_THROW(sameState);
+
+	if (g_testBenchmark)
+	{
+		printf("    %d draws: %d uniforms, upload %d without cache, %d with cache (skip %d by version, %d by value)\n",
+			(int)hash.size(),
+			stats.NumUniform,
+			numSet,
+			numCacheSet,
+			cacheStats.NumSkipVersion,
+			cacheStats.NumSkipValue);
+	}
+
+	shaderManager->setUniformCache(cacheEnabled);
+
+	for (u32 i = 0; i < materials.size(); i++)
+		delete materials[i];
+
+	delete shader;
+}
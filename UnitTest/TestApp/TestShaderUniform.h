@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Material/Shader/CShader.h"
+
+void testShaderUniform();
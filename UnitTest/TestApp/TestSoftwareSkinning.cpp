@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestSoftwareSkinning.h"
+#include "Thread/CJobSystem.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static float randomSkinValue(float min, float max)
+{
+	return min + (max - min) * (float)(rand() % 10000) / 10000.0f;
+}
+
+static void skinVerticesScalar(const CSkinnedMesh::SJoint* joints, const video::S3DVertexSkin* src, video::S3DVertex* dst, int numVertex)
+{
+	// the loop of CSoftwareSkinningUtils::softwareSkinning before the kernel
+	for (int i = 0; i < numVertex; i++)
+	{
+		const video::S3DVertexSkin& vertex = src[i];
+		video::S3DVertex& result = dst[i];
+
+		result.Pos.set(0.0f, 0.0f, 0.0f);
+		result.Normal.set(0.0f, 0.0f, 0.0f);
+
+		const float* weight = &vertex.BoneWeight.X;
+		const float* boneIndex = &vertex.BoneIndex.X;
+
+		for (int j = 0; j < 4; j++)
+		{
+			if (weight[j] > 0.0f)
+			{
+				CSoftwareSkinningUtils::skinVertex(joints[(int)boneIndex[j]].SkinningMatrix,
+					result.Pos,
+					result.Normal,
+					vertex.Pos,
+					vertex.Normal,
+					weight[j]);
+			}
+		}
+	}
+}
+
+void testSoftwareSkinning()
+{
+	srand(0);
+
+	const int numJoint = 64;
+	const int numVertex = 100000;
+
+	core::array<core::matrix4> matrices;
+	core::array<CSkinnedMesh::SJoint> joints;
+
+	for (int i = 0; i < numJoint; i++)
+	{
+		core::matrix4 m;
+		m.setRotationDegrees(core::vector3df(randomSkinValue(0.0f, 360.0f), randomSkinValue(0.0f, 360.0f), randomSkinValue(0.0f, 360.0f)));
+		m.setTranslation(core::vector3df(randomSkinValue(-2.0f, 2.0f), randomSkinValue(-2.0f, 2.0f), randomSkinValue(-2.0f, 2.0f)));
+		matrices.push_back(m);
+	}
+
+	for (int i = 0; i < numJoint; i++)
+	{
+		joints.push_back(CSkinnedMesh::SJoint());
+		joints[i].SkinningMatrix = matrices[i].pointer();
+	}
+
+	core::array<video::S3DVertexSkin> vertices;
+	vertices.set_used(numVertex);
+
+	for (int i = 0; i < numVertex; i++)
+	{
+		video::S3DVertexSkin& v = vertices[i];
+		v.Pos.set(randomSkinValue(-1.0f, 1.0f), randomSkinValue(0.0f, 2.0f), randomSkinValue(-1.0f, 1.0f));
+		v.Normal.set(randomSkinValue(-1.0f, 1.0f), randomSkinValue(-1.0f, 1.0f), randomSkinValue(-1.0f, 1.0f));
+		v.Normal.normalize();
+
+		// 1 to 4 bones
+		int numBone = 1 + rand() % 4;
+		float* weight = &v.BoneWeight.X;
+		float* boneIndex = &v.BoneIndex.X;
+		float sum = 0.0f;
+
+		for (int j = 0; j < 4; j++)
+		{
+			boneIndex[j] = (float)(rand() % numJoint);
+			weight[j] = j < numBone ? randomSkinValue(0.1f, 1.0f) : 0.0f;
+			sum += weight[j];
+		}
+
+		for (int j = 0; j < 4; j++)
+			weight[j] = weight[j] / sum;
+	}
+
+	core::array<video::S3DVertex> expected;
+	core::array<video::S3DVertex> result;
+	expected.set_used(numVertex);
+	result.set_used(numVertex);
+
+	TEST_CASE("Software skinning kernel");
+	skinVerticesScalar(joints.const_pointer(), vertices.const_pointer(), expected.pointer(), numVertex);
+	CSoftwareSkinningUtils::skinVertices(joints.const_pointer(), vertices.const_pointer(), result.pointer(), 0, numVertex);
+
+	bool equal = true;
+	for (int i = 0; i < numVertex; i++)
+	{
+		if (!result[i].Pos.equals(expected[i].Pos, 0.0001f) ||
+			!result[i].Normal.equals(expected[i].Normal, 0.0001f))
+		{
+			equal = false;
+			break;
+		}
+	}
+	TEST_ASSERT_THROW(equal);
+
+	const CSkinnedMesh::SJoint* jointData = joints.const_pointer();
+	const video::S3DVertexSkin* src = vertices.const_pointer();
+	video::S3DVertex* dst = result.pointer();
+
+	if (g_testBenchmark)
+	{
+		TEST_CASE("Software skinning benchmark");
+		const int numLoop = 20;
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		for (int loop = 0; loop < numLoop; loop++)
+			skinVerticesScalar(joints.const_pointer(), vertices.const_pointer(), expected.pointer(), numVertex);
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		for (int loop = 0; loop < numLoop; loop++)
+			CSoftwareSkinningUtils::skinVertices(joints.const_pointer(), vertices.const_pointer(), result.pointer(), 0, numVertex);
+
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		for (int loop = 0; loop < numLoop; loop++)
+		{
+			System::CJobSystem::runParallelFor(numVertex, 1024,
+				[jointData, src, dst](int begin, int end)
+				{
+					CSoftwareSkinningUtils::skinVertices(jointData, src, dst, begin, end);
+				});
+		}
+
+		auto t3 = std::chrono::high_resolution_clock::now();
+
+		printf("    %d vertices: scalar %.3fms, kernel %.3fms, parallel %.3fms\n",
+			numVertex,
+			std::chrono::duration<double, std::milli>(t1 - t0).count() / numLoop,
+			std::chrono::duration<double, std::milli>(t2 - t1).count() / numLoop,
+			std::chrono::duration<double, std::milli>(t3 - t2).count() / numLoop);
+	}
+
+	TEST_CASE("Software skinning parallel");
+
+	// clear the result of the kernel test
+	for (int i = 0; i < numVertex; i++)
+		dst[i].Pos.set(0.0f, 0.0f, 0.0f);
+
+	System::CJobSystem::runParallelFor(numVertex, 1024,
+		[jointData, src, dst](int begin, int end)
+		{
+			CSoftwareSkinningUtils::skinVertices(jointData, src, dst, begin, end);
+		});
+
+	equal = true;
+	for (int i = 0; i < numVertex; i++)
+	{
+		if (!result[i].Pos.equals(expected[i].Pos, 0.0001f))
+		{
+			equal = false;
+			break;
+		}
+	}
+	TEST_ASSERT_THROW(equal);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "VertexAnimation/CSoftwareSkinningUtils.h"
+
+void testSoftwareSkinning();
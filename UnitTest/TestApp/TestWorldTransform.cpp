@@ -0,0 +1,165 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestWorldTransform.h"
+#include "Culling/CVisibleData.h"
+#include "Utils/CMatrix.h"
+
+#include <chrono>
+
+using namespace Skylicht;
+
+static float randomAngle()
+{
+	return (float)(rand() % 3600) / 10.0f;
+}
+
+static core::matrix4 randomRelative()
+{
+	core::matrix4 m;
+	m.setRotationDegrees(core::vector3df(randomAngle(), randomAngle(), randomAngle()));
+	m.setTranslation(core::vector3df(0.0f, 1.0f + (float)(rand() % 100) / 100.0f, 0.0f));
+	return m;
+}
+
+static bool isMatrixEqual(const core::matrix4& a, const core::matrix4& b, float tolerance)
+{
+	for (int i = 0; i < 16; i++)
+	{
+		if (!core::equals(a[i], b[i], tolerance))
+			return false;
+	}
+	return true;
+}
+
+static CEntity* spawnBone(CEntityManager* entityManager, CEntity* parent)
+{
+	CEntity* entity = entityManager->createEntity();
+	entity->addData<CVisibleData>();
+
+	CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+	transform->Relative = randomRelative();
+
+	if (parent)
+		transform->ParentIndex = parent->getIndex();
+
+	return entity;
+}
+
+// a root with some chains of bones (like the spine, arms and legs of a character)
+static void spawnCharacter(CEntityManager* entityManager, core::array<CEntity*>& bones, int numChain, int chainLength)
+{
+	CEntity* root = spawnBone(entityManager, NULL);
+	bones.push_back(root);
+
+	for (int i = 0; i < numChain; i++)
+	{
+		CEntity* parent = root;
+		for (int j = 0; j < chainLength; j++)
+		{
+			parent = spawnBone(entityManager, parent);
+			bones.push_back(parent);
+		}
+	}
+}
+
+static bool checkWorldTransform(core::array<CEntity*>& bones)
+{
+	for (u32 i = 0; i < bones.size(); i++)
+	{
+		CWorldTransformData* transform = GET_ENTITY_DATA(bones[i], CWorldTransformData);
+
+		core::matrix4 world = transform->calcWorldMatrix();
+		if (!isMatrixEqual(transform->World, world, 0.001f))
+			return false;
+	}
+	return true;
+}
+
+void testWorldTransform()
+{
+	srand(0);
+
+	TEST_CASE("Matrix multiply");
+	bool pass = true;
+	for (int i = 0; i < 100; i++)
+	{
+		core::matrix4 a = randomRelative();
+		core::matrix4 b = randomRelative();
+
+		core::matrix4 result, check;
+		CMatrix::multiply(result, a, b);
+		check.setbyproduct_nocheck(a, b);
+
+		if (!isMatrixEqual(result, check, 0.00001f))
+			pass = false;
+
+		// the out matrix is the input matrix
+		CMatrix::multiply(a, a, b);
+		if (!isMatrixEqual(a, check, 0.00001f))
+			pass = false;
+	}
+	TEST_ASSERT_THROW(pass);
+
+	CEntityManager* entityManager = new CEntityManager();
+
+	core::array<CEntity*> bones;
+	for (int i = 0; i < 10; i++)
+		spawnCharacter(entityManager, bones, 4, 6);
+
+	TEST_CASE("World transform hierarchy");
+	entityManager->update();
+	TEST_ASSERT_THROW(checkWorldTransform(bones));
+
+	TEST_CASE("World transform dirty subtree");
+	CWorldTransformData* root = GET_ENTITY_DATA(bones[0], CWorldTransformData);
+	root->Relative.setTranslation(core::vector3df(10.0f, 0.0f, 0.0f));
+	root->HasChanged = true;
+
+	CWorldTransformData* bone = GET_ENTITY_DATA(bones[bones.size() - 1], CWorldTransformData);
+	bone->Relative = randomRelative();
+	bone->HasChanged = true;
+
+	entityManager->update();
+	TEST_ASSERT_THROW(checkWorldTransform(bones));
+
+	// the changed bones, and all the childs of root
+	TEST_ASSERT_EQUAL((u32)root->NeedValidate, 1);
+	TEST_ASSERT_EQUAL((u32)GET_ENTITY_DATA(bones[1], CWorldTransformData)->NeedValidate, 1);
+	TEST_ASSERT_EQUAL((u32)GET_ENTITY_DATA(bones[bones.size() - 2], CWorldTransformData)->NeedValidate, 0);
+	TEST_ASSERT_EQUAL((u32)bone->NeedValidate, 1);
+
+	delete entityManager;
+
+	TEST_CASE("World transform many characters");
+	entityManager = new CEntityManager();
+
+	bones.set_used(0);
+	for (int i = 0; i < 500; i++)
+		spawnCharacter(entityManager, bones, 5, 12);
+
+	entityManager->update();
+
+	const int numLoop = g_testBenchmark ? 50 : 2;
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	for (int loop = 0; loop < numLoop; loop++)
+	{
+		for (u32 i = 0; i < bones.size(); i++)
+			GET_ENTITY_DATA(bones[i], CWorldTransformData)->HasChanged = true;
+
+		entityManager->update();
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	if (g_testBenchmark)
+	{
+		printf("    %d bones: %.3fms per update\n",
+			bones.size(),
+			std::chrono::duration<double, std::milli>(end - begin).count() / numLoop);
+	}
+
+	TEST_ASSERT_THROW(checkWorldTransform(bones));
+
+	delete entityManager;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Base.hh"
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+
+void testWorldTransform();